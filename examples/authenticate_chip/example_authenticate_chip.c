@@ -119,9 +119,6 @@ static optiga_lib_status_t __get_chip_cert(uint16_t cert_oid,
 		                                   uint8_t* p_cert, uint16_t* p_cert_size)
 {
 	int32_t status  = (int32_t)OPTIGA_LIB_ERROR;
-	// We might need to modify a certificate buffer pointer
-	uint8_t tmp_cert[LENGTH_OPTIGA_CERT];
-	uint8_t* p_tmp_cert_pointer = tmp_cert;
 
 	do
 	{
@@ -132,15 +129,20 @@ static optiga_lib_status_t __get_chip_cert(uint16_t cert_oid,
 			break;
 		}
 
-		//Get end entity device certificate
-		status = optiga_util_read_data(cert_oid, 0, p_tmp_cert_pointer, p_cert_size);
+		//Get end entity device certificate, only the stored bytes are read
+		status = optiga_util_read_data_exact(cert_oid, 0, p_cert, p_cert_size);
 		if(OPTIGA_LIB_SUCCESS != status)
 		{
 			break;
 		}
+		status = OPTIGA_LIB_ERROR;
+		if (0 == *p_cert_size)
+		{
+			break;
+		}
 
 		// Refer to the Solution Reference Manual (SRM) v1.35 Table 30. Certificate Types
-		switch (p_tmp_cert_pointer[0])
+		switch (p_cert[0])
 		{
 		/* One-Way Authentication Identity. Certificate DER coded The first byte
 		*  of the DER encoded certificate is 0x30 and is used as Tag to differentiate
@@ -157,9 +159,12 @@ static optiga_lib_status_t __get_chip_cert(uint16_t cert_oid,
 			/* There might be a certificate chain encoded.
 			 * For this example we will consider only one certificate in the chain
 			 */
-			p_tmp_cert_pointer = p_tmp_cert_pointer + 9;
+			if (*p_cert_size <= 9)
+			{
+				break;
+			}
 			*p_cert_size = *p_cert_size - 9;
-			memcpy(p_cert, p_tmp_cert_pointer, *p_cert_size);
+			memmove(p_cert, p_cert + 9, *p_cert_size);
 			status = OPTIGA_LIB_SUCCESS;
 			break;
 		/* USB Type-C identity
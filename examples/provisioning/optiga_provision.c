@@ -0,0 +1,835 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \file
+*
+* \brief This file implements a command line tool which provisions several OPTIGA devices in parallel
+*        from a provisioning manifest. The devices are I2C buses of the Linux PAL, USB dongles are not supported.
+*
+* \ingroup
+* @{
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "optiga/optiga_util.h"
+#include "optiga/optiga_crypt.h"
+#include "optiga/ifx_i2c/ifx_i2c_config.h"
+#include "pal_linux.h"
+
+/// Maximum number of devices provisioned in parallel
+#define OPTIGA_PROVISION_MAX_DEVICES        (16)
+/// Maximum number of directives in a manifest
+#define OPTIGA_PROVISION_MAX_ITEMS          (32)
+/// Maximum size of a data object
+#define OPTIGA_PROVISION_MAX_DATA_LENGTH    (1728)
+/// Maximum length of a manifest line
+#define OPTIGA_PROVISION_MAX_LINE_LENGTH    (2 * OPTIGA_PROVISION_MAX_DATA_LENGTH + 64)
+/// Maximum length of a public key read back after key generation
+#define OPTIGA_PROVISION_MAX_PUBKEY_LENGTH  (120)
+/// Size of the device report
+#define OPTIGA_PROVISION_REPORT_SIZE        (32 * 1024)
+/// Length of the coprocessor UID
+#define OPTIGA_PROVISION_UID_LENGTH         (27)
+/// Length of the chunks hashed for the report signature
+#define OPTIGA_PROVISION_HASH_CHUNK_LENGTH  (512)
+
+/** @brief Manifest directives */
+typedef enum optiga_provision_item_type
+{
+    /// Write data object
+    OPTIGA_PROVISION_WRITE = 0x00,
+    /// Write metadata of an object
+    OPTIGA_PROVISION_METADATA = 0x01,
+    /// Generate a key pair and read back the public key
+    OPTIGA_PROVISION_KEYGEN = 0x02,
+    /// Read back a data object into the report
+    OPTIGA_PROVISION_READ = 0x03,
+    /// Check the lifecycle state of an object
+    OPTIGA_PROVISION_LIFECYCLE = 0x04
+} optiga_provision_item_type_t;
+
+/** @brief Manifest directive */
+typedef struct optiga_provision_item
+{
+    /// Directive, from #optiga_provision_item_type_t
+    uint8_t type;
+    /// Object the directive works on
+    uint16_t oid;
+    /// Write type for writes, curve for key generation, expected state for lifecycle checks
+    uint8_t param;
+    /// Data of a write is compressed, no data can be appended to it
+    uint8_t compressed;
+    /// Key usage for key generation
+    uint8_t key_usage;
+    /// Data to be written, metadata or NULL
+    uint8_t * data;
+    /// Length of data, maximum length to be read back for reads
+    uint16_t data_length;
+} optiga_provision_item_t;
+
+/** @brief Provisioning manifest */
+typedef struct optiga_provision_manifest
+{
+    /// Directives in manifest order
+    optiga_provision_item_t items[OPTIGA_PROVISION_MAX_ITEMS];
+    /// Number of directives
+    uint8_t item_count;
+    /// Key used to sign the device reports, 0x0000 if reports are not signed
+    uint16_t report_key;
+} optiga_provision_manifest_t;
+
+/** @brief Report of a device */
+typedef struct optiga_provision_report
+{
+    /// Report text
+    char text[OPTIGA_PROVISION_REPORT_SIZE];
+    /// Length of the report text
+    size_t length;
+} optiga_provision_report_t;
+
+/// I2C device used by the Linux PAL, set per provisioned device
+char * i2c_if;
+
+/// Communication instance of the provisioned device
+optiga_comms_t optiga_comms = {(void*)&ifx_i2c_context_0, NULL, NULL, 0};
+
+static optiga_provision_manifest_t manifest;
+static optiga_provision_report_t report;
+
+static uint32_t optiga_provision_time_ms(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((now.tv_sec * 1000) + (now.tv_nsec / 1000000));
+}
+
+static void optiga_provision_report_add(const char * format, ...)
+{
+    va_list args;
+    int length;
+
+    va_start(args, format);
+    length = vsnprintf(report.text + report.length, sizeof(report.text) - report.length, format, args);
+    va_end(args);
+
+    if (length > 0)
+    {
+        report.length += (size_t)length;
+        if (report.length >= sizeof(report.text))
+        {
+            report.length = sizeof(report.text) - 1;
+        }
+    }
+}
+
+static void optiga_provision_report_hex(const uint8_t * data, uint16_t length)
+{
+    uint16_t index;
+
+    for (index = 0; index < length; index++)
+    {
+        optiga_provision_report_add("%02X", data[index]);
+    }
+}
+
+static int optiga_provision_parse_hex(const char * text, uint8_t * data, uint16_t size, uint16_t * length)
+{
+    size_t text_length = strlen(text);
+    uint16_t index;
+    unsigned int value;
+
+    if ((0 != (text_length % 2)) || ((text_length / 2) > size))
+    {
+        return -1;
+    }
+    for (index = 0; index < (text_length / 2); index++)
+    {
+        if (!isxdigit((unsigned char)text[2 * index]) || !isxdigit((unsigned char)text[(2 * index) + 1]) ||
+            (1 != sscanf(&text[2 * index], "%2x", &value)))
+        {
+            return -1;
+        }
+        data[index] = (uint8_t)value;
+    }
+    *length = (uint16_t)(text_length / 2);
+    return 0;
+}
+
+static int optiga_provision_load_data(const char * source, optiga_provision_item_t * item)
+{
+    uint8_t buffer[OPTIGA_PROVISION_MAX_DATA_LENGTH];
+    uint16_t length = 0;
+    FILE * file;
+    size_t read_length;
+
+    if (0 == strncmp(source, "hex:", 4))
+    {
+        if (0 != optiga_provision_parse_hex(source + 4, buffer, sizeof(buffer), &length))
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        file = fopen(source, "rb");
+        if (NULL == file)
+        {
+            return -1;
+        }
+        read_length = fread(buffer, 1, sizeof(buffer), file);
+        //Data which does not fit into a data object is refused
+        if ((0 == read_length) || (EOF != fgetc(file)))
+        {
+            fclose(file);
+            return -1;
+        }
+        fclose(file);
+        length = (uint16_t)read_length;
+    }
+
+    item->data = malloc(length);
+    if (NULL == item->data)
+    {
+        return -1;
+    }
+    memcpy(item->data, buffer, length);
+    item->data_length = length;
+    return 0;
+}
+
+/**
+ * Appends the data of an append write to the previous write of the same object, so the object is written
+ * by a single write filling every APDU. Returns 1 if there is no such previous write.
+ */
+static int optiga_provision_merge_write(optiga_provision_item_t * item)
+{
+    optiga_provision_item_t * previous = &manifest.items[manifest.item_count - 1];
+    uint8_t * data;
+
+    if ((0 == manifest.item_count) || (OPTIGA_PROVISION_WRITE != previous->type) || (previous->oid != item->oid))
+    {
+        return 1;
+    }
+    if ((previous->compressed) ||
+        ((previous->data_length + item->data_length) > OPTIGA_PROVISION_MAX_DATA_LENGTH))
+    {
+        return -1;
+    }
+
+    data = realloc(previous->data, previous->data_length + item->data_length);
+    if (NULL == data)
+    {
+        return -1;
+    }
+    memcpy(data + previous->data_length, item->data, item->data_length);
+    previous->data = data;
+    previous->data_length += item->data_length;
+    free(item->data);
+    item->data = NULL;
+    return 0;
+}
+
+static int optiga_provision_parse_usage(char * text, uint8_t * key_usage)
+{
+    char * token;
+
+    *key_usage = 0;
+    for (token = strtok(text, ","); NULL != token; token = strtok(NULL, ","))
+    {
+        if (0 == strcmp(token, "auth"))
+        {
+            *key_usage |= (uint8_t)OPTIGA_KEY_USAGE_AUTHENTICATION;
+        }
+        else if (0 == strcmp(token, "sign"))
+        {
+            *key_usage |= (uint8_t)OPTIGA_KEY_USAGE_SIGN;
+        }
+        else if (0 == strcmp(token, "keyagree"))
+        {
+            *key_usage |= (uint8_t)OPTIGA_KEY_USAGE_KEY_AGREEMENT;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+    return (0 != *key_usage) ? 0 : -1;
+}
+
+#ifdef OPTIGA_UTIL_CERT_COMPRESSION
+/**
+ * Replaces the data of a write by the compressed certificate, read back with optiga_util_read_cert.
+ * Certificates which do not get shorter are written as they are, optiga_util_read_cert returns them unchanged.
+ */
+static void optiga_provision_compress(optiga_provision_item_t * item)
+{
+    uint8_t buffer[OPTIGA_PROVISION_MAX_DATA_LENGTH];
+    uint16_t length = item->data_length - 1;
+
+    if (OPTIGA_LIB_SUCCESS == optiga_util_compress_cert(item->data, item->data_length, buffer, &length))
+    {
+        memcpy(item->data, buffer, length);
+        item->data_length = length;
+    }
+}
+#endif
+
+/**
+ * Parses a provisioning manifest. Each line holds one directive, '#' starts a comment:
+ *
+ *     write      <oid> <file | hex:data> [append | compress]
+ *
+ * An append write following a write of the same object is merged into it, the data is appended to the data
+ * of the previous write.
+ *     metadata   <oid> <file | hex:metadata>
+ *     keygen     <oid> <p256 | p384> <auth,sign,keyagree>
+ *     read       <oid> <max length>
+ *     lifecycle  <oid> <expected state>
+ *     report_key <oid>
+ */
+static int optiga_provision_parse_manifest(const char * path)
+{
+    static char line[OPTIGA_PROVISION_MAX_LINE_LENGTH];
+    char * argv[4];
+    uint8_t argc;
+    uint32_t line_number = 0;
+    optiga_provision_item_t * item;
+    FILE * file;
+    unsigned long value;
+    int status = 0;
+
+    file = fopen(path, "r");
+    if (NULL == file)
+    {
+        fprintf(stderr, "cannot open manifest %s\n", path);
+        return -1;
+    }
+
+    while ((0 == status) && (NULL != fgets(line, sizeof(line), file)))
+    {
+        line_number++;
+        if (NULL != strchr(line, '#'))
+        {
+            *strchr(line, '#') = '\0';
+        }
+        for (argc = 0; argc < 4; argc++)
+        {
+            argv[argc] = strtok((0 == argc) ? line : NULL, " \t\r\n");
+            if (NULL == argv[argc])
+            {
+                break;
+            }
+        }
+        if (0 == argc)
+        {
+            continue;
+        }
+
+        status = -1;
+        if ((argc < 2) || (OPTIGA_PROVISION_MAX_ITEMS == manifest.item_count))
+        {
+            break;
+        }
+        item = &manifest.items[manifest.item_count];
+        memset(item, 0, sizeof(*item));
+        item->oid = (uint16_t)strtoul(argv[1], NULL, 16);
+
+        if (0 == strcmp(argv[0], "report_key"))
+        {
+            manifest.report_key = item->oid;
+            status = 0;
+            continue;
+        }
+        if ((0 == strcmp(argv[0], "write")) && (argc >= 3))
+        {
+            item->type = OPTIGA_PROVISION_WRITE;
+            item->param = ((4 == argc) && (0 == strcmp(argv[3], "append"))) ?
+                          OPTIGA_UTIL_WRITE_ONLY : OPTIGA_UTIL_ERASE_AND_WRITE;
+            status = optiga_provision_load_data(argv[2], item);
+#ifdef OPTIGA_UTIL_CERT_COMPRESSION
+            if ((0 == status) && (4 == argc) && (0 == strcmp(argv[3], "compress")))
+            {
+                optiga_provision_compress(item);
+                item->compressed = TRUE;
+            }
+#endif
+            if ((0 == status) && (OPTIGA_UTIL_WRITE_ONLY == item->param))
+            {
+                status = optiga_provision_merge_write(item);
+                if (0 == status)
+                {
+                    //Merged, no directive of its own
+                    continue;
+                }
+                status = (1 == status) ? 0 : -1;
+            }
+        }
+        else if ((0 == strcmp(argv[0], "metadata")) && (3 == argc))
+        {
+            item->type = OPTIGA_PROVISION_METADATA;
+            status = optiga_provision_load_data(argv[2], item);
+        }
+        else if ((0 == strcmp(argv[0], "keygen")) && (4 == argc))
+        {
+            item->type = OPTIGA_PROVISION_KEYGEN;
+            item->param = (0 == strcmp(argv[2], "p384")) ? (uint8_t)OPTIGA_ECC_NIST_P_384 : (uint8_t)OPTIGA_ECC_NIST_P_256;
+            status = optiga_provision_parse_usage(argv[3], &item->key_usage);
+        }
+        else if ((0 == strcmp(argv[0], "read")) && (3 == argc))
+        {
+            item->type = OPTIGA_PROVISION_READ;
+            value = strtoul(argv[2], NULL, 0);
+            item->data_length = (uint16_t)value;
+            status = ((0 != value) && (value <= OPTIGA_PROVISION_MAX_DATA_LENGTH)) ? 0 : -1;
+        }
+        else if ((0 == strcmp(argv[0], "lifecycle")) && (3 == argc))
+        {
+            item->type = OPTIGA_PROVISION_LIFECYCLE;
+            item->param = (uint8_t)strtoul(argv[2], NULL, 16);
+            status = 0;
+        }
+
+        if (0 == status)
+        {
+            manifest.item_count++;
+        }
+    }
+    fclose(file);
+
+    if (0 != status)
+    {
+        fprintf(stderr, "%s:%u: invalid directive\n", path, line_number);
+    }
+    return status;
+}
+
+/**
+ * Signs the report with the report key, over the SHA-256 digest calculated by the device.
+ * The host composes the report, so the signature is self-asserted and is no attestation of its content.
+ */
+static void optiga_provision_sign_report(void)
+{
+    optiga_lib_status_t return_status;
+    uint8_t hash_context_buffer[130];
+    optiga_hash_context_t hash_context;
+    hash_data_from_host_t hash_data_host;
+    uint8_t digest[32];
+    uint8_t signature[110];
+    uint16_t signature_length = sizeof(signature);
+    size_t offset;
+
+    do
+    {
+        hash_context.context_buffer = hash_context_buffer;
+        hash_context.context_buffer_length = sizeof(hash_context_buffer);
+        hash_context.hash_algo = (uint8_t)OPTIGA_HASH_TYPE_SHA_256;
+
+        return_status = optiga_crypt_hash_start(&hash_context);
+        for (offset = 0; (OPTIGA_LIB_SUCCESS == return_status) && (offset < report.length);
+             offset += OPTIGA_PROVISION_HASH_CHUNK_LENGTH)
+        {
+            hash_data_host.buffer = (const uint8_t *)report.text + offset;
+            hash_data_host.length = (uint32_t)(report.length - offset);
+            if (hash_data_host.length > OPTIGA_PROVISION_HASH_CHUNK_LENGTH)
+            {
+                hash_data_host.length = OPTIGA_PROVISION_HASH_CHUNK_LENGTH;
+            }
+            return_status = optiga_crypt_hash_update(&hash_context, OPTIGA_CRYPT_HOST_DATA, &hash_data_host);
+        }
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        return_status = optiga_crypt_hash_finalize(&hash_context, digest);
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+
+        return_status = optiga_crypt_ecdsa_sign(digest, sizeof(digest), (optiga_key_id_t)manifest.report_key,
+                                                signature, &signature_length);
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+
+        //The signature covers the report up to this line
+        optiga_provision_report_add("signature %04X ", manifest.report_key);
+        optiga_provision_report_hex(signature, signature_length);
+        optiga_provision_report_add("\n");
+    } while (FALSE);
+
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        optiga_provision_report_add("signature %04X failed 0x%04X\n", manifest.report_key, return_status);
+    }
+}
+
+/**
+ * Provisions the device. Writes and metadata updates are executed in manifest order, then key generation
+ * is executed as a single command program and the objects are read back.
+ */
+static int optiga_provision_device(const char * device)
+{
+    optiga_lib_status_t return_status;
+    optiga_crypt_step_t steps[OPTIGA_PROVISION_MAX_ITEMS];
+    uint8_t coprocessor_uid[OPTIGA_PROVISION_UID_LENGTH];
+    uint16_t uid_length = sizeof(coprocessor_uid);
+    uint8_t * outputs[OPTIGA_PROVISION_MAX_ITEMS] = {NULL};
+    uint16_t output_lengths[OPTIGA_PROVISION_MAX_ITEMS];
+    optiga_lib_status_t output_status[OPTIGA_PROVISION_MAX_ITEMS];
+    optiga_provision_item_t * item;
+    uint8_t step_count = 0;
+    uint8_t failed_step = 0;
+    uint8_t index;
+    uint32_t start_time = optiga_provision_time_ms();
+    uint32_t operation_time;
+    bool_t application_open = FALSE;
+    int result = -1;
+
+    i2c_if = (char *)device;
+    optiga_provision_report_add("device %s\n", device);
+
+    do
+    {
+        operation_time = optiga_provision_time_ms();
+        //The timer of the Linux PAL is created here, whether or not the library is built with PAL_OS_HAS_EVENT_INIT
+        pal_os_event_init();
+        return_status = optiga_util_open_application(&optiga_comms);
+        optiga_provision_report_add("open_application 0x%04X %u ms\n", return_status,
+                                    optiga_provision_time_ms() - operation_time);
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        application_open = TRUE;
+
+        for (index = 0; index < manifest.item_count; index++)
+        {
+            item = &manifest.items[index];
+            operation_time = optiga_provision_time_ms();
+            if (OPTIGA_PROVISION_WRITE == item->type)
+            {
+                return_status = optiga_util_write_data(item->oid, item->param, 0x00, item->data, item->data_length);
+                optiga_provision_report_add("write %04X %u bytes", item->oid, item->data_length);
+            }
+            else if (OPTIGA_PROVISION_METADATA == item->type)
+            {
+                return_status = optiga_util_write_metadata(item->oid, item->data, (uint8_t)item->data_length);
+                optiga_provision_report_add("metadata %04X", item->oid);
+            }
+            else
+            {
+                continue;
+            }
+            optiga_provision_report_add(" 0x%04X %u ms\n", return_status, optiga_provision_time_ms() - operation_time);
+            if (OPTIGA_LIB_SUCCESS != return_status)
+            {
+                break;
+            }
+        }
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+
+        //All key slots are generated as one program, no other command is interleaved
+        memset(steps, 0, sizeof(steps));
+        for (index = 0; index < manifest.item_count; index++)
+        {
+            item = &manifest.items[index];
+            switch (item->type)
+            {
+                case OPTIGA_PROVISION_KEYGEN:
+                    output_lengths[index] = OPTIGA_PROVISION_MAX_PUBKEY_LENGTH;
+                break;
+                case OPTIGA_PROVISION_READ:
+                    output_lengths[index] = item->data_length;
+                break;
+                case OPTIGA_PROVISION_LIFECYCLE:
+                    output_lengths[index] = 1;
+                break;
+                default:
+                    continue;
+            }
+            output_status[index] = OPTIGA_CRYPT_STEP_NOT_EXECUTED;
+            outputs[index] = malloc(output_lengths[index]);
+            if (NULL == outputs[index])
+            {
+                return_status = OPTIGA_LIB_ERROR;
+                break;
+            }
+            if (OPTIGA_PROVISION_KEYGEN == item->type)
+            {
+                steps[step_count].type = OPTIGA_CRYPT_STEP_ECC_GENERATE_KEYPAIR;
+                steps[step_count].target_oid = item->oid;
+                steps[step_count].param = item->param;
+                steps[step_count].key_usage = item->key_usage;
+                steps[step_count].output = outputs[index];
+                steps[step_count].output_length = output_lengths[index];
+                step_count++;
+            }
+        }
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+
+        if (0 != step_count)
+        {
+            operation_time = optiga_provision_time_ms();
+            return_status = optiga_crypt_execute_program(steps, step_count, &failed_step);
+            optiga_provision_report_add("program %u steps 0x%04X %u ms\n", step_count, return_status,
+                                        optiga_provision_time_ms() - operation_time);
+            if (OPTIGA_LIB_SUCCESS != return_status)
+            {
+                //The outputs of the failed step and of the steps not executed are not reported
+                step_count = 0;
+                for (index = 0; index < manifest.item_count; index++)
+                {
+                    if (OPTIGA_PROVISION_KEYGEN == manifest.items[index].type)
+                    {
+                        optiga_provision_report_add("keygen %04X 0x%04X\n", manifest.items[index].oid,
+                                                    steps[step_count].status);
+                        step_count++;
+                    }
+                }
+                optiga_provision_report_add("program failed at step %u\n", failed_step);
+                break;
+            }
+        }
+
+        return_status = optiga_util_read_data(eCOPROCESSOR_UID, 0x0000, coprocessor_uid, &uid_length);
+        optiga_provision_report_add("uid 0x%04X ", return_status);
+        if (OPTIGA_LIB_SUCCESS == return_status)
+        {
+            optiga_provision_report_hex(coprocessor_uid, uid_length);
+        }
+        optiga_provision_report_add("\n");
+
+        step_count = 0;
+        for (index = 0; index < manifest.item_count; index++)
+        {
+            item = &manifest.items[index];
+            if (NULL == outputs[index])
+            {
+                continue;
+            }
+            if (OPTIGA_PROVISION_KEYGEN == item->type)
+            {
+                output_status[index] = steps[step_count].status;
+                output_lengths[index] = steps[step_count].output_length;
+                step_count++;
+                optiga_provision_report_add("keygen %04X 0x%04X ", item->oid, output_status[index]);
+            }
+            else
+            {
+                output_status[index] = optiga_util_read_data(item->oid, 0x0000, outputs[index], &output_lengths[index]);
+                if (OPTIGA_PROVISION_READ == item->type)
+                {
+                    optiga_provision_report_add("read %04X 0x%04X ", item->oid, output_status[index]);
+                }
+                else
+                {
+                    optiga_provision_report_add("lifecycle %04X expected %02X 0x%04X ",
+                                                item->oid, item->param, output_status[index]);
+                    if ((OPTIGA_LIB_SUCCESS == output_status[index]) &&
+                        ((1 != output_lengths[index]) || (item->param != outputs[index][0])))
+                    {
+                        return_status = OPTIGA_LIB_ERROR;
+                    }
+                }
+            }
+            if (OPTIGA_LIB_SUCCESS == output_status[index])
+            {
+                optiga_provision_report_hex(outputs[index], output_lengths[index]);
+            }
+            else
+            {
+                return_status = output_status[index];
+            }
+            optiga_provision_report_add("\n");
+        }
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        result = 0;
+    } while (FALSE);
+
+    optiga_provision_report_add("result %s\n", (0 == result) ? "ok" : "failed");
+    optiga_provision_report_add("time %u ms\n", optiga_provision_time_ms() - start_time);
+
+    //A report of a device which could not be opened cannot be signed
+    if ((0x0000 != manifest.report_key) && (TRUE == application_open))
+    {
+        optiga_provision_sign_report();
+    }
+
+    for (index = 0; index < manifest.item_count; index++)
+    {
+        free(outputs[index]);
+    }
+    return result;
+}
+
+static int optiga_provision_write_report(const char * device, const char * report_dir)
+{
+    char path[512];
+    const char * name = strrchr(device, '/');
+    FILE * file;
+    int status = -1;
+
+    snprintf(path, sizeof(path), "%s/%s.txt", report_dir, (NULL != name) ? name + 1 : device);
+    file = fopen(path, "w");
+    if (NULL != file)
+    {
+        if (report.length == fwrite(report.text, 1, report.length, file))
+        {
+            status = 0;
+        }
+        fclose(file);
+    }
+    return status;
+}
+
+static void optiga_provision_usage(const char * name)
+{
+    fprintf(stderr, "usage: %s -m <manifest> [-o <report directory>] <i2c device>...\n", name);
+    fprintf(stderr, "Devices are I2C buses (e.g. /dev/i2c-1), USB dongles are not supported.\n");
+}
+
+/**
+ * Provisions every device given on the command line in its own process, so the devices are programmed in parallel.
+ * A report is written per device and the timing of every device is printed.
+ */
+int main(int argc, char * argv[])
+{
+    const char * manifest_path = NULL;
+    const char * report_dir = ".";
+    pid_t pids[OPTIGA_PROVISION_MAX_DEVICES];
+    uint32_t end_times[OPTIGA_PROVISION_MAX_DEVICES];
+    int results[OPTIGA_PROVISION_MAX_DEVICES];
+    uint32_t start_time;
+    uint8_t device_count;
+    uint8_t done = 0;
+    uint8_t passed = 0;
+    uint8_t index;
+    int option;
+    int wait_status;
+    pid_t pid;
+
+    while (-1 != (option = getopt(argc, argv, "m:o:")))
+    {
+        if ('m' == option)
+        {
+            manifest_path = optarg;
+        }
+        else if ('o' == option)
+        {
+            report_dir = optarg;
+        }
+        else
+        {
+            optiga_provision_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if ((NULL == manifest_path) || (optind == argc) || ((argc - optind) > OPTIGA_PROVISION_MAX_DEVICES))
+    {
+        optiga_provision_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (0 != optiga_provision_parse_manifest(manifest_path))
+    {
+        return EXIT_FAILURE;
+    }
+
+    device_count = (uint8_t)(argc - optind);
+    start_time = optiga_provision_time_ms();
+    fflush(stdout);
+    for (index = 0; index < device_count; index++)
+    {
+        pids[index] = fork();
+        if (0 == pids[index])
+        {
+            option = optiga_provision_device(argv[optind + index]);
+            if (0 != optiga_provision_write_report(argv[optind + index], report_dir))
+            {
+                option = -1;
+            }
+            _exit((0 == option) ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        results[index] = (pids[index] < 0) ? -1 : 1;
+        end_times[index] = start_time;
+        if (pids[index] < 0)
+        {
+            done++;
+        }
+    }
+
+    while (done < device_count)
+    {
+        pid = wait(&wait_status);
+        if (pid < 0)
+        {
+            break;
+        }
+        for (index = 0; index < device_count; index++)
+        {
+            if (pid == pids[index])
+            {
+                end_times[index] = optiga_provision_time_ms();
+                results[index] = (WIFEXITED(wait_status) && (EXIT_SUCCESS == WEXITSTATUS(wait_status))) ? 0 : -1;
+                done++;
+            }
+        }
+    }
+
+    for (index = 0; index < device_count; index++)
+    {
+        printf("%-24s %-6s %6.2f s\n", argv[optind + index], (0 == results[index]) ? "ok" : "failed",
+               (end_times[index] - start_time) / 1000.0);
+        passed += (0 == results[index]) ? 1 : 0;
+    }
+    printf("%u of %u devices provisioned in %.2f s, %.2f s per device\n", passed, device_count,
+           (optiga_provision_time_ms() - start_time) / 1000.0,
+           (optiga_provision_time_ms() - start_time) / 1000.0 / device_count);
+
+    return (passed == device_count) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+* @}
+*/
@@ -0,0 +1,496 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \file
+*
+* \brief   This file implements the OPTIGA cluster APIs.
+*
+* \ingroup  grOptigaCluster
+* @{
+*/
+
+#include <string.h>
+#include "optiga/optiga_cluster.h"
+#include "optiga/optiga_util.h"
+#include "optiga/pal/pal_os_lock.h"
+#include "optiga/pal/pal_os_timer.h"
+
+#if defined(MODULE_ENABLE_TOOLBOX) && defined(MODULE_ENABLE_READ_WRITE)
+
+/// @cond hidden
+///Request can be served by any node
+#define OPTIGA_CLUSTER_ANY_NODE         (0xFF)
+///Size of the buffer a certificate is read into
+#define OPTIGA_CLUSTER_CERT_LENGTH      (1728)
+
+///Executes a request on the node selected in the command library with the key OID, if any
+typedef int32_t (*optiga_cluster_request_t)(void * args, uint16_t oid);
+
+typedef struct optiga_cluster_sign_args
+{
+    uint8_t * digest;
+    uint8_t digest_length;
+    uint8_t * signature;
+    uint16_t * signature_length;
+} optiga_cluster_sign_args_t;
+
+typedef struct optiga_cluster_verify_args
+{
+    uint8_t * digest;
+    uint8_t digest_length;
+    uint8_t * signature;
+    uint16_t signature_length;
+    const public_key_from_host_t * public_key;
+} optiga_cluster_verify_args_t;
+
+typedef struct optiga_cluster_random_args
+{
+    optiga_rng_types_t rng_type;
+    uint8_t * random_data;
+    uint16_t random_data_length;
+} optiga_cluster_random_args_t;
+
+static int32_t __optiga_cluster_sign(void * args, uint16_t oid)
+{
+    optiga_cluster_sign_args_t * sign_args = (optiga_cluster_sign_args_t *)args;
+    sCalcSignOptions_d sign_options;
+    sbBlob_d sign;
+    int32_t return_value;
+
+    sign_options.eSignScheme = eECDSA_FIPS_186_3_WITHOUT_HASH;
+    sign_options.wOIDSignKey = oid;
+    sign_options.sDigestToSign.prgbStream = sign_args->digest;
+    sign_options.sDigestToSign.wLen       = sign_args->digest_length;
+
+    sign.prgbStream = sign_args->signature;
+    sign.wLen       = *sign_args->signature_length;
+
+    return_value = CmdLib_CalculateSign(&sign_options, &sign);
+    if (CMD_LIB_OK == return_value)
+    {
+        *sign_args->signature_length = sign.wLen;
+    }
+    return return_value;
+}
+
+static int32_t __optiga_cluster_verify(void * args, uint16_t oid)
+{
+    optiga_cluster_verify_args_t * verify_args = (optiga_cluster_verify_args_t *)args;
+    sVerifyOption_d verifysign_options;
+    sbBlob_d sign, dgst;
+
+    verifysign_options.eSignScheme         = eECDSA_FIPS_186_3_WITHOUT_HASH;
+    verifysign_options.eVerifyDataType     = eDataStream;
+    verifysign_options.sPubKeyInput.eAlgId = (eAlgId_d)verify_args->public_key->curve;
+    verifysign_options.sPubKeyInput.sDataStream.prgbStream = verify_args->public_key->public_key;
+    verifysign_options.sPubKeyInput.sDataStream.wLen       = verify_args->public_key->length;
+
+    dgst.prgbStream = verify_args->digest;
+    dgst.wLen       = verify_args->digest_length;
+
+    sign.prgbStream = verify_args->signature;
+    sign.wLen       = verify_args->signature_length;
+
+    return CmdLib_VerifySign(&verifysign_options, &dgst, &sign);
+}
+
+static int32_t __optiga_cluster_random(void * args, uint16_t oid)
+{
+    optiga_cluster_random_args_t * random_args = (optiga_cluster_random_args_t *)args;
+    sRngOptions_d rand_options;
+    sCmdResponse_d rand_response;
+
+    rand_options.eRngType       = (eRngType_d)random_args->rng_type;
+    rand_options.wRandomDataLen = random_args->random_data_length;
+
+    rand_response.prgbBuffer    = random_args->random_data;
+    rand_response.wBufferLength = random_args->random_data_length;
+    rand_response.wRespLength   = 0;
+
+    return CmdLib_GetRandom(&rand_options, &rand_response);
+}
+
+//Marks the node as lost, it is tried again after OPTIGA_CLUSTER_RETRY_INTERVAL_MS
+static void __optiga_cluster_node_lost(optiga_cluster_node_t * node)
+{
+    node->alive = FALSE;
+    node->down_since = pal_os_timer_get_time_in_milliseconds();
+    optiga_comms_close(node->p_comms);
+}
+
+//Checks whether the metadata of the key object allows signing. Metadata without key usage is not a candidate.
+static uint8_t __optiga_cluster_is_signing_key(const optiga_util_metadata_t * metadata)
+{
+    if ((0 == (OPTIGA_UTIL_METADATA_KEY_USAGE & metadata->present)) ||
+        (0 == (OPTIGA_UTIL_METADATA_ALGORITHM & metadata->present)))
+    {
+        return FALSE;
+    }
+    return (metadata->key_usage & (OPTIGA_KEY_USAGE_AUTHENTICATION | OPTIGA_KEY_USAGE_SIGN)) ? TRUE : FALSE;
+}
+
+//Opens the application on the node and takes the inventory of its signing keys from their metadata.
+//The OPTIGA lock must be held, the command library is left with the comms context of the node.
+static uint8_t __optiga_cluster_node_open(optiga_cluster_node_t * node)
+{
+    optiga_util_metadata_t metadata;
+    optiga_lib_status_t status;
+    uint8_t slot;
+
+    if (OPTIGA_LIB_SUCCESS != optiga_util_open_application(node->p_comms))
+    {
+        return FALSE;
+    }
+
+    for (slot = 0; slot < OPTIGA_CLUSTER_KEY_SLOTS; slot++)
+    {
+        node->key_algorithm[slot] = 0;
+        status = optiga_util_get_metadata((uint16_t)(eFIRST_DEVICE_PRIKEY_1 + slot), &metadata);
+        if ((int32_t)CMD_DEV_EXEC_ERROR == (int32_t)status)
+        {
+            optiga_comms_close(node->p_comms);
+            return FALSE;
+        }
+        if ((OPTIGA_LIB_SUCCESS == status) && (__optiga_cluster_is_signing_key(&metadata)))
+        {
+            node->key_algorithm[slot] = metadata.algorithm;
+        }
+    }
+    return TRUE;
+}
+
+//Checks whether the node can serve requests, a lost node is reopened once the retry interval is elapsed
+static uint8_t __optiga_cluster_node_available(optiga_cluster_node_t * node)
+{
+    if ((!node->alive) &&
+        ((uint32_t)(pal_os_timer_get_time_in_milliseconds() - node->down_since) >= OPTIGA_CLUSTER_RETRY_INTERVAL_MS))
+    {
+        if (__optiga_cluster_node_open(node))
+        {
+            node->alive = TRUE;
+        }
+        else
+        {
+            node->down_since = pal_os_timer_get_time_in_milliseconds();
+        }
+    }
+    return node->alive;
+}
+
+//Checks whether the certificate holds the public key, as the subject public key of the DER encoding
+static uint8_t __optiga_cluster_cert_holds_key(const uint8_t * cert, uint16_t cert_length,
+                                               const public_key_from_host_t * public_key)
+{
+    uint16_t offset;
+
+    if ((0 == public_key->length) || (public_key->length > cert_length))
+    {
+        return FALSE;
+    }
+    for (offset = 0; offset <= (cert_length - public_key->length); offset++)
+    {
+        if (0 == memcmp(&cert[offset], public_key->public_key, public_key->length))
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+//Executes the request on the least used available node, which holds the key if key_id is not OPTIGA_CLUSTER_ANY_NODE.
+//A node lost during the request is marked and the request is repeated on the next node.
+static optiga_lib_status_t __optiga_cluster_dispatch(optiga_cluster_t * cluster,
+                                                     uint8_t key_id,
+                                                     optiga_cluster_request_t request,
+                                                     void * args)
+{
+    optiga_lib_status_t return_value = OPTIGA_CLUSTER_ERROR_NO_NODE;
+    optiga_comms_t * p_previous_comms;
+    uint8_t tried[OPTIGA_CLUSTER_MAX_NODES] = {0};
+    uint8_t selected;
+    uint8_t index;
+    uint8_t node;
+    uint16_t oid = 0x0000;
+    uint16_t candidate_oid;
+    int32_t status;
+
+    while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS)
+    {
+    }
+    p_previous_comms = CmdLib_GetOptigaCommsContext();
+
+    for (;;)
+    {
+        selected = OPTIGA_CLUSTER_ANY_NODE;
+        for (index = 0; index < ((OPTIGA_CLUSTER_ANY_NODE == key_id) ? cluster->node_count : cluster->placement_count); index++)
+        {
+            node = index;
+            candidate_oid = 0x0000;
+            if (OPTIGA_CLUSTER_ANY_NODE != key_id)
+            {
+                if (key_id != cluster->placements[index].key_id)
+                {
+                    continue;
+                }
+                node = cluster->placements[index].node;
+                candidate_oid = cluster->placements[index].oid;
+            }
+
+            if ((tried[node]) || (!__optiga_cluster_node_available(&cluster->nodes[node])))
+            {
+                continue;
+            }
+            if ((OPTIGA_CLUSTER_ANY_NODE == selected) || (cluster->nodes[node].served < cluster->nodes[selected].served))
+            {
+                selected = node;
+                oid = candidate_oid;
+            }
+        }
+
+        if (OPTIGA_CLUSTER_ANY_NODE == selected)
+        {
+            break;
+        }
+        tried[selected] = TRUE;
+
+        CmdLib_SetOptigaCommsContext(cluster->nodes[selected].p_comms);
+        status = request(args, oid);
+        if ((int32_t)CMD_DEV_EXEC_ERROR == status)
+        {
+            __optiga_cluster_node_lost(&cluster->nodes[selected]);
+            continue;
+        }
+
+        cluster->nodes[selected].served++;
+        return_value = (CMD_LIB_OK == status) ? OPTIGA_CLUSTER_SUCCESS : (optiga_lib_status_t)status;
+        break;
+    }
+
+    CmdLib_SetOptigaCommsContext(p_previous_comms);
+    pal_os_lock_release();
+
+    return return_value;
+}
+
+/// @endcond
+
+optiga_lib_status_t optiga_cluster_add_node(optiga_cluster_t * cluster,
+                                            optiga_comms_t * p_comms)
+{
+    optiga_lib_status_t return_value = OPTIGA_CLUSTER_ERROR_INVALID_INPUT;
+    optiga_cluster_node_t * node;
+    optiga_comms_t * p_previous_comms;
+
+    do
+    {
+        if ((NULL == cluster) || (NULL == p_comms))
+        {
+            break;
+        }
+        if (OPTIGA_CLUSTER_MAX_NODES == cluster->node_count)
+        {
+            return_value = OPTIGA_CLUSTER_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+
+        node = &cluster->nodes[cluster->node_count++];
+        node->p_comms = p_comms;
+        node->served = 0;
+        node->alive = FALSE;
+
+        while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS)
+        {
+        }
+        p_previous_comms = CmdLib_GetOptigaCommsContext();
+        if (__optiga_cluster_node_open(node))
+        {
+            node->alive = TRUE;
+        }
+        CmdLib_SetOptigaCommsContext(p_previous_comms);
+        pal_os_lock_release();
+
+        if (!node->alive)
+        {
+            node->down_since = pal_os_timer_get_time_in_milliseconds();
+            return_value = OPTIGA_CLUSTER_ERROR_NO_NODE;
+            break;
+        }
+        return_value = OPTIGA_CLUSTER_SUCCESS;
+    } while (FALSE);
+
+    return return_value;
+}
+
+optiga_lib_status_t optiga_cluster_register_key(optiga_cluster_t * cluster,
+                                                const public_key_from_host_t * public_key,
+                                                uint8_t * key_id)
+{
+    optiga_lib_status_t return_value = OPTIGA_CLUSTER_ERROR_INVALID_INPUT;
+    optiga_comms_t * p_previous_comms;
+    uint8_t cert[OPTIGA_CLUSTER_CERT_LENGTH];
+    uint16_t cert_length;
+    uint8_t placed = 0;
+    uint8_t node;
+    uint8_t slot;
+    int32_t status;
+
+    do
+    {
+        if ((NULL == cluster) || (NULL == public_key) || (NULL == key_id))
+        {
+            break;
+        }
+
+        return_value = OPTIGA_CLUSTER_SUCCESS;
+        while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS)
+        {
+        }
+        p_previous_comms = CmdLib_GetOptigaCommsContext();
+        for (node = 0; (node < cluster->node_count) && (OPTIGA_CLUSTER_SUCCESS == return_value); node++)
+        {
+            for (slot = 0; slot < OPTIGA_CLUSTER_KEY_SLOTS; slot++)
+            {
+                if (!__optiga_cluster_node_available(&cluster->nodes[node]))
+                {
+                    break;
+                }
+                //Only signing keys of the curve of the public key, from the inventory of the node
+                if (public_key->curve != cluster->nodes[node].key_algorithm[slot])
+                {
+                    continue;
+                }
+                CmdLib_SetOptigaCommsContext(cluster->nodes[node].p_comms);
+
+                //The certificate object with the index of the key object holds its public key
+                cert_length = sizeof(cert);
+#ifdef OPTIGA_UTIL_CERT_COMPRESSION
+                status = (int32_t)optiga_util_read_cert((uint16_t)(eDEVICE_PUBKEY_CERT_IFX + slot), cert, &cert_length);
+#else
+                status = (int32_t)optiga_util_read_data((uint16_t)(eDEVICE_PUBKEY_CERT_IFX + slot), 0, cert, &cert_length);
+#endif
+                if ((int32_t)CMD_DEV_EXEC_ERROR == status)
+                {
+                    __optiga_cluster_node_lost(&cluster->nodes[node]);
+                    break;
+                }
+                if ((OPTIGA_LIB_SUCCESS != status) || (!__optiga_cluster_cert_holds_key(cert, cert_length, public_key)))
+                {
+                    continue;
+                }
+
+                if (OPTIGA_CLUSTER_MAX_PLACEMENTS == cluster->placement_count)
+                {
+                    return_value = OPTIGA_CLUSTER_ERROR_MEMORY_INSUFFICIENT;
+                    break;
+                }
+                cluster->placements[cluster->placement_count].key_id = cluster->key_count;
+                cluster->placements[cluster->placement_count].node = node;
+                cluster->placements[cluster->placement_count].oid = (uint16_t)(eFIRST_DEVICE_PRIKEY_1 + slot);
+                cluster->placement_count++;
+                placed++;
+            }
+        }
+        CmdLib_SetOptigaCommsContext(p_previous_comms);
+        pal_os_lock_release();
+
+        if (0 == placed)
+        {
+            return_value = (OPTIGA_CLUSTER_SUCCESS == return_value) ? OPTIGA_CLUSTER_ERROR_KEY_NOT_FOUND : return_value;
+            break;
+        }
+        *key_id = cluster->key_count++;
+    } while (FALSE);
+
+    return return_value;
+}
+
+optiga_lib_status_t optiga_cluster_sign(optiga_cluster_t * cluster,
+                                        uint8_t key_id,
+                                        uint8_t * digest,
+                                        uint8_t digest_length,
+                                        uint8_t * signature,
+                                        uint16_t * signature_length)
+{
+    optiga_cluster_sign_args_t sign_args;
+
+    if ((NULL == cluster) || (NULL == digest) || (NULL == signature) || (NULL == signature_length) ||
+        (key_id >= cluster->key_count))
+    {
+        return OPTIGA_CLUSTER_ERROR_INVALID_INPUT;
+    }
+
+    sign_args.digest = digest;
+    sign_args.digest_length = digest_length;
+    sign_args.signature = signature;
+    sign_args.signature_length = signature_length;
+
+    return __optiga_cluster_dispatch(cluster, key_id, __optiga_cluster_sign, &sign_args);
+}
+
+optiga_lib_status_t optiga_cluster_verify(optiga_cluster_t * cluster,
+                                          uint8_t * digest,
+                                          uint8_t digest_length,
+                                          uint8_t * signature,
+                                          uint16_t signature_length,
+                                          public_key_from_host_t * public_key)
+{
+    optiga_cluster_verify_args_t verify_args;
+
+    if ((NULL == cluster) || (NULL == digest) || (NULL == signature) || (NULL == public_key))
+    {
+        return OPTIGA_CLUSTER_ERROR_INVALID_INPUT;
+    }
+
+    verify_args.digest = digest;
+    verify_args.digest_length = digest_length;
+    verify_args.signature = signature;
+    verify_args.signature_length = signature_length;
+    verify_args.public_key = public_key;
+
+    return __optiga_cluster_dispatch(cluster, OPTIGA_CLUSTER_ANY_NODE, __optiga_cluster_verify, &verify_args);
+}
+
+optiga_lib_status_t optiga_cluster_random(optiga_cluster_t * cluster,
+                                          optiga_rng_types_t rng_type,
+                                          uint8_t * random_data,
+                                          uint16_t random_data_length)
+{
+    optiga_cluster_random_args_t random_args;
+
+    if ((NULL == cluster) || (NULL == random_data))
+    {
+        return OPTIGA_CLUSTER_ERROR_INVALID_INPUT;
+    }
+
+    random_args.rng_type = rng_type;
+    random_args.random_data = random_data;
+    random_args.random_data_length = random_data_length;
+
+    return __optiga_cluster_dispatch(cluster, OPTIGA_CLUSTER_ANY_NODE, __optiga_cluster_random, &random_args);
+}
+
+#endif // MODULE_ENABLE_TOOLBOX && MODULE_ENABLE_READ_WRITE
+
+/**
+* @}
+*/
@@ -0,0 +1,78 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file optiga_cluster_sim.h
+*
+* \brief   Keys of the simulated OPTIGA nodes, shared by the node and the cluster test.
+*
+* \ingroup  grOptigaCluster
+* @{
+*/
+
+#ifndef _OPTIGA_CLUSTER_SIM_H_
+#define _OPTIGA_CLUSTER_SIM_H_
+
+#include <stdint.h>
+
+///Key store objects E0F0 - E0F3 of a simulated node
+#define OPTIGA_CLUSTER_SIM_KEY_SLOTS            (4)
+///Public key as DER encoded BIT STRING of an uncompressed NIST P-256 point
+#define OPTIGA_CLUSTER_SIM_PUBLIC_KEY_LENGTH    (68)
+///Largest data object of a simulated node
+#define OPTIGA_CLUSTER_SIM_OBJECT_LENGTH        (128)
+///Data object with the number of signatures calculated by the node
+#define OPTIGA_CLUSTER_SIM_SIGN_COUNT_OID       (0xF1D0)
+
+/**
+ * \brief Derives the public key of a simulated key from its seed.
+ *
+ * \param[in]   seed            Seed of the key
+ * \param[out]  public_key      Buffer of #OPTIGA_CLUSTER_SIM_PUBLIC_KEY_LENGTH bytes
+ *
+ * \retval      #OPTIGA_CLUSTER_SIM_PUBLIC_KEY_LENGTH
+ */
+static inline uint16_t optiga_cluster_sim_public_key(uint8_t seed, uint8_t * public_key)
+{
+    uint8_t index;
+
+    public_key[0] = 0x03;
+    public_key[1] = 0x42;
+    public_key[2] = 0x00;
+    public_key[3] = 0x04;
+    for (index = 0; index < 64; index++)
+    {
+        public_key[4 + index] = (uint8_t)((seed * 31) + (index * 7) + 1);
+    }
+    return OPTIGA_CLUSTER_SIM_PUBLIC_KEY_LENGTH;
+}
+
+#endif //_OPTIGA_CLUSTER_SIM_H_
+
+/**
+* @}
+*/
@@ -0,0 +1,337 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file optiga_cluster_sim_node.c
+*
+* \brief   Node of the cluster test harness: a simulated OPTIGA served by the optiga comms over TCP bridge.
+*
+*          optiga_cluster_sim_node <port> [<slot>:<seed> ...]
+*
+*          Every <slot>:<seed> puts a signing key into E0F0 + slot, its certificate into E0E0 + slot. The public key
+*          is derived from the seed byte, see #optiga_cluster_sim_public_key. Signatures are not real ECDSA: the
+*          signature of a digest is the digest XOR the public key, which is enough to check the routing.
+*          The number of signatures calculated is readable from data object F1D0.
+*
+*          gcc -Ioptiga/include -Ipal/linux optiga/cluster/test/optiga_cluster_sim_node.c
+*              pal/linux/optiga_comms_tcp_bridge.c pal/linux/pal_os_timer.c optiga/common/Util.c -o optiga_cluster_sim_node
+*
+* \ingroup  grOptigaCluster
+* @{
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "optiga/comms/optiga_comms.h"
+#include "optiga/common/Util.h"
+#include "optiga_comms_tcp.h"
+#include "optiga_cluster_sim.h"
+
+optiga_comms_t optiga_comms = {NULL, NULL, NULL, 0};
+
+/// @cond hidden
+#define SIM_STATUS_OK               (0x00)
+#define SIM_STATUS_ERROR            (0xFF)
+
+#define SIM_CMD_GETDATA             (0x01)
+#define SIM_CMD_GET_RND             (0x0C)
+#define SIM_CMD_CALC_SIGN           (0x31)
+#define SIM_CMD_VERIFY_SIGN         (0x32)
+#define SIM_CMD_OPEN_APP            (0xF0)
+
+///Error codes of the error code object F1C2
+#define SIM_ERROR_INVALID_OID       (0x01)
+#define SIM_ERROR_INVALID_PARAM     (0x03)
+#define SIM_ERROR_OUT_OF_BOUND      (0x08)
+#define SIM_ERROR_SIGNATURE         (0x2C)
+
+static uint8_t sim_key_seed[OPTIGA_CLUSTER_SIM_KEY_SLOTS];
+static uint8_t sim_has_key[OPTIGA_CLUSTER_SIM_KEY_SLOTS];
+static uint8_t sim_last_error;
+static uint8_t sim_sign_count;
+static uint8_t sim_random;
+
+static uint16_t sim_respond(uint8_t * p_response, uint8_t status, const uint8_t * p_data, uint16_t length)
+{
+    p_response[0] = status;
+    p_response[1] = 0x00;
+    Utility_SetUint16(&p_response[2], length);
+    if (NULL != p_data)
+    {
+        memmove(&p_response[4], p_data, length);
+    }
+    return 4 + length;
+}
+
+static uint16_t sim_error(uint8_t * p_response, uint8_t error)
+{
+    sim_last_error = error;
+    return sim_respond(p_response, SIM_STATUS_ERROR, NULL, 0);
+}
+
+//Builds the data or metadata of the object, returns 0 if the object does not exist
+static uint16_t sim_object(uint16_t oid, uint8_t metadata, uint8_t * p_object)
+{
+    static const uint8_t metadata_key[] = {0x20, 0x09, 0xC0, 0x01, 0x07, 0xE0, 0x01, 0x03, 0xE1, 0x01, 0x10};
+    static const uint8_t metadata_empty[] = {0x20, 0x03, 0xC0, 0x01, 0x07};
+    static const uint8_t cert_prefix[] = {0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02,
+                                          0x01, 0x06, 0x08, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01, 0x07};
+    uint8_t slot = (uint8_t)(oid & 0x0F);
+    uint16_t length = 0;
+
+    if ((oid >= 0xE0F0) && (oid < (0xE0F0 + OPTIGA_CLUSTER_SIM_KEY_SLOTS)) && metadata)
+    {
+        length = sim_has_key[slot] ? sizeof(metadata_key) : sizeof(metadata_empty);
+        memcpy(p_object, sim_has_key[slot] ? metadata_key : metadata_empty, length);
+    }
+    else if ((oid >= 0xE0E0) && (oid < (0xE0E0 + OPTIGA_CLUSTER_SIM_KEY_SLOTS)) && !metadata && sim_has_key[slot])
+    {
+        memcpy(p_object, cert_prefix, sizeof(cert_prefix));
+        length = sizeof(cert_prefix);
+        length += optiga_cluster_sim_public_key(sim_key_seed[slot], &p_object[length]);
+    }
+    else if ((0xE0C6 == oid) && !metadata)
+    {
+        Utility_SetUint16(p_object, 0x0615);
+        length = 2;
+    }
+    else if ((0xF1C2 == oid) && !metadata)
+    {
+        p_object[0] = sim_last_error;
+        length = 1;
+    }
+    else if ((OPTIGA_CLUSTER_SIM_SIGN_COUNT_OID == oid) && !metadata)
+    {
+        p_object[0] = sim_sign_count;
+        length = 1;
+    }
+    return length;
+}
+
+static uint16_t sim_get_data(const uint8_t * p_apdu, uint16_t apdu_length, uint8_t * p_response)
+{
+    uint8_t object[OPTIGA_CLUSTER_SIM_OBJECT_LENGTH];
+    uint16_t object_length;
+    uint16_t offset = 0;
+    uint16_t length;
+
+    if (apdu_length < 6)
+    {
+        return sim_error(p_response, SIM_ERROR_INVALID_PARAM);
+    }
+    object_length = sim_object(Utility_GetUint16(&p_apdu[4]), p_apdu[1], object);
+    if (0 == object_length)
+    {
+        return sim_error(p_response, SIM_ERROR_INVALID_OID);
+    }
+    length = object_length;
+    if ((0 == p_apdu[1]) && (apdu_length >= 10))
+    {
+        offset = Utility_GetUint16(&p_apdu[6]);
+        length = Utility_GetUint16(&p_apdu[8]);
+        if (offset >= object_length)
+        {
+            return sim_error(p_response, SIM_ERROR_OUT_OF_BOUND);
+        }
+        if (length > (object_length - offset))
+        {
+            length = object_length - offset;
+        }
+    }
+    return sim_respond(p_response, SIM_STATUS_OK, &object[offset], length);
+}
+
+static uint16_t sim_calc_sign(const uint8_t * p_apdu, uint16_t apdu_length, uint8_t * p_response)
+{
+    uint8_t public_key[OPTIGA_CLUSTER_SIM_PUBLIC_KEY_LENGTH];
+    uint8_t signature[2 + 64];
+    uint16_t digest_length = Utility_GetUint16(&p_apdu[5]);
+    uint16_t key_oid;
+    uint8_t slot;
+    uint16_t index;
+
+    if ((apdu_length < (4 + 3 + digest_length + 5)) || (digest_length > 64))
+    {
+        return sim_error(p_response, SIM_ERROR_INVALID_PARAM);
+    }
+    key_oid = Utility_GetUint16(&p_apdu[4 + 3 + digest_length + 3]);
+    slot = (uint8_t)(key_oid & 0x0F);
+    if ((key_oid < 0xE0F0) || (slot >= OPTIGA_CLUSTER_SIM_KEY_SLOTS) || (!sim_has_key[slot]))
+    {
+        return sim_error(p_response, SIM_ERROR_INVALID_OID);
+    }
+
+    optiga_cluster_sim_public_key(sim_key_seed[slot], public_key);
+    signature[0] = 0x02;
+    signature[1] = (uint8_t)digest_length;
+    for (index = 0; index < digest_length; index++)
+    {
+        signature[2 + index] = p_apdu[7 + index] ^ public_key[4 + index];
+    }
+    sim_sign_count++;
+    return sim_respond(p_response, SIM_STATUS_OK, signature, 2 + digest_length);
+}
+
+static uint16_t sim_verify_sign(const uint8_t * p_apdu, uint16_t apdu_length, uint8_t * p_response)
+{
+    const uint8_t * p_digest = &p_apdu[7];
+    const uint8_t * p_signature;
+    const uint8_t * p_public_key;
+    uint16_t digest_length = Utility_GetUint16(&p_apdu[5]);
+    uint16_t signature_length;
+    uint16_t position = 4 + 3 + digest_length;
+    uint16_t index;
+
+    //Digest, signature, algorithm and public key from host
+    if (apdu_length < (position + 3))
+    {
+        return sim_error(p_response, SIM_ERROR_INVALID_PARAM);
+    }
+    signature_length = Utility_GetUint16(&p_apdu[position + 1]);
+    p_signature = &p_apdu[position + 3];
+    position += 3 + signature_length + 4 + 3;
+    if ((apdu_length < (position + 4 + digest_length)) || (signature_length != (2 + digest_length)))
+    {
+        return sim_error(p_response, SIM_ERROR_SIGNATURE);
+    }
+    p_public_key = &p_apdu[position];
+    for (index = 0; index < digest_length; index++)
+    {
+        if (p_signature[2 + index] != (p_digest[index] ^ p_public_key[4 + index]))
+        {
+            return sim_error(p_response, SIM_ERROR_SIGNATURE);
+        }
+    }
+    return sim_respond(p_response, SIM_STATUS_OK, NULL, 0);
+}
+
+static uint16_t sim_execute(const uint8_t * p_apdu, uint16_t apdu_length, uint8_t * p_response)
+{
+    uint8_t random[256];
+    uint16_t length;
+
+    if (apdu_length < 4)
+    {
+        return sim_error(p_response, SIM_ERROR_INVALID_PARAM);
+    }
+    switch (p_apdu[0])
+    {
+        case SIM_CMD_OPEN_APP:
+            sim_last_error = 0;
+            return sim_respond(p_response, SIM_STATUS_OK, NULL, 0);
+        case SIM_CMD_GETDATA:
+            return sim_get_data(p_apdu, apdu_length, p_response);
+        case SIM_CMD_GET_RND:
+            length = Utility_GetUint16(&p_apdu[4]);
+            if (length > sizeof(random))
+            {
+                return sim_error(p_response, SIM_ERROR_INVALID_PARAM);
+            }
+            for (apdu_length = 0; apdu_length < length; apdu_length++)
+            {
+                random[apdu_length] = sim_random++;
+            }
+            return sim_respond(p_response, SIM_STATUS_OK, random, length);
+        case SIM_CMD_CALC_SIGN:
+            return sim_calc_sign(p_apdu, apdu_length, p_response);
+        case SIM_CMD_VERIFY_SIGN:
+            return sim_verify_sign(p_apdu, apdu_length, p_response);
+        default:
+            return sim_error(p_response, SIM_ERROR_INVALID_PARAM);
+    }
+}
+
+static void sim_complete(optiga_comms_t * p_ctx)
+{
+    if (NULL != p_ctx->upper_layer_handler)
+    {
+        p_ctx->upper_layer_handler(p_ctx->upper_layer_ctx, OPTIGA_COMMS_SUCCESS);
+    }
+}
+/// @endcond
+
+host_lib_status_t optiga_comms_open(optiga_comms_t * p_ctx)
+{
+    sim_complete(p_ctx);
+    return OPTIGA_COMMS_SUCCESS;
+}
+
+host_lib_status_t optiga_comms_reset(optiga_comms_t * p_ctx, uint8_t reset_type)
+{
+    (void)reset_type;
+    sim_complete(p_ctx);
+    return OPTIGA_COMMS_SUCCESS;
+}
+
+host_lib_status_t optiga_comms_transceive(optiga_comms_t * p_ctx, const uint8_t * p_data,
+                                          const uint16_t * p_data_length,
+                                          uint8_t * p_buffer, uint16_t * p_buffer_len)
+{
+    uint8_t response[4 + OPTIGA_CLUSTER_SIM_OBJECT_LENGTH];
+    uint16_t length = sim_execute(p_data, *p_data_length, response);
+
+    if (length > *p_buffer_len)
+    {
+        return OPTIGA_COMMS_ERROR;
+    }
+    memcpy(p_buffer, response, length);
+    *p_buffer_len = length;
+    sim_complete(p_ctx);
+    return OPTIGA_COMMS_SUCCESS;
+}
+
+int main(int argc, char * argv[])
+{
+    unsigned int slot;
+    unsigned int seed;
+    int index;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <port> [<slot>:<seed> ...]\n", argv[0]);
+        return 2;
+    }
+    for (index = 2; index < argc; index++)
+    {
+        if ((2 != sscanf(argv[index], "%u:%x", &slot, &seed)) || (slot >= OPTIGA_CLUSTER_SIM_KEY_SLOTS))
+        {
+            fprintf(stderr, "invalid key %s\n", argv[index]);
+            return 2;
+        }
+        sim_has_key[slot] = 1;
+        sim_key_seed[slot] = (uint8_t)seed;
+    }
+
+    optiga_comms_tcp_bridge_run(&optiga_comms, (uint16_t)atoi(argv[1]));
+    return 1;
+}
+
+/**
+* @}
+*/
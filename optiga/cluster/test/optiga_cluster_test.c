@@ -0,0 +1,326 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file optiga_cluster_test.c
+*
+* \brief   Test of the cluster coordinator against simulated OPTIGA nodes, each one a separate process reached
+*          over the optiga comms over TCP backend.
+*
+*          gcc -Ioptiga/include -Ipal/linux optiga/cluster/test/optiga_cluster_test.c optiga/cluster/optiga_cluster.c
+*              optiga/util/optiga_util.c optiga/cmd/CommandLib.c optiga/common/Util.c pal/linux/optiga_comms_tcp.c
+*              pal/linux/pal_os_lock.c pal/linux/pal_os_timer.c -lpthread -o optiga_cluster_test
+*          ./optiga_cluster_test ./optiga_cluster_sim_node
+*
+* \ingroup  grOptigaCluster
+* @{
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "optiga/optiga_cluster.h"
+#include "optiga/optiga_util.h"
+#include "optiga/cmd/CommandLib.h"
+#include "optiga_comms_tcp.h"
+#include "optiga_cluster_sim.h"
+
+#define TEST_NODES          (3)
+#define TEST_PORT           (19741)
+
+#define TEST_SEED_SHARED    (0xA1)
+#define TEST_SEED_SINGLE    (0xC3)
+#define TEST_SEED_UNKNOWN   (0x55)
+
+#define TEST_CHECK(condition)                                               \
+    if (!(condition))                                                       \
+    {                                                                       \
+        printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition);       \
+        return -1;                                                          \
+    }
+
+/// @cond hidden
+//Node 0 and 1 hold the shared key, node 0 in E0F1 and node 1 in E0F2. Node 2 holds the single key only.
+static const char * test_node_keys[TEST_NODES][3] =
+{
+    {"0:B2", "1:A1", NULL},
+    {"2:A1", NULL, NULL},
+    {"0:C3", NULL, NULL},
+};
+
+static optiga_comms_tcp_context_t test_contexts[TEST_NODES] =
+{
+    OPTIGA_COMMS_TCP_CONTEXT("127.0.0.1", TEST_PORT),
+    OPTIGA_COMMS_TCP_CONTEXT("127.0.0.1", TEST_PORT + 1),
+    OPTIGA_COMMS_TCP_CONTEXT("127.0.0.1", TEST_PORT + 2),
+};
+static optiga_comms_t test_comms[TEST_NODES];
+static pid_t test_pids[TEST_NODES];
+static optiga_cluster_t test_cluster;
+
+static int test_start_node(const char * program, uint8_t node)
+{
+    char port[8];
+    char * argv[6];
+    uint8_t index;
+
+    snprintf(port, sizeof(port), "%d", TEST_PORT + node);
+    argv[0] = (char *)program;
+    argv[1] = port;
+    for (index = 0; index < 3; index++)
+    {
+        argv[2 + index] = (char *)test_node_keys[node][index];
+    }
+    argv[5] = NULL;
+
+    test_pids[node] = fork();
+    if (0 == test_pids[node])
+    {
+        execv(program, argv);
+        _exit(1);
+    }
+    return (test_pids[node] > 0) ? 0 : -1;
+}
+
+static void test_stop_node(uint8_t node)
+{
+    if (test_pids[node] > 0)
+    {
+        kill(test_pids[node], SIGKILL);
+        waitpid(test_pids[node], NULL, 0);
+        test_pids[node] = 0;
+    }
+}
+
+//Reads the number of signatures calculated by the node
+static int test_sign_count(uint8_t node)
+{
+    optiga_comms_t * p_previous_comms = CmdLib_GetOptigaCommsContext();
+    uint8_t count = 0;
+    uint16_t length = sizeof(count);
+    optiga_lib_status_t status;
+
+    CmdLib_SetOptigaCommsContext(&test_comms[node]);
+    status = optiga_util_read_data(OPTIGA_CLUSTER_SIM_SIGN_COUNT_OID, 0, &count, &length);
+    CmdLib_SetOptigaCommsContext(p_previous_comms);
+    return (OPTIGA_LIB_SUCCESS == status) ? count : -1;
+}
+
+static void test_public_key(uint8_t seed, uint8_t * buffer, public_key_from_host_t * public_key)
+{
+    public_key->public_key = buffer;
+    public_key->length = optiga_cluster_sim_public_key(seed, buffer);
+    public_key->curve = OPTIGA_ECC_NIST_P_256;
+}
+
+//Signs with the key and checks the signature is made with the expected public key
+static int test_sign(uint8_t key_id, const uint8_t * public_key, uint8_t digest_seed)
+{
+    uint8_t digest[32];
+    uint8_t signature[2 + 64];
+    uint16_t signature_length = sizeof(signature);
+    uint8_t index;
+
+    for (index = 0; index < sizeof(digest); index++)
+    {
+        digest[index] = (uint8_t)(digest_seed + index);
+    }
+    TEST_CHECK(OPTIGA_CLUSTER_SUCCESS == optiga_cluster_sign(&test_cluster, key_id, digest, sizeof(digest),
+                                                             signature, &signature_length));
+    TEST_CHECK((2 + sizeof(digest)) == signature_length);
+    for (index = 0; index < sizeof(digest); index++)
+    {
+        TEST_CHECK(signature[2 + index] == (digest[index] ^ public_key[4 + index]));
+    }
+    return 0;
+}
+
+//Every node is added, the inventory is taken without signing
+static int test_add_nodes(void)
+{
+    uint8_t node;
+
+    for (node = 0; node < TEST_NODES; node++)
+    {
+        TEST_CHECK(OPTIGA_CLUSTER_SUCCESS == optiga_cluster_add_node(&test_cluster, &test_comms[node]));
+    }
+    TEST_CHECK(OPTIGA_ECC_NIST_P_256 == test_cluster.nodes[0].key_algorithm[0]);
+    TEST_CHECK(OPTIGA_ECC_NIST_P_256 == test_cluster.nodes[0].key_algorithm[1]);
+    TEST_CHECK(0 == test_cluster.nodes[0].key_algorithm[2]);
+    TEST_CHECK(OPTIGA_ECC_NIST_P_256 == test_cluster.nodes[1].key_algorithm[2]);
+    return 0;
+}
+
+//Keys are located on every node holding them, no signature is calculated for it
+static int test_register_keys(uint8_t * shared_key_id, uint8_t * single_key_id)
+{
+    uint8_t buffer[OPTIGA_CLUSTER_SIM_PUBLIC_KEY_LENGTH];
+    public_key_from_host_t public_key;
+    uint8_t key_id;
+    uint8_t node;
+
+    test_public_key(TEST_SEED_SHARED, buffer, &public_key);
+    TEST_CHECK(OPTIGA_CLUSTER_SUCCESS == optiga_cluster_register_key(&test_cluster, &public_key, shared_key_id));
+    test_public_key(TEST_SEED_SINGLE, buffer, &public_key);
+    TEST_CHECK(OPTIGA_CLUSTER_SUCCESS == optiga_cluster_register_key(&test_cluster, &public_key, single_key_id));
+    test_public_key(TEST_SEED_UNKNOWN, buffer, &public_key);
+    TEST_CHECK(OPTIGA_CLUSTER_ERROR_KEY_NOT_FOUND == optiga_cluster_register_key(&test_cluster, &public_key, &key_id));
+
+    TEST_CHECK(3 == test_cluster.placement_count);
+    TEST_CHECK((0 == test_cluster.placements[0].node) && (0xE0F1 == test_cluster.placements[0].oid));
+    TEST_CHECK((1 == test_cluster.placements[1].node) && (0xE0F2 == test_cluster.placements[1].oid));
+    TEST_CHECK((2 == test_cluster.placements[2].node) && (0xE0F0 == test_cluster.placements[2].oid));
+    for (node = 0; node < TEST_NODES; node++)
+    {
+        TEST_CHECK(0 == test_sign_count(node));
+    }
+    return 0;
+}
+
+//Signatures with the shared key are balanced over both nodes holding it
+static int test_balance(uint8_t shared_key_id, uint8_t single_key_id)
+{
+    uint8_t shared[OPTIGA_CLUSTER_SIM_PUBLIC_KEY_LENGTH];
+    uint8_t single[OPTIGA_CLUSTER_SIM_PUBLIC_KEY_LENGTH];
+    uint8_t index;
+
+    optiga_cluster_sim_public_key(TEST_SEED_SHARED, shared);
+    optiga_cluster_sim_public_key(TEST_SEED_SINGLE, single);
+    for (index = 0; index < 4; index++)
+    {
+        TEST_CHECK(0 == test_sign(shared_key_id, shared, index));
+    }
+    TEST_CHECK(0 == test_sign(single_key_id, single, 0x40));
+
+    TEST_CHECK(2 == test_sign_count(0));
+    TEST_CHECK(2 == test_sign_count(1));
+    TEST_CHECK(1 == test_sign_count(2));
+    return 0;
+}
+
+//Stateless requests are served by any node
+static int test_stateless(void)
+{
+    uint8_t buffer[OPTIGA_CLUSTER_SIM_PUBLIC_KEY_LENGTH];
+    public_key_from_host_t public_key;
+    uint8_t digest[32];
+    uint8_t signature[2 + 32];
+    uint8_t random[16];
+    uint8_t index;
+
+    test_public_key(TEST_SEED_SINGLE, buffer, &public_key);
+    signature[0] = 0x02;
+    signature[1] = sizeof(digest);
+    for (index = 0; index < sizeof(digest); index++)
+    {
+        digest[index] = index;
+        signature[2 + index] = digest[index] ^ buffer[4 + index];
+    }
+    TEST_CHECK(OPTIGA_CLUSTER_SUCCESS == optiga_cluster_verify(&test_cluster, digest, sizeof(digest),
+                                                               signature, sizeof(signature), &public_key));
+    signature[2] ^= 0x01;
+    TEST_CHECK(OPTIGA_CLUSTER_SUCCESS != optiga_cluster_verify(&test_cluster, digest, sizeof(digest),
+                                                               signature, sizeof(signature), &public_key));
+    TEST_CHECK(OPTIGA_CLUSTER_SUCCESS == optiga_cluster_random(&test_cluster, OPTIGA_RNG_TYPE_TRNG,
+                                                               random, sizeof(random)));
+    return 0;
+}
+
+//A lost node is skipped, the request is served by the other node holding the key
+static int test_failover(uint8_t shared_key_id)
+{
+    uint8_t shared[OPTIGA_CLUSTER_SIM_PUBLIC_KEY_LENGTH];
+    uint8_t index;
+
+    optiga_cluster_sim_public_key(TEST_SEED_SHARED, shared);
+    test_stop_node(1);
+    for (index = 0; index < 2; index++)
+    {
+        TEST_CHECK(0 == test_sign(shared_key_id, shared, 0x80 + index));
+    }
+    TEST_CHECK(4 == test_sign_count(0));
+    TEST_CHECK(!test_cluster.nodes[1].alive);
+
+    test_stop_node(0);
+    TEST_CHECK(OPTIGA_CLUSTER_ERROR_NO_NODE == optiga_cluster_sign(&test_cluster, shared_key_id, shared, 32,
+                                                                   shared, &(uint16_t){sizeof(shared)}));
+    return 0;
+}
+/// @endcond
+
+int main(int argc, char * argv[])
+{
+    uint8_t shared_key_id = 0;
+    uint8_t single_key_id = 0;
+    uint8_t node;
+    int result = 0;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <optiga_cluster_sim_node>\n", argv[0]);
+        return 2;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    for (node = 0; node < TEST_NODES; node++)
+    {
+        test_comms[node].comms_ctx = &test_contexts[node];
+        result |= test_start_node(argv[1], node);
+    }
+    //Give the nodes time to listen
+    usleep(200000);
+
+    do
+    {
+        if ((0 != result) || (0 != (result = test_add_nodes())))
+        {
+            break;
+        }
+        if (0 != (result = test_register_keys(&shared_key_id, &single_key_id)))
+        {
+            break;
+        }
+        result |= test_balance(shared_key_id, single_key_id);
+        result |= test_stateless();
+        result |= test_failover(shared_key_id);
+    } while (0);
+
+    for (node = 0; node < TEST_NODES; node++)
+    {
+        test_stop_node(node);
+    }
+
+    printf("%s\n", (0 == result) ? "PASSED" : "FAILED");
+    return (0 == result) ? 0 : 1;
+}
+
+/**
+* @}
+*/
@@ -38,11 +38,22 @@
 #ifdef USE_CMDLIB_WITH_RTOS
 #include "optiga/pal/pal_os_timer.h"
 #endif
+#include "optiga/pal/pal_os_event.h"
 
 /// @cond hidden
 
 static optiga_comms_t* p_optiga_comms;
 
+///Handler notified about changed data objects and keys
+static fObjectChanged_d pfObjectChanged = NULL;
+
+///Notifies the handler that an OID of the current chip changed, 0x0000 for all OIDs
+#define NOTIFY_OBJECT_CHANGED(wOID) \
+    if(NULL != pfObjectChanged) \
+    { \
+        pfObjectChanged(p_optiga_comms, (wOID)); \
+    }
+
 ///Maximum size of buffer, considering Maximum size of arbitrary data (1500) and header bytes
 #define MAX_APDU_BUFF_LEN           	1558
 	
@@ -400,6 +411,9 @@ volatile static host_lib_status_t optiga_comms_status;
 static void optiga_comms_event_handler(void* upper_layer_ctx, host_lib_status_t event)
 {
     optiga_comms_status = event;
+#ifdef PAL_OS_HAS_EVENT_WAIT
+    pal_os_event_notify(p_optiga_comms->comms_ctx);
+#endif
 }
 
 /**
@@ -424,17 +438,28 @@ _STATIC_H int32_t CmdLib_GetDeviceError(void)
     {
         p_optiga_comms->upper_layer_handler = optiga_comms_event_handler;
         optiga_comms_status  = OPTIGA_COMMS_BUSY;
+#ifdef PAL_OS_HAS_EVENT_WAIT
+        pal_os_event_prepare_wait(p_optiga_comms->comms_ctx);
+#endif
         i4Status  =  optiga_comms_transceive(p_optiga_comms,rgbErrorCmd,&wBufferLength,
                                                  rgbErrorCmd,&wBufferLength);
         if(OPTIGA_COMMS_SUCCESS != i4Status)
         {
+#ifdef PAL_OS_HAS_EVENT_WAIT
+            pal_os_event_cancel_wait(p_optiga_comms->comms_ctx);
+#endif
             i4Status = (int32_t)CMD_DEV_EXEC_ERROR;
             break;
         }
 
         //wait for completion
         while(optiga_comms_status == OPTIGA_COMMS_BUSY){
-#ifdef USE_CMDLIB_WITH_RTOS
+#ifdef PAL_OS_HAS_EVENT_PROCESS
+            pal_os_event_process();
+#endif
+#ifdef PAL_OS_HAS_EVENT_WAIT
+            pal_os_event_wait(p_optiga_comms->comms_ctx);
+#elif defined(USE_CMDLIB_WITH_RTOS)
         	pal_os_timer_delay_in_milliseconds(1);
 #endif
         };
@@ -485,17 +510,28 @@ _STATIC_H int32_t TransceiveAPDU(sApduData_d *PpsApduData,uint8_t bGetError)
 
         p_optiga_comms->upper_layer_handler = optiga_comms_event_handler;
         optiga_comms_status  = OPTIGA_COMMS_BUSY;
+#ifdef PAL_OS_HAS_EVENT_WAIT
+        pal_os_event_prepare_wait(p_optiga_comms->comms_ctx);
+#endif
         i4Status  =  optiga_comms_transceive(p_optiga_comms,PpsApduData->prgbAPDUBuffer,&wTotalLength,
                                                 PpsApduData->prgbRespBuffer,&PpsApduData->wResponseLength);
         if(OPTIGA_COMMS_SUCCESS != i4Status)
         {
+#ifdef PAL_OS_HAS_EVENT_WAIT
+            pal_os_event_cancel_wait(p_optiga_comms->comms_ctx);
+#endif
             i4Status = (int32_t)CMD_DEV_EXEC_ERROR;
             break;
         }
         //wait for completion
         do
         {
-#ifdef USE_CMDLIB_WITH_RTOS
+#ifdef PAL_OS_HAS_EVENT_PROCESS
+            pal_os_event_process();
+#endif
+#ifdef PAL_OS_HAS_EVENT_WAIT
+            pal_os_event_wait(p_optiga_comms->comms_ctx);
+#elif defined(USE_CMDLIB_WITH_RTOS)
         	pal_os_timer_delay_in_milliseconds(1);
 #endif
         }while(optiga_comms_status == OPTIGA_COMMS_BUSY);
@@ -820,6 +856,30 @@ void CmdLib_SetOptigaCommsContext(const optiga_comms_t *p_input_optiga_comms)
 	p_optiga_comms = (optiga_comms_t*)p_input_optiga_comms;
 }
 
+/**
+* Gets the OPTIGA Comms context currently used by the command libary.
+* 
+* <br>
+* \retval  Pointer to OPTIGA comms context
+*/
+optiga_comms_t* CmdLib_GetOptigaCommsContext(void)
+{
+	return p_optiga_comms;
+}
+
+/**
+* Sets the handler notified about the data objects, metadata and keys changed through the command library.
+* The handler is called for every SetDataObject and key pair generation, whether it succeeded or not, since
+* the object may be changed partially. Opening the application notifies 0x0000, since the chip may have been reset or replaced.
+* 
+* <br>
+* \param[in] PfHandler Handler to be called, NULL to remove it
+*/
+void CmdLib_SetObjectChangedHandler(fObjectChanged_d PfHandler)
+{
+	pfObjectChanged = PfHandler;
+}
+
 /**
 * Opens the Security Chip Application. The Unique Application Identifier is used internally by 
 * the function while forming a command APDU.
@@ -859,6 +919,7 @@ int32_t CmdLib_OpenApplication(const sOpenApp_d* PpsOpenApp)
             i4Status = (int32_t)CMD_LIB_INVALID_PARAM;
             break;
         }
+        NOTIFY_OBJECT_CHANGED(0x0000);
 
         //Set the pointer to the response buffer
         sApduData.prgbRespBuffer = sApduData.prgbAPDUBuffer;
@@ -1035,35 +1096,10 @@ int32_t CmdLib_GetDataObject(const sGetData_d *PpsGDVector, sCmdResponse_d *PpsR
 }
 
 /**
-* Writes data or metadata to the specified data object by issuing SetDataObject command based on input parameters.
-*
-* <br>
-* Notes: <br>
-* - Application on security chip must be opened using #CmdLib_OpenApplication before using this API.<br>
-*
-* - The function does not verify if the write access permitted for the data object.
-* 
-* - While writing metadata, the metadata must be specified in an already TLV encoded 
-*   byte array format. For example, to set LcsO to operational the value passed by 
-*   the user must be 0x20 0x03 0xC0, 0x01, 0x07. <br>
-*
-* - The function does not validate if the provided input data bytes are correctly 
-*   formatted. For example, while setting LcsO to operational, function does not 
-*   verify if the value is indeed 0x07. <br>
-*
-* - In case of failure,it is possible that partial data is written into the data object.<br>
-*   In such a case, the user should decide if the data has to be re-written.
-*
-*\param[in] PpsSDVector Pointer to Set Data Object inputs
-*
-* \retval  #CMD_LIB_OK
-* \retval  #CMD_LIB_ERROR 
-* \retval  #CMD_LIB_INVALID_PARAM 
-* \retval  #CMD_LIB_INSUFFICIENT_MEMORY
-* \retval  #CMD_DEV_ERROR
-* \retval  #CMD_LIB_NULL_PARAM
-*/
-int32_t CmdLib_SetDataObject(const sSetData_d *PpsSDVector)
+ * \brief A common function for CmdLib_SetDataObject and CmdLib_SetDataObjectVector.
+ * 
+ */
+_STATIC_H int32_t CmdLib_SetDataHelper(const sSetData_d *PpsSDVector, const sDataGather_d *PpsGather)
 {
 /// @cond hidden
 #define BUFFER_SIZE (wMaxCommsBuffer)
@@ -1086,7 +1122,7 @@ int32_t CmdLib_SetDataObject(const sSetData_d *PpsSDVector)
 		INIT_HEAP_APDUBUFFER(sApduData.prgbAPDUBuffer,BUFFER_SIZE);
 #endif
 
-        if((NULL == PpsSDVector)||(NULL == PpsSDVector->prgbData))
+        if((NULL == PpsSDVector)||((NULL == PpsSDVector->prgbData) && (NULL == PpsGather)))
         {
             i4Status = (int32_t)CMD_LIB_NULL_PARAM;
             break;
@@ -1120,6 +1156,9 @@ int32_t CmdLib_SetDataObject(const sSetData_d *PpsSDVector)
             break;
         }
 
+        //The data object may be changed partially even if the write fails
+        NOTIFY_OBJECT_CHANGED(PpsSDVector->wOID);
+
         //Set the pointer to the response buffer
         sApduData.prgbRespBuffer = sApduData.prgbAPDUBuffer+7;
         //copy OID
@@ -1147,8 +1186,19 @@ int32_t CmdLib_SetDataObject(const sSetData_d *PpsSDVector)
             sApduData.prgbAPDUBuffer[OFFSET_PAYLOAD + BYTES_OID] = (uint8_t)(wOffset >> BITS_PER_BYTE);
             sApduData.prgbAPDUBuffer[OFFSET_PAYLOAD + BYTES_OID + 1] = (uint8_t)wOffset;                
             //copy the data
-
-            OCP_MEMCPY(sApduData.prgbAPDUBuffer+OVERHEAD,PpsSDVector->prgbData+wTotalWriteLen,wWriteLen);
+            if(NULL != PpsGather)
+            {
+                //Gather the data from the buffers of the caller, filling the APDU across buffer boundaries
+                if(wWriteLen != PpsGather->pfGather(PpsGather->pCtx, sApduData.prgbAPDUBuffer+OVERHEAD, wWriteLen))
+                {
+                    i4Status = (int32_t)CMD_LIB_INVALID_LEN;
+                    break;
+                }
+            }
+            else
+            {
+                OCP_MEMCPY(sApduData.prgbAPDUBuffer+OVERHEAD,PpsSDVector->prgbData+wTotalWriteLen,wWriteLen);
+            }
 
 			//Set Response buffer length
 			sApduData.wResponseLength = BUFFER_SIZE;
@@ -1178,6 +1228,70 @@ int32_t CmdLib_SetDataObject(const sSetData_d *PpsSDVector)
     return i4Status;
 }
 
+/**
+* Writes data or metadata to the specified data object by issuing SetDataObject command based on input parameters.
+*
+* <br>
+* Notes: <br>
+* - Application on security chip must be opened using #CmdLib_OpenApplication before using this API.<br>
+*
+* - The function does not verify if the write access permitted for the data object.
+* 
+* - While writing metadata, the metadata must be specified in an already TLV encoded 
+*   byte array format. For example, to set LcsO to operational the value passed by 
+*   the user must be 0x20 0x03 0xC0, 0x01, 0x07. <br>
+*
+* - The function does not validate if the provided input data bytes are correctly 
+*   formatted. For example, while setting LcsO to operational, function does not 
+*   verify if the value is indeed 0x07. <br>
+*
+* - In case of failure,it is possible that partial data is written into the data object.<br>
+*   In such a case, the user should decide if the data has to be re-written.
+*
+*\param[in] PpsSDVector Pointer to Set Data Object inputs
+*
+* \retval  #CMD_LIB_OK
+* \retval  #CMD_LIB_ERROR 
+* \retval  #CMD_LIB_INVALID_PARAM 
+* \retval  #CMD_LIB_INSUFFICIENT_MEMORY
+* \retval  #CMD_DEV_ERROR
+* \retval  #CMD_LIB_NULL_PARAM
+*/
+int32_t CmdLib_SetDataObject(const sSetData_d *PpsSDVector)
+{
+    return CmdLib_SetDataHelper(PpsSDVector, NULL);
+}
+
+/**
+* Writes data or metadata to the specified data object by issuing SetDataObject command, with the data copied from
+* several buffers of the caller into the command APDUs.
+*
+* <br>
+* Notes: <br>
+* - Same as #CmdLib_SetDataObject, except that prgbData of PpsSDVector is not used.<br>
+*
+* - PpsGather is invoked in order for the wLength bytes of PpsSDVector, in parts of at most one command APDU.<br>
+*
+*\param[in] PpsSDVector Pointer to Set Data Object inputs
+*\param[in] PpsGather   Pointer to the gather function of the data to be written
+*
+* \retval  #CMD_LIB_OK
+* \retval  #CMD_LIB_ERROR 
+* \retval  #CMD_LIB_INVALID_PARAM 
+* \retval  #CMD_LIB_INVALID_LEN
+* \retval  #CMD_LIB_INSUFFICIENT_MEMORY
+* \retval  #CMD_DEV_ERROR
+* \retval  #CMD_LIB_NULL_PARAM
+*/
+int32_t CmdLib_SetDataObjectVector(const sSetData_d *PpsSDVector, const sDataGather_d *PpsGather)
+{
+    if((NULL == PpsGather) || (NULL == PpsGather->pfGather))
+    {
+        return (int32_t)CMD_LIB_NULL_PARAM;
+    }
+    return CmdLib_SetDataHelper(PpsSDVector, PpsGather);
+}
+
 /**
 * Reads maximum communication buffer size supported by the security chip.<br>
 * 
@@ -1497,62 +1611,10 @@ int32_t CmdLib_SetAuthScheme(const sAuthScheme_d *PpsAuthVector)
 
 #ifdef MODULE_ENABLE_TOOLBOX
 /**
-* Calculates the hash of input data by using the Security Chip.<br>
-*
-* Input:<br>
-* - Provide the required type of input data for hashing. Use \ref sCalcHash_d.eHashDataType with the following options,
-*   - eDataStream : Indicates, sDataStream is considered as hash input.
-*   - eOIDData : Indicates, sOIDData is considered for hash input.
-* 
-* - Provide the input to import/export the hash context. Use \ref sContextInfo_d.eContextAction with the following options,
-*   - #eImport : Import hash context to perform the hash.
-*   - #eExport : Export current active hash context.
-*   - #eImportExport : Import hash context and Export back the context after hashing. 
-*   - #eUnused : Context data import/export feature is not used. This option is also recommended for #eHashSequence_d as #eStartFinalizeHash or #eTerminateHash.
-*
-* Output:<br>
-* - Successful API execution,
-*   - Hash is returned in sOutHash only if #eHashSequence_d is #eStartFinalizeHash,#eIntermediateHash or #eFinalizeHash.<br>
-*   - Hash context data is returned only if \ref sContextInfo_d.eContextAction is #eExport or #eImportExport.<br> 
-*
-* Notes: <br>
-* - Application on security chip must be opened using #CmdLib_OpenApplication before using this API.<br>
-* - #eTerminateHash in #eHashSequence_d is used to terminate any existing hash session. Any input data or hash context options supplied with this sequence is ignored.
-* - Sequences for generating a hash successfully can be as follows:<br>
-*     - #eStartHash,#eFinalizeHash<br>
-*     - #eStartHash,#eContinueHash (single or multiple),#eFinalizeHash<br>
-*     - #eStartFinalizeHash<br>
-*     - #eStartHash,#eIntermediateHash,#eContinueHash,#eFinalizeHash<br>
-*
-* - If the memory buffer is not sufficient to store output hash/hash context or the data to be sent to security chip is more than communication buffer,#CMD_LIB_INSUFFICIENT_MEMORY error is retured.
-* - This API does not maintain any state of hashing operations.<br>
-* - There is no support for chaining while sending data therefore in order to avoid communication buffer overflow, the user must take care of fragmenting the data for hashing.<br>
-*   Use the API #CmdLib_GetMaxCommsBufferSize to check the maximum communication buffer size supported by the security chip. In addition, the overhead for command APDU header and 
-*   TLV encoding must be considered as explained below.<br> 
-*
-*   Read the maximum communication buffer size using the API #CmdLib_GetMaxCommsBufferSize() and store in a variable <b>"wMaxCommsBuffer"</b><br>
-*   Substract the header overheads and hash context size(depends on applicable Hash algorithm) respectively from wMaxCommsBuffer. The result gives the Available_Size to frame the hash data input.<br>
-*
-*   - Only hash calculation : <br>
-*   &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp; Available_Size = (wMaxCommsBuffer - #CALC_HASH_FIXED_OVERHEAD_SIZE)<br>
-*   - Import context to security chip and calculate hash  : <br>
-*   &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp; Available_Size = (wMaxCommsBuffer - #CALC_HASH_FIXED_OVERHEAD_SIZE - #CALC_HASH_IMPORT_OR_EXPORT_OVERHEAD_SIZE - #CALC_HASH_SHA256_CONTEXT_SIZE)<br>
-*   - Calulate hash and export context out of security chip : <br>  
-*   &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp; Available_Size = (wMaxCommsBuffer - #CALC_HASH_FIXED_OVERHEAD_SIZE - #CALC_HASH_IMPORT_OR_EXPORT_OVERHEAD_SIZE)<br> 
-*   - Import context to security chip, calculate hash and export context out of security chip :<br>
-*   &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp; Available_Size = (wMaxCommsBuffer - #CALC_HASH_FIXED_OVERHEAD_SIZE - #CALC_HASH_IMPORT_AND_EXPORT_OVERHEAD_SIZE - #CALC_HASH_SHA256_CONTEXT_SIZE)<br>
-*
-*
-* \param[in,out] PpsCalcHash Pointer to #sCalcHash_d that contains information to calculate hash
-*
-* \retval  #CMD_LIB_OK
-* \retval  #CMD_LIB_ERROR
-* \retval  #CMD_LIB_NULL_PARAM
-* \retval  #CMD_LIB_INSUFFICIENT_MEMORY
-* \retval  #CMD_DEV_EXEC_ERROR
-* \retval  #CMD_DEV_ERROR
-*/
-int32_t CmdLib_CalcHash(sCalcHash_d* PpsCalcHash)
+ * \brief A common function for CmdLib_CalcHash and CmdLib_CalcHashVector.
+ * 
+ */
+_STATIC_H int32_t CmdLib_CalcHashHelper(sCalcHash_d* PpsCalcHash, const sDataGather_d* PpsGather)
 {
     int32_t i4Status = (int32_t)CMD_LIB_ERROR;
 	sApduData_d sApduData;
@@ -1613,7 +1675,7 @@ int32_t CmdLib_CalcHash(sCalcHash_d* PpsCalcHash)
         }
         else if(eDataStream == eHashDataType)
         {
-            if(NULL == PpsCalcHash->sDataStream.prgbStream)
+            if((NULL == PpsCalcHash->sDataStream.prgbStream) && (NULL == PpsGather))
             {
                 i4Status = (int32_t)CMD_LIB_NULL_PARAM;
                 break;
@@ -1683,7 +1745,18 @@ int32_t CmdLib_CalcHash(sCalcHash_d* PpsCalcHash)
         if(eTerminateHash != PpsCalcHash->eHashSequence)
         {
 			//If the DataType is Data stream, copy the input data to the buffer
-            if(eDataStream == eHashDataType)
+            if((eDataStream == eHashDataType) && (NULL != PpsGather))
+            {
+                //Gather the data from the buffers of the caller, filling the APDU across buffer boundaries
+                if(wInDataLen != PpsGather->pfGather(PpsGather->pCtx,
+                                                     &sApduData.prgbAPDUBuffer[OFFSET_PAYLOAD + BYTES_SEQ + BYTES_LENGTH],
+                                                     wInDataLen))
+                {
+                    i4Status = (int32_t)CMD_LIB_INVALID_LEN;
+                    break;
+                }
+            }
+            else if(eDataStream == eHashDataType)
             {
                 OCP_MEMCPY(&sApduData.prgbAPDUBuffer[OFFSET_PAYLOAD + BYTES_SEQ + BYTES_LENGTH], PpsCalcHash->sDataStream.prgbStream, 
                 wInDataLen);
@@ -1790,6 +1863,96 @@ int32_t CmdLib_CalcHash(sCalcHash_d* PpsCalcHash)
     return i4Status;
 }
 
+/**
+* Calculates the hash of input data by using the Security Chip.<br>
+*
+* Input:<br>
+* - Provide the required type of input data for hashing. Use \ref sCalcHash_d.eHashDataType with the following options,
+*   - eDataStream : Indicates, sDataStream is considered as hash input.
+*   - eOIDData : Indicates, sOIDData is considered for hash input.
+* 
+* - Provide the input to import/export the hash context. Use \ref sContextInfo_d.eContextAction with the following options,
+*   - #eImport : Import hash context to perform the hash.
+*   - #eExport : Export current active hash context.
+*   - #eImportExport : Import hash context and Export back the context after hashing. 
+*   - #eUnused : Context data import/export feature is not used. This option is also recommended for #eHashSequence_d as #eStartFinalizeHash or #eTerminateHash.
+*
+* Output:<br>
+* - Successful API execution,
+*   - Hash is returned in sOutHash only if #eHashSequence_d is #eStartFinalizeHash,#eIntermediateHash or #eFinalizeHash.<br>
+*   - Hash context data is returned only if \ref sContextInfo_d.eContextAction is #eExport or #eImportExport.<br> 
+*
+* Notes: <br>
+* - Application on security chip must be opened using #CmdLib_OpenApplication before using this API.<br>
+* - #eTerminateHash in #eHashSequence_d is used to terminate any existing hash session. Any input data or hash context options supplied with this sequence is ignored.
+* - Sequences for generating a hash successfully can be as follows:<br>
+*     - #eStartHash,#eFinalizeHash<br>
+*     - #eStartHash,#eContinueHash (single or multiple),#eFinalizeHash<br>
+*     - #eStartFinalizeHash<br>
+*     - #eStartHash,#eIntermediateHash,#eContinueHash,#eFinalizeHash<br>
+*
+* - If the memory buffer is not sufficient to store output hash/hash context or the data to be sent to security chip is more than communication buffer,#CMD_LIB_INSUFFICIENT_MEMORY error is retured.
+* - This API does not maintain any state of hashing operations.<br>
+* - There is no support for chaining while sending data therefore in order to avoid communication buffer overflow, the user must take care of fragmenting the data for hashing.<br>
+*   Use the API #CmdLib_GetMaxCommsBufferSize to check the maximum communication buffer size supported by the security chip. In addition, the overhead for command APDU header and 
+*   TLV encoding must be considered as explained below.<br> 
+*
+*   Read the maximum communication buffer size using the API #CmdLib_GetMaxCommsBufferSize() and store in a variable <b>"wMaxCommsBuffer"</b><br>
+*   Substract the header overheads and hash context size(depends on applicable Hash algorithm) respectively from wMaxCommsBuffer. The result gives the Available_Size to frame the hash data input.<br>
+*
+*   - Only hash calculation : <br>
+*   &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp; Available_Size = (wMaxCommsBuffer - #CALC_HASH_FIXED_OVERHEAD_SIZE)<br>
+*   - Import context to security chip and calculate hash  : <br>
+*   &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp; Available_Size = (wMaxCommsBuffer - #CALC_HASH_FIXED_OVERHEAD_SIZE - #CALC_HASH_IMPORT_OR_EXPORT_OVERHEAD_SIZE - #CALC_HASH_SHA256_CONTEXT_SIZE)<br>
+*   - Calulate hash and export context out of security chip : <br>  
+*   &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp; Available_Size = (wMaxCommsBuffer - #CALC_HASH_FIXED_OVERHEAD_SIZE - #CALC_HASH_IMPORT_OR_EXPORT_OVERHEAD_SIZE)<br> 
+*   - Import context to security chip, calculate hash and export context out of security chip :<br>
+*   &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp; Available_Size = (wMaxCommsBuffer - #CALC_HASH_FIXED_OVERHEAD_SIZE - #CALC_HASH_IMPORT_AND_EXPORT_OVERHEAD_SIZE - #CALC_HASH_SHA256_CONTEXT_SIZE)<br>
+*
+*
+* \param[in,out] PpsCalcHash Pointer to #sCalcHash_d that contains information to calculate hash
+*
+* \retval  #CMD_LIB_OK
+* \retval  #CMD_LIB_ERROR
+* \retval  #CMD_LIB_NULL_PARAM
+* \retval  #CMD_LIB_INSUFFICIENT_MEMORY
+* \retval  #CMD_DEV_EXEC_ERROR
+* \retval  #CMD_DEV_ERROR
+*/
+int32_t CmdLib_CalcHash(sCalcHash_d* PpsCalcHash)
+{
+    return CmdLib_CalcHashHelper(PpsCalcHash, NULL);
+}
+
+/**
+* Calculates the hash on input data by issuing CalcHash command to Security Chip, with the data stream copied from
+* several buffers of the caller into the command APDU.
+*
+* Notes: <br>
+* - Same as #CmdLib_CalcHash, except that sDataStream.prgbStream of PpsCalcHash is not used if
+*   eHashDataType is #eDataStream.<br>
+* - PpsGather is invoked once for the sDataStream.wLen bytes of PpsCalcHash.<br>
+*
+* \param[in,out] PpsCalcHash Pointer to #sCalcHash_d that contains information to calculate hash
+* \param[in]     PpsGather   Pointer to the gather function of the data stream
+*
+* \retval  #CMD_LIB_OK
+* \retval  #CMD_LIB_ERROR
+* \retval  #CMD_LIB_NULL_PARAM
+* \retval  #CMD_LIB_INVALID_LEN
+* \retval  #CMD_LIB_INSUFFICIENT_MEMORY
+* \retval  #CMD_DEV_EXEC_ERROR
+* \retval  #CMD_DEV_ERROR
+*/
+int32_t CmdLib_CalcHashVector(sCalcHash_d* PpsCalcHash, const sDataGather_d* PpsGather)
+{
+    if((NULL == PpsGather) || (NULL == PpsGather->pfGather))
+    {
+        return (int32_t)CMD_LIB_NULL_PARAM;
+    }
+    return CmdLib_CalcHashHelper(PpsCalcHash, PpsGather);
+}
+
 /**
 * Verifies the signature over the input digest by using the Security Chip.<br>
 *
@@ -2016,6 +2179,8 @@ int32_t CmdLib_GenerateKeyPair(const sKeyPairOption_d* PpsKeyPairOption,sOutKeyP
 		sApduData.wResponseLength = wCalApduLen;
 		if(eStorePrivKeyOnly == PpsKeyPairOption->eKeyExport)
 		{		
+			NOTIFY_OBJECT_CHANGED(PpsKeyPairOption->wOIDPrivKey);
+
 			//Set private key OID tag, length, data
 			sApduData.prgbAPDUBuffer[LEN_APDUHEADER] = TAG_OID;
 			Utility_SetUint16(&sApduData.prgbAPDUBuffer[wWritePosition + TAG_LENGTH_OFFSET], LEN_PRI_KEY);
@@ -146,6 +146,8 @@ host_lib_status_t ifx_i2c_open(ifx_i2c_context_t *p_ctx)
         p_ctx->reset_state = IFX_I2C_STATE_RESET_PIN_LOW;
         p_ctx->do_pal_init = TRUE;
         p_ctx->state = IFX_I2C_STATE_UNINIT;
+        p_ctx->p_timing = &ifx_i2c_timing_default;
+        p_ctx->dl.response_timeout_ms = 0;
 
         api_status = ifx_i2c_init(p_ctx);
         if(IFX_I2C_STACK_SUCCESS == api_status)
@@ -315,8 +317,9 @@ host_lib_status_t ifx_i2c_close(ifx_i2c_context_t *p_ctx)
 *
 *<b>API Details:</b>
 *  - This API is implemented in synchronous mode.
-*  - If the write fails due to the following reasons, this API repeats the write for #PL_POLLING_MAX_CNT times
-*    with a fixed interval of #PL_POLLING_INVERVAL_US microseconds and exits with respective return status.
+*  - If the write fails due to the following reasons, this API repeats the write for the polling count
+*    with the polling interval of the timing profile in use (#PL_POLLING_MAX_CNT and #PL_POLLING_INVERVAL_US
+*    microseconds by default) and exits with respective return status.
 *    - I2C bus is in busy state, returns #IFX_I2C_STACK_BUSY
 *    - No-acknowledge(NACK) received from slave, returns #IFX_I2C_STACK_ERROR
 *    - I2C errors, returns #IFX_I2C_STACK_ERROR
@@ -351,6 +354,67 @@ host_lib_status_t ifx_i2c_set_slave_address(ifx_i2c_context_t *p_ctx, uint8_t sl
     return api_status;
 }
 
+/**
+* Enables or disables the adaptation of the frame size to the error rate.<br>
+*
+*<b>Pre Conditions:</b>
+* - None<br>
+*
+*<b>API Details:</b>
+*  - The data link layer counts frames received with CRC error and NACKs received.
+*    #DL_ADAPTIVE_ERROR_BURST such frames within #DL_ADAPTIVE_WINDOW frames halve the frame size,
+*    down to #DL_ADAPTIVE_MIN_FRAME_SIZE. #DL_ADAPTIVE_CLEAN_FRAMES error free frames in a row double it,
+*    up to the frame size negotiated by #ifx_i2c_open.<br>
+*  - A new frame size is agreed with the slave through the DATA_REG_LEN register before the next
+*    #ifx_i2c_transceive, never within a transmission.<br>
+*  - Disabling keeps the frame size in use until the next #ifx_i2c_open or #ifx_i2c_reset.<br>
+*
+* \param[in,out] p_ctx              Pointer to #ifx_i2c_context_t
+* \param[in]     enable             0 - Fixed frame size.<br>
+*                                   Non-zero - Adaptive frame size.
+*
+* \retval  #IFX_I2C_STACK_SUCCESS
+*/
+host_lib_status_t ifx_i2c_set_adaptive_frame_size(ifx_i2c_context_t *p_ctx, uint8_t enable)
+{
+    p_ctx->adaptive_frame_size = (0 != enable) ? TRUE : FALSE;
+    if (!p_ctx->adaptive_frame_size)
+    {
+        p_ctx->dl.target_frame_size = 0;
+    }
+    return IFX_I2C_STACK_SUCCESS;
+}
+
+/**
+* Gets the frame size in use and the frame error statistics.<br>
+*
+*<b>Pre Conditions:</b>
+* - IFX I2C protocol stack must be initialized.<br>
+*
+*<b>API Details:</b>
+*  - The statistics are counted since the last #ifx_i2c_open or #ifx_i2c_reset,
+*    also if the adaptive frame size is disabled.<br>
+*
+* \param[in]     p_ctx              Pointer to #ifx_i2c_context_t
+* \param[out]    p_stats            Pointer to #ifx_i2c_frame_stats_t to be filled
+*
+* \retval  #IFX_I2C_STACK_SUCCESS
+* \retval  #IFX_I2C_STACK_ERROR      Stack is not initialized
+*/
+host_lib_status_t ifx_i2c_get_frame_stats(const ifx_i2c_context_t *p_ctx, ifx_i2c_frame_stats_t *p_stats)
+{
+    host_lib_status_t api_status = (int32_t)IFX_I2C_STACK_ERROR;
+
+    if (IFX_I2C_STATE_IDLE == p_ctx->state)
+    {
+        *p_stats = p_ctx->dl.stats;
+        p_stats->frame_size = p_ctx->pl.data_reg_len;
+        p_stats->max_frame_size = p_ctx->frame_size;
+        api_status = IFX_I2C_STACK_SUCCESS;
+    }
+    return api_status;
+}
+
 /// @cond hidden
 //lint --e{715} suppress "This is ignored as ifx_i2c_event_handler_t handler function prototype requires this argument"
 void ifx_i2c_tl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status_t event, const uint8_t* p_data, uint16_t data_len)
@@ -71,6 +71,17 @@ ifx_i2c_context_t ifx_i2c_context_0 =
     &optiga_pal_i2c_context_0,
 };
 
+/** @brief Timing profile of the IFX I2C protocol stack, without command execution times.*/
+const ifx_i2c_timing_profile_t ifx_i2c_timing_default =
+{
+    PL_POLLING_INVERVAL_US,
+    PL_POLLING_MAX_CNT,
+    PL_DATA_POLLING_INVERVAL_US,
+    TL_MAX_EXIT_TIMEOUT * 1000,
+    NULL,
+    0
+};
+
 /***********************************************************************************************************************
 * GLOBAL
 ***********************************************************************************************************************/
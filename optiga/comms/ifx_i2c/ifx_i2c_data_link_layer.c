@@ -108,6 +108,8 @@ _STATIC_H host_lib_status_t ifx_i2c_dl_send_frame_internal(ifx_i2c_context_t *p_
 _STATIC_H host_lib_status_t ifx_i2c_dl_resync(ifx_i2c_context_t* p_ctx);
 /// Helper function to resend frame
 _STATIC_H void ifx_i2c_dl_resend_frame(ifx_i2c_context_t* p_ctx,uint8_t seqctr_value);
+/// Helper function to adapt the frame size to the frame errors
+_STATIC_H void ifx_i2c_dl_adapt_frame_size(ifx_i2c_context_t* p_ctx, uint8_t frame_error);
 /// Data Link Layer state machine
 _STATIC_H void ifx_i2c_pl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status_t event, const uint8_t* p_data, uint16_t data_len);
 
@@ -135,10 +137,28 @@ host_lib_status_t ifx_i2c_dl_init(ifx_i2c_context_t *p_ctx,ifx_i2c_event_handler
     p_ctx->dl.error = 0;
     p_ctx->dl.p_tx_frame_buffer = p_ctx->tx_frame_buffer;
     p_ctx->dl.p_rx_frame_buffer = p_ctx->rx_frame_buffer;
+    // The frame size is negotiated again, start adapting from it
+    p_ctx->dl.target_frame_size = 0;
+    p_ctx->dl.window_frames = 0;
+    p_ctx->dl.window_errors = 0;
+    p_ctx->dl.clean_frames = 0;
+    memset(&p_ctx->dl.stats, 0, sizeof(p_ctx->dl.stats));
 
     return IFX_I2C_STACK_SUCCESS;
 }
 
+host_lib_status_t ifx_i2c_dl_set_frame_size(ifx_i2c_context_t *p_ctx,uint16_t frame_size)
+{
+    LOG_DL("[IFX-DL]: Set frame size\n");
+    // State must be idle
+    if (p_ctx->dl.state != DL_STATE_IDLE)
+    {
+        return IFX_I2C_STACK_ERROR;
+    }
+    p_ctx->dl.target_frame_size = 0;
+    return ifx_i2c_pl_set_frame_size(p_ctx, frame_size);
+}
+
 host_lib_status_t ifx_i2c_dl_send_frame(ifx_i2c_context_t *p_ctx,uint16_t frame_len)
 {
 	LOG_DL("[IFX-DL]: Start TX Frame\n");
@@ -153,6 +173,7 @@ host_lib_status_t ifx_i2c_dl_send_frame(ifx_i2c_context_t *p_ctx,uint16_t frame_
     p_ctx->dl.action_rx_only = 0;
 	p_ctx->dl.tx_buffer_size = frame_len;
     p_ctx->dl.data_poll_timeout = PL_TRANS_TIMEOUT_MS;
+    p_ctx->dl.stats.frames_sent++;
     
     return ifx_i2c_dl_send_frame_internal(p_ctx,frame_len, DL_FCTR_SEQCTR_VALUE_ACK, 0);
 }
@@ -171,7 +192,13 @@ host_lib_status_t ifx_i2c_dl_receive_frame(ifx_i2c_context_t *p_ctx)
     p_ctx->dl.retransmit_counter = 0;
     p_ctx->dl.action_rx_only = 1;
     p_ctx->dl.frame_start_time = pal_os_timer_get_time_in_milliseconds();
-    p_ctx->dl.data_poll_timeout = TL_MAX_EXIT_TIMEOUT*1000;
+    p_ctx->dl.data_poll_timeout = p_ctx->p_timing->tl_max_exit_timeout_ms;
+    // Bounded by the maximum execution time of the command, if it is known
+    if (0 != p_ctx->dl.response_timeout_ms)
+    {
+        p_ctx->dl.data_poll_timeout = p_ctx->dl.response_timeout_ms;
+        p_ctx->dl.response_timeout_ms = 0;
+    }
 
     return ifx_i2c_pl_receive_frame(p_ctx);
 }
@@ -205,6 +232,59 @@ _STATIC_H host_lib_status_t ifx_i2c_dl_calc_crc(const uint8_t* p_data, uint16_t
     return crc;
 }
 
+_STATIC_H void ifx_i2c_dl_adapt_frame_size(ifx_i2c_context_t* p_ctx, uint8_t frame_error)
+{
+    uint32_t frame_size = (0 != p_ctx->dl.target_frame_size)?p_ctx->dl.target_frame_size:p_ctx->pl.data_reg_len;
+
+    if (!p_ctx->adaptive_frame_size)
+    {
+        return;
+    }
+
+    p_ctx->dl.window_frames++;
+    if (frame_error)
+    {
+        p_ctx->dl.clean_frames = 0;
+        // Shrink on a burst of errors, a single error costs less than smaller frames
+        if (++p_ctx->dl.window_errors >= DL_ADAPTIVE_ERROR_BURST)
+        {
+            p_ctx->dl.window_frames = DL_ADAPTIVE_WINDOW;
+            frame_size >>= 1;
+            if (frame_size < DL_ADAPTIVE_MIN_FRAME_SIZE)
+            {
+                frame_size = DL_ADAPTIVE_MIN_FRAME_SIZE;
+            }
+            if (frame_size < p_ctx->pl.data_reg_len)
+            {
+                LOG_DL("[IFX-DL]: Error burst -> Frame size %d\n", frame_size);
+                p_ctx->dl.target_frame_size = (uint16_t)frame_size;
+                p_ctx->dl.stats.shrink_count++;
+            }
+        }
+    }
+    else if (++p_ctx->dl.clean_frames >= DL_ADAPTIVE_CLEAN_FRAMES)
+    {
+        p_ctx->dl.clean_frames = 0;
+        frame_size <<= 1;
+        if (frame_size > p_ctx->frame_size)
+        {
+            frame_size = p_ctx->frame_size;
+        }
+        if (frame_size > p_ctx->pl.data_reg_len)
+        {
+            LOG_DL("[IFX-DL]: Clean period -> Frame size %d\n", frame_size);
+            p_ctx->dl.target_frame_size = (uint16_t)frame_size;
+            p_ctx->dl.stats.grow_count++;
+        }
+    }
+
+    if (p_ctx->dl.window_frames >= DL_ADAPTIVE_WINDOW)
+    {
+        p_ctx->dl.window_frames = 0;
+        p_ctx->dl.window_errors = 0;
+    }
+}
+
 _STATIC_H host_lib_status_t ifx_i2c_dl_send_frame_internal(ifx_i2c_context_t *p_ctx,uint16_t frame_len,
     uint8_t seqctr_value, uint8_t resend)
 {
@@ -268,6 +348,7 @@ _STATIC_H host_lib_status_t ifx_i2c_dl_resync(ifx_i2c_context_t* p_ctx)
     p_ctx->dl.tx_seq_nr = DL_MAX_FRAME_NUM;
     p_ctx->dl.rx_seq_nr = DL_MAX_FRAME_NUM;
     p_ctx->dl.resynced = 1;
+    p_ctx->dl.stats.resyncs++;
     LOG_DL("[IFX-DL]: Send Re-Sync Frame\n"); 
     p_ctx->dl.state = DL_STATE_RESEND;
     api_status = ifx_i2c_dl_send_frame_internal(p_ctx,0,DL_FCTR_SEQCTR_VALUE_RESYNC,0);
@@ -279,7 +360,7 @@ _STATIC_H void ifx_i2c_dl_resend_frame(ifx_i2c_context_t* p_ctx,uint8_t seqctr_v
     host_lib_status_t status;
     // If exit timeout not violated
 	uint32_t current_time_stamp = pal_os_timer_get_time_in_milliseconds();
-    if ((current_time_stamp - p_ctx->tl.api_start_time) < (TL_MAX_EXIT_TIMEOUT * 1000))
+    if ((current_time_stamp - p_ctx->tl.api_start_time) < p_ctx->p_timing->tl_max_exit_timeout_ms)
     {
         if(p_ctx->dl.retransmit_counter == DL_TRANS_REPEAT)
         {
@@ -291,6 +372,7 @@ _STATIC_H void ifx_i2c_dl_resend_frame(ifx_i2c_context_t* p_ctx,uint8_t seqctr_v
         {
 			LOG_DL("[IFX-DL]: Re-TX Frame\n");
 			p_ctx->dl.retransmit_counter++;            
+            p_ctx->dl.stats.retransmissions++;
             p_ctx->dl.state = DL_STATE_TX;
             status = ifx_i2c_dl_send_frame_internal(p_ctx,p_ctx->dl.tx_buffer_size,seqctr_value, 1);           
         }
@@ -395,6 +477,11 @@ _STATIC_H void ifx_i2c_pl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status
                 {	
                     // CRC,Length of data frame is 0/ SEQCTR has RFU/Re-sync in Data frame
                     LOG_DL("[IFX-DL]: NACK for CRC error,Data frame length is not correct,RFU in SEQCTR\n");
+                    if (crc_received != crc_calculated)
+                    {
+                        p_ctx->dl.stats.crc_errors++;
+                        ifx_i2c_dl_adapt_frame_size(p_ctx, TRUE);
+                    }
                     p_ctx->dl.state  = DL_STATE_NACK;
                     break;
                 }
@@ -419,12 +506,16 @@ _STATIC_H void ifx_i2c_pl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status
                 {	
                     // NACK for transmitted frame
                     LOG_DL("[IFX-DL]: NACK received in data frame\n");
+                    p_ctx->dl.stats.nacks_received++;
+                    ifx_i2c_dl_adapt_frame_size(p_ctx, TRUE);
                     p_ctx->dl.state = DL_STATE_RESEND;		
                     break;	
                 }
                 p_ctx->dl.rx_seq_nr = (p_ctx->dl.rx_seq_nr + 1) & DL_MAX_FRAME_NUM;                  
                 memcpy(p_ctx->dl.p_rx_frame_buffer, p_data, data_len);
                 p_ctx->dl.rx_buffer_size = data_len;
+                p_ctx->dl.stats.frames_received++;
+                ifx_i2c_dl_adapt_frame_size(p_ctx, FALSE);
 
                 // Send control frame to acknowledge reception of this data frame
                 LOG_DL("[IFX-DL]: Read Data Frame -> Send ACK\n");
@@ -451,6 +542,8 @@ _STATIC_H void ifx_i2c_pl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status
                 {	
                     // Re-Transmit frame in case of CF CRC error
                     LOG_DL("[IFX-DL]: Retransmit frame for CF CRC error\n");
+                    p_ctx->dl.stats.crc_errors++;
+                    ifx_i2c_dl_adapt_frame_size(p_ctx, TRUE);
                     p_ctx->dl.state = DL_STATE_RESEND;
                     break;
                 }
@@ -481,11 +574,14 @@ _STATIC_H void ifx_i2c_pl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status
                 {	
                     // NACK for transmitted frame
                     LOG_DL("[IFX-DL]: NACK received\n");
+                    p_ctx->dl.stats.nacks_received++;
+                    ifx_i2c_dl_adapt_frame_size(p_ctx, TRUE);
                     p_ctx->dl.state = DL_STATE_RESEND;		
                     break;	
                 }	
                 
                 LOG_DL("[IFX-DL]: ACK received\n");
+                ifx_i2c_dl_adapt_frame_size(p_ctx, FALSE);
                 // Report frame reception to upper layer and go in idle state
                 p_ctx->dl.state = DL_STATE_IDLE;
                 continue_state_machine = FALSE;  
@@ -163,9 +163,11 @@ host_lib_status_t ifx_i2c_pl_init(ifx_i2c_context_t *p_ctx,ifx_i2c_event_handler
     p_ctx->pl.upper_layer_event_handler = handler;
     p_ctx->pl.frame_state = PL_STATE_UNINIT;
     p_ctx->pl.negotiate_state = PL_INIT_SET_FREQ_DEFAULT;
+    p_ctx->pl.requested_frame_size = p_ctx->frame_size;
+    p_ctx->pl.frame_size_update = FALSE;
     p_ctx->p_pal_i2c_ctx->slave_address = p_ctx->slave_address;
     p_ctx->p_pal_i2c_ctx->upper_layer_event_handler = ifx_i2c_pl_pal_event_handler;
-    p_ctx->pl.retry_counter = PL_POLLING_MAX_CNT;
+    p_ctx->pl.retry_counter = p_ctx->p_timing->pl_polling_max_cnt;
 	
 	if(TRUE == p_ctx->do_pal_init)
     {
@@ -211,6 +213,25 @@ host_lib_status_t ifx_i2c_pl_send_frame(ifx_i2c_context_t *p_ctx,uint8_t* p_fram
     return IFX_I2C_STACK_SUCCESS;
 }
 
+/// Physical Layer high level interface function
+host_lib_status_t ifx_i2c_pl_set_frame_size(ifx_i2c_context_t *p_ctx, uint16_t frame_size)
+{
+    // Physical Layer must be idle
+    if (p_ctx->pl.frame_state != PL_STATE_READY)
+    {
+        return IFX_I2C_STACK_ERROR;
+    }
+    LOG_PL("[IFX-PL]: Update frame size to %d\n", frame_size);
+    // Only the frame length part of the negotiation is done
+    p_ctx->pl.requested_frame_size = frame_size;
+    p_ctx->pl.frame_size_update = TRUE;
+    p_ctx->pl.negotiate_state = PL_INIT_SET_DATA_REG_LEN;
+    p_ctx->pl.frame_state = PL_STATE_INIT;
+
+    ifx_i2c_pl_frame_event_handler(p_ctx,IFX_I2C_STACK_SUCCESS);
+    return IFX_I2C_STACK_SUCCESS;
+}
+
 /// Physical Layer high level interface function
 host_lib_status_t ifx_i2c_pl_receive_frame(ifx_i2c_context_t *p_ctx)
 {
@@ -254,7 +275,7 @@ host_lib_status_t ifx_i2c_pl_write_slave_address(ifx_i2c_context_t *p_ctx, uint8
         p_ctx->pl.buffer[MODE_OFFSET] = PL_REG_BASE_ADDR_PERSISTANT;
     }
 
-    p_ctx->pl.retry_counter   = PL_POLLING_MAX_CNT;
+    p_ctx->pl.retry_counter   = p_ctx->p_timing->pl_polling_max_cnt;
 
     while(p_ctx->pl.retry_counter)
     {
@@ -268,7 +289,7 @@ host_lib_status_t ifx_i2c_pl_write_slave_address(ifx_i2c_context_t *p_ctx, uint8
             break;
         }
         p_ctx->pl.retry_counter--;
-        pal_os_timer_delay_in_milliseconds(PL_POLLING_INVERVAL_US);
+        pal_os_timer_delay_in_milliseconds(p_ctx->p_timing->pl_polling_interval_us);
     }
 
     if(PAL_I2C_EVENT_SUCCESS == pal_event_status)
@@ -304,7 +325,7 @@ static void ifx_i2c_pl_read_register(ifx_i2c_context_t *p_ctx,uint8_t reg_addr,
     // Set low level interface variables and start transmission
     p_ctx->pl.buffer_rx_len   = reg_len;
     p_ctx->pl.register_action = PL_ACTION_READ_REGISTER;
-    p_ctx->pl.retry_counter   = PL_POLLING_MAX_CNT;
+    p_ctx->pl.retry_counter   = p_ctx->p_timing->pl_polling_max_cnt;
     p_ctx->pl.i2c_cmd         = PL_I2C_CMD_WRITE;
 
     //lint --e{534} suppress "Return value is not required to be checked"
@@ -323,7 +344,7 @@ static void ifx_i2c_pl_write_register(ifx_i2c_context_t *p_ctx,uint8_t reg_addr,
 
     // Set Physical Layer low level interface variables and start transmission
     p_ctx->pl.register_action = PL_ACTION_WRITE_REGISTER;
-    p_ctx->pl.retry_counter   = PL_POLLING_MAX_CNT;
+    p_ctx->pl.retry_counter   = p_ctx->p_timing->pl_polling_max_cnt;
     p_ctx->pl.i2c_cmd         = PL_I2C_CMD_WRITE;
     //lint --e{534} suppress "Return value is not required to be checked"
     pal_i2c_write(p_ctx->p_pal_i2c_ctx,p_ctx->pl.buffer, p_ctx->pl.buffer_tx_len);
@@ -352,7 +373,7 @@ static host_lib_status_t ifx_i2c_pl_set_bit_rate(ifx_i2c_context_t *p_ctx, uint1
         if (p_ctx->pl.retry_counter--)
         {
             LOG_PL("[IFX-PL]: Set bit rate failed, Retry setting.\n");
-            pal_os_event_register_callback_oneshot(ifx_i2c_pl_negotiation_event_handler,((void*)p_ctx),PL_POLLING_INVERVAL_US);
+            pal_os_event_register_callback_oneshot(ifx_i2c_pl_negotiation_event_handler,((void*)p_ctx),p_ctx->p_timing->pl_polling_interval_us);
             status = IFX_I2C_STACK_BUSY;
         }
         else
@@ -374,7 +395,7 @@ static void ifx_i2c_pl_negotiation_event_handler(void *p_input_ctx)
     uint8_t continue_negotiation;
     ifx_i2c_context_t* p_ctx = (ifx_i2c_context_t*)p_input_ctx;
 	uint8_t i2c_mode_value[2];
-    uint8_t max_frame_size[2] = { (uint8_t)(p_ctx->frame_size >> 8), (uint8_t)(p_ctx->frame_size) };
+    uint8_t max_frame_size[2] = { (uint8_t)(p_ctx->pl.requested_frame_size >> 8), (uint8_t)(p_ctx->pl.requested_frame_size) };
     uint16_t buffer_len = 0;
     uint16_t slave_frequency;
 	uint16_t slave_frame_len;
@@ -502,9 +523,14 @@ static void ifx_i2c_pl_negotiation_event_handler(void *p_input_ctx)
 				p_ctx->pl.negotiate_state = PL_INIT_DONE;
 				slave_frame_len = (p_ctx->pl.buffer[0] << 8) | p_ctx->pl.buffer[1]; 
                 // Error if slave's frame length is more than requested frame length
-				if(p_ctx->frame_size >= slave_frame_len)
+				if(p_ctx->pl.requested_frame_size >= slave_frame_len)
 				{
-					p_ctx->frame_size = slave_frame_len;
+					p_ctx->pl.data_reg_len = slave_frame_len;
+					// An update keeps the negotiated frame size as upper limit
+					if(!p_ctx->pl.frame_size_update)
+					{
+						p_ctx->frame_size = slave_frame_len;
+					}
 					event = IFX_I2C_STACK_SUCCESS;
 				}
                 p_buffer = NULL;
@@ -514,7 +540,8 @@ static void ifx_i2c_pl_negotiation_event_handler(void *p_input_ctx)
             break;
             case PL_INIT_DONE:
             {   
-                if(IFX_I2C_STACK_SUCCESS == event)
+                // A failed frame size update keeps the previous frame size in use
+                if((IFX_I2C_STACK_SUCCESS == event) || (p_ctx->pl.frame_size_update))
                 {                
                     p_ctx->pl.frame_state = PL_STATE_READY;
                 }
@@ -522,6 +549,7 @@ static void ifx_i2c_pl_negotiation_event_handler(void *p_input_ctx)
                 {
                     p_ctx->pl.frame_state = PL_STATE_UNINIT;
                 }
+                p_ctx->pl.frame_size_update = FALSE;
                 // Negotiation between master and slave is complete
                 p_ctx->pl.upper_layer_event_handler(p_ctx,event, p_buffer, buffer_len);
             }
@@ -584,7 +612,7 @@ static void ifx_i2c_pl_frame_event_handler(ifx_i2c_context_t *p_ctx,host_lib_sta
                         // Continue polling STATUS register if retry limit is not reached
                         if ((pal_os_timer_get_time_in_milliseconds() - p_ctx->dl.frame_start_time) < p_ctx->dl.data_poll_timeout)
                         {
-                            pal_os_event_register_callback_oneshot(ifx_i2c_pl_status_poll_callback, (void *)p_ctx, PL_DATA_POLLING_INVERVAL_US);
+                            pal_os_event_register_callback_oneshot(ifx_i2c_pl_status_poll_callback, (void *)p_ctx, p_ctx->p_timing->pl_data_polling_interval_us);
                         }
                         else
                         {
@@ -606,7 +634,7 @@ static void ifx_i2c_pl_frame_event_handler(ifx_i2c_context_t *p_ctx,host_lib_sta
                     // Continue polling STATUS register if retry limit is not reached
                     if ((pal_os_timer_get_time_in_milliseconds() - p_ctx->dl.frame_start_time) < p_ctx->dl.data_poll_timeout)
                     {
-                        pal_os_event_register_callback_oneshot(ifx_i2c_pl_status_poll_callback, (void *)p_ctx, PL_DATA_POLLING_INVERVAL_US);
+                        pal_os_event_register_callback_oneshot(ifx_i2c_pl_status_poll_callback, (void *)p_ctx, p_ctx->p_timing->pl_data_polling_interval_us);
                     }
                     else
                     {
@@ -684,7 +712,7 @@ static void ifx_i2c_pl_pal_event_handler(void *p_ctx, host_lib_status_t event)
             if (p_local_ctx->pl.retry_counter--)
             {
 				LOG_PL("[IFX-PL]: PAL Error -> Continue polling\n");
-                pal_os_event_register_callback_oneshot(ifx_i2c_pal_poll_callback,p_local_ctx,PL_POLLING_INVERVAL_US);
+                pal_os_event_register_callback_oneshot(ifx_i2c_pal_poll_callback,p_local_ctx,p_local_ctx->p_timing->pl_polling_interval_us);
             }
             else
             {
@@ -48,6 +48,7 @@
 #define TL_STATE_ERROR                      (0x06)
 #define TL_STATE_CHAINING_ERROR             (0x07)
 #define TL_STATE_RESEND                     (0x08)
+#define TL_STATE_FRAME_SIZE                 (0x09)
 // Transport Layer header size
 #define TL_HEADER_SIZE                      1
 
@@ -60,6 +61,8 @@
 
 #define TL_PCTR_CHANNEL_MASK                (0xF8)
 #define TL_PCTR_CHAIN_MASK                  (0x07)
+// Mask of the command code in the first byte of a command
+#define TL_CMD_CODE_MASK                    (0x7F)
 // Setup debug log statements
 #if IFX_I2C_LOG_TL == 1
 #include "common/Log_api.h"
@@ -99,6 +102,8 @@ _STATIC_H host_lib_status_t ifx_i2c_tl_send_chaining_error(ifx_i2c_context_t *p_
 _STATIC_H uint8_t ifx_i2c_tl_calculate_pctr(const ifx_i2c_context_t *p_ctx);
 /// Checks if chaining error occured based on current and previous pctr
 _STATIC_H host_lib_status_t ifx_i2c_tl_check_chaining_error(uint8_t current_chaning, uint8_t previous_chaining);
+/// Gets the maximum execution time of the command in transmission, 0 if it is not known
+_STATIC_H uint32_t ifx_i2c_tl_get_max_exec_time(const ifx_i2c_context_t *p_ctx);
 /// @endcond
 /***********************************************************************************************************************
 * API PROTOTYPES
@@ -154,6 +159,19 @@ host_lib_status_t ifx_i2c_tl_transceive(ifx_i2c_context_t *p_ctx,uint8_t* p_pack
         p_ctx->tl.master_chaining_error_count = 0;
         p_ctx->tl.transmission_completed = 0;
 		p_ctx->tl.error_event = IFX_I2C_STACK_ERROR;
+        p_ctx->dl.response_timeout_ms = 0;
+        // Agree the adapted frame size with the slave first, the packet is fragmented for it
+        if (0 != p_ctx->dl.target_frame_size)
+        {
+            p_ctx->tl.state = TL_STATE_FRAME_SIZE;
+            status = ifx_i2c_dl_set_frame_size(p_ctx, p_ctx->dl.target_frame_size);
+            if (IFX_I2C_STACK_SUCCESS != status)
+            {
+                p_ctx->tl.state = TL_STATE_IDLE;
+            }
+            break;
+        }
+        p_ctx->tl.max_packet_length = p_ctx->pl.data_reg_len - (DL_HEADER_SIZE + TL_HEADER_SIZE);
         status = ifx_i2c_tl_send_next_fragment(p_ctx);
     }while(FALSE);
     return status;
@@ -202,6 +220,23 @@ _STATIC_H uint8_t ifx_i2c_tl_calculate_pctr(const ifx_i2c_context_t *p_ctx)
           
     return pctr;
 }
+_STATIC_H uint32_t ifx_i2c_tl_get_max_exec_time(const ifx_i2c_context_t *p_ctx)
+{
+    uint32_t max_exec_time_ms = 0;
+    uint8_t cmd = p_ctx->tl.p_actual_packet[0] & TL_CMD_CODE_MASK;
+    uint8_t index;
+
+    for (index = 0; index < p_ctx->p_timing->cmd_timings_count; index++)
+    {
+        if (cmd == p_ctx->p_timing->p_cmd_timings[index].cmd)
+        {
+            max_exec_time_ms = p_ctx->p_timing->p_cmd_timings[index].max_exec_time_ms;
+            break;
+        }
+    }
+    return max_exec_time_ms;
+}
+
 _STATIC_H host_lib_status_t ifx_i2c_tl_send_next_fragment(ifx_i2c_context_t *p_ctx)
 {
     uint8_t pctr = 0;
@@ -258,8 +293,8 @@ _STATIC_H void ifx_i2c_dl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status
             pctr = p_data[0];
             chaining = pctr & TL_PCTR_CHAIN_MASK;
         }
-        // Propagate errors to upper layer
-        if ((event & IFX_I2C_DL_EVENT_ERROR)||(pctr & TL_PCTR_CHANNEL_MASK))
+        // Propagate errors to upper layer, a failed frame size update keeps the previous frame size
+        if (((event & IFX_I2C_DL_EVENT_ERROR) && (TL_STATE_FRAME_SIZE != p_ctx->tl.state))||(pctr & TL_PCTR_CHANNEL_MASK))
         {
             p_ctx->tl.state = TL_STATE_ERROR;
 			p_ctx->tl.error_event = IFX_I2C_STACK_ERROR;
@@ -272,6 +307,20 @@ _STATIC_H void ifx_i2c_dl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status
                 p_ctx->tl.upper_layer_event_handler(p_ctx,IFX_I2C_STACK_SUCCESS, 0, 0);
             }
             break;
+            case TL_STATE_FRAME_SIZE:
+            {
+                // Frame size update done, send the packet
+                LOG_TL("[IFX-TL]: Frame size %d, start Tx\n", p_ctx->pl.data_reg_len);
+                p_ctx->tl.max_packet_length = p_ctx->pl.data_reg_len - (DL_HEADER_SIZE + TL_HEADER_SIZE);
+                p_ctx->tl.state = TL_STATE_TX;
+                exit_machine = FALSE;
+                if (ifx_i2c_tl_send_next_fragment(p_ctx))
+                {
+                    p_ctx->tl.state = TL_STATE_IDLE;
+                    p_ctx->tl.upper_layer_event_handler(p_ctx,p_ctx->tl.error_event, 0u, 0u);
+                }
+            }
+            break;
             case TL_STATE_TX:
             {
                 // Frame transmission in Data Link layer complete, start receiving frames
@@ -311,6 +360,8 @@ _STATIC_H void ifx_i2c_dl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status
                         if (!(event & IFX_I2C_DL_EVENT_RX_SUCCESS))
                         {
                             LOG_TL("[IFX-TL]: Tx:Data already received after Tx\n");
+                            // Poll for the response right away, at most for the maximum execution time of the command
+                            p_ctx->dl.response_timeout_ms = ifx_i2c_tl_get_max_exec_time(p_ctx);
                             // Received CTRL frame, trigger reception in Data Link layer
                             if (ifx_i2c_dl_receive_frame(p_ctx))
                             {
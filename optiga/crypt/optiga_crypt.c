@@ -30,8 +30,251 @@
 */
 
 #include "optiga/optiga_crypt.h"
+#include "optiga/common/MemoryMgmt.h"
 #include "optiga/pal/pal_os_lock.h"
 
+#ifdef OPTIGA_CRYPT_VERIFY_CACHE_ENTRIES
+
+/// @cond hidden
+///Length of the random key of the verification result tags
+#define OPTIGA_CRYPT_VERIFY_CACHE_KEY_LENGTH    (32)
+
+///SipHash round
+#define OPTIGA_CRYPT_SIPROUND(v0, v1, v2, v3) \
+    do { \
+        v0 += v1; v1 = (v1 << 13) | (v1 >> 51); v1 ^= v0; v0 = (v0 << 32) | (v0 >> 32); \
+        v2 += v3; v3 = (v3 << 16) | (v3 >> 48); v3 ^= v2; \
+        v0 += v3; v3 = (v3 << 21) | (v3 >> 43); v3 ^= v0; \
+        v2 += v1; v1 = (v1 << 17) | (v1 >> 47); v1 ^= v2; v2 = (v2 << 32) | (v2 >> 32); \
+    } while (0)
+
+///Positive verification result
+typedef struct optiga_crypt_verify_cache_entry
+{
+    ///Keyed tag of public key, digest and signature
+    uint64_t tag[2];
+    ///Comms context of the chip which verified the signature
+    const optiga_comms_t * p_comms;
+    ///OID of the public key, 0x0000 for a public key from host
+    uint16_t oid;
+    ///Entry holds a result
+    uint8_t valid;
+} optiga_crypt_verify_cache_entry_t;
+
+static optiga_crypt_verify_cache_entry_t verify_cache[OPTIGA_CRYPT_VERIFY_CACHE_ENTRIES];
+///Entry to be replaced next, if the cache is full
+static uint8_t verify_cache_next = 0;
+///Key of the tags, drawn from the OPTIGA TRNG on first use
+static uint64_t verify_cache_key[OPTIGA_CRYPT_VERIFY_CACHE_KEY_LENGTH / 8];
+static uint8_t verify_cache_key_valid = FALSE;
+static optiga_crypt_verify_cache_metrics_t verify_cache_metrics;
+
+//SipHash-2-4 of the concatenated parts
+static uint64_t __optiga_crypt_siphash(const uint64_t * key, const uint8_t * const * parts,
+                                       const uint16_t * part_lengths, uint8_t part_count)
+{
+    uint64_t v0 = key[0] ^ 0x736f6d6570736575ULL;
+    uint64_t v1 = key[1] ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = key[0] ^ 0x6c7967656e657261ULL;
+    uint64_t v3 = key[1] ^ 0x7465646279746573ULL;
+    uint64_t m = 0;
+    uint32_t total = 0;
+    uint8_t part;
+    uint16_t index;
+
+    for (part = 0; part < part_count; part++)
+    {
+        for (index = 0; index < part_lengths[part]; index++)
+        {
+            m |= ((uint64_t)parts[part][index]) << (8 * (total & 7));
+            total++;
+            if (0 == (total & 7))
+            {
+                v3 ^= m;
+                OPTIGA_CRYPT_SIPROUND(v0, v1, v2, v3);
+                OPTIGA_CRYPT_SIPROUND(v0, v1, v2, v3);
+                v0 ^= m;
+                m = 0;
+            }
+        }
+    }
+    m |= ((uint64_t)total) << 56;
+    v3 ^= m;
+    OPTIGA_CRYPT_SIPROUND(v0, v1, v2, v3);
+    OPTIGA_CRYPT_SIPROUND(v0, v1, v2, v3);
+    v0 ^= m;
+    v2 ^= 0xFF;
+    OPTIGA_CRYPT_SIPROUND(v0, v1, v2, v3);
+    OPTIGA_CRYPT_SIPROUND(v0, v1, v2, v3);
+    OPTIGA_CRYPT_SIPROUND(v0, v1, v2, v3);
+    OPTIGA_CRYPT_SIPROUND(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+//Computes the 128 bit tag of a verification. Must be called with the OPTIGA lock acquired
+static uint8_t __optiga_crypt_verify_cache_tag(const sVerifyOption_d * verify_options, const sbBlob_d * digest,
+                                               const sbBlob_d * signature, uint64_t * tag)
+{
+    uint8_t random_key[OPTIGA_CRYPT_VERIFY_CACHE_KEY_LENGTH];
+    uint8_t header[8];
+    const uint8_t * parts[4];
+    uint16_t part_lengths[4];
+    sRngOptions_d rand_options;
+    sCmdResponse_d rand_response;
+    uint8_t index;
+
+    if ((NULL == digest->prgbStream) || (NULL == signature->prgbStream))
+    {
+        return FALSE;
+    }
+
+    if (!verify_cache_key_valid)
+    {
+        rand_options.eRngType       = eTRNG;
+        rand_options.wRandomDataLen = sizeof(random_key);
+        rand_response.prgbBuffer    = random_key;
+        rand_response.wBufferLength = sizeof(random_key);
+        rand_response.wRespLength   = 0;
+        if (CMD_LIB_OK != CmdLib_GetRandom(&rand_options, &rand_response))
+        {
+            return FALSE;
+        }
+        for (index = 0; index < sizeof(random_key); index++)
+        {
+            verify_cache_key[index / 8] = (verify_cache_key[index / 8] << 8) | random_key[index];
+        }
+        verify_cache_key_valid = TRUE;
+    }
+
+    //Lengths are part of the tag, so the boundaries between the parts are unambiguous
+    header[0] = (uint8_t)verify_options->eVerifyDataType;
+    header[1] = (uint8_t)verify_options->sPubKeyInput.eAlgId;
+    header[2] = (uint8_t)(digest->wLen >> 8);
+    header[3] = (uint8_t)(digest->wLen);
+    header[4] = (uint8_t)(signature->wLen >> 8);
+    header[5] = (uint8_t)(signature->wLen);
+    header[6] = 0x00;
+    header[7] = 0x00;
+    parts[0] = header;
+    part_lengths[0] = sizeof(header);
+    parts[1] = digest->prgbStream;
+    part_lengths[1] = digest->wLen;
+    parts[2] = signature->prgbStream;
+    part_lengths[2] = signature->wLen;
+    parts[3] = header;
+    part_lengths[3] = 0;
+    if (eDataStream == verify_options->eVerifyDataType)
+    {
+        if (NULL == verify_options->sPubKeyInput.sDataStream.prgbStream)
+        {
+            return FALSE;
+        }
+        parts[3] = verify_options->sPubKeyInput.sDataStream.prgbStream;
+        part_lengths[3] = verify_options->sPubKeyInput.sDataStream.wLen;
+    }
+    else
+    {
+        header[6] = (uint8_t)(verify_options->wOIDPubKey >> 8);
+        header[7] = (uint8_t)(verify_options->wOIDPubKey);
+    }
+
+    tag[0] = __optiga_crypt_siphash(&verify_cache_key[0], parts, part_lengths, 4);
+    tag[1] = __optiga_crypt_siphash(&verify_cache_key[2], parts, part_lengths, 4);
+    return TRUE;
+}
+
+//Drops the results of an OID of one chip, called by the command library for every change of a data object or key
+static void __optiga_crypt_verify_cache_changed(const optiga_comms_t * p_comms, uint16_t optiga_oid)
+{
+    uint8_t index;
+
+    for (index = 0; index < OPTIGA_CRYPT_VERIFY_CACHE_ENTRIES; index++)
+    {
+        if ((p_comms == verify_cache[index].p_comms) &&
+            ((0x0000 == optiga_oid) || (optiga_oid == verify_cache[index].oid)))
+        {
+            verify_cache[index].valid = FALSE;
+        }
+    }
+}
+
+static uint8_t __optiga_crypt_verify_cache_find(const uint64_t * tag)
+{
+    const optiga_comms_t * p_comms = CmdLib_GetOptigaCommsContext();
+    uint8_t index;
+
+    verify_cache_metrics.lookups++;
+    for (index = 0; index < OPTIGA_CRYPT_VERIFY_CACHE_ENTRIES; index++)
+    {
+        if ((verify_cache[index].valid) && (p_comms == verify_cache[index].p_comms) &&
+            (tag[0] == verify_cache[index].tag[0]) && (tag[1] == verify_cache[index].tag[1]))
+        {
+            verify_cache_metrics.hits++;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void __optiga_crypt_verify_cache_store(uint16_t optiga_oid, const uint64_t * tag)
+{
+    optiga_crypt_verify_cache_entry_t * p_entry = NULL;
+    uint8_t index;
+
+    //From now on the command library reports the writes, metadata updates and key generations
+    CmdLib_SetObjectChangedHandler(__optiga_crypt_verify_cache_changed);
+
+    for (index = 0; (index < OPTIGA_CRYPT_VERIFY_CACHE_ENTRIES) && (NULL == p_entry); index++)
+    {
+        if (!verify_cache[index].valid)
+        {
+            p_entry = &verify_cache[index];
+        }
+    }
+    if (NULL == p_entry)
+    {
+        p_entry = &verify_cache[verify_cache_next];
+        verify_cache_next = (verify_cache_next + 1) % OPTIGA_CRYPT_VERIFY_CACHE_ENTRIES;
+        verify_cache_metrics.evictions++;
+    }
+    p_entry->tag[0] = tag[0];
+    p_entry->tag[1] = tag[1];
+    p_entry->p_comms = CmdLib_GetOptigaCommsContext();
+    p_entry->oid = optiga_oid;
+    p_entry->valid = TRUE;
+    verify_cache_metrics.stores++;
+}
+
+#undef OPTIGA_CRYPT_SIPROUND
+/// @endcond
+
+void optiga_crypt_verify_cache_clear(uint16_t optiga_oid)
+{
+    uint8_t index;
+
+    for (index = 0; index < OPTIGA_CRYPT_VERIFY_CACHE_ENTRIES; index++)
+    {
+        if ((0x0000 == optiga_oid) || (optiga_oid == verify_cache[index].oid))
+        {
+            verify_cache[index].valid = FALSE;
+        }
+    }
+}
+
+void optiga_crypt_verify_cache_get_metrics(optiga_crypt_verify_cache_metrics_t * p_metrics)
+{
+    if (NULL != p_metrics)
+    {
+        *p_metrics = verify_cache_metrics;
+    }
+    verify_cache_metrics.lookups = 0;
+    verify_cache_metrics.hits = 0;
+    verify_cache_metrics.stores = 0;
+    verify_cache_metrics.evictions = 0;
+}
+
+#endif //OPTIGA_CRYPT_VERIFY_CACHE_ENTRIES
+
 optiga_lib_status_t optiga_crypt_random(optiga_rng_types_t rng_type,
                                         uint8_t * random_data,
                                         uint16_t random_data_length)
@@ -87,9 +330,51 @@ optiga_lib_status_t optiga_crypt_hash_start(optiga_hash_context_t * hash_ctx)
     return OPTIGA_LIB_SUCCESS;
 }
 
-optiga_lib_status_t optiga_crypt_hash_update(optiga_hash_context_t * hash_ctx,
-                                             uint8_t source_of_data_to_hash,
-                                             void * data_to_hash)
+/// @cond hidden
+///Position in the host buffers of #optiga_crypt_hash_update_vector
+typedef struct optiga_crypt_hash_vector_iterator
+{
+    const hash_data_from_host_t * vector;
+    uint8_t count;
+    uint8_t index;
+    uint32_t offset;
+} optiga_crypt_hash_vector_iterator_t;
+/// @endcond
+
+//Copies the next bytes of the host buffers into the command buffer
+static uint16_t __optiga_crypt_hash_vector_gather(Void * ctx, uint8_t * dest, uint16_t length)
+{
+    optiga_crypt_hash_vector_iterator_t * iterator = (optiga_crypt_hash_vector_iterator_t *)ctx;
+    uint16_t copied = 0;
+    uint32_t chunk;
+
+    while ((copied < length) && (iterator->index < iterator->count))
+    {
+        //Buffers with a length of 0 are not accessed at all
+        if (iterator->offset == iterator->vector[iterator->index].length)
+        {
+            iterator->index++;
+            iterator->offset = 0;
+            continue;
+        }
+        chunk = iterator->vector[iterator->index].length - iterator->offset;
+        if (chunk > (uint32_t)(length - copied))
+        {
+            chunk = (uint32_t)(length - copied);
+        }
+        OCP_MEMCPY(dest + copied, iterator->vector[iterator->index].buffer + iterator->offset, (uint16_t)chunk);
+        copied += (uint16_t)chunk;
+        iterator->offset += chunk;
+    }
+    return copied;
+}
+
+//Hash update of host data or data in OPTIGA. With a gather, the host data is taken from it and only
+//the length of data_to_hash is used.
+static optiga_lib_status_t __optiga_crypt_hash_update(optiga_hash_context_t * hash_ctx,
+                                                      uint8_t source_of_data_to_hash,
+                                                      void * data_to_hash,
+                                                      const sDataGather_d * gather)
 {
     optiga_lib_status_t return_value;
     sCalcHash_d hash_options;
@@ -169,7 +454,7 @@ optiga_lib_status_t optiga_crypt_hash_update(optiga_hash_context_t * hash_ctx,
     while (1)
     {   
         while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS);
-        return_value = CmdLib_CalcHash(&hash_options);
+        return_value = (NULL != gather) ? CmdLib_CalcHashVector(&hash_options, gather) : CmdLib_CalcHash(&hash_options);
         pal_os_lock_release();
 
         if (CMD_LIB_OK != return_value)
@@ -184,7 +469,10 @@ optiga_lib_status_t optiga_crypt_hash_update(optiga_hash_context_t * hash_ctx,
         }
         else
         {
-            hash_options.sDataStream.prgbStream += remaining_comm_buffer_size;
+            if (NULL == gather)
+            {
+                hash_options.sDataStream.prgbStream += remaining_comm_buffer_size;
+            }
             size_of_data_to_hash -= remaining_comm_buffer_size;
 
             remaining_comm_buffer_size = size_of_data_to_hash;
@@ -210,6 +498,49 @@ optiga_lib_status_t optiga_crypt_hash_update(optiga_hash_context_t * hash_ctx,
     return return_value;
 }
 
+optiga_lib_status_t optiga_crypt_hash_update(optiga_hash_context_t * hash_ctx,
+                                             uint8_t source_of_data_to_hash,
+                                             void * data_to_hash)
+{
+    return __optiga_crypt_hash_update(hash_ctx, source_of_data_to_hash, data_to_hash, NULL);
+}
+
+optiga_lib_status_t optiga_crypt_hash_update_vector(optiga_hash_context_t * hash_ctx,
+                                                    const hash_data_from_host_t * data_vector,
+                                                    uint8_t count)
+{
+    optiga_crypt_hash_vector_iterator_t iterator;
+    sDataGather_d gather;
+    hash_data_from_host_t total;
+    uint8_t index;
+
+    if ((NULL == hash_ctx) || (NULL == data_vector) || (0 == count))
+    {
+        return OPTIGA_CRYPT_ERROR_INVALID_INPUT;
+    }
+
+    total.buffer = NULL;
+    total.length = 0;
+    for (index = 0; index < count; index++)
+    {
+        if ((NULL == data_vector[index].buffer) && (0 != data_vector[index].length))
+        {
+            return OPTIGA_CRYPT_ERROR_INVALID_INPUT;
+        }
+        total.length += data_vector[index].length;
+    }
+
+    iterator.vector = data_vector;
+    iterator.count  = count;
+    iterator.index  = 0;
+    iterator.offset = 0;
+
+    gather.pfGather = __optiga_crypt_hash_vector_gather;
+    gather.pCtx     = &iterator;
+
+    return __optiga_crypt_hash_update(hash_ctx, OPTIGA_CRYPT_HOST_DATA, &total, &gather);
+}
+
 optiga_lib_status_t optiga_crypt_hash_finalize(optiga_hash_context_t * hash_ctx,
                                                uint8_t * hash_output)
 {
@@ -333,6 +664,10 @@ optiga_lib_status_t optiga_crypt_ecdsa_verify (uint8_t * digest,
     optiga_lib_status_t return_value;
     sVerifyOption_d verifysign_options;
     sbBlob_d sign, dgst;
+#ifdef OPTIGA_CRYPT_VERIFY_CACHE_ENTRIES
+    uint64_t cache_tag[2];
+    uint8_t cache_tag_valid;
+#endif
 
     verifysign_options.eSignScheme         = eECDSA_FIPS_186_3_WITHOUT_HASH;
     verifysign_options.sPubKeyInput.eAlgId = (eAlgId_d )(((public_key_from_host_t *)public_key)->curve);
@@ -356,7 +691,25 @@ optiga_lib_status_t optiga_crypt_ecdsa_verify (uint8_t * digest,
     sign.wLen       = signature_length;
 
     while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS);
-    return_value = CmdLib_VerifySign(&verifysign_options, &dgst, &sign);
+#ifdef OPTIGA_CRYPT_VERIFY_CACHE_ENTRIES
+    cache_tag_valid = __optiga_crypt_verify_cache_tag(&verifysign_options, &dgst, &sign, cache_tag);
+    if (cache_tag_valid && __optiga_crypt_verify_cache_find(cache_tag))
+    {
+        return_value = CMD_LIB_OK;
+    }
+    else
+#endif
+    {
+        return_value = CmdLib_VerifySign(&verifysign_options, &dgst, &sign);
+#ifdef OPTIGA_CRYPT_VERIFY_CACHE_ENTRIES
+        //Only positive results are kept
+        if ((CMD_LIB_OK == return_value) && cache_tag_valid)
+        {
+            __optiga_crypt_verify_cache_store((eOIDData == verifysign_options.eVerifyDataType) ?
+                                              verifysign_options.wOIDPubKey : 0x0000, cache_tag);
+        }
+#endif
+    }
     pal_os_lock_release();
 
     if(CMD_LIB_OK == return_value)
@@ -456,3 +809,298 @@ optiga_lib_status_t optiga_crypt_tls_prf_sha256(uint16_t secret,
 
     return return_value;
 }
+
+/**
+ * Checks the steps of a command program and their bindings before execution.
+ */
+static optiga_lib_status_t __optiga_crypt_check_program(const optiga_crypt_step_t * steps,
+                                                        uint8_t step_count)
+{
+    optiga_lib_status_t return_value = OPTIGA_CRYPT_SUCCESS;
+    const optiga_crypt_step_t * step;
+    uint8_t index;
+
+    for (index = 0; index < step_count; index++)
+    {
+        step = &steps[index];
+
+        //The first step has nothing to be bound to
+        if ((0 == index) && (0 != step->bind))
+        {
+            return_value = OPTIGA_CRYPT_ERROR_INVALID_INPUT;
+            break;
+        }
+
+        //Output of the previous step is only available if it was exported to host
+        if ((step->bind & OPTIGA_CRYPT_STEP_INPUT_FROM_PREVIOUS) &&
+            ((NULL == steps[index - 1].output) || (OPTIGA_CRYPT_STEP_ECDSA_VERIFY == steps[index - 1].type) ||
+             ((OPTIGA_CRYPT_STEP_ECC_GENERATE_KEYPAIR != steps[index - 1].type) && (0x0000 != steps[index - 1].target_oid))))
+        {
+            return_value = OPTIGA_CRYPT_ERROR_INVALID_INPUT;
+            break;
+        }
+
+        if ((step->bind & OPTIGA_CRYPT_STEP_OID_FROM_PREVIOUS) && (0x0000 == steps[index - 1].target_oid))
+        {
+            return_value = OPTIGA_CRYPT_ERROR_INVALID_INPUT;
+            break;
+        }
+
+        switch (step->type)
+        {
+            case OPTIGA_CRYPT_STEP_RANDOM:
+            {
+                if (NULL == step->output)
+                {
+                    return_value = OPTIGA_CRYPT_ERROR_INVALID_INPUT;
+                }
+            }
+            break;
+            case OPTIGA_CRYPT_STEP_ECC_GENERATE_KEYPAIR:
+            {
+                if ((NULL == step->output) || (0x0000 == step->target_oid))
+                {
+                    return_value = OPTIGA_CRYPT_ERROR_INVALID_INPUT;
+                }
+            }
+            break;
+            case OPTIGA_CRYPT_STEP_ECDSA_SIGN:
+            case OPTIGA_CRYPT_STEP_ECDSA_VERIFY:
+            {
+                if (((NULL == step->input) && !(step->bind & OPTIGA_CRYPT_STEP_INPUT_FROM_PREVIOUS)) ||
+                    (NULL == step->output))
+                {
+                    return_value = OPTIGA_CRYPT_ERROR_INVALID_INPUT;
+                }
+                if ((OPTIGA_CRYPT_STEP_ECDSA_VERIFY == step->type) && (0x0000 == step->oid) &&
+                    !(step->bind & OPTIGA_CRYPT_STEP_OID_FROM_PREVIOUS) && (NULL == step->public_key))
+                {
+                    return_value = OPTIGA_CRYPT_ERROR_INVALID_INPUT;
+                }
+            }
+            break;
+            case OPTIGA_CRYPT_STEP_ECDH:
+            {
+                if ((NULL == step->public_key) || ((0x0000 == step->target_oid) && (NULL == step->output)))
+                {
+                    return_value = OPTIGA_CRYPT_ERROR_INVALID_INPUT;
+                }
+            }
+            break;
+            case OPTIGA_CRYPT_STEP_TLS_PRF_SHA256:
+            {
+                if (((NULL == step->input) && !(step->bind & OPTIGA_CRYPT_STEP_INPUT_FROM_PREVIOUS)) ||
+                    ((0x0000 == step->target_oid) && (NULL == step->output)))
+                {
+                    return_value = OPTIGA_CRYPT_ERROR_INVALID_INPUT;
+                }
+            }
+            break;
+            default:
+            {
+                return_value = OPTIGA_CRYPT_ERROR_INVALID_INPUT;
+            }
+            break;
+        }
+
+        if (OPTIGA_CRYPT_SUCCESS != return_value)
+        {
+            break;
+        }
+    }
+
+    return return_value;
+}
+
+/**
+ * Executes one step of a command program. The OPTIGA lock must be held by the caller.
+ */
+static int32_t __optiga_crypt_execute_step(optiga_crypt_step_t * step)
+{
+    int32_t return_value = (int32_t)CMD_LIB_ERROR;
+    sbBlob_d output;
+    sCmdResponse_d response;
+
+    output.prgbStream = step->output;
+    output.wLen       = step->output_length;
+
+    switch (step->type)
+    {
+        case OPTIGA_CRYPT_STEP_RANDOM:
+        {
+            sRngOptions_d rand_options;
+
+            rand_options.eRngType       = (eRngType_d)step->param;
+            rand_options.wRandomDataLen = step->output_length;
+
+            response.prgbBuffer    = step->output;
+            response.wBufferLength = step->output_length;
+            response.wRespLength   = 0;
+
+            return_value = CmdLib_GetRandom(&rand_options, &response);
+        }
+        break;
+        case OPTIGA_CRYPT_STEP_ECC_GENERATE_KEYPAIR:
+        {
+            sKeyPairOption_d keypair_options;
+            sOutKeyPair_d public_key_out;
+
+            keypair_options.eAlgId      = (eAlgId_d)step->param;
+            keypair_options.eKeyUsage   = (eKeyUsage_d)step->key_usage;
+            keypair_options.eKeyExport  = eStorePrivKeyOnly;
+            keypair_options.wOIDPrivKey = step->target_oid;
+
+            public_key_out.sPublicKey = output;
+
+            return_value = CmdLib_GenerateKeyPair(&keypair_options, &public_key_out);
+            output.wLen = public_key_out.sPublicKey.wLen;
+        }
+        break;
+        case OPTIGA_CRYPT_STEP_ECDSA_SIGN:
+        {
+            sCalcSignOptions_d sign_options;
+
+            sign_options.eSignScheme = eECDSA_FIPS_186_3_WITHOUT_HASH;
+            sign_options.wOIDSignKey = step->oid;
+            sign_options.sDigestToSign.prgbStream = step->input;
+            sign_options.sDigestToSign.wLen       = step->input_length;
+
+            return_value = CmdLib_CalculateSign(&sign_options, &output);
+        }
+        break;
+        case OPTIGA_CRYPT_STEP_ECDSA_VERIFY:
+        {
+            sVerifyOption_d verifysign_options;
+            sbBlob_d digest;
+
+            verifysign_options.eSignScheme = eECDSA_FIPS_186_3_WITHOUT_HASH;
+            if (0x0000 != step->oid)
+            {
+                verifysign_options.eVerifyDataType     = eOIDData;
+                verifysign_options.wOIDPubKey          = step->oid;
+                verifysign_options.sPubKeyInput.eAlgId = (eAlgId_d)step->param;
+            }
+            else
+            {
+                verifysign_options.eVerifyDataType     = eDataStream;
+                verifysign_options.sPubKeyInput.eAlgId = (eAlgId_d)step->public_key->curve;
+                verifysign_options.sPubKeyInput.sDataStream.prgbStream = step->public_key->public_key;
+                verifysign_options.sPubKeyInput.sDataStream.wLen       = step->public_key->length;
+            }
+
+            digest.prgbStream = step->input;
+            digest.wLen       = step->input_length;
+
+            return_value = CmdLib_VerifySign(&verifysign_options, &digest, &output);
+        }
+        break;
+        case OPTIGA_CRYPT_STEP_ECDH:
+        {
+            sCalcSSecOptions_d shared_secret_options;
+
+            shared_secret_options.eKeyAgreementType  = eECDH_NISTSP80056A;
+            shared_secret_options.wOIDPrivKey        = step->oid;
+            shared_secret_options.ePubKeyAlgId       = (eAlgId_d)step->public_key->curve;
+            shared_secret_options.sPubKey.prgbStream = step->public_key->public_key;
+            shared_secret_options.sPubKey.wLen       = step->public_key->length;
+            shared_secret_options.wOIDSharedSecret   = step->target_oid;
+
+            return_value = CmdLib_CalculateSharedSecret(&shared_secret_options, &output);
+        }
+        break;
+        case OPTIGA_CRYPT_STEP_TLS_PRF_SHA256:
+        {
+            sDeriveKeyOptions_d derivekey_options;
+
+            derivekey_options.eKDM             = eTLS_PRF_SHA256;
+            derivekey_options.sSeed.prgbStream = step->input;
+            derivekey_options.sSeed.wLen       = step->input_length;
+            derivekey_options.wOIDSharedSecret = step->oid;
+            derivekey_options.wDerivedKeyLen   = (step->param < 16) ? 16 : step->param;
+            derivekey_options.wOIDDerivedKey   = step->target_oid;
+
+            return_value = CmdLib_DeriveKey(&derivekey_options, &output);
+        }
+        break;
+        default:
+        break;
+    }
+
+    if ((CMD_LIB_OK == return_value) && (OPTIGA_CRYPT_STEP_ECDSA_VERIFY != step->type))
+    {
+        //Nothing is returned to host when the result is stored in OPTIGA
+        if ((OPTIGA_CRYPT_STEP_ECC_GENERATE_KEYPAIR != step->type) && (0x0000 != step->target_oid))
+        {
+            output.wLen = 0;
+        }
+        step->output_length = output.wLen;
+    }
+
+    return return_value;
+}
+
+optiga_lib_status_t optiga_crypt_execute_program(optiga_crypt_step_t * steps,
+                                                 uint8_t step_count,
+                                                 uint8_t * failed_step)
+{
+    optiga_lib_status_t return_value = OPTIGA_CRYPT_ERROR_INVALID_INPUT;
+    optiga_crypt_step_t step;
+    uint8_t index = OPTIGA_CRYPT_STEP_INVALID_PROGRAM;
+
+    do
+    {
+        if ((NULL == steps) || (0 == step_count) || (OPTIGA_CRYPT_STEP_INVALID_PROGRAM <= step_count))
+        {
+            break;
+        }
+
+        for (index = 0; index < step_count; index++)
+        {
+            steps[index].status = OPTIGA_CRYPT_STEP_NOT_EXECUTED;
+        }
+
+        index = OPTIGA_CRYPT_STEP_INVALID_PROGRAM;
+        return_value = __optiga_crypt_check_program(steps, step_count);
+        if (OPTIGA_CRYPT_SUCCESS != return_value)
+        {
+            break;
+        }
+
+        //Keep the lock for the complete program, no other command is interleaved between the steps
+        while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS)
+        {
+        }
+        for (index = 0; index < step_count; index++)
+        {
+            //Bindings are resolved on a copy, the program of the caller stays reusable
+            step = steps[index];
+            if (step.bind & OPTIGA_CRYPT_STEP_INPUT_FROM_PREVIOUS)
+            {
+                step.input        = steps[index - 1].output;
+                step.input_length = steps[index - 1].output_length;
+            }
+            if (step.bind & OPTIGA_CRYPT_STEP_OID_FROM_PREVIOUS)
+            {
+                step.oid = steps[index - 1].target_oid;
+            }
+
+            return_value = __optiga_crypt_execute_step(&step);
+            if (CMD_LIB_OK != return_value)
+            {
+                steps[index].status = return_value;
+                break;
+            }
+            steps[index].output_length = step.output_length;
+            steps[index].status = OPTIGA_LIB_SUCCESS;
+            return_value = OPTIGA_LIB_SUCCESS;
+        }
+        pal_os_lock_release();
+    } while (FALSE);
+
+    if (NULL != failed_step)
+    {
+        *failed_step = index;
+    }
+
+    return return_value;
+}
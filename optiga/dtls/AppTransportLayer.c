@@ -0,0 +1,473 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+*
+ * \file AppTransportLayer.c
+ *
+ * \brief This file provides APIs for the transport layer which uses a transport owned by the application.
+ *        Inbound datagrams are fed by reference with OCP_FeedDatagram() and lent to the record layer, which
+ *        processes the records in place and gives the datagram back to the application when it is done.
+ *        Encrypted outbound records are handed over to the application, which frees them once they are transmitted.
+ *
+ * \ingroup grOCP
+ * @{ 
+ *
+ */
+
+#include "optiga/dtls/AppTransportLayer.h"
+#include "optiga/common/MemoryMgmt.h"
+
+#ifdef MODULE_ENABLE_DTLS_MUTUAL_AUTH
+
+/// @cond hidden
+
+///Number of slots of the datagram queue, one slot is kept free to tell a full queue from an empty one
+#define TL_FED_SLOTS                (OCP_TL_MAX_FED_DATAGRAMS + 1)
+
+//The queue is shared by the feeding and the receiving context without a lock. A slot is filled before the write
+//index is published with release ordering and read after the index is loaded with acquire ordering, and the same
+//for the read index when the slot is given back
+#if !defined(TL_LOAD_ACQUIRE)
+#if defined(__GNUC__)
+#define TL_LOAD_ACQUIRE(index)          __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define TL_STORE_RELEASE(index,value)   __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+#elif defined(_MSC_VER)
+//Accesses to volatile objects have acquire and release semantics with MSVC (/volatile:ms)
+#define TL_LOAD_ACQUIRE(index)          (index)
+#define TL_STORE_RELEASE(index,value)   ((index) = (value))
+#else
+#error "Define TL_LOAD_ACQUIRE and TL_STORE_RELEASE for the compiler"
+#endif
+#endif
+
+///Datagram fed by the application
+typedef struct sFedDatagram_d
+{
+    ///Datagram owned by the application
+    const uint8_t* prgbData;
+
+    ///Length of the datagram
+    uint16_t wLen;
+}sFedDatagram_d;
+
+///Transport layer handle
+typedef struct sAppTLHandle_d
+{
+    ///Queue of fed datagrams
+    sFedDatagram_d rgsFed[TL_FED_SLOTS];
+
+    ///Slot of the next datagram to be fed, only updated by the feeding context
+    volatile uint8_t bWrite;
+
+    ///Slot of the next datagram to be received, only updated by the receiving context
+    volatile uint8_t bRead;
+}sAppTLHandle_d;
+
+///Transport layer handle
+#define PS_TL_HANDLE ((sAppTLHandle_d*)PpsTL->phTLHdl)
+
+///Application transport
+#define PS_APP_TRANSPORT (PpsTL->psAppTransport)
+
+//Gives an outbound datagram handed over with pfSendOwned back
+_STATIC_H Void AppTL_FreeSent(const uint8_t* PprgbData)
+{
+    //lint --e{605} suppress "The buffer was allocated by the record layer and is only read by the application"
+    OCP_FREE((uint8_t*)PprgbData);
+}
+
+/// @endcond
+/**
+ * This API initialises the transport layer communication structure.
+ *
+ * \param[in,out]  PpsTL Pointer to the transport layer communication structure
+ *
+ * \return  #OCP_TL_OK on successful execution
+ * \return  #OCP_TL_NULL_PARAM on parameter received is NULL or the send callback is missing
+ * \return  #OCP_TL_MALLOC_FAILURE on failure to allocate memory
+ */
+int32_t AppTL_Init(sTL_d* PpsTL)
+{
+    int32_t i4Status = (int32_t)OCP_TL_ERROR;
+    do
+    {
+        //NULL check
+        if((NULL == PpsTL) || (NULL == PS_APP_TRANSPORT) || (NULL == PS_APP_TRANSPORT->pfSend))
+        {
+            i4Status = (int32_t)OCP_TL_NULL_PARAM;
+            break;
+        }
+
+        PpsTL->phTLHdl = (sAppTLHandle_d*)OCP_MALLOC(sizeof(sAppTLHandle_d));
+        if(NULL == PpsTL->phTLHdl)
+        {
+            i4Status = (int32_t)OCP_TL_MALLOC_FAILURE;
+            break;
+        }
+        PS_TL_HANDLE->bWrite = 0;
+        PS_TL_HANDLE->bRead = 0;
+
+        LOG_TRANSPORTMSG("Initializing application transport",eInfo);
+        i4Status = (int32_t)OCP_TL_OK;
+    }while(FALSE);
+    return i4Status;
+}
+
+/**
+ * This API starts accepting the datagrams fed by the application.
+ *
+ * \param[in,out]  PpsTL     Pointer to the transport layer communication structure
+ *
+ * \return  #OCP_TL_OK on successful execution
+ * \return  #OCP_TL_NULL_PARAM on parameter received is NULL
+ */
+int32_t AppTL_Connect(sTL_d* PpsTL)
+{
+    int32_t i4Status = (int32_t)OCP_TL_ERROR;
+    do
+    {
+        //NULL check
+        if((NULL == PpsTL) || (NULL == PpsTL->phTLHdl))
+        {
+            i4Status = (int32_t)OCP_TL_NULL_PARAM;
+            break;
+        }
+        LOG_TRANSPORTMSG("Connecting application transport",eInfo);
+
+        PpsTL->eIsConnected = eConnected;
+        i4Status = (int32_t)OCP_TL_OK;
+    }while(FALSE);
+    return i4Status;
+}
+
+/**
+ * This API passes the data to the application for transmission.
+ * The buffer belongs to the record layer, the application has to transmit or copy it before returning.
+ *
+ * \param[in]      PpsTL               Pointer to the transport layer communication structure
+ * \param[in]      PpbBuffer           Pointer to buffer containing data to be transmitted
+ * \param[in]      PwLen               Length of the data to be transmitted
+ *
+ * \return  #OCP_TL_OK on successful execution
+ * \return  #OCP_TL_NULL_PARAM on parameter received is NULL
+ * \return  Error returned by the application on failure
+ */
+int32_t AppTL_Send(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t PwLen)
+{
+    int32_t i4Status = (int32_t)OCP_TL_ERROR;
+    do
+    {
+        //NULL check
+        if((NULL == PpsTL) || (NULL == PpsTL->phTLHdl) || (NULL == PpbBuffer))
+        {
+            i4Status = (int32_t)OCP_TL_NULL_PARAM;
+            break;
+        }
+
+        LOG_TRANSPORTDBARY("Sending Data over application transport", PpbBuffer, PwLen, eInfo);
+
+        i4Status = PS_APP_TRANSPORT->pfSend(PS_APP_TRANSPORT->pCtx, PpbBuffer, PwLen);
+        if(OCP_TL_OK != i4Status)
+        {
+            LOG_TRANSPORTMSG("Error while sending data",eError);
+            break;
+        }
+    }while(FALSE);
+    return i4Status;
+}
+
+/**
+ * This API hands a buffer allocated by the record layer over to the application for transmission.
+ * With the pfSendOwned callback the application owns the buffer till it frees it with the callback passed along,
+ * otherwise the buffer is passed to pfSend and freed on return. A buffer not taken by the application is freed here.
+ *
+ * \param[in]      PpsTL               Pointer to the transport layer communication structure
+ * \param[in]      PpbBuffer           Buffer allocated with OCP_MALLOC containing data to be transmitted
+ * \param[in]      PwLen               Length of the data to be transmitted
+ *
+ * \return  #OCP_TL_OK on successful execution
+ * \return  #OCP_TL_NULL_PARAM on parameter received is NULL
+ * \return  Error returned by the application on failure
+ */
+int32_t AppTL_SendOwned(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t PwLen)
+{
+    int32_t i4Status = (int32_t)OCP_TL_ERROR;
+    do
+    {
+        //NULL check
+        if((NULL == PpsTL) || (NULL == PpsTL->phTLHdl) || (NULL == PpbBuffer))
+        {
+            i4Status = (int32_t)OCP_TL_NULL_PARAM;
+            break;
+        }
+
+        if(NULL == PS_APP_TRANSPORT->pfSendOwned)
+        {
+            i4Status = AppTL_Send(PpsTL, PpbBuffer, PwLen);
+            break;
+        }
+
+        LOG_TRANSPORTDBARY("Handing Data over to application transport", PpbBuffer, PwLen, eInfo);
+
+        i4Status = PS_APP_TRANSPORT->pfSendOwned(PS_APP_TRANSPORT->pCtx, PpbBuffer, PwLen, AppTL_FreeSent);
+        if(OCP_TL_OK != i4Status)
+        {
+            LOG_TRANSPORTMSG("Error while sending data",eError);
+            break;
+        }
+        //The application frees the buffer
+        PpbBuffer = NULL;
+    }while(FALSE);
+    OCP_FREE(PpbBuffer);
+    return i4Status;
+}
+
+/**
+ * This API lends the next datagram fed by the application to the record layer.
+ * If no datagram is queued, the poll callback of the application is invoked with the transport layer timeout.
+ * The datagram stays with the record layer till it is given back with #AppTL_ReleaseDatagram.
+ *
+ * \param[in]       PpsTL               Pointer to the transport layer communication structure
+ * \param[out]      PpsDatagram         Pointer to the received datagram
+ *
+ * \return  #OCP_TL_OK on successful execution
+ * \return  #OCP_TL_NULL_PARAM on parameter received is NULL
+ * \return  #OCP_TL_NO_DATA on no datagram fed by the application
+ * \return  Error returned by the poll callback of the application
+ */
+int32_t AppTL_RecvDatagram(const sTL_d* PpsTL,sDatagram_d* PpsDatagram)
+{
+    int32_t i4Status = (int32_t)OCP_TL_ERROR;
+    sFedDatagram_d* psFed;
+    uint8_t bRead;
+    do
+    {
+        //NULL check
+        if((NULL == PpsTL) || (NULL == PpsTL->phTLHdl) || (NULL == PpsDatagram))
+        {
+            i4Status = (int32_t)OCP_TL_NULL_PARAM;
+            break;
+        }
+        memset(PpsDatagram, 0x00, sizeof(sDatagram_d));
+
+        //Let the application run its stack if nothing is queued
+        bRead = PS_TL_HANDLE->bRead;
+        if((bRead == TL_LOAD_ACQUIRE(PS_TL_HANDLE->bWrite)) && (NULL != PS_APP_TRANSPORT->pfPoll))
+        {
+            i4Status = PS_APP_TRANSPORT->pfPoll(PS_APP_TRANSPORT->pCtx, PpsTL->wTimeout);
+            if(((int32_t)OCP_TL_OK != i4Status) && ((int32_t)OCP_TL_NO_DATA != i4Status))
+            {
+                LOG_TRANSPORTMSG("Error while polling application transport",eError);
+                break;
+            }
+        }
+
+        if(bRead == TL_LOAD_ACQUIRE(PS_TL_HANDLE->bWrite))
+        {
+            i4Status = (int32_t)OCP_TL_NO_DATA;
+            break;
+        }
+
+        //The record layer only reads the records of the datagram
+        psFed = &PS_TL_HANDLE->rgsFed[bRead];
+        //lint --e{605} suppress "The datagram is referenced as the segment of a datagram and not written"
+        PpsDatagram->rgpbSegment[0] = (uint8_t*)psFed->prgbData;
+        PpsDatagram->rgwSegmentLen[0] = psFed->wLen;
+        PpsDatagram->bSegmentCount = 1;
+        PpsDatagram->wLen = psFed->wLen;
+        PpsDatagram->pvHandle = (Void*)psFed->prgbData;
+        LOG_TRANSPORTDBARY("Received Data over application transport", psFed->prgbData, psFed->wLen, eInfo);
+
+        //The slot can be fed again, the datagram is referenced by the record layer
+        TL_STORE_RELEASE(PS_TL_HANDLE->bRead, (uint8_t)((bRead + 1) % TL_FED_SLOTS));
+        i4Status = (int32_t)OCP_TL_OK;
+    }while(FALSE);
+    return i4Status;
+}
+
+/**
+ * This API gives a datagram received with #AppTL_RecvDatagram back to the application with its release callback.
+ *
+ * \param[in]       PpsTL               Pointer to the transport layer communication structure
+ * \param[in,out]   PpsDatagram         Pointer to the datagram
+ *
+ * \return  None
+ */
+Void AppTL_ReleaseDatagram(const sTL_d* PpsTL,sDatagram_d* PpsDatagram)
+{
+    if((NULL != PpsTL) && (NULL != PpsDatagram) && (NULL != PpsDatagram->pvHandle))
+    {
+        if(NULL != PS_APP_TRANSPORT->pfRelease)
+        {
+            PS_APP_TRANSPORT->pfRelease(PS_APP_TRANSPORT->pCtx, (const uint8_t*)PpsDatagram->pvHandle);
+        }
+        memset(PpsDatagram, 0x00, sizeof(sDatagram_d));
+    }
+}
+
+/**
+ * This API receives the next datagram fed by the application into a buffer.
+ * The datagram is given back to the application once it is copied.
+ *
+ * \param[in]       PpsTL               Pointer to the transport layer communication structure
+ * \param[in,out]   PpbBuffer           Pointer to buffer where data is to be received
+ * \param[in,out]   PpwLen              Length of the buffer/Length of the received data
+ *
+ * \return  #OCP_TL_OK on successful execution
+ * \return  #OCP_TL_NULL_PARAM on parameter received is NULL
+ * \return  #OCP_TL_NO_DATA on no datagram fed by the application
+ * \return  #OCP_TL_ERROR on a datagram larger than the buffer, the datagram is dropped
+ * \return  Error returned by the poll callback of the application
+ */
+int32_t AppTL_Recv(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t* PpwLen)
+{
+    int32_t i4Status = (int32_t)OCP_TL_ERROR;
+    sDatagram_d sDatagram;
+    do
+    {
+        //NULL check
+        if((NULL == PpbBuffer) || (NULL == PpwLen))
+        {
+            i4Status = (int32_t)OCP_TL_NULL_PARAM;
+            break;
+        }
+
+        i4Status = AppTL_RecvDatagram(PpsTL, &sDatagram);
+        if(OCP_TL_OK != i4Status)
+        {
+            break;
+        }
+
+        if(sDatagram.wLen <= *PpwLen)
+        {
+            memcpy(PpbBuffer, sDatagram.rgpbSegment[0], sDatagram.wLen);
+            *PpwLen = sDatagram.wLen;
+        }
+        else
+        {
+            LOG_TRANSPORTMSG("Dropped datagram larger than the buffer",eError);
+            i4Status = (int32_t)OCP_TL_ERROR;
+        }
+        AppTL_ReleaseDatagram(PpsTL, &sDatagram);
+    }while(FALSE);
+    return i4Status;
+}
+
+/**
+ * This API queues an inbound datagram by reference.
+ * The datagram must stay valid till it is given back with the release callback, or till the record layer is done
+ * with it if no release callback is set.
+ * Datagrams are fed from one context at a time, which must stop feeding before the transport layer is disconnected.
+ *
+ * \param[in]      PpsTL               Pointer to the transport layer communication structure
+ * \param[in]      PprgbData           Pointer to the datagram
+ * \param[in]      PwLen               Length of the datagram
+ *
+ * \return  #OCP_TL_OK on successful execution
+ * \return  #OCP_TL_NULL_PARAM on parameter received is NULL
+ * \return  #OCP_TL_NO_DATA on zero length datagram
+ * \return  #OCP_TL_QUEUE_FULL if #OCP_TL_MAX_FED_DATAGRAMS datagrams are queued, the datagram is not taken
+ * \return  #OCP_TL_ERROR if the transport layer is not connected
+ */
+int32_t AppTL_Feed(const sTL_d* PpsTL,const uint8_t* PprgbData,uint16_t PwLen)
+{
+    int32_t i4Status = (int32_t)OCP_TL_ERROR;
+    uint8_t bWrite;
+    uint8_t bNext;
+    do
+    {
+        //NULL check
+        if((NULL == PpsTL) || (NULL == PpsTL->phTLHdl) || (NULL == PprgbData))
+        {
+            i4Status = (int32_t)OCP_TL_NULL_PARAM;
+            break;
+        }
+        if(0 == PwLen)
+        {
+            i4Status = (int32_t)OCP_TL_NO_DATA;
+            break;
+        }
+        if(eConnected != PpsTL->eIsConnected)
+        {
+            break;
+        }
+
+        bWrite = PS_TL_HANDLE->bWrite;
+        bNext = (uint8_t)((bWrite + 1) % TL_FED_SLOTS);
+        if(bNext == TL_LOAD_ACQUIRE(PS_TL_HANDLE->bRead))
+        {
+            i4Status = (int32_t)OCP_TL_QUEUE_FULL;
+            break;
+        }
+        PS_TL_HANDLE->rgsFed[bWrite].prgbData = PprgbData;
+        PS_TL_HANDLE->rgsFed[bWrite].wLen = PwLen;
+        //The slot is complete before the receiving context sees it
+        TL_STORE_RELEASE(PS_TL_HANDLE->bWrite, bNext);
+        i4Status = (int32_t)OCP_TL_OK;
+    }while(FALSE);
+    return i4Status;
+}
+
+/**
+ * This API gives the queued datagrams back to the application and releases all the resources.
+ * The application must have stopped feeding datagrams, see #AppTL_Feed.
+ *
+ * \param[in,out]  PpsTL     Pointer to the transport layer communication structure
+ *
+ * \return  None
+ */
+Void AppTL_Disconnect(sTL_d* PpsTL)
+{
+    uint8_t bRead;
+
+    //NULL check
+    if((NULL != PpsTL) && (NULL != PpsTL->phTLHdl))
+    {
+        LOG_TRANSPORTMSG("Closing application transport",eInfo);
+
+        PpsTL->eIsConnected = eDisconnected;
+        bRead = PS_TL_HANDLE->bRead;
+        while(bRead != TL_LOAD_ACQUIRE(PS_TL_HANDLE->bWrite))
+        {
+            if(NULL != PS_APP_TRANSPORT->pfRelease)
+            {
+                PS_APP_TRANSPORT->pfRelease(PS_APP_TRANSPORT->pCtx, PS_TL_HANDLE->rgsFed[bRead].prgbData);
+            }
+            bRead = (uint8_t)((bRead + 1) % TL_FED_SLOTS);
+        }
+
+        OCP_FREE(PpsTL->phTLHdl);
+        PpsTL->phTLHdl = NULL;
+    }
+}
+
+/// @cond hidden
+#undef PS_TL_HANDLE
+#undef PS_APP_TRANSPORT
+#undef TL_FED_SLOTS
+/// @endcond
+/**
+* @}
+*/
+#endif /*MODULE_ENABLE_DTLS_MUTUAL_AUTH*/
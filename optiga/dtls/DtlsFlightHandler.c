@@ -81,6 +81,40 @@
 #define UPDATE_RX_MSGSEQNUM(X,Y)        (X=Y)
 #define OCP_FLIGHT_TABLE_MAX_SIZE       3
 #define UPDATE_MSGSTATE(X,Y)            (X=Y)
+
+#ifndef DISABLE_COOKIE_CACHE
+#ifndef OCP_FL_COOKIE_CACHE_ENTRIES
+///Number of servers for which the last HelloVerifyRequest is cached
+#define OCP_FL_COOKIE_CACHE_ENTRIES     (2)
+#endif
+
+///Maximum length of a cached HelloVerifyRequest, server version(2) + cookie length(1) + cookie(255)
+#define COOKIE_CACHE_MSG_SIZE           (258)
+
+///Maximum length of an IP address string including the terminator
+#define COOKIE_CACHE_IP_LENGTH          (46)
+
+///HelloVerifyRequest of a server, kept to send the cookie in the first ClientHello of the next handshake
+typedef struct sCookieCache_d
+{
+    ///IP address of the server
+    char_t rgzIpAddress[COOKIE_CACHE_IP_LENGTH];
+    ///Port of the server, 0 if the entry is free
+    uint16_t wPort;
+    ///Message sequence number of the HelloVerifyRequest
+    uint16_t wMsgSequence;
+    ///Length of the HelloVerifyRequest without header
+    uint16_t wMsgLength;
+    ///HelloVerifyRequest without header
+    uint8_t rgbMsg[COOKIE_CACHE_MSG_SIZE];
+}sCookieCache_d;
+
+///Cached HelloVerifyRequests
+static sCookieCache_d rgsCookieCache[OCP_FL_COOKIE_CACHE_ENTRIES];
+
+///Entry to be replaced if the cache is full
+static uint8_t bCookieCacheNext = 0;
+#endif
 /// @endcond
 
 ///Maximum number of retransmission of a flight in a session during the handshake protocol
@@ -206,6 +240,18 @@ _STATIC_H int32_t DtlsHS_SendFlightToOptiga(sMsgInfo_d *PpsMessageList, const sM
  */
 _STATIC_H void DtlsHS_ResetFlight2MsgNode(const sFlightStats_d* PpsThisFlight);
 
+#ifndef DISABLE_COOKIE_CACHE
+/**
+ * \brief Finds the cached HelloVerifyRequest of the server.<br>
+ */
+_STATIC_H sCookieCache_d* DtlsHS_CookieCacheFind(const sMsgLyr_d* PpsMessageLayer, bool_t PfAllocate);
+
+/**
+ * \brief Caches the HelloVerifyRequest processed by the Security Chip.<br>
+ */
+_STATIC_H void DtlsHS_CookieCacheStore(const sMsgInfo_d* PpsMsgNode, const sMsgLyr_d* PpsMessageLayer);
+#endif
+
 /**
  * \brief Checks if message sequence number of received message/ fragment of flight4 is correct.<br>
  */
@@ -1837,6 +1883,55 @@ int32_t DtlsHS_MsgCheck(uint8_t PbLastProcFlight, const sbBlob_d* PpsBlobMessage
     return i4Status;
 }
 
+/**
+ * Gets the messages of flight 1 from the Security Chip without sending them.<br>
+ * The flight stays ready and #DtlsHS_Flight1Handler sends the messages got here.
+ * As the messages do not depend on the transport, this can be done before the transport is connected.<br>
+ *
+ * \param[in,out]	PpsThisFlight		      Pointer to structure containing flight1 status.
+ * \param[in]       PpsMessageLayer           Pointer to the structure containing message configuration information.
+ *
+ * \retval		#OCP_FL_OK  			            Successful execution
+ * \retval		#OCP_FL_ERROR    	                Flight is not ready
+ * \retval		#OCP_FL_GET_MSG_FROM_OPTIGA_ERROR    Error from Security Chip
+ */
+int32_t DtlsHS_Flight1Prepare(sFlightStats_d* PpsThisFlight, const sMsgLyr_d* PpsMessageLayer)
+{
+    int32_t i4Status = (int32_t)OCP_FL_ERROR;
+    sMsgInfo_d* psMsgListTrav = NULL;
+
+    do
+    {
+        if((uint8_t)efReady != PpsThisFlight->bFlightState)
+        {
+            break;
+        }
+
+        i4Status = (int32_t)OCP_FL_OK;
+        psMsgListTrav = PpsThisFlight->psMessageList;
+        while(NULL != psMsgListTrav)
+        {
+            if(ePartial == psMsgListTrav->eMsgState)
+            {
+                i4Status = DtlsHS_SInit_MessageNode(psMsgListTrav, PpsMessageLayer);
+                if((i4Status & (int32_t)DEV_ERROR_CODE_MASK) == (int32_t)CMD_DEV_ERROR)
+                {
+                    break;
+                }
+                else if((int32_t)OCP_FL_OK != i4Status)
+                {
+                    i4Status = (int32_t)OCP_FL_GET_MSG_FROM_OPTIGA_ERROR;
+                    break;
+                }
+                psMsgListTrav->eMsgState = eComplete;
+            }
+            psMsgListTrav = psMsgListTrav->psNext;
+        }
+    }while(0);
+
+    return i4Status;
+}
+
 /**
  * Flight one handler to process flight 1 messages .<br>
  *
@@ -1893,25 +1988,16 @@ int32_t DtlsHS_Flight1Handler(uint8_t PbLastProcFlight, sFlightStats_d* PpsThisF
             
             if((uint8_t)efReady == PpsThisFlight->bFlightState)
             {
-                //Get Message from Security Chip and Send to Server
+                //Get Message from Security Chip, unless prepared before connecting, and Send to Server
+                i4Status = DtlsHS_Flight1Prepare(PpsThisFlight, PpsMessageLayer);
+                if((int32_t)OCP_FL_OK != i4Status)
+                {
+                    break;
+                }
                 psMsgListTrav = PpsThisFlight->psMessageList;
 
                 while(NULL != psMsgListTrav)
                 {
-                    if(ePartial == psMsgListTrav->eMsgState)
-                    {
-                        i4Status = DtlsHS_SInit_MessageNode(psMsgListTrav, PpsMessageLayer);
-						if((i4Status & (int32_t)DEV_ERROR_CODE_MASK) == (int32_t)CMD_DEV_ERROR)
-						{
-							break;
-						}
-						else if((int32_t)OCP_FL_OK != i4Status)
-						{
-							i4Status = (int32_t)OCP_FL_GET_MSG_FROM_OPTIGA_ERROR;
-							break;
-						}
-                        psMsgListTrav->eMsgState = eComplete;
-                    }
                     if(OCP_HL_OK != DtlsHS_FSendMessage(psMsgListTrav, PpsMessageLayer))
                     {
                         i4Status = (int32_t)OCP_FL_FLIGHTSEND_ERROR;
@@ -2373,6 +2459,9 @@ int32_t DtlsHS_Flight2Handler(uint8_t PbLastProcFlight, sFlightStats_d* PpsThisF
             }
             //Update Flight Status
             PpsThisFlight->bFlightState = (uint8_t)efProcessed;
+#ifndef DISABLE_COOKIE_CACHE
+            DtlsHS_CookieCacheStore(PpsThisFlight->psMessageList, PpsMessageLayer);
+#endif
             DtlsHS_ResetFlight2MsgNode(PpsThisFlight);
             DtlsHS_FlightGetLastMsgSeqNum(PpsThisFlight->psMessageList, &wFlightLastMsgSeqNum);
             UPDATE_RX_MSGSEQNUM(PpsMessageLayer->dwRMsgSeqNum, wFlightLastMsgSeqNum);
@@ -2383,6 +2472,192 @@ int32_t DtlsHS_Flight2Handler(uint8_t PbLastProcFlight, sFlightStats_d* PpsThisF
     return i4Status;
 }
 
+#ifndef DISABLE_COOKIE_CACHE
+/**
+ * Finds the cached HelloVerifyRequest of the server the transport layer is configured for.<br>
+ * Servers are identified by IP address and port. Nothing is cached for a transport of the application, nor if
+ * alternative endpoints are configured, as the cookie is bound to the endpoint winning the race on connect.<br>
+ *
+ * \param[in]       PpsMessageLayer           Pointer to the structure containing message configuration information.
+ * \param[in]       PfAllocate                TRUE to return a new entry if the server is not cached
+ *
+ * \retval		Pointer to the entry
+ * \retval		NULL if the server is not cached or cannot be identified
+ */
+_STATIC_H sCookieCache_d* DtlsHS_CookieCacheFind(const sMsgLyr_d* PpsMessageLayer, bool_t PfAllocate)
+{
+    sCookieCache_d* psEntry = NULL;
+    const sTL_d* psTL;
+    uint8_t bIndex;
+
+    do
+    {
+        if((NULL == PpsMessageLayer->psConfigRL) || (NULL == PpsMessageLayer->psConfigRL->sRL.psConfigTL))
+        {
+            break;
+        }
+        psTL = &PpsMessageLayer->psConfigRL->sRL.psConfigTL->sTL;
+        if((NULL != psTL->psAppTransport) || (NULL == psTL->pzIpAddress) || (0 == psTL->wPort) ||
+           (COOKIE_CACHE_IP_LENGTH <= strlen(psTL->pzIpAddress)) ||
+           ((NULL != psTL->psAltEndpoints) && (0 != psTL->bAltEndpointCount)))
+        {
+            break;
+        }
+
+        for(bIndex = 0; bIndex < OCP_FL_COOKIE_CACHE_ENTRIES; bIndex++)
+        {
+            if((psTL->wPort == rgsCookieCache[bIndex].wPort) && (0 == strcmp(psTL->pzIpAddress, rgsCookieCache[bIndex].rgzIpAddress)))
+            {
+                psEntry = &rgsCookieCache[bIndex];
+                break;
+            }
+        }
+        if((NULL != psEntry) || (FALSE == PfAllocate))
+        {
+            break;
+        }
+
+        //Take a free entry, else the entries are replaced in turn
+        for(bIndex = 0; bIndex < OCP_FL_COOKIE_CACHE_ENTRIES; bIndex++)
+        {
+            if(0 == rgsCookieCache[bIndex].wPort)
+            {
+                psEntry = &rgsCookieCache[bIndex];
+                break;
+            }
+        }
+        if(NULL == psEntry)
+        {
+            psEntry = &rgsCookieCache[bCookieCacheNext];
+            bCookieCacheNext = (uint8_t)((bCookieCacheNext + 1) % OCP_FL_COOKIE_CACHE_ENTRIES);
+        }
+        strcpy(psEntry->rgzIpAddress, psTL->pzIpAddress);
+        psEntry->wPort = psTL->wPort;
+        psEntry->wMsgLength = 0;
+    }while(0);
+
+    return psEntry;
+}
+
+/**
+ * Caches the HelloVerifyRequest processed by the Security Chip for the server.<br>
+ * A HelloVerifyRequest too long to be cached removes the cached one.<br>
+ *
+ * \param[in]       PpsMsgNode                Pointer to the HelloVerifyRequest message node.
+ * \param[in]       PpsMessageLayer           Pointer to the structure containing message configuration information.
+ */
+_STATIC_H void DtlsHS_CookieCacheStore(const sMsgInfo_d* PpsMsgNode, const sMsgLyr_d* PpsMessageLayer)
+{
+    sCookieCache_d* psEntry;
+
+    do
+    {
+        if((NULL == PpsMsgNode) || (NULL == PpsMsgNode->psMsgHolder) || ((uint8_t)eHelloVerifyRequest != PpsMsgNode->bMsgType))
+        {
+            break;
+        }
+
+        psEntry = DtlsHS_CookieCacheFind(PpsMessageLayer, TRUE);
+        if(NULL == psEntry)
+        {
+            break;
+        }
+        if(COOKIE_CACHE_MSG_SIZE < PpsMsgNode->dwMsgLength)
+        {
+            psEntry->wPort = 0;
+            break;
+        }
+
+        memcpy(psEntry->rgbMsg, PpsMsgNode->psMsgHolder + OVERHEAD_LEN, PpsMsgNode->dwMsgLength);
+        psEntry->wMsgLength = (uint16_t)PpsMsgNode->dwMsgLength;
+        psEntry->wMsgSequence = PpsMsgNode->wMsgSequence;
+    }while(0);
+}
+#endif
+
+/**
+ * Passes the HelloVerifyRequest cached for the server to the Security Chip as if flight 2 was received.<br>
+ * The ClientHello must have been got from the Security Chip before. Flight 3 then carries the cached cookie,
+ * which saves the round trip of flight 1 and 2. If the server rejects the cookie, it sends a new HelloVerifyRequest
+ * and flight 3 is sent again with the new cookie.<br>
+ *
+ * \param[in,out]   PpsMessageLayer           Pointer to the structure containing message configuration information.
+ *
+ * \retval		#OCP_FL_OK  			            Cached HelloVerifyRequest processed, dwRMsgSeqNum of PpsMessageLayer is its sequence number
+ * \retval		#OCP_FL_NOT_LISTED                  No HelloVerifyRequest cached for the server
+ * \retval		#OCP_FL_MALLOC_FAILURE    	        Memory allocation failure
+ * \retval		#OCP_FL_SEND_MSG_TO_OPTIGA_ERROR     Error from Security Chip
+ */
+int32_t DtlsHS_Flight2Replay(sMsgLyr_d* PpsMessageLayer)
+{
+    int32_t i4Status = (int32_t)OCP_FL_NOT_LISTED;
+#ifndef DISABLE_COOKIE_CACHE
+    sCookieCache_d* psEntry;
+    sMsgInfo_d sMsgNode;
+
+    do
+    {
+        psEntry = DtlsHS_CookieCacheFind(PpsMessageLayer, FALSE);
+        if((NULL == psEntry) || (0 == psEntry->wMsgLength))
+        {
+            break;
+        }
+
+        sMsgNode.bMsgType = (uint8_t)eHelloVerifyRequest;
+        sMsgNode.wMsgSequence = psEntry->wMsgSequence;
+        sMsgNode.dwMsgLength = psEntry->wMsgLength;
+        sMsgNode.psMsgMapPtr = NULL;
+        sMsgNode.eMsgState = eComplete;
+        sMsgNode.bMsgCount = 0;
+        sMsgNode.psNext = NULL;
+        sMsgNode.psMsgHolder = (uint8_t*)OCP_MALLOC(psEntry->wMsgLength + OVERHEAD_LEN);
+        if(NULL == sMsgNode.psMsgHolder)
+        {
+            i4Status = (int32_t)OCP_FL_MALLOC_FAILURE;
+            break;
+        }
+        memcpy(sMsgNode.psMsgHolder + OVERHEAD_LEN, psEntry->rgbMsg, psEntry->wMsgLength);
+        //lint --e{534} suppress "Return value is not required to be checked"
+        DtlsHS_PrepareMsgHeader((sMsgNode.psMsgHolder + (OVERHEAD_LEN - MSG_HEADER_LEN)), &sMsgNode);
+
+        i4Status = DtlsHS_SendFlightToOptiga(&sMsgNode, PpsMessageLayer);
+        OCP_FREE(sMsgNode.psMsgHolder);
+        if(OCP_ML_OK != i4Status)
+        {
+            //Not used again
+            psEntry->wPort = 0;
+            break;
+        }
+
+        PpsMessageLayer->eFlight = eFlight2;
+        UPDATE_RX_MSGSEQNUM(PpsMessageLayer->dwRMsgSeqNum, psEntry->wMsgSequence);
+        i4Status = (int32_t)OCP_FL_OK;
+    }while(0);
+#else
+    (void)PpsMessageLayer;
+#endif
+    return i4Status;
+}
+
+/**
+ * Removes the HelloVerifyRequest cached for the server, e.g. if the handshake with the cached cookie failed.<br>
+ *
+ * \param[in]       PpsMessageLayer           Pointer to the structure containing message configuration information.
+ */
+void DtlsHS_Flight2Forget(const sMsgLyr_d* PpsMessageLayer)
+{
+#ifndef DISABLE_COOKIE_CACHE
+    sCookieCache_d* psEntry = DtlsHS_CookieCacheFind(PpsMessageLayer, FALSE);
+
+    if(NULL != psEntry)
+    {
+        psEntry->wPort = 0;
+    }
+#else
+    (void)PpsMessageLayer;
+#endif
+}
+
 /**
  * Checks if message sequence number of received message/ fragment of flight4 is correct.<br>
  *
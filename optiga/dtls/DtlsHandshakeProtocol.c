@@ -35,6 +35,7 @@
 #include "optiga/optiga_dtls.h"
 #include "optiga/dtls/DtlsRecordLayer.h"
 #include "optiga/dtls/DtlsFlightHandler.h"
+#include "optiga/dtls/DtlsProfiler.h"
 
 #ifdef MODULE_ENABLE_DTLS_MUTUAL_AUTH
 
@@ -184,6 +185,16 @@ _STATIC_H void DtlsHS_CreateFlightList(sFlightDetails_d** PppsFlightHead, sFligh
  */
 _STATIC_H int32_t DtlsHS_CreateFlightNode(uint8_t PbLastProcFlight, sFlightDetails_d** PppsFlightHead, sMsgLyr_d* PpsMessageLayer);
 
+/**
+ * \brief Initialises the message layer information from the handshake data.<br>
+ */
+_STATIC_H void DtlsHS_InitMessageLayer(const sHandshake_d* PphHandshake, sMsgLyr_d* PpsMessageLayer);
+
+/**
+ * \brief Passes the HelloVerifyRequest cached for the server to the security chip after the first flight is prepared.<br>
+ */
+_STATIC_H void DtlsHS_ReplayHelloVerify(sHandshake_d* PphHandshake, sMsgLyr_d* PpsMessageLayer);
+
 /**
  * Fragments a handshake message into smaller fragments.<br>
  * Returns a fragment of the handshake message.
@@ -1314,6 +1325,127 @@ int32_t DtlsHS_VerifyHR(const uint8_t* PprgbData, uint16_t PwLen)
     return i4Status;
 }
 
+/**
+ * Initialises the message layer information from the handshake data.<br>
+ * The buffer for the messages from the transport layer is not allocated.<br>
+ *
+ * \param[in]		PphHandshake			    Pointer to structure containing data to perform handshake
+ * \param[in,out]	PpsMessageLayer			    Pointer to message information
+ */
+_STATIC_H void DtlsHS_InitMessageLayer(const sHandshake_d* PphHandshake, sMsgLyr_d* PpsMessageLayer)
+{
+    uint8_t bIndex;
+
+    PpsMessageLayer->psConfigRL = PphHandshake->psConfigRL;
+    PpsMessageLayer->wSessionID = PphHandshake->wSessionOID;
+    PpsMessageLayer->wMaxPmtu = PphHandshake->wMaxPmtu;
+    PpsMessageLayer->wOIDDevCertificate = PphHandshake->wOIDDevCertificate;
+    PpsMessageLayer->pfGetUnixTIme = PphHandshake->pfGetUnixTIme;
+    PpsMessageLayer->eFlight = eFlight0;
+    PpsMessageLayer->dwRMsgSeqNum = 0xFFFFFFFF;
+    PpsMessageLayer->sTLMsg.prgbStream = NULL;
+    PpsMessageLayer->sTLMsg.wLen = 0;
+
+    for(bIndex = 0; bIndex < (sizeof(PpsMessageLayer->rgbOptMsgList)/sizeof(PpsMessageLayer->rgbOptMsgList[0])); bIndex++)
+    {
+        PpsMessageLayer->rgbOptMsgList[bIndex] = 0xFF;
+    }
+}
+
+/**
+ * Passes the HelloVerifyRequest cached for the server to the security chip after the ClientHello is got from it.<br>
+ * #DtlsHS_Handshake then continues after flight 2, so the ClientHello with the cookie in flight 3 is the first
+ * flight sent.<br>
+ * If nothing is cached or the security chip rejects the cached HelloVerifyRequest, which also removes it from the
+ * cache, the prepared ClientHello is sent in flight 1.<br>
+ *
+ * \param[in,out]	PphHandshake			        Pointer to structure containing data to perform handshake
+ * \param[in,out]	PpsMessageLayer			        Pointer to message information
+ */
+_STATIC_H void DtlsHS_ReplayHelloVerify(sHandshake_d* PphHandshake, sMsgLyr_d* PpsMessageLayer)
+{
+    if((int32_t)OCP_FL_OK == DtlsHS_Flight2Replay(PpsMessageLayer))
+    {
+        PphHandshake->dwReplayedMsgSeqNum = PpsMessageLayer->dwRMsgSeqNum;
+    }
+}
+
+/**
+ * Prepares the first flight of a DTLS handshake before the transport is connected.<br>
+ * The ClientHello is got from the security chip and kept with the handshake data. #DtlsHS_Handshake sends it
+ * without getting it again, so the security chip is not on the critical path once the transport is connected.<br>
+ * A HelloVerifyRequest cached for the server is passed to the security chip as well, see #DtlsHS_ReplayHelloVerify.<br>
+ * A prepared flight not sent must be released with #DtlsHS_ReleaseHandshake.<br>
+ * The authentication scheme must be set on the security chip before.<br>
+ *
+ * \param[in,out]	PphHandshake			    Pointer to structure containing data to perform handshake
+ *
+ * \retval 		#OCP_HL_OK		Successful Execution
+ * \retval 		#OCP_HL_ERROR	Failure Execution
+ */
+int32_t DtlsHS_PrepareHandshake(sHandshake_d* PphHandshake)
+{
+    sFlightDetails_d* pSFlightHead = NULL;
+    sMsgLyr_d sMessageLayer;
+    int32_t i4Status = (int32_t)OCP_HL_ERROR;
+
+    do
+    {
+        if(eClient != PphHandshake->eMode)
+        {
+            break;
+        }
+
+        //lint --e{534} suppress "The return value check is suppressed as this function always return Success"
+        DtlsHS_ReleaseHandshake(PphHandshake);
+        DtlsHS_InitMessageLayer(PphHandshake, &sMessageLayer);
+
+        i4Status = SEND_FLIGHT_INITIALIZE((uint8_t)eFlight0, &pSFlightHead, &sMessageLayer);
+        if((int32_t)OCP_HL_OK != i4Status)
+        {
+            break;
+        }
+        //Nothing to prepare
+        if(NULL == pSFlightHead)
+        {
+            break;
+        }
+
+        i4Status = DtlsHS_Flight1Prepare(&pSFlightHead->sFlightStats, &sMessageLayer);
+        if((int32_t)OCP_FL_OK != i4Status)
+        {
+            break;
+        }
+
+        //The cookie of the last handshake with the server saves the round trip of flight 1 and 2
+        DtlsHS_ReplayHelloVerify(PphHandshake, &sMessageLayer);
+
+        PphHandshake->phPreparedFlight = (hdl_t)pSFlightHead;
+        pSFlightHead = NULL;
+        i4Status = (int32_t)OCP_HL_OK;
+    }while(0);
+
+    DtlsHS_ClearBuffer(&pSFlightHead);
+    return i4Status;
+}
+
+/**
+ * Releases the first flight prepared with #DtlsHS_PrepareHandshake and not sent.<br>
+ *
+ * \param[in,out]	PphHandshake			    Pointer to structure containing data to perform handshake
+ *
+ * \retval 		#OCP_HL_OK		Successful Execution
+ */
+int32_t DtlsHS_ReleaseHandshake(sHandshake_d* PphHandshake)
+{
+    sFlightDetails_d* pSFlightHead = (sFlightDetails_d*)PphHandshake->phPreparedFlight;
+
+    DtlsHS_ClearBuffer(&pSFlightHead);
+    PphHandshake->phPreparedFlight = NULL;
+    PphHandshake->dwReplayedMsgSeqNum = 0xFFFFFFFF;
+    return (int32_t)OCP_HL_OK;
+}
+
 /**
  * Performs a DTLS handshake.<br>
  * The state machine is configurable as a client or as a server based on the selected protocol.Currently server configuration is not supported.<br>
@@ -1333,7 +1465,7 @@ int32_t DtlsHS_Handshake(sHandshake_d* PphHandshake)
     
     uint8_t bLastProcFlight=0; 
     uint8_t bSmMode = STATE_RECV;
-    uint8_t bIndex;
+    bool_t fCookieReplayed = FALSE;
     uint8_t bFlightTimeout = DEFAULT_TIMEOUT;
     sFlightDetails_d* pSFlightHead=NULL;
     sFlightDetails_d* pRFlightHead=NULL;
@@ -1350,26 +1482,31 @@ int32_t DtlsHS_Handshake(sHandshake_d* PphHandshake)
     }
 	    
     //Populate structure to be passed to MessageLayer
-    sMessageLayer.psConfigRL = PphHandshake->psConfigRL;
-    sMessageLayer.wSessionID = PphHandshake->wSessionOID;
+    DtlsHS_InitMessageLayer(PphHandshake, &sMessageLayer);
     ((sRecordLayer_d*)PphHandshake->psConfigRL->sRL.phRLHdl)->wSessionKeyOID = PphHandshake->wSessionOID;
-    sMessageLayer.wMaxPmtu = PphHandshake->wMaxPmtu;
-    sMessageLayer.wOIDDevCertificate = PphHandshake->wOIDDevCertificate;
-    sMessageLayer.pfGetUnixTIme = PphHandshake->pfGetUnixTIme;
-    sMessageLayer.eFlight = eFlight0;
-    sMessageLayer.dwRMsgSeqNum = 0xFFFFFFFF;
     sMessageLayer.sTLMsg.prgbStream = (uint8_t*)OCP_MALLOC(TLBUFFER_SIZE);
     if(NULL == sMessageLayer.sTLMsg.prgbStream)
     {
         i4Status = (int32_t)OCP_LIB_MALLOC_FAILURE;
         bSmMode = STATE_EXIT;
     }
-    sMessageLayer.sTLMsg.wLen = (uint16_t)TLBUFFER_SIZE;
-
-    for(bIndex = 0; bIndex < (sizeof(sMessageLayer.rgbOptMsgList)/sizeof(sMessageLayer.rgbOptMsgList[0])); bIndex++)
+    else
     {
-        sMessageLayer.rgbOptMsgList[bIndex] = 0xFF;
+        //Continue with the first flight if prepared before the transport was connected
+        pSFlightHead = (sFlightDetails_d*)PphHandshake->phPreparedFlight;
+        PphHandshake->phPreparedFlight = NULL;
+
+        //Continue after flight 2 if the cached HelloVerifyRequest was passed to the security chip with it
+        if((NULL != pSFlightHead) && (0xFFFFFFFF != PphHandshake->dwReplayedMsgSeqNum))
+        {
+            bLastProcFlight = (uint8_t)eFlight2;
+            sMessageLayer.eFlight = eFlight2;
+            sMessageLayer.dwRMsgSeqNum = PphHandshake->dwReplayedMsgSeqNum;
+            fCookieReplayed = TRUE;
+        }
+        PphHandshake->dwReplayedMsgSeqNum = 0xFFFFFFFF;
     }
+    sMessageLayer.sTLMsg.wLen = (uint16_t)TLBUFFER_SIZE;
 
     //Start state machine
     do
@@ -1378,6 +1515,7 @@ int32_t DtlsHS_Handshake(sHandshake_d* PphHandshake)
         {
             case STATE_SEND:
             {
+                DTLS_PROFILE_BEGIN_PHASE(FALSE);
                 i4Status = SEND_FLIGHT_INITIALIZE(bLastProcFlight, &pSFlightHead, &sMessageLayer);
                 if((int32_t)OCP_HL_OK != i4Status)
                 {
@@ -1393,6 +1531,7 @@ int32_t DtlsHS_Handshake(sHandshake_d* PphHandshake)
                 }
                 
                 i4Status = SEND_FLIGHT_PROCESS(&bLastProcFlight, pSFlightHead, &sMessageLayer);
+                DTLS_PROFILE_END_PHASE(bLastProcFlight, FALSE);
                 if(OCP_HL_OK == i4Status)
                 {
                     if(PphHandshake->eAuthState == eAuthInitialised)
@@ -1416,6 +1555,7 @@ int32_t DtlsHS_Handshake(sHandshake_d* PphHandshake)
             }
             case STATE_RECV:
             {
+                DTLS_PROFILE_BEGIN_PHASE(TRUE);
                 i4Status = REC_FLIGHT_INITIALIZE(bLastProcFlight, &pRFlightHead, &sMessageLayer);
                 if((int32_t)OCP_HL_OK != i4Status)
                 {
@@ -1428,6 +1568,9 @@ int32_t DtlsHS_Handshake(sHandshake_d* PphHandshake)
                 }
 
                 i4Status = REC_FLIGHT_PROCESS(&bLastProcFlight, &pRFlightHead, &sMessageLayer, bFlightTimeout);
+                //A flight not received is reported as the flight expected
+                DTLS_PROFILE_END_PHASE((OCP_HL_OK == i4Status) ? bLastProcFlight : (uint8_t)(bLastProcFlight + 1),
+                                       ((int32_t)OCP_HL_TIMEOUT == i4Status) ? TRUE : FALSE);
                 
                 if ((int32_t)OCP_HL_TIMEOUT == i4Status)
                 {
@@ -1495,6 +1638,12 @@ int32_t DtlsHS_Handshake(sHandshake_d* PphHandshake)
     #undef STATE_EXIT
 /// @endcond
 
+    //The next handshake with the server starts without cookie
+    if((TRUE == fCookieReplayed) && ((int32_t)OCP_HL_OK != i4Status))
+    {
+        DtlsHS_Flight2Forget(&sMessageLayer);
+    }
+
     if(sMessageLayer.sTLMsg.prgbStream != NULL)
     {
         OCP_FREE(sMessageLayer.sTLMsg.prgbStream);
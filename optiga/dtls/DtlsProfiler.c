@@ -0,0 +1,278 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+*
+*
+ * \file DtlsProfiler.c
+ *
+ * \brief This file implements the DTLS handshake profiler. The handshake layer marks the flight boundaries,
+ *        the message, crypto and record layers time the chip calls and the datagrams sent and received.
+ *        Only one handshake is recorded at a time, OCP_Connect() blocks until the handshake is over.
+ *
+ * \ingroup grMutualAuth
+ * @{ 
+ *
+ */
+
+#include "optiga/dtls/DtlsProfiler.h"
+#include "optiga/common/MemoryMgmt.h"
+#include "optiga/pal/pal_os_timer.h"
+
+#if defined(MODULE_ENABLE_DTLS_MUTUAL_AUTH) && defined(ENABLE_HANDSHAKE_PROFILER)
+
+/// @cond hidden
+///Number of timed operations
+#define PROFILE_EVENTS              (eProfileRecv + 1)
+
+///Profile being recorded, NULL if no handshake is in progress
+static sHandshakeProfile_d* psActiveProfile = NULL;
+
+///Phase in progress, copied into the profile when it ends
+static sProfilePhase_d sActivePhase;
+
+///Start of OCP_Connect()
+static uint32_t dwProfileStart;
+
+///Start of the operation in progress, per timed operation
+static uint32_t rgdwEventStart[PROFILE_EVENTS];
+
+///TRUE if a phase is in progress
+static bool_t fPhaseOpen;
+
+///TRUE if the first phase is started
+static bool_t fSetupDone;
+
+///TRUE if the last phase timed out, the next flight sent is a retransmission
+static bool_t fLastTimeout;
+
+//Milliseconds since the start of OCP_Connect()
+_STATIC_H uint32_t DtlsProf_Now(Void)
+{
+    return (uint32_t)(pal_os_timer_get_time_in_milliseconds() - dwProfileStart);
+}
+
+//Total minus the measured times, 0 if the millisecond rounding makes them exceed the total
+_STATIC_H uint32_t DtlsProf_Remaining(uint32_t PdwTotal, uint32_t PdwMeasured)
+{
+    return (PdwTotal > PdwMeasured) ? (PdwTotal - PdwMeasured) : 0;
+}
+/// @endcond
+
+/**
+ * Starts recording into the profile. The profile is cleared.<br>
+ *
+ * \param[in,out] PpsProfile    Pointer to the profile, NULL to record nothing
+ */
+Void DtlsProf_Start(sHandshakeProfile_d* PpsProfile)
+{
+    psActiveProfile = PpsProfile;
+    if(NULL != psActiveProfile)
+    {
+        OCP_MEMSET(psActiveProfile, 0, sizeof(sHandshakeProfile_d));
+        dwProfileStart = pal_os_timer_get_time_in_milliseconds();
+        fPhaseOpen = FALSE;
+        fSetupDone = FALSE;
+        fLastTimeout = FALSE;
+    }
+}
+
+/**
+ * Stops recording. A phase still in progress is ended and the totals of the profile are completed.<br>
+ *
+ * \param[in] Pi4Status     Status of OCP_Connect()
+ */
+Void DtlsProf_Stop(int32_t Pi4Status)
+{
+    if(NULL != psActiveProfile)
+    {
+        if(TRUE == fPhaseOpen)
+        {
+            DtlsProf_EndPhase(0, FALSE);
+        }
+        psActiveProfile->i4Status = Pi4Status;
+        psActiveProfile->dwTotal = DtlsProf_Now();
+        if(FALSE == fSetupDone)
+        {
+            psActiveProfile->dwSetup = psActiveProfile->dwTotal;
+        }
+        psActiveProfile->dwHost = DtlsProf_Remaining(psActiveProfile->dwTotal,
+                                  psActiveProfile->dwChip + psActiveProfile->dwSend +
+                                  psActiveProfile->dwRecv + psActiveProfile->dwTimeout);
+        psActiveProfile = NULL;
+    }
+}
+
+/**
+ * Starts a phase. A flight sent after a timeout is counted as retransmission.<br>
+ *
+ * \param[in] PfReceive     TRUE if a flight is received, FALSE if a flight is sent
+ */
+Void DtlsProf_BeginPhase(bool_t PfReceive)
+{
+    if(NULL != psActiveProfile)
+    {
+        if(FALSE == fSetupDone)
+        {
+            psActiveProfile->dwSetup = DtlsProf_Now();
+            fSetupDone = TRUE;
+        }
+        OCP_MEMSET(&sActivePhase, 0, sizeof(sActivePhase));
+        sActivePhase.fReceive = PfReceive;
+        if((FALSE == PfReceive) && (TRUE == fLastTimeout))
+        {
+            sActivePhase.fRetransmission = TRUE;
+            psActiveProfile->bRetransmissions++;
+        }
+        sActivePhase.dwStart = DtlsProf_Now();
+        fPhaseOpen = TRUE;
+    }
+}
+
+/**
+ * Ends the phase in progress. The time waited for a flight which timed out is counted as timeout time.<br>
+ *
+ * \param[in] PbFlight      Flight sent or received, the flight expected if it timed out
+ * \param[in] PfTimeout     TRUE if the flight was not received before the retransmission timeout
+ */
+Void DtlsProf_EndPhase(uint8_t PbFlight, bool_t PfTimeout)
+{
+    if((NULL != psActiveProfile) && (TRUE == fPhaseOpen))
+    {
+        sActivePhase.bFlight = PbFlight;
+        sActivePhase.fTimeout = PfTimeout;
+        sActivePhase.dwTotal = DtlsProf_Now() - sActivePhase.dwStart;
+        sActivePhase.dwHost = DtlsProf_Remaining(sActivePhase.dwTotal,
+                              sActivePhase.dwChip + sActivePhase.dwSend + sActivePhase.dwRecv);
+        if(TRUE == PfTimeout)
+        {
+            psActiveProfile->dwTimeout += sActivePhase.dwRecv;
+        }
+        else
+        {
+            psActiveProfile->dwRecv += sActivePhase.dwRecv;
+        }
+        fLastTimeout = PfTimeout;
+
+        if(psActiveProfile->bPhaseCount < DTLS_PROFILE_MAX_PHASES)
+        {
+            psActiveProfile->rgsPhase[psActiveProfile->bPhaseCount] = sActivePhase;
+            psActiveProfile->bPhaseCount++;
+        }
+        else
+        {
+            psActiveProfile->bDropped++;
+        }
+        fPhaseOpen = FALSE;
+    }
+}
+
+/**
+ * Starts timing an operation. Operations of the same kind do not nest.<br>
+ *
+ * \param[in] PeEvent       Operation
+ */
+Void DtlsProf_Begin(eProfileEvent_d PeEvent)
+{
+    if(NULL != psActiveProfile)
+    {
+        rgdwEventStart[PeEvent] = pal_os_timer_get_time_in_milliseconds();
+    }
+}
+
+/**
+ * Ends timing an operation and adds the time to the phase in progress and to the profile.<br>
+ * A chip call is also recorded on its own.<br>
+ *
+ * \param[in] PeEvent       Operation
+ * \param[in] PbOperation   Chip call from eProfileOperation_d, ignored for datagrams
+ * \param[in] PbMsgType     Handshake message type of the chip call, ignored for datagrams
+ * \param[in] PwLen         Length of the message, record or datagram. 0 if no datagram was received.
+ */
+Void DtlsProf_End(eProfileEvent_d PeEvent, uint8_t PbOperation, uint8_t PbMsgType, uint16_t PwLen)
+{
+    uint32_t dwTime;
+    sProfileMessage_d* psMessage;
+
+    if(NULL != psActiveProfile)
+    {
+        dwTime = (uint32_t)(pal_os_timer_get_time_in_milliseconds() - rgdwEventStart[PeEvent]);
+        switch(PeEvent)
+        {
+            case eProfileChip:
+            {
+                psActiveProfile->dwChip += dwTime;
+                sActivePhase.dwChip += dwTime;
+                if(psActiveProfile->bMessageCount < DTLS_PROFILE_MAX_MESSAGES)
+                {
+                    psMessage = &psActiveProfile->rgsMessage[psActiveProfile->bMessageCount];
+                    psMessage->bPhase = (TRUE == fPhaseOpen) ? psActiveProfile->bPhaseCount : (uint8_t)DTLS_PROFILE_NO_PHASE;
+                    psMessage->bOperation = PbOperation;
+                    psMessage->bMsgType = PbMsgType;
+                    psMessage->wLen = PwLen;
+                    psMessage->dwStart = (uint32_t)(rgdwEventStart[PeEvent] - dwProfileStart);
+                    psMessage->dwTime = dwTime;
+                    psActiveProfile->bMessageCount++;
+                }
+                else
+                {
+                    psActiveProfile->bDropped++;
+                }
+            }
+            break;
+            case eProfileSend:
+            {
+                psActiveProfile->dwSend += dwTime;
+                sActivePhase.dwSend += dwTime;
+                sActivePhase.bDatagramsSent++;
+            }
+            break;
+            case eProfileRecv:
+            {
+                //Waits outside a phase are not expected, they count as received
+                if(FALSE == fPhaseOpen)
+                {
+                    psActiveProfile->dwRecv += dwTime;
+                    break;
+                }
+                sActivePhase.dwRecv += dwTime;
+                if(0 != PwLen)
+                {
+                    sActivePhase.bDatagramsReceived++;
+                }
+            }
+            break;
+            default:
+            break;
+        }
+    }
+}
+
+/// @cond hidden
+#undef PROFILE_EVENTS
+/// @endcond
+
+/**
+* @}
+*/
+#endif /* MODULE_ENABLE_DTLS_MUTUAL_AUTH && ENABLE_HANDSHAKE_PROFILER */
@@ -33,6 +33,7 @@
  
 #include "optiga/common/Util.h"
 #include "optiga/dtls/DtlsRecordLayer.h"
+#include "optiga/dtls/DtlsProfiler.h"
 
 #ifdef MODULE_ENABLE_DTLS_MUTUAL_AUTH
 
@@ -78,9 +79,24 @@ _STATIC_H int32_t DtlsRL_Record_PrepareRecord(sRecordLayer_d* PpsRecordLayer,con
 _STATIC_H int32_t DtlsRL_CallBack_ValidateRec(const Void* PpvParams);    
 
 /**
- * \brief Gets the count of the total number of record in the buffer
+ * \brief Gets the count of the total number of record in the received datagram
  */
-_STATIC_H int32_t DtlsRL_GetRecordCount(uint8_t* PpbBuffer,uint16_t PwLen,uint8_t* PpbRecCount);
+_STATIC_H int32_t DtlsRL_GetRecordCount(const sDatagram_d* PpsDatagram,uint8_t* PpbRecCount);
+
+/**
+ * \brief Copies bytes of the received datagram, which may span several segments
+ */
+_STATIC_H Void DtlsRL_Datagram_Copy(const sDatagram_d* PpsDatagram,uint16_t PwOffset,uint8_t* PpbDest,uint16_t PwLen);
+
+/**
+ * \brief Returns the bytes of the received datagram if they are in one segment
+ */
+_STATIC_H uint8_t* DtlsRL_Datagram_Locate(const sDatagram_d* PpsDatagram,uint16_t PwOffset,uint16_t PwLen);
+
+/**
+ * \brief Gives the received datagram back to the transport layer
+ */
+_STATIC_H Void DtlsRL_Datagram_Release(sRL_d* PpsRecordLayer);
 
 /**
  *
@@ -424,21 +440,96 @@ _STATIC_H Void DtlsRL_CB_ChangeServerState(const Void* PpCBParams)
 }
 
 /**
- * Gets the count of the total number of record in the buffer.<br>
+ * Copies bytes of the received datagram, which may span several segments.<br>
+ *
+ * \param[in]       PpsDatagram     Pointer to the received datagram.
+ * \param[in]       PwOffset        Offset of the bytes in the datagram.
+ * \param[out]      PpbDest         Pointer to the destination buffer.
+ * \param[in]       PwLen           Number of bytes, the bytes must be within the datagram.
+ *
+ */
+_STATIC_H Void DtlsRL_Datagram_Copy(const sDatagram_d* PpsDatagram,uint16_t PwOffset,uint8_t* PpbDest,uint16_t PwLen)
+{
+    uint8_t bSegment;
+    uint16_t wChunk;
+
+    for(bSegment = 0; (bSegment < PpsDatagram->bSegmentCount) && (0 != PwLen); bSegment++)
+    {
+        if(PwOffset >= PpsDatagram->rgwSegmentLen[bSegment])
+        {
+            PwOffset -= PpsDatagram->rgwSegmentLen[bSegment];
+            continue;
+        }
+        wChunk = PpsDatagram->rgwSegmentLen[bSegment] - PwOffset;
+        if(wChunk > PwLen)
+        {
+            wChunk = PwLen;
+        }
+        memcpy(PpbDest, PpsDatagram->rgpbSegment[bSegment] + PwOffset, wChunk);
+        PpbDest += wChunk;
+        PwLen -= wChunk;
+        PwOffset = 0;
+    }
+}
+
+/**
+ * Returns the bytes of the received datagram, if they are within one segment.<br>
+ *
+ * \param[in]       PpsDatagram     Pointer to the received datagram.
+ * \param[in]       PwOffset        Offset of the bytes in the datagram.
+ * \param[in]       PwLen           Number of bytes.
+ *
+ * \retval    Pointer to the bytes in the segment
+ * \retval    NULL if the bytes span several segments
+ */
+_STATIC_H uint8_t* DtlsRL_Datagram_Locate(const sDatagram_d* PpsDatagram,uint16_t PwOffset,uint16_t PwLen)
+{
+    uint8_t bSegment;
+
+    for(bSegment = 0; bSegment < PpsDatagram->bSegmentCount; bSegment++)
+    {
+        if(PwOffset < PpsDatagram->rgwSegmentLen[bSegment])
+        {
+            return ((PpsDatagram->rgwSegmentLen[bSegment] - PwOffset) >= PwLen) ?
+                   (PpsDatagram->rgpbSegment[bSegment] + PwOffset) : NULL;
+        }
+        PwOffset -= PpsDatagram->rgwSegmentLen[bSegment];
+    }
+    return NULL;
+}
+
+/**
+ * Gives the datagram received without copying back to the transport layer.<br>
+ *
+ * \param[in,out]   PpsRecordLayer  Pointer to #sRL_d structure.
+ *
+ */
+_STATIC_H Void DtlsRL_Datagram_Release(sRL_d* PpsRecordLayer)
+{
+    if(TRUE == PpsRecordLayer->fDatagramHeld)
+    {
+        PpsRecordLayer->psConfigTL->pfReleaseDatagram(&(PpsRecordLayer->psConfigTL->sTL), &PpsRecordLayer->sDatagram);
+        PpsRecordLayer->fDatagramHeld = FALSE;
+    }
+}
+
+/**
+ * Gets the count of the total number of record in the received datagram.<br>
+ * The record headers are read across the segments of the datagram.
  *
- * \param[in,out]   PpbBuffer       Pointer to buffer containing the records.
- * \param[in]       PwLen           Length of the buffer.
+ * \param[in]       PpsDatagram     Pointer to the received datagram.
  * \param[in,out]   PpbRecCount     Pointer to record count value.
  *  
  * \retval    #OCP_RL_OK        Successful execution
  * \retval    #OCP_RL_ERROR     Failure in execution
  *
  */
-_STATIC_H int32_t DtlsRL_GetRecordCount(uint8_t* PpbBuffer,uint16_t PwLen,uint8_t* PpbRecCount)
+_STATIC_H int32_t DtlsRL_GetRecordCount(const sDatagram_d* PpsDatagram,uint8_t* PpbRecCount)
 {
     int32_t i4Status = OCP_RL_ERROR;
-    uint8_t* pbRecPtr = PpbBuffer;
-    uint16_t wRemainingLen = PwLen;
+    uint8_t rgbHeader[LENGTH_RL_HEADER];
+    uint16_t wOffset = 0;
+    uint16_t wRemainingLen = PpsDatagram->wLen;
     uint16_t wRecLen = 0;
     *PpbRecCount = 0;
     
@@ -447,17 +538,19 @@ _STATIC_H int32_t DtlsRL_GetRecordCount(uint8_t* PpbBuffer,uint16_t PwLen,uint8_
         //Check for remaining length
         if(wRemainingLen > LENGTH_RL_HEADER)
         {
+            DtlsRL_Datagram_Copy(PpsDatagram, wOffset, rgbHeader, LENGTH_RL_HEADER);
+
             //Content type check
-            if((*pbRecPtr != CONTENTTYPE_CIPHER_SPEC) && 
-            (*pbRecPtr != CONTENTTYPE_ALERT) && 
-            (*pbRecPtr != CONTENTTYPE_HANDSHAKE) && 
-            (*pbRecPtr != CONTENTTYPE_APP_DATA))
+            if((rgbHeader[OFFSET_RL_CONTENTTYPE] != CONTENTTYPE_CIPHER_SPEC) && 
+            (rgbHeader[OFFSET_RL_CONTENTTYPE] != CONTENTTYPE_ALERT) && 
+            (rgbHeader[OFFSET_RL_CONTENTTYPE] != CONTENTTYPE_HANDSHAKE) && 
+            (rgbHeader[OFFSET_RL_CONTENTTYPE] != CONTENTTYPE_APP_DATA))
             {
                 break;
             }
 
             //Get the record length
-            wRecLen = (uint32_t)Utility_GetUint16(pbRecPtr+OFFSET_RL_FRAG_LENGTH);
+            wRecLen = Utility_GetUint16(rgbHeader+OFFSET_RL_FRAG_LENGTH);
 
             if((wRecLen+LENGTH_RL_HEADER) > wRemainingLen)
             {
@@ -465,7 +558,7 @@ _STATIC_H int32_t DtlsRL_GetRecordCount(uint8_t* PpbBuffer,uint16_t PwLen,uint8_
             }
             (*PpbRecCount)++;
             wRemainingLen -= (wRecLen + LENGTH_RL_HEADER);
-            pbRecPtr += (wRecLen + LENGTH_RL_HEADER);
+            wOffset += (wRecLen + LENGTH_RL_HEADER);
             i4Status = OCP_RL_OK;
         }
         else
@@ -488,6 +581,7 @@ _STATIC_H int32_t DtlsRL_GetRecordCount(uint8_t* PpbBuffer,uint16_t PwLen,uint8_
  * memory for the record or not.
  * For internal handshake implementation, memory is already allocated by Handshake layer.
  * In case of Application layer, memory should be allocated here.
+ * A record built in memory allocated here is handed over to the transport layer if it has pfSendOwned.
  *
  * \param[in] PpsRecordLayer    Pointer to #sRecordLayer_d structure.
  * \param[in] PpbData           Pointer to a Data to be sent.
@@ -503,6 +597,7 @@ int32_t DtlsRL_Send(sRL_d* PpsRecordLayer,uint8_t* PpbData,uint16_t PwDataLen)
     sRecordData_d sRecordData;
     uint8_t* pbTotalFragMem = NULL;
     uint8_t* pbEncData = NULL;
+    uint8_t* pbOwnData;
     sbBlob_d sBlobData;
     sbBlob_d sRecordBlobData;
 /// @cond hidden
@@ -582,8 +677,22 @@ int32_t DtlsRL_Send(sRL_d* PpsRecordLayer,uint8_t* PpbData,uint16_t PwDataLen)
         }
         
         //Send the data over transport layer
-        i4Status = PpsRecordLayer->psConfigTL->pfSend(&(PpsRecordLayer->psConfigTL->sTL),
-        sBlobData.prgbStream,sBlobData.wLen);
+        DTLS_PROFILE_BEGIN(eProfileSend);
+        //A record in a buffer allocated here is handed over to the transport layer, which frees it
+        pbOwnData = (S_RECORDLAYER->bEncDecFlag == ENC_DEC_ENABLED) ? pbEncData : pbTotalFragMem;
+        if((NULL != PpsRecordLayer->psConfigTL->pfSendOwned) && (NULL != pbOwnData))
+        {
+            pbEncData = NULL;
+            pbTotalFragMem = NULL;
+            i4Status = PpsRecordLayer->psConfigTL->pfSendOwned(&(PpsRecordLayer->psConfigTL->sTL),
+            pbOwnData,sBlobData.wLen);
+        }
+        else
+        {
+            i4Status = PpsRecordLayer->psConfigTL->pfSend(&(PpsRecordLayer->psConfigTL->sTL),
+            sBlobData.prgbStream,sBlobData.wLen);
+        }
+        DTLS_PROFILE_END(eProfileSend, 0, 0, sBlobData.wLen);
         if(OCP_TL_OK != i4Status)
         {
             break;
@@ -832,17 +941,40 @@ int32_t DtlsRL_Recv(sRL_d* PpsRecordLayer,uint8_t* PpbBuffer,uint16_t* PpwLen)
     sbBlob_d sInBlobData;
     sWindow_d *psWindow;
     uint16_t wServerEpoch;
+    uint16_t wBufferLen = *PpwLen;
+    uint8_t rgbHeader[LENGTH_RL_HEADER];
 /// @cond hidden
 #define S_RECORDLAYER ((sRecordLayer_d*)(PpsRecordLayer->phRLHdl))
+#define PS_DATAGRAM (&PpsRecordLayer->sDatagram)
 /// @endcond
     do
     {        
         //If all record not processed, do not call receive
         if(0 == PpsRecordLayer->bMultipleRecord)
         {
+            //Records left over from the previous datagram are dropped
+            DtlsRL_Datagram_Release(PpsRecordLayer);
+
             //Receive Data over Transport
-            i4Status = PpsRecordLayer->psConfigTL->pfRecv(&(PpsRecordLayer->psConfigTL->sTL),
-            PpbBuffer,PpwLen);
+            DTLS_PROFILE_BEGIN(eProfileRecv);
+            if(NULL != PpsRecordLayer->psConfigTL->pfRecvDatagram)
+            {
+                //The records are processed from the buffers of the network stack, no copy of the datagram is made
+                i4Status = PpsRecordLayer->psConfigTL->pfRecvDatagram(&(PpsRecordLayer->psConfigTL->sTL), PS_DATAGRAM);
+                PpsRecordLayer->fDatagramHeld = (OCP_TL_OK == i4Status) ? TRUE : FALSE;
+            }
+            else
+            {
+                i4Status = PpsRecordLayer->psConfigTL->pfRecv(&(PpsRecordLayer->psConfigTL->sTL),
+                PpbBuffer,PpwLen);
+                //The buffer is the one segment of the datagram
+                PS_DATAGRAM->rgpbSegment[0] = PpbBuffer;
+                PS_DATAGRAM->rgwSegmentLen[0] = (OCP_TL_OK == i4Status) ? *PpwLen : 0;
+                PS_DATAGRAM->bSegmentCount = 1;
+                PS_DATAGRAM->wLen = PS_DATAGRAM->rgwSegmentLen[0];
+                PS_DATAGRAM->pvHandle = NULL;
+            }
+            DTLS_PROFILE_END(eProfileRecv, 0, 0, (OCP_TL_OK == i4Status) ? PS_DATAGRAM->wLen : 0);
             if((int32_t)OCP_TL_NO_DATA == i4Status)
             {
                 i4Status = (int32_t)OCP_RL_NO_DATA;
@@ -853,43 +985,46 @@ int32_t DtlsRL_Recv(sRL_d* PpsRecordLayer,uint8_t* PpbBuffer,uint16_t* PpwLen)
                 break;
             }
                         
-            if(*PpwLen > (MAX_PMTU - UDP_OVERHEAD))
+            if(PS_DATAGRAM->wLen > (MAX_PMTU - UDP_OVERHEAD))
             {
                 i4Status = (int32_t)OCP_RL_INVALID_RECORD_LENGTH;
                 break;
             }
             
             //Check how many record are available
-            i4Status = DtlsRL_GetRecordCount(PpbBuffer,*PpwLen,&(PpsRecordLayer->bMultipleRecord));
+            i4Status = DtlsRL_GetRecordCount(PS_DATAGRAM,&(PpsRecordLayer->bMultipleRecord));
             if(OCP_RL_OK != i4Status)
             {
                 break;
             }
-            
-            //Copy the received first record to call back input sBlob 
-            sbBlobCBData.prgbStream = PpbBuffer;
-            sbBlobCBData.wLen = LENGTH_RL_HEADER;
-            sbBlobCBData.wLen += Utility_GetUint16(sbBlobCBData.prgbStream + OFFSET_RL_FRAG_LENGTH);
-            
-            //Copy the location of the next record 
-            PpsRecordLayer->pNextRecord = (sbBlobCBData.prgbStream + sbBlobCBData.wLen); 
+            PpsRecordLayer->wNextRecord = 0;
+        }
+
+        //Take the next record, in place if it is within one segment
+        DtlsRL_Datagram_Copy(PS_DATAGRAM, PpsRecordLayer->wNextRecord, rgbHeader, LENGTH_RL_HEADER);
+        sbBlobCBData.wLen = LENGTH_RL_HEADER;
+        sbBlobCBData.wLen += Utility_GetUint16(rgbHeader + OFFSET_RL_FRAG_LENGTH);
+        sbBlobCBData.prgbStream = DtlsRL_Datagram_Locate(PS_DATAGRAM, PpsRecordLayer->wNextRecord, sbBlobCBData.wLen);
+
+        //Copy the location of the next record 
+        PpsRecordLayer->wNextRecord += sbBlobCBData.wLen;
 
-            //Decrement the record count after a record is copied
-            PpsRecordLayer->bMultipleRecord--;
+        //Decrement the record count after a record is taken
+        PpsRecordLayer->bMultipleRecord--;
+
+        //The message of the record is returned in the buffer, so the record has to fit in it
+        if(sbBlobCBData.wLen > wBufferLen)
+        {
+            i4Status = (int32_t)OCP_RL_INVALID_RECORD_LENGTH;
+            break;
         }
-        else
+
+        if(NULL == sbBlobCBData.prgbStream)
         {
-            //For multiple record
-            ////Copy the received record to call back input sBlob
-            sbBlobCBData.prgbStream = PpsRecordLayer->pNextRecord;
-            sbBlobCBData.wLen = LENGTH_RL_HEADER;
-            sbBlobCBData.wLen += Utility_GetUint16(sbBlobCBData.prgbStream + OFFSET_RL_FRAG_LENGTH);
-            
-            //Copy the location of the next successive record 
-            PpsRecordLayer->pNextRecord = (sbBlobCBData.prgbStream + sbBlobCBData.wLen);
-            
-            //Decrement the record count after a record is copied
-            PpsRecordLayer->bMultipleRecord--;
+            //Record split over segments is gathered into the buffer
+            DtlsRL_Datagram_Copy(PS_DATAGRAM, PpsRecordLayer->wNextRecord - sbBlobCBData.wLen,
+                                 PpbBuffer, sbBlobCBData.wLen);
+            sbBlobCBData.prgbStream = PpbBuffer;
         }
         
         //Assign function pointer for Decryption
@@ -903,7 +1038,7 @@ int32_t DtlsRL_Recv(sRL_d* PpsRecordLayer,uint8_t* PpbBuffer,uint16_t* PpwLen)
         sCBValidateRec.psRecordData->bContentType = PpsRecordLayer->bContentType;       
         sCBValidateRec.psRecordData->psBlobInOutMsg = &sInBlobData;
         sCBValidateRec.psRecordData->psBlobInOutMsg->prgbStream = PpbBuffer;
-        sCBValidateRec.psRecordData->psBlobInOutMsg->wLen = *PpwLen;
+        sCBValidateRec.psRecordData->psBlobInOutMsg->wLen = (TRUE == PpsRecordLayer->fDatagramHeld) ? wBufferLen : *PpwLen;
 
 		
 		S_RECORDLAYER->sServerSeqNumber.dwHigherByte = (uint32_t)Utility_GetUint16 (sbBlobCBData.prgbStream + OFFSET_RL_SEQUENCE);
@@ -982,8 +1117,15 @@ int32_t DtlsRL_Recv(sRL_d* PpsRecordLayer,uint8_t* PpbBuffer,uint16_t* PpwLen)
         }
         //if window slide refresh buffer to removed old sequence number
     }while(FALSE);
+
+    //The datagram is given back once its last record is processed
+    if(0 == PpsRecordLayer->bMultipleRecord)
+    {
+        DtlsRL_Datagram_Release(PpsRecordLayer);
+    }
 /// @cond hidden
 #undef S_RECORDLAYER
+#undef PS_DATAGRAM
 /// @endcond
     return i4Status;
 }
@@ -1033,6 +1175,8 @@ int32_t DtlsRL_Init(sRL_d* PpsRL)
 
         PpsRL->fRetransmit = FALSE;
         PpsRL->bMultipleRecord = 0x00;
+        PpsRL->wNextRecord = 0x00;
+        PpsRL->fDatagramHeld = FALSE;
         S_RECORDLAYER->psWindow = (sWindow_d*)OCP_MALLOC(sizeof(sWindow_d));
         if(NULL == S_RECORDLAYER->psWindow)
         {
@@ -1086,6 +1230,9 @@ void DtlsRL_Close(sRL_d* PpsRL)
     //NULL check
     if(NULL != PpsRL)
     {
+        DtlsRL_Datagram_Release(PpsRL);
+        PpsRL->bMultipleRecord = 0x00;
+
         if(NULL != PpsRL->phRLHdl)
         {
             if(NULL != PS_WINDOW)
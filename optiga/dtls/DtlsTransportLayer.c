@@ -33,11 +33,416 @@
 
 #include "optiga/dtls/DtlsTransportLayer.h"
 #include "optiga/common/MemoryMgmt.h"
+#include "optiga/pal/pal_os_timer.h"
 
 #ifdef MODULE_ENABLE_DTLS_MUTUAL_AUTH
 
 /// @cond hidden
 
+///Maximum number of endpoints in a race, including the primary endpoint
+#define TL_MAX_ENDPOINTS            (OCP_TL_MAX_ALT_ENDPOINTS + 1)
+
+///Delay after which the next endpoint of a race is started
+#define TL_RACE_STAGGER_MS          (250)
+
+///Maximum length of the datagram replayed to the endpoints started later
+#define TL_RACE_DATAGRAM_SIZE       (512)
+
+///Sender is none of the started endpoints
+#define TL_NO_ENDPOINT              (0xFF)
+
+#ifndef OCP_TL_WINNER_CACHE_ENTRIES
+///Number of endpoint sets for which the winner of the last race is cached
+#define OCP_TL_WINNER_CACHE_ENTRIES (2)
+#endif
+
+///Maximum length of an IP address string including the terminator
+#define TL_IP_LENGTH                (46)
+
+///Winner of the last race over a set of endpoints, kept across connects
+typedef struct sWinnerCache_d
+{
+    ///IP address of the primary endpoint
+    char_t rgzIpAddress[TL_IP_LENGTH];
+    ///Port of the primary endpoint, 0 if the entry is free
+    uint16_t wPort;
+    ///Number of endpoints raced
+    uint8_t bCount;
+    ///Hash of the alternative endpoints
+    uint32_t dwAltHash;
+    ///Index of the endpoint which answered first
+    uint8_t bWinner;
+}sWinnerCache_d;
+
+///Cached winners
+static sWinnerCache_d rgsWinnerCache[OCP_TL_WINNER_CACHE_ENTRIES];
+
+///Entry to be replaced if the cache is full
+static uint8_t bWinnerCacheNext = 0;
+
+///Transport layer handle, referred as pal_socket_t by the lower layer
+typedef struct sTLHandle_d
+{
+    ///Socket communication structure, must be the first member
+    pal_socket_t sSocket;
+
+    ///Order in which the endpoints are started
+    uint8_t rgbOrder[TL_MAX_ENDPOINTS];
+
+    ///Number of endpoints racing, 0 if there is no race or the winner is known
+    uint8_t bRaceCount;
+
+    ///Number of endpoints started
+    uint8_t bStarted;
+
+    ///Time at which the last endpoint was started
+    uint32_t dwLastStart;
+
+    ///Length of the last datagram sent, 0 if it could not be kept
+    uint16_t wDatagramLen;
+
+    ///Last datagram sent during the race
+    uint8_t rgbDatagram[TL_RACE_DATAGRAM_SIZE];
+}sTLHandle_d;
+
+_STATIC_H sEndpoint_d DtlsTL_GetEndpoint(const sTL_d* PpsTL, uint8_t PbIndex);
+
+_STATIC_H uint32_t DtlsTL_AltEndpointHash(const sTL_d* PpsTL, uint8_t PbCount);
+
+_STATIC_H sWinnerCache_d* DtlsTL_WinnerCacheFind(const sTL_d* PpsTL, uint8_t PbCount, bool_t PfAllocate);
+
+_STATIC_H int32_t DtlsTL_SendTo(const sTL_d* PpsTL, uint8_t PbIndex, uint8_t* PpbBuffer, uint16_t PwLen);
+
+_STATIC_H uint8_t DtlsTL_FindSender(const sTL_d* PpsTL);
+
+_STATIC_H Void DtlsTL_PinWinner(const sTL_d* PpsTL, uint8_t PbPosition);
+
+_STATIC_H int32_t DtlsTL_Listen(const sTL_d* PpsTL, uint8_t* PpbBuffer, uint32_t* PpdwLen,
+                                pal_socket_datagram_t* PpsDatagram);
+
+_STATIC_H int32_t DtlsTL_RaceRecv(const sTL_d* PpsTL, uint8_t* PpbBuffer, uint32_t* PpdwLen,
+                                  pal_socket_datagram_t* PpsDatagram);
+
+_STATIC_H int32_t DtlsTL_Receive(const sTL_d* PpsTL, uint8_t* PpbBuffer, uint32_t* PpdwLen,
+                                 pal_socket_datagram_t* PpsDatagram);
+
+///Transport layer handle
+#define PS_TL_HANDLE ((sTLHandle_d*)PpsTL->phTLHdl)
+
+/**
+ * Returns an endpoint of the transport layer, index 0 being the primary endpoint.
+ *
+ * \param[in]  PpsTL       Pointer to the transport layer communication structure
+ * \param[in]  PbIndex     Index of the endpoint
+ *
+ * \return  Endpoint
+ */
+_STATIC_H sEndpoint_d DtlsTL_GetEndpoint(const sTL_d* PpsTL, uint8_t PbIndex)
+{
+    sEndpoint_d sEndpoint;
+
+    if(0 == PbIndex)
+    {
+        sEndpoint.pzIpAddress = PpsTL->pzIpAddress;
+        sEndpoint.wPort = PpsTL->wPort;
+    }
+    else
+    {
+        sEndpoint = PpsTL->psAltEndpoints[PbIndex - 1];
+    }
+    return sEndpoint;
+}
+
+/**
+ * Computes a FNV-1a hash over the IP addresses and ports of the alternative endpoints.
+ *
+ * \param[in]  PpsTL       Pointer to the transport layer communication structure
+ * \param[in]  PbCount     Number of endpoints raced, including the primary endpoint
+ *
+ * \return  Hash of the alternative endpoints
+ */
+_STATIC_H uint32_t DtlsTL_AltEndpointHash(const sTL_d* PpsTL, uint8_t PbCount)
+{
+    uint32_t dwHash = 0x811C9DC5;
+    uint8_t bIndex;
+    const char_t* pzAddress;
+    sEndpoint_d sEndpoint;
+
+    for(bIndex = 1; bIndex < PbCount; bIndex++)
+    {
+        sEndpoint = DtlsTL_GetEndpoint(PpsTL, bIndex);
+        for(pzAddress = sEndpoint.pzIpAddress; (NULL != pzAddress) && ('\0' != *pzAddress); pzAddress++)
+        {
+            dwHash = (dwHash ^ (uint8_t)*pzAddress) * 0x01000193;
+        }
+        dwHash = (dwHash ^ (uint8_t)(sEndpoint.wPort >> 8)) * 0x01000193;
+        dwHash = (dwHash ^ (uint8_t)sEndpoint.wPort) * 0x01000193;
+    }
+    return dwHash;
+}
+
+/**
+ * Looks up the cached winner of the endpoints of the transport layer.
+ * The endpoints are identified by the primary IP address and port, the number of endpoints and the alternative endpoints.
+ *
+ * \param[in]  PpsTL       Pointer to the transport layer communication structure
+ * \param[in]  PbCount     Number of endpoints raced, including the primary endpoint
+ * \param[in]  PfAllocate  TRUE to return a free or the oldest entry if the endpoints are not cached
+ *
+ * \return  Pointer to the cache entry, NULL if the endpoints are not cached or can not be cached
+ */
+_STATIC_H sWinnerCache_d* DtlsTL_WinnerCacheFind(const sTL_d* PpsTL, uint8_t PbCount, bool_t PfAllocate)
+{
+    sWinnerCache_d* psEntry = NULL;
+    uint32_t dwAltHash;
+    uint8_t bIndex;
+
+    do
+    {
+        if((NULL == PpsTL->pzIpAddress) || (0 == PpsTL->wPort) || (TL_IP_LENGTH <= strlen(PpsTL->pzIpAddress)))
+        {
+            break;
+        }
+        dwAltHash = DtlsTL_AltEndpointHash(PpsTL, PbCount);
+
+        for(bIndex = 0; bIndex < OCP_TL_WINNER_CACHE_ENTRIES; bIndex++)
+        {
+            if((PpsTL->wPort == rgsWinnerCache[bIndex].wPort) && (PbCount == rgsWinnerCache[bIndex].bCount) &&
+               (dwAltHash == rgsWinnerCache[bIndex].dwAltHash) &&
+               (0 == strcmp(PpsTL->pzIpAddress, rgsWinnerCache[bIndex].rgzIpAddress)))
+            {
+                psEntry = &rgsWinnerCache[bIndex];
+                break;
+            }
+        }
+        if((NULL != psEntry) || (FALSE == PfAllocate))
+        {
+            break;
+        }
+
+        for(bIndex = 0; bIndex < OCP_TL_WINNER_CACHE_ENTRIES; bIndex++)
+        {
+            if(0 == rgsWinnerCache[bIndex].wPort)
+            {
+                psEntry = &rgsWinnerCache[bIndex];
+                break;
+            }
+        }
+        if(NULL == psEntry)
+        {
+            psEntry = &rgsWinnerCache[bWinnerCacheNext];
+            bWinnerCacheNext = (uint8_t)((bWinnerCacheNext + 1) % OCP_TL_WINNER_CACHE_ENTRIES);
+        }
+        strcpy(psEntry->rgzIpAddress, PpsTL->pzIpAddress);
+        psEntry->wPort = PpsTL->wPort;
+        psEntry->bCount = PbCount;
+        psEntry->dwAltHash = dwAltHash;
+        psEntry->bWinner = 0;
+    }while(FALSE);
+
+    return psEntry;
+}
+
+/**
+ * Sends a datagram to an endpoint and makes it the destination of the socket.
+ *
+ * \param[in]  PpsTL       Pointer to the transport layer communication structure
+ * \param[in]  PbIndex     Index of the endpoint
+ * \param[in]  PpbBuffer   Pointer to buffer containing data to be transmitted
+ * \param[in]  PwLen       Length of the data to be transmitted
+ *
+ * \return  #E_COMMS_SUCCESS on successful execution
+ * \return  Error from pal_socket_assign_ip_address or pal_socket_send on failure
+ */
+_STATIC_H int32_t DtlsTL_SendTo(const sTL_d* PpsTL, uint8_t PbIndex, uint8_t* PpbBuffer, uint16_t PwLen)
+{
+    int32_t i4Status;
+    sEndpoint_d sEndpoint = DtlsTL_GetEndpoint(PpsTL, PbIndex);
+
+    do
+    {
+        i4Status = pal_socket_assign_ip_address(sEndpoint.pzIpAddress, &(PS_TL_HANDLE->sSocket.sIPAddress));
+        if(E_COMMS_SUCCESS != i4Status)
+        {
+            break;
+        }
+        PS_TL_HANDLE->sSocket.wPort = sEndpoint.wPort;
+
+        i4Status = pal_socket_send(&PS_TL_HANDLE->sSocket, PpbBuffer, PwLen);
+    }while(FALSE);
+
+    return i4Status;
+}
+
+/**
+ * Looks up the sender of the last received datagram among the started endpoints.
+ *
+ * \param[in]  PpsTL       Pointer to the transport layer communication structure
+ *
+ * \return  Position of the sender in the start order, #TL_NO_ENDPOINT if the sender is unknown
+ */
+_STATIC_H uint8_t DtlsTL_FindSender(const sTL_d* PpsTL)
+{
+    uint8_t bPosition;
+    sEndpoint_d sEndpoint;
+
+    for(bPosition = 0; bPosition < PS_TL_HANDLE->bStarted; bPosition++)
+    {
+        sEndpoint = DtlsTL_GetEndpoint(PpsTL, PS_TL_HANDLE->rgbOrder[bPosition]);
+#ifndef WIN32
+        //Endpoints on the same host are told apart by the port
+        if((sEndpoint.wPort == PS_TL_HANDLE->sSocket.wRecvPort) &&
+           (E_COMMS_SUCCESS == pal_socket_compare_ip_address(sEndpoint.pzIpAddress, &(PS_TL_HANDLE->sSocket.sIPAddress))))
+        {
+            break;
+        }
+#endif
+    }
+    return (bPosition < PS_TL_HANDLE->bStarted) ? bPosition : (uint8_t)TL_NO_ENDPOINT;
+}
+
+/**
+ * Ends the race, the rest of the session is bound to the winner which is cached for the next connects.
+ *
+ * \param[in]  PpsTL       Pointer to the transport layer communication structure
+ * \param[in]  PbPosition  Position of the winner in the start order
+ *
+ * \return  None
+ */
+_STATIC_H Void DtlsTL_PinWinner(const sTL_d* PpsTL, uint8_t PbPosition)
+{
+    sEndpoint_d sEndpoint = DtlsTL_GetEndpoint(PpsTL, PS_TL_HANDLE->rgbOrder[PbPosition]);
+    sWinnerCache_d* psEntry = DtlsTL_WinnerCacheFind(PpsTL, PS_TL_HANDLE->bRaceCount, TRUE);
+
+    //Socket address is already the sender, the port is the one of the endpoint
+    PS_TL_HANDLE->sSocket.wPort = sEndpoint.wPort;
+    PS_TL_HANDLE->bRaceCount = 0;
+
+    if(NULL != psEntry)
+    {
+        psEntry->bWinner = PS_TL_HANDLE->rgbOrder[PbPosition];
+    }
+
+    LOG_TRANSPORTMSG("Endpoint won the connect race",eInfo);
+}
+
+/**
+ * Receives a datagram on the socket, copied into the buffer or referenced without copying.
+ *
+ * \param[in]      PpsTL       Pointer to the transport layer communication structure
+ * \param[in,out]  PpbBuffer   Pointer to buffer where data is to be received, not used if PpsDatagram is given
+ * \param[in,out]  PpdwLen     Length of the buffer/Length of the received data
+ * \param[out]     PpsDatagram Pointer to the datagram received without copying, NULL to copy into PpbBuffer
+ *
+ * \return  #E_COMMS_SUCCESS on successful execution
+ * \return  Error from pal_socket_listen or pal_socket_listen_datagram on failure
+ */
+_STATIC_H int32_t DtlsTL_Listen(const sTL_d* PpsTL, uint8_t* PpbBuffer, uint32_t* PpdwLen,
+                                pal_socket_datagram_t* PpsDatagram)
+{
+    int32_t i4Status;
+
+#ifndef WIN32
+    if(NULL != PpsDatagram)
+    {
+        i4Status = pal_socket_listen_datagram(&PS_TL_HANDLE->sSocket, PpsDatagram);
+        if(E_COMMS_SUCCESS == i4Status)
+        {
+            *PpdwLen = PpsDatagram->length;
+        }
+        return i4Status;
+    }
+#endif
+    i4Status = pal_socket_listen(&PS_TL_HANDLE->sSocket, PpbBuffer, PpdwLen);
+    return i4Status;
+}
+
+/**
+ * Receives the first answer of the race. The endpoints not yet started are started every #TL_RACE_STAGGER_MS
+ * with the last datagram sent, till the timeout of the transport layer.
+ *
+ * \param[in]      PpsTL       Pointer to the transport layer communication structure
+ * \param[in,out]  PpbBuffer   Pointer to buffer where data is to be received
+ * \param[in,out]  PpdwLen     Length of the buffer/Length of the received data
+ * \param[out]     PpsDatagram Pointer to the datagram received without copying, NULL to copy into PpbBuffer
+ *
+ * \return  #E_COMMS_SUCCESS on successful execution
+ * \return  #E_COMMS_UDP_NO_DATA_RECEIVED on no data received from the endpoints
+ * \return  Error from pal_socket_listen on failure
+ */
+_STATIC_H int32_t DtlsTL_RaceRecv(const sTL_d* PpsTL, uint8_t* PpbBuffer, uint32_t* PpdwLen,
+                                  pal_socket_datagram_t* PpsDatagram)
+{
+    int32_t i4Status = (int32_t)E_COMMS_UDP_NO_DATA_RECEIVED;
+    uint32_t dwStart = pal_os_timer_get_time_in_milliseconds();
+    uint32_t dwElapsed;
+    uint32_t dwSinceStart;
+    uint32_t dwSlice;
+    uint32_t dwRecvLen;
+    uint8_t bPosition;
+
+    for(;;)
+    {
+        dwElapsed = pal_os_timer_get_time_in_milliseconds() - dwStart;
+        if(dwElapsed >= PpsTL->wTimeout)
+        {
+            i4Status = (int32_t)E_COMMS_UDP_NO_DATA_RECEIVED;
+            break;
+        }
+        dwSlice = PpsTL->wTimeout - dwElapsed;
+
+        //Start the next endpoint when the stagger delay expired
+        if((PS_TL_HANDLE->bStarted < PS_TL_HANDLE->bRaceCount) && (0 != PS_TL_HANDLE->wDatagramLen))
+        {
+            dwSinceStart = pal_os_timer_get_time_in_milliseconds() - PS_TL_HANDLE->dwLastStart;
+            if(TL_RACE_STAGGER_MS <= dwSinceStart)
+            {
+                LOG_TRANSPORTMSG("Starting next endpoint of the connect race",eInfo);
+                if(E_COMMS_SUCCESS != DtlsTL_SendTo(PpsTL, PS_TL_HANDLE->rgbOrder[PS_TL_HANDLE->bStarted],
+                                                    PS_TL_HANDLE->rgbDatagram, PS_TL_HANDLE->wDatagramLen))
+                {
+                    LOG_TRANSPORTMSG("Error while sending data",eError);
+                }
+                PS_TL_HANDLE->bStarted++;
+                PS_TL_HANDLE->dwLastStart = pal_os_timer_get_time_in_milliseconds();
+                continue;
+            }
+            if((TL_RACE_STAGGER_MS - dwSinceStart) < dwSlice)
+            {
+                dwSlice = TL_RACE_STAGGER_MS - dwSinceStart;
+            }
+        }
+
+        PS_TL_HANDLE->sSocket.wTimeout = (uint16_t)dwSlice;
+        dwRecvLen = *PpdwLen;
+        i4Status = DtlsTL_Listen(PpsTL, PpbBuffer, &dwRecvLen, PpsDatagram);
+        if((int32_t)E_COMMS_UDP_NO_DATA_RECEIVED == i4Status)
+        {
+            continue;
+        }
+        if(E_COMMS_SUCCESS != i4Status)
+        {
+            break;
+        }
+
+        bPosition = DtlsTL_FindSender(PpsTL);
+        if(TL_NO_ENDPOINT != bPosition)
+        {
+            DtlsTL_PinWinner(PpsTL, bPosition);
+            *PpdwLen = dwRecvLen;
+            break;
+        }
+        //Datagram from a sender which is not part of the race is dropped
+        LOG_TRANSPORTMSG("Dropped data from unknown sender",eInfo);
+#ifndef WIN32
+        if(NULL != PpsDatagram)
+        {
+            pal_socket_release_datagram(PpsDatagram);
+        }
+#endif
+    }
+    return i4Status;
+}
 /// @endcond
 /**
  * This API initialises transport layer communication structure.
@@ -62,12 +467,14 @@ int32_t DtlsTL_Init(sTL_d* PpsTL)
         }
 		
         //Allocate the memory for the ethernet communication structure
-        PpsTL->phTLHdl = (pal_socket_t*)OCP_MALLOC(sizeof(pal_socket_t));
+        PpsTL->phTLHdl = (sTLHandle_d*)OCP_MALLOC(sizeof(sTLHandle_d));
         if(NULL == PpsTL->phTLHdl)
         {
             i4Status = (int32_t)OCP_TL_MALLOC_FAILURE;
             break;
         }
+        PS_TL_HANDLE->bRaceCount = 0;
+        PS_TL_HANDLE->bStarted = 0;
 /// @cond hidden
 #define PS_COMMS_HANDLE ((pal_socket_t*)PpsTL->phTLHdl)
 /// @endcond
@@ -113,7 +520,9 @@ int32_t DtlsTL_Init(sTL_d* PpsTL)
 }
 
 /**
- * This API creates client port
+ * This API creates client port.
+ * If alternative endpoints are configured, they are raced with the primary endpoint, the cached winner
+ * of the previous race over the same endpoints being started first.
  *
  * \param[in,out]  PpsTL     Pointer to the transport layer communication structure
  *
@@ -125,6 +534,13 @@ int32_t DtlsTL_Init(sTL_d* PpsTL)
 int32_t DtlsTL_Connect(sTL_d* PpsTL)
 {
     int32_t i4Status = (int32_t)OCP_TL_ERROR;
+    uint8_t bCount = 1;
+    uint8_t bFirst = 0;
+    uint8_t bIndex;
+    uint8_t bPosition;
+    sEndpoint_d sEndpoint;
+    sWinnerCache_d* psEntry;
+
     do
     {
         //NULL check
@@ -147,6 +563,47 @@ int32_t DtlsTL_Connect(sTL_d* PpsTL)
             break;
         }
 
+#ifndef WIN32
+        //The socket reports the sender of a datagram only with lwIP, OCP_Init rejects alternative endpoints elsewhere
+        if(NULL != PpsTL->psAltEndpoints)
+        {
+            bCount += (PpsTL->bAltEndpointCount > OCP_TL_MAX_ALT_ENDPOINTS) ?
+                      (uint8_t)OCP_TL_MAX_ALT_ENDPOINTS : PpsTL->bAltEndpointCount;
+        }
+#endif
+
+        //The winner of the previous race over the same endpoints is started first
+        if(bCount > 1)
+        {
+            psEntry = DtlsTL_WinnerCacheFind(PpsTL, bCount, FALSE);
+            if((NULL != psEntry) && (psEntry->bWinner < bCount))
+            {
+                bFirst = psEntry->bWinner;
+            }
+        }
+        PS_TL_HANDLE->rgbOrder[0] = bFirst;
+        bPosition = 1;
+        for(bIndex = 0; bIndex < bCount; bIndex++)
+        {
+            if(bIndex != bFirst)
+            {
+                PS_TL_HANDLE->rgbOrder[bPosition++] = bIndex;
+            }
+        }
+
+        PS_TL_HANDLE->bRaceCount = (bCount > 1) ? bCount : 0;
+        PS_TL_HANDLE->bStarted = 0;
+        PS_TL_HANDLE->wDatagramLen = 0;
+
+        //Send to the first endpoint till the race is started
+        sEndpoint = DtlsTL_GetEndpoint(PpsTL, bFirst);
+        i4Status = pal_socket_assign_ip_address(sEndpoint.pzIpAddress, &(PS_COMMS_HANDLE->sIPAddress));
+        if(E_COMMS_SUCCESS != i4Status)
+        {
+            break;
+        }
+        PS_COMMS_HANDLE->wPort = sEndpoint.wPort;
+
         PpsTL->eIsConnected = eConnected;
         i4Status = (int32_t)OCP_TL_OK;
     }while(FALSE);
@@ -158,6 +615,7 @@ int32_t DtlsTL_Connect(sTL_d* PpsTL)
 
 /**
  * This API transmits the data to the server.
+ * During a connect race the data is sent to every endpoint started so far and kept to start the next endpoints.
  *
  * \param[in,out]  PpsTL               Pointer to the transport layer communication structure
  * \param[in]      PpbBuffer           Pointer to buffer containing data to be transmitted
@@ -174,6 +632,7 @@ int32_t DtlsTL_Connect(sTL_d* PpsTL)
 int32_t DtlsTL_Send(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t PdwLen)
 {
     int32_t i4Status = (int32_t)OCP_TL_ERROR;
+    uint8_t bPosition;
     
     do
     {
@@ -190,7 +649,35 @@ int32_t DtlsTL_Send(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t PdwLen)
 /// @cond hidden
 #define PS_COMMS_HANDLE ((pal_socket_t*)PpsTL->phTLHdl)
 /// @endcond        
-        i4Status = pal_socket_send(PS_COMMS_HANDLE, PpbBuffer, PdwLen);
+        if(0 == PS_TL_HANDLE->bRaceCount)
+        {
+            i4Status = pal_socket_send(PS_COMMS_HANDLE, PpbBuffer, PdwLen);
+        }
+        else
+        {
+            //Keep the datagram for the endpoints started later
+            PS_TL_HANDLE->wDatagramLen = 0;
+            if(TL_RACE_DATAGRAM_SIZE >= PdwLen)
+            {
+                memcpy(PS_TL_HANDLE->rgbDatagram, PpbBuffer, PdwLen);
+                PS_TL_HANDLE->wDatagramLen = PdwLen;
+            }
+
+            if(0 == PS_TL_HANDLE->bStarted)
+            {
+                PS_TL_HANDLE->bStarted = 1;
+                PS_TL_HANDLE->dwLastStart = pal_os_timer_get_time_in_milliseconds();
+            }
+
+            //Sending is successful if any of the started endpoints is reached
+            for(bPosition = 0; bPosition < PS_TL_HANDLE->bStarted; bPosition++)
+            {
+                if(E_COMMS_SUCCESS == DtlsTL_SendTo(PpsTL, PS_TL_HANDLE->rgbOrder[bPosition], PpbBuffer, PdwLen))
+                {
+                    i4Status = E_COMMS_SUCCESS;
+                }
+            }
+        }
         if (E_COMMS_SUCCESS != i4Status)
         {
             LOG_TRANSPORTMSG("Error while sending data",eError);
@@ -204,12 +691,15 @@ int32_t DtlsTL_Send(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t PdwLen)
     return i4Status;
 }
 
+/// @cond hidden
 /**
- * This API receives the data from the server
+ * Receives the data from the server, copied into the buffer or referenced without copying.
+ * During a connect race the first endpoint to answer becomes the server of the session.
  *
  * \param[in]       PpsTL               Pointer to the transport layer communication structure
- * \param[in,out]   PpbBuffer           Pointer to buffer where data is to be received
+ * \param[in,out]   PpbBuffer           Pointer to buffer where data is to be received, not used if PpsDatagram is given
  * \param[in,out]   PpdwLen             Length of the buffer/Length of the received data
+ * \param[out]      PpsDatagram         Pointer to the datagram received without copying, NULL to copy into PpbBuffer
  *
  * \return  #OCP_TL_OK on successful execution
  * \return  #OCP_TL_NULL_PARAM on parameter received is NULL
@@ -217,7 +707,8 @@ int32_t DtlsTL_Send(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t PdwLen)
  * \return  #E_COMMS_INSUFFICIENT_BUF_SIZE on insufficient buffer size
  * \return  #OCP_TL_ERROR on failure
  */
-int32_t DtlsTL_Recv(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t* PpdwLen)
+_STATIC_H int32_t DtlsTL_Receive(const sTL_d* PpsTL, uint8_t* PpbBuffer, uint32_t* PpdwLen,
+                                 pal_socket_datagram_t* PpsDatagram)
 {
     int32_t i4Status = (int32_t)OCP_TL_ERROR;
     uint32_t dwRecvLen;
@@ -225,7 +716,7 @@ int32_t DtlsTL_Recv(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t* PpdwLen)
     do
     {
         //NULL check
-        if((NULL == PpsTL) || (NULL == PpsTL->phTLHdl) || (NULL == PpbBuffer))
+        if((NULL == PpsTL) || (NULL == PpsTL->phTLHdl) || ((NULL == PpbBuffer) && (NULL == PpsDatagram)))
         {
             i4Status = (int32_t)OCP_TL_NULL_PARAM;
             break;
@@ -241,7 +732,14 @@ int32_t DtlsTL_Recv(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t* PpdwLen)
         dwRecvLen = *PpdwLen;
         
         //Listen the server port and receive the data
-        i4Status = pal_socket_listen(PS_COMMS_HANDLE, PpbBuffer, &dwRecvLen);
+        if(0 == PS_TL_HANDLE->bRaceCount)
+        {
+            i4Status = DtlsTL_Listen(PpsTL, PpbBuffer, &dwRecvLen, PpsDatagram);
+        }
+        else
+        {
+            i4Status = DtlsTL_RaceRecv(PpsTL, PpbBuffer, &dwRecvLen, PpsDatagram);
+        }
         if ((int32_t)E_COMMS_UDP_NO_DATA_RECEIVED == i4Status)
         {
             i4Status = (int32_t)OCP_TL_NO_DATA;
@@ -256,17 +754,115 @@ int32_t DtlsTL_Recv(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t* PpdwLen)
         }
         
         LOG_TRANSPORTMSG("Received Data",eInfo);
-        LOG_TRANSPORTDBARY("Received Data over UDP", PpbBuffer, dwRecvLen, eInfo);
+        if(NULL == PpsDatagram)
+        {
+            LOG_TRANSPORTDBARY("Received Data over UDP", PpbBuffer, dwRecvLen, eInfo);
+        }
         
-        *PpdwLen = (uint16_t)dwRecvLen;
+        *PpdwLen = dwRecvLen;
         
         i4Status = (int32_t)OCP_TL_OK;
     }while(FALSE);
-/// @cond hidden    
 #undef PS_COMMS_HANDLE
-/// @endcond    
     return i4Status;
 }
+/// @endcond
+
+/**
+ * This API receives the data from the server.
+ * During a connect race the first endpoint to answer becomes the server of the session.
+ *
+ * \param[in]       PpsTL               Pointer to the transport layer communication structure
+ * \param[in,out]   PpbBuffer           Pointer to buffer where data is to be received
+ * \param[in,out]   PpdwLen             Length of the buffer/Length of the received data
+ *
+ * \return  #OCP_TL_OK on successful execution
+ * \return  #OCP_TL_NULL_PARAM on parameter received is NULL
+ * \return  #OCP_TL_NO_DATA on no data received from the target
+ * \return  #E_COMMS_INSUFFICIENT_BUF_SIZE on insufficient buffer size
+ * \return  #OCP_TL_ERROR on failure
+ */
+int32_t DtlsTL_Recv(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t* PpdwLen)
+{
+    int32_t i4Status;
+    uint32_t dwRecvLen;
+
+    if((NULL == PpbBuffer) || (NULL == PpdwLen))
+    {
+        return (int32_t)OCP_TL_NULL_PARAM;
+    }
+    dwRecvLen = *PpdwLen;
+    i4Status = DtlsTL_Receive(PpsTL, PpbBuffer, &dwRecvLen, NULL);
+    if((int32_t)OCP_TL_OK == i4Status)
+    {
+        *PpdwLen = (uint16_t)dwRecvLen;
+    }
+    return i4Status;
+}
+
+#ifndef WIN32
+/**
+ * This API receives a datagram from the server without copying it. The datagram references the buffers of the
+ * network stack till it is released with #DtlsTL_ReleaseDatagram.
+ * During a connect race the first endpoint to answer becomes the server of the session.
+ *
+ * \param[in]       PpsTL               Pointer to the transport layer communication structure
+ * \param[out]      PpsDatagram         Pointer to the received datagram
+ *
+ * \return  #OCP_TL_OK on successful execution
+ * \return  #OCP_TL_NULL_PARAM on parameter received is NULL
+ * \return  #OCP_TL_NO_DATA on no data received from the target
+ * \return  #OCP_TL_ERROR on failure
+ */
+int32_t DtlsTL_RecvDatagram(const sTL_d* PpsTL,sDatagram_d* PpsDatagram)
+{
+    int32_t i4Status;
+    uint32_t dwRecvLen = 0;
+    pal_socket_datagram_t sDatagram;
+    uint8_t bSegment;
+
+    if(NULL == PpsDatagram)
+    {
+        return (int32_t)OCP_TL_NULL_PARAM;
+    }
+    memset(PpsDatagram, 0x00, sizeof(sDatagram_d));
+    i4Status = DtlsTL_Receive(PpsTL, NULL, &dwRecvLen, &sDatagram);
+    if((int32_t)OCP_TL_OK == i4Status)
+    {
+        for(bSegment = 0; (bSegment < sDatagram.segment_count) && (bSegment < TL_MAX_DATAGRAM_SEGMENTS); bSegment++)
+        {
+            PpsDatagram->rgpbSegment[bSegment] = sDatagram.p_segment[bSegment];
+            PpsDatagram->rgwSegmentLen[bSegment] = sDatagram.segment_length[bSegment];
+        }
+        PpsDatagram->bSegmentCount = bSegment;
+        PpsDatagram->wLen = sDatagram.length;
+        PpsDatagram->pvHandle = sDatagram.p_handle;
+    }
+    return i4Status;
+}
+
+/**
+ * This API gives a datagram received with #DtlsTL_RecvDatagram back to the network stack.
+ *
+ * \param[in]       PpsTL               Pointer to the transport layer communication structure
+ * \param[in,out]   PpsDatagram         Pointer to the datagram
+ *
+ * \return  None
+ */
+void DtlsTL_ReleaseDatagram(const sTL_d* PpsTL,sDatagram_d* PpsDatagram)
+{
+    pal_socket_datagram_t sDatagram;
+
+    (void)PpsTL;
+    if((NULL != PpsDatagram) && (NULL != PpsDatagram->pvHandle))
+    {
+        memset(&sDatagram, 0x00, sizeof(sDatagram));
+        sDatagram.p_handle = PpsDatagram->pvHandle;
+        pal_socket_release_datagram(&sDatagram);
+        memset(PpsDatagram, 0x00, sizeof(sDatagram_d));
+    }
+}
+#endif
 
 /**
  * This API closes the UDP communication and releases all the resources
@@ -308,4 +904,7 @@ Void DtlsTL_Disconnect(sTL_d* PpsTL)
 /**
 * @}
 */
+/// @cond hidden
+#undef PS_TL_HANDLE
+/// @endcond
 #endif /*MODULE_ENABLE_DTLS_MUTUAL_AUTH*/
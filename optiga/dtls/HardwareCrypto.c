@@ -35,6 +35,7 @@
 #include "optiga/dtls/HardwareCrypto.h"
 #include "optiga/dtls/OcpCommon.h"
 #include "optiga/cmd/CommandLib.h"
+#include "optiga/dtls/DtlsProfiler.h"
 
 #ifdef MODULE_ENABLE_DTLS_MUTUAL_AUTH
 
@@ -122,7 +123,9 @@ int32_t HWCL_Encrypt(const sCL_d* PpsCL, const sbBlob_d* PpsBlobPlainText,sbBlob
         sProcCryptoData.sOutData.wBufferLength = PpsBlobCipherText->wLen;
 
         //Invoke the encrypt command API from the command library
+        DTLS_PROFILE_BEGIN(eProfileChip);
         i4Status = CmdLib_Encrypt(&sProcCryptoData);
+        DTLS_PROFILE_END(eProfileChip, (uint8_t)eProfileEncrypt, 0, PwLen);
         if(CMD_LIB_OK != i4Status)
         {
             break;
@@ -192,7 +195,9 @@ int32_t HWCL_Decrypt(const sCL_d* PpsCL,const sbBlob_d* PpsBlobCipherText,sbBlob
         LOG_TRANSPORTMSG("Encrypted Data sent to OPTIGA",eInfo);
         
         //Invoke the Decrypt command API from the command library
+        DTLS_PROFILE_BEGIN(eProfileChip);
         i4Status = CmdLib_Decrypt(&sProcCryptoData);
+        DTLS_PROFILE_END(eProfileChip, (uint8_t)eProfileDecrypt, 0, PwLen);
         if(CMD_LIB_OK != i4Status)
         {
             LOG_TRANSPORTDBVAL(i4Status,eInfo);
@@ -31,6 +31,7 @@
 */
 
 #include "optiga/dtls/MessageLayer.h"
+#include "optiga/dtls/DtlsProfiler.h"
 
 #ifdef MODULE_ENABLE_DTLS_MUTUAL_AUTH
 
@@ -186,7 +187,9 @@ int32_t MsgLayer_FormMessage(eMsgType_d eMsgType,const sMessageLayer_d* PpsMessa
 			break;
 		}
         //Get the Message using Get Message command from the Security Chip
+        DTLS_PROFILE_BEGIN(eProfileChip);
         i4Status =  CmdLib_GetMessage(&sGMsgVector);
+        DTLS_PROFILE_END(eProfileChip, (uint8_t)eProfileGetMessage, (uint8_t)eMsgType, (uint16_t)sCBGetMsg.dwMsgLen);
         if(CMD_LIB_OK != i4Status)
         {
             LOG_TRANSPORTDBVAL(i4Status,eInfo);
@@ -243,7 +246,9 @@ int32_t MsgLayer_ProcessMessage(eMsgType_d eMsgType,const sMessageLayer_d* PpsMe
         sPMsgVector.psCallBack = NULL;
 
         //Invoke the Put Message command API from the command library to send the message to Security Chip to Process
+        DTLS_PROFILE_BEGIN(eProfileChip);
         i4Status = CmdLib_PutMessage(&sPMsgVector);
+        DTLS_PROFILE_END(eProfileChip, (uint8_t)eProfilePutMessage, (uint8_t)eMsgType, PpsMessage->wLen);
         if(CMD_LIB_OK != i4Status)
         {
             LOG_TRANSPORTDBVAL(i4Status,eInfo);
@@ -33,12 +33,14 @@
 #include "optiga/optiga_dtls.h"
 #include "optiga/cmd/CommandLib.h"
 #include "optiga/dtls/AlertProtocol.h"
+#include "optiga/dtls/AppTransportLayer.h"
 
 #ifdef MODULE_ENABLE_DTLS_MUTUAL_AUTH
 
 /// @cond hidden
 
-extern Void ConfigHL(fPerformHandshake_d* PfPerformHandshake_d,eConfiguration_d PeConfiguration);
+extern Void ConfigHL(fPerformHandshake_d* PfPerformHandshake_d,fPerformHandshake_d* PpfPrepareHandshake,
+                     fPerformHandshake_d* PpfReleaseHandshake,eConfiguration_d PeConfiguration);
 extern Void ConfigRL(sConfigRL_d* PpsConfigRL,eConfiguration_d PeConfiguration);
 extern Void ConfigTL(sConfigTL_d* PpsConfigTL,eConfiguration_d PeConfiguration);
 extern Void ConfigCL(sConfigCL_d* PpsConfigCL,eConfiguration_d PeConfiguration);
@@ -60,6 +62,12 @@ typedef struct sAppOCPCtx_d
 {    
     ///Pointer to function that performs handshake
 	fPerformHandshake_d pfPerformHandshake;
+
+    ///Pointer to function that prepares the first flight before the transport is connected, NULL if not supported
+    fPerformHandshake_d pfPrepareHandshake;
+
+    ///Pointer to function that releases the prepared first flight
+    fPerformHandshake_d pfReleaseHandshake;
     
     ///Structure that contains Handshake data
 	sHandshake_d sHandshake;
@@ -75,6 +83,14 @@ typedef struct sAppOCPCtx_d
     
     ///Buffer to store the received application data
     uint8_t* pAppDataBuf;
+
+#ifdef ENABLE_HANDSHAKE_PROFILER
+    ///Profile of the last handshake
+    sHandshakeProfile_d sProfile;
+
+    ///Callback function pointer to report the profile
+    fProfileReport_d pfProfileReport;
+#endif
 }sAppOCPCtx_d;
 
 /**
@@ -82,7 +98,8 @@ typedef struct sAppOCPCtx_d
  */
 _STATIC_H Void OCP_Config(sAppOCPCtx_d* PpsAppOCPCntx,eConfiguration_d PeConfiguration)
 {
-    ConfigHL(&(PpsAppOCPCntx->pfPerformHandshake),PeConfiguration);
+    ConfigHL(&(PpsAppOCPCntx->pfPerformHandshake),&(PpsAppOCPCntx->pfPrepareHandshake),
+             &(PpsAppOCPCntx->pfReleaseHandshake),PeConfiguration);
     ConfigRL(&(PpsAppOCPCntx->sConfigRL),PeConfiguration);
     ConfigTL(PpsAppOCPCntx->sConfigRL.sRL.psConfigTL,PeConfiguration);
     ConfigCL(PpsAppOCPCntx->sConfigRL.sRL.psConfigCL,PeConfiguration);
@@ -107,6 +124,10 @@ _STATIC_H int32_t OCPAllocateMemory(sAppOCPCtx_d ** PppsAppOCPCntx)
         }
         
         (*PS_APPOCPCNTX).pAppDataBuf = NULL;
+        (*PS_APPOCPCNTX).pfPrepareHandshake = NULL;
+        (*PS_APPOCPCNTX).pfReleaseHandshake = NULL;
+        (*PS_APPOCPCNTX).sHandshake.phPreparedFlight = NULL;
+        (*PS_APPOCPCNTX).sHandshake.dwReplayedMsgSeqNum = 0xFFFFFFFF;
         (*PS_APPOCPCNTX).sConfigRL.sRL.psConfigTL = NULL;
         (*PS_APPOCPCNTX).sConfigRL.sRL.psConfigCL = NULL;
 
@@ -366,6 +387,12 @@ _STATIC_H Void CloseSession(hdl_t PhAppOCPCtx, bool_t PfFatalError, uint16_t PwS
     //Disconnect from the server via transport layer
     S_CONFIGURATION_TL->pfDisconnect(&S_CONFIGURATION_TL->sTL);
 
+    //Release the first flight if prepared and not sent
+    if(NULL != psCntx->pfReleaseHandshake)
+    {
+        psCntx->pfReleaseHandshake(&psCntx->sHandshake);
+    }
+
     //Clear the session reference ID registry for the handle 
     Registry_Free(PhAppOCPCtx);
 
@@ -405,11 +432,23 @@ _STATIC_H Void CloseSession(hdl_t PhAppOCPCtx, bool_t PfFatalError, uint16_t PwS
  * - psNetworkParams allows the user to configure the port, IP Address and maximum PMTU required for transport layer connection.<br>
  * - Valid IP address  and port number must be provided. The correctness of the IP address and port number will not be verified.<br>
  * - PMTU value should range between 296 to 1500,else  #OCP_LIB_UNSUPPORTED_PMTU error is returned.<br>
+ * - psAltEndpoints optionally lists further IPv4/IPv6 endpoints of the same server. The ClientHello is sent to the endpoints
+ *   with staggered starts and the handshake continues with the first one to respond. The winner is cached for the same set of
+ *   endpoints and tried first on later connects, also with a new OCP context. The cookie of the server is not cached
+ *   with alternative endpoints, so the handshake starts with flight 1.
+ *   Endpoints beyond #OCP_TL_MAX_ALT_ENDPOINTS are ignored. On WIN32 the endpoints can not be raced and #OCP_LIB_UNSUPPORTED_CONFIG
+ *   is returned if alternative endpoints are configured.<br>
+ * - With #eDTLS_12_APP_HWCRYPTO, psAppTransport provides the transport of the application instead of pal socket.
+ *   Outbound datagrams are passed to its send callback and inbound datagrams are passed with #OCP_FeedDatagram.
+ *   With the pfSendOwned callback, encrypted records are handed over to the application without a copy.
+ *   The IP address, port and alternative endpoints are not used.<br>
  * - Logger allows user to log data. User must provide the low level log writer through #sLogger_d.<br>
  * - pfGetUnixTIme(#fGetUnixTime_d) is a call-back function pointer that allows user to provide 32-bit Unix time format.<br>
  * - If pfGetUnixTIme is set to NULL, the unix time will not be sent to security chip.<br>
  * - If pfGetUnixTIme is not set to NULL or valid function pointer, the behavior would be unexpected.<br>
  * - The call back function pfGetUnixTIme is expected to return status s as #CALL_BACK_OK for success.
+ * - With ENABLE_HANDSHAKE_PROFILER defined, pfProfileReport(#fProfileReport_d) is called at the end of each #OCP_Connect()
+ *   with the profile of the handshake, also if it failed. It may be set to NULL and the profile read with #OCP_GetHandshakeProfile().
  *
  *<b>Notes:</b>
  * - Currently, only 1 DTLS session is supported by security chip.<br>
@@ -455,14 +494,32 @@ int32_t OCP_Init(const sAppOCPConfig_d* PpsAppOCPConfig,hdl_t* PphAppOCPCtx)
         }
 
         //Check for valid configuration
-        if(eDTLS_12_UDP_HWCRYPTO != PpsAppOCPConfig->eConfiguration)
+        if((eDTLS_12_UDP_HWCRYPTO != PpsAppOCPConfig->eConfiguration) && (eDTLS_12_APP_HWCRYPTO != PpsAppOCPConfig->eConfiguration))
+        {
+            i4Status = (int32_t)OCP_LIB_UNSUPPORTED_CONFIG;
+            break;
+        }
+
+        //Transport of the application must be able to send
+        if((eDTLS_12_APP_HWCRYPTO == PpsAppOCPConfig->eConfiguration) &&
+           ((NULL == PpsAppOCPConfig->sNetworkParams.psAppTransport) || (NULL == PpsAppOCPConfig->sNetworkParams.psAppTransport->pfSend)))
+        {
+            i4Status = (int32_t)OCP_LIB_NULL_PARAM;
+            break;
+        }
+
+#ifdef WIN32
+        //The socket does not report the sender of a datagram, alternative endpoints can not be raced
+        if((eDTLS_12_UDP_HWCRYPTO == PpsAppOCPConfig->eConfiguration) &&
+           (NULL != PpsAppOCPConfig->sNetworkParams.psAltEndpoints) && (0 != PpsAppOCPConfig->sNetworkParams.bAltEndpointCount))
         {
             i4Status = (int32_t)OCP_LIB_UNSUPPORTED_CONFIG;
             break;
         }
+#endif
 
         //Initialize the Auth Scheme type
-        if((eClient == PpsAppOCPConfig->eMode) && (eDTLS_12_UDP_HWCRYPTO == PpsAppOCPConfig->eConfiguration))
+        if(eClient == PpsAppOCPConfig->eMode)
         {
             eAuthScheme = eDTLSClient;
         }
@@ -512,6 +569,12 @@ int32_t OCP_Init(const sAppOCPConfig_d* PpsAppOCPConfig,hdl_t* PphAppOCPCtx)
         
         //Assign the callback function to get unix time
         psAppOCPCntx->sHandshake.pfGetUnixTIme = PpsAppOCPConfig->pfGetUnixTIme;
+
+#ifdef ENABLE_HANDSHAKE_PROFILER
+        //Assign the callback function to report the handshake profile
+        psAppOCPCntx->pfProfileReport = PpsAppOCPConfig->pfProfileReport;
+        OCP_MEMSET(&psAppOCPCntx->sProfile, 0, sizeof(psAppOCPCntx->sProfile));
+#endif
         
         //Assign the record layer configuration pointer to the handshake layer
         psAppOCPCntx->sHandshake.psConfigRL = &psAppOCPCntx->sConfigRL;
@@ -539,6 +602,17 @@ int32_t OCP_Init(const sAppOCPConfig_d* PpsAppOCPConfig,hdl_t* PphAppOCPCtx)
         //Assign the port number to the transport layer parameter
         S_TL.wPort = PpsAppOCPConfig->sNetworkParams.wPort;
 
+        //Assign the alternative endpoints to the transport layer parameter
+        S_TL.psAltEndpoints = PpsAppOCPConfig->sNetworkParams.psAltEndpoints;
+        S_TL.bAltEndpointCount = PpsAppOCPConfig->sNetworkParams.bAltEndpointCount;
+
+        //Assign the transport of the application, if it is used
+        S_TL.psAppTransport = NULL;
+        if(eDTLS_12_APP_HWCRYPTO == PpsAppOCPConfig->eConfiguration)
+        {
+            S_TL.psAppTransport = PpsAppOCPConfig->sNetworkParams.psAppTransport;
+        }
+
         //Assign the UDP Timeout to the transport layer parameter
         S_TL.wTimeout = 200;
         
@@ -616,8 +690,9 @@ int32_t OCP_Init(const sAppOCPConfig_d* PpsAppOCPConfig,hdl_t* PphAppOCPCtx)
  * - Server trust anchor must be available in the security chip.<br>
  *
  *<b>API Details:</b>
- * - Connects to the server via the transport layer.<br>
  * - Invokes CmdLib_SetAuthScheme() based on configuration.<br>
+ * - Gets the ClientHello from the security chip, so it is ready to be sent when the transport is connected.<br>
+ * - Connects to the server via the transport layer.<br>
  * - Performs a DTLS Handshake.<br>
  *
  *<b>User Input:</b><br>
@@ -647,6 +722,9 @@ int32_t OCP_Connect(const hdl_t PhAppOCPCtx)
 {
     int32_t i4Status = (int32_t)OCP_LIB_ERROR;
     sAuthScheme_d sAuthScheme;
+#ifdef ENABLE_HANDSHAKE_PROFILER
+    bool_t fProfiled = FALSE;
+#endif
 /// @cond hidden
 #define PS_CNTX ((sAppOCPCtx_d*)PhAppOCPCtx)
 #define S_CONFIGURATION_TL (PS_CNTX->sConfigRL.sRL.psConfigTL)
@@ -685,13 +763,12 @@ int32_t OCP_Connect(const hdl_t PhAppOCPCtx)
             i4Status = (int32_t)OCP_LIB_CONNECTION_ALREADY_EXISTS;
             break;
         }
-        //Connect to server
-        i4Status = S_CONFIGURATION_TL->pfConnect(&S_CONFIGURATION_TL->sTL);
-        if(OCP_TL_OK != i4Status)
-        {
-            break;
-        }
-            
+#ifdef ENABLE_HANDSHAKE_PROFILER
+        DTLS_PROFILE_START(&PS_CNTX->sProfile);
+        fProfiled = TRUE;
+#endif
+        //The security chip does not depend on the transport, it is done first to have the ClientHello
+        //ready when connected.
         //Get the Session OID from registry
         i4Status = Registry_GetHandleSessionID(PhAppOCPCtx,&(PS_CNTX->sHandshake.wSessionOID));
         if(OCP_LIB_OK != i4Status)
@@ -705,11 +782,30 @@ int32_t OCP_Connect(const hdl_t PhAppOCPCtx)
         sAuthScheme.wSessionKeyId = PS_CNTX->sHandshake.wSessionOID;
         
         //Set the AuthScheme
+        DTLS_PROFILE_BEGIN(eProfileChip);
         i4Status = CmdLib_SetAuthScheme(&sAuthScheme);
+        DTLS_PROFILE_END(eProfileChip, (uint8_t)eProfileSetAuthScheme, 0, 0);
         if(CMD_LIB_OK != i4Status)
         {
             break;
         }
+
+        //Prepare the first flight
+        if(NULL != PS_CNTX->pfPrepareHandshake)
+        {
+            i4Status = PS_CNTX->pfPrepareHandshake(&PS_CNTX->sHandshake);
+            if(OCP_HL_OK != i4Status)
+            {
+                break;
+            }
+        }
+
+        //Connect to server
+        i4Status = S_CONFIGURATION_TL->pfConnect(&S_CONFIGURATION_TL->sTL);
+        if(OCP_TL_OK != i4Status)
+        {
+            break;
+        }
         
         //Perform Handshake
         i4Status = PS_CNTX->pfPerformHandshake((hdl_t)&PS_CNTX->sHandshake);
@@ -721,6 +817,18 @@ int32_t OCP_Connect(const hdl_t PhAppOCPCtx)
 
     }while(FALSE);
 
+#ifdef ENABLE_HANDSHAKE_PROFILER
+    //Reported before a failed connect releases the context
+    if(TRUE == fProfiled)
+    {
+        DTLS_PROFILE_STOP(i4Status);
+        if(NULL != PS_CNTX->pfProfileReport)
+        {
+            PS_CNTX->pfProfileReport(PhAppOCPCtx, &PS_CNTX->sProfile);
+        }
+    }
+#endif
+
     do
     {
         if((OCP_LIB_OK != i4Status) && 
@@ -1139,6 +1247,7 @@ int32_t OCP_Receive(const hdl_t PhAppOCPCtx, uint8_t* PprgbData, uint16_t* PpwLe
 *
 *<b>User Input:</b><br>
 * - User must provide a valid PhAppOCPCtx handle.<br>
+* - With #eDTLS_12_APP_HWCRYPTO, the application must have stopped calling #OCP_FeedDatagram() from other contexts.<br>
 *
 * Notes: <br>
 * - If the record sequence number has reached maximum value for epoch 1, No Alert will be send due to the unavailability of record sequence number.<br>
@@ -1206,6 +1315,132 @@ int32_t OCP_Disconnect(hdl_t PhAppOCPCtx)
     return i4Status;
 }
 
+/**
+* This API passes an inbound datagram to a session configured with #eDTLS_12_APP_HWCRYPTO.<br>
+* The datagram is referenced, not copied. The record layer processes its records in place and then gives it back
+* with the pfRelease callback of #sAppTransport_d.<br>
+*
+*<b>Pre Conditions:</b>
+* - #OCP_Init() is successful with #eDTLS_12_APP_HWCRYPTO.<br>
+*
+*<b>Notes:</b>
+* - It can be invoked from the pfPoll callback of #sAppTransport_d or from one other context while OCP waits for data.<br>
+* - It is not synchronised with #OCP_Disconnect(), which frees the transport layer. The other context must stop feeding
+*   before #OCP_Disconnect() is called.<br>
+* - Datagrams fed before #OCP_Connect() or after #OCP_Disconnect() are not taken.<br>
+* - If #OCP_TL_MAX_FED_DATAGRAMS datagrams are pending, #OCP_TL_QUEUE_FULL is returned and the datagram stays with the caller.<br>
+* - The datagram must stay valid and unchanged till it is given back. If pfRelease is NULL, it must stay valid till OCP
+*   has processed its records, i.e. till the next datagram is received or the session is closed.<br>
+*
+* \param[in] PhAppOCPCtx    Handle to OCP Context
+* \param[in] PprgbData      Pointer to the datagram
+* \param[in] PwLen          Length of the datagram
+*
+* \retval  #OCP_LIB_OK
+* \retval  #OCP_LIB_NULL_PARAM
+* \retval  #OCP_LIB_SESSIONID_UNAVAILABLE
+* \retval  #OCP_LIB_UNSUPPORTED_CONFIG
+* \retval  #OCP_TL_QUEUE_FULL
+* \retval  #OCP_TL_ERROR
+*/
+int32_t OCP_FeedDatagram(const hdl_t PhAppOCPCtx,const uint8_t* PprgbData,uint16_t PwLen)
+{
+    int32_t i4Status = (int32_t)OCP_LIB_ERROR;
+/// @cond hidden
+#define PS_CNTX  ((sAppOCPCtx_d*)PhAppOCPCtx)
+#define S_CONFIGURATION_TL (PS_CNTX->sConfigRL.sRL.psConfigTL)
+/// @endcond
+    do
+    {
+        //NULL check for inputs
+        if((NULL == PS_CNTX) || (NULL == PprgbData))
+        {
+            i4Status = (int32_t)OCP_LIB_NULL_PARAM;
+            break;
+        }
+
+        //Validate the handle for the sessionID
+        i4Status = Registry_ValidateHandleSessionID(PhAppOCPCtx);
+        if(OCP_LIB_OK != i4Status)
+        {
+            break;
+        }
+
+        if((NULL == S_CONFIGURATION_TL) || (NULL == S_CONFIGURATION_TL->sTL.psAppTransport))
+        {
+            i4Status = (int32_t)OCP_LIB_UNSUPPORTED_CONFIG;
+            break;
+        }
+
+        i4Status = AppTL_Feed(&S_CONFIGURATION_TL->sTL, PprgbData, PwLen);
+        if(OCP_TL_OK != i4Status)
+        {
+            break;
+        }
+        i4Status = (int32_t)OCP_LIB_OK;
+    }while(FALSE);
+
+/// @cond hidden
+#undef PS_CNTX
+#undef S_CONFIGURATION_TL
+/// @endcond
+    return i4Status;
+}
+
+#ifdef ENABLE_HANDSHAKE_PROFILER
+/**
+* This API copies the profile of the last handshake of the session.<br>
+* The profile splits the time of #OCP_Connect() into the time spent in the security chip, in sending, in
+* receiving and in the host per flight, see #sHandshakeProfile_d.<br>
+*
+*<b>Pre Conditions:</b>
+* - #OCP_Init() is successful.<br>
+*
+*<b>Notes:</b>
+* - Timings have a resolution of 1 millisecond.<br>
+* - The profile is cleared by #OCP_Init() and overwritten by every #OCP_Connect().<br>
+* - A failed #OCP_Connect() releases the context, so its profile is only reported through pfProfileReport of #sAppOCPConfig_d.<br>
+*
+* \param[in] PhAppOCPCtx    Handle to OCP Context
+* \param[out] PpsProfile    Pointer to the profile
+*
+* \retval  #OCP_LIB_OK
+* \retval  #OCP_LIB_NULL_PARAM
+* \retval  #OCP_LIB_SESSIONID_UNAVAILABLE
+*/
+int32_t OCP_GetHandshakeProfile(const hdl_t PhAppOCPCtx,sHandshakeProfile_d* PpsProfile)
+{
+    int32_t i4Status = (int32_t)OCP_LIB_ERROR;
+/// @cond hidden
+#define PS_CNTX  ((sAppOCPCtx_d*)PhAppOCPCtx)
+/// @endcond
+    do
+    {
+        //NULL check for inputs
+        if((NULL == PS_CNTX) || (NULL == PpsProfile))
+        {
+            i4Status = (int32_t)OCP_LIB_NULL_PARAM;
+            break;
+        }
+
+        //Validate the handle for the sessionID
+        i4Status = Registry_ValidateHandleSessionID(PhAppOCPCtx);
+        if(OCP_LIB_OK != i4Status)
+        {
+            break;
+        }
+
+        OCP_MEMCPY(PpsProfile, &PS_CNTX->sProfile, sizeof(sHandshakeProfile_d));
+        i4Status = (int32_t)OCP_LIB_OK;
+    }while(FALSE);
+
+/// @cond hidden
+#undef PS_CNTX
+/// @endcond
+    return i4Status;
+}
+#endif
+
 /**
 * @}
 */
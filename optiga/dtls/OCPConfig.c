@@ -30,6 +30,7 @@
 * @{
 */
 #include "optiga/dtls/DtlsTransportLayer.h"
+#include "optiga/dtls/AppTransportLayer.h"
 #include "optiga/dtls/DtlsHandshakeProtocol.h" //To be put under ifdef
 #include "optiga/dtls/DtlsRecordLayer.h"
 #include "optiga/dtls/HardwareCrypto.h"
@@ -40,14 +41,18 @@
 /// @cond hidden
 //lint --e{714} suppress "Functions are extern and not reference in header file as 
 //          these function not to be used for external interfaces. Hence suppressed"
-Void ConfigHL(fPerformHandshake_d* PpfPerformHandshake,eConfiguration_d PeConfiguration)
+Void ConfigHL(fPerformHandshake_d* PpfPerformHandshake,fPerformHandshake_d* PpfPrepareHandshake,
+              fPerformHandshake_d* PpfReleaseHandshake,eConfiguration_d PeConfiguration)
 {
     //Based on input mode assign pointers to PpsAppOCPCntx
     switch(PeConfiguration)
     {
         case eDTLS_12_UDP_HWCRYPTO:
-            //Assign the Handshake layer function pointer to context data
+        case eDTLS_12_APP_HWCRYPTO:
+            //Assign the Handshake layer function pointers to context data
             *PpfPerformHandshake = DtlsHS_Handshake;
+            *PpfPrepareHandshake = DtlsHS_PrepareHandshake;
+            *PpfReleaseHandshake = DtlsHS_ReleaseHandshake;
             break;
       
         case eTLS_12_TCP_HWCRYPTO:
@@ -63,6 +68,7 @@ Void ConfigRL(sConfigRL_d* PpsConfigRL,eConfiguration_d PeConfiguration)
     switch(PeConfiguration)
     {
         case eDTLS_12_UDP_HWCRYPTO:
+        case eDTLS_12_APP_HWCRYPTO:
 
             PpsConfigRL->pfInit = DtlsRL_Init;
             PpsConfigRL->pfSend = DtlsRL_Send;
@@ -91,6 +97,27 @@ Void ConfigTL(sConfigTL_d* PpsConfigTL,eConfiguration_d PeConfiguration)
             PpsConfigTL->pfDisconnect = DtlsTL_Disconnect;
             PpsConfigTL->pfRecv = DtlsTL_Recv;
             PpsConfigTL->pfSend = DtlsTL_Send;        
+            PpsConfigTL->pfSendOwned = NULL;
+#ifndef WIN32
+            //The records are parsed from the pbuf chains of lwIP
+            PpsConfigTL->pfRecvDatagram = DtlsTL_RecvDatagram;
+            PpsConfigTL->pfReleaseDatagram = DtlsTL_ReleaseDatagram;
+#else
+            PpsConfigTL->pfRecvDatagram = NULL;
+            PpsConfigTL->pfReleaseDatagram = NULL;
+#endif
+            break;
+        case eDTLS_12_APP_HWCRYPTO:
+            //Datagrams are exchanged with the transport of the application
+            PpsConfigTL->pfInit = AppTL_Init;
+            PpsConfigTL->pfConnect = AppTL_Connect;
+            PpsConfigTL->pfDisconnect = AppTL_Disconnect;
+            PpsConfigTL->pfRecv = AppTL_Recv;
+            PpsConfigTL->pfSend = AppTL_Send;
+            //Records are handed over to the application and processed in the fed datagrams, without copies
+            PpsConfigTL->pfSendOwned = AppTL_SendOwned;
+            PpsConfigTL->pfRecvDatagram = AppTL_RecvDatagram;
+            PpsConfigTL->pfReleaseDatagram = AppTL_ReleaseDatagram;
             break;
     }
 }
@@ -103,6 +130,7 @@ Void ConfigCL(sConfigCL_d* PpsConfigCL,eConfiguration_d PeConfiguration)
     switch(PeConfiguration)
     {
         case eDTLS_12_UDP_HWCRYPTO:
+        case eDTLS_12_APP_HWCRYPTO:
         case eTLS_12_TCP_HWCRYPTO:
             PpsConfigCL->pfInit = HWCL_Init;
             PpsConfigCL->pfEncrypt = HWCL_Encrypt;
@@ -0,0 +1,340 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file dtls_cookie_cache_test.c
+*
+* \brief   Test of the cache of the HelloVerifyRequest. A scripted server behind a fake record layer answers a
+*          ClientHello without its current cookie with a HelloVerifyRequest and ends the handshake with a fatal alert
+*          once the cookie is right. A fake Security Chip puts the cookie of the last HelloVerifyRequest into the
+*          ClientHello. The cached cookie is sent in the first ClientHello of the next handshake, a new
+*          HelloVerifyRequest of the server is answered with the new cookie, and nothing is replayed with
+*          alternative endpoints.
+*
+*          gcc -Ioptiga/include -DMODULE_ENABLE_DTLS_MUTUAL_AUTH optiga/dtls/test/dtls_cookie_cache_test.c
+*              optiga/dtls/DtlsHandshakeProtocol.c optiga/dtls/DtlsFlightHandler.c optiga/dtls/MessageLayer.c
+*              optiga/common/Util.c -o dtls_cookie_cache_test
+*
+* \ingroup  grOCP
+* @{
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "optiga/dtls/DtlsHandshakeProtocol.h"
+#include "optiga/dtls/DtlsFlightHandler.h"
+#include "optiga/dtls/DtlsRecordLayer.h"
+#include "optiga/dtls/AlertProtocol.h"
+#include "optiga/dtls/MessageLayer.h"
+#include "optiga/cmd/CommandLib.h"
+
+#define TEST_CHECK(condition)                                               \
+    if (!(condition))                                                       \
+    {                                                                       \
+        printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition);       \
+        return -1;                                                          \
+    }
+
+/// @cond hidden
+#define TEST_COOKIE_LENGTH      (16)
+#define TEST_MAX_HELLOS         (8)
+#define TEST_PROTOCOL_VERSION   (0xFEFD)
+
+//Scripted server
+static uint8_t test_server_cookie[TEST_COOKIE_LENGTH];
+static uint8_t test_response[MSG_HEADER_LEN + 3 + TEST_COOKIE_LENGTH];
+static uint16_t test_response_length;
+static bool_t test_alert;
+
+//Cookie of each ClientHello sent, the first byte or 0 without cookie
+static uint8_t test_hellos[TEST_MAX_HELLOS];
+static uint8_t test_hello_count;
+
+//Fake Security Chip
+static uint8_t test_chip_cookie[TEST_COOKIE_LENGTH];
+static uint8_t test_chip_cookie_length;
+static uint16_t test_chip_sequence;
+static uint32_t test_time;
+
+static sRecordLayer_d test_record_layer;
+static sConfigTL_d test_config_tl;
+static sConfigRL_d test_config_rl;
+static sHandshake_d test_handshake;
+
+//The server answers a ClientHello, with a HelloVerifyRequest if the cookie is not its current one
+static int32_t test_rl_send(sRL_d* PpsRL, uint8_t* PpbBuffer, uint16_t PwLen)
+{
+    const uint8_t * p_hello = PpbBuffer + LENGTH_RL_HEADER;
+    const uint8_t * p_cookie;
+    uint16_t sequence;
+
+    if ((CONTENTTYPE_HANDSHAKE != PpsRL->bContentType) || (eClientHello != p_hello[0]) ||
+        (TEST_MAX_HELLOS == test_hello_count) || (PwLen < (LENGTH_RL_HEADER + MSG_HEADER_LEN + 35)))
+    {
+        return (int32_t)OCP_RL_OK;
+    }
+
+    //Version(2), random(32), session id(1 + 0), cookie
+    p_cookie = p_hello + MSG_HEADER_LEN + 35;
+    test_hellos[test_hello_count++] = (0 == p_cookie[0]) ? 0 : p_cookie[1];
+    if ((TEST_COOKIE_LENGTH == p_cookie[0]) && (0 == memcmp(p_cookie + 1, test_server_cookie, TEST_COOKIE_LENGTH)))
+    {
+        test_alert = TRUE;
+        return (int32_t)OCP_RL_OK;
+    }
+
+    sequence = Utility_GetUint16(p_hello + 4);
+    test_response[0] = eHello_Verify_Request;
+    Utility_SetUint24(test_response + 1, 3 + TEST_COOKIE_LENGTH);
+    Utility_SetUint16(test_response + 4, sequence);
+    Utility_SetUint24(test_response + 6, 0);
+    Utility_SetUint24(test_response + 9, 3 + TEST_COOKIE_LENGTH);
+    Utility_SetUint16(test_response + MSG_HEADER_LEN, TEST_PROTOCOL_VERSION);
+    test_response[MSG_HEADER_LEN + 2] = TEST_COOKIE_LENGTH;
+    memcpy(test_response + MSG_HEADER_LEN + 3, test_server_cookie, TEST_COOKIE_LENGTH);
+    test_response_length = sizeof(test_response);
+    return (int32_t)OCP_RL_OK;
+}
+
+static int32_t test_rl_recv(sRL_d* PpsRL, uint8_t* PpbBuffer, uint16_t* PpwLen)
+{
+    (void)PpsRL;
+    //Every poll without data takes a second
+    test_time += 1000;
+    if (test_alert)
+    {
+        test_alert = FALSE;
+        return (int32_t)OCP_RL_ALERT_RECEIVED;
+    }
+    if (0 == test_response_length)
+    {
+        return (int32_t)OCP_RL_NO_DATA;
+    }
+    memcpy(PpbBuffer, test_response, test_response_length);
+    *PpwLen = test_response_length;
+    test_response_length = 0;
+    return (int32_t)OCP_RL_OK;
+}
+
+//The Security Chip puts the cookie of the last HelloVerifyRequest into a ClientHello with cookie
+int32_t CmdLib_GetMessage(const sProcMsgData_d *PpsGMsgVector)
+{
+    uint8_t message[MSG_HEADER_LEN + 35 + 1 + TEST_COOKIE_LENGTH + 4 + 2];
+    uint16_t length = 0;
+    sbBlob_d blob;
+
+    if (eClientHello == PpsGMsgVector->eParam)
+    {
+        test_chip_sequence = 0;
+        test_chip_cookie_length = 0;
+    }
+    else if (eClientHelloWithCookie != PpsGMsgVector->eParam)
+    {
+        return (int32_t)CMD_LIB_ERROR;
+    }
+
+    memset(message, 0x00, sizeof(message));
+    Utility_SetUint16(message + MSG_HEADER_LEN, TEST_PROTOCOL_VERSION);
+    length = 35;
+    message[MSG_HEADER_LEN + length++] = test_chip_cookie_length;
+    memcpy(message + MSG_HEADER_LEN + length, test_chip_cookie, test_chip_cookie_length);
+    length += test_chip_cookie_length;
+    //One cipher suite, no compression
+    Utility_SetUint16(message + MSG_HEADER_LEN + length, 2);
+    Utility_SetUint16(message + MSG_HEADER_LEN + length + 2, 0xC0AE);
+    length += 4;
+    message[MSG_HEADER_LEN + length++] = 1;
+    message[MSG_HEADER_LEN + length++] = 0;
+
+    message[0] = eClientHello;
+    Utility_SetUint24(message + 1, length);
+    Utility_SetUint16(message + 4, test_chip_sequence++);
+    Utility_SetUint24(message + 9, length);
+
+    blob.prgbStream = message;
+    blob.wLen = (uint16_t)(MSG_HEADER_LEN + length);
+    return PpsGMsgVector->psCallBack->pfAcceptMessage(PpsGMsgVector->psCallBack->fvParams, &blob);
+}
+
+int32_t CmdLib_PutMessage(const sProcMsgData_d *PpsPMsgVector)
+{
+    const uint8_t * p_body = PpsPMsgVector->psBlobInBuffer->prgbStream + OVERHEAD_LEN;
+
+    if (eHelloVerifyRequest != PpsPMsgVector->eParam)
+    {
+        return (int32_t)CMD_LIB_ERROR;
+    }
+    test_chip_cookie_length = p_body[2];
+    memcpy(test_chip_cookie, p_body + 3, test_chip_cookie_length);
+    return (int32_t)CMD_LIB_OK;
+}
+
+uint32_t pal_os_timer_get_time_in_milliseconds(void)
+{
+    return test_time;
+}
+
+int32_t Alert_ProcessMsg(const sbBlob_d* PpsAlertMsg, int32_t* Ppi4ErrorCode)
+{
+    (void)PpsAlertMsg;
+    *Ppi4ErrorCode = (int32_t)OCP_AL_FATAL_ERROR;
+    return (int32_t)OCP_AL_OK;
+}
+
+void Alert_Send(sConfigRL_d *PpsConfigRL, int32_t Pi4ErrorCode)
+{
+    (void)PpsConfigRL;
+    (void)Pi4ErrorCode;
+}
+
+void Dtls_SlideWindow(const sRL_d* PpsRecordLayer, eAuthState_d PeAuthState)
+{
+    (void)PpsRecordLayer;
+    (void)PeAuthState;
+}
+
+//Every test talks to a server of its own, the cache is kept across the tests
+static void test_setup(uint16_t PwPort)
+{
+    static char_t address[] = "192.0.2.1";
+
+    memset(&test_config_tl, 0x00, sizeof(test_config_tl));
+    test_config_tl.sTL.pzIpAddress = address;
+    test_config_tl.sTL.wPort = PwPort;
+
+    memset(&test_config_rl, 0x00, sizeof(test_config_rl));
+    test_config_rl.pfSend = test_rl_send;
+    test_config_rl.pfRecv = test_rl_recv;
+    test_config_rl.sRL.phRLHdl = (hdl_t)&test_record_layer;
+    test_config_rl.sRL.psConfigTL = &test_config_tl;
+
+    memset(&test_handshake, 0x00, sizeof(test_handshake));
+    test_handshake.eMode = eClient;
+    test_handshake.wMaxPmtu = 1280;
+    test_handshake.psConfigRL = &test_config_rl;
+    test_handshake.eAuthState = eAuthInitialised;
+    test_handshake.wSessionOID = 0xE100;
+    test_handshake.dwReplayedMsgSeqNum = 0xFFFFFFFF;
+}
+
+//Runs a handshake till the server accepts the cookie and records the cookies of the ClientHellos sent
+static int test_handshake_run(void)
+{
+    test_hello_count = 0;
+    test_response_length = 0;
+    test_alert = FALSE;
+    test_handshake.eAuthState = eAuthInitialised;
+    TEST_CHECK(OCP_HL_OK == DtlsHS_PrepareHandshake(&test_handshake));
+    TEST_CHECK(OCP_HL_OK != DtlsHS_Handshake(&test_handshake));
+    return 0;
+}
+
+static int test_replay_cached_cookie(void)
+{
+    test_setup(4433);
+    memset(test_server_cookie, 0xA1, sizeof(test_server_cookie));
+
+    //Nothing cached, the cookie of the HelloVerifyRequest is cached
+    TEST_CHECK(0 == test_handshake_run());
+    TEST_CHECK((2 == test_hello_count) && (0 == test_hellos[0]) && (0xA1 == test_hellos[1]));
+
+    //The first ClientHello carries the cached cookie
+    TEST_CHECK(0 == test_handshake_run());
+    TEST_CHECK((1 == test_hello_count) && (0xA1 == test_hellos[0]));
+
+    //The handshake with the replayed cookie failed, so the next one starts without cookie
+    TEST_CHECK(0 == test_handshake_run());
+    TEST_CHECK((2 == test_hello_count) && (0 == test_hellos[0]) && (0xA1 == test_hellos[1]));
+    return 0;
+}
+
+static int test_new_hello_verify_request(void)
+{
+    test_setup(4434);
+    memset(test_server_cookie, 0xB1, sizeof(test_server_cookie));
+    TEST_CHECK(0 == test_handshake_run());
+    TEST_CHECK((2 == test_hello_count) && (0xB1 == test_hellos[1]));
+
+    //The server changed its cookie, the cached one is answered with a new HelloVerifyRequest
+    memset(test_server_cookie, 0xB2, sizeof(test_server_cookie));
+    TEST_CHECK(0 == test_handshake_run());
+    TEST_CHECK((2 == test_hello_count) && (0xB1 == test_hellos[0]) && (0xB2 == test_hellos[1]));
+    return 0;
+}
+
+static int test_alternative_endpoints(void)
+{
+    static char_t address[] = "2001:db8::1";
+    static const sEndpoint_d endpoints[] = {{address, 4433}};
+
+    test_setup(4435);
+    memset(test_server_cookie, 0xC1, sizeof(test_server_cookie));
+    TEST_CHECK(0 == test_handshake_run());
+    TEST_CHECK((2 == test_hello_count) && (0xC1 == test_hellos[1]));
+
+    //The cookie may be sent to another endpoint, it is neither replayed nor cached
+    test_config_tl.sTL.psAltEndpoints = endpoints;
+    test_config_tl.sTL.bAltEndpointCount = 1;
+    memset(test_server_cookie, 0xC2, sizeof(test_server_cookie));
+    TEST_CHECK(0 == test_handshake_run());
+    TEST_CHECK((2 == test_hello_count) && (0 == test_hellos[0]) && (0xC2 == test_hellos[1]));
+
+    //The cookie cached before is still there for the endpoint alone
+    test_config_tl.sTL.psAltEndpoints = NULL;
+    test_config_tl.sTL.bAltEndpointCount = 0;
+    TEST_CHECK(0 == test_handshake_run());
+    TEST_CHECK((2 == test_hello_count) && (0xC1 == test_hellos[0]) && (0xC2 == test_hellos[1]));
+    return 0;
+}
+/// @endcond
+
+int main(void)
+{
+    int result = 0;
+
+    if (0 != test_replay_cached_cookie())
+    {
+        result = -1;
+    }
+    if (0 != test_new_hello_verify_request())
+    {
+        result = -1;
+    }
+    if (0 != test_alternative_endpoints())
+    {
+        result = -1;
+    }
+
+    printf("%s\n", (0 == result) ? "PASSED" : "FAILED");
+    return (0 == result) ? 0 : 1;
+}
+
+/**
+* @}
+*/
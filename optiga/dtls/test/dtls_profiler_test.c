@@ -0,0 +1,350 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file dtls_profiler_test.c
+*
+* \brief   Test of the handshake profiler. The handshake and record layers run on a fake clock against a fake
+*          Security Chip and a scripted server behind a fake transport layer. The server drops the first ClientHello,
+*          answers the retransmission with a HelloVerifyRequest and the ClientHello with cookie with a fatal alert.
+*          Every chip call, datagram sent and wait takes a known time and every read of the clock a millisecond of
+*          host time. The chip, send, receive, timeout and host times of the profile and of each phase must add up
+*          to their totals.
+*
+*          gcc -Ioptiga/include -DMODULE_ENABLE_DTLS_MUTUAL_AUTH -DENABLE_HANDSHAKE_PROFILER
+*              optiga/dtls/test/dtls_profiler_test.c optiga/dtls/DtlsProfiler.c optiga/dtls/DtlsHandshakeProtocol.c
+*              optiga/dtls/DtlsFlightHandler.c optiga/dtls/MessageLayer.c optiga/dtls/DtlsRecordLayer.c
+*              optiga/dtls/DtlsWindowing.c optiga/common/Util.c -o dtls_profiler_test
+*
+* \ingroup  grOCP
+* @{
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "optiga/dtls/DtlsProfiler.h"
+#include "optiga/dtls/DtlsHandshakeProtocol.h"
+#include "optiga/dtls/DtlsRecordLayer.h"
+#include "optiga/dtls/AlertProtocol.h"
+#include "optiga/dtls/MessageLayer.h"
+#include "optiga/cmd/CommandLib.h"
+
+#define TEST_CHECK(condition)                                               \
+    if (!(condition))                                                       \
+    {                                                                       \
+        printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition);       \
+        return -1;                                                          \
+    }
+
+/// @cond hidden
+#define TEST_COOKIE_LENGTH      (16)
+#define TEST_PROTOCOL_VERSION   (0xFEFD)
+
+//Times of the fake chip, transport and server in milliseconds
+#define TEST_GET_MESSAGE_MS     (25)
+#define TEST_PUT_MESSAGE_MS     (15)
+#define TEST_SEND_MS            (2)
+#define TEST_ROUND_TRIP_MS      (40)
+
+static uint32_t test_time;
+
+//Scripted server
+static uint8_t test_response[LENGTH_RL_HEADER + MSG_HEADER_LEN + 3 + TEST_COOKIE_LENGTH];
+static uint16_t test_response_length;
+static uint16_t test_server_sequence;
+static uint8_t test_hellos;
+
+//Fake Security Chip
+static uint8_t test_chip_cookie[TEST_COOKIE_LENGTH];
+static uint8_t test_chip_cookie_length;
+static uint16_t test_chip_sequence;
+static uint8_t test_chip_calls;
+
+static sConfigTL_d test_config_tl;
+static sConfigCL_d test_config_cl;
+static sConfigRL_d test_config_rl;
+static sHandshake_d test_handshake;
+static sHandshakeProfile_d test_profile;
+
+//Every read of the clock is a millisecond of host processing
+uint32_t pal_os_timer_get_time_in_milliseconds(void)
+{
+    return test_time++;
+}
+
+static void test_server_record(uint8_t PbContentType, const uint8_t* PpbFragment, uint16_t PwLen)
+{
+    memset(test_response, 0x00, LENGTH_RL_HEADER);
+    test_response[OFFSET_RL_CONTENTTYPE] = PbContentType;
+    Utility_SetUint16(test_response + OFFSET_RL_PROT_VERSION, TEST_PROTOCOL_VERSION);
+    Utility_SetUint16(test_response + OFFSET_RL_SEQUENCE + 4, test_server_sequence++);
+    Utility_SetUint16(test_response + OFFSET_RL_FRAG_LENGTH, PwLen);
+    memcpy(test_response + LENGTH_RL_HEADER, PpbFragment, PwLen);
+    test_response_length = LENGTH_RL_HEADER + PwLen;
+}
+
+//The server drops the first ClientHello, asks for a cookie and ends the handshake once it gets one
+static void test_server(const uint8_t* PpbRecord)
+{
+    static const uint8_t alert[] = {2, 40};
+    const uint8_t* p_hello = PpbRecord + LENGTH_RL_HEADER;
+    uint8_t message[MSG_HEADER_LEN + 3 + TEST_COOKIE_LENGTH];
+
+    if ((CONTENTTYPE_HANDSHAKE != PpbRecord[OFFSET_RL_CONTENTTYPE]) || (eClientHello != p_hello[0]))
+    {
+        return;
+    }
+    if (0 == test_hellos++)
+    {
+        return;
+    }
+    //Version(2), random(32), session id(1 + 0), cookie
+    if (0 != p_hello[MSG_HEADER_LEN + 35])
+    {
+        test_server_record(CONTENTTYPE_ALERT, alert, sizeof(alert));
+        return;
+    }
+
+    message[0] = eHello_Verify_Request;
+    Utility_SetUint24(message + 1, 3 + TEST_COOKIE_LENGTH);
+    Utility_SetUint16(message + 4, Utility_GetUint16(p_hello + 4));
+    Utility_SetUint24(message + 6, 0);
+    Utility_SetUint24(message + 9, 3 + TEST_COOKIE_LENGTH);
+    Utility_SetUint16(message + MSG_HEADER_LEN, TEST_PROTOCOL_VERSION);
+    message[MSG_HEADER_LEN + 2] = TEST_COOKIE_LENGTH;
+    memset(message + MSG_HEADER_LEN + 3, 0x5C, TEST_COOKIE_LENGTH);
+    test_server_record(CONTENTTYPE_HANDSHAKE, message, sizeof(message));
+}
+
+static int32_t test_tl_send(const sTL_d* PpsTL, uint8_t* PpbBuffer, uint16_t PwLen)
+{
+    (void)PpsTL;
+    (void)PwLen;
+    test_time += TEST_SEND_MS;
+    test_server(PpbBuffer);
+    return (int32_t)OCP_TL_OK;
+}
+
+static int32_t test_tl_send_owned(const sTL_d* PpsTL, uint8_t* PpbBuffer, uint16_t PwLen)
+{
+    int32_t i4Status = test_tl_send(PpsTL, PpbBuffer, PwLen);
+
+    OCP_FREE(PpbBuffer);
+    return i4Status;
+}
+
+//A response arrives after the round trip, else the wait lasts till the timeout of the transport layer
+static int32_t test_tl_recv(const sTL_d* PpsTL, uint8_t* PpbBuffer, uint16_t* PpwLen)
+{
+    if (0 == test_response_length)
+    {
+        test_time += PpsTL->wTimeout;
+        return (int32_t)OCP_TL_NO_DATA;
+    }
+    test_time += TEST_ROUND_TRIP_MS;
+    memcpy(PpbBuffer, test_response, test_response_length);
+    *PpwLen = test_response_length;
+    test_response_length = 0;
+    return (int32_t)OCP_TL_OK;
+}
+
+//The Security Chip puts the cookie of the last HelloVerifyRequest into a ClientHello with cookie
+int32_t CmdLib_GetMessage(const sProcMsgData_d *PpsGMsgVector)
+{
+    uint8_t message[MSG_HEADER_LEN + 35 + 1 + TEST_COOKIE_LENGTH + 4 + 2];
+    uint16_t length;
+    sbBlob_d blob;
+
+    test_time += TEST_GET_MESSAGE_MS;
+    test_chip_calls++;
+    if (eClientHello == PpsGMsgVector->eParam)
+    {
+        test_chip_sequence = 0;
+        test_chip_cookie_length = 0;
+    }
+    else if (eClientHelloWithCookie != PpsGMsgVector->eParam)
+    {
+        return (int32_t)CMD_LIB_ERROR;
+    }
+
+    memset(message, 0x00, sizeof(message));
+    Utility_SetUint16(message + MSG_HEADER_LEN, TEST_PROTOCOL_VERSION);
+    length = 35;
+    message[MSG_HEADER_LEN + length++] = test_chip_cookie_length;
+    memcpy(message + MSG_HEADER_LEN + length, test_chip_cookie, test_chip_cookie_length);
+    length += test_chip_cookie_length;
+    //One cipher suite, no compression
+    Utility_SetUint16(message + MSG_HEADER_LEN + length, 2);
+    Utility_SetUint16(message + MSG_HEADER_LEN + length + 2, 0xC0AE);
+    length += 4;
+    message[MSG_HEADER_LEN + length++] = 1;
+    message[MSG_HEADER_LEN + length++] = 0;
+
+    message[0] = eClientHello;
+    Utility_SetUint24(message + 1, length);
+    Utility_SetUint16(message + 4, test_chip_sequence++);
+    Utility_SetUint24(message + 9, length);
+
+    blob.prgbStream = message;
+    blob.wLen = (uint16_t)(MSG_HEADER_LEN + length);
+    return PpsGMsgVector->psCallBack->pfAcceptMessage(PpsGMsgVector->psCallBack->fvParams, &blob);
+}
+
+int32_t CmdLib_PutMessage(const sProcMsgData_d *PpsPMsgVector)
+{
+    const uint8_t * p_body = PpsPMsgVector->psBlobInBuffer->prgbStream + OVERHEAD_LEN;
+
+    test_time += TEST_PUT_MESSAGE_MS;
+    test_chip_calls++;
+    if (eHelloVerifyRequest != PpsPMsgVector->eParam)
+    {
+        return (int32_t)CMD_LIB_ERROR;
+    }
+    test_chip_cookie_length = p_body[2];
+    memcpy(test_chip_cookie, p_body + 3, test_chip_cookie_length);
+    return (int32_t)CMD_LIB_OK;
+}
+
+int32_t Alert_ProcessMsg(const sbBlob_d* PpsAlertMsg, int32_t* Ppi4ErrorCode)
+{
+    (void)PpsAlertMsg;
+    *Ppi4ErrorCode = (int32_t)OCP_AL_FATAL_ERROR;
+    return (int32_t)OCP_AL_OK;
+}
+
+void Alert_Send(sConfigRL_d *PpsConfigRL, int32_t Pi4ErrorCode)
+{
+    (void)PpsConfigRL;
+    (void)Pi4ErrorCode;
+}
+
+static int test_open(void)
+{
+    memset(&test_config_tl, 0x00, sizeof(test_config_tl));
+    test_config_tl.pfSend = test_tl_send;
+    test_config_tl.pfSendOwned = test_tl_send_owned;
+    test_config_tl.pfRecv = test_tl_recv;
+    test_config_tl.sTL.wTimeout = 200;
+
+    //Records are not encrypted before the change cipher spec
+    memset(&test_config_cl, 0x00, sizeof(test_config_cl));
+
+    memset(&test_config_rl, 0x00, sizeof(test_config_rl));
+    test_config_rl.pfInit = DtlsRL_Init;
+    test_config_rl.pfSend = DtlsRL_Send;
+    test_config_rl.pfRecv = DtlsRL_Recv;
+    test_config_rl.pfClose = DtlsRL_Close;
+    test_config_rl.sRL.psConfigTL = &test_config_tl;
+    test_config_rl.sRL.psConfigCL = &test_config_cl;
+    TEST_CHECK(OCP_RL_OK == DtlsRL_Init(&test_config_rl.sRL));
+
+    memset(&test_handshake, 0x00, sizeof(test_handshake));
+    test_handshake.eMode = eClient;
+    test_handshake.wMaxPmtu = 1280;
+    test_handshake.psConfigRL = &test_config_rl;
+    test_handshake.eAuthState = eAuthInitialised;
+    test_handshake.wSessionOID = 0xE100;
+    test_handshake.dwReplayedMsgSeqNum = 0xFFFFFFFF;
+    return 0;
+}
+
+static int test_times_add_up(void)
+{
+    int32_t i4Status;
+    uint32_t dwChip = 0;
+    uint32_t dwPhases = 0;
+    uint8_t bIndex;
+    const sProfilePhase_d* psPhase;
+
+    TEST_CHECK(0 == test_open());
+    test_time = 1000;
+
+    //As OCP_Connect() does
+    DtlsProf_Start(&test_profile);
+    i4Status = DtlsHS_PrepareHandshake(&test_handshake);
+    if (OCP_HL_OK == i4Status)
+    {
+        i4Status = DtlsHS_Handshake(&test_handshake);
+    }
+    DtlsProf_Stop(i4Status);
+    DtlsRL_Close(&test_config_rl.sRL);
+
+    //The handshake ran into the alert after the ClientHello with cookie, sent after a retransmission
+    TEST_CHECK((int32_t)OCP_AL_FATAL_ERROR == test_profile.i4Status);
+    TEST_CHECK(3 == test_hellos);
+    TEST_CHECK(1 == test_profile.bRetransmissions);
+    TEST_CHECK(0 == test_profile.bDropped);
+
+    //Every time of the handshake is accounted for once
+    TEST_CHECK(test_profile.dwTotal == (test_profile.dwChip + test_profile.dwSend + test_profile.dwRecv +
+                                        test_profile.dwTimeout + test_profile.dwHost));
+    TEST_CHECK(0 != test_profile.dwHost);
+    TEST_CHECK(test_profile.dwTimeout >= 200);
+    TEST_CHECK(test_profile.dwRecv >= (2 * TEST_ROUND_TRIP_MS));
+    TEST_CHECK(test_profile.dwSend >= (3 * TEST_SEND_MS));
+
+    //The chip calls are recorded one by one
+    TEST_CHECK(test_chip_calls == test_profile.bMessageCount);
+    for (bIndex = 0; bIndex < test_profile.bMessageCount; bIndex++)
+    {
+        dwChip += test_profile.rgsMessage[bIndex].dwTime;
+    }
+    TEST_CHECK(dwChip == test_profile.dwChip);
+    TEST_CHECK(dwChip >= ((2 * TEST_GET_MESSAGE_MS) + TEST_PUT_MESSAGE_MS));
+
+    //The phases add up the same way and follow each other after the setup
+    TEST_CHECK(0 != test_profile.bPhaseCount);
+    for (bIndex = 0; bIndex < test_profile.bPhaseCount; bIndex++)
+    {
+        psPhase = &test_profile.rgsPhase[bIndex];
+        TEST_CHECK(psPhase->dwTotal == (psPhase->dwChip + psPhase->dwSend + psPhase->dwRecv + psPhase->dwHost));
+        TEST_CHECK(psPhase->dwStart >= (test_profile.dwSetup + dwPhases));
+        dwPhases += psPhase->dwTotal;
+    }
+    TEST_CHECK((test_profile.dwSetup + dwPhases) <= test_profile.dwTotal);
+    return 0;
+}
+/// @endcond
+
+int main(void)
+{
+    int result = 0;
+
+    if (0 != test_times_add_up())
+    {
+        result = -1;
+    }
+
+    printf("%s\n", (0 == result) ? "PASSED" : "FAILED");
+    return (0 == result) ? 0 : 1;
+}
+
+/**
+* @}
+*/
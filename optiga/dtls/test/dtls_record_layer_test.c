@@ -0,0 +1,375 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file dtls_record_layer_test.c
+*
+* \brief   Test of the record layer receiving datagrams without copying. A fake transport layer hands out a datagram
+*          split over segments, as a chain of network stack buffers, with records inside one segment and records
+*          crossing segments. Records built by the record layer are handed over to the transport layer, records in
+*          a buffer of the caller are only lent to it. A Finished of the next epoch received before the change cipher
+*          spec of the server is decrypted and passed up, once the client has sent its own change cipher spec.
+*
+*          gcc -Ioptiga/include -DMODULE_ENABLE_DTLS_MUTUAL_AUTH optiga/dtls/test/dtls_record_layer_test.c
+*              optiga/dtls/DtlsRecordLayer.c optiga/dtls/DtlsWindowing.c optiga/common/Util.c -o dtls_record_layer_test
+*
+* \ingroup  grOCP
+* @{
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "optiga/dtls/DtlsRecordLayer.h"
+
+#define TEST_CHECK(condition)                                               \
+    if (!(condition))                                                       \
+    {                                                                       \
+        printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition);       \
+        return -1;                                                          \
+    }
+
+/// @cond hidden
+#define TEST_RECORDS            (3)
+#define TEST_FRAGMENT_LENGTH    (20)
+#define TEST_RECORD_LENGTH      (LENGTH_RL_HEADER + TEST_FRAGMENT_LENGTH)
+#define TEST_PROTOCOL_VERSION   (0xFEFD)
+
+//Segment boundaries: record 0 in segment 0, record 1 crossing into segment 1 and 2, record 2 in segment 2
+static const uint16_t test_segment_lengths[] = {40, 10, TEST_RECORDS * TEST_RECORD_LENGTH - 50};
+
+static uint8_t test_wire[TEST_RECORDS * TEST_RECORD_LENGTH];
+static uint8_t test_segments[sizeof(test_segment_lengths) / sizeof(test_segment_lengths[0])][TEST_RECORDS * TEST_RECORD_LENGTH];
+static uint8_t test_received;
+static uint8_t test_released;
+static uint16_t test_sequence;
+
+static void test_build_wire(void)
+{
+    uint8_t record;
+    uint8_t * p_record;
+
+    memset(test_wire, 0x00, sizeof(test_wire));
+    for (record = 0; record < TEST_RECORDS; record++)
+    {
+        p_record = test_wire + record * TEST_RECORD_LENGTH;
+        p_record[OFFSET_RL_CONTENTTYPE] = CONTENTTYPE_HANDSHAKE;
+        Utility_SetUint16(p_record + OFFSET_RL_PROT_VERSION, TEST_PROTOCOL_VERSION);
+        Utility_SetUint16(p_record + OFFSET_RL_SEQUENCE + 4, test_sequence++);
+        Utility_SetUint16(p_record + OFFSET_RL_FRAG_LENGTH, TEST_FRAGMENT_LENGTH);
+        memset(p_record + OFFSET_RL_FRAGMENT, 0xA0 + record, TEST_FRAGMENT_LENGTH);
+    }
+}
+
+static int32_t test_recv_datagram(const sTL_d * p_tl, sDatagram_d * p_datagram)
+{
+    uint8_t segment;
+    uint16_t offset = 0;
+
+    (void)p_tl;
+    memset(p_datagram, 0x00, sizeof(*p_datagram));
+    for (segment = 0; segment < sizeof(test_segment_lengths) / sizeof(test_segment_lengths[0]); segment++)
+    {
+        //Every segment in its own buffer, so that only the record layer can join them
+        memcpy(test_segments[segment], test_wire + offset, test_segment_lengths[segment]);
+        p_datagram->rgpbSegment[segment] = test_segments[segment];
+        p_datagram->rgwSegmentLen[segment] = test_segment_lengths[segment];
+        offset += test_segment_lengths[segment];
+    }
+    p_datagram->bSegmentCount = segment;
+    p_datagram->wLen = offset;
+    p_datagram->pvHandle = test_segments;
+    test_received++;
+    return OCP_TL_OK;
+}
+
+static void test_release_datagram(const sTL_d * p_tl, sDatagram_d * p_datagram)
+{
+    (void)p_tl;
+    if (test_segments == p_datagram->pvHandle)
+    {
+        test_released++;
+    }
+}
+
+static uint8_t * test_owned;
+static uint16_t test_owned_length;
+static uint8_t test_lent;
+
+static int32_t test_send_owned(const sTL_d * p_tl, uint8_t * p_buffer, uint16_t length)
+{
+    (void)p_tl;
+    test_owned = p_buffer;
+    test_owned_length = length;
+    return OCP_TL_OK;
+}
+
+static int32_t test_send(const sTL_d * p_tl, uint8_t * p_buffer, uint16_t length)
+{
+    (void)p_tl;
+    (void)p_buffer;
+    (void)length;
+    test_lent++;
+    return OCP_TL_OK;
+}
+
+//Flight of the server with the Finished (epoch 1) ahead of the change cipher spec (epoch 0)
+#define TEST_NONCE_LENGTH       (8)
+#define TEST_MAC_LENGTH         (8)
+#define TEST_FINISHED_LENGTH    (12 + 12)
+#define TEST_FINISHED_RECORD    (LENGTH_RL_HEADER + TEST_NONCE_LENGTH + TEST_FINISHED_LENGTH + TEST_MAC_LENGTH)
+#define TEST_CCS_RECORD         (LENGTH_RL_HEADER + 1)
+
+static uint8_t test_flight[TEST_FINISHED_RECORD + TEST_CCS_RECORD];
+static uint8_t test_decrypted;
+
+static void test_build_flight(void)
+{
+    uint8_t * p_record = test_flight;
+
+    memset(test_flight, 0x00, sizeof(test_flight));
+    p_record[OFFSET_RL_CONTENTTYPE] = CONTENTTYPE_HANDSHAKE;
+    Utility_SetUint16(p_record + OFFSET_RL_PROT_VERSION, TEST_PROTOCOL_VERSION);
+    Utility_SetUint16(p_record + OFFSET_RL_EPOCH, 1);
+    Utility_SetUint16(p_record + OFFSET_RL_FRAG_LENGTH, TEST_FINISHED_RECORD - LENGTH_RL_HEADER);
+    memset(p_record + OFFSET_RL_FRAGMENT + TEST_NONCE_LENGTH, 0x14, TEST_FINISHED_LENGTH);
+
+    p_record += TEST_FINISHED_RECORD;
+    p_record[OFFSET_RL_CONTENTTYPE] = CONTENTTYPE_CIPHER_SPEC;
+    Utility_SetUint16(p_record + OFFSET_RL_PROT_VERSION, TEST_PROTOCOL_VERSION);
+    Utility_SetUint16(p_record + OFFSET_RL_SEQUENCE + 4, 5);
+    Utility_SetUint16(p_record + OFFSET_RL_FRAG_LENGTH, 1);
+    p_record[OFFSET_RL_FRAGMENT] = 0x01;
+}
+
+static int32_t test_recv_flight(const sTL_d * p_tl, sDatagram_d * p_datagram)
+{
+    (void)p_tl;
+    memset(p_datagram, 0x00, sizeof(*p_datagram));
+    p_datagram->rgpbSegment[0] = test_flight;
+    p_datagram->rgwSegmentLen[0] = sizeof(test_flight);
+    p_datagram->bSegmentCount = 1;
+    p_datagram->wLen = sizeof(test_flight);
+    p_datagram->pvHandle = test_flight;
+    test_received++;
+    return OCP_TL_OK;
+}
+
+//Strips the explicit nonce and the MAC, the record follows the space reserved for the command header
+static int32_t test_decrypt(const sCL_d * p_cl, const sbBlob_d * p_cipher, sbBlob_d * p_plain, uint16_t length)
+{
+    const uint8_t * p_record = p_cipher->prgbStream + OVERHEAD_UPDOWNLINK;
+    uint16_t message_length = length - (LENGTH_RL_HEADER + TEST_NONCE_LENGTH + TEST_MAC_LENGTH);
+
+    (void)p_cl;
+    memmove(p_plain->prgbStream, p_record, LENGTH_RL_HEADER);
+    memmove(p_plain->prgbStream + LENGTH_RL_HEADER, p_record + LENGTH_RL_HEADER + TEST_NONCE_LENGTH, message_length);
+    p_plain->wLen = LENGTH_RL_HEADER + message_length;
+    test_decrypted++;
+    return OCP_CL_OK;
+}
+
+static sConfigTL_d test_config_tl;
+static sConfigCL_d test_config_cl;
+static sRL_d test_rl;
+
+static int test_open(void)
+{
+    memset(&test_config_tl, 0x00, sizeof(test_config_tl));
+    test_config_tl.pfRecvDatagram = test_recv_datagram;
+    test_config_tl.pfReleaseDatagram = test_release_datagram;
+    test_config_tl.pfSend = test_send;
+    test_config_tl.pfSendOwned = test_send_owned;
+
+    //Records are not encrypted, no decryption is called
+    memset(&test_config_cl, 0x00, sizeof(test_config_cl));
+
+    memset(&test_rl, 0x00, sizeof(test_rl));
+    test_rl.psConfigTL = &test_config_tl;
+    test_rl.psConfigCL = &test_config_cl;
+    TEST_CHECK(OCP_RL_OK == DtlsRL_Init(&test_rl));
+    test_rl.bContentType = CONTENTTYPE_HANDSHAKE;
+    test_received = 0;
+    test_released = 0;
+    return 0;
+}
+
+static int test_records_across_segments(void)
+{
+    uint8_t buffer[TEST_RECORD_LENGTH];
+    uint8_t expected[TEST_FRAGMENT_LENGTH];
+    uint16_t length;
+    uint8_t record;
+
+    TEST_CHECK(0 == test_open());
+    test_build_wire();
+
+    for (record = 0; record < TEST_RECORDS; record++)
+    {
+        length = sizeof(buffer);
+        TEST_CHECK(OCP_RL_OK == DtlsRL_Recv(&test_rl, buffer, &length));
+        TEST_CHECK(TEST_FRAGMENT_LENGTH == length);
+        memset(expected, 0xA0 + record, sizeof(expected));
+        TEST_CHECK(0 == memcmp(buffer, expected, sizeof(expected)));
+
+        //One datagram for all records, given back with the last one
+        TEST_CHECK(1 == test_received);
+        TEST_CHECK(((TEST_RECORDS - 1 == record) ? 1 : 0) == test_released);
+    }
+    DtlsRL_Close(&test_rl);
+    TEST_CHECK(1 == test_released);
+    return 0;
+}
+
+static int test_record_too_long_for_buffer(void)
+{
+    uint8_t buffer[TEST_RECORD_LENGTH - 1];
+    uint16_t length = sizeof(buffer);
+
+    TEST_CHECK(0 == test_open());
+    test_build_wire();
+
+    //The record does not fit into the buffer the message is returned in
+    TEST_CHECK((int32_t)OCP_RL_INVALID_RECORD_LENGTH == DtlsRL_Recv(&test_rl, buffer, &length));
+    TEST_CHECK(0 == test_released);
+
+    //The records left over are dropped on close
+    DtlsRL_Close(&test_rl);
+    TEST_CHECK(1 == test_released);
+    return 0;
+}
+
+static int test_finished_before_change_cipher_spec(void)
+{
+    uint8_t ccs = 0x01;
+    uint8_t buffer[TEST_FINISHED_RECORD];
+    uint8_t expected[TEST_FINISHED_LENGTH];
+    uint16_t length;
+
+    //Before the client sends its change cipher spec, a record of the next epoch cannot be decrypted
+    TEST_CHECK(0 == test_open());
+    test_config_tl.pfRecvDatagram = test_recv_flight;
+    test_config_cl.pfDecrypt = test_decrypt;
+    test_build_flight();
+    test_decrypted = 0;
+    length = sizeof(buffer);
+    TEST_CHECK((int32_t)OCP_RL_INCORRECT_EPOCH == DtlsRL_Recv(&test_rl, buffer, &length));
+    TEST_CHECK(0 == test_decrypted);
+    DtlsRL_Close(&test_rl);
+
+    //The client sends its change cipher spec with flight 5, it moves to the next epoch
+    TEST_CHECK(0 == test_open());
+    test_config_tl.pfRecvDatagram = test_recv_flight;
+    test_config_cl.pfDecrypt = test_decrypt;
+    test_rl.bContentType = CONTENTTYPE_CIPHER_SPEC;
+    test_rl.bMemoryAllocated = FALSE;
+    test_owned = NULL;
+    TEST_CHECK(OCP_RL_OK == DtlsRL_Send(&test_rl, &ccs, sizeof(ccs)));
+    free(test_owned);
+    test_rl.bContentType = CONTENTTYPE_HANDSHAKE;
+
+    //The Finished ahead of the change cipher spec of the server is decrypted and passed up, not dropped
+    length = sizeof(buffer);
+    TEST_CHECK(OCP_RL_OK == DtlsRL_Recv(&test_rl, buffer, &length));
+    TEST_CHECK(1 == test_decrypted);
+    TEST_CHECK(0x01 == test_rl.bDecRecord);
+    TEST_CHECK(TEST_FINISHED_LENGTH == length);
+    memset(expected, 0x14, sizeof(expected));
+    TEST_CHECK(0 == memcmp(buffer, expected, sizeof(expected)));
+    TEST_CHECK(CCS_RECORD_NOTRECV == test_rl.bRecvCCSRecord);
+
+    //The change cipher spec which follows is taken from the same datagram
+    length = sizeof(buffer);
+    TEST_CHECK(OCP_RL_OK == DtlsRL_Recv(&test_rl, buffer, &length));
+    TEST_CHECK((1 == length) && (0x01 == buffer[0]));
+    TEST_CHECK(0x00 == test_rl.bDecRecord);
+    TEST_CHECK(CCS_RECORD_RECV == test_rl.bRecvCCSRecord);
+    TEST_CHECK(1 == test_received);
+
+    DtlsRL_Close(&test_rl);
+    return 0;
+}
+
+static int test_send_hands_over_record(void)
+{
+    uint8_t message[TEST_FRAGMENT_LENGTH];
+    uint8_t record[TEST_RECORD_LENGTH];
+
+    TEST_CHECK(0 == test_open());
+    memset(message, 0x5A, sizeof(message));
+    test_owned = NULL;
+    test_lent = 0;
+
+    //The record is built in memory of the record layer, which goes to the transport layer
+    test_rl.bMemoryAllocated = FALSE;
+    TEST_CHECK(OCP_RL_OK == DtlsRL_Send(&test_rl, message, sizeof(message)));
+    TEST_CHECK((NULL != test_owned) && (TEST_RECORD_LENGTH == test_owned_length) && (0 == test_lent));
+    TEST_CHECK(CONTENTTYPE_HANDSHAKE == test_owned[OFFSET_RL_CONTENTTYPE]);
+    TEST_CHECK(0 == memcmp(test_owned + OFFSET_RL_FRAGMENT, message, sizeof(message)));
+    free(test_owned);
+
+    //The record in the buffer of the handshake layer is kept for retransmission and only lent
+    test_owned = NULL;
+    test_rl.bMemoryAllocated = TRUE;
+    memcpy(record + OFFSET_RL_FRAGMENT, message, sizeof(message));
+    TEST_CHECK(OCP_RL_OK == DtlsRL_Send(&test_rl, record, sizeof(record)));
+    TEST_CHECK((NULL == test_owned) && (1 == test_lent));
+
+    DtlsRL_Close(&test_rl);
+    return 0;
+}
+/// @endcond
+
+int main(void)
+{
+    int result = 0;
+
+    if (0 != test_records_across_segments())
+    {
+        result = -1;
+    }
+    if (0 != test_record_too_long_for_buffer())
+    {
+        result = -1;
+    }
+    if (0 != test_send_hands_over_record())
+    {
+        result = -1;
+    }
+    if (0 != test_finished_before_change_cipher_spec())
+    {
+        result = -1;
+    }
+
+    printf("%s\n", (0 == result) ? "PASSED" : "FAILED");
+    return (0 == result) ? 0 : 1;
+}
+
+/**
+* @}
+*/
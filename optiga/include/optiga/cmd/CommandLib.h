@@ -156,7 +156,16 @@ LIBRARY_EXPORTS int32_t CmdLib_OpenApplication(const sOpenApp_d* PpsOpenApp);
 
 /// @cond hidden
 LIBRARY_EXPORTS void CmdLib_SetOptigaCommsContext(const optiga_comms_t *p_input_optiga_comms);
+LIBRARY_EXPORTS optiga_comms_t* CmdLib_GetOptigaCommsContext(void);
 /// @endcond 
+
+///Function pointer notified about a data object or key changed on the chip of PpsComms, 0x0000 for all of them
+typedef Void (*fObjectChanged_d)(const optiga_comms_t* PpsComms, uint16_t PwOID);
+
+/**
+ * \brief Sets the handler notified about the data objects, metadata and keys changed through the command library.
+ */
+LIBRARY_EXPORTS void CmdLib_SetObjectChangedHandler(fObjectChanged_d PfHandler);
 /****************************************************************************
  *
  * Definitions related to GetDataObject and SetDataObject commands.
@@ -188,6 +197,24 @@ typedef enum eWriteOption_d
     eERASE_AND_WRITE
 }eWriteOption_d;
 
+/**
+ * \brief Function to copy the next PwLen bytes of the input data into the command APDU.
+ *        Returns the number of bytes copied, less than PwLen if the input data is exhausted.
+ */
+typedef uint16_t (*fGatherData_d)(Void* PpCtx, uint8_t* PprgbDest, uint16_t PwLen);
+
+/**
+ * \brief Structure to specify input data held in several buffers, copied directly into the command APDUs.
+ */
+typedef struct sDataGather_d
+{
+    ///Function copying the data in order
+    fGatherData_d pfGather;
+
+    ///Context of the function, e.g. the array of buffers and the current position
+    Void* pCtx;
+}sDataGather_d;
+
 /**
  * \brief Structure to specify GetDataObject command parameters.
  */
@@ -242,6 +269,11 @@ LIBRARY_EXPORTS int32_t CmdLib_GetDataObject(const sGetData_d *PpsGDVector, sCmd
  */
 LIBRARY_EXPORTS int32_t CmdLib_SetDataObject(const sSetData_d *PpsSDVector);
 
+/**
+ * \brief Writes to the specified data object by issuing SetDataObject command, with the data held in several buffers.
+ */
+LIBRARY_EXPORTS int32_t CmdLib_SetDataObjectVector(const sSetData_d *PpsSDVector, const sDataGather_d *PpsGather);
+
 /**
  * \brief Reads maximum communication buffer size supported by the security chip. 
  */
@@ -678,6 +710,11 @@ typedef struct sDeriveKeyOptions_d
  */
 LIBRARY_EXPORTS int32_t CmdLib_CalcHash(sCalcHash_d* PpsCalcHash);
 
+/**
+ * \brief Calculates the hash on input data held in several buffers by issuing CalcHash command to Security Chip.
+ */
+LIBRARY_EXPORTS int32_t CmdLib_CalcHashVector(sCalcHash_d* PpsCalcHash, const sDataGather_d* PpsGather);
+
 /**
  * \brief Verify the signature on digest by issuing VerifySign command to Security Chip. 
  */
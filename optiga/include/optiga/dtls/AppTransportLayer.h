@@ -0,0 +1,91 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+*
+* \file
+*
+* \brief   This file defines APIs of the transport layer which uses a transport owned by the application.
+*
+* \ingroup  grOCP
+* @{
+*/
+#ifndef __APPTL_H__
+#define __APPTL_H__
+
+#include "optiga/dtls/OcpTransportLayer.h"
+#include "optiga/dtls/OcpCommonIncludes.h"
+
+#ifdef MODULE_ENABLE_DTLS_MUTUAL_AUTH
+
+/**
+ * \brief This function initializes the transport layer communication structure.
+ */
+int32_t AppTL_Init(sTL_d* PpsTL);
+
+/**
+ * \brief This function starts accepting the datagrams fed by the application.
+ */
+int32_t AppTL_Connect(sTL_d* PpsTL);
+
+/**
+ * \brief This function passes the data to the application for transmission.
+ */
+int32_t AppTL_Send(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t PwLen);
+
+/**
+ * \brief This function hands a buffer allocated by the record layer over to the application for transmission.
+ */
+int32_t AppTL_SendOwned(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t PwLen);
+
+/**
+ * \brief This function receives the next datagram fed by the application into a buffer.
+ */
+int32_t AppTL_Recv(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t* PpwLen);
+
+/**
+ * \brief This function lends the next datagram fed by the application to the record layer.
+ */
+int32_t AppTL_RecvDatagram(const sTL_d* PpsTL,sDatagram_d* PpsDatagram);
+
+/**
+ * \brief This function gives a datagram received with #AppTL_RecvDatagram back to the application.
+ */
+void AppTL_ReleaseDatagram(const sTL_d* PpsTL,sDatagram_d* PpsDatagram);
+
+/**
+ * \brief This function queues an inbound datagram by reference.
+ */
+int32_t AppTL_Feed(const sTL_d* PpsTL,const uint8_t* PprgbData,uint16_t PwLen);
+
+/**
+ * \brief This function returns the pending datagrams to the application and releases all the resources.
+ */
+void AppTL_Disconnect(sTL_d* PpsTL);
+
+#endif /* MODULE_ENABLE_DTLS_MUTUAL_AUTH */
+#endif //__APPTL_H__
+
+/**
+* @}
+*/
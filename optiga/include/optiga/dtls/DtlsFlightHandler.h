@@ -161,11 +161,26 @@ void DtlsHS_GetFlightMsgInfo(uint8_t PeFlightID, uint16_t** PpwMessageList);
  */
 int32_t DtlsHS_Flight2CheckMsgSeqNum(uint8_t PbRxMsgID, uint16_t PwRxMsgSeqNum, const sMsgInfo_d *PpsMessageList);
 
+/**
+ * \brief  Gets the messages of flight 1 from the security chip without sending them.
+ */
+int32_t DtlsHS_Flight1Prepare(sFlightStats_d* PpsThisFlight, const sMsgLyr_d* PpsMessageLayer);
+
 /**
  * \brief  Flight one handler to process flight 1 messages.
  */
 int32_t DtlsHS_Flight1Handler(uint8_t PbLastProcFlight, sFlightStats_d* PpThisFlight, sMsgLyr_d* PpsMessageLayer);
 
+/**
+ * \brief  Passes the HelloVerifyRequest cached for the server to the security chip.
+ */
+int32_t DtlsHS_Flight2Replay(sMsgLyr_d* PpsMessageLayer);
+
+/**
+ * \brief  Removes the HelloVerifyRequest cached for the server.
+ */
+void DtlsHS_Flight2Forget(const sMsgLyr_d* PpsMessageLayer);
+
 /**
  * \brief  Flight two handler to process flight 2 messages.
  */
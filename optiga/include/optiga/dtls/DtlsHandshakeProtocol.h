@@ -346,6 +346,16 @@ int32_t DtlsHS_PrepareMsgHeader(uint8_t* PpbMsgHeader, const sMsgInfo_d *sMsgInf
  */
 int32_t DtlsHS_Handshake(sHandshake_d* PphHandshake);
 
+/**
+ * \brief Prepares the first flight of the (D)TLS handshake before the transport is connected
+ */
+int32_t DtlsHS_PrepareHandshake(sHandshake_d* PphHandshake);
+
+/**
+ * \brief Releases the first flight prepared and not sent
+ */
+int32_t DtlsHS_ReleaseHandshake(sHandshake_d* PphHandshake);
+
 /**
  * \brief Sends a message to the server.
  */
@@ -0,0 +1,227 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+*
+*
+* \file
+*
+* \brief   This file defines the types and APIs of the DTLS handshake profiler, which breaks the time of
+*          OCP_Connect() down into chip, host and network time per flight and per chip call.
+*
+* \ingroup  grMutualAuth
+* @{
+*/
+
+#ifndef __DTLSPROFILER_H__
+#define __DTLSPROFILER_H__
+
+#include "optiga/common/Datatypes.h"
+#include "optiga/dtls/OcpCommonIncludes.h"
+
+#ifdef MODULE_ENABLE_DTLS_MUTUAL_AUTH
+
+///Maximum number of flight phases recorded, retransmissions included
+#define DTLS_PROFILE_MAX_PHASES         16
+
+///Maximum number of chip calls recorded
+#define DTLS_PROFILE_MAX_MESSAGES       32
+
+///Phase index of the chip calls before the first flight
+#define DTLS_PROFILE_NO_PHASE           0xFF
+
+/**
+ * \brief Enumeration of the timed operations.
+ */
+typedef enum eProfileEvent_d
+{
+    ///Command to the security chip
+    eProfileChip,
+    ///Datagram sent over the transport layer
+    eProfileSend,
+    ///Wait for a datagram on the transport layer
+    eProfileRecv
+}eProfileEvent_d;
+
+/**
+ * \brief Enumeration of the chip calls recorded.
+ */
+typedef enum eProfileOperation_d
+{
+    ///Get message, the chip forms a handshake message
+    eProfileGetMessage,
+    ///Put message, the chip processes a handshake message
+    eProfilePutMessage,
+    ///Encryption of a record
+    eProfileEncrypt,
+    ///Decryption of a record
+    eProfileDecrypt,
+    ///Set authentication scheme, before the first flight
+    eProfileSetAuthScheme
+}eProfileOperation_d;
+
+/**
+ * \brief Time of a flight sent or received once. All times are in milliseconds.
+ */
+typedef struct sProfilePhase_d
+{
+    ///Flight sent or received, as numbered by eFlight_d
+    uint8_t bFlight;
+    ///TRUE if the flight is received, FALSE if it is sent
+    bool_t fReceive;
+    ///TRUE if the flight is sent again after a timeout
+    bool_t fRetransmission;
+    ///TRUE if the flight was not received before the retransmission timeout
+    bool_t fTimeout;
+    ///Number of datagrams sent
+    uint8_t bDatagramsSent;
+    ///Number of datagrams received
+    uint8_t bDatagramsReceived;
+    ///Start of the phase, relative to the start of OCP_Connect()
+    uint32_t dwStart;
+    ///Duration of the phase
+    uint32_t dwTotal;
+    ///Time spent in chip commands
+    uint32_t dwChip;
+    ///Time spent sending datagrams
+    uint32_t dwSend;
+    ///Time spent waiting for datagrams, network round trip and server processing
+    uint32_t dwRecv;
+    ///Remaining time, spent in host processing
+    uint32_t dwHost;
+}sProfilePhase_d;
+
+/**
+ * \brief Time of a chip call.
+ */
+typedef struct sProfileMessage_d
+{
+    ///Index of the phase in sHandshakeProfile_d, #DTLS_PROFILE_NO_PHASE before the first flight
+    uint8_t bPhase;
+    ///Chip call, from eProfileOperation_d
+    uint8_t bOperation;
+    ///Handshake message type, 0 for records and set authentication scheme
+    uint8_t bMsgType;
+    ///Length of the message or record
+    uint16_t wLen;
+    ///Start of the call, relative to the start of OCP_Connect()
+    uint32_t dwStart;
+    ///Duration of the call
+    uint32_t dwTime;
+}sProfileMessage_d;
+
+/**
+ * \brief Profile of one OCP_Connect(). All times are in milliseconds.
+ */
+typedef struct sHandshakeProfile_d
+{
+    ///Status returned by OCP_Connect()
+    int32_t i4Status;
+    ///Duration of OCP_Connect()
+    uint32_t dwTotal;
+    ///Time before the first flight, transport connect and set authentication scheme
+    uint32_t dwSetup;
+    ///Time spent in chip commands
+    uint32_t dwChip;
+    ///Time spent sending datagrams
+    uint32_t dwSend;
+    ///Time spent waiting for datagrams of flights received
+    uint32_t dwRecv;
+    ///Time spent waiting for flights which timed out
+    uint32_t dwTimeout;
+    ///Remaining time, spent in host processing
+    uint32_t dwHost;
+    ///Number of flights sent again
+    uint8_t bRetransmissions;
+    ///Number of phases recorded
+    uint8_t bPhaseCount;
+    ///Number of chip calls recorded
+    uint8_t bMessageCount;
+    ///Number of phases and chip calls not recorded since the tables were full. Their times are in the totals.
+    uint8_t bDropped;
+    ///Phases in order
+    sProfilePhase_d rgsPhase[DTLS_PROFILE_MAX_PHASES];
+    ///Chip calls in order
+    sProfileMessage_d rgsMessage[DTLS_PROFILE_MAX_MESSAGES];
+}sHandshakeProfile_d;
+
+///Function pointer to report the profile of each OCP_Connect()
+typedef Void (*fProfileReport_d)(hdl_t PhAppOCPCtx, const sHandshakeProfile_d* PpsProfile);
+
+///Define ENABLE_HANDSHAKE_PROFILER to record the profile of each OCP_Connect().
+#ifdef ENABLE_HANDSHAKE_PROFILER
+/**
+ * \brief Starts recording into the profile.
+ */
+Void DtlsProf_Start(sHandshakeProfile_d* PpsProfile);
+
+/**
+ * \brief Stops recording and completes the totals of the profile.
+ */
+Void DtlsProf_Stop(int32_t Pi4Status);
+
+/**
+ * \brief Starts a phase, sending or receiving a flight.
+ */
+Void DtlsProf_BeginPhase(bool_t PfReceive);
+
+/**
+ * \brief Ends the phase started last.
+ */
+Void DtlsProf_EndPhase(uint8_t PbFlight, bool_t PfTimeout);
+
+/**
+ * \brief Starts timing an operation.
+ */
+Void DtlsProf_Begin(eProfileEvent_d PeEvent);
+
+/**
+ * \brief Ends timing an operation.
+ */
+Void DtlsProf_End(eProfileEvent_d PeEvent, uint8_t PbOperation, uint8_t PbMsgType, uint16_t PwLen);
+
+/// @cond hidden
+#define DTLS_PROFILE_START(profile)                     DtlsProf_Start(profile)
+#define DTLS_PROFILE_STOP(status)                       DtlsProf_Stop(status)
+#define DTLS_PROFILE_BEGIN_PHASE(receive)               DtlsProf_BeginPhase(receive)
+#define DTLS_PROFILE_END_PHASE(flight,timeout)          DtlsProf_EndPhase(flight,timeout)
+#define DTLS_PROFILE_BEGIN(event)                       DtlsProf_Begin(event)
+#define DTLS_PROFILE_END(event,operation,type,len)      DtlsProf_End(event,operation,type,len)
+/// @endcond
+#else
+/// @cond hidden
+#define DTLS_PROFILE_START(profile)
+#define DTLS_PROFILE_STOP(status)
+#define DTLS_PROFILE_BEGIN_PHASE(receive)
+#define DTLS_PROFILE_END_PHASE(flight,timeout)
+#define DTLS_PROFILE_BEGIN(event)
+#define DTLS_PROFILE_END(event,operation,type,len)
+/// @endcond
+#endif /* ENABLE_HANDSHAKE_PROFILER */
+
+#endif /* MODULE_ENABLE_DTLS_MUTUAL_AUTH */
+#endif //__DTLSPROFILER_H__
+
+/**
+* @}
+*/
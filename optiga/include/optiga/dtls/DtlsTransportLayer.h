@@ -64,6 +64,18 @@ int32_t DtlsTL_Send(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t PwLen);
  */
 int32_t DtlsTL_Recv(const sTL_d* PpsTL,uint8_t* PpbBuffer,uint16_t* PpwLen);
 
+#ifndef WIN32
+/**
+ * \brief This function receives a datagram from the server without copying it.
+ */
+int32_t DtlsTL_RecvDatagram(const sTL_d* PpsTL,sDatagram_d* PpsDatagram);
+
+/**
+ * \brief This function releases a datagram received with #DtlsTL_RecvDatagram.
+ */
+void DtlsTL_ReleaseDatagram(const sTL_d* PpsTL,sDatagram_d* PpsDatagram);
+#endif
+
 /**
  * \brief This function closes the UDP communication and releases all the resources.
  */
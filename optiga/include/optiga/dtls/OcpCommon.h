@@ -143,6 +143,11 @@ typedef struct sHandshake_d
 	uint16_t wOIDDevPrivKey;
     ///Callback function pointer to get unixtime
     fGetUnixTime_d pfGetUnixTIme;
+    ///First flight prepared before the transport is connected, NULL if none
+    hdl_t phPreparedFlight;
+    ///Message sequence number of the cached HelloVerifyRequest passed to the security chip with the prepared flight,
+    ///0xFFFFFFFF if none
+    uint32_t dwReplayedMsgSeqNum;
 }sHandshake_d;
 
  
@@ -169,7 +174,7 @@ typedef enum eFlight_d
 	eDefault
 }eFlight_d;
 
-///Function pointer to perform Handshake
+///Function pointer to perform Handshake, also used to prepare and release the first flight
 typedef int32_t (*fPerformHandshake_d)(sHandshake_d*);
 
 #endif //__OCPCOMMON_H__
@@ -143,8 +143,14 @@ typedef struct sRL_d
     ///Indicates if the record received is Change cipher spec
     uint8_t bRecvCCSRecord;
     
-    ///pointer to a Next record
-    uint8_t* pNextRecord;
+    ///Received datagram, the records not yet processed are taken from it
+    sDatagram_d sDatagram;
+
+    ///Offset of the next record in the received datagram
+    uint16_t wNextRecord;
+
+    ///Indicates if the datagram is held from the transport layer and must be released
+    bool_t fDatagramHeld;
     
     ///Pointer to callback to change the server epoch state
 	Void (*fServerStateTrn)(const void*);
@@ -56,6 +56,15 @@
 ///Malloc failure
 #define OCP_TL_MALLOC_FAILURE       (BASE_ERROR_TRANSPORTLAYER + 3)
 
+///Queue of datagrams fed by the application is full
+#define OCP_TL_QUEUE_FULL           (BASE_ERROR_TRANSPORTLAYER + 4)
+
+///Maximum number of alternative endpoints raced with the primary endpoint on connect
+#define OCP_TL_MAX_ALT_ENDPOINTS    (3)
+
+///Maximum number of datagrams fed by the application and not yet received by the record layer
+#define OCP_TL_MAX_FED_DATAGRAMS    (4)
+
 /****************************************************************************
  *
  * Common data structure used across all functions.
@@ -87,6 +96,58 @@ typedef enum eReceiveCall_d
     eNonBlocking = 0x20
 }eReceiveCall_d;
 
+/**
+ * \brief Structure holding a network endpoint.
+ */
+typedef struct sEndpoint_d
+{
+    ///IP Address, IPv4 or IPv6 literal
+    char_t* pzIpAddress;
+
+    ///Port Number
+    uint16_t wPort;
+}sEndpoint_d;
+
+///Function pointer for the application transport to send a datagram.
+///The buffer is owned by the application only for the duration of the call
+typedef int32_t (*fAppTLSend_d)(Void* PpCtx, const uint8_t* PprgbData, uint16_t PwLen);
+
+///Function pointer for the application transport to wait up to PwTimeout milliseconds
+///for inbound datagrams, which are passed with OCP_FeedDatagram()
+typedef int32_t (*fAppTLPoll_d)(Void* PpCtx, uint16_t PwTimeout);
+
+///Function pointer for the application transport to take back a datagram passed with OCP_FeedDatagram()
+typedef Void (*fAppTLRelease_d)(Void* PpCtx, const uint8_t* PprgbData);
+
+///Function pointer passed with an outbound datagram to give it back to OCP once it is transmitted
+typedef Void (*fAppTLFree_d)(const uint8_t* PprgbData);
+
+///Function pointer for the application transport to send a datagram it owns till it calls PpfFree.
+///If an error is returned, the datagram stays with OCP and PpfFree must not be called
+typedef int32_t (*fAppTLSendOwned_d)(Void* PpCtx, const uint8_t* PprgbData, uint16_t PwLen, fAppTLFree_d PpfFree);
+
+/**
+ * \brief Structure holding the transport owned by the application.
+ */
+typedef struct sAppTransport_d
+{
+    ///Sends a datagram, must return #OCP_TL_OK on success
+    fAppTLSend_d pfSend;
+
+    ///Waits for inbound datagrams, NULL if datagrams are fed from another context
+    fAppTLPoll_d pfPoll;
+
+    ///Takes back a fed datagram once it is received by the record layer, NULL if not required
+    fAppTLRelease_d pfRelease;
+
+    ///Application context passed to the callbacks
+    Void* pCtx;
+
+    ///Sends an encrypted record without copying, the datagram is owned by the application till it is freed.
+    ///NULL if the datagrams are sent with pfSend only, which is still used for records kept for retransmission
+    fAppTLSendOwned_d pfSendOwned;
+}sAppTransport_d;
+
 /**
  * \brief Structure holding Transport Layer Information.
  */
@@ -100,6 +161,15 @@ typedef struct sTL_d
     
     ///IP Address
 	char_t* pzIpAddress;
+
+    ///Alternative endpoints raced with pzIpAddress and wPort on connect
+    const sEndpoint_d* psAltEndpoints;
+
+    ///Number of alternative endpoints
+    uint8_t bAltEndpointCount;
+
+    ///Transport owned by the application, used instead of pal socket if not NULL
+    const sAppTransport_d* psAppTransport;
     
     ///Transport Layer Timeout
     uint16_t wTimeout;
@@ -129,6 +199,39 @@ typedef int32_t (*fTLSend)(const sTL_d* psTL,uint8_t* pbBuffer,uint16_t wLen);
 ///Function pointer for Transport Layer Receive
 typedef int32_t (*fTLRecv)(const sTL_d* psTL,uint8_t* pbBuffer,uint16_t* pwLen);
 
+///Function pointer for Transport Layer Send taking over a buffer allocated with OCP_MALLOC, which it frees in any case
+typedef int32_t (*fTLSendOwned)(const sTL_d* psTL,uint8_t* pbBuffer,uint16_t wLen);
+
+///Maximum number of segments of a datagram received without copying
+#define TL_MAX_DATAGRAM_SEGMENTS    (4)
+
+/**
+ * \brief Structure referencing a datagram received without copying, e.g. a chain of network stack buffers.
+ */
+typedef struct sDatagram_d
+{
+    ///Data of the segments in order
+    uint8_t* rgpbSegment[TL_MAX_DATAGRAM_SEGMENTS];
+
+    ///Length of the segments
+    uint16_t rgwSegmentLen[TL_MAX_DATAGRAM_SEGMENTS];
+
+    ///Number of segments
+    uint8_t bSegmentCount;
+
+    ///Total length of the datagram
+    uint16_t wLen;
+
+    ///Buffer of the network stack, given back with #fTLReleaseDatagram
+    Void* pvHandle;
+}sDatagram_d;
+
+///Function pointer for Transport Layer Receive without copying, the datagram is valid till it is released
+typedef int32_t (*fTLRecvDatagram)(const sTL_d* psTL,sDatagram_d* psDatagram);
+
+///Function pointer for Transport Layer to release a datagram received with #fTLRecvDatagram
+typedef void (*fTLReleaseDatagram)(const sTL_d* psTL,sDatagram_d* psDatagram);
+
 /**
  * \brief Structure to configure Transport Layer.
  */
@@ -139,9 +242,18 @@ typedef struct sConfigTL_d
     
     ///Function pointer to Send via TL
 	fTLSend pfSend;
+
+    ///Function pointer to Send via TL without copying a buffer of the record layer, NULL if the TL only borrows it
+	fTLSendOwned pfSendOwned;
     
     ///Function pointer to Receive via TL
 	fTLRecv pfRecv;
+
+    ///Function pointer to Receive via TL without copying, NULL if the TL only copies
+	fTLRecvDatagram pfRecvDatagram;
+
+    ///Function pointer to release a datagram received with pfRecvDatagram
+	fTLReleaseDatagram pfReleaseDatagram;
     
     ///Function pointer to Connect to TL
 	fTLConnect pfConnect;
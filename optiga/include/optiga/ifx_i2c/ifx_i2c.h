@@ -94,6 +94,16 @@ host_lib_status_t ifx_i2c_close(ifx_i2c_context_t *p_ctx);
  */
 host_lib_status_t ifx_i2c_set_slave_address(ifx_i2c_context_t *p_ctx, uint8_t slave_address, uint8_t persistent);
 
+/**
+ * \brief   Enables or disables the adaptation of the frame size to the error rate.
+ */
+host_lib_status_t ifx_i2c_set_adaptive_frame_size(ifx_i2c_context_t *p_ctx, uint8_t enable);
+
+/**
+ * \brief   Gets the frame size in use and the frame error statistics.
+ */
+host_lib_status_t ifx_i2c_get_frame_stats(const ifx_i2c_context_t *p_ctx, ifx_i2c_frame_stats_t *p_stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -72,6 +72,23 @@ extern "C" {
 /** @brief Data link layer: Trans timeout in milliseconds*/
 #define PL_TRANS_TIMEOUT_MS         (10)
 
+/** @brief Data link layer: smallest frame size the adaptive frame size shrinks to */
+#ifndef DL_ADAPTIVE_MIN_FRAME_SIZE
+#define DL_ADAPTIVE_MIN_FRAME_SIZE  (64)
+#endif
+/** @brief Data link layer: number of frames with CRC error or NACK within #DL_ADAPTIVE_WINDOW frames, which halves the frame size */
+#ifndef DL_ADAPTIVE_ERROR_BURST
+#define DL_ADAPTIVE_ERROR_BURST     (2)
+#endif
+/** @brief Data link layer: number of frames over which the errors are counted */
+#ifndef DL_ADAPTIVE_WINDOW
+#define DL_ADAPTIVE_WINDOW          (16)
+#endif
+/** @brief Data link layer: number of error free frames in a row, which double the frame size up to the negotiated one */
+#ifndef DL_ADAPTIVE_CLEAN_FRAMES
+#define DL_ADAPTIVE_CLEAN_FRAMES    (64)
+#endif
+
 /** @brief Transport layer: Maximum exit timeout in seconds */
 #define TL_MAX_EXIT_TIMEOUT         (6)
 
@@ -122,6 +139,58 @@ extern "C" {
 ***********************************************************************************************************************/
 typedef struct ifx_i2c_context ifx_i2c_context_t;
 
+/** @brief Upper bound of the execution time of a command in OPTIGA */
+typedef struct ifx_i2c_cmd_timing
+{
+    /// Command code, bit 7 is ignored
+    uint8_t cmd;
+    /// Measured maximum execution time in milliseconds. The response is polled for right away, polling gives up
+    /// after this time instead of the exit timeout of the profile
+    uint32_t max_exec_time_ms;
+} ifx_i2c_cmd_timing_t;
+
+/** @brief Timing profile of the IFX I2C protocol stack */
+typedef struct ifx_i2c_timing_profile
+{
+    /// Physical Layer: polling interval in microseconds
+    uint32_t pl_polling_interval_us;
+    /// Physical layer: maximal attempts
+    uint16_t pl_polling_max_cnt;
+    /// Physical Layer: data register polling interval in microseconds
+    uint32_t pl_data_polling_interval_us;
+    /// Transport layer: Maximum exit timeout in milliseconds
+    uint32_t tl_max_exit_timeout_ms;
+    /// Upper bounds of the execution times of the commands, may be NULL
+    const ifx_i2c_cmd_timing_t* p_cmd_timings;
+    /// Number of entries in p_cmd_timings
+    uint8_t cmd_timings_count;
+} ifx_i2c_timing_profile_t;
+
+/** @brief Frame statistics of the data link layer, since the last open or reset */
+typedef struct ifx_i2c_frame_stats
+{
+    /// Data frames sent, without retransmissions
+    uint32_t frames_sent;
+    /// Data frames received
+    uint32_t frames_received;
+    /// Frames retransmitted
+    uint32_t retransmissions;
+    /// Frames received with CRC error
+    uint32_t crc_errors;
+    /// NACKs received for sent frames
+    uint32_t nacks_received;
+    /// Re-synchronizations of the frame numbers
+    uint32_t resyncs;
+    /// Number of times the adaptive frame size was reduced
+    uint16_t shrink_count;
+    /// Number of times the adaptive frame size was increased
+    uint16_t grow_count;
+    /// Frame size in use (DATA_REG_LEN of the slave)
+    uint16_t frame_size;
+    /// Frame size negotiated by open or reset, the upper limit of the adaptive frame size
+    uint16_t max_frame_size;
+} ifx_i2c_frame_stats_t;
+
 /** @brief Event handler function prototype */
 typedef void (*ifx_i2c_event_handler_t)(struct ifx_i2c_context* ctx, host_lib_status_t event, const uint8_t* data, uint16_t data_len);
 
@@ -162,6 +231,12 @@ typedef struct ifx_i2c_pl
     uint8_t   negotiate_state;
     /// Soft reset requested
     uint8_t   request_soft_reset;
+    /// Frame size written to DATA_REG_LEN by the negotiation
+    uint16_t  requested_frame_size;
+    /// Frame size agreed with the slave, used for the frames sent
+    uint16_t  data_reg_len;
+    /// Negotiation only updates the frame size of a running stack
+    uint8_t   frame_size_update;
 } ifx_i2c_pl_t;
 
 /** @brief Datalink layer structure */
@@ -185,6 +260,8 @@ typedef struct ifx_i2c_dl
     uint8_t resynced;
     /// Timeout value
     uint32_t data_poll_timeout;
+    /// Upper bound for the next response in milliseconds, 0 to use the exit timeout
+    uint32_t response_timeout_ms;
     /// Transmit buffer size
     uint16_t tx_buffer_size;
     /// Receive buffer size
@@ -197,6 +274,19 @@ typedef struct ifx_i2c_dl
     uint32_t frame_start_time;
     // Upper layer Event handler
     ifx_i2c_event_handler_t upper_layer_event_handler;
+
+    // Adaptive frame size variables
+
+    /// Frame size to be negotiated before the next packet, 0 if none
+    uint16_t target_frame_size;
+    /// Frames in the current error counting window
+    uint8_t window_frames;
+    /// Frames with CRC error or NACK in the current window
+    uint8_t window_errors;
+    /// Error free frames in a row
+    uint8_t clean_frames;
+    /// Frame statistics
+    ifx_i2c_frame_stats_t stats;
 } ifx_i2c_dl_t;
 
 /** @brief Transport layer structure */
@@ -285,6 +375,11 @@ typedef struct ifx_i2c_context
     uint8_t tx_frame_buffer[DL_MAX_FRAME_SIZE];
     /// IFX I2C rx frame of max length
     uint8_t rx_frame_buffer[DL_MAX_FRAME_SIZE];
+
+    /// Timing profile in use, set to #ifx_i2c_timing_default by #ifx_i2c_open
+    const ifx_i2c_timing_profile_t* p_timing;
+    /// Adapt the frame size to the error rate, set by #ifx_i2c_set_adaptive_frame_size
+    uint8_t adaptive_frame_size;
        
 } ifx_i2c_context_t;
 
@@ -295,6 +390,9 @@ typedef struct ifx_i2c_context
 /** @brief IFX I2C Instance */
 extern ifx_i2c_context_t ifx_i2c_context_0;
 
+/** @brief Timing profile of the IFX I2C protocol stack, built from the macros above */
+extern const ifx_i2c_timing_profile_t ifx_i2c_timing_default;
+
 /***********************************************************************************************************************
 * LOCAL ROUTINES
 ***********************************************************************************************************************/
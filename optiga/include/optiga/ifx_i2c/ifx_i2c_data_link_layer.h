@@ -105,6 +105,21 @@ host_lib_status_t ifx_i2c_dl_send_frame(ifx_i2c_context_t *p_ctx,uint16_t frame_
  */
 host_lib_status_t ifx_i2c_dl_receive_frame(ifx_i2c_context_t *p_ctx);
 
+/**
+ * @brief Function for changing the frame size.
+ *
+ * Asynchronous function to agree a new frame size with the slave. The function returns immediately.
+ * #IFX_I2C_DL_EVENT_TX_SUCCESS or #IFX_I2C_DL_EVENT_ERROR is propagated to the event handler
+ * registered with @ref ifx_i2c_dl_init. The frame size in use is p_ctx->pl.data_reg_len afterwards.
+ *
+ * @param[in,out] p_ctx     Pointer to ifx i2c context.
+ * @param[in] frame_size    Requested frame size.
+ *
+ * @retval  IFX_I2C_STACK_SUCCESS If function was successful.
+ * @retval  IFX_I2C_STACK_ERROR If the module is busy.
+ */
+host_lib_status_t ifx_i2c_dl_set_frame_size(ifx_i2c_context_t *p_ctx,uint16_t frame_size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -99,6 +99,22 @@ host_lib_status_t ifx_i2c_pl_send_frame(ifx_i2c_context_t *p_ctx,uint8_t* p_fram
  */
 host_lib_status_t ifx_i2c_pl_receive_frame(ifx_i2c_context_t *p_ctx);
 
+/**
+ * @brief Function for changing the frame size.
+ *
+ * Asynchronous function to write the frame size to the DATA_REG_LEN register of the slave
+ * and read it back, as done by the negotiation at initialization. The function returns immediately.
+ * The result is propagated to the event handler registered with @ref ifx_i2c_pl_init.
+ * If the slave does not accept the frame size, the previous frame size stays in use.
+ *
+ * @param[in,out] p_ctx     Pointer to ifx i2c context.
+ * @param[in] frame_size    Requested frame size, not above the frame size negotiated at initialization.
+ *
+ * @retval  IFX_I2C_STACK_SUCCESS If function was successful.
+ * @retval  IFX_I2C_STACK_ERROR If the module is busy.
+ */
+host_lib_status_t ifx_i2c_pl_set_frame_size(ifx_i2c_context_t *p_ctx, uint16_t frame_size);
+
 
 /**
  * @brief Function for setting slave address.
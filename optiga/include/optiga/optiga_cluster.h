@@ -0,0 +1,234 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \file
+*
+* \brief   This file defines APIs, types and data structures used in the OPTIGA cluster module,
+*          which routes requests over several OPTIGA instances (e.g. remote boards on optiga comms over TCP).
+*
+* \ingroup  grOptigaCluster
+* @{
+*/
+
+#ifndef _OPTIGA_CLUSTER_H_
+#define _OPTIGA_CLUSTER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "optiga/common/Datatypes.h"
+#include "optiga/comms/optiga_comms.h"
+#include "optiga/optiga_crypt.h"
+
+/**
+ * OPTIGA cluster module return values
+ */
+///OPTIGA cluster API execution is successful
+#define OPTIGA_CLUSTER_SUCCESS                      (0x0000)
+///OPTIGA cluster API failed
+#define OPTIGA_CLUSTER_ERROR                        (0x0502)
+///OPTIGA cluster API called with invalid inputs
+#define OPTIGA_CLUSTER_ERROR_INVALID_INPUT          (0x0503)
+///Node or key table of the cluster is full
+#define OPTIGA_CLUSTER_ERROR_MEMORY_INSUFFICIENT    (0x0504)
+///No reachable node is able to serve the request
+#define OPTIGA_CLUSTER_ERROR_NO_NODE                (0x0505)
+///The public key is not held by any node of the cluster
+#define OPTIGA_CLUSTER_ERROR_KEY_NOT_FOUND          (0x0506)
+
+///Maximum number of nodes (OPTIGA instances) in a cluster
+#define OPTIGA_CLUSTER_MAX_NODES                    (8)
+///Maximum number of key placements (node and key OID) in a cluster
+#define OPTIGA_CLUSTER_MAX_PLACEMENTS               (16)
+///Time after which a lost node is tried again
+#define OPTIGA_CLUSTER_RETRY_INTERVAL_MS            (5000)
+///Number of key store objects (E0F0 - E0F3) in the inventory of a node
+#define OPTIGA_CLUSTER_KEY_SLOTS                    (4)
+
+/**
+ * \brief OPTIGA instance which is part of the cluster.
+ */
+typedef struct optiga_cluster_node
+{
+    ///Comms instance of the node, e.g. with an optiga comms over TCP context
+    optiga_comms_t * p_comms;
+    ///Node is reachable
+    uint8_t alive;
+    ///Time the node was found unreachable
+    uint32_t down_since;
+    ///Number of requests served, used to balance the stateless requests
+    uint32_t served;
+    ///Algorithm of the signing keys in E0F0 - E0F3 from their metadata, 0 if the object holds no signing key
+    uint8_t key_algorithm[OPTIGA_CLUSTER_KEY_SLOTS];
+} optiga_cluster_node_t;
+
+/**
+ * \brief Location of a registered key.
+ */
+typedef struct optiga_cluster_placement
+{
+    ///Identifier returned by #optiga_cluster_register_key
+    uint8_t key_id;
+    ///Index of the node holding the key
+    uint8_t node;
+    ///Key store OID on the node
+    uint16_t oid;
+} optiga_cluster_placement_t;
+
+/**
+ * \brief Cluster of OPTIGA instances. Must be zero initialized before use.
+ */
+typedef struct optiga_cluster
+{
+    ///Nodes of the cluster
+    optiga_cluster_node_t nodes[OPTIGA_CLUSTER_MAX_NODES];
+    ///Number of nodes
+    uint8_t node_count;
+    ///Key placements
+    optiga_cluster_placement_t placements[OPTIGA_CLUSTER_MAX_PLACEMENTS];
+    ///Number of key placements
+    uint8_t placement_count;
+    ///Number of registered keys
+    uint8_t key_count;
+} optiga_cluster_t;
+
+/**
+ * @brief Adds an OPTIGA instance to the cluster.
+ *
+ *<b>API Details:</b>
+ * - Opens the communication and the application on the node.<br>
+ * - Takes the inventory of the signing keys of the node from the metadata of E0F0 - E0F3. It is taken again
+ *   whenever the node is reopened.<br>
+ * - The node is added even if it is not reachable now, it is tried again after #OPTIGA_CLUSTER_RETRY_INTERVAL_MS.<br>
+ *
+ * \param[in,out]  cluster      Pointer to the cluster
+ * \param[in]      p_comms      Comms instance of the node, must stay valid as long as the cluster is used
+ *
+ * \retval  #OPTIGA_CLUSTER_SUCCESS                     Node is added and reachable
+ * \retval  #OPTIGA_CLUSTER_ERROR_NO_NODE               Node is added but not reachable
+ * \retval  #OPTIGA_CLUSTER_ERROR_INVALID_INPUT         Wrong Input arguments provided
+ * \retval  #OPTIGA_CLUSTER_ERROR_MEMORY_INSUFFICIENT   Cluster has already #OPTIGA_CLUSTER_MAX_NODES nodes
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_cluster_add_node(optiga_cluster_t * cluster,
+                                                            optiga_comms_t * p_comms);
+
+/**
+ * @brief Locates a key in the cluster by its public key.
+ *
+ *<b>API Details:</b>
+ * - Key store objects E0F0 - E0F3 which are signing keys of the curve of the public key, according to
+ *   the inventory of the node, are candidates.<br>
+ * - The certificate object with the same index (E0E0 - E0E3) is read for every candidate. The key is found if the
+ *   certificate holds the given public key.<br>
+ * - Every node and OID holding the key is recorded, so the key can be served by any of them.<br>
+ *
+ *<b>Notes:</b>
+ * - No private key operation is executed, the usage counters of the keys are not affected.<br>
+ * - The public key must be given in the encoding used in the certificate (DER encoded BIT STRING).<br>
+ *
+ * \param[in,out]  cluster      Pointer to the cluster
+ * \param[in]      public_key   Public key of the key pair to be located
+ * \param[out]     key_id       Identifier of the key to be used with #optiga_cluster_sign
+ *
+ * \retval  #OPTIGA_CLUSTER_SUCCESS                     Key is located
+ * \retval  #OPTIGA_CLUSTER_ERROR_KEY_NOT_FOUND         Key is not held by any reachable node
+ * \retval  #OPTIGA_CLUSTER_ERROR_INVALID_INPUT         Wrong Input arguments provided
+ * \retval  #OPTIGA_CLUSTER_ERROR_MEMORY_INSUFFICIENT   Placement table is full
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_cluster_register_key(optiga_cluster_t * cluster,
+                                                                const public_key_from_host_t * public_key,
+                                                                uint8_t * key_id);
+
+/**
+ * @brief Signs a digest with a registered key.
+ *
+ *<b>API Details:</b>
+ * - Routes the request to the least used reachable node holding the key.<br>
+ * - If the node is lost during the request, it is marked unreachable and the request is repeated on the next node holding the key.<br>
+ *
+ * \param[in,out]  cluster            Pointer to the cluster
+ * \param[in]      key_id             Identifier from #optiga_cluster_register_key
+ * \param[in]      digest             Digest to be signed
+ * \param[in]      digest_length      Length of digest
+ * \param[out]     signature          Buffer for the signature
+ * \param[in,out]  signature_length   Size of signature buffer, updated with the signature length
+ *
+ * \retval  #OPTIGA_CLUSTER_SUCCESS                     Successful execution
+ * \retval  #OPTIGA_CLUSTER_ERROR_NO_NODE               No reachable node holds the key
+ * \retval  #OPTIGA_DEVICE_ERROR                        Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_cluster_sign(optiga_cluster_t * cluster,
+                                                        uint8_t key_id,
+                                                        uint8_t * digest,
+                                                        uint8_t digest_length,
+                                                        uint8_t * signature,
+                                                        uint16_t * signature_length);
+
+/**
+ * @brief Verifies a signature with a public key from host on any node.
+ *
+ * \param[in,out]  cluster            Pointer to the cluster
+ * \param[in]      digest             Digest which is signed
+ * \param[in]      digest_length      Length of digest
+ * \param[in]      signature          Signature to be verified
+ * \param[in]      signature_length   Length of signature
+ * \param[in]      public_key         Public key from host
+ *
+ * \retval  #OPTIGA_CLUSTER_SUCCESS                     Signature is valid
+ * \retval  #OPTIGA_CLUSTER_ERROR_NO_NODE               No node is reachable
+ * \retval  #OPTIGA_DEVICE_ERROR                        Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_cluster_verify(optiga_cluster_t * cluster,
+                                                          uint8_t * digest,
+                                                          uint8_t digest_length,
+                                                          uint8_t * signature,
+                                                          uint16_t signature_length,
+                                                          public_key_from_host_t * public_key);
+
+/**
+ * @brief Generates random data on any node.
+ *
+ * \param[in,out]  cluster              Pointer to the cluster
+ * \param[in]      rng_type             Type of random data generator
+ * \param[out]     random_data          Buffer for the random data
+ * \param[in]      random_data_length   Length of random data to be generated
+ *
+ * \retval  #OPTIGA_CLUSTER_SUCCESS                     Successful execution
+ * \retval  #OPTIGA_CLUSTER_ERROR_NO_NODE               No node is reachable
+ * \retval  #OPTIGA_DEVICE_ERROR                        Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_cluster_random(optiga_cluster_t * cluster,
+                                                          optiga_rng_types_t rng_type,
+                                                          uint8_t * random_data,
+                                                          uint16_t random_data_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_OPTIGA_CLUSTER_H_
+
+/**
+* @}
+*/
@@ -289,6 +289,37 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_hash_update(optiga_hash_context
                                                              uint8_t source_of_data_to_hash,
                                                              void * data_to_hash);
 
+/**
+ * @brief Updates a hash context with data scattered over several host buffers.
+ *
+ * Same as #optiga_crypt_hash_update with #OPTIGA_CRYPT_HOST_DATA for the concatenation of the buffers.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ * - #optiga_hash_context_t from #optiga_crypt_hash_start or #optiga_crypt_hash_update must be available.
+ *
+ *<b>API Details:</b><br>
+ * - The buffers are copied directly into the command buffer, a command may take data from several buffers.
+ *   So the number of commands depends on the total length only, not on the number of buffers.<br>
+ * - Exports the hash context to caller.<br>
+ *
+ *<b>Notes:</b><br>
+ *  - A message to be signed (e.g. header, payload and trailer) is hashed with this API and the digest
+ *    is signed with #optiga_crypt_ecdsa_sign, no concatenated copy of the message is needed.<br>
+ *
+ *<br>
+ * \param[in]   hash_ctx          Pointer to #optiga_hash_context_t containing hash context from OPTIGA, must not be NULL
+ * \param[in]   data_vector       Buffers with the data for hashing in order, buffers with a length of 0 are skipped
+ * \param[in]   count             Number of buffers
+ *
+ * \retval  #OPTIGA_CRYPT_SUCCESS                           Successful invocation of optiga cmd module
+ * \retval  #OPTIGA_CRYPT_ERROR_INVALID_INPUT               Wrong Input arguments provided
+ * \retval  #OPTIGA_DEVICE_ERROR                            Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_hash_update_vector(optiga_hash_context_t * hash_ctx,
+                                                                    const hash_data_from_host_t * data_vector,
+                                                                    uint8_t count);
+
  /**
  *
  * @brief Finalizes and exports the hash output.
@@ -532,6 +563,144 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_tls_prf_sha256(uint16_t secret,
                                                                 bool_t export_to_host,
                                                                 uint8_t * derived_key);
 
+/**
+ * \brief Operations which can be chained in a command program.
+ */
+typedef enum optiga_crypt_step_type
+{
+    /// Generate random data (#optiga_crypt_random)
+    OPTIGA_CRYPT_STEP_RANDOM = 0x00,
+    /// Generate a key pair, private key is stored in <b>target_oid</b> (#optiga_crypt_ecc_generate_keypair)
+    OPTIGA_CRYPT_STEP_ECC_GENERATE_KEYPAIR = 0x01,
+    /// Sign the digest in <b>input</b> with the private key in <b>oid</b> (#optiga_crypt_ecdsa_sign)
+    OPTIGA_CRYPT_STEP_ECDSA_SIGN = 0x02,
+    /// Verify the signature in <b>output</b> over the digest in <b>input</b> (#optiga_crypt_ecdsa_verify)
+    OPTIGA_CRYPT_STEP_ECDSA_VERIFY = 0x03,
+    /// Shared secret of the private key in <b>oid</b> and <b>public_key</b> (#optiga_crypt_ecdh)
+    OPTIGA_CRYPT_STEP_ECDH = 0x04,
+    /// Derive a key from the secret in <b>oid</b> with the seed in <b>input</b> (#optiga_crypt_tls_prf_sha256)
+    OPTIGA_CRYPT_STEP_TLS_PRF_SHA256 = 0x05,
+} optiga_crypt_step_type_t;
+
+/** @brief Input of the step is the output of the previous step */
+#define OPTIGA_CRYPT_STEP_INPUT_FROM_PREVIOUS     (0x01)
+/** @brief OID of the step is the target OID of the previous step */
+#define OPTIGA_CRYPT_STEP_OID_FROM_PREVIOUS       (0x02)
+
+/** @brief Step of a command program is not executed, since an earlier step failed */
+#define OPTIGA_CRYPT_STEP_NOT_EXECUTED            (0x0406)
+
+/** @brief Failed step index reported if the program is rejected before any step is executed */
+#define OPTIGA_CRYPT_STEP_INVALID_PROGRAM         (0xFF)
+
+/**
+ * \brief To specify one step of a command program.
+ */
+typedef struct optiga_crypt_step
+{
+    ///Operation to be performed, from #optiga_crypt_step_type_t
+    uint8_t type;
+    ///Binding to the previous step, combination of OPTIGA_CRYPT_STEP_xxx_FROM_PREVIOUS
+    uint8_t bind;
+    ///Object the step works on (private key, secret or public key). 0x0000 if not applicable
+    uint16_t oid;
+    ///Object the result is stored into (private key, shared secret or derived key). 0x0000 exports it to host
+    uint16_t target_oid;
+    ///Step specific parameter (rng type, curve or derived key length)
+    uint16_t param;
+    ///Key usage of the generated key pair, from #optiga_key_usage_t
+    uint8_t key_usage;
+    ///Public key from host for #OPTIGA_CRYPT_STEP_ECDH and #OPTIGA_CRYPT_STEP_ECDSA_VERIFY if oid is 0x0000
+    public_key_from_host_t * public_key;
+    ///Input data (digest or seed)
+    uint8_t * input;
+    ///Length of input data
+    uint16_t input_length;
+    ///Output buffer. For #OPTIGA_CRYPT_STEP_ECDSA_VERIFY this holds the signature to be verified
+    uint8_t * output;
+    ///Size of output buffer, updated with the length of the output on completion
+    uint16_t output_length;
+    ///Status of the step, #OPTIGA_CRYPT_STEP_NOT_EXECUTED if the program stopped before it
+    optiga_lib_status_t status;
+} optiga_crypt_step_t;
+
+/**
+ * @brief Executes a chain of crypto operations as one unit.
+ *
+ * Executes the given steps in order while holding the OPTIGA lock for the whole program.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b>
+ * - Validates all the steps and their bindings before any command is sent to OPTIGA.<br>
+ * - A step with #OPTIGA_CRYPT_STEP_INPUT_FROM_PREVIOUS uses the output of the previous step as input.<br>
+ * - A step with #OPTIGA_CRYPT_STEP_OID_FROM_PREVIOUS uses the target OID of the previous step
+ *   (e.g. the session context filled by #OPTIGA_CRYPT_STEP_ECDH) as its OID.<br>
+ * - Stops at the first failing step. The remaining steps are marked with #OPTIGA_CRYPT_STEP_NOT_EXECUTED.<br>
+ * - Bindings are resolved on a copy of the step, <b>input</b>, <b>input_length</b> and <b>oid</b> of the steps are not modified.<br>
+ *
+ *<b>Notes:</b>
+ * - Error codes from lower layers will be returned as it is.<br>
+ * - Private key export is not supported in a program, <b>target_oid</b> of #OPTIGA_CRYPT_STEP_ECC_GENERATE_KEYPAIR must be valid.<br>
+ * - Other users of OPTIGA are blocked until the complete program is executed.<br>
+ *
+ * \param[in,out]  steps                  Pointer to the array of steps, must not be NULL.
+ * \param[in]      step_count             Number of steps in the array, less than #OPTIGA_CRYPT_STEP_INVALID_PROGRAM.
+ * \param[out]     failed_step            Index of the failing step, step_count if all steps are successful,
+ *                                        #OPTIGA_CRYPT_STEP_INVALID_PROGRAM if the program is rejected. Can be NULL.
+ *
+ * \retval  #OPTIGA_CRYPT_SUCCESS                           All the steps are successfully executed
+ * \retval  #OPTIGA_CRYPT_ERROR_INVALID_INPUT               Wrong Input arguments or bindings provided, no step is executed
+ * \retval  #OPTIGA_DEVICE_ERROR                            Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_execute_program(optiga_crypt_step_t * steps,
+                                                                 uint8_t step_count,
+                                                                 uint8_t * failed_step);
+
+#ifdef OPTIGA_CRYPT_VERIFY_CACHE_ENTRIES
+/**
+ * \brief Statistics of the verification result cache, enabled by defining OPTIGA_CRYPT_VERIFY_CACHE_ENTRIES
+ *        to the number of results to be kept.
+ */
+typedef struct optiga_crypt_verify_cache_metrics
+{
+    ///Number of verifications looked up in the cache
+    uint32_t lookups;
+    ///Number of verifications served from the cache without a command to OPTIGA
+    uint32_t hits;
+    ///Number of positive results stored
+    uint32_t stores;
+    ///Number of results replaced, since the cache was full
+    uint32_t evictions;
+} optiga_crypt_verify_cache_metrics_t;
+
+/**
+ * @brief Drops cached verification results.
+ *
+ * #optiga_crypt_ecdsa_verify keeps positive results as 128 bit SipHash tags of the public key (or its OID),
+ * the digest and the signature. The tag key is drawn from the OPTIGA TRNG on first use, so a forged or
+ * corrupted entry does not match any verification.<br>
+ *
+ *<b>Notes:</b>
+ * - Results are kept per comms context, a result of one chip is not returned for another one.<br>
+ * - Every write of data or metadata and every key generation through the command library (#optiga_util_write_data,
+ *   #optiga_util_write_metadata, the cluster and provisioning modules, direct CmdLib calls) drops the results of the
+ *   changed OID of that chip, #optiga_util_open_application drops all the results of the chip. Any other update of
+ *   a certificate data object, e.g. a protected update, must be followed by a call of this API.<br>
+ *
+ * \param[in]   optiga_oid      OID of the public key, 0x0000 drops all the results, for all the chips
+ */
+LIBRARY_EXPORTS void optiga_crypt_verify_cache_clear(uint16_t optiga_oid);
+
+/**
+ * @brief Gets the statistics of the verification result cache and resets them.
+ *
+ * \param[out]  p_metrics       Statistics since the previous call, can be NULL to only reset them
+ */
+LIBRARY_EXPORTS void optiga_crypt_verify_cache_get_metrics(optiga_crypt_verify_cache_metrics_t * p_metrics);
+#endif
+
 
 #ifdef __cplusplus
 }
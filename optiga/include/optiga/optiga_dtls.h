@@ -55,6 +55,7 @@
 #include "optiga/common/Datatypes.h"
 #include "optiga/dtls/OcpCommon.h"
 #include "optiga/dtls/OcpCommonIncludes.h"
+#include "optiga/dtls/DtlsProfiler.h"
 
 #ifdef MODULE_ENABLE_DTLS_MUTUAL_AUTH
 
@@ -132,7 +133,10 @@ typedef enum eConfiguration_d
     eDTLS_12_UDP_HWCRYPTO =  0x85,
         
     ///TLS 1.2  protocol over TCP using Hardware crypto
-    eTLS_12_TCP_HWCRYPTO =   0x49
+    eTLS_12_TCP_HWCRYPTO =   0x49,
+
+    ///DTLS 1.2 protocol over a transport owned by the application using Hardware crypto
+    eDTLS_12_APP_HWCRYPTO =  0x86
     
 }eConfiguration_d;
 
@@ -149,6 +153,17 @@ typedef struct sNetworkParams_d
     
     ///Network Pmtu
     uint16_t wMaxPmtu;
+
+    ///Alternative endpoints of the same server, NULL if not used.
+    ///The first endpoint to answer the ClientHello is used for the session
+    sEndpoint_d* psAltEndpoints;
+
+    ///Number of alternative endpoints, up to #OCP_TL_MAX_ALT_ENDPOINTS
+    uint8_t bAltEndpointCount;
+
+    ///Transport owned by the application, required for #eDTLS_12_APP_HWCRYPTO and ignored otherwise.
+    ///The IP address, port and alternative endpoints are not used with it
+    sAppTransport_d* psAppTransport;
 }sNetworkParams_d;
 
 /**
@@ -176,6 +191,11 @@ typedef struct sConfigOCP_d
 
 	///Private key OID
 	uint16_t wOIDDevPrivKey;
+
+#ifdef ENABLE_HANDSHAKE_PROFILER
+    ///Callback function pointer to report the handshake profile at the end of each OCP_Connect(), NULL if not used
+    fProfileReport_d pfProfileReport;
+#endif
 }sAppOCPConfig_d;
 
 /**
@@ -203,6 +223,18 @@ LIBRARY_EXPORTS int32_t OCP_Receive(const hdl_t PhAppOCPCtx,uint8_t* PpbData,uin
  */
 LIBRARY_EXPORTS int32_t OCP_Disconnect(hdl_t PhAppOCPCtx);
 
+/**
+ * \brief  Passes an inbound datagram by reference to a session using a transport owned by the application.
+ */
+LIBRARY_EXPORTS int32_t OCP_FeedDatagram(const hdl_t PhAppOCPCtx,const uint8_t* PprgbData,uint16_t PwLen);
+
+#ifdef ENABLE_HANDSHAKE_PROFILER
+/**
+ * \brief  Gets the profile of the last handshake.
+ */
+LIBRARY_EXPORTS int32_t OCP_GetHandshakeProfile(const hdl_t PhAppOCPCtx,sHandshakeProfile_d* PpsProfile);
+#endif
+
 #endif /* MODULE_ENABLE_DTLS_MUTUAL_AUTH*/
 #endif //__OCP_H__
 /**
@@ -73,6 +73,21 @@ extern "C" {
 /// Option to erase and write the data object
 #define OPTIGA_UTIL_ERASE_AND_WRITE (0x40)
 
+/**
+ * \brief Fragment of the data to be written with #optiga_util_write_data_vector.
+ */
+typedef struct optiga_util_data_fragment
+{
+    ///Data of the fragment
+    const uint8_t * buffer;
+    ///Length of the fragment
+    uint16_t length;
+} optiga_util_data_fragment_t;
+
+#ifdef OPTIGA_UTIL_CERT_COMPRESSION
+///First byte of a certificate stored in the compressed format, not used by DER (0x30) and TLS (0xC0) certificates
+#define OPTIGA_UTIL_CERT_COMPRESSED_TAG             (0xCC)
+#endif
 
 /**
  * OPTIGA util module return values
@@ -89,6 +104,79 @@ extern "C" {
 #define OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT       (0x0304)
 ///OPTIGA util API called when, a request of same instance is already in service
 #define OPTIGA_UTIL_ERROR_INSTANCE_IN_USE           (0x0305)
+///Access condition of the data object is never satisfied, known from the cached metadata without a command
+#define OPTIGA_UTIL_ERROR_ACCESS_DENIED             (0x0306)
+
+///Maximum length of an access condition kept in #optiga_util_metadata_t
+#define OPTIGA_UTIL_METADATA_MAX_ACCESS_LENGTH      (8)
+///Access condition which is always satisfied (ALW)
+#define OPTIGA_UTIL_ACCESS_ALWAYS                   (0x00)
+///Access condition which is never satisfied (NEV)
+#define OPTIGA_UTIL_ACCESS_NEVER                    (0xFF)
+
+/**
+ * Flags of the metadata tags found by #optiga_util_parse_metadata
+ */
+///Life cycle state of the object (tag 0xC0)
+#define OPTIGA_UTIL_METADATA_LCSO                   (0x0001)
+///Version of the object (tag 0xC1)
+#define OPTIGA_UTIL_METADATA_VERSION                (0x0002)
+///Maximum size of the object (tag 0xC4)
+#define OPTIGA_UTIL_METADATA_MAX_SIZE               (0x0004)
+///Used size of the object (tag 0xC5)
+#define OPTIGA_UTIL_METADATA_USED_SIZE              (0x0008)
+///Change access condition (tag 0xD0)
+#define OPTIGA_UTIL_METADATA_CHANGE_ACCESS          (0x0010)
+///Read access condition (tag 0xD1)
+#define OPTIGA_UTIL_METADATA_READ_ACCESS            (0x0020)
+///Execute access condition (tag 0xD3)
+#define OPTIGA_UTIL_METADATA_EXECUTE_ACCESS         (0x0040)
+///Algorithm of a key object (tag 0xE0)
+#define OPTIGA_UTIL_METADATA_ALGORITHM              (0x0080)
+///Key usage of a key object (tag 0xE1)
+#define OPTIGA_UTIL_METADATA_KEY_USAGE              (0x0100)
+///Data object type (tag 0xE8)
+#define OPTIGA_UTIL_METADATA_DATA_OBJECT_TYPE       (0x0200)
+
+/**
+ * \brief Access condition of a data object, as stored in the metadata.
+ */
+typedef struct optiga_util_access_condition
+{
+    ///Length of the access condition
+    uint8_t length;
+    ///Access condition, e.g. #OPTIGA_UTIL_ACCESS_ALWAYS or a sequence of identifiers, references and operators
+    uint8_t value[OPTIGA_UTIL_METADATA_MAX_ACCESS_LENGTH];
+} optiga_util_access_condition_t;
+
+/**
+ * \brief Metadata of a data object, parsed from the TLV returned by #optiga_util_read_metadata.
+ */
+typedef struct optiga_util_metadata
+{
+    ///Tags found in the metadata, from the OPTIGA_UTIL_METADATA_* flags. Fields of tags not found are 0.
+    uint16_t present;
+    ///Life cycle state of the object
+    uint8_t lcso;
+    ///Version of the object
+    uint16_t version;
+    ///Maximum size of the object
+    uint16_t max_size;
+    ///Used size of the object
+    uint16_t used_size;
+    ///Change access condition
+    optiga_util_access_condition_t change_access;
+    ///Read access condition
+    optiga_util_access_condition_t read_access;
+    ///Execute access condition
+    optiga_util_access_condition_t execute_access;
+    ///Algorithm of a key object
+    uint8_t algorithm;
+    ///Key usage of a key object
+    uint8_t key_usage;
+    ///Data object type
+    uint8_t data_object_type;
+} optiga_util_metadata_t;
 
 
 /**
@@ -205,6 +293,7 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_util_open_application(optiga_comms_t*
  *
  * \retval  #OPTIGA_UTIL_SUCCESS                               Successful invocation of optiga cmd module
  * \retval  #OPTIGA_UTIL_ERROR_INVALID_INPUT                   Wrong Input arguments provided
+ * \retval  #OPTIGA_UTIL_ERROR_ACCESS_DENIED                   Access condition is never satisfied according to the cached metadata, no command is sent
  * \retval  #OPTIGA_DEVICE_ERROR                               Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
  */
 LIBRARY_EXPORTS optiga_lib_status_t optiga_util_read_data(uint16_t optiga_oid,
@@ -244,6 +333,126 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_util_read_metadata(uint16_t optiga_oi
                                                               uint8_t * buffer,
                                                               uint16_t * bytes_to_read);
 
+/**
+ * @brief Parses metadata of a data object.
+ *
+ * Converts the metadata TLV returned by #optiga_util_read_metadata into #optiga_util_metadata_t.<br>
+ *
+ *<b>API Details:</b>
+ * - Runs on the host only, no command is sent to OPTIGA.<br>
+ * - Tags unknown to #optiga_util_metadata_t are skipped.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - Access conditions longer than #OPTIGA_UTIL_METADATA_MAX_ACCESS_LENGTH are not kept, their flag is not set.<br>
+ *
+ * \param[in]      metadata         Valid pointer to the metadata TLV (tag 0x20)
+ * \param[in]      metadata_length  Length of metadata
+ * \param[out]     parsed           Valid pointer to the parsed metadata
+ *
+ * \retval  #OPTIGA_UTIL_SUCCESS                               Metadata is parsed
+ * \retval  #OPTIGA_UTIL_ERROR_INVALID_INPUT                   Wrong Input arguments provided
+ * \retval  #OPTIGA_UTIL_ERROR                                 Metadata is not a valid TLV
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_util_parse_metadata(const uint8_t * metadata,
+                                                               uint16_t metadata_length,
+                                                               optiga_util_metadata_t * parsed);
+
+/**
+ * @brief Gets the parsed metadata of a data object.
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b>
+ * - Reads the metadata with #optiga_util_read_metadata and parses it with #optiga_util_parse_metadata.<br>
+ * - The parsed metadata is cached, a cached data object costs no command. The used size in the cache is updated by
+ *   #optiga_util_write_data, the data object is removed from the cache by #optiga_util_write_metadata and
+ *   the cache is cleared completely by #optiga_util_open_application.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - Data objects or metadata changed by other means than the util APIs (e.g. the command library directly)
+ *   must be re-read by calling #optiga_util_open_application.<br>
+ * - Life cycle states changed by OPTIGA itself (e.g. a monotonic counter reaching its threshold) are not seen in the cache.<br>
+ *
+ * \param[in]      optiga_oid     OID of data object
+ * \param[out]     metadata       Valid pointer to the parsed metadata
+ *
+ * \retval  #OPTIGA_UTIL_SUCCESS                               Successful invocation of optiga cmd module
+ * \retval  #OPTIGA_UTIL_ERROR_INVALID_INPUT                   Wrong Input arguments provided
+ * \retval  #OPTIGA_UTIL_ERROR                                 Metadata read is not a valid TLV
+ * \retval  #OPTIGA_DEVICE_ERROR                               Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_util_get_metadata(uint16_t optiga_oid,
+                                                             optiga_util_metadata_t * metadata);
+
+/**
+ * @brief Gets the used size of a data object.
+ *
+ * Retrieves the number of bytes stored in the data object, so that a buffer of the right size can be provided
+ * to #optiga_util_read_data_exact.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b>
+ * - Gets the metadata of the data object with #optiga_util_get_metadata and returns the used size (tag 0xC5).
+ *   A data object in the metadata cache costs no command.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - Data objects changed by other means than #optiga_util_write_data (e.g. the command library directly)
+ *   must be re-read by calling #optiga_util_open_application.<br>
+ *
+ * \param[in]      optiga_oid     OID of data object
+ * \param[out]     used_size      Valid pointer to the used size of the data object
+ *
+ * \retval  #OPTIGA_UTIL_SUCCESS                               Successful invocation of optiga cmd module
+ * \retval  #OPTIGA_UTIL_ERROR_INVALID_INPUT                   Wrong Input arguments provided
+ * \retval  #OPTIGA_UTIL_ERROR                                 Metadata of the data object has no used size
+ * \retval  #OPTIGA_DEVICE_ERROR                               Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_util_get_data_size(uint16_t optiga_oid,
+                                                              uint16_t * used_size);
+
+/**
+ * @brief Reads exactly the stored data from optiga.
+ *
+ * Same as #optiga_util_read_data, but the length to be read is limited to the used size of the data object.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b>
+ * - Gets the used size with #optiga_util_get_data_size, i.e. the metadata is read only if it is not cached yet.
+ *   The bytes from <b>offset</b> up to the used size are then read in chunks of the maximum command size.
+ *   No additional command is needed to detect the end of the data.<br>
+ * - If the metadata of the data object has no used size, the data is read like #optiga_util_read_data. The used
+ *   size found by a short read is stored in the cache, so that the next reads of the data object are exact.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - If <b>*bytes_to_read</b> is less than the stored data, no data is returned.<br>
+ * - In case of any errors, <b>*bytes_to_read</b> is set to 0.<br>
+ *
+ * \param[in]      optiga_oid       OID of data object
+ * \param[in]      offset           Offset from within data object
+ * \param[in,out]  buffer           Valid pointer to the buffer to which data is read
+ * \param[in,out]  bytes_to_read    Valid pointer to the size of buffer
+ *                                  - When the data is successfully retrieved, it is updated with actual data length retrieved
+ *
+ * \retval  #OPTIGA_UTIL_SUCCESS                               Successful invocation of optiga cmd module
+ * \retval  #OPTIGA_UTIL_ERROR_INVALID_INPUT                   Wrong Input arguments provided or offset is beyond the used size
+ * \retval  #OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT             Stored data from offset is longer than the buffer
+ * \retval  #OPTIGA_UTIL_ERROR_ACCESS_DENIED                   Access condition is never satisfied according to the cached metadata, no command is sent
+ * \retval  #OPTIGA_DEVICE_ERROR                               Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_util_read_data_exact(uint16_t optiga_oid,
+                                                                uint16_t offset,
+                                                                uint8_t * buffer,
+                                                                uint16_t * bytes_to_read);
+
 /**
  * @brief Writes data to optiga.
  *
@@ -271,6 +480,7 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_util_read_metadata(uint16_t optiga_oi
  *
  * \retval  #OPTIGA_UTIL_SUCCESS                               Successful invocation of optiga cmd module
  * \retval  #OPTIGA_UTIL_ERROR_INVALID_INPUT                   Wrong Input arguments provided
+ * \retval  #OPTIGA_UTIL_ERROR_ACCESS_DENIED                   Access condition is never satisfied according to the cached metadata, no command is sent
  * \retval  #OPTIGA_UTIL_ERROR_INSTANCE_IN_USE                 Same instance with ongoing request servicing used
  * \retval  #OPTIGA_CMD_ERROR_MEMORY_INSUFFICIENT              Length of the buffer to copy the metadata is less than actual length of metadata
  * \retval  #OPTIGA_DEVICE_ERROR                               Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
@@ -281,6 +491,43 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_util_write_data(uint16_t optiga_oid,
                                                            uint8_t * buffer,
                                                            uint16_t bytes_to_write);
 
+/**
+ * @brief Writes data scattered over several buffers to optiga.
+ *
+ * Writes the concatenation of the fragments into the specified data object, same as #optiga_util_write_data
+ * with all fragments copied into one buffer before.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b>
+ * - The fragments are copied directly into the command buffer, a command may take data from several fragments.<br>
+ * - Invokes #optiga_cmd_set_data_object API as often as #optiga_util_write_data for the total length.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - Error codes from lower layers will be returned as it is.<br>
+ * - Fragments with a length of 0 are skipped, the total length must not be 0 and must fit into 16 bits.<br>
+ *
+ * \param[in]      optiga_oid     OID of data object
+ *                                - It should be a valid data object, otherwise OPTIGA returns an error.<br>
+ * \param[in]      write_type     Type of the write operation. Can be OPTIGA_UTIL_ERASE_AND_WRITE or OPTIGA_UTIL_WRITE_ONLY
+ * \param[in]      offset         Offset from within data object
+ *                                - It must be valid offset from within data object, otherwise OPTIGA returns an error.<br>
+ * \param[in]      fragments      Valid pointer to the fragments with user data to write, in order
+ * \param[in]      count          Number of fragments
+ *
+ * \retval  #OPTIGA_UTIL_SUCCESS                               Successful invocation of optiga cmd module
+ * \retval  #OPTIGA_UTIL_ERROR_INVALID_INPUT                   Wrong Input arguments provided
+ * \retval  #OPTIGA_UTIL_ERROR_ACCESS_DENIED                   Access condition is never satisfied according to the cached metadata, no command is sent
+ * \retval  #OPTIGA_DEVICE_ERROR                               Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_util_write_data_vector(uint16_t optiga_oid,
+                                                                  uint8_t write_type,
+                                                                  uint16_t offset,
+                                                                  const optiga_util_data_fragment_t * fragments,
+                                                                  uint8_t count);
+
 /**
  * @brief Writes metadata for the user provided data object.
  *
@@ -312,6 +559,98 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_util_write_data(uint16_t optiga_oid,
 LIBRARY_EXPORTS optiga_lib_status_t optiga_util_write_metadata(uint16_t optiga_oid,
                                                                uint8_t * buffer,
                                                                uint8_t bytes_to_write);
+
+#ifdef OPTIGA_UTIL_CERT_COMPRESSION
+/**
+ * @brief Compresses a certificate to be stored in a data object.
+ *
+ * Encodes the certificate in the compressed format read by #optiga_util_read_cert, which saves I2C transfer time on every read.<br>
+ *
+ *<b>API Details:</b>
+ * - Runs on the host only, no command is sent to OPTIGA. Meant for provisioning, where the time taken does not matter.<br>
+ * - The format starts with #OPTIGA_UTIL_CERT_COMPRESSED_TAG and the certificate length, followed by runs of literal bytes
+ *   and matches referring to earlier bytes or to a preset dictionary of DER fragments common to OPTIGA Trust X certificates.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - The certificate of the OPTIGA itself (#eDEVICE_PUBKEY_CERT_IFX) and every certificate OPTIGA uses in the DTLS handshake
+ *   must be stored uncompressed, OPTIGA sends them as they are.<br>
+ * - The compressed data may be larger than the certificate if it has few DER fragments in common with the dictionary.<br>
+ *
+ * \param[in]      p_cert         Valid pointer to the certificate
+ * \param[in]      cert_length    Length of the certificate
+ * \param[out]     p_buffer       Valid pointer to the buffer for the compressed data
+ * \param[in,out]  buffer_size    Valid pointer to the size of buffer
+ *                                - When the certificate is compressed, it is updated with the length of the compressed data
+ *
+ * \retval  #OPTIGA_UTIL_SUCCESS                               Certificate is compressed
+ * \retval  #OPTIGA_UTIL_ERROR_INVALID_INPUT                   Wrong Input arguments provided
+ * \retval  #OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT             Compressed data does not fit into the buffer
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_util_compress_cert(const uint8_t * p_cert,
+                                                              uint16_t cert_length,
+                                                              uint8_t * p_buffer,
+                                                              uint16_t * buffer_size);
+
+/**
+ * @brief Decompresses a certificate compressed with #optiga_util_compress_cert.
+ *
+ *<b>API Details:</b>
+ * - Runs on the host only, no command is sent to OPTIGA.<br>
+ * - The compressed data may be located at the end of <b>p_buffer</b>, it is then decompressed in place.<br>
+ *<br>
+ *
+ * \param[in]      p_data         Valid pointer to the compressed data
+ * \param[in]      data_length    Length of the compressed data
+ * \param[out]     p_buffer       Valid pointer to the buffer for the certificate
+ * \param[in,out]  buffer_size    Valid pointer to the size of buffer
+ *                                - When the certificate is decompressed, it is updated with the certificate length
+ *
+ * \retval  #OPTIGA_UTIL_SUCCESS                               Certificate is decompressed
+ * \retval  #OPTIGA_UTIL_ERROR_INVALID_INPUT                   Wrong Input arguments provided or data is not compressed
+ * \retval  #OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT             Certificate does not fit into the buffer, or the in place
+ *                                                            decompression would overwrite data not yet read
+ * \retval  #OPTIGA_UTIL_ERROR                                 Compressed data is corrupted
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_util_decompress_cert(const uint8_t * p_data,
+                                                                uint16_t data_length,
+                                                                uint8_t * p_buffer,
+                                                                uint16_t * buffer_size);
+
+/**
+ * @brief Reads a certificate from a data object, which may be stored compressed.
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b>
+ * - Reads the stored data of the data object with #optiga_util_read_data_exact.<br>
+ * - If the data starts with #OPTIGA_UTIL_CERT_COMPRESSED_TAG, it is moved to the end of the buffer and decompressed in place.
+ *   Otherwise the data is returned as it is.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - The buffer must hold the decompressed certificate and some bytes more, since in place decompression can not
+ *   overwrite compressed data which is not yet read. A few bytes more than the certificate length are sufficient
+ *   for certificates like the ones issued for OPTIGA Trust X.<br>
+ * - In case of any errors, <b>*buffer_size</b> is set to 0.<br>
+ *
+ * \param[in]      optiga_oid     OID of data object
+ * \param[out]     p_buffer       Valid pointer to the buffer for the certificate
+ * \param[in,out]  buffer_size    Valid pointer to the size of buffer
+ *                                - When the certificate is read, it is updated with the certificate length
+ *
+ * \retval  #OPTIGA_UTIL_SUCCESS                               Certificate is read
+ * \retval  #OPTIGA_UTIL_ERROR_INVALID_INPUT                   Wrong Input arguments provided
+ * \retval  #OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT             Certificate does not fit into the buffer
+ * \retval  #OPTIGA_UTIL_ERROR                                 Compressed data is corrupted
+ * \retval  #OPTIGA_DEVICE_ERROR                               Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_util_read_cert(uint16_t optiga_oid,
+                                                          uint8_t * p_buffer,
+                                                          uint16_t * buffer_size);
+#endif //OPTIGA_UTIL_CERT_COMPRESSION
+
 #ifdef __cplusplus
 }
 #endif
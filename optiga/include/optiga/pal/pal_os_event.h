@@ -65,6 +65,47 @@ typedef void (*register_callback)(void*);
 pal_status_t pal_os_event_init(void);
 #endif
 
+#ifdef PAL_OS_HAS_EVENT_PROCESS
+/**
+ * @brief Platform specific function to serve the due events, invoked by the library while it waits for OPTIGA.
+ *
+ * Needed by the platforms on which no signal, interrupt or thread serves the events, e.g. if they are run by the
+ * event loop of the application.
+ */
+void pal_os_event_process(void);
+#endif
+
+#ifdef PAL_OS_HAS_EVENT_WAIT
+/**
+ * @brief Platform specific function to register the calling task as the one waiting for the next completion.
+ *
+ * Invoked by the library before a request is sent to OPTIGA, so a completion signalled before the wait is not lost.
+ * The p_ctx of the wait functions is the context of the comms stack the request is sent over (optiga_comms_t.comms_ctx),
+ * the same one the stack passes as callback argument to #pal_os_event_register_callback_oneshot. Platforms serving
+ * several chips use it to pick the timer and the completion of the chip.
+ */
+void pal_os_event_prepare_wait(const void * p_ctx);
+
+/**
+ * @brief Platform specific function to undo #pal_os_event_prepare_wait, invoked by the library if the request
+ *        could not be sent to OPTIGA and no completion follows.
+ */
+void pal_os_event_cancel_wait(const void * p_ctx);
+
+/**
+ * @brief Platform specific function to block the calling task till #pal_os_event_notify or a short timeout.
+ *
+ * Invoked by the library instead of polling while it waits for OPTIGA. The library checks its completion
+ * status after each return, so spurious or timed out returns are allowed.
+ */
+void pal_os_event_wait(const void * p_ctx);
+
+/**
+ * @brief Platform specific function to wake the waiting task, invoked by the library when a request completes.
+ */
+void pal_os_event_notify(const void * p_ctx);
+#endif
+
 /**
  * @brief Callback registration function to trigger once when timer expires.
  */
@@ -111,6 +111,9 @@ typedef struct pal_socket
 
     ///Port for UDP communication
     uint16_t wPort;
+
+    ///Port of the sender of the last datagram received
+    uint16_t wRecvPort;
         
     ///Transport Layer Timeout
     uint16_t wTimeout;
@@ -145,6 +148,31 @@ typedef struct pal_socket
 } pal_socket_t;
 #endif
 
+///Maximum number of segments of a datagram received without copying, longer chains are coalesced
+#define PAL_SOCKET_MAX_SEGMENTS     (4)
+
+/**
+ * \brief This structure references a datagram received without copying, e.g. the pbuf chain of lwIP
+ */
+typedef struct pal_socket_datagram
+{
+    ///Data of the segments in order
+    uint8_t* p_segment[PAL_SOCKET_MAX_SEGMENTS];
+
+    ///Length of the segments
+    uint16_t segment_length[PAL_SOCKET_MAX_SEGMENTS];
+
+    ///Number of segments
+    uint8_t segment_count;
+
+    ///Total length of the datagram
+    uint16_t length;
+
+    ///Buffer of the network stack, freed by #pal_socket_release_datagram
+    void* p_handle;
+
+} pal_socket_datagram_t;
+
 /**********************************************************************************************************************
  * API Prototypes
  *********************************************************************************************************************/
@@ -158,6 +186,13 @@ int32_t pal_socket_assign_ip_address(const char* p_ip_address,void *p_input_ip_a
 int32_t pal_socket_assign_ip_address(const char_t* p_ip_address,char** p_input_ip_address);
 #endif
 
+#ifndef WIN32
+/**
+ * \brief Compares an IP address string with an assigned IP address
+ */
+int32_t pal_socket_compare_ip_address(const char_t* p_ip_address,const void* p_input_ip_address);
+#endif
+
 /**
  * \brief Initializes the socket communication structure
  */
@@ -178,6 +213,18 @@ int32_t pal_socket_connect(pal_socket_t* p_socket,
  */
 int32_t pal_socket_listen(pal_socket_t* p_socket, uint8_t *p_data,
                           uint32_t *p_length);
+#ifndef WIN32
+/**
+ * \brief Receives a datagram from the client without copying it, it must be released with #pal_socket_release_datagram
+ */
+int32_t pal_socket_listen_datagram(pal_socket_t* p_socket, pal_socket_datagram_t* p_datagram);
+
+/**
+ * \brief Releases a datagram received with #pal_socket_listen_datagram
+ */
+void pal_socket_release_datagram(pal_socket_datagram_t* p_datagram);
+#endif
+
 /**
  * \brief Sends the data to the the client
  */
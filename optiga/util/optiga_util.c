@@ -32,18 +32,135 @@
 #include "optiga/optiga_util.h"
 #include "optiga/comms/optiga_comms.h"
 #include "optiga/cmd/CommandLib.h"
+#include "optiga/common/MemoryMgmt.h"
 #include "optiga/pal/pal_os_timer.h"
+#include "optiga/pal/pal_os_event.h"
 
-///Length of metadata
-#define LENGTH_METADATA             0x1C
+/// @cond hidden
+///Size of the buffer to read the metadata of a data object
+#define OPTIGA_UTIL_METADATA_BUFFER_SIZE    (64)
+///Tag of the metadata TLV
+#define OPTIGA_UTIL_TAG_METADATA            (0x20)
+///Tags in metadata
+#define OPTIGA_UTIL_TAG_LCSO                (0xC0)
+#define OPTIGA_UTIL_TAG_VERSION             (0xC1)
+#define OPTIGA_UTIL_TAG_MAX_SIZE            (0xC4)
+#define OPTIGA_UTIL_TAG_USED_SIZE           (0xC5)
+#define OPTIGA_UTIL_TAG_CHANGE_ACCESS       (0xD0)
+#define OPTIGA_UTIL_TAG_READ_ACCESS         (0xD1)
+#define OPTIGA_UTIL_TAG_EXECUTE_ACCESS      (0xD3)
+#define OPTIGA_UTIL_TAG_ALGORITHM           (0xE0)
+#define OPTIGA_UTIL_TAG_KEY_USAGE           (0xE1)
+#define OPTIGA_UTIL_TAG_DATA_OBJECT_TYPE    (0xE8)
+///Number of data objects of which the metadata is cached
+#ifndef OPTIGA_UTIL_METADATA_CACHE_ENTRIES
+#define OPTIGA_UTIL_METADATA_CACHE_ENTRIES  (8)
+#endif
+/// @endcond
 
 volatile static host_lib_status_t optiga_comms_status;
 
 #ifdef MODULE_ENABLE_READ_WRITE
 
+/// @cond hidden
+///Parsed metadata of a data object
+typedef struct optiga_util_metadata_cache
+{
+    ///Comms context of the OPTIGA holding the data object
+    const optiga_comms_t * p_comms;
+    ///OID of the data object, 0 if the entry is free
+    uint16_t oid;
+    ///Parsed metadata of the data object
+    optiga_util_metadata_t metadata;
+} optiga_util_metadata_cache_t;
+
+static optiga_util_metadata_cache_t metadata_cache[OPTIGA_UTIL_METADATA_CACHE_ENTRIES];
+///Entry to be replaced next, if the cache is full
+static uint8_t metadata_cache_next = 0;
+
+//Finds the entry of the data object on the OPTIGA currently selected in the command library, a free entry if the OID is 0
+static optiga_util_metadata_cache_t * __optiga_util_metadata_cache_find(uint16_t optiga_oid)
+{
+    const optiga_comms_t * p_comms = CmdLib_GetOptigaCommsContext();
+    uint8_t index;
+
+    for (index = 0; index < OPTIGA_UTIL_METADATA_CACHE_ENTRIES; index++)
+    {
+        if ((optiga_oid == metadata_cache[index].oid) &&
+            ((0 == optiga_oid) || (p_comms == metadata_cache[index].p_comms)))
+        {
+            return &metadata_cache[index];
+        }
+    }
+    return NULL;
+}
+
+static void __optiga_util_metadata_cache_store(uint16_t optiga_oid, const optiga_util_metadata_t * metadata)
+{
+    optiga_util_metadata_cache_t * p_entry = __optiga_util_metadata_cache_find(optiga_oid);
+
+    if (NULL == p_entry)
+    {
+        p_entry = __optiga_util_metadata_cache_find(0);
+    }
+    if (NULL == p_entry)
+    {
+        p_entry = &metadata_cache[metadata_cache_next];
+        metadata_cache_next = (metadata_cache_next + 1) % OPTIGA_UTIL_METADATA_CACHE_ENTRIES;
+    }
+    p_entry->p_comms = CmdLib_GetOptigaCommsContext();
+    p_entry->oid = optiga_oid;
+    p_entry->metadata = *metadata;
+}
+
+//Clears the entry of the data object, all entries of the OPTIGA currently selected in the command library if the OID is 0
+static void __optiga_util_metadata_cache_clear(uint16_t optiga_oid)
+{
+    const optiga_comms_t * p_comms = CmdLib_GetOptigaCommsContext();
+    optiga_util_metadata_cache_t * p_entry;
+    uint8_t index;
+
+    if (0 == optiga_oid)
+    {
+        for (index = 0; index < OPTIGA_UTIL_METADATA_CACHE_ENTRIES; index++)
+        {
+            if (p_comms == metadata_cache[index].p_comms)
+            {
+                metadata_cache[index].oid = 0;
+            }
+        }
+        return;
+    }
+    p_entry = __optiga_util_metadata_cache_find(optiga_oid);
+    if (NULL != p_entry)
+    {
+        p_entry->oid = 0;
+    }
+}
+
+//Checks the cached metadata only, a data object not in the cache is never denied
+static uint8_t __optiga_util_access_denied(uint16_t optiga_oid, uint16_t access_flag)
+{
+    optiga_util_metadata_cache_t * p_entry = __optiga_util_metadata_cache_find(optiga_oid);
+    const optiga_util_access_condition_t * p_access;
+
+    if ((0 == optiga_oid) || (NULL == p_entry) || (0 == (access_flag & p_entry->metadata.present)))
+    {
+        return FALSE;
+    }
+    p_access = (OPTIGA_UTIL_METADATA_READ_ACCESS == access_flag) ?
+               &p_entry->metadata.read_access : &p_entry->metadata.change_access;
+    return ((1 == p_access->length) && (OPTIGA_UTIL_ACCESS_NEVER == p_access->value[0])) ? TRUE : FALSE;
+}
+/// @endcond
+
 static void __optiga_util_comms_event_handler(void* upper_layer_ctx, host_lib_status_t event)
 {
 	optiga_comms_status = event;
+#ifdef PAL_OS_HAS_EVENT_WAIT
+	//The comms context being opened, see optiga_util_open_application
+	pal_os_event_notify(((optiga_comms_t*)upper_layer_ctx)->comms_ctx);
+#endif
 }
 
 optiga_lib_status_t optiga_util_open_application(optiga_comms_t* p_comms)
@@ -56,9 +173,16 @@ optiga_lib_status_t optiga_util_open_application(optiga_comms_t* p_comms)
 		//Invoke optiga_comms_open to initialize the IFX I2C Protocol and security chip
 		optiga_comms_status = OPTIGA_COMMS_BUSY;
 		p_comms->upper_layer_handler = __optiga_util_comms_event_handler;
+#ifdef PAL_OS_HAS_EVENT_WAIT
+		p_comms->upper_layer_ctx = p_comms;
+		pal_os_event_prepare_wait(p_comms->comms_ctx);
+#endif
 		status = optiga_comms_open(p_comms);
 		if(E_COMMS_SUCCESS != status)
 		{
+#ifdef PAL_OS_HAS_EVENT_WAIT
+			pal_os_event_cancel_wait(p_comms->comms_ctx);
+#endif
 			status = OPTIGA_LIB_ERROR;
 			break;
 		}
@@ -66,7 +190,14 @@ optiga_lib_status_t optiga_util_open_application(optiga_comms_t* p_comms)
 		//Wait until IFX I2C initialization is complete
 		while(optiga_comms_status == OPTIGA_COMMS_BUSY)
 		{
+#ifdef PAL_OS_HAS_EVENT_PROCESS
+			pal_os_event_process();
+#endif
+#ifdef PAL_OS_HAS_EVENT_WAIT
+			pal_os_event_wait(p_comms->comms_ctx);
+#elif !defined(PAL_OS_HAS_EVENT_PROCESS)
 			pal_os_timer_delay_in_milliseconds(1);
+#endif
 		}
 
 		if((OPTIGA_COMMS_SUCCESS != status) || (optiga_comms_status == OPTIGA_COMMS_ERROR))
@@ -79,6 +210,9 @@ optiga_lib_status_t optiga_util_open_application(optiga_comms_t* p_comms)
 		//This context will be used by command library to communicate with OPTIGA using IFX I2C Protocol.
 		CmdLib_SetOptigaCommsContext(p_comms);
 
+		//The chip behind the comms context may have changed, the entries of other comms contexts are kept
+		__optiga_util_metadata_cache_clear(0);
+
 		//Open the application in Security Chip
 		sOpenApp.eOpenType = eInit;
 		status = CmdLib_OpenApplication(&sOpenApp);
@@ -106,6 +240,12 @@ optiga_lib_status_t optiga_util_read_data(uint16_t optiga_oid, uint16_t offset,
             break;
         }
 
+        if(__optiga_util_access_denied(optiga_oid, OPTIGA_UTIL_METADATA_READ_ACCESS))
+        {
+            status = OPTIGA_UTIL_ERROR_ACCESS_DENIED;
+            break;
+        }
+
         cmd_params.wOID = optiga_oid;
         cmd_params.wLength = *buffer_size;
         cmd_params.wOffset = offset;
@@ -133,7 +273,7 @@ optiga_lib_status_t optiga_util_read_metadata(uint16_t optiga_oid, uint8_t * p_b
     int32_t status  = (int32_t)OPTIGA_LIB_ERROR;
     sGetData_d cmd_params;
     sCmdResponse_d cmd_resp;
-    uint16_t buffer_limit = *buffer_size;
+    uint16_t buffer_limit;
 
     do
     {
@@ -142,10 +282,11 @@ optiga_lib_status_t optiga_util_read_metadata(uint16_t optiga_oid, uint8_t * p_b
             status = (int32_t)OPTIGA_LIB_ERROR;
             break;
         }
+        buffer_limit = *buffer_size;
 
-        //Get metadata of OID
+        //Get metadata of OID, as much as the buffer holds so that no TLV is cut off
         cmd_params.wOID = optiga_oid;
-        cmd_params.wLength = LENGTH_METADATA;
+        cmd_params.wLength = buffer_limit;
         cmd_params.wOffset = 0;
         cmd_params.eDataOrMdata = eMETA_DATA;
 
@@ -167,15 +308,344 @@ optiga_lib_status_t optiga_util_read_metadata(uint16_t optiga_oid, uint8_t * p_b
 
 }
 
-optiga_lib_status_t optiga_util_write_data(uint16_t optiga_oid, uint8_t write_type, uint16_t offset, uint8_t * p_buffer, uint16_t buffer_size)
+optiga_lib_status_t optiga_util_parse_metadata(const uint8_t * metadata, uint16_t metadata_length,
+                                               optiga_util_metadata_t * parsed)
+{
+    int32_t status = OPTIGA_UTIL_ERROR_INVALID_INPUT;
+    optiga_util_access_condition_t * p_access;
+    uint16_t access_flag = 0;
+    const uint8_t * value;
+    uint16_t offset = 2;
+    uint16_t end;
+    uint8_t length;
+
+    do
+    {
+        if ((NULL == metadata) || (NULL == parsed))
+        {
+            break;
+        }
+        OCP_MEMSET(parsed, 0, sizeof(*parsed));
+
+        //Metadata TLV: 0x20, length, followed by the tags (tag, length, value)
+        status = OPTIGA_UTIL_ERROR;
+        if ((metadata_length < 2) || (OPTIGA_UTIL_TAG_METADATA != metadata[0]) ||
+            ((2 + metadata[1]) > metadata_length))
+        {
+            break;
+        }
+        end = 2 + metadata[1];
+
+        while ((offset + 2) <= end)
+        {
+            length = metadata[offset + 1];
+            value = &metadata[offset + 2];
+            if ((offset + 2 + length) > end)
+            {
+                break;
+            }
+            p_access = NULL;
+            switch (metadata[offset])
+            {
+                case OPTIGA_UTIL_TAG_LCSO:
+                {
+                    if (1 == length)
+                    {
+                        parsed->lcso = value[0];
+                        parsed->present |= OPTIGA_UTIL_METADATA_LCSO;
+                    }
+                }
+                break;
+                case OPTIGA_UTIL_TAG_VERSION:
+                {
+                    if (2 == length)
+                    {
+                        parsed->version = (uint16_t)((value[0] << 8) | value[1]);
+                        parsed->present |= OPTIGA_UTIL_METADATA_VERSION;
+                    }
+                }
+                break;
+                case OPTIGA_UTIL_TAG_MAX_SIZE:
+                case OPTIGA_UTIL_TAG_USED_SIZE:
+                {
+                    if ((0 == length) || (length > 2))
+                    {
+                        break;
+                    }
+                    if (OPTIGA_UTIL_TAG_MAX_SIZE == metadata[offset])
+                    {
+                        parsed->max_size = (1 == length) ? value[0] : (uint16_t)((value[0] << 8) | value[1]);
+                        parsed->present |= OPTIGA_UTIL_METADATA_MAX_SIZE;
+                    }
+                    else
+                    {
+                        parsed->used_size = (1 == length) ? value[0] : (uint16_t)((value[0] << 8) | value[1]);
+                        parsed->present |= OPTIGA_UTIL_METADATA_USED_SIZE;
+                    }
+                }
+                break;
+                case OPTIGA_UTIL_TAG_CHANGE_ACCESS:
+                {
+                    p_access = &parsed->change_access;
+                    access_flag = OPTIGA_UTIL_METADATA_CHANGE_ACCESS;
+                }
+                break;
+                case OPTIGA_UTIL_TAG_READ_ACCESS:
+                {
+                    p_access = &parsed->read_access;
+                    access_flag = OPTIGA_UTIL_METADATA_READ_ACCESS;
+                }
+                break;
+                case OPTIGA_UTIL_TAG_EXECUTE_ACCESS:
+                {
+                    p_access = &parsed->execute_access;
+                    access_flag = OPTIGA_UTIL_METADATA_EXECUTE_ACCESS;
+                }
+                break;
+                case OPTIGA_UTIL_TAG_ALGORITHM:
+                {
+                    if (1 == length)
+                    {
+                        parsed->algorithm = value[0];
+                        parsed->present |= OPTIGA_UTIL_METADATA_ALGORITHM;
+                    }
+                }
+                break;
+                case OPTIGA_UTIL_TAG_KEY_USAGE:
+                {
+                    if (1 == length)
+                    {
+                        parsed->key_usage = value[0];
+                        parsed->present |= OPTIGA_UTIL_METADATA_KEY_USAGE;
+                    }
+                }
+                break;
+                case OPTIGA_UTIL_TAG_DATA_OBJECT_TYPE:
+                {
+                    if (1 == length)
+                    {
+                        parsed->data_object_type = value[0];
+                        parsed->present |= OPTIGA_UTIL_METADATA_DATA_OBJECT_TYPE;
+                    }
+                }
+                break;
+                default:
+                break;
+            }
+            //Access conditions which do not fit are not kept
+            if ((NULL != p_access) && (0 != length) && (length <= OPTIGA_UTIL_METADATA_MAX_ACCESS_LENGTH))
+            {
+                p_access->length = length;
+                OCP_MEMCPY(p_access->value, value, length);
+                parsed->present |= access_flag;
+            }
+            offset += 2 + length;
+        }
+        if (offset != end)
+        {
+            break;
+        }
+        status = OPTIGA_LIB_SUCCESS;
+    }while(FALSE);
+
+    return status;
+}
+
+optiga_lib_status_t optiga_util_get_metadata(uint16_t optiga_oid, optiga_util_metadata_t * metadata)
+{
+    int32_t status  = (int32_t)OPTIGA_LIB_ERROR;
+    uint8_t buffer[OPTIGA_UTIL_METADATA_BUFFER_SIZE];
+    uint16_t buffer_length = sizeof(buffer);
+    optiga_util_metadata_cache_t * p_entry;
+
+    do
+    {
+        if((NULL == metadata) || (0 == optiga_oid))
+        {
+            status = OPTIGA_UTIL_ERROR_INVALID_INPUT;
+            break;
+        }
+
+        p_entry = __optiga_util_metadata_cache_find(optiga_oid);
+        if(NULL != p_entry)
+        {
+            *metadata = p_entry->metadata;
+            status = OPTIGA_LIB_SUCCESS;
+            break;
+        }
+
+        status = optiga_util_read_metadata(optiga_oid, buffer, &buffer_length);
+        if(OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+
+        status = optiga_util_parse_metadata(buffer, buffer_length, metadata);
+        if(OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        __optiga_util_metadata_cache_store(optiga_oid, metadata);
+    }while(FALSE);
+
+    return status;
+}
+
+optiga_lib_status_t optiga_util_get_data_size(uint16_t optiga_oid, uint16_t * used_size)
+{
+    int32_t status  = (int32_t)OPTIGA_LIB_ERROR;
+    optiga_util_metadata_t metadata;
+
+    do
+    {
+        if(NULL == used_size)
+        {
+            status = OPTIGA_UTIL_ERROR_INVALID_INPUT;
+            break;
+        }
+
+        status = optiga_util_get_metadata(optiga_oid, &metadata);
+        if(OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+
+        if(0 == (OPTIGA_UTIL_METADATA_USED_SIZE & metadata.present))
+        {
+            status = OPTIGA_UTIL_ERROR;
+            break;
+        }
+        *used_size = metadata.used_size;
+    }while(FALSE);
+
+    return status;
+}
+
+optiga_lib_status_t optiga_util_read_data_exact(uint16_t optiga_oid, uint16_t offset,
+                                                uint8_t * p_buffer, uint16_t* buffer_size)
+{
+    int32_t status  = (int32_t)OPTIGA_LIB_ERROR;
+    uint16_t used_size = 0;
+    uint16_t buffer_limit;
+    optiga_util_metadata_cache_t * p_entry;
+
+    do
+    {
+        if((NULL == p_buffer) || (NULL == buffer_size) || (0 == *buffer_size))
+        {
+            status = OPTIGA_UTIL_ERROR_INVALID_INPUT;
+            break;
+        }
+        buffer_limit = *buffer_size;
+
+        //The used size is read from the metadata if it is not cached yet, the metadata is cached for the next reads
+        status = optiga_util_get_data_size(optiga_oid, &used_size);
+        if(OPTIGA_UTIL_ERROR == status)
+        {
+            //No used size in the metadata, the end is detected by a short read
+            status = optiga_util_read_data(optiga_oid, offset, p_buffer, buffer_size);
+            if(OPTIGA_LIB_SUCCESS != status)
+            {
+                *buffer_size = 0;
+                break;
+            }
+            //The short read ended at the used size, which is kept for the next reads
+            p_entry = __optiga_util_metadata_cache_find(optiga_oid);
+            if((NULL != p_entry) && (*buffer_size < buffer_limit))
+            {
+                p_entry->metadata.used_size = offset + *buffer_size;
+                p_entry->metadata.present |= OPTIGA_UTIL_METADATA_USED_SIZE;
+            }
+            break;
+        }
+        if(OPTIGA_LIB_SUCCESS != status)
+        {
+            *buffer_size = 0;
+            break;
+        }
+
+        if(offset > used_size)
+        {
+            *buffer_size = 0;
+            status = OPTIGA_UTIL_ERROR_INVALID_INPUT;
+            break;
+        }
+        if(offset == used_size)
+        {
+            *buffer_size = 0;
+            status = OPTIGA_LIB_SUCCESS;
+            break;
+        }
+
+        //Request exactly the stored bytes, the command library stops once they are received
+        if(*buffer_size < (used_size - offset))
+        {
+            *buffer_size = 0;
+            status = OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+        *buffer_size = used_size - offset;
+        status = optiga_util_read_data(optiga_oid, offset, p_buffer, buffer_size);
+        if(OPTIGA_LIB_SUCCESS != status)
+        {
+            *buffer_size = 0;
+        }
+    }while(FALSE);
+
+    return status;
+}
+
+/// @cond hidden
+///Position in the fragments of #optiga_util_write_data_vector
+typedef struct optiga_util_fragment_iterator
+{
+    const optiga_util_data_fragment_t * fragments;
+    uint8_t count;
+    uint8_t index;
+    uint16_t offset;
+} optiga_util_fragment_iterator_t;
+/// @endcond
+
+//Copies the next bytes of the fragments into the command buffer
+static uint16_t __optiga_util_fragment_gather(Void * ctx, uint8_t * dest, uint16_t length)
+{
+    optiga_util_fragment_iterator_t * iterator = (optiga_util_fragment_iterator_t *)ctx;
+    uint16_t copied = 0;
+    uint16_t chunk;
+
+    while ((copied < length) && (iterator->index < iterator->count))
+    {
+        //Fragments with a length of 0 are not accessed at all
+        if (iterator->offset == iterator->fragments[iterator->index].length)
+        {
+            iterator->index++;
+            iterator->offset = 0;
+            continue;
+        }
+        chunk = iterator->fragments[iterator->index].length - iterator->offset;
+        if (chunk > (length - copied))
+        {
+            chunk = length - copied;
+        }
+        OCP_MEMCPY(dest + copied, iterator->fragments[iterator->index].buffer + iterator->offset, chunk);
+        copied += chunk;
+        iterator->offset += chunk;
+    }
+    return copied;
+}
+
+//Writes the data from p_buffer or, if gather is not NULL, from the gather
+static optiga_lib_status_t __optiga_util_write_data(uint16_t optiga_oid, uint8_t write_type, uint16_t offset,
+                                                    uint8_t * p_buffer, const sDataGather_d * gather, uint16_t buffer_size)
 {
     int32_t status  = (int32_t)OPTIGA_LIB_ERROR;
+    optiga_util_metadata_cache_t * p_entry;
 
     sSetData_d sd_params;
 
     do
     {
-        if((NULL == p_buffer) || (0x00 == buffer_size))
+        if(((NULL == p_buffer) && (NULL == gather)) || (0x00 == buffer_size))
         {
             break;
         }
@@ -186,6 +656,12 @@ optiga_lib_status_t optiga_util_write_data(uint16_t optiga_oid, uint8_t write_ty
             break;
         }
 
+        if (__optiga_util_access_denied(optiga_oid, OPTIGA_UTIL_METADATA_CHANGE_ACCESS))
+        {
+            status = OPTIGA_UTIL_ERROR_ACCESS_DENIED;
+            break;
+        }
+
         sd_params.wOID = optiga_oid;
         sd_params.wOffset = offset;
         sd_params.eDataOrMdata = eDATA;
@@ -200,17 +676,71 @@ optiga_lib_status_t optiga_util_write_data(uint16_t optiga_oid, uint8_t write_ty
         sd_params.prgbData = p_buffer;
         sd_params.wLength = buffer_size;
 
-        status = CmdLib_SetDataObject(&sd_params);
+        status = (NULL != gather) ? CmdLib_SetDataObjectVector(&sd_params, gather) : CmdLib_SetDataObject(&sd_params);
         if(CMD_LIB_OK != status)
         {
+            //The data object may be written partially
+            __optiga_util_metadata_cache_clear(optiga_oid);
             break;
         }
+
+        p_entry = __optiga_util_metadata_cache_find(optiga_oid);
+        if((NULL != p_entry) && (OPTIGA_UTIL_METADATA_USED_SIZE & p_entry->metadata.present))
+        {
+            if((OPTIGA_UTIL_ERASE_AND_WRITE == write_type) || ((offset + buffer_size) > p_entry->metadata.used_size))
+            {
+                p_entry->metadata.used_size = offset + buffer_size;
+            }
+        }
         status = OPTIGA_LIB_SUCCESS;
     }while(FALSE);
 
     return status;
 }
 
+optiga_lib_status_t optiga_util_write_data(uint16_t optiga_oid, uint8_t write_type, uint16_t offset, uint8_t * p_buffer, uint16_t buffer_size)
+{
+    return __optiga_util_write_data(optiga_oid, write_type, offset, p_buffer, NULL, buffer_size);
+}
+
+optiga_lib_status_t optiga_util_write_data_vector(uint16_t optiga_oid, uint8_t write_type, uint16_t offset,
+                                                  const optiga_util_data_fragment_t * fragments, uint8_t count)
+{
+    optiga_util_fragment_iterator_t iterator;
+    sDataGather_d gather;
+    uint32_t total_length = 0;
+    uint8_t index;
+
+    if((NULL == fragments) || (0 == count))
+    {
+        return OPTIGA_UTIL_ERROR_INVALID_INPUT;
+    }
+
+    for(index = 0; index < count; index++)
+    {
+        if((NULL == fragments[index].buffer) && (0 != fragments[index].length))
+        {
+            return OPTIGA_UTIL_ERROR_INVALID_INPUT;
+        }
+        total_length += fragments[index].length;
+    }
+
+    if((0 == total_length) || (0xFFFF < total_length))
+    {
+        return OPTIGA_UTIL_ERROR_INVALID_INPUT;
+    }
+
+    iterator.fragments = fragments;
+    iterator.count     = count;
+    iterator.index     = 0;
+    iterator.offset    = 0;
+
+    gather.pfGather = __optiga_util_fragment_gather;
+    gather.pCtx     = &iterator;
+
+    return __optiga_util_write_data(optiga_oid, write_type, offset, NULL, &gather, (uint16_t)total_length);
+}
+
 optiga_lib_status_t optiga_util_write_metadata(uint16_t optiga_oid, uint8_t * p_buffer, uint8_t buffer_size)
 {
 
@@ -225,6 +755,9 @@ optiga_lib_status_t optiga_util_write_metadata(uint16_t optiga_oid, uint8_t * p_
     sd_params.prgbData = p_buffer;
     sd_params.wLength = buffer_size;
 
+    //The used size is read again on the next use
+    __optiga_util_metadata_cache_clear(optiga_oid);
+
     status = CmdLib_SetDataObject(&sd_params);
     if(CMD_LIB_OK != status)
     {
@@ -234,4 +767,291 @@ optiga_lib_status_t optiga_util_write_metadata(uint16_t optiga_oid, uint8_t * p_
     return OPTIGA_LIB_SUCCESS;
 }
 
+#ifdef OPTIGA_UTIL_CERT_COMPRESSION
+
+/// @cond hidden
+///Length of the header of a compressed certificate (tag and certificate length)
+#define OPTIGA_UTIL_CERT_HEADER_LENGTH      (3)
+///Shortest match, a match takes 3 bytes
+#define OPTIGA_UTIL_CERT_MIN_MATCH          (4)
+///Longest match
+#define OPTIGA_UTIL_CERT_MAX_MATCH          (0x7F + OPTIGA_UTIL_CERT_MIN_MATCH)
+///Longest run of literals
+#define OPTIGA_UTIL_CERT_MAX_LITERALS       (0x80)
+///Control byte of a match, the lower bits hold the match length
+#define OPTIGA_UTIL_CERT_MATCH              (0x80)
+///Largest distance of a match
+#define OPTIGA_UTIL_CERT_MAX_DISTANCE       (0xFFFF)
+
+///Preset dictionary of DER fragments of X.509 certificates with ECC P-256 keys, as issued for OPTIGA Trust X.
+///A match may refer to it as if it preceded the certificate. Must never change, stored certificates depend on it.
+static const uint8_t optiga_util_cert_dictionary[] =
+{
+    0x30, 0x82, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce,
+    0x3d, 0x04, 0x03, 0x02, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x03,
+    0x31, 0x0b, 0x30, 0x09, 0x06, 0x03, 0x55, 0x04, 0x06, 0x13, 0x02, 0x44, 0x45, 0x31, 0x21, 0x30,
+    0x1f, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x18, 0x49, 0x6e, 0x66, 0x69, 0x6e, 0x65, 0x6f, 0x6e,
+    0x20, 0x54, 0x65, 0x63, 0x68, 0x6e, 0x6f, 0x6c, 0x6f, 0x67, 0x69, 0x65, 0x73, 0x20, 0x41, 0x47,
+    0x31, 0x13, 0x30, 0x11, 0x06, 0x03, 0x55, 0x04, 0x0b, 0x0c, 0x0a, 0x4f, 0x50, 0x54, 0x49, 0x47,
+    0x41, 0x28, 0x54, 0x4d, 0x29, 0x31, 0x2b, 0x30, 0x29, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x22,
+    0x49, 0x6e, 0x66, 0x69, 0x6e, 0x65, 0x6f, 0x6e, 0x20, 0x4f, 0x50, 0x54, 0x49, 0x47, 0x41, 0x28,
+    0x54, 0x4d, 0x29, 0x20, 0x54, 0x72, 0x75, 0x73, 0x74, 0x20, 0x58, 0x20, 0x43, 0x41, 0x20, 0x31,
+    0x30, 0x31, 0x30, 0x1e, 0x17, 0x0d, 0x5a, 0x17, 0x0d, 0x31, 0x18, 0x30, 0x16, 0x06, 0x03, 0x55,
+    0x04, 0x03, 0x0c, 0x0f, 0x49, 0x6e, 0x66, 0x69, 0x6e, 0x65, 0x6f, 0x6e, 0x49, 0x6f, 0x54, 0x4e,
+    0x6f, 0x64, 0x65, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01,
+    0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0xa3, 0x81,
+    0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x30, 0x0e, 0x06, 0x03, 0x55,
+    0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x07, 0x80, 0x30, 0x0c, 0x06, 0x03, 0x55,
+    0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30, 0x00, 0x30, 0x15, 0x06, 0x03, 0x55, 0x1d, 0x20,
+    0x04, 0x0e, 0x30, 0x0c, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x82, 0x14, 0x00, 0x44, 0x01, 0x14, 0x01,
+    0x30, 0x53, 0x06, 0x03, 0x55, 0x1d, 0x1f, 0x04, 0x4c, 0x30, 0x4a, 0x30, 0x48, 0xa0, 0x46, 0xa0,
+    0x44, 0x86, 0x42, 0x68, 0x74, 0x74, 0x70, 0x3a, 0x2f, 0x2f, 0x70, 0x6b, 0x69, 0x2e, 0x69, 0x6e,
+    0x66, 0x69, 0x6e, 0x65, 0x6f, 0x6e, 0x2e, 0x63, 0x6f, 0x6d, 0x2f, 0x4f, 0x70, 0x74, 0x69, 0x67,
+    0x61, 0x54, 0x72, 0x75, 0x73, 0x74, 0x45, 0x63, 0x63, 0x43, 0x41, 0x31, 0x30, 0x31, 0x2f, 0x4f,
+    0x70, 0x74, 0x69, 0x67, 0x61, 0x54, 0x72, 0x75, 0x73, 0x74, 0x45, 0x63, 0x63, 0x43, 0x41, 0x31,
+    0x30, 0x31, 0x2e, 0x63, 0x72, 0x6c, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30,
+    0x16, 0x80, 0x14, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x21, 0x00, 0x02, 0x20, 0x02, 0x21, 0x00
+};
+/// @endcond
+
+//Byte of the window, which is the dictionary followed by the certificate
+static uint8_t __optiga_util_cert_window(const uint8_t * cert, uint32_t position)
+{
+    if (position < sizeof(optiga_util_cert_dictionary))
+    {
+        return optiga_util_cert_dictionary[position];
+    }
+    return cert[position - sizeof(optiga_util_cert_dictionary)];
+}
+
+optiga_lib_status_t optiga_util_compress_cert(const uint8_t * p_cert, uint16_t cert_length,
+                                              uint8_t * p_buffer, uint16_t * buffer_size)
+{
+    int32_t status = OPTIGA_UTIL_ERROR_INVALID_INPUT;
+    uint32_t window_end;
+    uint32_t candidate;
+    uint32_t best_distance = 0;
+    uint16_t best_length;
+    uint16_t length;
+    uint16_t in = 0;
+    uint16_t out = OPTIGA_UTIL_CERT_HEADER_LENGTH;
+    uint16_t literal_control = 0;
+    uint8_t literal_count = 0;
+
+    do
+    {
+        if((NULL == p_cert) || (0 == cert_length) || (NULL == p_buffer) || (NULL == buffer_size))
+        {
+            break;
+        }
+
+        status = OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT;
+        if(*buffer_size < OPTIGA_UTIL_CERT_HEADER_LENGTH)
+        {
+            break;
+        }
+        p_buffer[0] = OPTIGA_UTIL_CERT_COMPRESSED_TAG;
+        p_buffer[1] = (uint8_t)(cert_length >> 8);
+        p_buffer[2] = (uint8_t)cert_length;
+
+        while(in < cert_length)
+        {
+            //Longest match in the window, greedy
+            window_end = sizeof(optiga_util_cert_dictionary) + in;
+            candidate = (window_end > OPTIGA_UTIL_CERT_MAX_DISTANCE) ? (window_end - OPTIGA_UTIL_CERT_MAX_DISTANCE) : 0;
+            best_length = 0;
+            for(; candidate < window_end; candidate++)
+            {
+                //A match may overlap the bytes it produces
+                length = 0;
+                while((length < OPTIGA_UTIL_CERT_MAX_MATCH) && ((in + length) < cert_length) &&
+                      (__optiga_util_cert_window(p_cert, candidate + length) == p_cert[in + length]))
+                {
+                    length++;
+                }
+                if(length > best_length)
+                {
+                    best_length = length;
+                    best_distance = window_end - candidate;
+                }
+            }
+
+            if(best_length >= OPTIGA_UTIL_CERT_MIN_MATCH)
+            {
+                if((out + 3) > *buffer_size)
+                {
+                    break;
+                }
+                literal_count = 0;
+                p_buffer[out++] = (uint8_t)(OPTIGA_UTIL_CERT_MATCH | (best_length - OPTIGA_UTIL_CERT_MIN_MATCH));
+                p_buffer[out++] = (uint8_t)(best_distance >> 8);
+                p_buffer[out++] = (uint8_t)best_distance;
+                in += best_length;
+            }
+            else
+            {
+                if(0 == literal_count)
+                {
+                    if(out >= *buffer_size)
+                    {
+                        break;
+                    }
+                    literal_control = out++;
+                }
+                if(out >= *buffer_size)
+                {
+                    break;
+                }
+                p_buffer[out++] = p_cert[in++];
+                p_buffer[literal_control] = literal_count++;
+                if(OPTIGA_UTIL_CERT_MAX_LITERALS == literal_count)
+                {
+                    literal_count = 0;
+                }
+            }
+        }
+        if(in < cert_length)
+        {
+            break;
+        }
+
+        *buffer_size = out;
+        status = OPTIGA_LIB_SUCCESS;
+    }while(FALSE);
+
+    return status;
+}
+
+optiga_lib_status_t optiga_util_decompress_cert(const uint8_t * p_data, uint16_t data_length,
+                                                uint8_t * p_buffer, uint16_t * buffer_size)
+{
+    int32_t status = OPTIGA_UTIL_ERROR_INVALID_INPUT;
+    uint16_t cert_length;
+    uint16_t in = OPTIGA_UTIL_CERT_HEADER_LENGTH;
+    uint16_t out = 0;
+    uint16_t length;
+    uint32_t distance;
+    uint32_t position;
+    uint8_t in_place;
+
+    do
+    {
+        if((NULL == p_data) || (data_length < OPTIGA_UTIL_CERT_HEADER_LENGTH) || (NULL == p_buffer) ||
+           (NULL == buffer_size) || (OPTIGA_UTIL_CERT_COMPRESSED_TAG != p_data[0]))
+        {
+            break;
+        }
+
+        cert_length = (uint16_t)((p_data[1] << 8) | p_data[2]);
+        if(cert_length > *buffer_size)
+        {
+            status = OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+        //The compressed data may be stored at the end of the buffer, then writing must not pass reading
+        in_place = ((p_data >= p_buffer) && (p_data < (p_buffer + *buffer_size))) ? TRUE : FALSE;
+
+        while(in < data_length)
+        {
+            if(OPTIGA_UTIL_CERT_MATCH & p_data[in])
+            {
+                if((in + 3) > data_length)
+                {
+                    break;
+                }
+                length = (p_data[in] & (uint8_t)~OPTIGA_UTIL_CERT_MATCH) + OPTIGA_UTIL_CERT_MIN_MATCH;
+                distance = ((uint32_t)p_data[in + 1] << 8) | p_data[in + 2];
+                in += 3;
+                position = sizeof(optiga_util_cert_dictionary) + out;
+                if((0 == distance) || (distance > position) || ((out + length) > cert_length) ||
+                   (in_place && ((p_buffer + out + length) > (p_data + in))))
+                {
+                    break;
+                }
+                position -= distance;
+                while(length--)
+                {
+                    p_buffer[out++] = __optiga_util_cert_window(p_buffer, position++);
+                }
+            }
+            else
+            {
+                length = p_data[in++] + 1;
+                if(((in + length) > data_length) || ((out + length) > cert_length) ||
+                   (in_place && ((p_buffer + out) > (p_data + in))))
+                {
+                    break;
+                }
+                while(length--)
+                {
+                    p_buffer[out++] = p_data[in++];
+                }
+            }
+        }
+        if((in != data_length) || (out != cert_length))
+        {
+            status = in_place ? OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT : OPTIGA_UTIL_ERROR;
+            break;
+        }
+
+        *buffer_size = cert_length;
+        status = OPTIGA_LIB_SUCCESS;
+    }while(FALSE);
+
+    return status;
+}
+
+optiga_lib_status_t optiga_util_read_cert(uint16_t optiga_oid, uint8_t * p_buffer, uint16_t * buffer_size)
+{
+    int32_t status = OPTIGA_UTIL_ERROR_INVALID_INPUT;
+    uint16_t buffer_limit;
+    uint16_t stored_length;
+
+    do
+    {
+        if((NULL == p_buffer) || (NULL == buffer_size) || (0 == *buffer_size))
+        {
+            break;
+        }
+        buffer_limit = *buffer_size;
+        stored_length = buffer_limit;
+
+        status = optiga_util_read_data_exact(optiga_oid, 0, p_buffer, &stored_length);
+        if(OPTIGA_LIB_SUCCESS != status)
+        {
+            *buffer_size = 0;
+            break;
+        }
+        *buffer_size = stored_length;
+        //Certificates stored in other formats are returned as they are
+        if((0 == stored_length) || (OPTIGA_UTIL_CERT_COMPRESSED_TAG != p_buffer[0]))
+        {
+            break;
+        }
+
+        //Decompress in place from the end of the buffer
+        memmove(p_buffer + (buffer_limit - stored_length), p_buffer, stored_length);
+        *buffer_size = buffer_limit;
+        status = optiga_util_decompress_cert(p_buffer + (buffer_limit - stored_length), stored_length,
+                                             p_buffer, buffer_size);
+        if(OPTIGA_LIB_SUCCESS != status)
+        {
+            *buffer_size = 0;
+        }
+    }while(FALSE);
+
+    return status;
+}
+
+/// @cond hidden
+#undef OPTIGA_UTIL_CERT_HEADER_LENGTH
+#undef OPTIGA_UTIL_CERT_MIN_MATCH
+#undef OPTIGA_UTIL_CERT_MAX_MATCH
+#undef OPTIGA_UTIL_CERT_MAX_LITERALS
+#undef OPTIGA_UTIL_CERT_MATCH
+#undef OPTIGA_UTIL_CERT_MAX_DISTANCE
+/// @endcond
+
+#endif //OPTIGA_UTIL_CERT_COMPRESSION
+
 #endif // MODULE_ENABLE_READ_WRITE
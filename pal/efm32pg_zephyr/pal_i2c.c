@@ -36,6 +36,7 @@
  *********************************************************************************************************************/
 /* Optiga based includes */
 #include <optiga/pal/pal_i2c.h>
+#include "pal_zephyr.h"
 
 /* Zephyr based includes */
 #include <zephyr.h>
@@ -46,7 +47,6 @@
 /**********************************************************************************************************************
  * MACROS
  *********************************************************************************************************************/
-#define I2C_DEVICE_NAME     DT_ALIAS_I2C_0_LABEL
 #define SEM_INIT_VALUE      1
 #define SEM_MAX_VALUE       1
 #define SEM_TAKE_SUCCESS    0
@@ -54,11 +54,73 @@
 /*********************************************************************************************************************
  * LOCAL DATA
  *********************************************************************************************************************/
-/* Structure for holding I2C device context */
-struct device *p_i2c_dev;
+/* Each i2c_ctx_t holds its device, bus lock and transfer work, so several buses can be used at once */
 
-/* binary semaphore for mutual exclusion for i2c bus */
-K_SEM_DEFINE(i2c_bus_lock, SEM_INIT_VALUE, SEM_MAX_VALUE);
+/**********************************************************************************************************************
+ * LOCAL ROUTINES
+ *********************************************************************************************************************/
+/**
+*  Transfer work handler, runs in the work queue of the stack.
+*
+*  Performs the pending transfer of the bus, releases the bus and then informs the upper layer,
+*  which may start the next transfer right away.<br>
+*
+*\param[in] work Transfer work item of the bus
+*/
+static void pal_i2c_transfer_handler(struct k_work *work)
+{
+    i2c_ctx_t *bus = CONTAINER_OF(work, i2c_ctx_t, transfer);
+    pal_i2c_t *p_i2c_context = bus->p_pending;
+    app_event_handler_t upper_layer_handler =
+            (app_event_handler_t)p_i2c_context->upper_layer_event_handler;
+    int result;
+
+    if (bus->is_read) {
+        result = i2c_read(bus->p_device, bus->p_data, (u32_t)bus->length,
+                          (u16_t)(p_i2c_context->slave_address));
+    } else {
+        result = i2c_write(bus->p_device, bus->p_data, (u32_t)bus->length,
+                           (u16_t)(p_i2c_context->slave_address));
+    }
+
+    bus->p_pending = NULL;
+    k_sem_give(&bus->bus_lock);
+
+    upper_layer_handler(p_i2c_context->upper_layer_ctx,
+                        (result == 0) ? PAL_I2C_EVENT_SUCCESS : PAL_I2C_EVENT_ERROR);
+}
+
+/**
+*  Acquires the bus and submits the transfer to the work queue of the stack.
+*
+*\param[in] p_i2c_context  Pointer to the pal I2C context #pal_i2c_t
+*\param[in] p_data         Pointer to the data buffer
+*\param[in] length         Length of the data
+*\param[in] is_read        1 to read from the slave, 0 to write to it
+*/
+static pal_status_t pal_i2c_submit(pal_i2c_t* p_i2c_context, uint8_t* p_data,
+                                   uint16_t length, uint8_t is_read)
+{
+    i2c_ctx_t *bus = (i2c_ctx_t*)p_i2c_context->p_i2c_hw_config;
+    app_event_handler_t upper_layer_handler =
+            (app_event_handler_t)p_i2c_context->upper_layer_event_handler;
+
+    if ((bus->p_init_flag == 0) ||
+        (k_sem_take(&bus->bus_lock, K_NO_WAIT) != SEM_TAKE_SUCCESS)) {
+        upper_layer_handler(p_i2c_context->upper_layer_ctx,
+                            PAL_I2C_EVENT_BUSY);
+        return PAL_STATUS_I2C_BUSY;
+    }
+
+    /* the bus is held till the transfer work completes */
+    bus->p_pending = p_i2c_context;
+    bus->p_data = p_data;
+    bus->length = length;
+    bus->is_read = is_read;
+    k_work_submit_to_queue(&pal_zephyr_work_q, &bus->transfer);
+
+    return PAL_STATUS_SUCCESS;
+}
 
 /**********************************************************************************************************************
  * API IMPLEMENTATION
@@ -88,10 +150,20 @@ K_SEM_DEFINE(i2c_bus_lock, SEM_INIT_VALUE, SEM_MAX_VALUE);
  */
 pal_status_t pal_i2c_init(const pal_i2c_t* p_i2c_context)
 {
-    p_i2c_dev = device_get_binding(I2C_DEVICE_NAME);
+    i2c_ctx_t *bus = (i2c_ctx_t*)p_i2c_context->p_i2c_hw_config;
 
-    if (p_i2c_dev == 0) {
-        return PAL_STATUS_FAILURE;
+    /* repeated init, e.g. by several slaves on the bus, keeps the bus state */
+    if (bus->p_init_flag == 0) {
+        bus->p_device = device_get_binding(bus->p_dev_name);
+
+        if (bus->p_device == NULL) {
+            return PAL_STATUS_FAILURE;
+        }
+
+        k_sem_init(&bus->bus_lock, SEM_INIT_VALUE, SEM_MAX_VALUE);
+        k_work_init(&bus->transfer, pal_i2c_transfer_handler);
+        bus->p_pending = NULL;
+        bus->p_init_flag = 1;
     }
 
     return PAL_STATUS_SUCCESS;
@@ -159,38 +231,7 @@ pal_status_t pal_i2c_deinit(const pal_i2c_t* p_i2c_context)
 pal_status_t pal_i2c_write(pal_i2c_t *p_i2c_context, uint8_t *p_data,
                            uint16_t length)
 {
-    int lock_result;
-    pal_status_t status;
-    app_event_handler_t upper_layer_handler =
-            (app_event_handler_t)p_i2c_context->upper_layer_event_handler;
-
-
-    lock_result = k_sem_take(&i2c_bus_lock, K_NO_WAIT);
-
-    if (lock_result == SEM_TAKE_SUCCESS) {
-        int i2c_result;
-
-        i2c_result = i2c_write(p_i2c_dev, p_data, (u32_t)length,
-                           p_i2c_context->slave_address);
-
-        if (i2c_result == 0) {
-            upper_layer_handler(p_i2c_context->upper_layer_ctx,
-                                PAL_I2C_EVENT_SUCCESS);
-            status = PAL_STATUS_SUCCESS;
-        } else {
-            upper_layer_handler(p_i2c_context->upper_layer_ctx,
-                                PAL_I2C_EVENT_ERROR);
-            status = PAL_STATUS_FAILURE;
-        }
-
-        k_sem_give(&i2c_bus_lock);
-    } else {
-        status = PAL_STATUS_I2C_BUSY;
-        upper_layer_handler(p_i2c_context->upper_layer_ctx,
-                            PAL_I2C_EVENT_BUSY);
-    }
-
-    return status;
+    return pal_i2c_submit(p_i2c_context, p_data, length, 0);
 }
 
 /**
@@ -227,37 +268,7 @@ pal_status_t pal_i2c_write(pal_i2c_t *p_i2c_context, uint8_t *p_data,
 pal_status_t pal_i2c_read(pal_i2c_t* p_i2c_context, uint8_t* p_data,
                           uint16_t length)
 {
-    int lock_result;
-    pal_status_t status;
-    app_event_handler_t upper_layer_handler =
-            (app_event_handler_t)p_i2c_context->upper_layer_event_handler;
-
-    lock_result = k_sem_take(&i2c_bus_lock, K_NO_WAIT);
-
-    if (lock_result == SEM_TAKE_SUCCESS) {
-        int result;
-
-        result = i2c_read(p_i2c_dev, p_data, (u32_t)length,
-                          (u16_t)(p_i2c_context->slave_address));
-
-        if (result == 0) {
-            upper_layer_handler(p_i2c_context->upper_layer_ctx,
-                                PAL_I2C_EVENT_SUCCESS);
-            status = PAL_STATUS_SUCCESS;
-        } else {
-            upper_layer_handler(p_i2c_context->upper_layer_ctx,
-                                PAL_I2C_EVENT_ERROR);
-            status = PAL_STATUS_FAILURE;
-        }
-
-        k_sem_give(&i2c_bus_lock);
-    } else {
-        status = PAL_STATUS_I2C_BUSY;
-        upper_layer_handler(p_i2c_context->upper_layer_ctx,
-                            PAL_I2C_EVENT_BUSY);
-    }
-
-    return status;
+    return pal_i2c_submit(p_i2c_context, p_data, length, 1);
 }
 
 /**
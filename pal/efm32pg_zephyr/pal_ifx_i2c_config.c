@@ -36,6 +36,7 @@
 /* Optiga based includes */
 #include <optiga/pal/pal_gpio.h>
 #include <optiga/pal/pal_i2c.h>
+#include "pal_zephyr.h"
 
 /* Zephyr based includes */
 #include <zephyr.h>
@@ -51,6 +52,7 @@
 #define I2C_SDA     DT_INST_0_SILABS_GECKO_I2C_LOCATION_SDA_2  /* 10 */
 #define I2C_PORT    2   /* Port C */
 #define I2C_FREQ_HZ DT_INST_0_SILABS_GECKO_I2C_CLOCK_FREQUENCY /* 100 000 Hz */
+#define I2C_DEV_NAME DT_ALIAS_I2C_0_LABEL
 
 #define I2C_OPTIGA_ADDRESS 0x30
 
@@ -63,14 +65,6 @@
 /*********************************************************************************************************************
  * Context structures
  *********************************************************************************************************************/
-/* context for i2c devices */
-typedef struct {
-    uint8_t  p_port;
-    uint8_t  p_scl_io;
-    uint8_t  p_sda_io;
-    uint32_t p_bitrate;
-} i2c_ctx_t;
-
 /* context for gpio devices */
 typedef struct {
     uint8_t         p_pin;
@@ -81,10 +75,11 @@ typedef struct {
 
 /* inicialize context for stk3402a I2C and GPIO on EXP header */
 i2c_ctx_t stk3402a_i2c_ctx = {
-    I2C_PORT,
-    I2C_SCL,
-    I2C_SDA,
-    I2C_FREQ_HZ
+    .p_port     = I2C_PORT,
+    .p_scl_io   = I2C_SCL,
+    .p_sda_io   = I2C_SDA,
+    .p_bitrate  = I2C_FREQ_HZ,
+    .p_dev_name = I2C_DEV_NAME
 };
 
 gpio_ctx_t vdd_stk3402a_gpio_ctx = {
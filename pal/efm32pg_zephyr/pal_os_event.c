@@ -36,77 +36,122 @@
 /* Optiga based includes */
 #include <optiga/pal/pal_os_event.h>
 #include <optiga/pal/pal.h>
+#include "pal_zephyr.h"
 
 /* Zephyr based includes */
 #include <kernel.h>
-
-/**********************************************************************************************************************
- * MACROS
- *********************************************************************************************************************/
-#define TIMER_CALLBACK_STACK_SIZE    1000
-#define CALLBACK_HANDLER_THRD_PRIO   1
-
-#define SEM_INIT_VALUE      0
-#define SEM_MAX_VALUE       1
+#include <init.h>
 
 /*********************************************************************************************************************
  * LOCAL DATA
  *********************************************************************************************************************/
-typedef struct callbacks {
-    volatile register_callback func; /* Callback function when timer elapses */
-    void *args;            /* Pointer to store upper layer callback context */
-} pal_os_event_clbs_t;
+static void timer_expiry_func(struct k_timer *timer);
+static void timer_work_handler(struct k_work *work);
 
-static void timer_callback_func();
-static void callback_handler_thrd(void *unused1, void *unused2, void *unused3);
-
-static pal_os_event_clbs_t clb_ctx_0;
+/* one event context per IFX I2C stack, bound to it on first use */
+static pal_zephyr_event_t pal_zephyr_events[PAL_ZEPHYR_EVENT_CONTEXTS];
 
 /* on boot kernel objects defines */
-K_SEM_DEFINE(timer_lock, SEM_INIT_VALUE, SEM_MAX_VALUE);
-K_TIMER_DEFINE(timer_callback_ctx, timer_callback_func, NULL); /* timer */
-K_THREAD_STACK_DEFINE(callback_stack_area, TIMER_CALLBACK_STACK_SIZE);
-K_THREAD_DEFINE(clb_tid, TIMER_CALLBACK_STACK_SIZE,
-        callback_handler_thrd, NULL, NULL, NULL,
-        CALLBACK_HANDLER_THRD_PRIO, 0, K_NO_WAIT);
+K_THREAD_STACK_DEFINE(pal_zephyr_work_q_stack, PAL_ZEPHYR_WORK_Q_STACK_SIZE);
+struct k_work_q pal_zephyr_work_q;
 
 /**********************************************************************************************************************
  * LOCAL ROUTINES
  *********************************************************************************************************************/
 /**
-*  Timer callback handler.
+*  Returns the event context of an IFX I2C stack, binding a free one on first use.
+*
+*\param[in] p_ctx Context of the stack, passed as callback argument by it
+*
+*etval Event context, NULL if all of them are bound to other stacks
+*/
+static pal_zephyr_event_t *pal_os_event_get(const void *p_ctx)
+{
+    pal_zephyr_event_t *p_event = NULL;
+    unsigned int key;
+    u8_t index;
+
+    key = irq_lock();
+    for (index = 0; index < PAL_ZEPHYR_EVENT_CONTEXTS; index++) {
+        if (p_ctx == pal_zephyr_events[index].p_ctx) {
+            p_event = &pal_zephyr_events[index];
+            break;
+        }
+        if ((NULL == p_event) && (NULL == pal_zephyr_events[index].p_ctx)) {
+            p_event = &pal_zephyr_events[index];
+        }
+    }
+    if ((NULL != p_event) && (NULL == p_event->p_ctx)) {
+        p_event->p_ctx = p_ctx;
+        p_event->func = NULL;
+        k_timer_init(&p_event->timer, timer_expiry_func, NULL);
+        k_work_init(&p_event->work, timer_work_handler);
+        k_sem_init(&p_event->completion, 0, 1);
+    }
+    irq_unlock(key);
+
+    return p_event;
+}
+
+/**
+*  Timer expiry handler, runs in interrupt context.
 *
-*  This get called from the TIMER elapse event.<br>
-*  Once the timer expires, the registered callback funtion gets called from the timer event handler, if
-*  the call back is not NULL.<br>
+*  The registered callback drives the I2C transfers, so it is not invoked here but
+*  in the work queue of the stack.<br>
 *
-*\param[in] unused arguments
+*\param[in] timer Expired timer
 */
-static void callback_handler_thrd(void *unused1, void *unused2, void *unused3)
+static void timer_expiry_func(struct k_timer *timer)
 {
-    ARG_UNUSED(unused1);
-    ARG_UNUSED(unused2);
-    ARG_UNUSED(unused3);
+    pal_zephyr_event_t *p_event = CONTAINER_OF(timer, pal_zephyr_event_t, timer);
+
+    p_event->fired_generation = p_event->generation;
+    k_work_submit_to_queue(&pal_zephyr_work_q, &p_event->work);
+}
 
+/**
+*  Timer work handler, runs in the work queue of the stack.
+*
+*  Invokes the registered callback once, if it was not replaced since the timer expired.<br>
+*
+*\param[in] work Timer work item
+*/
+static void timer_work_handler(struct k_work *work)
+{
+    pal_zephyr_event_t *p_event = CONTAINER_OF(work, pal_zephyr_event_t, work);
     register_callback func = NULL;
     void *func_args = NULL;
+    unsigned int key;
 
-    while (1) {
-        k_sem_take(&timer_lock, K_FOREVER);
+    key = irq_lock();
+    if (p_event->fired_generation == p_event->generation) {
+        func = p_event->func;
+        func_args = p_event->args;
+        p_event->func = NULL;
+    }
+    irq_unlock(key);
 
-        if(clb_ctx_0.func) {
-            func = clb_ctx_0.func;
-            func_args = clb_ctx_0.args;
-            func((void*)func_args);
-        }
+    if (func) {
+        func(func_args);
     }
 }
 
-static void timer_callback_func()
+/**
+*  Starts the work queue of the stack at boot.
+*/
+static int pal_os_event_work_q_init(struct device *dev)
 {
-    k_sem_give(&timer_lock);
+    ARG_UNUSED(dev);
+
+    k_work_q_start(&pal_zephyr_work_q, pal_zephyr_work_q_stack,
+                   K_THREAD_STACK_SIZEOF(pal_zephyr_work_q_stack),
+                   PAL_ZEPHYR_WORK_Q_PRIO);
+
+    return 0;
 }
 
+SYS_INIT(pal_os_event_work_q_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
 /**********************************************************************************************************************
  * API IMPLEMENTATION
  *********************************************************************************************************************/
@@ -115,26 +160,34 @@ static void timer_callback_func()
 * <br>
 *
 * <b>API Details:</b>
-*         This function registers the callback function supplied by the caller.<br>
-*         It triggers a timer with the supplied time interval in microseconds.<br>
-*         Once the timer expires, the registered callback function gets called.<br>
+*         This function registers the callback function supplied by the caller, replacing a pending one
+*         of the same stack. The stack is identified by the callback arguments, its IFX I2C context.<br>
+*         It triggers the timer of the stack with the supplied time interval in microseconds, rounded up to milliseconds.<br>
+*         Once the timer expires, the registered callback function gets called in the work queue of the stack.<br>
 *
 * \param[in] callback              Callback function pointer
 * \param[in] callback_args         Callback arguments
 * \param[in] time_us               time in micro seconds to trigger the call back
 */
-void pal_os_event_register_callback_oneshot(register_callback callback, 
-                                            void* callback_args, 
+void pal_os_event_register_callback_oneshot(register_callback callback,
+                                            void* callback_args,
                                             uint32_t time_us)
 {
-    if (time_us < 1000) {
-        time_us = 1000;
-     }
+    pal_zephyr_event_t *p_event = pal_os_event_get(callback_args);
+    unsigned int key;
 
-    clb_ctx_0.func = callback;
-    clb_ctx_0.args = callback_args;
+    if (NULL == p_event) {
+        /* more stacks than PAL_ZEPHYR_EVENT_CONTEXTS */
+        return;
+    }
 
-    k_timer_start(&timer_callback_ctx, time_us/1000, 0);
+    /* registration and restart are atomic to the expiry handler */
+    key = irq_lock();
+    p_event->func = callback;
+    p_event->args = callback_args;
+    p_event->generation++;
+    k_timer_start(&p_event->timer, K_MSEC((time_us + 999) / 1000), K_NO_WAIT);
+    irq_unlock(key);
 }
 
 /**
@@ -153,6 +206,60 @@ void pal_os_event_delayms(uint32_t time_ms)
 
 }
 
+/**
+* Drops a stale completion of the stack, invoked by the library before a request is sent to OPTIGA.
+*
+* \param[in] p_ctx                 Context of the IFX I2C stack the request is sent over
+*/
+void pal_os_event_prepare_wait(const void *p_ctx)
+{
+    pal_zephyr_event_t *p_event = pal_os_event_get(p_ctx);
+
+    if (NULL != p_event) {
+        k_sem_reset(&p_event->completion);
+    }
+}
+
+/**
+* Drops the wait, invoked by the library if the request could not be sent to OPTIGA.
+*
+* \param[in] p_ctx                 Context of the IFX I2C stack the request is sent over
+*/
+void pal_os_event_cancel_wait(const void *p_ctx)
+{
+    pal_os_event_prepare_wait(p_ctx);
+}
+
+/**
+* Blocks the calling thread till the completion of the stack is notified, at most #PAL_ZEPHYR_WAIT_TIMEOUT_MS.
+*
+* \param[in] p_ctx                 Context of the IFX I2C stack the request is sent over
+*/
+void pal_os_event_wait(const void *p_ctx)
+{
+    pal_zephyr_event_t *p_event = pal_os_event_get(p_ctx);
+
+    if (NULL != p_event) {
+        (void)k_sem_take(&p_event->completion, K_MSEC(PAL_ZEPHYR_WAIT_TIMEOUT_MS));
+    } else {
+        k_sleep(K_MSEC(1));
+    }
+}
+
+/**
+* Wakes the thread waiting for the stack. Invoked by the library from the work queue when a request completes.
+*
+* \param[in] p_ctx                 Context of the IFX I2C stack the request completed on
+*/
+void pal_os_event_notify(const void *p_ctx)
+{
+    pal_zephyr_event_t *p_event = pal_os_event_get(p_ctx);
+
+    if (NULL != p_event) {
+        k_sem_give(&p_event->completion);
+    }
+}
+
 /**
 * @}
 */
@@ -0,0 +1,128 @@
+/**
+* MIT License
+*
+* Copyright (c) 2019 Arrow Electronics
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file
+*
+* \brief This file provides the configuration and the shared types of the Zephyr PAL.
+*
+* The IFX I2C stack runs on a dedicated work queue: the event timer and every I2C transfer submit a work item,
+* so the stack is driven by completions only. The task waiting for OPTIGA blocks on a semaphore which is given
+* the instant the request completes. Every IFX I2C stack, i.e. every chip, has its own timer, work item and
+* semaphore, see #PAL_ZEPHYR_EVENT_CONTEXTS.
+*
+* Build it with PAL_OS_HAS_EVENT_WAIT defined.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#ifndef _PAL_ZEPHYR_H_
+#define _PAL_ZEPHYR_H_
+
+/**********************************************************************************************************************
+ * HEADER FILES
+ *********************************************************************************************************************/
+/* Optiga based includes */
+#include <optiga/pal/pal.h>
+#include <optiga/pal/pal_i2c.h>
+#include <optiga/pal/pal_os_event.h>
+
+/* Zephyr based includes */
+#include <zephyr.h>
+#include <device.h>
+
+/**********************************************************************************************************************
+ * MACROS
+ *********************************************************************************************************************/
+/* Stack size of the work queue running the IFX I2C stack */
+#ifndef PAL_ZEPHYR_WORK_Q_STACK_SIZE
+#define PAL_ZEPHYR_WORK_Q_STACK_SIZE    1000
+#endif
+
+/* Priority of the work queue running the IFX I2C stack */
+#ifndef PAL_ZEPHYR_WORK_Q_PRIO
+#define PAL_ZEPHYR_WORK_Q_PRIO          1
+#endif
+
+/* Number of IFX I2C stacks, each one gets its own timer, work item and completion semaphore */
+#ifndef PAL_ZEPHYR_EVENT_CONTEXTS
+#define PAL_ZEPHYR_EVENT_CONTEXTS       2
+#endif
+
+/* Upper bound of a single wait, the library checks its status after each wait */
+#ifndef PAL_ZEPHYR_WAIT_TIMEOUT_MS
+#define PAL_ZEPHYR_WAIT_TIMEOUT_MS      100
+#endif
+
+/*********************************************************************************************************************
+ * Context structures
+ *********************************************************************************************************************/
+/* context of an i2c bus, one per bus shared by all pal_i2c_t on it */
+typedef struct {
+    uint8_t             p_port;
+    uint8_t             p_scl_io;
+    uint8_t             p_sda_io;
+    uint32_t            p_bitrate;
+    /* label of the Zephyr i2c device, e.g. from devicetree or an emulated bus */
+    const char         *p_dev_name;
+
+    /* below members are owned by pal_i2c.c */
+    struct device      *p_device;
+    struct k_sem        bus_lock;
+    struct k_work       transfer;
+    pal_i2c_t          *p_pending;
+    uint8_t            *p_data;
+    uint16_t            length;
+    uint8_t             is_read;
+    uint8_t             p_init_flag;
+} i2c_ctx_t;
+
+/* event context of an IFX I2C stack, owned by pal_os_event.c */
+typedef struct {
+    /* context of the stack the events are bound to, NULL if free */
+    const void         *p_ctx;
+    /* callback registered for the timer and its argument */
+    register_callback   func;
+    void               *args;
+    /* incremented on every registration, so the work of a replaced timer is ignored */
+    u32_t               generation;
+    /* generation of the last expired timer */
+    u32_t               fired_generation;
+    struct k_timer      timer;
+    struct k_work       work;
+    /* given when a request to OPTIGA over the stack completes */
+    struct k_sem        completion;
+} pal_zephyr_event_t;
+
+/*********************************************************************************************************************
+ * Shared data
+ *********************************************************************************************************************/
+/* work queue running the IFX I2C stack, started at boot by pal_os_event.c */
+extern struct k_work_q pal_zephyr_work_q;
+
+#endif /* _PAL_ZEPHYR_H_ */
+
+/**
+* @}
+*/
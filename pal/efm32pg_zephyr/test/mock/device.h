@@ -0,0 +1,53 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file
+*
+* \brief Mock of the Zephyr device model. Devices are registered by the test with
+*        zephyr_mock_add_device() and looked up by their label with device_get_binding().
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#ifndef _DEVICE_MOCK_H_
+#define _DEVICE_MOCK_H_
+
+#include "kernel.h"
+
+struct device {
+    const char *name;
+    const void *driver_api;
+};
+
+struct device *device_get_binding(const char *name);
+
+/* Makes the device known to device_get_binding, for the test */
+void zephyr_mock_add_device(struct device *dev);
+
+#endif /* _DEVICE_MOCK_H_ */
+
+/**
+* @}
+*/
@@ -0,0 +1,59 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file
+*
+* \brief Mock of the Zephyr I2C driver API, the transfers are passed to the emulated bus given as driver API
+*        of the device.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#ifndef _I2C_MOCK_H_
+#define _I2C_MOCK_H_
+
+#include "device.h"
+
+/* Emulated I2C bus, returns 0 on success */
+struct i2c_driver_api {
+    int (*write)(struct device *dev, const u8_t *buf, u32_t num_bytes, u16_t addr);
+    int (*read)(struct device *dev, u8_t *buf, u32_t num_bytes, u16_t addr);
+};
+
+static inline int i2c_write(struct device *dev, const u8_t *buf, u32_t num_bytes, u16_t addr)
+{
+    return ((const struct i2c_driver_api *)dev->driver_api)->write(dev, buf, num_bytes, addr);
+}
+
+static inline int i2c_read(struct device *dev, u8_t *buf, u32_t num_bytes, u16_t addr)
+{
+    return ((const struct i2c_driver_api *)dev->driver_api)->read(dev, buf, num_bytes, addr);
+}
+
+#endif /* _I2C_MOCK_H_ */
+
+/**
+* @}
+*/
@@ -0,0 +1,122 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file
+*
+* \brief Mock of the Zephyr kernel API used by the Zephyr PAL, on POSIX threads. Timeouts are milliseconds of
+*        CLOCK_MONOTONIC, irq_lock() is one recursive mutex and the timers expire in a thread standing for the
+*        timer interrupt. Only for the tests in pal/efm32pg_zephyr/test, it is not a Zephyr board.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#ifndef _KERNEL_MOCK_H_
+#define _KERNEL_MOCK_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+typedef uint8_t u8_t;
+typedef uint16_t u16_t;
+typedef uint32_t u32_t;
+typedef int32_t s32_t;
+
+#define ARG_UNUSED(x)                   (void)(x)
+#define CONTAINER_OF(ptr, type, field)  ((type *)(((char *)(ptr)) - offsetof(type, field)))
+
+#define K_MSEC(ms)                      ((s32_t)(ms))
+#define K_NO_WAIT                       (0)
+#define K_FOREVER                       (-1)
+
+#define CONFIG_APPLICATION_INIT_PRIORITY    (90)
+
+struct device;
+struct k_work;
+struct k_timer;
+
+typedef void (*k_work_handler_t)(struct k_work *work);
+typedef void (*k_timer_expiry_t)(struct k_timer *timer);
+
+struct k_sem {
+    u32_t count;
+    u32_t limit;
+};
+
+struct k_work {
+    k_work_handler_t handler;
+    struct k_work *next;
+    u8_t pending;
+};
+
+struct k_work_q {
+    pthread_t thread;
+    struct k_work *head;
+    struct k_work *tail;
+};
+
+struct k_timer {
+    k_timer_expiry_t expiry;
+    u32_t deadline;
+    u8_t active;
+    struct k_timer *next;
+};
+
+#define K_SEM_DEFINE(name, initial_count, count_limit) \
+    struct k_sem name = {(initial_count), (count_limit)}
+
+#define K_THREAD_STACK_DEFINE(name, size)   char name[size]
+#define K_THREAD_STACK_SIZEOF(name)         sizeof(name)
+
+/* Runs the init function before main, at the level of the application */
+#define SYS_INIT(init_fn, level, prio)                                  \
+    static void __attribute__((constructor)) init_fn##_sys_init(void)   \
+    {                                                                   \
+        (void)init_fn(NULL);                                            \
+    }
+
+unsigned int irq_lock(void);
+void irq_unlock(unsigned int key);
+
+void k_sem_init(struct k_sem *sem, unsigned int initial_count, unsigned int limit);
+int k_sem_take(struct k_sem *sem, s32_t timeout);
+void k_sem_give(struct k_sem *sem);
+void k_sem_reset(struct k_sem *sem);
+
+void k_work_init(struct k_work *work, k_work_handler_t handler);
+void k_work_q_start(struct k_work_q *work_q, char *stack, size_t stack_size, int prio);
+int k_work_submit_to_queue(struct k_work_q *work_q, struct k_work *work);
+
+void k_timer_init(struct k_timer *timer, k_timer_expiry_t expiry_fn, k_timer_expiry_t stop_fn);
+void k_timer_start(struct k_timer *timer, s32_t duration, s32_t period);
+
+u32_t k_uptime_get_32(void);
+s32_t k_sleep(s32_t ms);
+
+#endif /* _KERNEL_MOCK_H_ */
+
+/**
+* @}
+*/
@@ -0,0 +1,333 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file pal_zephyr_test.c
+*
+* \brief   Test of the timers, waits and I2C transfers of the Zephyr PAL over its k_timer, k_work and k_sem path.
+*          Two stacks register timers and wait at the same time, each must get its own callback from the work queue
+*          and be woken over its own event context. The I2C transfers run on an emulated bus bound by its label.
+*          The Zephyr kernel is replaced by the mock on POSIX threads in mock/ and zephyr_mock.c.
+*
+*          gcc -DPAL_OS_HAS_EVENT_WAIT -DPAL_ZEPHYR_WAIT_TIMEOUT_MS=50 -Ioptiga/include -Ipal/efm32pg_zephyr
+*              -Ipal/efm32pg_zephyr/test/mock pal/efm32pg_zephyr/test/pal_zephyr_test.c
+*              pal/efm32pg_zephyr/test/zephyr_mock.c pal/efm32pg_zephyr/pal_os_event.c
+*              pal/efm32pg_zephyr/pal_i2c.c pal/efm32pg_zephyr/pal_os_timer.c -lpthread -o pal_zephyr_test
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+
+#include <kernel.h>
+#include <device.h>
+#include <drivers/i2c.h>
+#include "optiga/pal/pal_os_event.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga/pal/pal_i2c.h"
+#include "pal_zephyr.h"
+
+#define TEST_CHECK(condition)                                               \
+    if (!(condition)) {                                                     \
+        printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition);       \
+        return -1;                                                          \
+    }
+
+/// @cond hidden
+/// Callback of a stack
+typedef struct test_callback {
+    /// Number of calls
+    volatile u32_t calls;
+    /// Time of the last call
+    volatile u32_t called_ms;
+    /// Order of the last call among all callbacks
+    volatile u32_t order;
+    /// The last call was in the work queue thread
+    volatile u8_t in_work_q;
+} test_callback_t;
+
+static uint8_t test_stack_a;
+static uint8_t test_stack_b;
+static test_callback_t test_callback_a;
+static test_callback_t test_callback_b;
+static volatile u32_t test_calls;
+
+/// Emulated OPTIGA on the I2C bus
+static u8_t test_slave_data[16];
+static u32_t test_slave_length;
+static volatile u8_t test_slave_fail;
+static volatile u8_t test_slave_hold;
+static volatile u8_t test_slave_held;
+
+/// Events of the upper layer of the I2C context
+static volatile u8_t test_i2c_event;
+static volatile u32_t test_i2c_events;
+
+// Callback bound to test_stack_a, counts the calls and checks the thread it runs in
+static void test_callback_stack_a(void *p_args)
+{
+    test_callback_a.calls++;
+    test_callback_a.called_ms = k_uptime_get_32();
+    test_callback_a.order = ++test_calls;
+    test_callback_a.in_work_q = pthread_equal(pthread_self(), pal_zephyr_work_q.thread);
+    ARG_UNUSED(p_args);
+}
+
+static void test_callback_stack_b(void *p_args)
+{
+    test_callback_b.calls++;
+    test_callback_b.called_ms = k_uptime_get_32();
+    test_callback_b.order = ++test_calls;
+    test_callback_b.in_work_q = pthread_equal(pthread_self(), pal_zephyr_work_q.thread);
+    ARG_UNUSED(p_args);
+}
+
+static void test_reset_callbacks(void)
+{
+    memset(&test_callback_a, 0, sizeof(test_callback_a));
+    memset(&test_callback_b, 0, sizeof(test_callback_b));
+    test_calls = 0;
+}
+
+static void *test_notify_stack_b(void *p_args)
+{
+    ARG_UNUSED(p_args);
+    k_sleep(K_MSEC(10));
+    pal_os_event_notify(&test_stack_b);
+    return NULL;
+}
+
+static int test_emul_write(struct device *dev, const u8_t *buf, u32_t num_bytes, u16_t addr)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(addr);
+    while (test_slave_hold) {
+        test_slave_held = 1;
+        k_sleep(K_MSEC(1));
+    }
+    if (test_slave_fail || (num_bytes > sizeof(test_slave_data))) {
+        return -EIO;
+    }
+    memcpy(test_slave_data, buf, num_bytes);
+    test_slave_length = num_bytes;
+    return 0;
+}
+
+static int test_emul_read(struct device *dev, u8_t *buf, u32_t num_bytes, u16_t addr)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(addr);
+    if (test_slave_fail || (num_bytes > test_slave_length)) {
+        return -EIO;
+    }
+    memcpy(buf, test_slave_data, num_bytes);
+    return 0;
+}
+
+static const struct i2c_driver_api test_emul_api = {
+    .write = test_emul_write,
+    .read = test_emul_read
+};
+
+static struct device test_emul_device = {
+    .name = "I2C_0",
+    .driver_api = &test_emul_api
+};
+
+static i2c_ctx_t test_bus = {
+    .p_dev_name = "I2C_0"
+};
+
+static void test_i2c_handler(void *p_ctx, uint8_t event)
+{
+    ARG_UNUSED(p_ctx);
+    test_i2c_event = event;
+    test_i2c_events++;
+}
+
+static pal_i2c_t test_i2c = {
+    (void *)&test_bus,
+    0x30,
+    NULL,
+    (void *)test_i2c_handler
+};
+
+static void test_wait_until(volatile u32_t *p_count, u32_t count)
+{
+    u32_t start_ms = k_uptime_get_32();
+
+    while ((*p_count < count) && ((k_uptime_get_32() - start_ms) < 2000)) {
+        k_sleep(K_MSEC(1));
+    }
+}
+/// @endcond
+
+/**
+* Registers timers for two stacks at the same time, the shorter one must fire first and neither may be lost.
+*/
+int test_timers_per_stack(void)
+{
+    u32_t start_ms;
+
+    test_reset_callbacks();
+    start_ms = k_uptime_get_32();
+    pal_os_event_register_callback_oneshot(test_callback_stack_a, &test_stack_a, 30000);
+    pal_os_event_register_callback_oneshot(test_callback_stack_b, &test_stack_b, 10000);
+    test_wait_until(&test_calls, 2);
+
+    TEST_CHECK(1 == test_callback_a.calls);
+    TEST_CHECK(1 == test_callback_b.calls);
+    TEST_CHECK(1 == test_callback_b.order);
+    TEST_CHECK(2 == test_callback_a.order);
+    TEST_CHECK((test_callback_a.called_ms - start_ms) >= 30);
+    TEST_CHECK((test_callback_b.called_ms - start_ms) >= 10);
+    TEST_CHECK(test_callback_a.in_work_q);
+    TEST_CHECK(test_callback_b.in_work_q);
+    return 0;
+}
+
+/**
+* Replaces the timer of a stack before it expires, only the second callback must be called and at its own time.
+*/
+int test_replaced_registration(void)
+{
+    u32_t start_ms;
+
+    test_reset_callbacks();
+    start_ms = k_uptime_get_32();
+    pal_os_event_register_callback_oneshot(test_callback_stack_b, &test_stack_a, 5000);
+    pal_os_event_register_callback_oneshot(test_callback_stack_a, &test_stack_a, 20000);
+    test_wait_until(&test_calls, 1);
+    k_sleep(K_MSEC(20));
+
+    TEST_CHECK(0 == test_callback_b.calls);
+    TEST_CHECK(1 == test_callback_a.calls);
+    TEST_CHECK((test_callback_a.called_ms - start_ms) >= 20);
+    return 0;
+}
+
+/**
+* Waits of two stacks, the notification of one stack must not wake the other, which runs into the timeout.
+*/
+int test_wait_per_stack(void)
+{
+    pthread_t notifier;
+    u32_t start_ms;
+    u32_t waited_ms;
+
+    pal_os_event_prepare_wait(&test_stack_a);
+    pal_os_event_prepare_wait(&test_stack_b);
+    pthread_create(&notifier, NULL, test_notify_stack_b, NULL);
+
+    start_ms = k_uptime_get_32();
+    pal_os_event_wait(&test_stack_b);
+    waited_ms = k_uptime_get_32() - start_ms;
+    TEST_CHECK(waited_ms < PAL_ZEPHYR_WAIT_TIMEOUT_MS);
+
+    start_ms = k_uptime_get_32();
+    pal_os_event_wait(&test_stack_a);
+    waited_ms = k_uptime_get_32() - start_ms;
+    TEST_CHECK(waited_ms >= PAL_ZEPHYR_WAIT_TIMEOUT_MS);
+
+    pthread_join(notifier, NULL);
+
+    // a notification before the wait is kept, a cancelled wait drops it
+    pal_os_event_notify(&test_stack_a);
+    pal_os_event_cancel_wait(&test_stack_a);
+    start_ms = k_uptime_get_32();
+    pal_os_event_wait(&test_stack_a);
+    TEST_CHECK((k_uptime_get_32() - start_ms) >= PAL_ZEPHYR_WAIT_TIMEOUT_MS);
+    return 0;
+}
+
+/**
+* Transfers over the emulated bus: the events come from the work queue, a second transfer while the bus is held
+* gets BUSY and a failed transfer gets ERROR.
+*/
+int test_i2c_transfers(void)
+{
+    uint8_t write_data[4] = {0x82, 0x01, 0x02, 0x03};
+    uint8_t read_data[4];
+
+    zephyr_mock_add_device(&test_emul_device);
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_i2c_init(&test_i2c));
+
+    test_i2c_events = 0;
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_i2c_write(&test_i2c, write_data, sizeof(write_data)));
+    test_wait_until(&test_i2c_events, 1);
+    TEST_CHECK(PAL_I2C_EVENT_SUCCESS == test_i2c_event);
+
+    memset(read_data, 0, sizeof(read_data));
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_i2c_read(&test_i2c, read_data, sizeof(read_data)));
+    test_wait_until(&test_i2c_events, 2);
+    TEST_CHECK(PAL_I2C_EVENT_SUCCESS == test_i2c_event);
+    TEST_CHECK(0 == memcmp(write_data, read_data, sizeof(read_data)));
+
+    test_slave_hold = 1;
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_i2c_write(&test_i2c, write_data, sizeof(write_data)));
+    while (!test_slave_held) {
+        k_sleep(K_MSEC(1));
+    }
+    TEST_CHECK(PAL_STATUS_I2C_BUSY == pal_i2c_read(&test_i2c, read_data, sizeof(read_data)));
+    TEST_CHECK(PAL_I2C_EVENT_BUSY == test_i2c_event);
+    TEST_CHECK(3 == test_i2c_events);
+    test_slave_hold = 0;
+    test_wait_until(&test_i2c_events, 4);
+    TEST_CHECK(PAL_I2C_EVENT_SUCCESS == test_i2c_event);
+
+    test_slave_fail = 1;
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_i2c_read(&test_i2c, read_data, sizeof(read_data)));
+    test_wait_until(&test_i2c_events, 5);
+    TEST_CHECK(PAL_I2C_EVENT_ERROR == test_i2c_event);
+    test_slave_fail = 0;
+
+    // the bus is free again after the error
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_i2c_read(&test_i2c, read_data, sizeof(read_data)));
+    test_wait_until(&test_i2c_events, 6);
+    TEST_CHECK(PAL_I2C_EVENT_SUCCESS == test_i2c_event);
+    return 0;
+}
+
+int main(void)
+{
+    int status = 0;
+
+    status |= test_timers_per_stack();
+    status |= test_replaced_registration();
+    status |= test_wait_per_stack();
+    status |= test_i2c_transfers();
+
+    printf("%s\n", (0 == status) ? "PASSED" : "FAILED");
+    return (0 == status) ? 0 : 1;
+}
+
+/**
+* @}
+*/
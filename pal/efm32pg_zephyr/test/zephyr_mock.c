@@ -0,0 +1,302 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file
+*
+* \brief This file implements the mock of the Zephyr kernel API used by the Zephyr PAL on POSIX threads.
+*
+* The work queue is a thread, the timers expire in a thread standing for the timer interrupt, with irq_lock() held.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include "kernel.h"
+#include "device.h"
+
+/// @cond hidden
+#define ZEPHYR_MOCK_MAX_DEVICES     (4)
+
+static pthread_mutex_t irq_mutex;
+static pthread_once_t irq_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t sem_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sem_cond = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t work_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_cond = PTHREAD_COND_INITIALIZER;
+static pthread_once_t timer_once = PTHREAD_ONCE_INIT;
+static pthread_t timer_thread;
+static struct k_timer *timers = NULL;
+static struct device *devices[ZEPHYR_MOCK_MAX_DEVICES];
+
+static void zephyr_mock_irq_init(void)
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&irq_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+/* Timer interrupt: runs the expiry functions of the expired timers with the interrupts locked */
+static void *zephyr_mock_timer_isr(void *arg)
+{
+    struct timespec delay = {0, 200000};
+    struct k_timer *timer;
+    unsigned int key;
+
+    ARG_UNUSED(arg);
+    for (;;) {
+        key = irq_lock();
+        for (timer = timers; NULL != timer; timer = timer->next) {
+            if (timer->active && ((s32_t)(k_uptime_get_32() - timer->deadline) >= 0)) {
+                timer->active = 0;
+                timer->expiry(timer);
+            }
+        }
+        irq_unlock(key);
+        nanosleep(&delay, NULL);
+    }
+    return NULL;
+}
+
+static void zephyr_mock_timer_start_isr(void)
+{
+    pthread_create(&timer_thread, NULL, zephyr_mock_timer_isr, NULL);
+}
+
+static void *zephyr_mock_work_q_thread(void *arg)
+{
+    struct k_work_q *work_q = (struct k_work_q *)arg;
+    struct k_work *work;
+
+    for (;;) {
+        pthread_mutex_lock(&work_mutex);
+        while (NULL == work_q->head) {
+            pthread_cond_wait(&work_cond, &work_mutex);
+        }
+        work = work_q->head;
+        work_q->head = work->next;
+        if (NULL == work_q->head) {
+            work_q->tail = NULL;
+        }
+        work->pending = 0;
+        pthread_mutex_unlock(&work_mutex);
+
+        work->handler(work);
+    }
+    return NULL;
+}
+
+/* Absolute CLOCK_REALTIME time after the timeout, for pthread_cond_timedwait */
+static struct timespec zephyr_mock_deadline(s32_t timeout)
+{
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout / 1000;
+    deadline.tv_nsec += (long)(timeout % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+    return deadline;
+}
+/// @endcond
+
+unsigned int irq_lock(void)
+{
+    pthread_once(&irq_once, zephyr_mock_irq_init);
+    pthread_mutex_lock(&irq_mutex);
+    return 0;
+}
+
+void irq_unlock(unsigned int key)
+{
+    ARG_UNUSED(key);
+    pthread_mutex_unlock(&irq_mutex);
+}
+
+void k_sem_init(struct k_sem *sem, unsigned int initial_count, unsigned int limit)
+{
+    pthread_mutex_lock(&sem_mutex);
+    sem->count = initial_count;
+    sem->limit = limit;
+    pthread_mutex_unlock(&sem_mutex);
+}
+
+int k_sem_take(struct k_sem *sem, s32_t timeout)
+{
+    struct timespec deadline = zephyr_mock_deadline(timeout);
+    int result = 0;
+
+    pthread_mutex_lock(&sem_mutex);
+    while (0 == sem->count) {
+        if (K_NO_WAIT == timeout) {
+            result = -EBUSY;
+            break;
+        }
+        if (K_FOREVER == timeout) {
+            pthread_cond_wait(&sem_cond, &sem_mutex);
+        } else if (ETIMEDOUT == pthread_cond_timedwait(&sem_cond, &sem_mutex, &deadline)) {
+            result = (0 == sem->count) ? -EAGAIN : 0;
+            break;
+        }
+    }
+    if (0 == result) {
+        sem->count--;
+    }
+    pthread_mutex_unlock(&sem_mutex);
+    return result;
+}
+
+void k_sem_give(struct k_sem *sem)
+{
+    pthread_mutex_lock(&sem_mutex);
+    if (sem->count < sem->limit) {
+        sem->count++;
+    }
+    pthread_cond_broadcast(&sem_cond);
+    pthread_mutex_unlock(&sem_mutex);
+}
+
+void k_sem_reset(struct k_sem *sem)
+{
+    pthread_mutex_lock(&sem_mutex);
+    sem->count = 0;
+    pthread_mutex_unlock(&sem_mutex);
+}
+
+void k_work_init(struct k_work *work, k_work_handler_t handler)
+{
+    memset(work, 0, sizeof(*work));
+    work->handler = handler;
+}
+
+void k_work_q_start(struct k_work_q *work_q, char *stack, size_t stack_size, int prio)
+{
+    ARG_UNUSED(stack);
+    ARG_UNUSED(stack_size);
+    ARG_UNUSED(prio);
+    work_q->head = NULL;
+    work_q->tail = NULL;
+    pthread_create(&work_q->thread, NULL, zephyr_mock_work_q_thread, work_q);
+}
+
+int k_work_submit_to_queue(struct k_work_q *work_q, struct k_work *work)
+{
+    pthread_mutex_lock(&work_mutex);
+    if (!work->pending) {
+        work->pending = 1;
+        work->next = NULL;
+        if (NULL == work_q->tail) {
+            work_q->head = work;
+        } else {
+            work_q->tail->next = work;
+        }
+        work_q->tail = work;
+        pthread_cond_broadcast(&work_cond);
+    }
+    pthread_mutex_unlock(&work_mutex);
+    return 0;
+}
+
+void k_timer_init(struct k_timer *timer, k_timer_expiry_t expiry_fn, k_timer_expiry_t stop_fn)
+{
+    struct k_timer *listed;
+    unsigned int key;
+
+    ARG_UNUSED(stop_fn);
+    pthread_once(&timer_once, zephyr_mock_timer_start_isr);
+    key = irq_lock();
+    timer->expiry = expiry_fn;
+    timer->active = 0;
+    for (listed = timers; (NULL != listed) && (timer != listed); listed = listed->next) {
+    }
+    if (NULL == listed) {
+        timer->next = timers;
+        timers = timer;
+    }
+    irq_unlock(key);
+}
+
+void k_timer_start(struct k_timer *timer, s32_t duration, s32_t period)
+{
+    unsigned int key;
+
+    ARG_UNUSED(period);
+    key = irq_lock();
+    timer->deadline = k_uptime_get_32() + (u32_t)duration;
+    timer->active = 1;
+    irq_unlock(key);
+}
+
+u32_t k_uptime_get_32(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (u32_t)((now.tv_sec * 1000ULL) + (now.tv_nsec / 1000000));
+}
+
+s32_t k_sleep(s32_t ms)
+{
+    struct timespec delay;
+
+    delay.tv_sec = ms / 1000;
+    delay.tv_nsec = (long)(ms % 1000) * 1000000;
+    nanosleep(&delay, NULL);
+    return 0;
+}
+
+struct device *device_get_binding(const char *name)
+{
+    u8_t index;
+
+    for (index = 0; index < ZEPHYR_MOCK_MAX_DEVICES; index++) {
+        if ((NULL != devices[index]) && (0 == strcmp(name, devices[index]->name))) {
+            return devices[index];
+        }
+    }
+    return NULL;
+}
+
+void zephyr_mock_add_device(struct device *dev)
+{
+    u8_t index;
+
+    for (index = 0; index < ZEPHYR_MOCK_MAX_DEVICES; index++) {
+        if (NULL == devices[index]) {
+            devices[index] = dev;
+            break;
+        }
+    }
+}
+
+/**
+* @}
+*/
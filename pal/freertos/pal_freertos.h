@@ -0,0 +1,90 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file pal_freertos.h
+*
+* \brief   This file provides the configuration and prototype declarations of the portable FreeRTOS PAL core.
+*
+* The core implements pal_os_event, pal_os_timer and pal_os_lock with FreeRTOS primitives only:
+* - The IFX I2C stack runs in a dedicated stack task, woken by a software timer.
+* - The task waiting for a request over a comms context is woken by a direct to task notification the instant
+*   the request completes.
+*
+* Build it with PAL_OS_HAS_EVENT_INIT and PAL_OS_HAS_EVENT_WAIT defined, together with the pal_i2c and pal_gpio
+* of the board.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#ifndef _PAL_FREERTOS_H_
+#define _PAL_FREERTOS_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "optiga/pal/pal.h"
+#include "optiga/pal/pal_os_event.h"
+
+/// Priority of the task running the IFX I2C stack
+#ifndef PAL_FREERTOS_STACK_TASK_PRIORITY
+#define PAL_FREERTOS_STACK_TASK_PRIORITY    (configMAX_PRIORITIES - 1)
+#endif
+
+/// Stack depth of the task running the IFX I2C stack, in words
+#ifndef PAL_FREERTOS_STACK_TASK_STACK_SIZE
+#define PAL_FREERTOS_STACK_TASK_STACK_SIZE  (configMINIMAL_STACK_SIZE * 5)
+#endif
+
+/// Index of the task notification used to wake the waiting task. Values other than 0 need FreeRTOS 10.4 or newer
+/// and configTASK_NOTIFICATION_ARRAY_ENTRIES above the index
+#ifndef PAL_FREERTOS_NOTIFY_INDEX
+#define PAL_FREERTOS_NOTIFY_INDEX           (0)
+#endif
+
+/// Number of comms contexts whose requests can be waited for at the same time
+#ifndef PAL_FREERTOS_MAX_WAITERS
+#define PAL_FREERTOS_MAX_WAITERS            (2)
+#endif
+
+/// Upper bound of a single wait, the library checks its status after each wait
+#ifndef PAL_FREERTOS_WAIT_TIMEOUT_MS
+#define PAL_FREERTOS_WAIT_TIMEOUT_MS        (100)
+#endif
+
+/**
+ * @brief Runs a callback in the stack task as soon as possible, to be called from an interrupt handler.
+ *
+ * Used by pal_i2c implementations which get the transfer completion in an interrupt, since the upper layers
+ * must not run in interrupt context. One deferred callback can be pending at a time.
+ *
+ * \param[in] callback              Callback function pointer
+ * \param[in] callback_args         Callback arguments
+ */
+void pal_freertos_defer_from_isr(register_callback callback, void * callback_args);
+
+#endif /* _PAL_FREERTOS_H_ */
+
+/**
+* @}
+*/
@@ -0,0 +1,359 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file
+*
+* \brief This file implements the platform abstraction layer APIs for os event/scheduler on FreeRTOS.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+/**********************************************************************************************************************
+ * HEADER FILES
+ *********************************************************************************************************************/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "pal_freertos.h"
+
+/**********************************************************************************************************************
+ * MACROS
+ *********************************************************************************************************************/
+/// @cond hidden
+/// Notification bit of the stack task for an expired timer
+#define PAL_FREERTOS_EVENT_TIMER        (0x01U)
+/// Notification bit of the stack task for a callback deferred from an interrupt
+#define PAL_FREERTOS_EVENT_DEFERRED     (0x02U)
+
+#if (PAL_FREERTOS_NOTIFY_INDEX > 0)
+#define PAL_FREERTOS_NOTIFY_TAKE(ticks) ulTaskNotifyTakeIndexed(PAL_FREERTOS_NOTIFY_INDEX, pdTRUE, (ticks))
+#define PAL_FREERTOS_NOTIFY_GIVE(task)  xTaskNotifyGiveIndexed((task), PAL_FREERTOS_NOTIFY_INDEX)
+#else
+#define PAL_FREERTOS_NOTIFY_TAKE(ticks) ulTaskNotifyTake(pdTRUE, (ticks))
+#define PAL_FREERTOS_NOTIFY_GIVE(task)  xTaskNotifyGive((task))
+#endif
+
+/*********************************************************************************************************************
+ * LOCAL DATA
+ *********************************************************************************************************************/
+
+typedef struct callbacks {
+	/// Callback function when timer elapses
+	register_callback func;
+	/// Pointer to store upper layer callback context (For example: Ifx i2c context)
+	void * args;
+}pal_os_event_clbs_t;
+
+static pal_os_event_clbs_t clb_ctx_0;
+static pal_os_event_clbs_t clb_deferred;
+
+/// Tick count at which the registered callback is due. An expiry of a replaced timer before it is ignored,
+/// the timer is restarted with the new period anyway
+static TickType_t timer_deadline = 0;
+
+/// Task waiting for the completion of a request to OPTIGA over a comms context
+typedef struct waiter {
+	/// Context of the comms stack the request is sent over, NULL if the entry is free
+	const void * p_ctx;
+	/// Waiting task
+	TaskHandle_t task;
+}pal_os_event_waiter_t;
+
+static TaskHandle_t stack_task = NULL;
+static TimerHandle_t stack_timer = NULL;
+static pal_os_event_waiter_t waiters[PAL_FREERTOS_MAX_WAITERS];
+
+/**
+*  Looks up the waiter of a comms context, to be called in a critical section.
+*
+*\param[in] p_ctx Context of the comms stack, NULL to look up a free entry
+*
+*\retval Entry of the comms context, NULL if there is none
+*/
+static pal_os_event_waiter_t * pal_os_event_find_waiter(const void * p_ctx)
+{
+	uint8_t index;
+
+	for (index = 0; index < PAL_FREERTOS_MAX_WAITERS; index++)
+	{
+		if (p_ctx == waiters[index].p_ctx)
+		{
+			return &waiters[index];
+		}
+	}
+	return NULL;
+}
+
+/**
+*  Timer callback handler, runs in the timer service task.
+*
+*  The registered callback is not invoked here, since it would block the other timers while
+*  it drives the I2C transfer. The stack task is notified instead.
+*
+*\param[in] timer Expired timer
+*/
+static void pal_os_event_timer_callback(TimerHandle_t timer)
+{
+	(void)timer;
+	(void)xTaskNotify(stack_task, PAL_FREERTOS_EVENT_TIMER, eSetBits);
+}
+
+/**
+*  Stack task, invokes the callbacks of the IFX I2C stack.
+*
+*\param[in] parameters Not used
+*/
+static void pal_os_event_stack_task(void * parameters)
+{
+	uint32_t events;
+	register_callback func;
+	void * func_args;
+
+	(void)parameters;
+	for (;;)
+	{
+		events = 0;
+		(void)xTaskNotifyWait(0, PAL_FREERTOS_EVENT_TIMER | PAL_FREERTOS_EVENT_DEFERRED, &events, portMAX_DELAY);
+
+		if (events & PAL_FREERTOS_EVENT_DEFERRED)
+		{
+			taskENTER_CRITICAL();
+			func = clb_deferred.func;
+			func_args = clb_deferred.args;
+			clb_deferred.func = NULL;
+			taskEXIT_CRITICAL();
+			if (NULL != func)
+			{
+				func(func_args);
+			}
+		}
+
+		if (events & PAL_FREERTOS_EVENT_TIMER)
+		{
+			func = NULL;
+			taskENTER_CRITICAL();
+			//Not before the deadline, even if the timer of a replaced registration expired
+			if ((TickType_t)(xTaskGetTickCount() - timer_deadline) < (portMAX_DELAY / 2U))
+			{
+				func = clb_ctx_0.func;
+				func_args = clb_ctx_0.args;
+				clb_ctx_0.func = NULL;
+			}
+			taskEXIT_CRITICAL();
+			if (NULL != func)
+			{
+				func(func_args);
+			}
+		}
+	}
+}
+/// @endcond
+
+/**
+* Platform specific event init function.
+* <br>
+*
+* <b>API Details:</b>
+*         Creates the stack task and its timer. Calling it again has no effect.<br>
+*
+*
+* \retval  #PAL_STATUS_SUCCESS  On success
+* \retval  #PAL_STATUS_FAILURE  If the task or the timer could not be created
+*/
+pal_status_t pal_os_event_init(void)
+{
+	pal_status_t status = PAL_STATUS_FAILURE;
+
+	do {
+		if (NULL == stack_task)
+		{
+			if (pdPASS != xTaskCreate(pal_os_event_stack_task,
+									  "optiga_stack",
+									  PAL_FREERTOS_STACK_TASK_STACK_SIZE,
+									  NULL,
+									  PAL_FREERTOS_STACK_TASK_PRIORITY,
+									  &stack_task))
+			{
+				stack_task = NULL;
+				break;
+			}
+		}
+
+		if (NULL == stack_timer)
+		{
+			stack_timer = xTimerCreate("optiga_timer", 1, pdFALSE, NULL, pal_os_event_timer_callback);
+			if (NULL == stack_timer)
+			{
+				break;
+			}
+		}
+		status = PAL_STATUS_SUCCESS;
+	} while(0);
+
+	return status;
+}
+
+/**
+* Platform specific event call back registration function to trigger once when timer expires.
+* <br>
+*
+* <b>API Details:</b>
+*         This function registers the callback function supplied by the caller, replacing a pending one.<br>
+*         It starts a software timer of at least the supplied time interval, rounded up to full ticks.<br>
+*         Once the timer expires, the registered callback function gets called in the stack task.<br>
+*
+* \param[in] callback              Callback function pointer
+* \param[in] callback_args         Callback arguments
+* \param[in] time_us               time in micro seconds to trigger the call back
+*
+*/
+void pal_os_event_register_callback_oneshot(register_callback callback,
+                                            void* callback_args,
+                                            uint32_t time_us)
+{
+	TickType_t ticks;
+
+	if ((NULL == stack_timer) && (PAL_STATUS_SUCCESS != pal_os_event_init()))
+	{
+		return;
+	}
+
+	ticks = (TickType_t)((((uint64_t)time_us * configTICK_RATE_HZ) + 999999U) / 1000000U);
+	if (0 == ticks)
+	{
+		ticks = 1;
+	}
+
+	//The deadline is published with the callback. The timer restarted below expires at or after it,
+	//an expiry of the previous period in between does not pass the deadline check of the stack task
+	taskENTER_CRITICAL();
+	clb_ctx_0.func = callback;
+	clb_ctx_0.args = callback_args;
+	timer_deadline = xTaskGetTickCount() + ticks;
+	taskEXIT_CRITICAL();
+
+	//Also starts the timer
+	(void)xTimerChangePeriod(stack_timer, ticks, portMAX_DELAY);
+}
+
+/**
+* Runs a callback in the stack task as soon as possible, to be called from an interrupt handler.
+*
+* \param[in] callback              Callback function pointer
+* \param[in] callback_args         Callback arguments
+*/
+void pal_freertos_defer_from_isr(register_callback callback, void * callback_args)
+{
+	BaseType_t higher_priority_task_woken = pdFALSE;
+	UBaseType_t saved_interrupt_status;
+
+	saved_interrupt_status = taskENTER_CRITICAL_FROM_ISR();
+	clb_deferred.func = callback;
+	clb_deferred.args = callback_args;
+	taskEXIT_CRITICAL_FROM_ISR(saved_interrupt_status);
+
+	(void)xTaskNotifyFromISR(stack_task, PAL_FREERTOS_EVENT_DEFERRED, eSetBits, &higher_priority_task_woken);
+	portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+/**
+* Registers the calling task as the one waiting for the next completion over the comms context and drops a stale
+* notification. Requests over different comms contexts can be waited for by different tasks at the same time.
+* If more than #PAL_FREERTOS_MAX_WAITERS comms contexts are waited for, the task is not registered and
+* #pal_os_event_wait returns after its timeout only.
+*
+* \param[in] p_ctx                 Context of the comms stack the request is sent over
+*/
+void pal_os_event_prepare_wait(const void * p_ctx)
+{
+	pal_os_event_waiter_t * p_waiter;
+
+	taskENTER_CRITICAL();
+	p_waiter = pal_os_event_find_waiter(p_ctx);
+	if (NULL == p_waiter)
+	{
+		p_waiter = pal_os_event_find_waiter(NULL);
+	}
+	if (NULL != p_waiter)
+	{
+		p_waiter->p_ctx = p_ctx;
+		p_waiter->task = xTaskGetCurrentTaskHandle();
+	}
+	taskEXIT_CRITICAL();
+	(void)PAL_FREERTOS_NOTIFY_TAKE(0);
+}
+
+/**
+* Unregisters the waiting task of the comms context, invoked by the library if the request could not be sent to OPTIGA.
+*/
+void pal_os_event_cancel_wait(const void * p_ctx)
+{
+	pal_os_event_waiter_t * p_waiter;
+
+	taskENTER_CRITICAL();
+	p_waiter = pal_os_event_find_waiter(p_ctx);
+	if (NULL != p_waiter)
+	{
+		p_waiter->p_ctx = NULL;
+	}
+	taskEXIT_CRITICAL();
+}
+
+/**
+* Blocks the calling task till the completion is notified, at most #PAL_FREERTOS_WAIT_TIMEOUT_MS.
+*/
+void pal_os_event_wait(const void * p_ctx)
+{
+	(void)p_ctx;
+	(void)PAL_FREERTOS_NOTIFY_TAKE(pdMS_TO_TICKS(PAL_FREERTOS_WAIT_TIMEOUT_MS));
+}
+
+/**
+* Wakes the task waiting for the comms context and unregisters it. Invoked by the library from the stack task when
+* a request completes.
+*/
+void pal_os_event_notify(const void * p_ctx)
+{
+	pal_os_event_waiter_t * p_waiter;
+	TaskHandle_t task = NULL;
+
+	taskENTER_CRITICAL();
+	p_waiter = pal_os_event_find_waiter(p_ctx);
+	if ((NULL != p_ctx) && (NULL != p_waiter))
+	{
+		task = p_waiter->task;
+		p_waiter->p_ctx = NULL;
+	}
+	taskEXIT_CRITICAL();
+	if (NULL != task)
+	{
+		(void)PAL_FREERTOS_NOTIFY_GIVE(task);
+	}
+}
+
+/**
+* @}
+*/
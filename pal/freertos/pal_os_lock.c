@@ -0,0 +1,83 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file pal_os_lock.c
+*
+* \brief   This file implements the platform abstraction layer APIs for os locks on FreeRTOS.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "optiga/pal/pal_os_lock.h"
+
+/// @cond hidden
+static SemaphoreHandle_t pal_os_lock_mutex = NULL;
+/// @endcond
+
+/**
+ * Acquires the lock, blocking the calling task till it is available.
+ * The mutex is created on first use, its priority inheritance protects the task holding it.
+ *
+ * \retval  #PAL_STATUS_SUCCESS  Lock is acquired
+ * \retval  #PAL_STATUS_FAILURE  Lock could not be created
+ */
+pal_status_t pal_os_lock_acquire(void)
+{
+    pal_status_t return_status = PAL_STATUS_FAILURE;
+
+    if (NULL == pal_os_lock_mutex)
+    {
+        vTaskSuspendAll();
+        if (NULL == pal_os_lock_mutex)
+        {
+            pal_os_lock_mutex = xSemaphoreCreateMutex();
+        }
+        (void)xTaskResumeAll();
+    }
+
+    if ((NULL != pal_os_lock_mutex) && (pdTRUE == xSemaphoreTake(pal_os_lock_mutex, portMAX_DELAY)))
+    {
+        return_status = PAL_STATUS_SUCCESS;
+    }
+    return return_status;
+}
+
+/**
+ * Releases the lock
+ */
+void pal_os_lock_release(void)
+{
+    if (NULL != pal_os_lock_mutex)
+    {
+        (void)xSemaphoreGive(pal_os_lock_mutex);
+    }
+}
+
+/**
+* @}
+*/
@@ -0,0 +1,338 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file
+*
+* \brief This file implements the mock of the FreeRTOS kernel API used by the FreeRTOS PAL on POSIX threads.
+*
+* Tasks are threads, the critical sections are one recursive mutex and the software timer is served by a thread
+* like the timer service task of FreeRTOS.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <errno.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+/// @cond hidden
+struct freertos_mock_task
+{
+    pthread_t thread;
+    TaskFunction_t task_code;
+    void * parameters;
+    /// Notification value
+    uint32_t value;
+    /// A notification is pending
+    uint8_t pending;
+};
+
+struct freertos_mock_timer
+{
+    pthread_t thread;
+    TimerCallbackFunction_t callback;
+    /// Timer is running
+    uint8_t active;
+    /// Tick count at which the timer expires
+    TickType_t expiry;
+};
+
+static pthread_mutex_t critical_mutex;
+static pthread_once_t critical_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t notify_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t notify_cond = PTHREAD_COND_INITIALIZER;
+static __thread struct freertos_mock_task * current_task = NULL;
+static struct freertos_mock_timer timer_0;
+
+static void freertos_mock_critical_init(void)
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&critical_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+// Absolute CLOCK_REALTIME time after the ticks, for pthread_cond_timedwait
+static struct timespec freertos_mock_deadline(TickType_t ticks)
+{
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += ticks / 1000;
+    deadline.tv_nsec += (long)(ticks % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+    return deadline;
+}
+
+// Waits for a notification of the current task, with notify_mutex held
+static uint8_t freertos_mock_wait_pending(TickType_t ticks_to_wait)
+{
+    struct timespec deadline = freertos_mock_deadline(ticks_to_wait);
+
+    while (!current_task->pending)
+    {
+        if (0 == ticks_to_wait)
+        {
+            return 0;
+        }
+        if (portMAX_DELAY == ticks_to_wait)
+        {
+            pthread_cond_wait(&notify_cond, &notify_mutex);
+        }
+        else if (ETIMEDOUT == pthread_cond_timedwait(&notify_cond, &notify_mutex, &deadline))
+        {
+            return current_task->pending;
+        }
+    }
+    return 1;
+}
+
+static void * freertos_mock_task_entry(void * p_task)
+{
+    current_task = (struct freertos_mock_task *)p_task;
+    current_task->task_code(current_task->parameters);
+    return NULL;
+}
+
+static void * freertos_mock_timer_service(void * p_timer)
+{
+    struct freertos_mock_timer * p_mock_timer = (struct freertos_mock_timer *)p_timer;
+    struct timespec delay = {0, 200000};
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        if (p_mock_timer->active && ((int32_t)(xTaskGetTickCount() - p_mock_timer->expiry) >= 0))
+        {
+            p_mock_timer->active = 0;
+            taskEXIT_CRITICAL();
+            p_mock_timer->callback(p_mock_timer);
+            continue;
+        }
+        taskEXIT_CRITICAL();
+        nanosleep(&delay, NULL);
+    }
+    return NULL;
+}
+/// @endcond
+
+void taskENTER_CRITICAL(void)
+{
+    pthread_once(&critical_once, freertos_mock_critical_init);
+    pthread_mutex_lock(&critical_mutex);
+}
+
+void taskEXIT_CRITICAL(void)
+{
+    pthread_mutex_unlock(&critical_mutex);
+}
+
+UBaseType_t taskENTER_CRITICAL_FROM_ISR(void)
+{
+    taskENTER_CRITICAL();
+    return 0;
+}
+
+void taskEXIT_CRITICAL_FROM_ISR(UBaseType_t saved_interrupt_status)
+{
+    (void)saved_interrupt_status;
+    taskEXIT_CRITICAL();
+}
+
+void portYIELD_FROM_ISR(BaseType_t higher_priority_task_woken)
+{
+    (void)higher_priority_task_woken;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task_code, const char * name, uint32_t stack_depth, void * parameters,
+                       UBaseType_t priority, TaskHandle_t * p_created_task)
+{
+    struct freertos_mock_task * p_task = calloc(1, sizeof(*p_task));
+
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+    if (NULL == p_task)
+    {
+        return pdFAIL;
+    }
+    p_task->task_code = task_code;
+    p_task->parameters = parameters;
+    if (NULL != p_created_task)
+    {
+        *p_created_task = p_task;
+    }
+    if (0 != pthread_create(&p_task->thread, NULL, freertos_mock_task_entry, p_task))
+    {
+        free(p_task);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return current_task;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (TickType_t)((now.tv_sec * 1000ULL) + (now.tv_nsec / 1000000));
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec delay;
+
+    delay.tv_sec = ticks / 1000;
+    delay.tv_nsec = (long)(ticks % 1000) * 1000000;
+    nanosleep(&delay, NULL);
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    pthread_mutex_lock(&notify_mutex);
+    if (eSetBits == action)
+    {
+        task->value |= value;
+    }
+    else if (eIncrement == action)
+    {
+        task->value++;
+    }
+    task->pending = 1;
+    pthread_cond_broadcast(&notify_cond);
+    pthread_mutex_unlock(&notify_mutex);
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action,
+                              BaseType_t * p_higher_priority_task_woken)
+{
+    if (NULL != p_higher_priority_task_woken)
+    {
+        *p_higher_priority_task_woken = pdFALSE;
+    }
+    return xTaskNotify(task, value, action);
+}
+
+BaseType_t xTaskNotifyWait(uint32_t bits_to_clear_on_entry, uint32_t bits_to_clear_on_exit, uint32_t * p_value,
+                           TickType_t ticks_to_wait)
+{
+    BaseType_t result = pdFALSE;
+
+    pthread_mutex_lock(&notify_mutex);
+    if (!current_task->pending)
+    {
+        current_task->value &= ~bits_to_clear_on_entry;
+    }
+    if (freertos_mock_wait_pending(ticks_to_wait))
+    {
+        current_task->pending = 0;
+        result = pdTRUE;
+    }
+    if (NULL != p_value)
+    {
+        *p_value = current_task->value;
+    }
+    if (pdTRUE == result)
+    {
+        current_task->value &= ~bits_to_clear_on_exit;
+    }
+    pthread_mutex_unlock(&notify_mutex);
+    return result;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    return xTaskNotify(task, 0, eIncrement);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait)
+{
+    uint32_t value;
+
+    pthread_mutex_lock(&notify_mutex);
+    if (0 == current_task->value)
+    {
+        current_task->pending = 0;
+        (void)freertos_mock_wait_pending(ticks_to_wait);
+    }
+    value = current_task->value;
+    if (0 != value)
+    {
+        current_task->value = (pdTRUE == clear_count_on_exit) ? 0 : (value - 1);
+    }
+    current_task->pending = 0;
+    pthread_mutex_unlock(&notify_mutex);
+    return value;
+}
+
+TimerHandle_t xTimerCreate(const char * name, TickType_t period, UBaseType_t auto_reload, void * timer_id,
+                           TimerCallbackFunction_t callback)
+{
+    (void)name;
+    (void)period;
+    (void)auto_reload;
+    (void)timer_id;
+    if (NULL != timer_0.callback)
+    {
+        return NULL;
+    }
+    timer_0.callback = callback;
+    if (0 != pthread_create(&timer_0.thread, NULL, freertos_mock_timer_service, &timer_0))
+    {
+        timer_0.callback = NULL;
+        return NULL;
+    }
+    return &timer_0;
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    taskENTER_CRITICAL();
+    timer->expiry = xTaskGetTickCount() + period;
+    timer->active = 1;
+    taskEXIT_CRITICAL();
+    return pdPASS;
+}
+
+/**
+* @}
+*/
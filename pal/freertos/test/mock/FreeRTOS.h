@@ -0,0 +1,65 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file
+*
+* \brief Mock of the FreeRTOS kernel API used by the FreeRTOS PAL, on POSIX threads. Ticks are milliseconds
+*        of CLOCK_MONOTONIC. Only for the tests in pal/freertos/test, it is not a FreeRTOS port.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#ifndef _FREERTOS_MOCK_H_
+#define _FREERTOS_MOCK_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define configTICK_RATE_HZ          (1000)
+#define configMAX_PRIORITIES        (7)
+#define configMINIMAL_STACK_SIZE    (128)
+
+#define pdTRUE                      (1)
+#define pdFALSE                     (0)
+#define pdPASS                      (1)
+#define pdFAIL                      (0)
+#define portMAX_DELAY               (0xFFFFFFFFU)
+#define pdMS_TO_TICKS(ms)           ((TickType_t)(ms))
+
+void taskENTER_CRITICAL(void);
+void taskEXIT_CRITICAL(void);
+UBaseType_t taskENTER_CRITICAL_FROM_ISR(void);
+void taskEXIT_CRITICAL_FROM_ISR(UBaseType_t saved_interrupt_status);
+void portYIELD_FROM_ISR(BaseType_t higher_priority_task_woken);
+
+#endif /* _FREERTOS_MOCK_H_ */
+
+/**
+* @}
+*/
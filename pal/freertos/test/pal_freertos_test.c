@@ -0,0 +1,208 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file pal_freertos_test.c
+*
+* \brief   Test of the waits of the FreeRTOS PAL with two comms contexts waited for by two tasks at the same time.
+*          A simulated OPTIGA in the stack task completes the requests one after the other, each task must be woken
+*          by the completion over its own comms context and not by the timeout of the wait.
+*          The FreeRTOS kernel is replaced by the mock on POSIX threads in mock/ and freertos_mock.c.
+*
+*          gcc -DPAL_OS_HAS_EVENT_INIT -DPAL_OS_HAS_EVENT_WAIT -DPAL_FREERTOS_WAIT_TIMEOUT_MS=200
+*              -Ioptiga/include -Ipal/freertos -Ipal/freertos/test/mock pal/freertos/test/pal_freertos_test.c
+*              pal/freertos/test/freertos_mock.c pal/freertos/pal_os_event.c pal/freertos/pal_os_timer.c
+*              -lpthread -o pal_freertos_test
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "optiga/pal/pal_os_event.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "pal_freertos.h"
+
+#define TEST_CHECK(condition)                                               \
+    if (!(condition))                                                       \
+    {                                                                       \
+        printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition);       \
+        return -1;                                                          \
+    }
+
+/// Execution time of a request in the simulated OPTIGA
+#define TEST_EXEC_TIME_US   (20000)
+
+/// @cond hidden
+/// Request of a task over a comms context
+typedef struct test_request
+{
+    /// Comms context the request is sent over
+    const void * p_ctx;
+    /// Cancel the wait instead of waiting for the completion
+    uint8_t cancel;
+    /// Task is prepared for the wait
+    volatile uint8_t prepared;
+    /// Request is completed by the simulated OPTIGA
+    volatile uint8_t completed;
+    /// Task is done waiting
+    volatile uint8_t done;
+    /// Number of waits till the completion was seen
+    uint32_t waits;
+    /// Time at which the task was woken for the last time
+    uint32_t woken_ms;
+} test_request_t;
+
+static uint8_t test_comms_a;
+static uint8_t test_comms_b;
+static test_request_t * test_queue[2];
+static uint8_t test_queue_count;
+static uint8_t test_queue_next;
+
+// Simulated OPTIGA in the stack task: completes the queued requests one after the other
+static void test_chip_callback(void * p_args)
+{
+    test_request_t * p_request = test_queue[test_queue_next++];
+
+    (void)p_args;
+    p_request->completed = 1;
+    pal_os_event_notify(p_request->p_ctx);
+    if (test_queue_next < test_queue_count)
+    {
+        pal_os_event_register_callback_oneshot(test_chip_callback, NULL, TEST_EXEC_TIME_US);
+    }
+}
+
+// Task sending a request, waits like the command library
+static void test_request_task(void * p_args)
+{
+    test_request_t * p_request = (test_request_t *)p_args;
+
+    pal_os_event_prepare_wait(p_request->p_ctx);
+    if (p_request->cancel)
+    {
+        pal_os_event_cancel_wait(p_request->p_ctx);
+    }
+    p_request->prepared = 1;
+    do
+    {
+        pal_os_event_wait(p_request->p_ctx);
+        p_request->waits++;
+        p_request->woken_ms = pal_os_timer_get_time_in_milliseconds();
+    } while (!p_request->completed);
+    p_request->done = 1;
+    for (;;)
+    {
+        vTaskDelay(1000);
+    }
+}
+
+static void test_wait_until(volatile uint8_t * p_flag)
+{
+    uint32_t start_ms = pal_os_timer_get_time_in_milliseconds();
+
+    while (!*p_flag && ((pal_os_timer_get_time_in_milliseconds() - start_ms) < 2000))
+    {
+        vTaskDelay(1);
+    }
+}
+
+static int test_run_requests(test_request_t * p_first, test_request_t * p_second)
+{
+    TaskHandle_t task;
+
+    test_queue[0] = p_first;
+    test_queue[1] = p_second;
+    test_queue_count = 2;
+    test_queue_next = 0;
+
+    TEST_CHECK(pdPASS == xTaskCreate(test_request_task, "first", configMINIMAL_STACK_SIZE, p_first, 1, &task));
+    TEST_CHECK(pdPASS == xTaskCreate(test_request_task, "second", configMINIMAL_STACK_SIZE, p_second, 1, &task));
+    test_wait_until(&p_first->prepared);
+    test_wait_until(&p_second->prepared);
+
+    pal_os_event_register_callback_oneshot(test_chip_callback, NULL, TEST_EXEC_TIME_US);
+    test_wait_until(&p_first->done);
+    test_wait_until(&p_second->done);
+    TEST_CHECK(p_first->done && p_second->done);
+    return 0;
+}
+
+int test_waiters_per_context(void)
+{
+    test_request_t first = {&test_comms_a, 0, 0, 0, 0, 0, 0};
+    test_request_t second = {&test_comms_b, 0, 0, 0, 0, 0, 0};
+    uint32_t start_ms = pal_os_timer_get_time_in_milliseconds();
+
+    // The second task prepares last, the completion of the first request still wakes the first task
+    TEST_CHECK(0 == test_run_requests(&first, &second));
+    TEST_CHECK(1 == first.waits);
+    TEST_CHECK(1 == second.waits);
+    TEST_CHECK(first.woken_ms <= second.woken_ms);
+    TEST_CHECK((second.woken_ms - start_ms) < PAL_FREERTOS_WAIT_TIMEOUT_MS);
+    return 0;
+}
+
+int test_cancelled_wait(void)
+{
+    test_request_t first = {&test_comms_a, 1, 0, 0, 0, 0, 0};
+    test_request_t second = {&test_comms_b, 0, 0, 0, 0, 0, 0};
+    uint32_t start_ms = pal_os_timer_get_time_in_milliseconds();
+
+    // The cancelled task is not woken by the completion, only by the timeout of its wait
+    TEST_CHECK(0 == test_run_requests(&first, &second));
+    TEST_CHECK(1 == first.waits);
+    TEST_CHECK((first.woken_ms - start_ms) >= PAL_FREERTOS_WAIT_TIMEOUT_MS);
+    TEST_CHECK(1 == second.waits);
+    TEST_CHECK((second.woken_ms - start_ms) < PAL_FREERTOS_WAIT_TIMEOUT_MS);
+    return 0;
+}
+/// @endcond
+
+int main(void)
+{
+    int status = 0;
+
+    if (PAL_STATUS_SUCCESS != pal_os_event_init())
+    {
+        printf("FAILED to create the stack task\n");
+        return 1;
+    }
+
+    status |= test_waiters_per_context();
+    status |= test_cancelled_wait();
+
+    printf("%s\n", (0 == status) ? "PASSED" : "FAILED");
+    return (0 == status) ? 0 : 1;
+}
+
+/**
+* @}
+*/
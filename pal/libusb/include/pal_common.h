@@ -70,5 +70,6 @@ int usb_hid_get_feature(uint8_t report_id, uint8_t* report,pal_usb_t* usb_events
 uint16_t ifx_i2c_usb_reset(pal_usb_t usb_events);
 int usb_hid_set_feature(uint8_t report_id, uint8_t* data, uint8_t length,pal_usb_t* usb_events);
 void print_status(uint8_t s);
+void pal_usb_event_trigger_registered_callback(pal_usb_t* pal_usb);
 
 #endif
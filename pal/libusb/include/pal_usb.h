@@ -50,6 +50,10 @@
 #include <unistd.h>
 #endif
 #include "optiga/pal/pal_i2c.h"
+#include "optiga/pal/pal_gpio.h"
+#include "optiga/pal/pal_os_event.h"
+#include "optiga/ifx_i2c/ifx_i2c_config.h"
+#include "optiga/comms/optiga_comms.h"
 #include "optiga/common/Datatypes.h"
 /**********************************************************************************************************************
  * MACROS
@@ -92,10 +96,35 @@
 #define false 0
 #define true 1
 
+// Maximum number of dongles driven at the same time
+#define PAL_USB_MAX_DEVICES         8
+
 /**********************************************************************************************************************
  * ENUMS
  *********************************************************************************************************************/
 
+/** @brief State of a dongle */
+typedef enum pal_usb_state
+{
+    /// Slot is not used
+    PAL_USB_STATE_FREE = 0,
+    /// Dongle is attached, but not yet opened
+    PAL_USB_STATE_ARRIVED,
+    /// Dongle is opened and can be used
+    PAL_USB_STATE_READY,
+    /// Dongle is detached, slot must be released with #pal_usb_release_device
+    PAL_USB_STATE_REMOVED
+} pal_usb_state_t;
+
+/** @brief Hotplug events reported to the application */
+typedef enum pal_usb_event
+{
+    /// Dongle is attached and ready to be used
+    PAL_USB_EVENT_ARRIVED = 1,
+    /// Dongle is detached
+    PAL_USB_EVENT_REMOVED
+} pal_usb_event_t;
+
 /**********************************************************************************************************************
  * DATA STRUCTURES
  *********************************************************************************************************************/
@@ -116,7 +145,102 @@ typedef struct pal_usb
     uint8_t hid_ep_in;
     /// Endpoint to write to device
     uint8_t hid_ep_out;
-   
+    /// Device as enumerated by libusb, used to match the hotplug events
+    libusb_device* device;
+    /// State of the dongle, see #pal_usb_state_t
+    volatile uint8_t state;
+    /// Hotplug event to be reported to the application
+    uint8_t pending_event;
+    /// Bus number of the dongle
+    uint8_t bus_number;
+    /// Address of the dongle on the bus
+    uint8_t device_address;
+    /// I2C bus of the dongle is acquired
+    volatile uint8_t i2c_busy;
+    /// Pal i2c context of the ongoing i2c transaction
+    pal_i2c_t* p_current_i2c_ctx;
+    /// Callback registered by the ifx i2c stack of the dongle
+    volatile register_callback event_callback;
+    /// Context of the registered callback
+    void* event_callback_ctx;
+    /// Completion status of the optiga comms request on the dongle
+    volatile host_lib_status_t completion_status;
+    /// Pal i2c context of the OPTIGA on the dongle
+    pal_i2c_t pal_i2c_ctx;
+    /// Reset pin of the OPTIGA on the dongle
+    pal_gpio_t reset_pin;
+    /// IFX I2C context of the OPTIGA on the dongle
+    ifx_i2c_context_t ifx_i2c_ctx;
+    /// Optiga comms instance of the OPTIGA on the dongle
+    optiga_comms_t comms;
 } pal_usb_t;
 
+/**
+ * \brief Callback to report the attach and detach of dongles.
+ *
+ * \param[in] p_ctx     Context registered with #pal_usb_register_hotplug_handler
+ * \param[in] pal_usb   Dongle
+ * \param[in] event     #PAL_USB_EVENT_ARRIVED or #PAL_USB_EVENT_REMOVED
+ */
+typedef void (*pal_usb_hotplug_handler_t)(void* p_ctx, pal_usb_t* pal_usb, pal_usb_event_t event);
+
+/**********************************************************************************************************************
+ * API Prototypes
+ *********************************************************************************************************************/
+
+/**
+ * \brief Returns a dongle which is ready to be used.
+ *
+ *<b>API Details:</b>
+ * - All the dongles with #USB_VID and #USB_PID are opened by pal_init and on hotplug.<br>
+ * - Every dongle is an independent OPTIGA instance, its <b>comms</b> can be used with #optiga_comms_open
+ *   and the optiga comms APIs or added to an OPTIGA cluster. The dongles can be driven concurrently from
+ *   different threads, each dongle from one thread at a time.<br>
+ * - The pal i2c and reset pin contexts of pal_ifx_usb_config.c are bound to the first dongle found by pal_init
+ *   and must not be used together with the instance of that dongle.<br>
+ *
+ * \param[in] index   Slot index, 0 to #PAL_USB_MAX_DEVICES - 1
+ *
+ * \retval  Pointer to the dongle, NULL if the slot does not hold a ready dongle
+ */
+LIBRARY_EXPORTS pal_usb_t* pal_usb_get_device(uint8_t index);
+
+/**
+ * \brief Registers the application callback for the attach and detach of dongles.
+ *
+ * \param[in] handler   Callback, NULL to unregister
+ * \param[in] p_ctx     Context passed to the callback
+ */
+LIBRARY_EXPORTS void pal_usb_register_hotplug_handler(pal_usb_hotplug_handler_t handler, void* p_ctx);
+
+/**
+ * \brief Handles the hotplug events.
+ *
+ *<b>API Details:</b>
+ * - Waits for the libusb events up to timeout_ms, opens the attached dongles and reports the attach and detach
+ *   to the registered callback, which is invoked from the calling thread.<br>
+ * - If the platform does not support the libusb hotplug, the bus is enumerated again instead.<br>
+ * - Must be called periodically from one thread, e.g. the main thread of the station.<br>
+ *
+ * \param[in] timeout_ms   Maximum time to wait for events
+ *
+ * \retval  #PAL_STATUS_SUCCESS  Events are handled
+ * \retval  #PAL_STATUS_FAILURE  libusb failed to handle the events
+ */
+LIBRARY_EXPORTS pal_status_t pal_usb_handle_events(uint32_t timeout_ms);
+
+/**
+ * \brief Closes a dongle and frees its slot.
+ *
+ *<b>Notes:</b>
+ * - A detached dongle keeps its slot until released, so that the instance stays valid for the threads still
+ *   using it. Must be called only after the comms instance of the dongle is not used any more.<br>
+ *
+ * \param[in] pal_usb   Dongle to be released
+ *
+ * \retval  #PAL_STATUS_SUCCESS  Dongle is released
+ * \retval  #PAL_STATUS_FAILURE  Invalid dongle
+ */
+LIBRARY_EXPORTS pal_status_t pal_usb_release_device(pal_usb_t* pal_usb);
+
 #endif
@@ -41,6 +41,7 @@
 #include "optiga/ifx_i2c/ifx_i2c.h"
 #include "optiga/pal/pal_os_event.h"
 #include "pal_usb.h"
+#include "pal_common.h"
 
 /// @cond hidden
 /**********************************************************************************************************************
@@ -57,6 +58,10 @@
 #define SENDDATA 0
 #define RESPONSEDATA 1
 
+/// Dongle which serves the optiga comms instance
+#define PAL_USB_OF_COMMS(p_ctx) \
+    ((pal_usb_t*)((ifx_i2c_context_t*)((p_ctx)->comms_ctx))->p_pal_i2c_ctx->p_i2c_hw_config)
+
 /**********************************************************************************************************************
  * LOCAL DATA
  *********************************************************************************************************************/
@@ -66,12 +71,9 @@
 static host_lib_status_t check_optiga_comms_state(optiga_comms_t *p_ctx);
 static void ifx_i2c_event_handler(void* upper_layer_ctx, host_lib_status_t event);
 
-uint16_t completion_status;
-
 extern pal_i2c_t optiga_pal_i2c_context_0;
 //pal_gpio_t optiga_vdd_0;
 extern pal_gpio_t optiga_reset_0;
-extern void pal_os_event_trigger_registered_callback(void);
 
 ifx_i2c_context_t ifx_i2c_context_1 =
 {
@@ -130,6 +132,7 @@ ifx_i2c_context_t ifx_i2c_context_1 =
 host_lib_status_t optiga_comms_open(optiga_comms_t *p_ctx)
 {
     host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    pal_usb_t * pal_usb;
 
     if (OPTIGA_COMMS_SUCCESS == check_optiga_comms_state(p_ctx))
     {
@@ -139,7 +142,8 @@ host_lib_status_t optiga_comms_open(optiga_comms_t *p_ctx)
     	((ifx_i2c_context_t*)(p_ctx->comms_ctx))->p_upper_layer_ctx = (void*)p_ctx;
 		((ifx_i2c_context_t*)(p_ctx->comms_ctx))->upper_layer_event_handler = ifx_i2c_event_handler;
 
-        completion_status = OPTIGA_COMMS_BUSY;
+        pal_usb = PAL_USB_OF_COMMS(p_ctx);
+        pal_usb->completion_status = OPTIGA_COMMS_BUSY;
         status = ifx_i2c_open((ifx_i2c_context_t*)(p_ctx->comms_ctx));
         if (IFX_I2C_STACK_SUCCESS != status)
         {
@@ -148,9 +152,9 @@ host_lib_status_t optiga_comms_open(optiga_comms_t *p_ctx)
         }
         do
         {
-            pal_os_event_trigger_registered_callback();
-        }while(completion_status == OPTIGA_COMMS_BUSY);
-        status = completion_status;
+            pal_usb_event_trigger_registered_callback(pal_usb);
+        }while(pal_usb->completion_status == OPTIGA_COMMS_BUSY);
+        status = pal_usb->completion_status;
     }
     return status; 
 }
@@ -185,10 +189,13 @@ host_lib_status_t optiga_comms_open(optiga_comms_t *p_ctx)
 host_lib_status_t optiga_comms_reset(optiga_comms_t *p_ctx,uint8_t reset_type)
 {
     host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    pal_usb_t * pal_usb;
     if (OPTIGA_COMMS_SUCCESS == check_optiga_comms_state(p_ctx))
     {
         ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->p_upper_layer_ctx = (void*)p_ctx;
         ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->upper_layer_event_handler = ifx_i2c_event_handler;
+        pal_usb = PAL_USB_OF_COMMS(p_ctx);
+        pal_usb->completion_status = OPTIGA_COMMS_BUSY;
         status = ifx_i2c_reset((ifx_i2c_context_t*)(p_ctx->comms_ctx),(ifx_i2c_reset_type_t)reset_type); 
         if (IFX_I2C_STACK_SUCCESS != status)
         {
@@ -197,8 +204,8 @@ host_lib_status_t optiga_comms_reset(optiga_comms_t *p_ctx,uint8_t reset_type)
         }
         do
         {       
-            pal_os_event_trigger_registered_callback();
-        }while(completion_status == OPTIGA_COMMS_BUSY);
+            pal_usb_event_trigger_registered_callback(pal_usb);
+        }while(pal_usb->completion_status == OPTIGA_COMMS_BUSY);
     }
     return status;
 }
@@ -246,12 +253,14 @@ host_lib_status_t optiga_comms_transceive(optiga_comms_t *p_ctx,const uint8_t* p
                                           uint8_t* p_buffer, uint16_t* p_buffer_len)
 {
     host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    pal_usb_t * pal_usb;
     if (OPTIGA_COMMS_SUCCESS == check_optiga_comms_state(p_ctx))
     {
         ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->p_upper_layer_ctx = (void*)p_ctx;
         ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->upper_layer_event_handler = ifx_i2c_event_handler;
 
-        completion_status = OPTIGA_COMMS_BUSY;
+        pal_usb = PAL_USB_OF_COMMS(p_ctx);
+        pal_usb->completion_status = OPTIGA_COMMS_BUSY;
 
         status = (ifx_i2c_transceive((ifx_i2c_context_t*)(p_ctx->comms_ctx),p_data,p_data_length,p_buffer,p_buffer_len));
         if (IFX_I2C_STACK_SUCCESS != status)
@@ -261,10 +270,10 @@ host_lib_status_t optiga_comms_transceive(optiga_comms_t *p_ctx,const uint8_t* p
         }
         do
         {
-            pal_os_event_trigger_registered_callback();
-        }while(completion_status == OPTIGA_COMMS_BUSY);
+            pal_usb_event_trigger_registered_callback(pal_usb);
+        }while(pal_usb->completion_status == OPTIGA_COMMS_BUSY);
 
-        status = completion_status;
+        status = pal_usb->completion_status;
     }
     return status;
 }
@@ -292,10 +301,13 @@ host_lib_status_t optiga_comms_transceive(optiga_comms_t *p_ctx,const uint8_t* p
 host_lib_status_t optiga_comms_close(optiga_comms_t *p_ctx)
 {
     host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    pal_usb_t * pal_usb;
     if (OPTIGA_COMMS_SUCCESS == check_optiga_comms_state(p_ctx))
     {      
         ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->p_upper_layer_ctx = (void*)p_ctx;
         ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->upper_layer_event_handler = ifx_i2c_event_handler;
+        pal_usb = PAL_USB_OF_COMMS(p_ctx);
+        pal_usb->completion_status = OPTIGA_COMMS_BUSY;
         status = ifx_i2c_close((ifx_i2c_context_t*)(p_ctx->comms_ctx)); 
         if (IFX_I2C_STACK_SUCCESS != status)
         {
@@ -304,8 +316,8 @@ host_lib_status_t optiga_comms_close(optiga_comms_t *p_ctx)
         } 
         do
         {
-            pal_os_event_trigger_registered_callback();
-        }while(completion_status == OPTIGA_COMMS_BUSY);
+            pal_usb_event_trigger_registered_callback(pal_usb);
+        }while(pal_usb->completion_status == OPTIGA_COMMS_BUSY);
     }
     return status;
 }
@@ -331,7 +343,7 @@ static void ifx_i2c_event_handler(void* upper_layer_ctx, host_lib_status_t event
     {
         ((optiga_comms_t*)upper_layer_ctx)->upper_layer_handler(ctx,event);
     }
-    completion_status = event;
+    PAL_USB_OF_COMMS((optiga_comms_t*)upper_layer_ctx)->completion_status = event;
     ((optiga_comms_t*)upper_layer_ctx)->state = OPTIGA_COMMS_FREE;
 }
 
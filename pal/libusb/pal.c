@@ -38,12 +38,16 @@
  * HEADER FILES
  *********************************************************************************************************************/
 #include "optiga/pal/pal_i2c.h"
+#include "optiga/pal/pal_os_timer.h"
 #ifdef __WIN32__
 #include "libusb.h"
+#include <windows.h>
 #else // LINUX
 #include <libusb-1.0/libusb.h>
 #include <unistd.h>
+#include <pthread.h>
 #endif
+#include <string.h>
 #include "pal_usb.h"
 #include "pal_common.h"
 
@@ -59,83 +63,507 @@
 #endif
 
 #define WAIT_500_MS    (500)
+// Hotplug events queued by the libusb callback till pal_usb_process_pending applies them
+#define PAL_USB_HOTPLUG_QUEUE_SIZE    (PAL_USB_MAX_DEVICES * 2)
 /// @cond hidden
 /*********************************************************************************************************************
  * LOCAL DATA
  *********************************************************************************************************************/
 
 extern pal_usb_t usb_events;
-static libusb_device_handle *dev_handle = NULL; //a device handle
+extern ifx_i2c_context_t ifx_i2c_context_1;
+
+/// Dongles found on the bus
+static pal_usb_t pal_usb_devices[PAL_USB_MAX_DEVICES];
+/// Handle of the registered libusb hotplug callback
+static libusb_hotplug_callback_handle hotplug_callback_handle;
+/// libusb hotplug callback is registered
+static uint8_t hotplug_registered = false;
+/// Application callback for attach and detach
+static pal_usb_hotplug_handler_t hotplug_handler = NULL;
+/// Context of the application callback
+static void * hotplug_handler_ctx = NULL;
+
+/// Hotplug event reported by libusb
+typedef struct pal_usb_hotplug_event
+{
+	libusb_device * device;
+	libusb_hotplug_event event;
+} pal_usb_hotplug_event_t;
+
+/// Events of the hotplug callback, which can be run by libusb in any thread handling the libusb events
+static pal_usb_hotplug_event_t hotplug_queue[PAL_USB_HOTPLUG_QUEUE_SIZE];
+/// Number of queued hotplug events
+static uint8_t hotplug_queue_count = 0;
+#ifdef __WIN32__
+static CRITICAL_SECTION hotplug_queue_lock;
+#else
+static pthread_mutex_t hotplug_queue_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 /**********************************************************************************************************************
  * LOCAL ROUTINES
  *********************************************************************************************************************/
 
-pal_status_t pal_init(void)
+static void pal_usb_queue_lock(void)
+{
+#ifdef __WIN32__
+	EnterCriticalSection(&hotplug_queue_lock);
+#else
+	pthread_mutex_lock(&hotplug_queue_lock);
+#endif
+}
+
+static void pal_usb_queue_unlock(void)
+{
+#ifdef __WIN32__
+	LeaveCriticalSection(&hotplug_queue_lock);
+#else
+	pthread_mutex_unlock(&hotplug_queue_lock);
+#endif
+}
+
+// Opens the dongle, reads the HID endpoints and resets the I2C master of the dongle
+static pal_status_t pal_usb_open(pal_usb_t * pal_usb)
 {
 	struct libusb_config_descriptor* config_desc = NULL;
-	
-	if (libusb_init(NULL))
+	pal_status_t status = PAL_I2C_EVENT_ERROR;
+
+	if (libusb_open(pal_usb->device, &pal_usb->handle))
 	{
-		LOG_PAL("Failed to init libusb\n.");
+		LOG_PAL("Error: failed to open the dongle at %d:%d\n.", pal_usb->bus_number, pal_usb->device_address);
+		pal_usb->handle = NULL;
 		return PAL_I2C_EVENT_ERROR;
 	}
-	LOG_PAL("pal_init\n. ");
 
-	//libusb_set_debug(NULL, 4);
+	do
+	{
+#ifndef __WIN32__ // LINUX
+		libusb_detach_kernel_driver(pal_usb->handle, USB_INTERFACE);
+#else
+		if (libusb_claim_interface(pal_usb->handle, 0) < 0)
+		{
+			break;
+		}
+#endif
+
+		if (libusb_get_active_config_descriptor(pal_usb->device, &config_desc))
+		{
+			config_desc = NULL;
+			break;
+		}
 
-	dev_handle = libusb_open_device_with_vid_pid(NULL, USB_VID, USB_PID);
-	
-	usb_events.handle = dev_handle;
+		if (config_desc->bNumInterfaces < 1 || config_desc->interface->num_altsetting < 1
+			|| config_desc->interface->altsetting->bNumEndpoints < 2)
+		{
+			break;
+		}
 
-	if (usb_events.handle == NULL)
+		pal_usb->hid_ep_in = config_desc->interface->altsetting->endpoint->bEndpointAddress;
+		if (config_desc->interface->altsetting->endpoint->wMaxPacketSize != HID_REPORT_SIZE)
+		{
+			break;
+		}
+
+		pal_usb->hid_ep_out = (config_desc->interface->altsetting->endpoint + 1)->bEndpointAddress;
+		if (((config_desc->interface->altsetting->endpoint) + 1)->wMaxPacketSize != HID_REPORT_SIZE)
+		{
+			break;
+		}
+
+		if (ifx_i2c_usb_reset(*pal_usb) != PAL_STATUS_SUCCESS)
+		{
+			break;
+		}
+		status = PAL_STATUS_SUCCESS;
+	} while (0);
+
+	if (config_desc != NULL)
 	{
-		LOG_PAL("Error: dev_handle is NULL!\n.");
-		return PAL_I2C_EVENT_ERROR;
+		libusb_free_config_descriptor(config_desc);
+	}
+	if (status != PAL_STATUS_SUCCESS)
+	{
+		libusb_close(pal_usb->handle);
+		pal_usb->handle = NULL;
 	}
+	return status;
+}
 
-#ifndef __WIN32__ // LINUX
-	libusb_detach_kernel_driver(usb_events.handle, USB_INTERFACE);
-#else
-	if (libusb_claim_interface(usb_events.handle, 0) < 0)
+// Builds the OPTIGA instance (pal i2c, reset pin, ifx i2c and optiga comms contexts) of the dongle
+static void pal_usb_setup_instance(pal_usb_t * pal_usb)
+{
+	memset(&pal_usb->pal_i2c_ctx, 0, sizeof(pal_usb->pal_i2c_ctx));
+	pal_usb->pal_i2c_ctx.p_i2c_hw_config = (void*)pal_usb;
+	pal_usb->pal_i2c_ctx.slave_address = ifx_i2c_context_1.slave_address;
+
+	pal_usb->reset_pin.p_gpio_hw = (void*)pal_usb;
+
+	// Only the configuration of the default ifx i2c context is taken over, the protocol state starts from zero
+	memset(&pal_usb->ifx_i2c_ctx, 0, sizeof(pal_usb->ifx_i2c_ctx));
+	pal_usb->ifx_i2c_ctx.slave_address = ifx_i2c_context_1.slave_address;
+	pal_usb->ifx_i2c_ctx.frequency = ifx_i2c_context_1.frequency;
+	pal_usb->ifx_i2c_ctx.frame_size = ifx_i2c_context_1.frame_size;
+	pal_usb->ifx_i2c_ctx.p_slave_vdd_pin = NULL;
+	pal_usb->ifx_i2c_ctx.p_slave_reset_pin = &pal_usb->reset_pin;
+	pal_usb->ifx_i2c_ctx.p_pal_i2c_ctx = &pal_usb->pal_i2c_ctx;
+
+	memset(&pal_usb->comms, 0, sizeof(pal_usb->comms));
+	pal_usb->comms.comms_ctx = (void*)&pal_usb->ifx_i2c_ctx;
+}
+
+// Returns the slot of an attached dongle, NULL if the device is not known
+static pal_usb_t * pal_usb_find_device(const libusb_device * device)
+{
+	uint8_t index;
+
+	for (index = 0; index < PAL_USB_MAX_DEVICES; index++)
 	{
-		libusb_close(dev_handle);
-		dev_handle=NULL;
-		return PAL_I2C_EVENT_ERROR;
+		if (((PAL_USB_STATE_ARRIVED == pal_usb_devices[index].state) ||
+			 (PAL_USB_STATE_READY == pal_usb_devices[index].state)) &&
+			(device == pal_usb_devices[index].device))
+		{
+			return &pal_usb_devices[index];
+		}
 	}
-#endif
+	return NULL;
+}
 
-	if (libusb_get_active_config_descriptor(libusb_get_device(usb_events.handle), &config_desc))
+// Records an attached dongle, it is opened by pal_usb_process_pending
+static void pal_usb_add_device(libusb_device * device)
+{
+	uint8_t index;
+
+	if (NULL != pal_usb_find_device(device))
 	{
-		return PAL_I2C_EVENT_ERROR;
+		return;
+	}
+	for (index = 0; index < PAL_USB_MAX_DEVICES; index++)
+	{
+		if (PAL_USB_STATE_FREE == pal_usb_devices[index].state)
+		{
+			memset(&pal_usb_devices[index], 0, sizeof(pal_usb_t));
+			pal_usb_devices[index].device = libusb_ref_device(device);
+			pal_usb_devices[index].bus_number = libusb_get_bus_number(device);
+			pal_usb_devices[index].device_address = libusb_get_device_address(device);
+			pal_usb_devices[index].state = PAL_USB_STATE_ARRIVED;
+			return;
+		}
 	}
+	LOG_PAL("Error: no free slot for the dongle, max %d\n.", PAL_USB_MAX_DEVICES);
+}
+
+// Marks a detached dongle, the transfers on the dongle fail from now on
+static void pal_usb_remove_device(libusb_device * device)
+{
+	pal_usb_t * pal_usb = pal_usb_find_device(device);
 
-	if (config_desc->bNumInterfaces < 1 || config_desc->interface->num_altsetting < 1
-		|| config_desc->interface->altsetting->bNumEndpoints < 2)
+	if (NULL == pal_usb)
 	{
-		return PAL_I2C_EVENT_ERROR;
+		return;
 	}
+	if (PAL_USB_STATE_ARRIVED == pal_usb->state)
+	{
+		// Not yet reported to the application
+		libusb_unref_device(pal_usb->device);
+		memset(pal_usb, 0, sizeof(pal_usb_t));
+		return;
+	}
+	pal_usb->state = PAL_USB_STATE_REMOVED;
+	pal_usb->pending_event = PAL_USB_EVENT_REMOVED;
+	if (device == usb_events.device)
+	{
+		usb_events.state = PAL_USB_STATE_REMOVED;
+	}
+}
 
-	usb_events.hid_ep_in = config_desc->interface->altsetting->endpoint->bEndpointAddress;
-	if (config_desc->interface->altsetting->endpoint->wMaxPacketSize != HID_REPORT_SIZE)
+//lint --e{715} suppress "ctx and user_data are not used, the dongles are kept in the local table"
+static int LIBUSB_CALL pal_usb_hotplug_callback(libusb_context * ctx, libusb_device * device,
+                                                libusb_hotplug_event event, void * user_data)
+{
+	// No transfers are allowed in here and the callback can run in another thread handling the libusb events,
+	// e.g. during a synchronous transfer. The dongles are only updated by pal_usb_process_pending.
+	pal_usb_queue_lock();
+	if (hotplug_queue_count < PAL_USB_HOTPLUG_QUEUE_SIZE)
 	{
-		return PAL_I2C_EVENT_ERROR;
+		hotplug_queue[hotplug_queue_count].device = libusb_ref_device(device);
+		hotplug_queue[hotplug_queue_count].event = event;
+		hotplug_queue_count++;
+	}
+	else
+	{
+		LOG_PAL("Error: hotplug event dropped, max %d\n.", PAL_USB_HOTPLUG_QUEUE_SIZE);
 	}
+	pal_usb_queue_unlock();
+	// Keep the callback registered
+	return 0;
+}
 
-	usb_events.hid_ep_out = (config_desc->interface->altsetting->endpoint + 1)->bEndpointAddress;
-	if (((config_desc->interface->altsetting->endpoint) + 1)->wMaxPacketSize != HID_REPORT_SIZE)
+// Enumerates the bus, used at init and where libusb does not support hotplug
+static void pal_usb_rescan(void)
+{
+	libusb_device ** device_list = NULL;
+	struct libusb_device_descriptor device_desc;
+	ssize_t count;
+	ssize_t i;
+	uint8_t index;
+	uint8_t found;
+
+	count = libusb_get_device_list(NULL, &device_list);
+	if (count < 0)
 	{
-		return PAL_I2C_EVENT_ERROR;
+		return;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		if ((0 == libusb_get_device_descriptor(device_list[i], &device_desc)) &&
+			(USB_VID == device_desc.idVendor) && (USB_PID == device_desc.idProduct))
+		{
+			pal_usb_add_device(device_list[i]);
+		}
+	}
+
+	for (index = 0; index < PAL_USB_MAX_DEVICES; index++)
+	{
+		if (PAL_USB_STATE_READY != pal_usb_devices[index].state)
+		{
+			continue;
+		}
+		found = false;
+		for (i = 0; i < count; i++)
+		{
+			if (device_list[i] == pal_usb_devices[index].device)
+			{
+				found = true;
+				break;
+			}
+		}
+		if (!found)
+		{
+			pal_usb_remove_device(pal_usb_devices[index].device);
+		}
+	}
+
+	libusb_free_device_list(device_list, 1);
+}
+
+// Applies the queued hotplug events, opens the attached dongles and reports the attach and detach to the application
+static void pal_usb_process_pending(void)
+{
+	pal_usb_hotplug_event_t events[PAL_USB_HOTPLUG_QUEUE_SIZE];
+	uint8_t count;
+	uint8_t index;
+	pal_usb_t * pal_usb;
+
+	pal_usb_queue_lock();
+	count = hotplug_queue_count;
+	memcpy(events, hotplug_queue, count * sizeof(pal_usb_hotplug_event_t));
+	hotplug_queue_count = 0;
+	pal_usb_queue_unlock();
+
+	for (index = 0; index < count; index++)
+	{
+		if (LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED == events[index].event)
+		{
+			pal_usb_add_device(events[index].device);
+		}
+		else
+		{
+			pal_usb_remove_device(events[index].device);
+		}
+		libusb_unref_device(events[index].device);
+	}
+
+	for (index = 0; index < PAL_USB_MAX_DEVICES; index++)
+	{
+		pal_usb = &pal_usb_devices[index];
+		if (PAL_USB_STATE_ARRIVED == pal_usb->state)
+		{
+			if (PAL_STATUS_SUCCESS == pal_usb_open(pal_usb))
+			{
+				pal_usb_setup_instance(pal_usb);
+				pal_usb->state = PAL_USB_STATE_READY;
+				pal_usb->pending_event = PAL_USB_EVENT_ARRIVED;
+			}
+			else
+			{
+				libusb_unref_device(pal_usb->device);
+				memset(pal_usb, 0, sizeof(pal_usb_t));
+			}
+		}
+
+		if (0 != pal_usb->pending_event)
+		{
+			if (NULL != hotplug_handler)
+			{
+				hotplug_handler(hotplug_handler_ctx, pal_usb, (pal_usb_event_t)pal_usb->pending_event);
+			}
+			pal_usb->pending_event = 0;
+		}
 	}
+}
+/// @endcond
+
+/**********************************************************************************************************************
+ * API IMPLEMENTATION
+ *********************************************************************************************************************/
 
-	if (ifx_i2c_usb_reset(usb_events) != PAL_STATUS_SUCCESS)
+pal_status_t pal_init(void)
+{
+	uint8_t index;
+
+	if (libusb_init(NULL))
 	{
+		LOG_PAL("Failed to init libusb\n.");
 		return PAL_I2C_EVENT_ERROR;
 	}
-	return PAL_STATUS_SUCCESS;
+	LOG_PAL("pal_init\n. ");
+
+	//libusb_set_debug(NULL, 4);
+
+#ifdef __WIN32__
+	InitializeCriticalSection(&hotplug_queue_lock);
+#endif
+
+	// Register before enumerating, so that no dongle is missed. A dongle seen twice is recorded once.
+	if (libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG))
+	{
+		if (LIBUSB_SUCCESS == libusb_hotplug_register_callback(NULL,
+		                                                       LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED |
+		                                                       LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT,
+		                                                       LIBUSB_HOTPLUG_NO_FLAGS,
+		                                                       USB_VID,
+		                                                       USB_PID,
+		                                                       LIBUSB_HOTPLUG_MATCH_ANY,
+		                                                       pal_usb_hotplug_callback,
+		                                                       NULL,
+		                                                       &hotplug_callback_handle))
+		{
+			hotplug_registered = true;
+		}
+	}
+
+	pal_usb_rescan();
+	pal_usb_process_pending();
+
+	// The default contexts of pal_ifx_usb_config.c use the first dongle
+	for (index = 0; index < PAL_USB_MAX_DEVICES; index++)
+	{
+		if (PAL_USB_STATE_READY == pal_usb_devices[index].state)
+		{
+			usb_events.handle = pal_usb_devices[index].handle;
+			usb_events.hid_ep_in = pal_usb_devices[index].hid_ep_in;
+			usb_events.hid_ep_out = pal_usb_devices[index].hid_ep_out;
+			usb_events.device = pal_usb_devices[index].device;
+			usb_events.bus_number = pal_usb_devices[index].bus_number;
+			usb_events.device_address = pal_usb_devices[index].device_address;
+			usb_events.state = PAL_USB_STATE_READY;
+			return PAL_STATUS_SUCCESS;
+		}
+	}
+
+	LOG_PAL("Error: no dongle found!\n.");
+	return PAL_I2C_EVENT_ERROR;
 }
 
 pal_status_t pal_deinit(void)
 {
+	uint8_t index;
+
+	if (hotplug_registered)
+	{
+		libusb_hotplug_deregister_callback(NULL, hotplug_callback_handle);
+		hotplug_registered = false;
+	}
+	// Events queued but not yet applied
+	pal_usb_queue_lock();
+	for (index = 0; index < hotplug_queue_count; index++)
+	{
+		libusb_unref_device(hotplug_queue[index].device);
+	}
+	hotplug_queue_count = 0;
+	pal_usb_queue_unlock();
+	for (index = 0; index < PAL_USB_MAX_DEVICES; index++)
+	{
+		if (PAL_USB_STATE_FREE != pal_usb_devices[index].state)
+		{
+			pal_usb_release_device(&pal_usb_devices[index]);
+		}
+	}
+	libusb_exit(NULL);
+#ifdef __WIN32__
+	DeleteCriticalSection(&hotplug_queue_lock);
+#endif
     return PAL_STATUS_SUCCESS;
 }
+
+pal_usb_t* pal_usb_get_device(uint8_t index)
+{
+	if ((index < PAL_USB_MAX_DEVICES) && (PAL_USB_STATE_READY == pal_usb_devices[index].state))
+	{
+		return &pal_usb_devices[index];
+	}
+	return NULL;
+}
+
+void pal_usb_register_hotplug_handler(pal_usb_hotplug_handler_t handler, void* p_ctx)
+{
+	hotplug_handler = handler;
+	hotplug_handler_ctx = p_ctx;
+}
+
+pal_status_t pal_usb_handle_events(uint32_t timeout_ms)
+{
+	struct timeval timeout;
+
+	if (hotplug_registered)
+	{
+		timeout.tv_sec = (long)(timeout_ms / 1000);
+		timeout.tv_usec = (long)((timeout_ms % 1000) * 1000);
+		if (libusb_handle_events_timeout_completed(NULL, &timeout, NULL))
+		{
+			return PAL_STATUS_FAILURE;
+		}
+	}
+	else
+	{
+		// The delay takes at most 16 bits, longer timeouts are clamped
+		pal_os_timer_delay_in_milliseconds((timeout_ms > 0xFFFF) ? 0xFFFF : (uint16_t)timeout_ms);
+		pal_usb_rescan();
+	}
+	pal_usb_process_pending();
+	return PAL_STATUS_SUCCESS;
+}
+
+pal_status_t pal_usb_release_device(pal_usb_t* pal_usb)
+{
+	if ((pal_usb < &pal_usb_devices[0]) || (pal_usb >= &pal_usb_devices[PAL_USB_MAX_DEVICES]) ||
+		(PAL_USB_STATE_FREE == pal_usb->state))
+	{
+		return PAL_STATUS_FAILURE;
+	}
+
+	if ((NULL != pal_usb->handle) && (pal_usb->handle == usb_events.handle))
+	{
+		usb_events.handle = NULL;
+		usb_events.state = PAL_USB_STATE_REMOVED;
+	}
+	if (NULL != pal_usb->handle)
+	{
+#ifdef __WIN32__
+		libusb_release_interface(pal_usb->handle, 0);
+#endif
+		libusb_close(pal_usb->handle);
+	}
+	if (NULL != pal_usb->device)
+	{
+		libusb_unref_device(pal_usb->device);
+	}
+	memset(pal_usb, 0, sizeof(pal_usb_t));
+	return PAL_STATUS_SUCCESS;
+}
+
+/**
+* @}
+*/
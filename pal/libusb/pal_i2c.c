@@ -63,40 +63,31 @@
  * LOCAL DATA
  *********************************************************************************************************************/
 
-void i2c_master_end_of_transmit_callback(void);
-void i2c_master_end_of_receive_callback(void);
+void i2c_master_end_of_transmit_callback(pal_usb_t * pal_usb);
+void i2c_master_end_of_receive_callback(pal_usb_t * pal_usb);
 void invoke_upper_layer_callback(const pal_i2c_t * p_pal_i2c_ctx, host_lib_status_t event);
 static uint16_t usb_i2c_poll_operation_result(pal_i2c_t * p_i2c_context);
 
-/* Variable to indicate the re-entrant count of the i2c bus acquire function*/
-static volatile uint32_t g_entry_count = 0;
-/* Pointer to the current pal i2c context*/
-static pal_i2c_t * gp_pal_i2c_current_ctx;
-extern pal_usb_t usb_events;
-
 /**********************************************************************************************************************
  * LOCAL ROUTINES
  *********************************************************************************************************************/
-// I2C acquire bus function
-//lint --e{715} suppress the unused p_i2c_context variable lint error , since this is kept for future enhancements
-static pal_status_t pal_i2c_acquire(const void * p_i2c_context)
+// I2C acquire bus function, every dongle has its own bus
+static pal_status_t pal_i2c_acquire(const pal_i2c_t * p_i2c_context)
 {
-    if (g_entry_count == 0)
+    pal_usb_t * pal_usb = (pal_usb_t * ) p_i2c_context->p_i2c_hw_config;
+
+    if (pal_usb->i2c_busy == 0)
     {
-        g_entry_count++;
-        if (g_entry_count == 1)
-        {
-            return PAL_STATUS_SUCCESS;
-        }
+        pal_usb->i2c_busy = 1;
+        return PAL_STATUS_SUCCESS;
     }
     return PAL_STATUS_FAILURE;
 }
 
 // I2C release bus function
-//lint --e{715} suppress the unused p_i2c_context variable lint, since this is kept for future enhancements
-static void pal_i2c_release(const void * p_i2c_context)
+static void pal_i2c_release(const pal_i2c_t * p_i2c_context)
 {
-    g_entry_count = 0;
+    ((pal_usb_t * ) p_i2c_context->p_i2c_hw_config)->i2c_busy = 0;
 }
 /// @endcond
 
@@ -123,40 +114,40 @@ void invoke_upper_layer_callback (const pal_i2c_t * p_pal_i2c_ctx, host_lib_stat
     upper_layer_handler(p_pal_i2c_ctx->upper_layer_ctx, event);
 
     //Release I2C Bus
-    pal_i2c_release(p_pal_i2c_ctx->upper_layer_ctx);
+    pal_i2c_release(p_pal_i2c_ctx);
 }
 
 /// @cond hidden
 // I2C driver callback function when the transmit is completed successfully
-void i2c_master_end_of_transmit_callback(void)
+void i2c_master_end_of_transmit_callback(pal_usb_t * pal_usb)
 {
-    invoke_upper_layer_callback(gp_pal_i2c_current_ctx, PAL_I2C_EVENT_SUCCESS);
+    invoke_upper_layer_callback(pal_usb->p_current_i2c_ctx, PAL_I2C_EVENT_SUCCESS);
 }
 
 
 // I2C driver callback function when the receive is completed successfully
-void i2c_master_end_of_receive_callback(void)
+void i2c_master_end_of_receive_callback(pal_usb_t * pal_usb)
 {
-    invoke_upper_layer_callback(gp_pal_i2c_current_ctx, PAL_I2C_EVENT_SUCCESS);
+    invoke_upper_layer_callback(pal_usb->p_current_i2c_ctx, PAL_I2C_EVENT_SUCCESS);
 }
 
 // I2C error callback function
-void i2c_master_error_detected_callback(void)
+void i2c_master_error_detected_callback(pal_usb_t * pal_usb)
 {
-    invoke_upper_layer_callback(gp_pal_i2c_current_ctx, PAL_I2C_EVENT_ERROR);
+    invoke_upper_layer_callback(pal_usb->p_current_i2c_ctx, PAL_I2C_EVENT_ERROR);
 }
 
 
 // I2C driver callback function when the nack error detected
-void i2c_master_nack_received_callback(void)
+void i2c_master_nack_received_callback(pal_usb_t * pal_usb)
 {
-    i2c_master_error_detected_callback();
+    i2c_master_error_detected_callback(pal_usb);
 }
 
 // I2C driver callback function when the arbitration lost error detected
-void i2c_master_arbitration_lost_callback(void)
+void i2c_master_arbitration_lost_callback(pal_usb_t * pal_usb)
 {
-    i2c_master_error_detected_callback();
+    i2c_master_error_detected_callback(pal_usb);
 }
 
 
@@ -166,7 +157,7 @@ uint16_t usb_i2c_poll_operation_result(pal_i2c_t * p_i2c_context)
     LOG_PAL("usb_i2c_poll_operation_result\n. ");
     while (1)
     {
-        if (usb_hid_get_feature(REPORT_ID_I2C_STATUS, report, &usb_events) != 5)
+        if (usb_hid_get_feature(REPORT_ID_I2C_STATUS, report, (pal_usb_t * ) p_i2c_context->p_i2c_hw_config) != 5)
         {
             LOG_PAL("[IFX-HAL]: USB get I2C status failed.\n");
             return PAL_I2C_EVENT_ERROR;
@@ -299,11 +290,20 @@ pal_status_t pal_i2c_write(pal_i2c_t * p_i2c_context, uint8_t * p_data, uint16_t
     report[3] = (uint8_t)length;
 
     memcpy(&report[4], p_data, length);
-    //Acquire the I2C bus before read/write
 
+    if (PAL_USB_STATE_REMOVED == pal_usb->state)
+    {
+        //Dongle is detached, fail without touching the device
+        //lint --e{611} suppress "void* function pointer is type casted to app_event_handler_t type"
+        ((app_event_handler_t)(p_i2c_context->upper_layer_event_handler))
+                                                   (p_i2c_context->upper_layer_ctx, PAL_I2C_EVENT_ERROR);
+        return PAL_STATUS_FAILURE;
+    }
+
+    //Acquire the I2C bus before read/write
     if (PAL_STATUS_SUCCESS == pal_i2c_acquire(p_i2c_context))
     {
-        gp_pal_i2c_current_ctx = p_i2c_context;
+        pal_usb->p_current_i2c_ctx = p_i2c_context;
 
         //Invoke the low level i2c master driver API to write to the bus
         usb_lib_status = libusb_interrupt_transfer(pal_usb->handle,
@@ -319,18 +319,18 @@ pal_status_t pal_i2c_write(pal_i2c_t * p_i2c_context, uint8_t * p_data, uint16_t
             ((app_event_handler_t)(p_i2c_context->upper_layer_event_handler))
                                                        (p_i2c_context->upper_layer_ctx, PAL_I2C_EVENT_ERROR);
             //Release I2C Bus
-            pal_i2c_release((void * )p_i2c_context);
+            pal_i2c_release(p_i2c_context);
         }
         else
         {
             if (usb_i2c_poll_operation_result(p_i2c_context) == PAL_STATUS_SUCCESS)
             {
-                i2c_master_end_of_transmit_callback();
+                i2c_master_end_of_transmit_callback(pal_usb);
                 status = PAL_STATUS_SUCCESS;
             }
             else
             {
-                invoke_upper_layer_callback(gp_pal_i2c_current_ctx, PAL_I2C_EVENT_ERROR);
+                invoke_upper_layer_callback(pal_usb->p_current_i2c_ctx, PAL_I2C_EVENT_ERROR);
             }
         }
     }
@@ -391,10 +391,20 @@ pal_status_t pal_i2c_read(pal_i2c_t * p_i2c_context, uint8_t * p_data, uint16_t
     report[3] = (uint8_t)length;
     report[4] = 0;
     pal_usb = (pal_usb_t * ) p_i2c_context->p_i2c_hw_config;
+
+    if (PAL_USB_STATE_REMOVED == pal_usb->state)
+    {
+        //Dongle is detached, fail without touching the device
+        //lint --e{611} suppress "void* function pointer is type casted to app_event_handler_t type"
+        ((app_event_handler_t)(p_i2c_context->upper_layer_event_handler))
+                                                   (p_i2c_context->upper_layer_ctx, PAL_I2C_EVENT_ERROR);
+        return PAL_STATUS_FAILURE;
+    }
+
     //Acquire the I2C bus before read/write
     if (PAL_STATUS_SUCCESS == pal_i2c_acquire(p_i2c_context))
     {
-        gp_pal_i2c_current_ctx = p_i2c_context;
+        pal_usb->p_current_i2c_ctx = p_i2c_context;
         usb_lib_status = libusb_interrupt_transfer(pal_usb->handle,
                                                    pal_usb->hid_ep_out,
                                                    report,
@@ -408,6 +418,8 @@ pal_status_t pal_i2c_read(pal_i2c_t * p_i2c_context, uint8_t * p_data, uint16_t
             //lint --e{611} suppress "void* function pointer is type casted to app_event_handler_t type"
             ((app_event_handler_t)(p_i2c_context->upper_layer_event_handler))
                                                        (p_i2c_context->upper_layer_ctx, PAL_I2C_EVENT_ERROR);
+            //Release I2C Bus
+            pal_i2c_release(p_i2c_context);
             return usb_lib_status;
         }
         //Invoke the low level i2c master driver API to read from the bus
@@ -424,7 +436,7 @@ pal_status_t pal_i2c_read(pal_i2c_t * p_i2c_context, uint8_t * p_data, uint16_t
         {
             memcpy(p_data, &report[2], report[1]);
             usb_lib_status = PAL_STATUS_SUCCESS;
-            i2c_master_end_of_receive_callback();
+            i2c_master_end_of_receive_callback(pal_usb);
         }
         else
         {
@@ -432,7 +444,7 @@ pal_status_t pal_i2c_read(pal_i2c_t * p_i2c_context, uint8_t * p_data, uint16_t
             ((app_event_handler_t)(p_i2c_context->upper_layer_event_handler))
                                                         (p_i2c_context->upper_layer_ctx, PAL_I2C_EVENT_ERROR);
             //Release I2C Bus
-            pal_i2c_release((void * )p_i2c_context);
+            pal_i2c_release(p_i2c_context);
         }
     }
     else
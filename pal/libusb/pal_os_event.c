@@ -40,6 +40,8 @@
 #include "optiga/pal/pal.h"
 #include "optiga/pal/pal_os_timer.h"
 #include "optiga/pal/pal_os_event.h"
+#include "pal_usb.h"
+#include "pal_common.h"
 
 /**********************************************************************************************************************
  * MACROS
@@ -50,16 +52,7 @@
  * LOCAL DATA
  *********************************************************************************************************************/
 /// @cond hidden 
-/// Callback function when timer elapses
-static volatile register_callback callback_registered = NULL;
-/// Pointer to store upper layer callback context (For example: Ifx i2c context)
-static void * callback_ctx;
-/// User provided delay
-static uint32_t timer_delay_in_ms = 0;
-/// Timer required or not
-static volatile uint8_t time_required = 0;
-/// To maintain thread status
-static volatile uint8_t timer_stub_is_active = 0;
+extern pal_usb_t usb_events;
 
 pal_status_t pal_os_event_init(void)
 {
@@ -67,17 +60,23 @@ pal_status_t pal_os_event_init(void)
 	return PAL_STATUS_SUCCESS;
 }
 
-void pal_os_event_trigger_registered_callback(void)
+// Every dongle keeps the callback of its own ifx i2c stack, so the dongles are served independently
+void pal_usb_event_trigger_registered_callback(pal_usb_t * pal_usb)
 {
     register_callback callback;
-    if (callback_registered)
+    if (pal_usb->event_callback)
     {
-        callback = callback_registered;
-        callback_registered = NULL;
-        callback((void * )callback_ctx);
+        callback = pal_usb->event_callback;
+        pal_usb->event_callback = NULL;
+        callback(pal_usb->event_callback_ctx);
     }
 }
 
+void pal_os_event_trigger_registered_callback(void)
+{
+    pal_usb_event_trigger_registered_callback(&usb_events);
+}
+
 /// @endcond
 
 /**
@@ -93,15 +92,18 @@ void pal_os_event_trigger_registered_callback(void)
 * \param[in] callback_args         Callback arguments
 * \param[in] time_us               time in micro seconds to trigger the call back
 *
+* \note The callback arguments are always the ifx i2c context, the callback is kept on the dongle of that context.
+*       The delay is not applied, the USB round trip of the dongle is longer than the requested delays.
 */
+//lint --e{715} suppress "time_us is not used, see the note above"
 void pal_os_event_register_callback_oneshot(register_callback callback, 
                                             void * callback_args, 
                                             uint32_t time_us)
 {
-    callback_registered = callback;
-    callback_ctx = callback_args;
-    time_required = 1;
-    timer_delay_in_ms = (time_us / CONVERT_US_TO_MS);
+    pal_usb_t * pal_usb = (pal_usb_t * )((ifx_i2c_context_t * )callback_args)->p_pal_i2c_ctx->p_i2c_hw_config;
+
+    pal_usb->event_callback_ctx = callback_args;
+    pal_usb->event_callback = callback;
 }
 
 /**
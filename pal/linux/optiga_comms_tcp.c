@@ -0,0 +1,540 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file optiga_comms_tcp.c
+*
+* \brief   This file implements optiga comms abstraction layer over TCP to a remote OPTIGA bridge.
+*          It replaces optiga/comms/optiga_comms.c when the security chip is not attached locally.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+/**********************************************************************************************************************
+ * HEADER FILES
+ *********************************************************************************************************************/
+#include <string.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <stdio.h>
+
+#include "optiga/comms/optiga_comms.h"
+#include "optiga/ifx_i2c/ifx_i2c_config.h"
+#include "optiga/common/Util.h"
+#include "optiga_comms_tcp.h"
+
+/// @cond hidden
+/**********************************************************************************************************************
+ * MACROS
+ *********************************************************************************************************************/
+ /// Optiga comms is in use
+ #define OPTIGA_COMMS_INUSE     (0x01)
+ /// Optiga comms is free
+ #define OPTIGA_COMMS_FREE      (0x00)
+
+/**********************************************************************************************************************
+ * LOCAL ROUTINES
+ *********************************************************************************************************************/
+static host_lib_status_t check_optiga_comms_state(optiga_comms_t *p_ctx);
+static host_lib_status_t optiga_comms_tcp_connect(optiga_comms_tcp_context_t * p_tcp);
+static host_lib_status_t optiga_comms_tcp_submit(optiga_comms_t * p_ctx, uint8_t type,
+                                                 const uint8_t * p_data, uint16_t data_length,
+                                                 uint8_t * p_buffer, uint16_t * p_buffer_len);
+static void optiga_comms_tcp_complete(optiga_comms_tcp_context_t * p_tcp, uint16_t tag, host_lib_status_t event);
+static void * optiga_comms_tcp_receiver(void * p_arg);
+static int32_t optiga_comms_tcp_recv_all(int32_t socket, uint8_t * p_buffer, uint32_t length);
+
+/// @endcond
+/**********************************************************************************************************************
+ * API IMPLEMENTATION
+ *********************************************************************************************************************/
+
+/**
+ * Initializes the commmunication with the remote OPTIGA.<br>
+ *
+ *<b>API Details:</b>
+ * - Connects to the bridge, if this is the first instance using the #optiga_comms_tcp_context_t.<br>
+ * - All instances referring the same #optiga_comms_tcp_context_t share one connection.<br>
+ * - The OPTIGA itself is opened by the bridge.<br>
+ *<br>
+ *
+ *<b>User Input:</b><br>
+ * - The <b>comms_ctx</b> must be initialized with a valid #optiga_comms_tcp_context_t.<br>
+ *
+ * \param[in,out] p_ctx   Pointer to optiga comms context
+ *
+ * \retval  #OPTIGA_COMMS_SUCCESS
+ * \retval  #OPTIGA_COMMS_ERROR
+ */
+host_lib_status_t optiga_comms_open(optiga_comms_t *p_ctx)
+{
+    host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    optiga_comms_tcp_context_t * p_tcp;
+
+    if (OPTIGA_COMMS_SUCCESS == check_optiga_comms_state(p_ctx))
+    {
+        p_tcp = (optiga_comms_tcp_context_t *)p_ctx->comms_ctx;
+
+        pthread_mutex_lock(&p_tcp->mutex);
+        status = OPTIGA_COMMS_SUCCESS;
+        if (0 == p_tcp->open_count)
+        {
+            status = optiga_comms_tcp_connect(p_tcp);
+        }
+        else if (!p_tcp->connected)
+        {
+            //Connection is lost, all the instances have to be closed before reconnecting
+            status = OPTIGA_COMMS_ERROR;
+        }
+        if (OPTIGA_COMMS_SUCCESS == status)
+        {
+            p_tcp->open_count++;
+        }
+        pthread_mutex_unlock(&p_tcp->mutex);
+
+        p_ctx->state = OPTIGA_COMMS_FREE;
+        if ((OPTIGA_COMMS_SUCCESS == status) && (NULL != p_ctx->upper_layer_handler))
+        {
+            p_ctx->upper_layer_handler(p_ctx->upper_layer_ctx, OPTIGA_COMMS_SUCCESS);
+        }
+    }
+    return status;
+}
+
+/**
+ * Resets the remote OPTIGA.<br>
+ *
+ *<b>API Details:</b>
+ * - Requests the bridge to reset the OPTIGA. The reset is queued behind the APDUs already submitted.<br>
+ * - The <b>upper_layer_handler</b> is invoked when the bridge confirms the reset.<br>
+ *
+ * \param[in,out] p_ctx        Pointer to #optiga_comms_t
+ * \param[in,out] reset_type   type of reset
+ *
+ * \retval  #OPTIGA_COMMS_SUCCESS
+ * \retval  #OPTIGA_COMMS_ERROR
+ */
+host_lib_status_t optiga_comms_reset(optiga_comms_t *p_ctx,uint8_t reset_type)
+{
+    host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    if (OPTIGA_COMMS_SUCCESS == check_optiga_comms_state(p_ctx))
+    {
+        status = optiga_comms_tcp_submit(p_ctx, OPTIGA_COMMS_TCP_TYPE_RESET, &reset_type, 1, NULL, NULL);
+        if (OPTIGA_COMMS_SUCCESS != status)
+        {
+            p_ctx->state = OPTIGA_COMMS_FREE;
+        }
+    }
+    return status;
+}
+
+/**
+ * Sends a command to the remote OPTIGA and receives a response.<br>
+ *
+ *<b>API Details:</b>
+ * - Queues the APDU on the connection and returns. APDUs submitted by other instances while a send is
+ *   in progress are batched into the next send.<br>
+ * - Up to #OPTIGA_COMMS_TCP_MAX_PENDING APDUs can be outstanding per connection.<br>
+ * - The <b>upper_layer_handler</b> is invoked from the receiver thread when the response arrives.<br>
+ *
+ *<b>Notes:</b>
+ * - The actual number of bytes received is stored in p_buffer_len. In case of error, p_buffer_len is set to 0.<br>
+ * - If the size of p_buffer is insufficient to copy the response bytes then
+ *   #IFX_I2C_STACK_MEM_ERROR is notified.
+ *
+ * \param[in,out] p_ctx             Pointer to #optiga_comms_t
+ * \param[in]     p_data            Pointer to the write data buffer
+ * \param[in]     p_data_length     Pointer to the length of the write data buffer
+ * \param[in,out] p_buffer          Pointer to the receive data buffer
+ * \param[in,out] p_buffer_len      Pointer to the length of the receive data buffer
+ *
+ * \retval  #OPTIGA_COMMS_SUCCESS
+ * \retval  #OPTIGA_COMMS_ERROR
+ */
+host_lib_status_t optiga_comms_transceive(optiga_comms_t *p_ctx,const uint8_t* p_data,
+                                          const uint16_t* p_data_length,
+                                          uint8_t* p_buffer, uint16_t* p_buffer_len)
+{
+    host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    if (OPTIGA_COMMS_SUCCESS == check_optiga_comms_state(p_ctx))
+    {
+        if ((NULL != p_data) && (NULL != p_data_length) && (NULL != p_buffer) && (NULL != p_buffer_len) &&
+            (*p_data_length <= OPTIGA_COMMS_TCP_MAX_APDU_LENGTH))
+        {
+            status = optiga_comms_tcp_submit(p_ctx, OPTIGA_COMMS_TCP_TYPE_TRANSCEIVE, p_data, *p_data_length,
+                                             p_buffer, p_buffer_len);
+        }
+        if (OPTIGA_COMMS_SUCCESS != status)
+        {
+            p_ctx->state = OPTIGA_COMMS_FREE;
+        }
+    }
+    return status;
+}
+
+/**
+ * Closes the communication with the remote OPTIGA.<br>
+ *
+ *<b>API Details:</b>
+ * - Disconnects from the bridge, if this is the last instance using the connection.
+ *   Outstanding APDUs are completed with #OPTIGA_COMMS_ERROR.<br>
+ *
+ * \param[in,out] p_ctx             Pointer to #optiga_comms_t
+ *
+ * \retval  #OPTIGA_COMMS_SUCCESS
+ * \retval  #OPTIGA_COMMS_ERROR
+ */
+host_lib_status_t optiga_comms_close(optiga_comms_t *p_ctx)
+{
+    host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    optiga_comms_tcp_context_t * p_tcp;
+    uint8_t disconnect = FALSE;
+
+    if (OPTIGA_COMMS_SUCCESS == check_optiga_comms_state(p_ctx))
+    {
+        p_tcp = (optiga_comms_tcp_context_t *)p_ctx->comms_ctx;
+
+        pthread_mutex_lock(&p_tcp->mutex);
+        if (0 != p_tcp->open_count)
+        {
+            p_tcp->open_count--;
+            disconnect = (0 == p_tcp->open_count);
+            status = OPTIGA_COMMS_SUCCESS;
+        }
+        pthread_mutex_unlock(&p_tcp->mutex);
+
+        if (disconnect)
+        {
+            //Receiver thread fails the outstanding APDUs and exits
+            shutdown(p_tcp->socket, SHUT_RDWR);
+            pthread_join(p_tcp->receiver, NULL);
+            close(p_tcp->socket);
+            p_tcp->socket = -1;
+        }
+
+        p_ctx->state = OPTIGA_COMMS_FREE;
+        if ((OPTIGA_COMMS_SUCCESS == status) && (NULL != p_ctx->upper_layer_handler))
+        {
+            p_ctx->upper_layer_handler(p_ctx->upper_layer_ctx, OPTIGA_COMMS_SUCCESS);
+        }
+    }
+    return status;
+}
+
+/// @cond hidden
+static host_lib_status_t check_optiga_comms_state(optiga_comms_t *p_ctx)
+{
+    host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    if ((NULL != p_ctx) && (NULL != p_ctx->comms_ctx) && (p_ctx->state != OPTIGA_COMMS_INUSE))
+    {
+        p_ctx->state = OPTIGA_COMMS_INUSE;
+        status = OPTIGA_COMMS_SUCCESS;
+    }
+    return status;
+}
+
+//Must be called with the connection mutex held
+static host_lib_status_t optiga_comms_tcp_connect(optiga_comms_tcp_context_t * p_tcp)
+{
+    host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    struct addrinfo hints;
+    struct addrinfo * p_result = NULL;
+    struct addrinfo * p_addr;
+    char port[6];
+    int32_t socket_fd = -1;
+    int nodelay = 1;
+
+    do
+    {
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        snprintf(port, sizeof(port), "%u", p_tcp->port);
+
+        if (0 != getaddrinfo(p_tcp->host, port, &hints, &p_result))
+        {
+            break;
+        }
+
+        for (p_addr = p_result; NULL != p_addr; p_addr = p_addr->ai_next)
+        {
+            socket_fd = socket(p_addr->ai_family, p_addr->ai_socktype, p_addr->ai_protocol);
+            if (socket_fd < 0)
+            {
+                continue;
+            }
+            if (0 == connect(socket_fd, p_addr->ai_addr, p_addr->ai_addrlen))
+            {
+                break;
+            }
+            close(socket_fd);
+            socket_fd = -1;
+        }
+        freeaddrinfo(p_result);
+
+        if (socket_fd < 0)
+        {
+            break;
+        }
+
+        //Frames are batched by the sender, do not delay them further
+        setsockopt(socket_fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+        p_tcp->socket = socket_fd;
+        p_tcp->connected = TRUE;
+        p_tcp->batch_length = 0;
+        p_tcp->batch_index = 0;
+        p_tcp->flushing = FALSE;
+        memset(p_tcp->pending, 0, sizeof(p_tcp->pending));
+
+        if (0 != pthread_create(&p_tcp->receiver, NULL, optiga_comms_tcp_receiver, p_tcp))
+        {
+            close(socket_fd);
+            p_tcp->socket = -1;
+            p_tcp->connected = FALSE;
+            break;
+        }
+        status = OPTIGA_COMMS_SUCCESS;
+    } while (FALSE);
+
+    return status;
+}
+
+static host_lib_status_t optiga_comms_tcp_submit(optiga_comms_t * p_ctx, uint8_t type,
+                                                 const uint8_t * p_data, uint16_t data_length,
+                                                 uint8_t * p_buffer, uint16_t * p_buffer_len)
+{
+    host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    optiga_comms_tcp_context_t * p_tcp = (optiga_comms_tcp_context_t *)p_ctx->comms_ctx;
+    uint8_t * p_frame;
+    uint8_t * p_batch;
+    uint16_t batch_length;
+    uint16_t tag;
+    ssize_t sent;
+    uint16_t offset;
+
+    pthread_mutex_lock(&p_tcp->mutex);
+    do
+    {
+        if (!p_tcp->connected)
+        {
+            break;
+        }
+
+        for (tag = 0; tag < OPTIGA_COMMS_TCP_MAX_PENDING; tag++)
+        {
+            if (NULL == p_tcp->pending[tag].p_comms)
+            {
+                break;
+            }
+        }
+        if (OPTIGA_COMMS_TCP_MAX_PENDING == tag)
+        {
+            break;
+        }
+
+        p_tcp->pending[tag].p_comms = p_ctx;
+        p_tcp->pending[tag].p_buffer = p_buffer;
+        p_tcp->pending[tag].p_buffer_len = p_buffer_len;
+
+        //Every pending APDU has at most one frame in the batch, so the batch never overflows
+        p_frame = &p_tcp->batch[p_tcp->batch_index][p_tcp->batch_length];
+        Utility_SetUint16(&p_frame[0], tag);
+        p_frame[2] = type;
+        p_frame[3] = 0x00;
+        Utility_SetUint16(&p_frame[4], OPTIGA_COMMS_SUCCESS);
+        Utility_SetUint16(&p_frame[6], data_length);
+        memcpy(&p_frame[OPTIGA_COMMS_TCP_HEADER_LENGTH], p_data, data_length);
+        p_tcp->batch_length += OPTIGA_COMMS_TCP_HEADER_LENGTH + data_length;
+        status = OPTIGA_COMMS_SUCCESS;
+
+        //Another submitter is already sending, it picks this frame up with its next send
+        if (p_tcp->flushing)
+        {
+            break;
+        }
+
+        p_tcp->flushing = TRUE;
+        while (0 != p_tcp->batch_length)
+        {
+            p_batch = p_tcp->batch[p_tcp->batch_index];
+            batch_length = p_tcp->batch_length;
+            p_tcp->batch_index ^= 1;
+            p_tcp->batch_length = 0;
+
+            pthread_mutex_unlock(&p_tcp->mutex);
+            for (offset = 0; offset < batch_length; offset += (uint16_t)sent)
+            {
+                sent = send(p_tcp->socket, &p_batch[offset], batch_length - offset, MSG_NOSIGNAL);
+                if (sent <= 0)
+                {
+                    //Receiver thread fails all the outstanding APDUs
+                    shutdown(p_tcp->socket, SHUT_RDWR);
+                    break;
+                }
+            }
+            pthread_mutex_lock(&p_tcp->mutex);
+        }
+        p_tcp->flushing = FALSE;
+    } while (FALSE);
+    pthread_mutex_unlock(&p_tcp->mutex);
+
+    return status;
+}
+
+static void optiga_comms_tcp_complete(optiga_comms_tcp_context_t * p_tcp, uint16_t tag, host_lib_status_t event)
+{
+    optiga_comms_t * p_comms;
+
+    pthread_mutex_lock(&p_tcp->mutex);
+    p_comms = p_tcp->pending[tag].p_comms;
+    p_tcp->pending[tag].p_comms = NULL;
+    pthread_mutex_unlock(&p_tcp->mutex);
+
+    if (NULL != p_comms)
+    {
+        p_comms->state = OPTIGA_COMMS_FREE;
+        if (NULL != p_comms->upper_layer_handler)
+        {
+            p_comms->upper_layer_handler(p_comms->upper_layer_ctx, event);
+        }
+    }
+}
+
+static int32_t optiga_comms_tcp_recv_all(int32_t socket, uint8_t * p_buffer, uint32_t length)
+{
+    ssize_t received;
+    uint8_t discard[64];
+
+    while (0 != length)
+    {
+        //A NULL buffer drops the data
+        if (NULL == p_buffer)
+        {
+            received = recv(socket, discard, (length < sizeof(discard)) ? length : sizeof(discard), 0);
+        }
+        else
+        {
+            received = recv(socket, p_buffer, length, 0);
+        }
+        if (received <= 0)
+        {
+            return -1;
+        }
+        if (NULL != p_buffer)
+        {
+            p_buffer += received;
+        }
+        length -= (uint32_t)received;
+    }
+    return 0;
+}
+
+static void * optiga_comms_tcp_receiver(void * p_arg)
+{
+    optiga_comms_tcp_context_t * p_tcp = (optiga_comms_tcp_context_t *)p_arg;
+    optiga_comms_tcp_pending_t pending;
+    uint8_t header[OPTIGA_COMMS_TCP_HEADER_LENGTH];
+    host_lib_status_t event;
+    uint16_t tag;
+    uint16_t length;
+
+    for (;;)
+    {
+        if (0 != optiga_comms_tcp_recv_all(p_tcp->socket, header, sizeof(header)))
+        {
+            break;
+        }
+        tag = Utility_GetUint16(&header[0]);
+        event = Utility_GetUint16(&header[4]);
+        length = Utility_GetUint16(&header[6]);
+
+        //The bridge never sends more than an APDU, anything else means the stream is out of sync
+        if (length > OPTIGA_COMMS_TCP_MAX_APDU_LENGTH)
+        {
+            break;
+        }
+
+        pending.p_comms = NULL;
+        pthread_mutex_lock(&p_tcp->mutex);
+        if (tag < OPTIGA_COMMS_TCP_MAX_PENDING)
+        {
+            pending = p_tcp->pending[tag];
+        }
+        pthread_mutex_unlock(&p_tcp->mutex);
+
+        //Response to an unknown tag is dropped
+        if ((NULL == pending.p_comms) || (NULL == pending.p_buffer))
+        {
+            if (0 != optiga_comms_tcp_recv_all(p_tcp->socket, NULL, length))
+            {
+                break;
+            }
+        }
+        else if (length > *pending.p_buffer_len)
+        {
+            if (0 != optiga_comms_tcp_recv_all(p_tcp->socket, NULL, length))
+            {
+                break;
+            }
+            *pending.p_buffer_len = 0;
+            event = IFX_I2C_STACK_MEM_ERROR;
+        }
+        else
+        {
+            if (0 != optiga_comms_tcp_recv_all(p_tcp->socket, pending.p_buffer, length))
+            {
+                break;
+            }
+            *pending.p_buffer_len = length;
+        }
+
+        if (NULL != pending.p_comms)
+        {
+            optiga_comms_tcp_complete(p_tcp, tag, event);
+        }
+    }
+
+    //Connection is lost or closed, nothing outstanding will be answered
+    pthread_mutex_lock(&p_tcp->mutex);
+    p_tcp->connected = FALSE;
+    pthread_mutex_unlock(&p_tcp->mutex);
+    for (tag = 0; tag < OPTIGA_COMMS_TCP_MAX_PENDING; tag++)
+    {
+        optiga_comms_tcp_complete(p_tcp, tag, OPTIGA_COMMS_ERROR);
+    }
+    return NULL;
+}
+
+/// @endcond
+/**
+* @}
+*/
@@ -0,0 +1,105 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file optiga_comms_tcp.h
+*
+* \brief   This file provides the prototype declarations of the optiga comms over TCP backend and bridge.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#ifndef _OPTIGA_COMMS_TCP_H_
+#define _OPTIGA_COMMS_TCP_H_
+
+#include <pthread.h>
+#include "optiga/comms/optiga_comms.h"
+
+/// Default TCP port of the bridge
+#define OPTIGA_COMMS_TCP_DEFAULT_PORT           (9731)
+/// Maximum number of APDUs outstanding on one connection
+#define OPTIGA_COMMS_TCP_MAX_PENDING            (8)
+/// Maximum APDU length carried in a frame
+#define OPTIGA_COMMS_TCP_MAX_APDU_LENGTH        (1600)
+/// Frame header length [tag(2) type(1) rfu(1) status(2) length(2)]
+#define OPTIGA_COMMS_TCP_HEADER_LENGTH          (8)
+/// Size of a batch of frames written with a single send
+#define OPTIGA_COMMS_TCP_BATCH_SIZE             (OPTIGA_COMMS_TCP_MAX_PENDING * (OPTIGA_COMMS_TCP_HEADER_LENGTH + OPTIGA_COMMS_TCP_MAX_APDU_LENGTH))
+
+/// Frame carries an APDU for #optiga_comms_transceive
+#define OPTIGA_COMMS_TCP_TYPE_TRANSCEIVE        (0x01)
+/// Frame requests #optiga_comms_reset, payload is the reset type
+#define OPTIGA_COMMS_TCP_TYPE_RESET             (0x02)
+
+/** @brief APDU waiting for its response */
+typedef struct optiga_comms_tcp_pending
+{
+    /// Comms instance which submitted the APDU, NULL if the slot is free
+    optiga_comms_t * p_comms;
+    /// Receive buffer of the caller
+    uint8_t * p_buffer;
+    /// Length of the receive buffer, updated with the response length
+    uint16_t * p_buffer_len;
+} optiga_comms_tcp_pending_t;
+
+/** @brief Connection to a bridge, to be referred by optiga_comms_t.comms_ctx */
+typedef struct optiga_comms_tcp_context
+{
+    /// Host name or address of the bridge
+    const char * host;
+    /// TCP port of the bridge
+    uint16_t port;
+
+    /// @cond hidden
+    int32_t socket;
+    uint8_t open_count;
+    uint8_t connected;
+    pthread_mutex_t mutex;
+    pthread_t receiver;
+    optiga_comms_tcp_pending_t pending[OPTIGA_COMMS_TCP_MAX_PENDING];
+    uint8_t batch[2][OPTIGA_COMMS_TCP_BATCH_SIZE];
+    uint16_t batch_length;
+    uint8_t batch_index;
+    uint8_t flushing;
+    /// @endcond
+} optiga_comms_tcp_context_t;
+
+/// Initializer for #optiga_comms_tcp_context_t, the fields not named start zeroed
+#define OPTIGA_COMMS_TCP_CONTEXT(p_host, tcp_port)  {.host = (p_host), .port = (tcp_port), .socket = -1, \
+                                                    .mutex = PTHREAD_MUTEX_INITIALIZER}
+
+/**
+ * \brief   Serves the local OPTIGA to optiga comms over TCP clients.
+ */
+host_lib_status_t optiga_comms_tcp_bridge_run(optiga_comms_t * p_comms, uint16_t port);
+
+#endif /* _OPTIGA_COMMS_TCP_H_ */
+
+/**
+* @}
+*/
@@ -0,0 +1,348 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file optiga_comms_tcp_bridge.c
+*
+* \brief   This file implements the bridge which serves a locally attached OPTIGA to optiga comms over TCP clients.
+*          It is linked with the regular optiga comms (ifx i2c) stack and the Linux PAL.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <stdio.h>
+
+#include "optiga/comms/optiga_comms.h"
+#include "optiga/common/Util.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga/pal/pal_os_event.h"
+#include "optiga_comms_tcp.h"
+
+#if IFX_I2C_LOG_PAL == 1
+#define LOG(...)  printf(__VA_ARGS__)
+#else
+#define LOG(...)
+#endif
+
+#define LOG_PREFIX "[IFX-PAL-TCP-BRIDGE] "
+
+/// @cond hidden
+/// Maximum number of clients connected to the bridge
+#define OPTIGA_COMMS_TCP_BRIDGE_MAX_CLIENTS     (8)
+
+/** @brief Client connected to the bridge */
+typedef struct optiga_comms_tcp_bridge_client
+{
+    /// Socket of the client, -1 if unused
+    int32_t socket;
+    /// Received frames which are not yet executed
+    uint8_t rx[OPTIGA_COMMS_TCP_BATCH_SIZE];
+    /// Length of received data
+    uint16_t rx_length;
+    /// Responses to be sent with a single send
+    uint8_t tx[OPTIGA_COMMS_TCP_BATCH_SIZE];
+    /// Length of responses
+    uint16_t tx_length;
+} optiga_comms_tcp_bridge_client_t;
+
+static optiga_comms_tcp_bridge_client_t bridge_clients[OPTIGA_COMMS_TCP_BRIDGE_MAX_CLIENTS];
+static volatile host_lib_status_t bridge_comms_status;
+static uint8_t bridge_response[OPTIGA_COMMS_TCP_MAX_APDU_LENGTH];
+
+static void optiga_comms_tcp_bridge_event_handler(void * upper_layer_ctx, host_lib_status_t event)
+{
+    bridge_comms_status = event;
+}
+
+static host_lib_status_t optiga_comms_tcp_bridge_wait(host_lib_status_t status)
+{
+    if (OPTIGA_COMMS_SUCCESS == status)
+    {
+        while (OPTIGA_COMMS_BUSY == bridge_comms_status)
+        {
+#ifdef PAL_OS_HAS_EVENT_PROCESS
+            pal_os_event_process();
+#else
+            pal_os_timer_delay_in_milliseconds(1);
+#endif
+        }
+        status = bridge_comms_status;
+    }
+    return status;
+}
+
+static void optiga_comms_tcp_bridge_drop(optiga_comms_tcp_bridge_client_t * p_client)
+{
+    LOG(LOG_PREFIX "client %d disconnected\n", p_client->socket);
+    close(p_client->socket);
+    p_client->socket = -1;
+    p_client->rx_length = 0;
+    p_client->tx_length = 0;
+}
+
+static void optiga_comms_tcp_bridge_flush(optiga_comms_tcp_bridge_client_t * p_client)
+{
+    uint16_t offset;
+    ssize_t sent = 0;
+
+    for (offset = 0; offset < p_client->tx_length; offset += (uint16_t)sent)
+    {
+        sent = send(p_client->socket, &p_client->tx[offset], p_client->tx_length - offset, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+            optiga_comms_tcp_bridge_drop(p_client);
+            return;
+        }
+    }
+    p_client->tx_length = 0;
+}
+
+//Returns FALSE if the header at the start of the receive buffer announces a frame which can never fit the buffer
+static uint8_t optiga_comms_tcp_bridge_frame_valid(const optiga_comms_tcp_bridge_client_t * p_client)
+{
+    return (uint8_t)((p_client->rx_length < OPTIGA_COMMS_TCP_HEADER_LENGTH) ||
+                     (Utility_GetUint16(&p_client->rx[6]) <= OPTIGA_COMMS_TCP_MAX_APDU_LENGTH));
+}
+
+//Returns the length of the first complete frame in the receive buffer, 0 if there is none
+static uint16_t optiga_comms_tcp_bridge_frame_length(const optiga_comms_tcp_bridge_client_t * p_client)
+{
+    uint16_t length;
+
+    if (p_client->rx_length < OPTIGA_COMMS_TCP_HEADER_LENGTH)
+    {
+        return 0;
+    }
+    length = OPTIGA_COMMS_TCP_HEADER_LENGTH + Utility_GetUint16(&p_client->rx[6]);
+    return (p_client->rx_length < length) ? 0 : length;
+}
+
+static void optiga_comms_tcp_bridge_execute(optiga_comms_t * p_comms, optiga_comms_tcp_bridge_client_t * p_client)
+{
+    host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    uint8_t * p_frame = p_client->rx;
+    uint16_t frame_length = optiga_comms_tcp_bridge_frame_length(p_client);
+    uint16_t apdu_length = Utility_GetUint16(&p_frame[6]);
+    uint16_t response_length = 0;
+
+    bridge_comms_status = OPTIGA_COMMS_BUSY;
+    if (OPTIGA_COMMS_TCP_TYPE_TRANSCEIVE == p_frame[2])
+    {
+        response_length = sizeof(bridge_response);
+        status = optiga_comms_tcp_bridge_wait(optiga_comms_transceive(p_comms, &p_frame[OPTIGA_COMMS_TCP_HEADER_LENGTH],
+                                                                      &apdu_length, bridge_response, &response_length));
+    }
+    else if ((OPTIGA_COMMS_TCP_TYPE_RESET == p_frame[2]) && (1 == apdu_length))
+    {
+        status = optiga_comms_tcp_bridge_wait(optiga_comms_reset(p_comms, p_frame[OPTIGA_COMMS_TCP_HEADER_LENGTH]));
+    }
+    if (OPTIGA_COMMS_SUCCESS != status)
+    {
+        response_length = 0;
+    }
+
+    //Response header reuses the tag and type of the request
+    memcpy(&p_client->tx[p_client->tx_length], p_frame, 4);
+    Utility_SetUint16(&p_client->tx[p_client->tx_length + 4], status);
+    Utility_SetUint16(&p_client->tx[p_client->tx_length + 6], response_length);
+    memcpy(&p_client->tx[p_client->tx_length + OPTIGA_COMMS_TCP_HEADER_LENGTH], bridge_response, response_length);
+    p_client->tx_length += OPTIGA_COMMS_TCP_HEADER_LENGTH + response_length;
+
+    memmove(p_client->rx, &p_client->rx[frame_length], p_client->rx_length - frame_length);
+    p_client->rx_length -= frame_length;
+}
+/// @endcond
+
+/**
+ * Serves the local OPTIGA to optiga comms over TCP clients.<br>
+ *
+ *<b>API Details:</b>
+ * - Opens the OPTIGA using p_comms and listens for clients on the given port.<br>
+ * - The APDUs of all the clients are executed one at a time, in a round robin manner between the clients.<br>
+ * - Clients pipeline their APDUs, the frames already received are executed back to back and their responses
+ *   are sent with a single send, once the client has no further complete frame pending.<br>
+ * - p_comms can be backed by any optiga comms implementation (e.g. a simulator) which completes through
+ *   the <b>upper_layer_handler</b>.<br>
+ *
+ * \param[in,out] p_comms     Pointer to #optiga_comms_t of the local OPTIGA
+ * \param[in]     port        TCP port to listen on
+ *
+ * \retval  #OPTIGA_COMMS_ERROR  Returns only if the OPTIGA or the listening socket cannot be opened
+ */
+host_lib_status_t optiga_comms_tcp_bridge_run(optiga_comms_t * p_comms, uint16_t port)
+{
+    host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    struct pollfd poll_fds[OPTIGA_COMMS_TCP_BRIDGE_MAX_CLIENTS + 1];
+    struct sockaddr_in address;
+    optiga_comms_tcp_bridge_client_t * p_client;
+    int32_t listener = -1;
+    int32_t socket_fd;
+    int option = 1;
+    uint8_t executed;
+    uint8_t index;
+    ssize_t received;
+
+    do
+    {
+        p_comms->upper_layer_handler = optiga_comms_tcp_bridge_event_handler;
+        bridge_comms_status = OPTIGA_COMMS_BUSY;
+        if (OPTIGA_COMMS_SUCCESS != optiga_comms_tcp_bridge_wait(optiga_comms_open(p_comms)))
+        {
+            break;
+        }
+
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener < 0)
+        {
+            break;
+        }
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        if ((0 != bind(listener, (struct sockaddr *)&address, sizeof(address))) || (0 != listen(listener, 4)))
+        {
+            break;
+        }
+
+        for (index = 0; index < OPTIGA_COMMS_TCP_BRIDGE_MAX_CLIENTS; index++)
+        {
+            bridge_clients[index].socket = -1;
+        }
+        LOG(LOG_PREFIX "listening on port %u\n", port);
+
+        for (;;)
+        {
+            poll_fds[0].fd = listener;
+            poll_fds[0].events = POLLIN;
+            for (index = 0; index < OPTIGA_COMMS_TCP_BRIDGE_MAX_CLIENTS; index++)
+            {
+                poll_fds[index + 1].fd = bridge_clients[index].socket;
+                poll_fds[index + 1].events = POLLIN;
+                poll_fds[index + 1].revents = 0;
+            }
+            if (poll(poll_fds, OPTIGA_COMMS_TCP_BRIDGE_MAX_CLIENTS + 1, -1) < 0)
+            {
+                continue;
+            }
+
+            if (poll_fds[0].revents & POLLIN)
+            {
+                socket_fd = accept(listener, NULL, NULL);
+                for (index = 0; (socket_fd >= 0) && (index < OPTIGA_COMMS_TCP_BRIDGE_MAX_CLIENTS); index++)
+                {
+                    if (bridge_clients[index].socket < 0)
+                    {
+                        setsockopt(socket_fd, IPPROTO_TCP, TCP_NODELAY, &option, sizeof(option));
+                        bridge_clients[index].socket = socket_fd;
+                        bridge_clients[index].rx_length = 0;
+                        bridge_clients[index].tx_length = 0;
+                        socket_fd = -1;
+                    }
+                }
+                if (socket_fd >= 0)
+                {
+                    close(socket_fd);
+                }
+            }
+
+            for (index = 0; index < OPTIGA_COMMS_TCP_BRIDGE_MAX_CLIENTS; index++)
+            {
+                p_client = &bridge_clients[index];
+                if ((p_client->socket < 0) || !(poll_fds[index + 1].revents & (POLLIN | POLLHUP | POLLERR)))
+                {
+                    continue;
+                }
+                received = recv(p_client->socket, &p_client->rx[p_client->rx_length],
+                                sizeof(p_client->rx) - p_client->rx_length, 0);
+                if (received <= 0)
+                {
+                    optiga_comms_tcp_bridge_drop(p_client);
+                    continue;
+                }
+                p_client->rx_length += (uint16_t)received;
+
+                //A frame which can never fit the receive buffer is a protocol violation
+                if (!optiga_comms_tcp_bridge_frame_valid(p_client))
+                {
+                    optiga_comms_tcp_bridge_drop(p_client);
+                }
+            }
+
+            //Execute one frame per client and round, so that clients with deep pipelines do not starve others
+            do
+            {
+                executed = FALSE;
+                for (index = 0; index < OPTIGA_COMMS_TCP_BRIDGE_MAX_CLIENTS; index++)
+                {
+                    p_client = &bridge_clients[index];
+                    if ((p_client->socket < 0) || (0 == optiga_comms_tcp_bridge_frame_length(p_client)))
+                    {
+                        continue;
+                    }
+                    optiga_comms_tcp_bridge_execute(p_comms, p_client);
+                    executed = TRUE;
+
+                    //Every frame following the executed one is checked before it is used
+                    if (!optiga_comms_tcp_bridge_frame_valid(p_client))
+                    {
+                        optiga_comms_tcp_bridge_flush(p_client);
+                        if (p_client->socket >= 0)
+                        {
+                            optiga_comms_tcp_bridge_drop(p_client);
+                        }
+                    }
+                    else if ((0 == optiga_comms_tcp_bridge_frame_length(p_client)) ||
+                             ((sizeof(p_client->tx) - p_client->tx_length) <
+                              (OPTIGA_COMMS_TCP_HEADER_LENGTH + OPTIGA_COMMS_TCP_MAX_APDU_LENGTH)))
+                    {
+                        optiga_comms_tcp_bridge_flush(p_client);
+                    }
+                }
+            } while (executed);
+        }
+    } while (FALSE);
+
+    if (listener >= 0)
+    {
+        close(listener);
+    }
+    return status;
+}
+
+/**
+* @}
+*/
@@ -0,0 +1,223 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file pal_i2c_uring.c
+*
+* \brief   This file implements the platform abstraction layer(pal) APIs for I2C on top of io_uring.
+*          It replaces pal_i2c.c: transfers are submitted to the shared ring and completed from the ring thread,
+*          so one thread serves all buses. Without io_uring support the transfers are done blocking.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <linux/i2c-dev.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "optiga/pal/pal_i2c.h"
+#include "pal_linux.h"
+
+#if IFX_I2C_LOG_HAL == 1
+#define LOG_HAL IFX_I2C_LOG
+#else
+#include<stdio.h>
+#define LOG_HAL(...) //printf(__VA_ARGS__)
+#endif
+
+/// I2C device
+extern char * i2c_if;
+
+/// @cond hidden
+
+/* io_uring is available, otherwise transfers are blocking */
+static uint8_t uring_available = false;
+
+static void invoke_upper_layer_callback(const pal_i2c_t * p_pal_i2c_ctx, optiga_lib_status_t event)
+{
+    app_event_handler_t upper_layer_handler;
+    //lint --e{611} suppress "void* function pointer is type casted to app_event_handler_t  type"
+    upper_layer_handler = (app_event_handler_t)p_pal_i2c_ctx->upper_layer_event_handler;
+
+    upper_layer_handler(p_pal_i2c_ctx->upper_layer_ctx, event);
+}
+
+// Acquires the bus of the context, every bus is used independently
+static pal_status_t pal_i2c_acquire(const pal_i2c_t * p_i2c_context)
+{
+    pal_linux_t * pal_linux = (pal_linux_t *)p_i2c_context->p_i2c_hw_config;
+
+    return (0 == __atomic_exchange_n(&pal_linux->busy, 1, __ATOMIC_ACQUIRE)) ? PAL_STATUS_SUCCESS : PAL_STATUS_FAILURE;
+}
+
+static void pal_i2c_release(const pal_i2c_t * p_i2c_context)
+{
+    pal_linux_t * pal_linux = (pal_linux_t *)p_i2c_context->p_i2c_hw_config;
+
+    __atomic_store_n(&pal_linux->busy, 0, __ATOMIC_RELEASE);
+}
+
+// Completion of a transfer, invoked from the ring thread
+static void pal_i2c_transfer_completed(void * p_ctx, int32_t result)
+{
+    pal_i2c_t * p_i2c_context = (pal_i2c_t *)p_ctx;
+    pal_linux_t * pal_linux = (pal_linux_t *)p_i2c_context->p_i2c_hw_config;
+
+    LOG_HAL("[IFX-HAL]: I2C transfer completed %d\n", result);
+    //Release the bus first, the upper layer may start the next transfer from its handler
+    pal_i2c_release(p_i2c_context);
+    invoke_upper_layer_callback(p_i2c_context, (result == (int32_t)pal_linux->length) ?
+                                               PAL_I2C_EVENT_SUCCESS : PAL_I2C_EVENT_ERROR);
+}
+
+static pal_status_t pal_i2c_transfer(pal_i2c_t * p_i2c_context, uint8_t * p_data, uint16_t length, uint8_t is_write)
+{
+    pal_status_t status = PAL_STATUS_FAILURE;
+    pal_linux_t * pal_linux = (pal_linux_t *)p_i2c_context->p_i2c_hw_config;
+    int32_t result;
+
+    do
+    {
+        if (PAL_STATUS_SUCCESS != pal_i2c_acquire(p_i2c_context))
+        {
+            status = PAL_STATUS_I2C_BUSY;
+            invoke_upper_layer_callback(p_i2c_context, PAL_I2C_EVENT_BUSY);
+            break;
+        }
+
+        pal_linux->length = length;
+        if (true == uring_available)
+        {
+            pal_linux->request.handler = pal_i2c_transfer_completed;
+            pal_linux->request.p_ctx = p_i2c_context;
+            status = (is_write) ?
+                     pal_linux_uring_write(&pal_linux->request, pal_linux->i2c_handle, p_data, length) :
+                     pal_linux_uring_read(&pal_linux->request, pal_linux->i2c_handle, p_data, length);
+            if (PAL_STATUS_SUCCESS == status)
+            {
+                break;
+            }
+            // The ring failed, this and the following transfers are blocking
+            LOG_HAL("[IFX-HAL]: io_uring failed, blocking transfers\n");
+            uring_available = false;
+        }
+
+        result = (is_write) ? write(pal_linux->i2c_handle, p_data, length) : read(pal_linux->i2c_handle, p_data, length);
+        status = (0 > result) ? PAL_STATUS_FAILURE : PAL_STATUS_SUCCESS;
+        pal_i2c_transfer_completed(p_i2c_context, result);
+    } while (0);
+
+    return status;
+}
+/// @endcond
+
+pal_status_t pal_i2c_init(const pal_i2c_t* p_i2c_context)
+{
+	int32_t ret = PAL_I2C_EVENT_ERROR;
+	pal_linux_t *pal_linux;
+	do
+	{
+		pal_linux = (pal_linux_t*) p_i2c_context->p_i2c_hw_config;
+		pal_linux->i2c_handle = open(i2c_if, O_RDWR);
+		pal_linux->busy = 0;
+		if (pal_linux->i2c_handle < 0)
+		{
+			LOG_HAL("open of %s returned an error = %d\n", i2c_if, errno);
+			ret = PAL_STATUS_FAILURE;
+			break;
+		}
+
+		// Assign the slave address
+		ret = ioctl(pal_linux->i2c_handle, I2C_SLAVE, p_i2c_context->slave_address);
+		if(PAL_STATUS_SUCCESS != ret)
+		{
+			LOG_HAL("ioctl returned an error = %d\n", errno);
+			ret = PAL_STATUS_FAILURE;
+			break;
+		}
+
+		uring_available = (PAL_STATUS_SUCCESS == pal_linux_uring_init()) ? true : false;
+		LOG_HAL("[IFX-HAL]: io_uring %s\n", uring_available ? "used" : "not supported, blocking transfers");
+	}while(0);
+    return ret;
+}
+
+
+pal_status_t pal_i2c_deinit(const pal_i2c_t* p_i2c_context)
+{
+	LOG_HAL("pal_i2c_deinit\n. ");
+	
+    return PAL_STATUS_SUCCESS;
+}
+
+
+pal_status_t pal_i2c_write(pal_i2c_t* p_i2c_context,uint8_t* p_data , uint16_t length)
+{
+	LOG_HAL("[IFX-HAL]: I2C TX (%d)\n", length);
+	return pal_i2c_transfer(p_i2c_context, p_data, length, true);
+}
+
+
+pal_status_t pal_i2c_read(pal_i2c_t* p_i2c_context , uint8_t* p_data , uint16_t length)
+{
+	LOG_HAL("[IFX-HAL]: I2C RX (%d)\n", length);
+	return pal_i2c_transfer(p_i2c_context, p_data, length, false);
+}
+
+
+pal_status_t pal_i2c_set_bitrate(const pal_i2c_t* p_i2c_context , uint16_t bitrate)
+{
+    pal_status_t return_status = PAL_STATUS_FAILURE;
+    optiga_lib_status_t event = PAL_I2C_EVENT_ERROR;
+	LOG_HAL("pal_i2c_set_bitrate\n. ");
+    //Acquire the I2C bus before setting the bitrate
+    if (PAL_STATUS_SUCCESS == pal_i2c_acquire(p_i2c_context))
+    {    
+        // The bitrate of i2c-dev is configured by the kernel, the request is accepted
+        return_status = PAL_STATUS_SUCCESS;
+        event = PAL_I2C_EVENT_SUCCESS;
+        pal_i2c_release(p_i2c_context);
+    }
+    else
+    {
+        return_status = PAL_STATUS_I2C_BUSY;
+        event = PAL_I2C_EVENT_BUSY;
+    }
+    if (0 != p_i2c_context->upper_layer_event_handler)
+    {
+        //lint --e{611} suppress "void* function pointer is type casted to app_event_handler_t  type"
+        ((app_event_handler_t)(p_i2c_context->upper_layer_event_handler))(p_i2c_context->upper_layer_ctx  , event);
+    }
+    return return_status;
+}
+
+/**
+* @}
+*/
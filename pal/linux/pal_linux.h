@@ -46,6 +46,24 @@
 #define LOW 0
 typedef uint16_t gpio_pin_t;
 
+/// Number of submission queue entries of the io_uring
+#define PAL_LINUX_URING_ENTRIES 64
+
+/** @brief Completion handler of an io_uring request, result is the number of bytes transferred or -errno, also
+ *         the error of io_uring_enter if the ring fails */
+typedef void (*pal_linux_uring_handler_t)(void * p_ctx, int32_t result);
+
+/** @brief io_uring request, must stay valid till it completes */
+typedef struct pal_linux_uring_request
+{
+    /// Handler invoked in the ring thread on completion
+    pal_linux_uring_handler_t handler;
+    /// Context passed to the handler
+    void * p_ctx;
+    /// Relative time of a timeout request, layout of struct __kernel_timespec
+    int64_t timeout[2];
+} pal_linux_uring_request_t;
+
 /** @brief PAL I2C context structure */
 typedef struct pal_linux
 {
@@ -53,6 +71,12 @@ typedef struct pal_linux
     int32_t i2c_handle;
     /// Pointer to store the callers handler
     void * upper_layer_event_handler;
+    /// io_uring request of the transfer in progress (io_uring backend)
+    pal_linux_uring_request_t request;
+    /// Length of the transfer in progress (io_uring backend)
+    uint16_t length;
+    /// Bus is acquired by a transfer (io_uring backend)
+    uint8_t busy;
 } pal_linux_t;
 
 typedef struct pal_linux_gpio {
@@ -60,4 +84,109 @@ typedef struct pal_linux_gpio {
     int fd;
 } pal_linux_gpio_t;
 
+/** @brief Real-time mode of the event thread */
+typedef struct pal_linux_realtime_config
+{
+    /// SCHED_FIFO priority of the event thread
+    int32_t priority;
+    /// CPU the event thread is pinned to, -1 to keep the default affinity
+    int32_t cpu;
+    /// Deadlines closer than this are met by spinning instead of sleeping
+    uint32_t spin_threshold_us;
+    /// Lock the process memory (mlockall) to avoid page faults
+    uint8_t lock_memory;
+} pal_linux_realtime_config_t;
+
+/** @brief Measured overshoot of the event timer */
+typedef struct pal_linux_event_metrics
+{
+    /// Number of timer events fired
+    uint32_t event_count;
+    /// Last overshoot over the deadline in microseconds
+    uint32_t last_overshoot_us;
+    /// Maximum overshoot in microseconds
+    uint32_t max_overshoot_us;
+    /// Sum of the overshoots in microseconds, for the average
+    uint64_t total_overshoot_us;
+} pal_linux_event_metrics_t;
+
+/**
+ * @brief Creates the timer of the event thread. The Linux PAL provides it in every build, pal_os_event.h declares it
+ *        only with PAL_OS_HAS_EVENT_INIT.
+ */
+pal_status_t pal_os_event_init(void);
+
+/**
+ * @brief Enables the real-time mode of the event thread, to be called before pal_os_event_init.
+ */
+pal_status_t pal_linux_event_set_realtime(const pal_linux_realtime_config_t * p_config);
+
+/**
+ * @brief Returns the measured timer overshoot and resets it.
+ */
+void pal_linux_event_get_metrics(pal_linux_event_metrics_t * p_metrics);
+
+/** @brief Handler of a file descriptor watched by the pollable mode, events are the epoll events */
+typedef void (*pal_linux_fd_handler_t)(void * p_ctx, int32_t fd, uint32_t events);
+
+/// Maximum number of file descriptors watched in the pollable mode
+#define PAL_LINUX_EVENT_MAX_WATCHES 8
+
+/**
+ * @brief Enables the pollable mode of the event handling, to be called before pal_os_event_init.
+ *
+ * No signal and no thread is used. The library work (timer expiry and the watched file descriptors) is
+ * signalled by one file descriptor, see #pal_linux_event_get_fd, and is run by #pal_linux_event_process
+ * from the thread of the application's event loop (epoll, libuv, asio, ...).
+ *
+ * Only the comms layer is non-blocking in this mode: optiga_comms_open() and optiga_comms_transceive() return
+ * right away and the upper layer handler of the comms context is called from #pal_linux_event_process once the
+ * response is received. The I2C transfers of this PAL are synchronous, the stack progresses on the timer events only.
+ * optiga_util, optiga_crypt, the command library and OCP remain blocking calls: they wait in a loop that serves
+ * only the timer with pal_os_event_process(), if the library is built with PAL_OS_HAS_EVENT_PROCESS, and must not
+ * be called from the event loop while a comms operation of the application is pending.
+ */
+pal_status_t pal_linux_event_set_pollable(void);
+
+/**
+ * @brief Returns the file descriptor which is readable when library work is pending (pollable mode), -1 otherwise.
+ */
+int32_t pal_linux_event_get_fd(void);
+
+/**
+ * @brief Runs the pending work without blocking (pollable mode). Returns the number of callbacks and handlers run.
+ */
+int32_t pal_linux_event_process(void);
+
+/**
+ * @brief Adds a file descriptor, e.g. a socket, to the pollable file descriptor, the handler is called from
+ *        #pal_linux_event_process. A NULL handler removes the file descriptor.
+ */
+pal_status_t pal_linux_event_watch_fd(int32_t fd, uint32_t events, pal_linux_fd_handler_t handler, void * p_ctx);
+
+/**
+ * @brief Sets up the io_uring shared by the I2C buses and the timers and starts its thread.
+ */
+pal_status_t pal_linux_uring_init(void);
+
+/**
+ * @brief Submits a read from a file descriptor.
+ */
+pal_status_t pal_linux_uring_read(pal_linux_uring_request_t * p_request, int32_t fd, void * p_buffer, uint32_t length);
+
+/**
+ * @brief Submits a write to a file descriptor.
+ */
+pal_status_t pal_linux_uring_write(pal_linux_uring_request_t * p_request, int32_t fd, const void * p_buffer, uint32_t length);
+
+/**
+ * @brief Submits a timeout, completing with -ETIME after time_us.
+ */
+pal_status_t pal_linux_uring_timeout(pal_linux_uring_request_t * p_request, uint32_t time_us);
+
+/**
+ * @brief Cancels a pending timeout, which then completes with -ECANCELED.
+ */
+pal_status_t pal_linux_uring_timeout_remove(const pal_linux_uring_request_t * p_target);
+
 #endif
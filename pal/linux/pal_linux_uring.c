@@ -0,0 +1,389 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file pal_linux_uring.c
+*
+* \brief   This file implements the io_uring shared by the io_uring based PAL backends.
+*          If the ring fails, the requests in flight complete with the error and new requests are refused, so the
+*          backends continue without it.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#include "pal_linux.h"
+
+/// @cond hidden
+/// Requests in flight at most, as many as the completion queue holds
+#define PAL_LINUX_URING_PENDING (2 * PAL_LINUX_URING_ENTRIES)
+
+typedef struct pal_linux_uring
+{
+    int32_t fd;
+    uint32_t * sq_head;
+    uint32_t * sq_tail;
+    uint32_t * sq_mask;
+    uint32_t * sq_array;
+    uint32_t sq_entries;
+    struct io_uring_sqe * sqes;
+    uint32_t * cq_head;
+    uint32_t * cq_tail;
+    uint32_t * cq_mask;
+    struct io_uring_cqe * cqes;
+    /// Entries queued but not yet submitted to the kernel
+    uint32_t to_submit;
+    /// Requests submitted and not completed yet, completed with the error if the ring fails
+    pal_linux_uring_request_t * pending[PAL_LINUX_URING_PENDING];
+    uint32_t pending_count;
+    pthread_mutex_t mutex;
+    pthread_t thread;
+    uint8_t initialized;
+    /// io_uring_enter failed, no request is accepted any more
+    uint8_t failed;
+} pal_linux_uring_t;
+
+static pal_linux_uring_t uring = {-1, .mutex = PTHREAD_MUTEX_INITIALIZER};
+
+static int32_t uring_enter(uint32_t to_submit, uint32_t min_complete, uint32_t flags)
+{
+    return (int32_t)syscall(__NR_io_uring_enter, uring.fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+// Checks that the kernel supports all operations used by the backends
+static pal_status_t uring_probe(void)
+{
+    static const uint8_t required_ops[] = {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_TIMEOUT, IORING_OP_TIMEOUT_REMOVE};
+    uint8_t buffer[sizeof(struct io_uring_probe) + (256 * sizeof(struct io_uring_probe_op))] = {0};
+    struct io_uring_probe * p_probe = (struct io_uring_probe *)buffer;
+    uint8_t index;
+
+    if (0 != syscall(__NR_io_uring_register, uring.fd, IORING_REGISTER_PROBE, p_probe, 256))
+    {
+        return PAL_STATUS_FAILURE;
+    }
+    for (index = 0; index < sizeof(required_ops); index++)
+    {
+        if ((required_ops[index] > p_probe->last_op) ||
+            !(p_probe->ops[required_ops[index]].flags & IO_URING_OP_SUPPORTED))
+        {
+            return PAL_STATUS_FAILURE;
+        }
+    }
+    return PAL_STATUS_SUCCESS;
+}
+
+// Submits the queued entries, called with the mutex held from threads other than the ring thread
+static void uring_flush(void)
+{
+    int32_t submitted;
+
+    while (uring.to_submit > 0)
+    {
+        submitted = uring_enter(uring.to_submit, 0, 0);
+        if ((submitted < 0) && (EINTR == errno))
+        {
+            continue;
+        }
+        if (submitted <= 0)
+        {
+            break;
+        }
+        uring.to_submit -= ((uint32_t)submitted < uring.to_submit) ? (uint32_t)submitted : uring.to_submit;
+    }
+}
+
+// Queues a submission entry, with the mutex held
+static struct io_uring_sqe * uring_get_sqe(void)
+{
+    uint32_t tail = *uring.sq_tail;
+    uint32_t index;
+    struct io_uring_sqe * p_sqe;
+
+    if ((tail - __atomic_load_n(uring.sq_head, __ATOMIC_ACQUIRE)) >= uring.sq_entries)
+    {
+        uring_flush();
+        if ((tail - __atomic_load_n(uring.sq_head, __ATOMIC_ACQUIRE)) >= uring.sq_entries)
+        {
+            return NULL;
+        }
+    }
+    index = tail & *uring.sq_mask;
+    p_sqe = &uring.sqes[index];
+    memset(p_sqe, 0, sizeof(*p_sqe));
+    uring.sq_array[index] = index;
+    return p_sqe;
+}
+
+// Publishes the entry returned by uring_get_sqe. Entries queued by the ring thread, i.e. from completion
+// handlers, are submitted together with its next wait; other threads submit right away
+static void uring_commit(void)
+{
+    __atomic_store_n(uring.sq_tail, *uring.sq_tail + 1, __ATOMIC_RELEASE);
+    uring.to_submit++;
+    if (!pthread_equal(pthread_self(), uring.thread))
+    {
+        uring_flush();
+    }
+}
+
+// Removes a completed request from the requests in flight, with the mutex held
+static void uring_remove_pending(const pal_linux_uring_request_t * p_request)
+{
+    uint32_t index;
+
+    for (index = 0; index < uring.pending_count; index++)
+    {
+        if (p_request == uring.pending[index])
+        {
+            uring.pending[index] = uring.pending[--uring.pending_count];
+            break;
+        }
+    }
+}
+
+// Refuses new requests and completes the requests in flight with the error, invoked from the ring thread
+static void uring_fail(int32_t error)
+{
+    pal_linux_uring_request_t * pending[PAL_LINUX_URING_PENDING];
+    uint32_t count;
+    uint32_t index;
+
+    pthread_mutex_lock(&uring.mutex);
+    uring.failed = true;
+    count = uring.pending_count;
+    memcpy(pending, uring.pending, count * sizeof(pending[0]));
+    uring.pending_count = 0;
+    pthread_mutex_unlock(&uring.mutex);
+
+    // The kernel cancels what is still in flight once the ring is closed
+    close(uring.fd);
+    for (index = 0; index < count; index++)
+    {
+        if (NULL != pending[index]->handler)
+        {
+            pending[index]->handler(pending[index]->p_ctx, -error);
+        }
+    }
+}
+
+static void * uring_thread(void * arg)
+{
+    uint32_t head;
+    uint32_t to_submit;
+    struct io_uring_cqe * p_cqe;
+    pal_linux_uring_request_t * p_request;
+    int32_t result;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&uring.mutex);
+        to_submit = uring.to_submit;
+        uring.to_submit = 0;
+        pthread_mutex_unlock(&uring.mutex);
+
+        // Submit what the handlers queued and wait for the next completion in one call
+        if ((uring_enter(to_submit, 1, IORING_ENTER_GETEVENTS) < 0) && (EINTR != errno) && (EBUSY != errno))
+        {
+            uring_fail(errno);
+            break;
+        }
+
+        head = *uring.cq_head;
+        while (head != __atomic_load_n(uring.cq_tail, __ATOMIC_ACQUIRE))
+        {
+            p_cqe = &uring.cqes[head & *uring.cq_mask];
+            p_request = (pal_linux_uring_request_t *)(uintptr_t)p_cqe->user_data;
+            result = p_cqe->res;
+            head++;
+            __atomic_store_n(uring.cq_head, head, __ATOMIC_RELEASE);
+
+            if (NULL == p_request)
+            {
+                continue;
+            }
+            pthread_mutex_lock(&uring.mutex);
+            uring_remove_pending(p_request);
+            pthread_mutex_unlock(&uring.mutex);
+            if (NULL != p_request->handler)
+            {
+                p_request->handler(p_request->p_ctx, result);
+            }
+        }
+    }
+    return NULL;
+}
+
+static pal_status_t uring_submit(pal_linux_uring_request_t * p_request, uint8_t opcode, int32_t fd,
+                                 uint64_t address, uint32_t length, uint64_t offset, uint32_t flags)
+{
+    struct io_uring_sqe * p_sqe;
+    pal_status_t status = PAL_STATUS_FAILURE;
+
+    pthread_mutex_lock(&uring.mutex);
+    p_sqe = ((uring.initialized) && (!uring.failed) &&
+             ((NULL == p_request) || (uring.pending_count < PAL_LINUX_URING_PENDING))) ? uring_get_sqe() : NULL;
+    if (NULL != p_sqe)
+    {
+        p_sqe->opcode = opcode;
+        p_sqe->fd = fd;
+        p_sqe->addr = address;
+        p_sqe->len = length;
+        p_sqe->off = offset;
+        // Shared by rw_flags, poll32_events and timeout_flags
+        p_sqe->rw_flags = (__kernel_rwf_t)flags;
+        p_sqe->user_data = (uint64_t)(uintptr_t)p_request;
+        if (NULL != p_request)
+        {
+            uring.pending[uring.pending_count++] = p_request;
+        }
+        uring_commit();
+        status = PAL_STATUS_SUCCESS;
+    }
+    pthread_mutex_unlock(&uring.mutex);
+    return status;
+}
+/// @endcond
+
+/**
+ * Sets up the io_uring and starts the ring thread which reaps the completions and invokes the handlers of the
+ * requests. Can be called several times, the ring is set up once.
+ *
+ * \retval  #PAL_STATUS_SUCCESS  The ring is ready
+ * \retval  #PAL_STATUS_FAILURE  io_uring or one of the operations used is not supported by the kernel, or the ring
+ *                               has failed
+ */
+pal_status_t pal_linux_uring_init(void)
+{
+    struct io_uring_params params;
+    uint8_t * p_sq_ring;
+    uint8_t * p_cq_ring;
+    size_t sq_size;
+    size_t cq_size;
+    pal_status_t status = PAL_STATUS_FAILURE;
+
+    pthread_mutex_lock(&uring.mutex);
+    do
+    {
+        if (uring.initialized)
+        {
+            status = (uring.failed) ? PAL_STATUS_FAILURE : PAL_STATUS_SUCCESS;
+            break;
+        }
+
+        memset(&params, 0, sizeof(params));
+        uring.fd = (int32_t)syscall(__NR_io_uring_setup, PAL_LINUX_URING_ENTRIES, &params);
+        if (uring.fd < 0)
+        {
+            break;
+        }
+        if (PAL_STATUS_SUCCESS != uring_probe())
+        {
+            close(uring.fd);
+            break;
+        }
+
+        sq_size = params.sq_off.array + (params.sq_entries * sizeof(uint32_t));
+        cq_size = params.cq_off.cqes + (params.cq_entries * sizeof(struct io_uring_cqe));
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+        {
+            sq_size = (cq_size > sq_size) ? cq_size : sq_size;
+        }
+        p_sq_ring = mmap(NULL, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring.fd, IORING_OFF_SQ_RING);
+        p_cq_ring = p_sq_ring;
+        if (!(params.features & IORING_FEAT_SINGLE_MMAP) && (MAP_FAILED != p_sq_ring))
+        {
+            p_cq_ring = mmap(NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring.fd, IORING_OFF_CQ_RING);
+        }
+        uring.sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, uring.fd, IORING_OFF_SQES);
+        if ((MAP_FAILED == p_sq_ring) || (MAP_FAILED == p_cq_ring) || (MAP_FAILED == uring.sqes))
+        {
+            close(uring.fd);
+            break;
+        }
+
+        uring.sq_head = (uint32_t *)(p_sq_ring + params.sq_off.head);
+        uring.sq_tail = (uint32_t *)(p_sq_ring + params.sq_off.tail);
+        uring.sq_mask = (uint32_t *)(p_sq_ring + params.sq_off.ring_mask);
+        uring.sq_array = (uint32_t *)(p_sq_ring + params.sq_off.array);
+        uring.sq_entries = params.sq_entries;
+        uring.cq_head = (uint32_t *)(p_cq_ring + params.cq_off.head);
+        uring.cq_tail = (uint32_t *)(p_cq_ring + params.cq_off.tail);
+        uring.cq_mask = (uint32_t *)(p_cq_ring + params.cq_off.ring_mask);
+        uring.cqes = (struct io_uring_cqe *)(p_cq_ring + params.cq_off.cqes);
+
+        if (0 != pthread_create(&uring.thread, NULL, uring_thread, NULL))
+        {
+            close(uring.fd);
+            break;
+        }
+        uring.initialized = true;
+        status = PAL_STATUS_SUCCESS;
+    } while (0);
+    pthread_mutex_unlock(&uring.mutex);
+
+    return status;
+}
+
+pal_status_t pal_linux_uring_read(pal_linux_uring_request_t * p_request, int32_t fd, void * p_buffer, uint32_t length)
+{
+    return uring_submit(p_request, IORING_OP_READ, fd, (uint64_t)(uintptr_t)p_buffer, length, (uint64_t)-1, 0);
+}
+
+pal_status_t pal_linux_uring_write(pal_linux_uring_request_t * p_request, int32_t fd, const void * p_buffer, uint32_t length)
+{
+    return uring_submit(p_request, IORING_OP_WRITE, fd, (uint64_t)(uintptr_t)p_buffer, length, (uint64_t)-1, 0);
+}
+
+pal_status_t pal_linux_uring_timeout(pal_linux_uring_request_t * p_request, uint32_t time_us)
+{
+    p_request->timeout[0] = time_us / 1000000;
+    p_request->timeout[1] = (int64_t)(time_us % 1000000) * 1000;
+    return uring_submit(p_request, IORING_OP_TIMEOUT, -1, (uint64_t)(uintptr_t)p_request->timeout, 1, 0, 0);
+}
+
+pal_status_t pal_linux_uring_timeout_remove(const pal_linux_uring_request_t * p_target)
+{
+    // The completion of the removal itself has no request, the ring thread skips it
+    return uring_submit(NULL, IORING_OP_TIMEOUT_REMOVE, -1, (uint64_t)(uintptr_t)p_target, 0, 0, 0);
+}
+
+/**
+* @}
+*/
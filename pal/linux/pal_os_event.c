@@ -34,12 +34,21 @@
 * @{
 */
 
+#define _GNU_SOURCE
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <signal.h>
 #include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/timerfd.h>
+#include <sys/epoll.h>
+#include <poll.h>
 #include "optiga/pal/pal_os_timer.h"
 #include "optiga/pal/pal_os_event.h"
 
@@ -56,28 +65,461 @@ typedef struct pal_os_event
     register_callback callback_registered;
     /// context to be passed to callback
     void * callback_ctx;
+    /// deadline of the registered callback
+    struct timespec deadline;
+    /// incremented with every registration, to detect a re-registration while waiting
+    uint32_t generation;
 }pal_os_event_t;
 
 static pal_os_event_t pal_os_event_0 = {0};
 static 	timer_t timerid;
 
+/// Real-time mode is enabled
+static uint8_t realtime_enabled = false;
+static pal_linux_realtime_config_t realtime_config;
+static pthread_t realtime_thread;
+static pthread_mutex_t realtime_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t realtime_cond;
+
+static pal_linux_event_metrics_t event_metrics = {0};
+
+/** \brief File descriptor watched in the pollable mode */
+typedef struct pal_os_event_watch
+{
+    /// watched file descriptor, -1 if the entry is free
+    int32_t fd;
+    /// handler invoked when the file descriptor is ready
+    pal_linux_fd_handler_t handler;
+    /// context passed to the handler
+    void * p_ctx;
+}pal_os_event_watch_t;
+
+/// Pollable mode is enabled
+static uint8_t pollable_enabled = false;
+/// epoll file descriptor handed to the application
+static int epoll_fd = -1;
+/// timerfd of the registered callback, part of the epoll set
+static int timer_fd = -1;
+static pal_os_event_watch_t timer_watch;
+static pal_os_event_watch_t fd_watches[PAL_LINUX_EVENT_MAX_WATCHES];
+
+static void timespec_add_us(struct timespec * p_time, uint32_t time_us)
+{
+	p_time->tv_sec += time_us / 1000000;
+	p_time->tv_nsec += (long)(time_us % 1000000) * 1000;
+	if (p_time->tv_nsec >= 1000000000)
+	{
+		p_time->tv_sec++;
+		p_time->tv_nsec -= 1000000000;
+	}
+}
+
+static int64_t timespec_diff_us(const struct timespec * p_later, const struct timespec * p_earlier)
+{
+	return ((int64_t)(p_later->tv_sec - p_earlier->tv_sec) * 1000000) +
+	       ((p_later->tv_nsec - p_earlier->tv_nsec) / 1000);
+}
+
+// Records the overshoot of the event fired now over its deadline
+static void record_overshoot(const struct timespec * p_deadline, clockid_t clock)
+{
+	struct timespec now;
+	int64_t overshoot_us;
+
+	clock_gettime(clock, &now);
+	overshoot_us = timespec_diff_us(&now, p_deadline);
+	if (overshoot_us < 0)
+	{
+		overshoot_us = 0;
+	}
+	event_metrics.event_count++;
+	event_metrics.last_overshoot_us = (uint32_t)overshoot_us;
+	event_metrics.total_overshoot_us += (uint64_t)overshoot_us;
+	if ((uint32_t)overshoot_us > event_metrics.max_overshoot_us)
+	{
+		event_metrics.max_overshoot_us = (uint32_t)overshoot_us;
+	}
+}
+
 static void handler(int sig, siginfo_t *si, void *uc)
 {
 	register_callback callback;
 	
 	if (pal_os_event_0.callback_registered)
     {
+        record_overshoot(&pal_os_event_0.deadline, CLOCKID);
         callback = pal_os_event_0.callback_registered;
         pal_os_event_0.callback_registered = NULL;
         callback((void * )pal_os_event_0.callback_ctx);
     }
 }
 
+// Event thread of the real-time mode: sleeps till shortly before the deadline, then spins
+static void * realtime_event_thread(void * arg)
+{
+	register_callback callback;
+	void * callback_ctx;
+	struct timespec deadline;
+	struct timespec wake_time;
+	struct timespec now;
+	uint32_t generation;
+
+	pthread_mutex_lock(&realtime_mutex);
+	for (;;)
+	{
+		if (NULL == pal_os_event_0.callback_registered)
+		{
+			pthread_cond_wait(&realtime_cond, &realtime_mutex);
+			continue;
+		}
+
+		generation = pal_os_event_0.generation;
+		deadline = pal_os_event_0.deadline;
+		wake_time = deadline;
+		wake_time.tv_nsec -= (long)(realtime_config.spin_threshold_us % 1000000) * 1000;
+		wake_time.tv_sec -= realtime_config.spin_threshold_us / 1000000;
+		if (wake_time.tv_nsec < 0)
+		{
+			wake_time.tv_sec--;
+			wake_time.tv_nsec += 1000000000;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		if ((timespec_diff_us(&wake_time, &now) > 0) &&
+		    (ETIMEDOUT != pthread_cond_timedwait(&realtime_cond, &realtime_mutex, &wake_time)))
+		{
+			// Registration changed or spurious wake up, evaluate again
+			continue;
+		}
+		if ((generation != pal_os_event_0.generation) || (NULL == pal_os_event_0.callback_registered))
+		{
+			continue;
+		}
+
+		// Spin for the rest, the lock is released so that a new registration is not blocked
+		pthread_mutex_unlock(&realtime_mutex);
+		do
+		{
+			clock_gettime(CLOCK_MONOTONIC, &now);
+		} while (timespec_diff_us(&deadline, &now) > 0);
+		pthread_mutex_lock(&realtime_mutex);
+
+		if ((generation != pal_os_event_0.generation) || (NULL == pal_os_event_0.callback_registered))
+		{
+			continue;
+		}
+		record_overshoot(&deadline, CLOCK_MONOTONIC);
+		callback = pal_os_event_0.callback_registered;
+		callback_ctx = pal_os_event_0.callback_ctx;
+		pal_os_event_0.callback_registered = NULL;
+
+		// The callback may register the next event
+		pthread_mutex_unlock(&realtime_mutex);
+		callback(callback_ctx);
+		pthread_mutex_lock(&realtime_mutex);
+	}
+	return NULL;
+}
+
+static pal_status_t realtime_event_init(void)
+{
+	pthread_condattr_t cond_attr;
+	pthread_attr_t thread_attr;
+	struct sched_param param;
+	cpu_set_t cpu_set;
+	pal_status_t status = PAL_STATUS_FAILURE;
+
+	do
+	{
+		if (realtime_config.lock_memory && (0 != mlockall(MCL_CURRENT | MCL_FUTURE)))
+		{
+			printf("mlockall failed, continuing without locked memory\n");
+		}
+
+		pthread_condattr_init(&cond_attr);
+		pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+		pthread_cond_init(&realtime_cond, &cond_attr);
+		pthread_condattr_destroy(&cond_attr);
+
+		pthread_attr_init(&thread_attr);
+		pthread_attr_setinheritsched(&thread_attr, PTHREAD_EXPLICIT_SCHED);
+		pthread_attr_setschedpolicy(&thread_attr, SCHED_FIFO);
+		param.sched_priority = realtime_config.priority;
+		pthread_attr_setschedparam(&thread_attr, &param);
+		if (realtime_config.cpu >= 0)
+		{
+			CPU_ZERO(&cpu_set);
+			CPU_SET(realtime_config.cpu, &cpu_set);
+			pthread_attr_setaffinity_np(&thread_attr, sizeof(cpu_set), &cpu_set);
+		}
+
+		// SCHED_FIFO needs CAP_SYS_NICE, without it the thread is created with the default policy
+		if (0 != pthread_create(&realtime_thread, &thread_attr, realtime_event_thread, NULL))
+		{
+			printf("Real-time event thread not permitted, using the default policy\n");
+			pthread_attr_setinheritsched(&thread_attr, PTHREAD_INHERIT_SCHED);
+			if (0 != pthread_create(&realtime_thread, &thread_attr, realtime_event_thread, NULL))
+			{
+				pthread_attr_destroy(&thread_attr);
+				break;
+			}
+		}
+		pthread_attr_destroy(&thread_attr);
+		status = PAL_STATUS_SUCCESS;
+	} while (0);
+
+	return status;
+}
+
+/**
+ * Enables the real-time mode. Timer events are then served by a dedicated thread with SCHED_FIFO priority,
+ * optionally pinned to a CPU, which sleeps till spin_threshold_us before the deadline and spins for the rest.
+ * Callbacks run in that thread instead of the SIGRTMIN handler.
+ */
+pal_status_t pal_linux_event_set_realtime(const pal_linux_realtime_config_t * p_config)
+{
+	if ((NULL == p_config) || (true == realtime_enabled) || (true == pollable_enabled) ||
+	    (p_config->priority < sched_get_priority_min(SCHED_FIFO)) ||
+	    (p_config->priority > sched_get_priority_max(SCHED_FIFO)))
+	{
+		return PAL_STATUS_FAILURE;
+	}
+	realtime_config = *p_config;
+	realtime_enabled = true;
+	return PAL_STATUS_SUCCESS;
+}
+
+/**
+ * Returns the overshoot of the timer events over their deadlines measured since the last call.
+ */
+void pal_linux_event_get_metrics(pal_linux_event_metrics_t * p_metrics)
+{
+	if (true == realtime_enabled)
+	{
+		pthread_mutex_lock(&realtime_mutex);
+	}
+	if (NULL != p_metrics)
+	{
+		*p_metrics = event_metrics;
+	}
+	memset(&event_metrics, 0, sizeof(event_metrics));
+	if (true == realtime_enabled)
+	{
+		pthread_mutex_unlock(&realtime_mutex);
+	}
+}
+
+static pal_status_t pollable_event_init(void)
+{
+	struct epoll_event event;
+	uint8_t index;
+
+	for (index = 0; index < PAL_LINUX_EVENT_MAX_WATCHES; index++)
+	{
+		fd_watches[index].fd = -1;
+	}
+
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if ((epoll_fd < 0) || (timer_fd < 0))
+	{
+		printf("pollable event init failed\n");
+		return PAL_STATUS_FAILURE;
+	}
+
+	timer_watch.fd = timer_fd;
+	event.events = EPOLLIN;
+	event.data.ptr = &timer_watch;
+	if (0 != epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &event))
+	{
+		return PAL_STATUS_FAILURE;
+	}
+	return PAL_STATUS_SUCCESS;
+}
+
+// Runs the registered callback if its deadline is reached, the expiry of the timerfd is consumed
+static int32_t pollable_run_timer(void)
+{
+	register_callback callback;
+	struct timespec now;
+	uint64_t expirations;
+
+	//lint --e{534} suppress "Nothing to be read if the timer did not expire yet"
+	(void)read(timer_fd, &expirations, sizeof(expirations));
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	if ((NULL == pal_os_event_0.callback_registered) || (timespec_diff_us(&pal_os_event_0.deadline, &now) > 0))
+	{
+		return 0;
+	}
+	record_overshoot(&pal_os_event_0.deadline, CLOCK_MONOTONIC);
+	callback = pal_os_event_0.callback_registered;
+	pal_os_event_0.callback_registered = NULL;
+	// The callback may register the next event, which re-arms the timerfd
+	callback(pal_os_event_0.callback_ctx);
+	return 1;
+}
+
+pal_status_t pal_linux_event_set_pollable(void)
+{
+	if ((true == realtime_enabled) || (true == pollable_enabled))
+	{
+		return PAL_STATUS_FAILURE;
+	}
+	pollable_enabled = true;
+	return PAL_STATUS_SUCCESS;
+}
+
+int32_t pal_linux_event_get_fd(void)
+{
+	return (true == pollable_enabled) ? epoll_fd : -1;
+}
+
+int32_t pal_linux_event_process(void)
+{
+	struct epoll_event events[PAL_LINUX_EVENT_MAX_WATCHES + 1];
+	pal_os_event_watch_t * p_watch;
+	int32_t count;
+	int32_t index;
+	int32_t processed = 0;
+
+	if ((true != pollable_enabled) || (epoll_fd < 0))
+	{
+		return 0;
+	}
+
+	count = epoll_wait(epoll_fd, events, PAL_LINUX_EVENT_MAX_WATCHES + 1, 0);
+	for (index = 0; index < count; index++)
+	{
+		p_watch = (pal_os_event_watch_t *)events[index].data.ptr;
+		if (&timer_watch == p_watch)
+		{
+			processed += pollable_run_timer();
+		}
+		// A handler run before may have removed this watch
+		else if ((p_watch->fd >= 0) && (NULL != p_watch->handler))
+		{
+			p_watch->handler(p_watch->p_ctx, p_watch->fd, events[index].events);
+			processed++;
+		}
+	}
+	return processed;
+}
+
+pal_status_t pal_linux_event_watch_fd(int32_t fd, uint32_t events, pal_linux_fd_handler_t handler, void * p_ctx)
+{
+	struct epoll_event event;
+	pal_os_event_watch_t * p_watch = NULL;
+	uint8_t index;
+
+	if ((true != pollable_enabled) || (epoll_fd < 0) || (fd < 0))
+	{
+		return PAL_STATUS_FAILURE;
+	}
+
+	for (index = 0; index < PAL_LINUX_EVENT_MAX_WATCHES; index++)
+	{
+		if (fd == fd_watches[index].fd)
+		{
+			p_watch = &fd_watches[index];
+			break;
+		}
+	}
+
+	if (NULL == handler)
+	{
+		if (NULL != p_watch)
+		{
+			epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+			p_watch->fd = -1;
+			p_watch->handler = NULL;
+		}
+		return PAL_STATUS_SUCCESS;
+	}
+
+	event.events = events;
+	if (NULL != p_watch)
+	{
+		event.data.ptr = p_watch;
+		if (0 != epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event))
+		{
+			return PAL_STATUS_FAILURE;
+		}
+	}
+	else
+	{
+		for (index = 0; index < PAL_LINUX_EVENT_MAX_WATCHES; index++)
+		{
+			if (fd_watches[index].fd < 0)
+			{
+				p_watch = &fd_watches[index];
+				break;
+			}
+		}
+		if (NULL == p_watch)
+		{
+			return PAL_STATUS_FAILURE;
+		}
+		event.data.ptr = p_watch;
+		if (0 != epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event))
+		{
+			return PAL_STATUS_FAILURE;
+		}
+		p_watch->fd = fd;
+	}
+	p_watch->handler = handler;
+	p_watch->p_ctx = p_ctx;
+	return PAL_STATUS_SUCCESS;
+}
+
+/**
+ * Serves the timer while a blocking library call waits for a response of OPTIGA. Only the timer is served, the watched
+ * file descriptors are left to the application's event loop, so that no application handler runs inside a library call.
+ * In the signal and the real-time mode the timer is served elsewhere, the call only yields the CPU for up to 1 ms
+ * so that the waiting library does not spin.
+ */
+void pal_os_event_process(void)
+{
+	struct pollfd poll_fd;
+	struct timespec now;
+	int64_t wait_us = 1000;
+
+	if (true != pollable_enabled)
+	{
+		// The signal handler or the event thread serve the timer, the timer signal ends the sleep early
+		usleep(1000);
+		return;
+	}
+
+	if (NULL != pal_os_event_0.callback_registered)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		wait_us = timespec_diff_us(&pal_os_event_0.deadline, &now);
+	}
+	if (wait_us > 0)
+	{
+		poll_fd.fd = timer_fd;
+		poll_fd.events = POLLIN;
+		poll_fd.revents = 0;
+		poll(&poll_fd, 1, (int)((wait_us > 10000) ? 10 : ((wait_us + 999) / 1000)));
+	}
+	pollable_run_timer();
+}
+
 pal_status_t pal_os_event_init(void)
 {
 	struct sigevent sev;
 	struct sigaction sa;
 	
+	if (true == realtime_enabled)
+	{
+		return realtime_event_init();
+	}
+	if (true == pollable_enabled)
+	{
+		return pollable_event_init();
+	}
+
 	/* Establishing handler for signal */
 	
 	sa.sa_flags = SA_SIGINFO;
@@ -105,7 +547,29 @@ pal_status_t pal_os_event_init(void)
 
 pal_status_t pal_os_event_stop(void)
 {
-	if (timerid != 0)
+	if (true == realtime_enabled)
+	{
+		pthread_mutex_lock(&realtime_mutex);
+		pal_os_event_0.callback_registered = NULL;
+		pal_os_event_0.generation++;
+		pthread_cond_signal(&realtime_cond);
+		pthread_mutex_unlock(&realtime_mutex);
+	}
+	else if (true == pollable_enabled)
+	{
+		pal_os_event_0.callback_registered = NULL;
+		if (timer_fd >= 0)
+		{
+			close(timer_fd);
+			timer_fd = -1;
+		}
+		if (epoll_fd >= 0)
+		{
+			close(epoll_fd);
+			epoll_fd = -1;
+		}
+	}
+	else if (timerid != 0)
 	{
 		timer_delete(timerid);
 	}
@@ -119,6 +583,41 @@ void pal_os_event_register_callback_oneshot(register_callback callback,
 {
 	struct itimerspec its;
 	long long freq_nanosecs;
+
+	if (true == realtime_enabled)
+	{
+		pthread_mutex_lock(&realtime_mutex);
+		clock_gettime(CLOCK_MONOTONIC, &pal_os_event_0.deadline);
+		timespec_add_us(&pal_os_event_0.deadline, time_us);
+		pal_os_event_0.callback_registered = callback;
+		pal_os_event_0.callback_ctx = callback_args;
+		pal_os_event_0.generation++;
+		pthread_cond_signal(&realtime_cond);
+		pthread_mutex_unlock(&realtime_mutex);
+		return;
+	}
+
+	if (true == pollable_enabled)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &pal_os_event_0.deadline);
+		timespec_add_us(&pal_os_event_0.deadline, time_us);
+		pal_os_event_0.callback_registered = callback;
+		pal_os_event_0.callback_ctx = callback_args;
+
+		// Absolute expiry, a deadline already passed makes the timerfd readable right away
+		its.it_value = pal_os_event_0.deadline;
+		its.it_interval.tv_sec = 0;
+		its.it_interval.tv_nsec = 0;
+		if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL) == -1)
+		{
+			printf("Error in timerfd_settime\n");
+			exit(1);
+		}
+		return;
+	}
+
+    clock_gettime(CLOCKID, &pal_os_event_0.deadline);
+    timespec_add_us(&pal_os_event_0.deadline, time_us);
     pal_os_event_0.callback_registered = callback;
     pal_os_event_0.callback_ctx = callback_args;
 	
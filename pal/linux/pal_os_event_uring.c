@@ -0,0 +1,327 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file pal_os_event_uring.c
+*
+* \brief   This file implements the platform abstraction layer APIs for os event/scheduler on top of io_uring.
+*          It replaces pal_os_event.c when the io_uring backend is used, so timers complete in the same ring
+*          thread as the I2C transfers.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include "optiga/pal/pal_os_event.h"
+#include "optiga/pal/pal_os_timer.h"
+
+#include "pal_linux.h"
+
+/// Number of timeouts which can be in flight, superseded timeouts are cancelled and free their slot on completion
+#define PAL_OS_EVENT_URING_SLOTS 8
+
+/// Timers are not set up yet
+#define PAL_OS_EVENT_BACKEND_NONE   0
+/// Timers are io_uring timeouts
+#define PAL_OS_EVENT_BACKEND_URING  1
+/// io_uring is not available, timers are a POSIX timer
+#define PAL_OS_EVENT_BACKEND_TIMER  2
+
+/** \brief PAL os event structure */
+typedef struct pal_os_event
+{
+    /// registered callback
+    register_callback callback_registered;
+    /// context to be passed to callback
+    void * callback_ctx;
+    /// incremented with every registration, a completing timeout fires only if it is the latest one
+    uint32_t generation;
+    /// expiry of the latest registration on CLOCK_MONOTONIC
+    struct timespec deadline;
+    /// the latest registration waits for a free slot
+    uint8_t deferred;
+}pal_os_event_t;
+
+/// @cond hidden
+typedef struct pal_os_event_slot
+{
+    pal_linux_uring_request_t request;
+    uint32_t generation;
+    uint8_t in_flight;
+    uint8_t cancelled;
+} pal_os_event_slot_t;
+
+static pal_os_event_t pal_os_event_0 = {0};
+static pal_os_event_slot_t event_slots[PAL_OS_EVENT_URING_SLOTS];
+static pthread_mutex_t event_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t event_backend = PAL_OS_EVENT_BACKEND_NONE;
+static timer_t fallback_timer;
+
+static void pal_os_event_expired(void * p_ctx, int32_t result);
+
+// Microseconds till the deadline, 0 if it has passed
+static uint32_t pal_os_event_remaining_us(const struct timespec * p_deadline)
+{
+    struct timespec now;
+    int64_t remaining_us;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    remaining_us = ((int64_t)(p_deadline->tv_sec - now.tv_sec) * 1000000) +
+                   ((p_deadline->tv_nsec - now.tv_nsec) / 1000);
+    return (remaining_us > 0) ? (uint32_t)remaining_us : 0;
+}
+
+// Fired by the POSIX timer in its own thread. A re-registration re-arms the timer, an expiry of the replaced
+// registration still running is recognised by the deadline not being reached.
+static void pal_os_event_timer_expired(union sigval value)
+{
+    register_callback callback = NULL;
+    void * callback_ctx = NULL;
+
+    (void)value;
+    pthread_mutex_lock(&event_mutex);
+    if ((NULL != pal_os_event_0.callback_registered) && (0 == pal_os_event_remaining_us(&pal_os_event_0.deadline)))
+    {
+        callback = pal_os_event_0.callback_registered;
+        callback_ctx = pal_os_event_0.callback_ctx;
+        pal_os_event_0.callback_registered = NULL;
+    }
+    pthread_mutex_unlock(&event_mutex);
+
+    if (NULL != callback)
+    {
+        callback(callback_ctx);
+    }
+}
+
+// Switches to the POSIX timer, called with the mutex held
+static void pal_os_event_timer_create(void)
+{
+    struct sigevent sev;
+
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD;
+    sev.sigev_notify_function = pal_os_event_timer_expired;
+    if (timer_create(CLOCK_MONOTONIC, &sev, &fallback_timer) == -1)
+    {
+        printf("timer_create\n");
+        exit(1);
+    }
+    event_backend = PAL_OS_EVENT_BACKEND_TIMER;
+}
+
+// Selects the io_uring timeouts, or the POSIX timer if the ring cannot be set up. Called with the mutex held.
+static void pal_os_event_select_backend(void)
+{
+    if (PAL_OS_EVENT_BACKEND_NONE != event_backend)
+    {
+        return;
+    }
+    if (PAL_STATUS_SUCCESS == pal_linux_uring_init())
+    {
+        event_backend = PAL_OS_EVENT_BACKEND_URING;
+    }
+    else
+    {
+        pal_os_event_timer_create();
+    }
+}
+
+// Arms the POSIX timer for the latest registration, called with the mutex held
+static void pal_os_event_timer_arm(void)
+{
+    struct itimerspec its;
+
+    its.it_value = pal_os_event_0.deadline;
+    its.it_interval.tv_sec = 0;
+    its.it_interval.tv_nsec = 0;
+    if (timer_settime(fallback_timer, TIMER_ABSTIME, &its, NULL) == -1)
+    {
+        printf("Error in timer_settime\n");
+        exit(1);
+    }
+}
+
+// Submits the timeout of the latest registration in a free slot, or defers it till a slot is freed.
+// Called with the mutex held.
+static void pal_os_event_uring_arm(void)
+{
+    pal_os_event_slot_t * p_slot = NULL;
+    uint8_t index;
+
+    pal_os_event_0.deferred = false;
+    for (index = 0; index < PAL_OS_EVENT_URING_SLOTS; index++)
+    {
+        if (false == event_slots[index].in_flight)
+        {
+            p_slot = &event_slots[index];
+            break;
+        }
+    }
+    if (NULL == p_slot)
+    {
+        // All slots hold superseded timeouts being cancelled, the first one to complete arms this registration
+        pal_os_event_0.deferred = true;
+        return;
+    }
+
+    p_slot->in_flight = true;
+    p_slot->cancelled = false;
+    p_slot->generation = pal_os_event_0.generation;
+    p_slot->request.handler = pal_os_event_expired;
+    p_slot->request.p_ctx = p_slot;
+    if (PAL_STATUS_SUCCESS != pal_linux_uring_timeout(&p_slot->request, pal_os_event_remaining_us(&pal_os_event_0.deadline)))
+    {
+        // The ring is not usable any more, the timers continue on the POSIX timer
+        p_slot->in_flight = false;
+        pal_os_event_timer_create();
+        pal_os_event_timer_arm();
+    }
+}
+
+static void pal_os_event_expired(void * p_ctx, int32_t result)
+{
+    pal_os_event_slot_t * p_slot = (pal_os_event_slot_t *)p_ctx;
+    register_callback callback = NULL;
+    void * callback_ctx = NULL;
+
+    pthread_mutex_lock(&event_mutex);
+    p_slot->in_flight = false;
+    if ((-ETIME != result) && (-ECANCELED != result) && (0 != result))
+    {
+        // The ring failed and completes its requests with the error, the latest registration continues on the
+        // POSIX timer, for its original deadline
+        if (PAL_OS_EVENT_BACKEND_URING == event_backend)
+        {
+            pal_os_event_0.deferred = false;
+            pal_os_event_timer_create();
+            if (NULL != pal_os_event_0.callback_registered)
+            {
+                pal_os_event_timer_arm();
+            }
+        }
+    }
+    else if ((-ECANCELED != result) && (p_slot->generation == pal_os_event_0.generation))
+    {
+        callback = pal_os_event_0.callback_registered;
+        callback_ctx = pal_os_event_0.callback_ctx;
+        pal_os_event_0.callback_registered = NULL;
+    }
+    else if (pal_os_event_0.deferred)
+    {
+        pal_os_event_uring_arm();
+    }
+    pthread_mutex_unlock(&event_mutex);
+
+    if (NULL != callback)
+    {
+        callback(callback_ctx);
+    }
+}
+/// @endcond
+
+pal_status_t pal_os_event_init(void)
+{
+    pthread_mutex_lock(&event_mutex);
+    pal_os_event_select_backend();
+    pthread_mutex_unlock(&event_mutex);
+    return PAL_STATUS_SUCCESS;
+}
+
+pal_status_t pal_os_event_stop(void)
+{
+    pthread_mutex_lock(&event_mutex);
+    pal_os_event_0.callback_registered = NULL;
+    pal_os_event_0.generation++;
+    pal_os_event_0.deferred = false;
+    pthread_mutex_unlock(&event_mutex);
+    return PAL_STATUS_SUCCESS;
+}
+
+/**
+ * The timeouts complete in the ring thread, or the thread of the POSIX timer. While the library waits for a
+ * response of OPTIGA the call only yields the CPU for 1 ms, so that the waiting library does not spin.
+ */
+void pal_os_event_process(void)
+{
+    pal_os_timer_delay_in_milliseconds(1);
+}
+
+void pal_os_event_register_callback_oneshot(register_callback callback,
+                                            void*             callback_args,
+                                            uint32_t          time_us)
+{
+    uint8_t index;
+
+    pthread_mutex_lock(&event_mutex);
+    // The backend is selected here as well, in case the application does not call pal_os_event_init
+    pal_os_event_select_backend();
+
+    clock_gettime(CLOCK_MONOTONIC, &pal_os_event_0.deadline);
+    pal_os_event_0.deadline.tv_sec += time_us / 1000000;
+    pal_os_event_0.deadline.tv_nsec += (long)(time_us % 1000000) * 1000;
+    if (pal_os_event_0.deadline.tv_nsec >= 1000000000)
+    {
+        pal_os_event_0.deadline.tv_sec++;
+        pal_os_event_0.deadline.tv_nsec -= 1000000000;
+    }
+    pal_os_event_0.callback_registered = callback;
+    pal_os_event_0.callback_ctx = callback_args;
+    pal_os_event_0.generation++;
+
+    if (PAL_OS_EVENT_BACKEND_URING == event_backend)
+    {
+        // The superseded timeouts are cancelled, so their slots are freed without waiting for their expiry
+        for (index = 0; index < PAL_OS_EVENT_URING_SLOTS; index++)
+        {
+            if ((event_slots[index].in_flight) && (!event_slots[index].cancelled) &&
+                (PAL_STATUS_SUCCESS == pal_linux_uring_timeout_remove(&event_slots[index].request)))
+            {
+                event_slots[index].cancelled = true;
+            }
+        }
+        pal_os_event_uring_arm();
+    }
+    if (PAL_OS_EVENT_BACKEND_TIMER == event_backend)
+    {
+        pal_os_event_timer_arm();
+    }
+    pthread_mutex_unlock(&event_mutex);
+}
+
+/**
+* @}
+*/
@@ -0,0 +1,255 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file optiga_comms_tcp_bridge_test.c
+*
+* \brief   Test of the optiga comms over TCP bridge against a simulated OPTIGA, which echoes every APDU.
+*          The bridge runs in a child process, the test talks the frame protocol to it over a raw socket.
+*
+*          gcc -Ioptiga/include -Ipal/linux pal/linux/test/optiga_comms_tcp_bridge_test.c
+*              pal/linux/optiga_comms_tcp_bridge.c optiga/common/Util.c -o optiga_comms_tcp_bridge_test
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "optiga/comms/optiga_comms.h"
+#include "optiga/common/Util.h"
+#include "optiga_comms_tcp.h"
+
+#define TEST_PORT           (19731)
+
+#define TEST_CHECK(condition)                                               \
+    if (!(condition))                                                       \
+    {                                                                       \
+        printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition);       \
+        return -1;                                                          \
+    }
+
+optiga_comms_t optiga_comms = {NULL, NULL, NULL, 0};
+
+/// @cond hidden
+//Simulated OPTIGA, completes every request synchronously and echoes the APDU
+static void test_chip_complete(optiga_comms_t * p_ctx)
+{
+    if (NULL != p_ctx->upper_layer_handler)
+    {
+        p_ctx->upper_layer_handler(p_ctx->upper_layer_ctx, OPTIGA_COMMS_SUCCESS);
+    }
+}
+
+host_lib_status_t optiga_comms_open(optiga_comms_t * p_ctx)
+{
+    test_chip_complete(p_ctx);
+    return OPTIGA_COMMS_SUCCESS;
+}
+
+host_lib_status_t optiga_comms_reset(optiga_comms_t * p_ctx, uint8_t reset_type)
+{
+    (void)reset_type;
+    test_chip_complete(p_ctx);
+    return OPTIGA_COMMS_SUCCESS;
+}
+
+host_lib_status_t optiga_comms_transceive(optiga_comms_t * p_ctx, const uint8_t * p_data,
+                                          const uint16_t * p_data_length,
+                                          uint8_t * p_buffer, uint16_t * p_buffer_len)
+{
+    memcpy(p_buffer, p_data, *p_data_length);
+    *p_buffer_len = *p_data_length;
+    test_chip_complete(p_ctx);
+    return OPTIGA_COMMS_SUCCESS;
+}
+
+void pal_os_timer_delay_in_milliseconds(uint16_t milliseconds)
+{
+    usleep(milliseconds * 1000);
+}
+
+static int test_connect(void)
+{
+    struct sockaddr_in address;
+    int socket_fd;
+    int attempt;
+
+    for (attempt = 0; attempt < 100; attempt++)
+    {
+        socket_fd = socket(AF_INET, SOCK_STREAM, 0);
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(TEST_PORT);
+        if (0 == connect(socket_fd, (struct sockaddr *)&address, sizeof(address)))
+        {
+            return socket_fd;
+        }
+        close(socket_fd);
+        usleep(10000);
+    }
+    return -1;
+}
+
+static uint16_t test_frame(uint8_t * p_frame, uint16_t tag, uint8_t type, const uint8_t * p_data, uint16_t length)
+{
+    Utility_SetUint16(&p_frame[0], tag);
+    p_frame[2] = type;
+    p_frame[3] = 0x00;
+    Utility_SetUint16(&p_frame[4], OPTIGA_COMMS_SUCCESS);
+    Utility_SetUint16(&p_frame[6], length);
+    memcpy(&p_frame[OPTIGA_COMMS_TCP_HEADER_LENGTH], p_data, length);
+    return OPTIGA_COMMS_TCP_HEADER_LENGTH + length;
+}
+
+static int test_recv_all(int socket_fd, uint8_t * p_buffer, uint16_t length)
+{
+    ssize_t received;
+
+    while (0 != length)
+    {
+        received = recv(socket_fd, p_buffer, length, 0);
+        if (received <= 0)
+        {
+            return -1;
+        }
+        p_buffer += received;
+        length -= (uint16_t)received;
+    }
+    return 0;
+}
+
+//Receives one response frame and checks its tag, status and payload
+static int test_expect_response(int socket_fd, uint16_t tag, const uint8_t * p_data, uint16_t length)
+{
+    uint8_t frame[OPTIGA_COMMS_TCP_HEADER_LENGTH + OPTIGA_COMMS_TCP_MAX_APDU_LENGTH];
+
+    TEST_CHECK(0 == test_recv_all(socket_fd, frame, OPTIGA_COMMS_TCP_HEADER_LENGTH));
+    TEST_CHECK(tag == Utility_GetUint16(&frame[0]));
+    TEST_CHECK(OPTIGA_COMMS_SUCCESS == Utility_GetUint16(&frame[4]));
+    TEST_CHECK(length == Utility_GetUint16(&frame[6]));
+    TEST_CHECK(0 == test_recv_all(socket_fd, frame, length));
+    TEST_CHECK(0 == memcmp(frame, p_data, length));
+    return 0;
+}
+
+//Frames sent together are all answered, in order
+static int test_pipelined_frames(void)
+{
+    static const uint8_t apdu_0[] = {0x81, 0x00, 0x00, 0x03, 0x01, 0x02, 0x03};
+    static const uint8_t apdu_1[] = {0x83, 0x00, 0x00, 0x00};
+    static const uint8_t reset = 0x00;
+    uint8_t frames[64];
+    uint16_t length = 0;
+    int socket_fd = test_connect();
+
+    TEST_CHECK(socket_fd >= 0);
+    length += test_frame(&frames[length], 0, OPTIGA_COMMS_TCP_TYPE_TRANSCEIVE, apdu_0, sizeof(apdu_0));
+    length += test_frame(&frames[length], 1, OPTIGA_COMMS_TCP_TYPE_TRANSCEIVE, apdu_1, sizeof(apdu_1));
+    length += test_frame(&frames[length], 2, OPTIGA_COMMS_TCP_TYPE_RESET, &reset, sizeof(reset));
+    TEST_CHECK(length == send(socket_fd, frames, length, 0));
+
+    TEST_CHECK(0 == test_expect_response(socket_fd, 0, apdu_0, sizeof(apdu_0)));
+    TEST_CHECK(0 == test_expect_response(socket_fd, 1, apdu_1, sizeof(apdu_1)));
+    TEST_CHECK(0 == test_expect_response(socket_fd, 2, NULL, 0));
+    close(socket_fd);
+    return 0;
+}
+
+//An oversized header behind a valid frame is rejected before it is used, the valid frame is still answered
+static int test_oversized_second_frame(void)
+{
+    static const uint8_t apdu[] = {0x81, 0x00, 0x00, 0x00};
+    uint8_t frames[64];
+    uint8_t data;
+    uint16_t length = 0;
+    int socket_fd = test_connect();
+
+    TEST_CHECK(socket_fd >= 0);
+    length += test_frame(&frames[length], 0, OPTIGA_COMMS_TCP_TYPE_TRANSCEIVE, apdu, sizeof(apdu));
+    length += test_frame(&frames[length], 1, OPTIGA_COMMS_TCP_TYPE_TRANSCEIVE, NULL, 0);
+    Utility_SetUint16(&frames[length - 2], 0xFFFF);
+    TEST_CHECK(length == send(socket_fd, frames, length, 0));
+
+    TEST_CHECK(0 == test_expect_response(socket_fd, 0, apdu, sizeof(apdu)));
+    TEST_CHECK(0 == recv(socket_fd, &data, sizeof(data), 0));
+    close(socket_fd);
+    return 0;
+}
+
+//An oversized header in the first frame drops the client
+static int test_oversized_first_frame(void)
+{
+    uint8_t frame[OPTIGA_COMMS_TCP_HEADER_LENGTH];
+    uint8_t data;
+    int socket_fd = test_connect();
+
+    TEST_CHECK(socket_fd >= 0);
+    test_frame(frame, 0, OPTIGA_COMMS_TCP_TYPE_TRANSCEIVE, NULL, 0);
+    Utility_SetUint16(&frame[6], OPTIGA_COMMS_TCP_MAX_APDU_LENGTH + 1);
+    TEST_CHECK(sizeof(frame) == send(socket_fd, frame, sizeof(frame), 0));
+    TEST_CHECK(0 == recv(socket_fd, &data, sizeof(data), 0));
+    close(socket_fd);
+    return 0;
+}
+/// @endcond
+
+int main(void)
+{
+    pid_t bridge;
+    int result = 0;
+
+    bridge = fork();
+    if (0 == bridge)
+    {
+        optiga_comms_tcp_bridge_run(&optiga_comms, TEST_PORT);
+        _exit(1);
+    }
+
+    result |= test_pipelined_frames();
+    result |= test_oversized_second_frame();
+    result |= test_oversized_first_frame();
+    //The bridge keeps serving after dropping misbehaving clients
+    result |= test_pipelined_frames();
+
+    kill(bridge, SIGTERM);
+    waitpid(bridge, NULL, 0);
+
+    printf("%s\n", (0 == result) ? "PASSED" : "FAILED");
+    return (0 == result) ? 0 : 1;
+}
+
+/**
+* @}
+*/
@@ -0,0 +1,290 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file optiga_comms_tcp_test.c
+*
+* \brief   Test of the optiga comms over TCP backend against a scripted bridge on the loopback interface.
+*
+*          gcc -Ioptiga/include -Ipal/linux pal/linux/test/optiga_comms_tcp_test.c
+*              pal/linux/optiga_comms_tcp.c optiga/common/Util.c -lpthread -o optiga_comms_tcp_test
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "optiga/comms/optiga_comms.h"
+#include "optiga/ifx_i2c/ifx_i2c_config.h"
+#include "optiga/common/Util.h"
+#include "optiga_comms_tcp.h"
+
+#define TEST_CHECK(condition)                                               \
+    if (!(condition))                                                       \
+    {                                                                       \
+        printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition);       \
+        return -1;                                                          \
+    }
+
+/// @cond hidden
+typedef struct test_instance
+{
+    optiga_comms_t comms;
+    volatile host_lib_status_t event;
+    uint8_t request[8];
+    uint16_t request_length;
+    uint8_t response[8];
+    uint16_t response_length;
+} test_instance_t;
+
+static optiga_comms_tcp_context_t test_context = OPTIGA_COMMS_TCP_CONTEXT("127.0.0.1", 0);
+static test_instance_t test_instances[2];
+static int test_listener = -1;
+
+static void test_event_handler(void * upper_layer_ctx, host_lib_status_t event)
+{
+    ((test_instance_t *)upper_layer_ctx)->event = event;
+}
+
+static int test_wait(test_instance_t * p_instance)
+{
+    int attempt;
+
+    for (attempt = 0; (attempt < 500) && (OPTIGA_COMMS_BUSY == p_instance->event); attempt++)
+    {
+        usleep(2000);
+    }
+    return (OPTIGA_COMMS_BUSY == p_instance->event) ? -1 : 0;
+}
+
+static int test_recv_all(int socket_fd, uint8_t * p_buffer, uint16_t length)
+{
+    ssize_t received;
+
+    while (0 != length)
+    {
+        received = recv(socket_fd, p_buffer, length, 0);
+        if (received <= 0)
+        {
+            return -1;
+        }
+        p_buffer += received;
+        length -= (uint16_t)received;
+    }
+    return 0;
+}
+
+//Receives a request frame of the bridge side and returns its tag
+static int test_bridge_recv(int socket_fd, uint8_t * p_payload, uint16_t * p_length)
+{
+    uint8_t header[OPTIGA_COMMS_TCP_HEADER_LENGTH];
+
+    if ((0 != test_recv_all(socket_fd, header, sizeof(header))) ||
+        (OPTIGA_COMMS_TCP_TYPE_TRANSCEIVE != header[2]))
+    {
+        return -1;
+    }
+    *p_length = Utility_GetUint16(&header[6]);
+    if (0 != test_recv_all(socket_fd, p_payload, *p_length))
+    {
+        return -1;
+    }
+    return Utility_GetUint16(&header[0]);
+}
+
+static void test_bridge_send(int socket_fd, uint16_t tag, uint16_t length, const uint8_t * p_payload)
+{
+    uint8_t frame[OPTIGA_COMMS_TCP_HEADER_LENGTH + 16];
+
+    Utility_SetUint16(&frame[0], tag);
+    frame[2] = OPTIGA_COMMS_TCP_TYPE_TRANSCEIVE;
+    frame[3] = 0x00;
+    Utility_SetUint16(&frame[4], OPTIGA_COMMS_SUCCESS);
+    Utility_SetUint16(&frame[6], length);
+    //Header only, if the payload is NULL
+    if (NULL != p_payload)
+    {
+        memcpy(&frame[OPTIGA_COMMS_TCP_HEADER_LENGTH], p_payload, length);
+    }
+    send(socket_fd, frame, OPTIGA_COMMS_TCP_HEADER_LENGTH + ((NULL != p_payload) ? length : 0), 0);
+}
+
+static int test_open(void)
+{
+    struct sockaddr_in address;
+    socklen_t address_length = sizeof(address);
+    uint8_t index;
+
+    test_listener = socket(AF_INET, SOCK_STREAM, 0);
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    TEST_CHECK(0 == bind(test_listener, (struct sockaddr *)&address, sizeof(address)));
+    TEST_CHECK(0 == listen(test_listener, 1));
+    TEST_CHECK(0 == getsockname(test_listener, (struct sockaddr *)&address, &address_length));
+    test_context.port = ntohs(address.sin_port);
+
+    for (index = 0; index < 2; index++)
+    {
+        memset(&test_instances[index], 0, sizeof(test_instances[index]));
+        test_instances[index].comms.comms_ctx = &test_context;
+        test_instances[index].comms.upper_layer_ctx = &test_instances[index];
+        test_instances[index].comms.upper_layer_handler = test_event_handler;
+        test_instances[index].event = OPTIGA_COMMS_BUSY;
+        TEST_CHECK(OPTIGA_COMMS_SUCCESS == optiga_comms_open(&test_instances[index].comms));
+        TEST_CHECK(OPTIGA_COMMS_SUCCESS == test_instances[index].event);
+    }
+    return 0;
+}
+
+static int test_transceive(test_instance_t * p_instance, uint8_t apdu, uint16_t response_length)
+{
+    p_instance->request[0] = apdu;
+    p_instance->request_length = 1;
+    p_instance->response_length = response_length;
+    p_instance->event = OPTIGA_COMMS_BUSY;
+    TEST_CHECK(OPTIGA_COMMS_SUCCESS == optiga_comms_transceive(&p_instance->comms, p_instance->request,
+                                                               &p_instance->request_length,
+                                                               p_instance->response,
+                                                               &p_instance->response_length));
+    return 0;
+}
+
+//Responses answered out of order are matched to their submitter by the tag
+static int test_out_of_order(int bridge)
+{
+    uint8_t payload[OPTIGA_COMMS_TCP_MAX_APDU_LENGTH];
+    uint16_t length;
+    int tag_0;
+    int tag_1;
+
+    TEST_CHECK(0 == test_transceive(&test_instances[0], 0xA0, sizeof(test_instances[0].response)));
+    TEST_CHECK(0 == test_transceive(&test_instances[1], 0xB0, sizeof(test_instances[1].response)));
+    tag_0 = test_bridge_recv(bridge, payload, &length);
+    TEST_CHECK((tag_0 >= 0) && (1 == length) && (0xA0 == payload[0]));
+    tag_1 = test_bridge_recv(bridge, payload, &length);
+    TEST_CHECK((tag_1 >= 0) && (1 == length) && (0xB0 == payload[0]) && (tag_0 != tag_1));
+
+    payload[0] = 0xB1;
+    payload[1] = 0xB2;
+    test_bridge_send(bridge, (uint16_t)tag_1, 2, payload);
+    payload[0] = 0xA1;
+    test_bridge_send(bridge, (uint16_t)tag_0, 1, payload);
+
+    TEST_CHECK((0 == test_wait(&test_instances[0])) && (0 == test_wait(&test_instances[1])));
+    TEST_CHECK(OPTIGA_COMMS_SUCCESS == test_instances[0].event);
+    TEST_CHECK((1 == test_instances[0].response_length) && (0xA1 == test_instances[0].response[0]));
+    TEST_CHECK(OPTIGA_COMMS_SUCCESS == test_instances[1].event);
+    TEST_CHECK((2 == test_instances[1].response_length) && (0xB2 == test_instances[1].response[1]));
+    return 0;
+}
+
+//A response longer than the buffer of the caller is reported as memory error, the stream stays in sync
+static int test_response_too_long(int bridge)
+{
+    uint8_t payload[OPTIGA_COMMS_TCP_MAX_APDU_LENGTH];
+    uint16_t length;
+    int tag;
+
+    TEST_CHECK(0 == test_transceive(&test_instances[0], 0xC0, 2));
+    tag = test_bridge_recv(bridge, payload, &length);
+    TEST_CHECK(tag >= 0);
+    memset(payload, 0xCC, 4);
+    test_bridge_send(bridge, (uint16_t)tag, 4, payload);
+
+    TEST_CHECK(0 == test_wait(&test_instances[0]));
+    TEST_CHECK(IFX_I2C_STACK_MEM_ERROR == test_instances[0].event);
+    TEST_CHECK(0 == test_instances[0].response_length);
+    return 0;
+}
+
+//A header announcing more than an APDU fails the outstanding requests instead of being trusted
+static int test_oversized_header(int bridge)
+{
+    uint8_t payload[OPTIGA_COMMS_TCP_MAX_APDU_LENGTH];
+    uint16_t length;
+    int tag;
+
+    TEST_CHECK(0 == test_transceive(&test_instances[0], 0xD0, sizeof(test_instances[0].response)));
+    tag = test_bridge_recv(bridge, payload, &length);
+    TEST_CHECK(tag >= 0);
+    test_bridge_send(bridge, (uint16_t)tag, OPTIGA_COMMS_TCP_MAX_APDU_LENGTH + 1, NULL);
+
+    TEST_CHECK(0 == test_wait(&test_instances[0]));
+    TEST_CHECK(OPTIGA_COMMS_ERROR == test_instances[0].event);
+    return 0;
+}
+/// @endcond
+
+int main(void)
+{
+    int result = 0;
+    int bridge = -1;
+
+    do
+    {
+        if (0 != test_open())
+        {
+            result = -1;
+            break;
+        }
+        bridge = accept(test_listener, NULL, NULL);
+        if (bridge < 0)
+        {
+            result = -1;
+            break;
+        }
+
+        result |= test_out_of_order(bridge);
+        result |= test_response_too_long(bridge);
+        result |= test_oversized_header(bridge);
+
+        optiga_comms_close(&test_instances[0].comms);
+        optiga_comms_close(&test_instances[1].comms);
+    } while (0);
+
+    if (bridge >= 0)
+    {
+        close(bridge);
+    }
+    if (test_listener >= 0)
+    {
+        close(test_listener);
+    }
+
+    printf("%s\n", (0 == result) ? "PASSED" : "FAILED");
+    return (0 == result) ? 0 : 1;
+}
+
+/**
+* @}
+*/
@@ -0,0 +1,224 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file pal_os_event_pollable_test.c
+*
+* \brief   Test of the pollable mode of the os event handling, driven by the poll() loop of the application.
+*          An operation submitted like optiga_comms_transceive() runs a chain of timer events and completes
+*          only from pal_linux_event_process, which never blocks. Watched file descriptors are served from the
+*          loop of the application and never from the wait of the library (pal_os_event_process).
+*
+*          gcc -DPAL_OS_HAS_EVENT_INIT -DPAL_OS_HAS_EVENT_PROCESS -Ioptiga/include -Ipal/linux pal/linux/test/pal_os_event_pollable_test.c
+*              pal/linux/pal_os_event.c pal/linux/pal_os_timer.c -lpthread -lrt -o pal_os_event_pollable_test
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <stdio.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "optiga/pal/pal_os_event.h"
+#include "pal_linux.h"
+
+#define TEST_CHECK(condition)                                               \
+    if (!(condition))                                                       \
+    {                                                                       \
+        printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition);       \
+        return -1;                                                          \
+    }
+
+/// Timer events of the simulated operation, like the status polls of the I2C stack
+#define TEST_STEPS          (4)
+
+/// Interval of the timer events in microseconds
+#define TEST_INTERVAL_US    (2000)
+
+/// @cond hidden
+static int test_in_process;
+static int test_outside_process;
+static int test_steps;
+static int test_completed;
+static int test_handled;
+
+static uint32_t test_now_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((now.tv_sec * 1000000) + (now.tv_nsec / 1000));
+}
+
+// Step of the submitted operation, the last one calls the completion handler of the application
+static void test_step_callback(void * p_ctx)
+{
+    if (!test_in_process)
+    {
+        test_outside_process++;
+    }
+    if (++test_steps < TEST_STEPS)
+    {
+        pal_os_event_register_callback_oneshot(test_step_callback, p_ctx, TEST_INTERVAL_US);
+        return;
+    }
+    ((void (*)(void))p_ctx)();
+}
+
+static void test_complete(void)
+{
+    test_completed++;
+}
+
+static void test_fd_handler(void * p_ctx, int32_t fd, uint32_t events)
+{
+    char byte;
+
+    (void)p_ctx;
+    (void)events;
+    if (!test_in_process)
+    {
+        test_outside_process++;
+    }
+    if (1 == read(fd, &byte, 1))
+    {
+        test_handled++;
+    }
+}
+
+// Event loop of the application: waits on the file descriptor and runs the library work when it is readable
+static int test_loop(int (*p_done)(void), uint32_t timeout_ms)
+{
+    struct pollfd poll_fd;
+    uint32_t start_ms = test_now_us() / 1000;
+
+    poll_fd.fd = pal_linux_event_get_fd();
+    poll_fd.events = POLLIN;
+    while (!p_done() && ((test_now_us() / 1000) - start_ms < timeout_ms))
+    {
+        poll_fd.revents = 0;
+        if ((1 == poll(&poll_fd, 1, 100)) && (poll_fd.revents & POLLIN))
+        {
+            test_in_process = 1;
+            pal_linux_event_process();
+            test_in_process = 0;
+        }
+    }
+    return p_done();
+}
+
+static int test_operation_done(void)
+{
+    return test_completed;
+}
+
+static int test_fd_done(void)
+{
+    return test_handled;
+}
+
+int test_operation_from_poll_loop(void)
+{
+    uint32_t start_us = test_now_us();
+
+    test_steps = 0;
+    test_completed = 0;
+    pal_os_event_register_callback_oneshot(test_step_callback, (void *)test_complete, TEST_INTERVAL_US);
+
+    // Nothing runs without the loop of the application
+    usleep(3 * TEST_INTERVAL_US);
+    TEST_CHECK(0 == test_steps);
+
+    TEST_CHECK(test_loop(test_operation_done, 1000));
+    TEST_CHECK(TEST_STEPS == test_steps);
+    TEST_CHECK(1 == test_completed);
+    TEST_CHECK((test_now_us() - start_us) >= (TEST_STEPS * TEST_INTERVAL_US));
+    return 0;
+}
+
+int test_process_never_blocks(void)
+{
+    uint32_t start_us;
+
+    test_steps = TEST_STEPS;
+    pal_os_event_register_callback_oneshot(test_step_callback, (void *)test_complete, 200000);
+    start_us = test_now_us();
+    TEST_CHECK(0 == pal_linux_event_process());
+    TEST_CHECK((test_now_us() - start_us) < 5000);
+
+    // A registration without callback replaces the pending one
+    pal_os_event_register_callback_oneshot(NULL, NULL, 0);
+    return 0;
+}
+
+int test_watched_fd(void)
+{
+    int pipe_fd[2];
+
+    TEST_CHECK(0 == pipe(pipe_fd));
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_linux_event_watch_fd(pipe_fd[0], POLLIN, test_fd_handler, NULL));
+    TEST_CHECK(1 == write(pipe_fd[1], "x", 1));
+
+    // The wait of the library serves only the timer
+    pal_os_event_process();
+    TEST_CHECK(0 == test_handled);
+
+    TEST_CHECK(test_loop(test_fd_done, 1000));
+    TEST_CHECK(1 == test_handled);
+
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_linux_event_watch_fd(pipe_fd[0], 0, NULL, NULL));
+    close(pipe_fd[0]);
+    close(pipe_fd[1]);
+    return 0;
+}
+/// @endcond
+
+int main(void)
+{
+    int status = 0;
+
+    if ((PAL_STATUS_SUCCESS != pal_linux_event_set_pollable()) || (PAL_STATUS_SUCCESS != pal_os_event_init()) ||
+        (pal_linux_event_get_fd() < 0))
+    {
+        printf("FAILED to enable the pollable mode\n");
+        return 1;
+    }
+
+    status |= test_operation_from_poll_loop();
+    status |= test_process_never_blocks();
+    status |= test_watched_fd();
+    status |= (0 == test_outside_process) ? 0 : -1;
+
+    printf("%s\n", (0 == status) ? "PASSED" : "FAILED");
+    return (0 == status) ? 0 : 1;
+}
+
+/**
+* @}
+*/
@@ -0,0 +1,224 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file pal_os_event_uring_test.c
+*
+* \brief   Test of the io_uring os event backend: re-registrations before the expiry, stop and registration from
+*          the callback. The test runs once on io_uring and once in a child process in which io_uring_setup is
+*          blocked by seccomp, i.e. on the POSIX timer fallback. A third child blocks io_uring_enter while a
+*          registration is pending, the ring fails and the registration fires on the POSIX timer.
+*
+*          gcc -DPAL_OS_HAS_EVENT_INIT -Ioptiga/include -Ipal/linux pal/linux/test/pal_os_event_uring_test.c
+*              pal/linux/pal_os_event_uring.c pal/linux/pal_linux_uring.c pal/linux/pal_os_timer.c
+*              -lpthread -lrt -o pal_os_event_uring_test
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <stdio.h>
+#include <stddef.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+
+#include "optiga/pal/pal_os_event.h"
+#include "pal_linux.h"
+
+#define TEST_CHECK(condition)                                               \
+    if (!(condition))                                                       \
+    {                                                                       \
+        printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition);       \
+        return -1;                                                          \
+    }
+
+/// More re-registrations than the backend has timeout slots
+#define TEST_REGISTRATIONS  (40)
+
+/// @cond hidden
+pal_status_t pal_os_event_stop(void);
+
+static volatile int test_fired[TEST_REGISTRATIONS];
+static volatile int test_chain;
+
+static void test_callback(void * p_ctx)
+{
+    test_fired[(int)(intptr_t)p_ctx]++;
+}
+
+static void test_chain_callback(void * p_ctx)
+{
+    (void)p_ctx;
+    if (++test_chain < 3)
+    {
+        pal_os_event_register_callback_oneshot(test_chain_callback, NULL, 1000);
+    }
+}
+
+// Makes io_uring_setup fail with ENOSYS, as on kernels without io_uring
+static int test_block_uring(void)
+{
+    struct sock_filter filter[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, nr)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_io_uring_setup, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | ENOSYS),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW),
+    };
+    struct sock_fprog program = {sizeof(filter) / sizeof(filter[0]), filter};
+
+    TEST_CHECK(0 == prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0));
+    TEST_CHECK(0 == prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &program));
+    return 0;
+}
+
+// Makes io_uring_enter of all threads fail with EPERM, as if the ring failed
+static int test_fail_uring(void)
+{
+    struct sock_filter filter[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, nr)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_io_uring_enter, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | EPERM),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW),
+    };
+    struct sock_fprog program = {sizeof(filter) / sizeof(filter[0]), filter};
+
+    TEST_CHECK(0 == prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0));
+    // The ring thread is running already, the filter is synchronised to it
+    TEST_CHECK(0 == syscall(__NR_seccomp, SECCOMP_SET_MODE_FILTER, SECCOMP_FILTER_FLAG_TSYNC, &program));
+    return 0;
+}
+
+static int test_ring_failure(void)
+{
+    if (PAL_STATUS_SUCCESS != pal_linux_uring_init())
+    {
+        // Nothing to fail without io_uring
+        return 0;
+    }
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_os_event_init());
+    pal_os_event_register_callback_oneshot(test_callback, (void *)0, 30000);
+    TEST_CHECK(0 == test_fail_uring());
+
+    // The replaced timeout cannot be cancelled any more, it expires and the ring fails on the next io_uring_enter.
+    // The pending timeout completes with the error and the registration continues on the POSIX timer.
+    pal_os_event_register_callback_oneshot(test_callback, (void *)1, 80000);
+    usleep(50000);
+    TEST_CHECK(PAL_STATUS_FAILURE == pal_linux_uring_init());
+    TEST_CHECK(0 == test_fired[1]);
+    usleep(80000);
+    TEST_CHECK(0 == test_fired[0]);
+    TEST_CHECK(1 == test_fired[1]);
+
+    // The following registrations are served by the POSIX timer
+    pal_os_event_register_callback_oneshot(test_callback, (void *)2, 10000);
+    usleep(40000);
+    TEST_CHECK(1 == test_fired[2]);
+    return 0;
+}
+
+static int test_run(void)
+{
+    int index;
+
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_os_event_init());
+
+    // Only the last of the re-registrations fires, none of them runs out of timeout slots
+    for (index = 0; index < TEST_REGISTRATIONS; index++)
+    {
+        pal_os_event_register_callback_oneshot(test_callback, (void *)(intptr_t)index, 50000);
+    }
+    usleep(150000);
+    for (index = 0; index < (TEST_REGISTRATIONS - 1); index++)
+    {
+        TEST_CHECK(0 == test_fired[index]);
+    }
+    TEST_CHECK(1 == test_fired[TEST_REGISTRATIONS - 1]);
+
+    // A stopped registration does not fire
+    pal_os_event_register_callback_oneshot(test_callback, (void *)0, 20000);
+    pal_os_event_stop();
+    usleep(60000);
+    TEST_CHECK(0 == test_fired[0]);
+
+    // Registrations from the callback
+    pal_os_event_register_callback_oneshot(test_chain_callback, NULL, 1000);
+    usleep(60000);
+    TEST_CHECK(3 == test_chain);
+    return 0;
+}
+/// @endcond
+
+int main(void)
+{
+    pid_t child;
+    int status = -1;
+
+    child = fork();
+    if (0 == child)
+    {
+        _exit(((0 == test_block_uring()) && (0 == test_run())) ? 0 : 1);
+    }
+    waitpid(child, &status, 0);
+    if (!WIFEXITED(status) || (0 != WEXITSTATUS(status)))
+    {
+        printf("FAILED on the timer fallback\n");
+        return 1;
+    }
+
+    // Forked before the ring of this process is set up, the child sets up its own
+    child = fork();
+    if (0 == child)
+    {
+        _exit((0 == test_ring_failure()) ? 0 : 1);
+    }
+    waitpid(child, &status, 0);
+    if (!WIFEXITED(status) || (0 != WEXITSTATUS(status)))
+    {
+        printf("FAILED on the failure of the ring\n");
+        return 1;
+    }
+
+    if (PAL_STATUS_SUCCESS != pal_linux_uring_init())
+    {
+        printf("io_uring not available, only the timer fallback is tested\n");
+    }
+    else if (0 != test_run())
+    {
+        return 1;
+    }
+    printf("PASSED\n");
+    return 0;
+}
+
+/**
+* @}
+*/
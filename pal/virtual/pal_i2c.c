@@ -0,0 +1,817 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file
+*
+* \brief This file implements the platform abstraction layer APIs for I2C with a simulated OPTIGA on the virtual clock.
+*
+* The simulated OPTIGA implements the registers of the ifx i2c physical layer, acknowledges the data link layer frames
+* and answers every command after its execution time. GetDataObject and SetDataObject work on data objects held in
+* memory, every other command gets a successful response without data. Responses longer than a frame are chained, the
+* next fragment is sent once the master acknowledges the previous one. Every transfer completes after its time on the
+* bus at the negotiated bit rate.
+*
+* Only one OPTIGA on one bus is simulated. #ifx_i2c_set_slave_address is not supported, it waits for the transfer
+* without running the scheduler.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <string.h>
+#include "optiga/pal/pal_i2c.h"
+#include "optiga/ifx_i2c/ifx_i2c_config.h"
+#include "pal_virtual.h"
+
+/// @cond hidden
+#define OPTIGA_REG_DATA                 (0x80)
+#define OPTIGA_REG_DATA_REG_LEN         (0x81)
+#define OPTIGA_REG_I2C_STATE            (0x82)
+#define OPTIGA_REG_MAX_SCL_FREQU        (0x84)
+#define OPTIGA_REG_SOFT_RESET           (0x88)
+
+#define OPTIGA_I2C_STATE_BUSY           (0x80)
+#define OPTIGA_I2C_STATE_RESPONSE_READY (0x40)
+#define OPTIGA_I2C_STATE_SOFT_RESET     (0x08)
+
+#define OPTIGA_FCTR_CONTROL_FRAME       (0x80)
+#define OPTIGA_FCTR_SEQCTR_OFFSET       (5)
+#define OPTIGA_FCTR_SEQCTR_MASK         (0x03)
+#define OPTIGA_FCTR_FRNR_OFFSET         (2)
+#define OPTIGA_FCTR_NR_MASK             (0x03)
+#define OPTIGA_SEQCTR_NACK              (0x01)
+#define OPTIGA_SEQCTR_RESYNC            (0x02)
+
+#define OPTIGA_PCTR_CHAIN_MASK          (0x07)
+#define OPTIGA_PCTR_CHAIN_NO            (0x00)
+#define OPTIGA_PCTR_CHAIN_FIRST         (0x01)
+#define OPTIGA_PCTR_CHAIN_INTERMEDIATE  (0x02)
+#define OPTIGA_PCTR_CHAIN_LAST          (0x04)
+
+#define OPTIGA_CMD_GET_DATA             (0x01)
+#define OPTIGA_CMD_SET_DATA             (0x02)
+#define OPTIGA_PARAM_METADATA           (0x01)
+#define OPTIGA_PARAM_ERASE_AND_WRITE    (0x40)
+#define OPTIGA_OID_MAX_COMMS_SIZE       (0xE0C6)
+#define OPTIGA_OID_ERROR_CODES          (0xF1C2)
+///Maximum comms buffer size reported, as the OPTIGA Trust X does
+#define OPTIGA_MAX_COMMS_SIZE           (0x0615)
+
+///Status of a failed command, the error code is read from #OPTIGA_OID_ERROR_CODES
+#define OPTIGA_STATUS_ERROR             (0xFF)
+#define OPTIGA_ERROR_INVALID_OID        (0x01)
+#define OPTIGA_ERROR_INVALID_PARAM      (0x03)
+#define OPTIGA_ERROR_INVALID_LENGTH     (0x04)
+#define OPTIGA_ERROR_OUT_OF_BOUND       (0x08)
+
+///Metadata TLV and the tags of the maximum and used size
+#define OPTIGA_TAG_METADATA             (0x20)
+#define OPTIGA_TAG_MAX_SIZE             (0xC4)
+#define OPTIGA_TAG_USED_SIZE            (0xC5)
+
+///Length of the header of a command and of a response
+#define OPTIGA_APDU_HEADER_LENGTH       (4)
+
+///Maximum length of a command (APDU) received in fragments
+#define OPTIGA_APDU_MAX_LENGTH          (1600)
+///Bits on the bus per byte, including the acknowledge bit
+#define OPTIGA_BITS_PER_BYTE            (9)
+
+typedef struct pal_virtual_optiga_object {
+	/// Object identifier, 0 if the entry is free
+	uint16_t oid;
+	/// Bytes written
+	uint16_t used_size;
+	uint8_t data[PAL_VIRTUAL_OPTIGA_OBJECT_SIZE];
+}pal_virtual_optiga_object_t;
+
+typedef struct pal_virtual_optiga {
+	/// Levels of the Vdd and reset pins
+	uint8_t pin_level[2];
+	/// Virtual time at which the chip was put in reset
+	uint64_t reset_low_start_us;
+	/// Register addressed by the last write of a register address
+	uint8_t selected_register;
+	/// Frame size agreed with the master
+	uint16_t data_reg_len;
+	/// Number of the last data frame sent
+	uint8_t tx_frame_nr;
+	/// Number of the last data frame received
+	uint8_t rx_frame_nr;
+	/// Frame to be read from the DATA register, length 0 if none
+	uint8_t response_frame[PAL_VIRTUAL_OPTIGA_FRAME_SIZE];
+	uint16_t response_frame_len;
+	/// Last data frame sent, sent again on a NACK
+	uint8_t last_data_frame[PAL_VIRTUAL_OPTIGA_FRAME_SIZE];
+	uint16_t last_data_frame_len;
+	/// Command received so far
+	uint8_t apdu[OPTIGA_APDU_MAX_LENGTH];
+	uint16_t apdu_len;
+	/// Response of the last command and the length sent in fragments so far
+	uint8_t response[OPTIGA_APDU_MAX_LENGTH];
+	uint16_t response_len;
+	uint16_t response_sent;
+	/// Error code of the last failed command
+	uint8_t last_error;
+	/// Data objects, written by SetDataObject. They keep their content over resets
+	pal_virtual_optiga_object_t objects[PAL_VIRTUAL_OPTIGA_OBJECTS];
+	/// The command is complete, its execution starts once the acknowledge is read
+	uint8_t command_received;
+	/// The command is executed
+	uint8_t executing;
+	/// Incremented by every reset, completions of commands started before are dropped
+	uint32_t generation;
+	/// Configuration
+	uint32_t exec_time_us;
+	uint8_t mute;
+	uint32_t nack_count;
+	uint32_t crc_error_count;
+	/// Counters
+	pal_virtual_optiga_stats_t stats;
+}pal_virtual_optiga_t;
+
+typedef struct pal_virtual_i2c_transfer {
+	/// Context of the transfer
+	pal_i2c_t * p_i2c_context;
+	/// Event reported at the end of the transfer
+	uint16_t event;
+}pal_virtual_i2c_transfer_t;
+
+static pal_virtual_optiga_t optiga;
+static pal_virtual_i2c_transfer_t transfer;
+static uint16_t bitrate_khz = 100;
+
+//CRC of the data link layer frames, as calculated by the ifx i2c data link layer
+static uint16_t pal_virtual_optiga_crc(const uint8_t * p_data, uint16_t length)
+{
+	uint16_t crc = 0;
+	uint16_t wh1;
+	uint16_t wh2;
+	uint16_t wh3;
+	uint16_t wh4;
+	uint16_t index;
+
+	for (index = 0; index < length; index++)
+	{
+		wh1 = (crc ^ p_data[index]) & 0xFF;
+		wh2 = wh1 & 0x0F;
+		wh3 = ((uint16_t)(wh2 << 4)) ^ wh1;
+		wh4 = wh3 >> 4;
+		crc = ((uint16_t)((((uint16_t)((((uint16_t)(wh3 << 1)) ^ wh4) << 4)) ^ wh2) << 3)) ^ wh4 ^ (crc >> 8);
+	}
+	return crc;
+}
+
+//Prepares a frame with the given header and payload to be read from the DATA register
+static void pal_virtual_optiga_queue_frame(uint8_t fctr, const uint8_t * p_payload, uint16_t payload_len)
+{
+	uint16_t crc;
+
+	optiga.response_frame[0] = fctr;
+	optiga.response_frame[1] = (uint8_t)(payload_len >> 8);
+	optiga.response_frame[2] = (uint8_t)payload_len;
+	if (0 != payload_len)
+	{
+		memcpy(&optiga.response_frame[3], p_payload, payload_len);
+	}
+	crc = pal_virtual_optiga_crc(optiga.response_frame, 3 + payload_len);
+	optiga.response_frame[3 + payload_len] = (uint8_t)(crc >> 8);
+	optiga.response_frame[4 + payload_len] = (uint8_t)crc;
+	optiga.response_frame_len = DL_HEADER_SIZE + payload_len;
+}
+
+static void pal_virtual_optiga_reset(void)
+{
+	optiga.selected_register = OPTIGA_REG_I2C_STATE;
+	optiga.data_reg_len = PAL_VIRTUAL_OPTIGA_FRAME_SIZE;
+	optiga.tx_frame_nr = OPTIGA_FCTR_NR_MASK;
+	optiga.rx_frame_nr = OPTIGA_FCTR_NR_MASK;
+	optiga.response_frame_len = 0;
+	optiga.last_data_frame_len = 0;
+	optiga.apdu_len = 0;
+	optiga.response_len = 0;
+	optiga.response_sent = 0;
+	optiga.command_received = FALSE;
+	optiga.executing = FALSE;
+	optiga.generation++;
+}
+
+//Finds a data object, or the free entry for it if create is set
+static pal_virtual_optiga_object_t * pal_virtual_optiga_find_object(uint16_t oid, uint8_t create)
+{
+	pal_virtual_optiga_object_t * p_free = NULL;
+	uint8_t index;
+
+	for (index = 0; index < PAL_VIRTUAL_OPTIGA_OBJECTS; index++)
+	{
+		if (oid == optiga.objects[index].oid)
+		{
+			return &optiga.objects[index];
+		}
+		if ((NULL == p_free) && (0 == optiga.objects[index].oid))
+		{
+			p_free = &optiga.objects[index];
+		}
+	}
+	if ((!create) || (NULL == p_free))
+	{
+		return NULL;
+	}
+	p_free->oid = oid;
+	p_free->used_size = 0;
+	return p_free;
+}
+
+//Reads data or metadata of an object, an object never written is empty
+static uint8_t pal_virtual_optiga_get_data(const uint8_t * p_payload, uint16_t payload_len, uint8_t param,
+                                           uint8_t * p_data, uint16_t * p_data_len)
+{
+	pal_virtual_optiga_object_t * p_object;
+	uint16_t oid;
+	uint16_t used_size;
+	uint16_t offset = 0;
+	uint16_t length = OPTIGA_MAX_COMMS_SIZE;
+
+	if ((2 != payload_len) && (6 != payload_len))
+	{
+		return OPTIGA_ERROR_INVALID_LENGTH;
+	}
+	oid = (uint16_t)((p_payload[0] << 8) | p_payload[1]);
+	if (6 == payload_len)
+	{
+		offset = (uint16_t)((p_payload[2] << 8) | p_payload[3]);
+		length = (uint16_t)((p_payload[4] << 8) | p_payload[5]);
+	}
+
+	if (OPTIGA_OID_MAX_COMMS_SIZE == oid)
+	{
+		p_data[0] = (uint8_t)(OPTIGA_MAX_COMMS_SIZE >> 8);
+		p_data[1] = (uint8_t)OPTIGA_MAX_COMMS_SIZE;
+		*p_data_len = 2;
+		return 0;
+	}
+	if (OPTIGA_OID_ERROR_CODES == oid)
+	{
+		p_data[0] = optiga.last_error;
+		*p_data_len = 1;
+		return 0;
+	}
+
+	p_object = pal_virtual_optiga_find_object(oid, FALSE);
+	used_size = (NULL != p_object) ? p_object->used_size : 0;
+	if (OPTIGA_PARAM_METADATA == param)
+	{
+		p_data[0] = OPTIGA_TAG_METADATA;
+		p_data[1] = 8;
+		p_data[2] = OPTIGA_TAG_MAX_SIZE;
+		p_data[3] = 2;
+		p_data[4] = (uint8_t)(PAL_VIRTUAL_OPTIGA_OBJECT_SIZE >> 8);
+		p_data[5] = (uint8_t)PAL_VIRTUAL_OPTIGA_OBJECT_SIZE;
+		p_data[6] = OPTIGA_TAG_USED_SIZE;
+		p_data[7] = 2;
+		p_data[8] = (uint8_t)(used_size >> 8);
+		p_data[9] = (uint8_t)used_size;
+		*p_data_len = 10;
+		return 0;
+	}
+	if (0 != param)
+	{
+		return OPTIGA_ERROR_INVALID_PARAM;
+	}
+	if (offset >= used_size)
+	{
+		return OPTIGA_ERROR_OUT_OF_BOUND;
+	}
+	if (length > (used_size - offset))
+	{
+		length = used_size - offset;
+	}
+	if (length > OPTIGA_MAX_COMMS_SIZE)
+	{
+		length = OPTIGA_MAX_COMMS_SIZE;
+	}
+	memcpy(p_data, &p_object->data[offset], length);
+	*p_data_len = length;
+	return 0;
+}
+
+//Writes data of an object, metadata is accepted and ignored
+static uint8_t pal_virtual_optiga_set_data(const uint8_t * p_payload, uint16_t payload_len, uint8_t param)
+{
+	pal_virtual_optiga_object_t * p_object;
+	uint16_t offset;
+	uint16_t length;
+
+	if (OPTIGA_PARAM_METADATA == param)
+	{
+		return 0;
+	}
+	if ((0 != param) && (OPTIGA_PARAM_ERASE_AND_WRITE != param))
+	{
+		return OPTIGA_ERROR_INVALID_PARAM;
+	}
+	if (payload_len < 4)
+	{
+		return OPTIGA_ERROR_INVALID_LENGTH;
+	}
+	offset = (uint16_t)((p_payload[2] << 8) | p_payload[3]);
+	length = payload_len - 4;
+	if ((offset + length) > PAL_VIRTUAL_OPTIGA_OBJECT_SIZE)
+	{
+		return OPTIGA_ERROR_OUT_OF_BOUND;
+	}
+	p_object = pal_virtual_optiga_find_object((uint16_t)((p_payload[0] << 8) | p_payload[1]), TRUE);
+	if (NULL == p_object)
+	{
+		return OPTIGA_ERROR_INVALID_OID;
+	}
+	if (OPTIGA_PARAM_ERASE_AND_WRITE == param)
+	{
+		memset(p_object->data, 0x00, sizeof(p_object->data));
+		p_object->used_size = 0;
+	}
+	memcpy(&p_object->data[offset], &p_payload[4], length);
+	if ((offset + length) > p_object->used_size)
+	{
+		p_object->used_size = offset + length;
+	}
+	return 0;
+}
+
+//Sends the next fragment of the response, chained if the response does not fit into a frame
+static void pal_virtual_optiga_send_fragment(void)
+{
+	uint8_t payload[PAL_VIRTUAL_OPTIGA_FRAME_SIZE];
+	uint16_t fragment_size = optiga.data_reg_len - (DL_HEADER_SIZE + 1);
+	uint16_t remaining = optiga.response_len - optiga.response_sent;
+
+	if (remaining <= fragment_size)
+	{
+		payload[0] = (0 == optiga.response_sent) ? OPTIGA_PCTR_CHAIN_NO : OPTIGA_PCTR_CHAIN_LAST;
+		fragment_size = remaining;
+	}
+	else
+	{
+		payload[0] = (0 == optiga.response_sent) ? OPTIGA_PCTR_CHAIN_FIRST : OPTIGA_PCTR_CHAIN_INTERMEDIATE;
+	}
+	memcpy(&payload[1], &optiga.response[optiga.response_sent], fragment_size);
+	optiga.response_sent += fragment_size;
+
+	optiga.tx_frame_nr = (optiga.tx_frame_nr + 1) & OPTIGA_FCTR_NR_MASK;
+	pal_virtual_optiga_queue_frame((uint8_t)((optiga.tx_frame_nr << OPTIGA_FCTR_FRNR_OFFSET) | optiga.rx_frame_nr),
+	                               payload, fragment_size + 1);
+	memcpy(optiga.last_data_frame, optiga.response_frame, optiga.response_frame_len);
+	optiga.last_data_frame_len = optiga.response_frame_len;
+}
+
+//Answers the command executed: status, undefined byte, length and data
+static void pal_virtual_optiga_command_done(void * p_generation)
+{
+	uint8_t cmd = optiga.apdu[0] & 0x7F;
+	uint8_t param = optiga.apdu[1];
+	uint16_t payload_len = optiga.apdu_len - OPTIGA_APDU_HEADER_LENGTH;
+	uint16_t data_len = 0;
+	uint8_t error = 0;
+
+	if ((uint32_t)(uintptr_t)p_generation != optiga.generation)
+	{
+		return;
+	}
+	if ((optiga.apdu_len < OPTIGA_APDU_HEADER_LENGTH) ||
+	    (payload_len != (uint16_t)((optiga.apdu[2] << 8) | optiga.apdu[3])))
+	{
+		error = OPTIGA_ERROR_INVALID_LENGTH;
+	}
+	else if (OPTIGA_CMD_GET_DATA == cmd)
+	{
+		error = pal_virtual_optiga_get_data(&optiga.apdu[OPTIGA_APDU_HEADER_LENGTH], payload_len, param,
+		                                    &optiga.response[OPTIGA_APDU_HEADER_LENGTH], &data_len);
+	}
+	else if (OPTIGA_CMD_SET_DATA == cmd)
+	{
+		error = pal_virtual_optiga_set_data(&optiga.apdu[OPTIGA_APDU_HEADER_LENGTH], payload_len, param);
+	}
+
+	if (0 != error)
+	{
+		optiga.last_error = error;
+		data_len = 0;
+	}
+	optiga.response[0] = (0 != error) ? OPTIGA_STATUS_ERROR : 0x00;
+	optiga.response[1] = 0x00;
+	optiga.response[2] = (uint8_t)(data_len >> 8);
+	optiga.response[3] = (uint8_t)data_len;
+	optiga.response_len = OPTIGA_APDU_HEADER_LENGTH + data_len;
+	optiga.response_sent = 0;
+	optiga.executing = FALSE;
+	pal_virtual_optiga_send_fragment();
+}
+
+//Handles a frame written to the DATA register
+static void pal_virtual_optiga_receive_frame(const uint8_t * p_frame, uint16_t frame_len)
+{
+	uint8_t fctr;
+	uint8_t seqctr;
+	uint8_t frame_nr;
+	uint8_t chaining;
+	uint16_t payload_len;
+
+	if ((frame_len < DL_HEADER_SIZE) ||
+	    (pal_virtual_optiga_crc(p_frame, frame_len - 2) != (uint16_t)((p_frame[frame_len - 2] << 8) | p_frame[frame_len - 1])))
+	{
+		//The master sends the frame again once its polling times out
+		return;
+	}
+	fctr = p_frame[0];
+	seqctr = (fctr >> OPTIGA_FCTR_SEQCTR_OFFSET) & OPTIGA_FCTR_SEQCTR_MASK;
+	payload_len = (uint16_t)((p_frame[1] << 8) | p_frame[2]);
+
+	if (fctr & OPTIGA_FCTR_CONTROL_FRAME)
+	{
+		if (OPTIGA_SEQCTR_RESYNC == seqctr)
+		{
+			optiga.tx_frame_nr = OPTIGA_FCTR_NR_MASK;
+			optiga.rx_frame_nr = OPTIGA_FCTR_NR_MASK;
+			optiga.response_frame_len = 0;
+			optiga.apdu_len = 0;
+			optiga.response_len = 0;
+			optiga.response_sent = 0;
+			optiga.command_received = FALSE;
+			optiga.executing = FALSE;
+			optiga.generation++;
+		}
+		else if ((OPTIGA_SEQCTR_NACK == seqctr) && (0 != optiga.last_data_frame_len))
+		{
+			memcpy(optiga.response_frame, optiga.last_data_frame, optiga.last_data_frame_len);
+			optiga.response_frame_len = optiga.last_data_frame_len;
+		}
+		//The acknowledge of a fragment of the response asks for the next one
+		else if ((0 == seqctr) && ((fctr & OPTIGA_FCTR_NR_MASK) == optiga.tx_frame_nr) &&
+		         (optiga.response_sent < optiga.response_len))
+		{
+			pal_virtual_optiga_send_fragment();
+		}
+		return;
+	}
+
+	frame_nr = (fctr >> OPTIGA_FCTR_FRNR_OFFSET) & OPTIGA_FCTR_NR_MASK;
+	//A repeated frame is only acknowledged again
+	if ((frame_nr != optiga.rx_frame_nr) && (0 != payload_len))
+	{
+		optiga.rx_frame_nr = frame_nr;
+		chaining = p_frame[3] & OPTIGA_PCTR_CHAIN_MASK;
+		if ((OPTIGA_PCTR_CHAIN_NO == chaining) || (OPTIGA_PCTR_CHAIN_FIRST == chaining))
+		{
+			optiga.apdu_len = 0;
+		}
+		if ((optiga.apdu_len + payload_len - 1) <= OPTIGA_APDU_MAX_LENGTH)
+		{
+			memcpy(&optiga.apdu[optiga.apdu_len], &p_frame[4], payload_len - 1);
+			optiga.apdu_len += payload_len - 1;
+		}
+		if ((OPTIGA_PCTR_CHAIN_NO == chaining) || (OPTIGA_PCTR_CHAIN_LAST == chaining))
+		{
+			optiga.command_received = TRUE;
+			optiga.stats.commands++;
+		}
+	}
+	pal_virtual_optiga_queue_frame((uint8_t)(OPTIGA_FCTR_CONTROL_FRAME | optiga.rx_frame_nr), NULL, 0);
+}
+
+//Reads the selected register into the buffer of the master
+static void pal_virtual_optiga_read_register(uint8_t * p_data, uint16_t length)
+{
+	uint8_t reg[4] = {0};
+	const uint8_t * p_reg = reg;
+	uint16_t reg_len = sizeof(reg);
+
+	switch (optiga.selected_register)
+	{
+		case OPTIGA_REG_I2C_STATE:
+		{
+			optiga.stats.status_polls++;
+			reg[0] = OPTIGA_I2C_STATE_SOFT_RESET;
+			reg[0] |= (0 != optiga.response_frame_len) ? OPTIGA_I2C_STATE_RESPONSE_READY : 0;
+			reg[0] |= optiga.executing ? OPTIGA_I2C_STATE_BUSY : 0;
+			reg[2] = (uint8_t)(optiga.response_frame_len >> 8);
+			reg[3] = (uint8_t)optiga.response_frame_len;
+		}
+		break;
+		case OPTIGA_REG_MAX_SCL_FREQU:
+		{
+			reg[2] = (uint8_t)(PAL_VIRTUAL_OPTIGA_FREQUENCY >> 8);
+			reg[3] = (uint8_t)PAL_VIRTUAL_OPTIGA_FREQUENCY;
+		}
+		break;
+		case OPTIGA_REG_DATA_REG_LEN:
+		{
+			reg[0] = (uint8_t)(optiga.data_reg_len >> 8);
+			reg[1] = (uint8_t)optiga.data_reg_len;
+			reg_len = 2;
+		}
+		break;
+		case OPTIGA_REG_DATA:
+		{
+			p_reg = optiga.response_frame;
+			reg_len = optiga.response_frame_len;
+			optiga.response_frame_len = 0;
+			//The command is executed once the master has its acknowledge
+			if (optiga.command_received)
+			{
+				optiga.command_received = FALSE;
+				optiga.executing = TRUE;
+				if (!optiga.mute)
+				{
+					//lint --e{534} suppress "The queue only overflows if the simulation leaks events"
+					pal_virtual_schedule(pal_virtual_optiga_command_done, (void *)(uintptr_t)optiga.generation,
+					                     optiga.exec_time_us);
+				}
+			}
+		}
+		break;
+		default:
+			break;
+	}
+	memset(p_data, 0x00, length);
+	memcpy(p_data, p_reg, (reg_len < length) ? reg_len : length);
+	//Only the copy read by the master is corrupted, a NACK gets the frame sent before
+	if ((OPTIGA_REG_DATA == optiga.selected_register) && (0 != optiga.crc_error_count) &&
+	    (reg_len >= DL_HEADER_SIZE) && (reg_len <= length))
+	{
+		optiga.crc_error_count--;
+		optiga.stats.crc_errors++;
+		p_data[reg_len - 1] ^= 0xFF;
+	}
+}
+
+//Writes a register address and, if given, the register content
+static void pal_virtual_optiga_write_register(const uint8_t * p_data, uint16_t length)
+{
+	optiga.selected_register = p_data[0];
+	if (1 == length)
+	{
+		return;
+	}
+	switch (optiga.selected_register)
+	{
+		case OPTIGA_REG_DATA:
+		{
+			pal_virtual_optiga_receive_frame(&p_data[1], length - 1);
+		}
+		break;
+		case OPTIGA_REG_DATA_REG_LEN:
+		{
+			if (3 == length)
+			{
+				optiga.data_reg_len = (uint16_t)((p_data[1] << 8) | p_data[2]);
+				if (optiga.data_reg_len > PAL_VIRTUAL_OPTIGA_FRAME_SIZE)
+				{
+					optiga.data_reg_len = PAL_VIRTUAL_OPTIGA_FRAME_SIZE;
+				}
+			}
+		}
+		break;
+		case OPTIGA_REG_SOFT_RESET:
+		{
+			optiga.stats.resets++;
+			pal_virtual_optiga_reset();
+		}
+		break;
+		default:
+			//I2C mode and base address are accepted, the simulation does not depend on them
+			break;
+	}
+}
+
+static void pal_virtual_i2c_transfer_done(void * p_transfer)
+{
+	pal_virtual_i2c_transfer_t * p_local_transfer = (pal_virtual_i2c_transfer_t *)p_transfer;
+	pal_i2c_t * p_i2c_context = p_local_transfer->p_i2c_context;
+
+	if (NULL != p_i2c_context->upper_layer_event_handler)
+	{
+		//lint --e{611} suppress "The upper layer handler is stored as void pointer in the pal i2c context"
+		((app_event_handler_t)(p_i2c_context->upper_layer_event_handler))(p_i2c_context->upper_layer_ctx,
+		                                                                  p_local_transfer->event);
+	}
+}
+
+//Starts a transfer, which completes after its time on the bus
+static pal_status_t pal_virtual_i2c_transfer(pal_i2c_t * p_i2c_context, uint8_t * p_data, uint16_t length,
+                                             uint8_t is_read)
+{
+	uint32_t bytes = 1;
+	uint8_t powered = optiga.pin_level[PAL_VIRTUAL_OPTIGA_PIN_VDD] && optiga.pin_level[PAL_VIRTUAL_OPTIGA_PIN_RESET];
+
+	transfer.p_i2c_context = p_i2c_context;
+	if ((!powered) || (0 != optiga.nack_count))
+	{
+		//Only the address byte is on the bus
+		if (0 != optiga.nack_count)
+		{
+			optiga.nack_count--;
+		}
+		optiga.stats.nacks++;
+		transfer.event = PAL_I2C_EVENT_ERROR;
+	}
+	else
+	{
+		bytes += length;
+		if (is_read)
+		{
+			pal_virtual_optiga_read_register(p_data, length);
+		}
+		else
+		{
+			pal_virtual_optiga_write_register(p_data, length);
+		}
+		transfer.event = PAL_I2C_EVENT_SUCCESS;
+	}
+	return pal_virtual_schedule(pal_virtual_i2c_transfer_done, &transfer,
+	                            (bytes * OPTIGA_BITS_PER_BYTE * 1000 + bitrate_khz - 1) / bitrate_khz);
+}
+/// @endcond
+
+/**
+* Powers the simulated OPTIGA up with its defaults and clears its counters.
+*
+* \param[in] exec_time_us          Execution time of every command in microseconds
+*/
+void pal_virtual_optiga_init(uint32_t exec_time_us)
+{
+	memset(&optiga, 0x00, sizeof(optiga));
+	optiga.pin_level[PAL_VIRTUAL_OPTIGA_PIN_VDD] = TRUE;
+	optiga.pin_level[PAL_VIRTUAL_OPTIGA_PIN_RESET] = TRUE;
+	optiga.exec_time_us = exec_time_us;
+	pal_virtual_optiga_reset();
+	bitrate_khz = 100;
+}
+
+/**
+* Makes the simulated OPTIGA receive commands but never answer them.
+*
+* \param[in] mute                  TRUE to stop answering, FALSE to answer again
+*/
+void pal_virtual_optiga_set_mute(uint8_t mute)
+{
+	optiga.mute = mute;
+}
+
+/**
+* Makes the simulated OPTIGA not acknowledge the next transfers.
+*
+* \param[in] count                 Number of transfers not acknowledged
+*/
+void pal_virtual_optiga_set_nack(uint32_t count)
+{
+	optiga.nack_count = count;
+}
+
+/**
+* Makes the simulated OPTIGA send the next frames with a wrong CRC.
+*
+* \param[in] count                 Number of frames sent with a wrong CRC
+*/
+void pal_virtual_optiga_set_crc_error(uint32_t count)
+{
+	optiga.crc_error_count = count;
+}
+
+/**
+* Gets the counters and the frame size of the simulated OPTIGA.
+*
+* \param[out] p_stats              Pointer to #pal_virtual_optiga_stats_t to be filled
+*/
+void pal_virtual_optiga_get_stats(pal_virtual_optiga_stats_t * p_stats)
+{
+	*p_stats = optiga.stats;
+	p_stats->data_reg_len = optiga.data_reg_len;
+}
+
+/**
+* Sets a pin of the simulated OPTIGA. The chip is reset while a pin is low and starts once both are high again.
+*
+* \param[in] pin                   #PAL_VIRTUAL_OPTIGA_PIN_VDD or #PAL_VIRTUAL_OPTIGA_PIN_RESET
+* \param[in] level                 TRUE for high, FALSE for low
+*/
+void pal_virtual_optiga_set_pin(uint8_t pin, uint8_t level)
+{
+	uint8_t was_powered = optiga.pin_level[PAL_VIRTUAL_OPTIGA_PIN_VDD] && optiga.pin_level[PAL_VIRTUAL_OPTIGA_PIN_RESET];
+	uint8_t powered;
+
+	optiga.pin_level[pin] = level ? TRUE : FALSE;
+	powered = optiga.pin_level[PAL_VIRTUAL_OPTIGA_PIN_VDD] && optiga.pin_level[PAL_VIRTUAL_OPTIGA_PIN_RESET];
+	if (was_powered && !powered)
+	{
+		optiga.reset_low_start_us = pal_virtual_get_time_us();
+		pal_virtual_optiga_reset();
+	}
+	else if (!was_powered && powered)
+	{
+		optiga.stats.resets++;
+		optiga.stats.reset_low_time_us = pal_virtual_get_time_us() - optiga.reset_low_start_us;
+		pal_virtual_optiga_reset();
+	}
+}
+
+/**
+* Initializes the I2C master, nothing to do for the simulated bus.
+*
+* \param[in] p_i2c_context   Pal i2c context
+*
+* \retval  #PAL_STATUS_SUCCESS  Always
+*/
+//lint --e{715} suppress "There is only one simulated bus"
+pal_status_t pal_i2c_init(const pal_i2c_t* p_i2c_context)
+{
+	return PAL_STATUS_SUCCESS;
+}
+
+/**
+* Deinitializes the I2C master, nothing to do for the simulated bus.
+*
+* \param[in] p_i2c_context   Pal i2c context
+*
+* \retval  #PAL_STATUS_SUCCESS  Always
+*/
+//lint --e{715} suppress "There is only one simulated bus"
+pal_status_t pal_i2c_deinit(const pal_i2c_t* p_i2c_context)
+{
+	return PAL_STATUS_SUCCESS;
+}
+
+/**
+* Writes to the simulated OPTIGA. The upper layer handler is invoked once the bytes are on the bus.
+*
+* \param[in] p_i2c_context   Pal i2c context
+* \param[in] p_data          Register address followed by the register content
+* \param[in] length          Number of bytes
+*
+* \retval  #PAL_STATUS_SUCCESS  Transfer is started
+* \retval  #PAL_STATUS_FAILURE  The event queue is full
+*/
+pal_status_t pal_i2c_write(pal_i2c_t* p_i2c_context, uint8_t* p_data, uint16_t length)
+{
+	return pal_virtual_i2c_transfer(p_i2c_context, p_data, length, FALSE);
+}
+
+/**
+* Reads the register addressed by the last write from the simulated OPTIGA.
+* The upper layer handler is invoked once the bytes are on the bus.
+*
+* \param[in] p_i2c_context   Pal i2c context
+* \param[in] p_data          Buffer for the register content
+* \param[in] length          Number of bytes
+*
+* \retval  #PAL_STATUS_SUCCESS  Transfer is started
+* \retval  #PAL_STATUS_FAILURE  The event queue is full
+*/
+pal_status_t pal_i2c_read(pal_i2c_t* p_i2c_context, uint8_t* p_data, uint16_t length)
+{
+	return pal_virtual_i2c_transfer(p_i2c_context, p_data, length, TRUE);
+}
+
+/**
+* Sets the bit rate of the simulated bus, which gives the time of the transfers.
+*
+* \param[in] p_i2c_context   Pal i2c context
+* \param[in] bitrate         Bit rate in KHz, at most #PAL_VIRTUAL_OPTIGA_FREQUENCY
+*
+* \retval  #PAL_STATUS_SUCCESS  Bit rate is set
+* \retval  #PAL_STATUS_FAILURE  Bit rate is not supported by the simulated OPTIGA
+*/
+//lint --e{715} suppress "There is only one simulated bus"
+pal_status_t pal_i2c_set_bitrate(const pal_i2c_t* p_i2c_context, uint16_t bitrate)
+{
+	if ((0 == bitrate) || (bitrate > PAL_VIRTUAL_OPTIGA_FREQUENCY))
+	{
+		return PAL_STATUS_FAILURE;
+	}
+	bitrate_khz = bitrate;
+	return PAL_STATUS_SUCCESS;
+}
+
+/**
+* @}
+*/
@@ -0,0 +1,242 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file
+*
+* \brief This file implements the platform abstraction layer APIs for os event/scheduler on a virtual clock.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <string.h>
+#include "pal_virtual.h"
+
+/// @cond hidden
+typedef struct pal_virtual_event {
+	/// Virtual time at which the event is due
+	uint64_t due_us;
+	/// Callback function
+	register_callback func;
+	/// Callback arguments
+	void * args;
+	/// Event is the one shot timer of the library
+	uint8_t is_oneshot;
+}pal_virtual_event_t;
+
+/// Pending events, sorted by due time, events with the same due time in the order they were scheduled
+static pal_virtual_event_t events[PAL_VIRTUAL_MAX_EVENTS];
+static uint8_t event_count = 0;
+static uint64_t virtual_time_us = 0;
+static volatile uint8_t stop_requested = FALSE;
+
+static pal_status_t pal_virtual_insert(register_callback callback, void * callback_args, uint32_t time_us,
+                                       uint8_t is_oneshot)
+{
+	uint8_t index;
+	uint64_t due_us = virtual_time_us + time_us;
+
+	if (PAL_VIRTUAL_MAX_EVENTS == event_count)
+	{
+		return PAL_STATUS_FAILURE;
+	}
+
+	//Behind all events due earlier or at the same time
+	index = event_count;
+	while ((index > 0) && (events[index - 1].due_us > due_us))
+	{
+		events[index] = events[index - 1];
+		index--;
+	}
+	events[index].due_us = due_us;
+	events[index].func = callback;
+	events[index].args = callback_args;
+	events[index].is_oneshot = is_oneshot;
+	event_count++;
+
+	return PAL_STATUS_SUCCESS;
+}
+
+static void pal_virtual_remove(uint8_t index)
+{
+	event_count--;
+	memmove(&events[index], &events[index + 1], (event_count - index) * sizeof(events[0]));
+}
+
+//Removes the first event and runs it at its due time
+static void pal_virtual_run_first(void)
+{
+	pal_virtual_event_t event = events[0];
+
+	pal_virtual_remove(0);
+	virtual_time_us = event.due_us;
+	if (NULL != event.func)
+	{
+		event.func(event.args);
+	}
+}
+/// @endcond
+
+/**
+* Resets the virtual clock to 0 and drops all pending events.
+*/
+void pal_virtual_init(void)
+{
+	event_count = 0;
+	virtual_time_us = 0;
+	stop_requested = FALSE;
+}
+
+/**
+* Returns the virtual time in microseconds.
+*/
+uint64_t pal_virtual_get_time_us(void)
+{
+	return virtual_time_us;
+}
+
+/**
+* Schedules a callback of the simulation after time_us of virtual time.
+*
+* \param[in] callback              Callback function pointer
+* \param[in] callback_args         Callback arguments
+* \param[in] time_us               Virtual time in microseconds till the callback
+*
+* \retval  #PAL_STATUS_SUCCESS  Event is scheduled
+* \retval  #PAL_STATUS_FAILURE  The event queue is full
+*/
+pal_status_t pal_virtual_schedule(register_callback callback, void * callback_args, uint32_t time_us)
+{
+	return pal_virtual_insert(callback, callback_args, time_us, FALSE);
+}
+
+/**
+* Advances the virtual clock to the next event and runs it.
+*
+* \retval  TRUE   An event is run
+* \retval  FALSE  No event is pending
+*/
+uint8_t pal_virtual_step(void)
+{
+	if (0 == event_count)
+	{
+		return FALSE;
+	}
+	pal_virtual_run_first();
+	return TRUE;
+}
+
+/**
+* Runs the events due within time_us and advances the virtual clock by time_us, or till #pal_virtual_stop is called.
+*
+* \param[in] time_us               Virtual time in microseconds to run
+*
+* \return Number of events run
+*/
+uint32_t pal_virtual_run_for(uint32_t time_us)
+{
+	uint64_t end_us = virtual_time_us + time_us;
+	uint32_t run_count = 0;
+
+	stop_requested = FALSE;
+	while ((0 != event_count) && (events[0].due_us <= end_us))
+	{
+		pal_virtual_run_first();
+		run_count++;
+		if (stop_requested)
+		{
+			stop_requested = FALSE;
+			return run_count;
+		}
+	}
+	//A run_for nested in an event may have moved the clock past end_us already, time never goes back
+	if (virtual_time_us < end_us)
+	{
+		virtual_time_us = end_us;
+	}
+	return run_count;
+}
+
+/**
+* Makes the running #pal_virtual_run_for return after the current event.
+*/
+void pal_virtual_stop(void)
+{
+	stop_requested = TRUE;
+}
+
+/**
+* Platform specific event init function.
+*
+* \retval  #PAL_STATUS_SUCCESS  Always, the scheduler needs no resources
+*/
+pal_status_t pal_os_event_init(void)
+{
+	return PAL_STATUS_SUCCESS;
+}
+
+/**
+* Platform specific event call back registration function to trigger once when timer expires.
+* <br>
+*
+* <b>API Details:</b>
+*         This function registers the callback function supplied by the caller, replacing a pending one.<br>
+*         The callback is run by the scheduler once the virtual clock reaches the supplied time interval.<br>
+*
+* \param[in] callback              Callback function pointer
+* \param[in] callback_args         Callback arguments
+* \param[in] time_us               time in micro seconds to trigger the call back
+*
+*/
+void pal_os_event_register_callback_oneshot(register_callback callback,
+                                            void* callback_args,
+                                            uint32_t time_us)
+{
+	uint8_t index;
+
+	for (index = 0; index < event_count; index++)
+	{
+		if (events[index].is_oneshot)
+		{
+			pal_virtual_remove(index);
+			break;
+		}
+	}
+	//lint --e{534} suppress "The slot of the removed timer is free, the queue is only full if the simulation leaks events"
+	pal_virtual_insert(callback, callback_args, time_us, TRUE);
+}
+
+/**
+* Runs the next event, invoked by the library while it waits for OPTIGA.
+* The virtual clock jumps to the event, so waiting takes no wall clock time.
+*/
+void pal_os_event_process(void)
+{
+	//lint --e{534} suppress "Nothing to do if no event is pending"
+	pal_virtual_step();
+}
+
+/**
+* @}
+*/
@@ -0,0 +1,67 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file pal_os_lock.c
+*
+* \brief   This file implements the platform abstraction layer APIs for os locks with the virtual time PAL.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include "optiga/pal/pal_os_lock.h"
+
+/// @cond hidden
+static uint8_t pal_os_lock_held = 0;
+/// @endcond
+
+/**
+ * Acquires the lock. The virtual time PAL is single threaded, so a held lock is never released by waiting.
+ *
+ * \retval  #PAL_STATUS_SUCCESS  Lock is acquired
+ * \retval  #PAL_STATUS_FAILURE  Lock is already held
+ */
+pal_status_t pal_os_lock_acquire(void)
+{
+    pal_status_t return_status = PAL_STATUS_FAILURE;
+
+    if (0 == pal_os_lock_held)
+    {
+        pal_os_lock_held = 1;
+        return_status = PAL_STATUS_SUCCESS;
+    }
+    return return_status;
+}
+
+/**
+ * Releases the lock
+ */
+void pal_os_lock_release(void)
+{
+    pal_os_lock_held = 0;
+}
+
+/**
+* @}
+*/
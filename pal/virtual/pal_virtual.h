@@ -0,0 +1,287 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file pal_virtual.h
+*
+* \brief   This file provides the configuration and prototype declarations of the virtual time PAL.
+*
+* The virtual time PAL implements pal_os_event, pal_os_timer and pal_os_lock on a discrete event scheduler
+* with a simulated clock, for single threaded tests and benchmarks together with a simulated OPTIGA and network:
+* - Time only advances when the scheduler runs the next due event, waits take no wall clock time.
+* - Events with the same due time run in the order they were scheduled, so the results are deterministic.
+*
+* Build it with PAL_OS_HAS_EVENT_PROCESS defined, so the library runs the scheduler while it waits for OPTIGA.
+*
+* pal_i2c.c, pal_gpio.c and pal_ifx_i2c_config.c simulate one OPTIGA behind the ifx i2c protocol stack, with the
+* registers, the data link and transport layer frames and a configurable execution time of the commands.
+* pal_virtual_udp.c simulates a UDP link with latency and loss between a client and a server, e.g. for the
+* application transport of the DTLS client.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#ifndef _PAL_VIRTUAL_H_
+#define _PAL_VIRTUAL_H_
+
+#include "optiga/pal/pal.h"
+#include "optiga/pal/pal_os_event.h"
+
+/// Maximum number of pending events, including the one shot timer of the library
+#ifndef PAL_VIRTUAL_MAX_EVENTS
+#define PAL_VIRTUAL_MAX_EVENTS  (32)
+#endif
+
+/// Frame size (DATA_REG_LEN) accepted by the simulated OPTIGA at most
+#define PAL_VIRTUAL_OPTIGA_FRAME_SIZE   (0x0115)
+
+/// Data objects the simulated OPTIGA holds at most, created by their first write
+#ifndef PAL_VIRTUAL_OPTIGA_OBJECTS
+#define PAL_VIRTUAL_OPTIGA_OBJECTS      (4)
+#endif
+
+/// Size of a data object of the simulated OPTIGA, as of a certificate data object of the OPTIGA Trust X
+#define PAL_VIRTUAL_OPTIGA_OBJECT_SIZE  (1728)
+
+/// Maximum SCL frequency of the simulated OPTIGA in KHz
+#define PAL_VIRTUAL_OPTIGA_FREQUENCY    (400)
+
+/// Pins of the simulated OPTIGA, in the pal_gpio_t of pal_ifx_i2c_config.c
+#define PAL_VIRTUAL_OPTIGA_PIN_VDD      (0)
+#define PAL_VIRTUAL_OPTIGA_PIN_RESET    (1)
+
+/// Maximum length of a datagram of the simulated UDP link
+#ifndef PAL_VIRTUAL_UDP_MTU
+#define PAL_VIRTUAL_UDP_MTU     (1500)
+#endif
+
+/// Number of datagrams in flight or held by the receivers of a simulated UDP link
+#ifndef PAL_VIRTUAL_UDP_SLOTS
+#define PAL_VIRTUAL_UDP_SLOTS   (8)
+#endif
+
+/// Endpoints of a simulated UDP link
+#define PAL_VIRTUAL_UDP_CLIENT  (0)
+#define PAL_VIRTUAL_UDP_SERVER  (1)
+
+/** @brief Counters of the simulated OPTIGA since #pal_virtual_optiga_init and its frame size */
+typedef struct pal_virtual_optiga_stats
+{
+    /// Commands (APDUs) received completely
+    uint32_t commands;
+    /// Reads of the I2C_STATE register
+    uint32_t status_polls;
+    /// Transfers not acknowledged
+    uint32_t nacks;
+    /// Frames sent with a wrong CRC
+    uint32_t crc_errors;
+    /// Cold, warm and soft resets
+    uint32_t resets;
+    /// Virtual time the chip was held in reset by the last cold or warm reset, in microseconds
+    uint64_t reset_low_time_us;
+    /// Frame size (DATA_REG_LEN) agreed with the master
+    uint16_t data_reg_len;
+} pal_virtual_optiga_stats_t;
+
+/** @brief Receives a datagram at an endpoint of a simulated UDP link, held till #pal_virtual_udp_release */
+typedef void (*pal_virtual_udp_receive_t)(void * p_ctx, const uint8_t * p_data, uint16_t length);
+
+/** @brief Datagram of a simulated UDP link */
+typedef struct pal_virtual_udp_datagram
+{
+    /// Link of the datagram
+    struct pal_virtual_udp * p_udp;
+    /// Endpoint the datagram is sent to
+    uint8_t endpoint;
+    /// Slot is in flight or held by the receiver
+    uint8_t in_use;
+    /// Length of the datagram
+    uint16_t length;
+    /// Datagram
+    uint8_t data[PAL_VIRTUAL_UDP_MTU];
+} pal_virtual_udp_datagram_t;
+
+/** @brief Simulated UDP link between a client and a server, set up by #pal_virtual_udp_init */
+typedef struct pal_virtual_udp
+{
+    /// One way latency in microseconds
+    uint32_t latency_us;
+    /// Bit n drops the n-th datagram sent to the endpoint (n < 32), per endpoint
+    uint32_t drop_mask[2];
+    /// Receivers of the endpoints, NULL drops the datagrams
+    pal_virtual_udp_receive_t receive[2];
+    /// Contexts of the receivers
+    void * receive_ctx[2];
+    /// Datagrams sent to the endpoints, including dropped ones
+    uint32_t sent[2];
+    /// Datagrams dropped on the way to the endpoints
+    uint32_t dropped[2];
+    /// An endpoint waits in #pal_virtual_udp_wait
+    uint8_t waiting[2];
+    /// A datagram arrived at the endpoint during #pal_virtual_udp_wait
+    uint8_t arrived[2];
+    /// Datagrams in flight or held by the receivers
+    pal_virtual_udp_datagram_t slots[PAL_VIRTUAL_UDP_SLOTS];
+} pal_virtual_udp_t;
+
+/**
+ * @brief Resets the virtual clock to 0 and drops all pending events, e.g. before each test case.
+ */
+void pal_virtual_init(void);
+
+/**
+ * @brief Returns the virtual time in microseconds.
+ */
+uint64_t pal_virtual_get_time_us(void);
+
+/**
+ * @brief Schedules a callback after time_us of virtual time, e.g. the completion of a simulated I2C transfer
+ *        or the arrival of a simulated datagram. Unlike the one shot timer of the library, the events of the
+ *        simulation do not replace each other.
+ *
+ * \param[in] callback              Callback function pointer
+ * \param[in] callback_args         Callback arguments
+ * \param[in] time_us               Virtual time in microseconds till the callback
+ *
+ * \retval  #PAL_STATUS_SUCCESS  Event is scheduled
+ * \retval  #PAL_STATUS_FAILURE  #PAL_VIRTUAL_MAX_EVENTS events are pending
+ */
+pal_status_t pal_virtual_schedule(register_callback callback, void * callback_args, uint32_t time_us);
+
+/**
+ * @brief Advances the virtual clock to the next event and runs it.
+ *
+ * \retval  TRUE   An event is run
+ * \retval  FALSE  No event is pending, the clock is not changed
+ */
+uint8_t pal_virtual_step(void);
+
+/**
+ * @brief Runs the events due within time_us and advances the virtual clock by time_us.
+ *
+ * Returns earlier, at the virtual time of the event, if an event calls #pal_virtual_stop. Used for waits, e.g. in
+ * the poll function of an application transport till the next datagram arrives or the timeout expires.
+ *
+ * \param[in] time_us               Virtual time in microseconds to run
+ *
+ * \return Number of events run
+ */
+uint32_t pal_virtual_run_for(uint32_t time_us);
+
+/**
+ * @brief Makes the running #pal_virtual_run_for return after the current event.
+ */
+void pal_virtual_stop(void);
+
+/**
+ * @brief Powers the simulated OPTIGA up with its defaults and clears its counters, e.g. before each test case.
+ *
+ * \param[in] exec_time_us          Execution time of every command in microseconds
+ */
+void pal_virtual_optiga_init(uint32_t exec_time_us);
+
+/**
+ * @brief Makes the simulated OPTIGA receive commands but never answer them, e.g. to test the exit timeout.
+ *
+ * \param[in] mute                  TRUE to stop answering, FALSE to answer again
+ */
+void pal_virtual_optiga_set_mute(uint8_t mute);
+
+/**
+ * @brief Makes the simulated OPTIGA not acknowledge the next transfers, e.g. to test the polling limits.
+ *
+ * \param[in] count                 Number of transfers not acknowledged
+ */
+void pal_virtual_optiga_set_nack(uint32_t count);
+
+/**
+ * @brief Makes the simulated OPTIGA send the next frames with a wrong CRC, e.g. to test the adaptive frame size.
+ *        A data frame is sent again correctly on the NACK of the master, an acknowledge on the retransmission.
+ *
+ * \param[in] count                 Number of frames sent with a wrong CRC
+ */
+void pal_virtual_optiga_set_crc_error(uint32_t count);
+
+/**
+ * @brief Gets the counters and the frame size of the simulated OPTIGA.
+ *
+ * \param[out] p_stats              Pointer to #pal_virtual_optiga_stats_t to be filled
+ */
+void pal_virtual_optiga_get_stats(pal_virtual_optiga_stats_t * p_stats);
+
+/**
+ * @brief Sets a pin of the simulated OPTIGA, invoked by pal_gpio.
+ *
+ * \param[in] pin                   #PAL_VIRTUAL_OPTIGA_PIN_VDD or #PAL_VIRTUAL_OPTIGA_PIN_RESET
+ * \param[in] level                 TRUE for high, FALSE for low
+ */
+void pal_virtual_optiga_set_pin(uint8_t pin, uint8_t level);
+
+/**
+ * @brief Sets up a simulated UDP link without loss and without receivers.
+ *
+ * \param[out] p_udp                Pointer to #pal_virtual_udp_t
+ * \param[in]  latency_us           One way latency in microseconds
+ */
+void pal_virtual_udp_init(pal_virtual_udp_t * p_udp, uint32_t latency_us);
+
+/**
+ * @brief Sends a datagram to an endpoint, it arrives after the latency of the link unless it is dropped.
+ *
+ * \param[in,out] p_udp             Pointer to #pal_virtual_udp_t
+ * \param[in]     endpoint          #PAL_VIRTUAL_UDP_CLIENT or #PAL_VIRTUAL_UDP_SERVER
+ * \param[in]     p_data            Datagram, copied
+ * \param[in]     length            Length of the datagram
+ *
+ * \retval  #PAL_STATUS_SUCCESS  Datagram is sent or dropped by the link
+ * \retval  #PAL_STATUS_FAILURE  Datagram is longer than #PAL_VIRTUAL_UDP_MTU or all slots are in use
+ */
+pal_status_t pal_virtual_udp_send(pal_virtual_udp_t * p_udp, uint8_t endpoint, const uint8_t * p_data,
+                                  uint16_t length);
+
+/**
+ * @brief Runs the virtual clock till a datagram arrives at the endpoint or the timeout expires.
+ *
+ * \param[in,out] p_udp             Pointer to #pal_virtual_udp_t
+ * \param[in]     endpoint          #PAL_VIRTUAL_UDP_CLIENT or #PAL_VIRTUAL_UDP_SERVER
+ * \param[in]     timeout_us        Virtual time in microseconds to wait at most
+ *
+ * \retval  TRUE   A datagram arrived, the clock is at its arrival
+ * \retval  FALSE  The timeout expired
+ */
+uint8_t pal_virtual_udp_wait(pal_virtual_udp_t * p_udp, uint8_t endpoint, uint32_t timeout_us);
+
+/**
+ * @brief Gives a received datagram back to the link.
+ *
+ * \param[in,out] p_udp             Pointer to #pal_virtual_udp_t
+ * \param[in]     p_data            Datagram passed to the receiver
+ */
+void pal_virtual_udp_release(pal_virtual_udp_t * p_udp, const uint8_t * p_data);
+
+#endif /* _PAL_VIRTUAL_H_ */
+
+/**
+* @}
+*/
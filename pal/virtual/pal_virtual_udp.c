@@ -0,0 +1,171 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file
+*
+* \brief This file implements a simulated UDP link on the virtual clock.
+*
+* A datagram arrives at its endpoint after the latency of the link, unless the drop mask of the endpoint selects it.
+* The receiver gets the datagram by reference and gives it back with #pal_virtual_udp_release, e.g. the release
+* callback of an application transport (#eDTLS_12_APP_HWCRYPTO) whose receiver feeds it with OCP_FeedDatagram().
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <string.h>
+#include "pal_virtual.h"
+
+/// @cond hidden
+//Hands a datagram to the receiver of its endpoint
+static void pal_virtual_udp_arrive(void * p_slot)
+{
+	pal_virtual_udp_datagram_t * p_datagram = (pal_virtual_udp_datagram_t *)p_slot;
+	pal_virtual_udp_t * p_udp = p_datagram->p_udp;
+	uint8_t endpoint = p_datagram->endpoint;
+
+	if (NULL == p_udp->receive[endpoint])
+	{
+		p_datagram->in_use = FALSE;
+		return;
+	}
+	p_udp->receive[endpoint](p_udp->receive_ctx[endpoint], p_datagram->data, p_datagram->length);
+	if (p_udp->waiting[endpoint])
+	{
+		p_udp->arrived[endpoint] = TRUE;
+		pal_virtual_stop();
+	}
+}
+/// @endcond
+
+/**
+* Sets up a simulated UDP link without loss and without receivers.
+*
+* \param[out] p_udp                Pointer to #pal_virtual_udp_t
+* \param[in]  latency_us           One way latency in microseconds
+*/
+void pal_virtual_udp_init(pal_virtual_udp_t * p_udp, uint32_t latency_us)
+{
+	memset(p_udp, 0x00, sizeof(*p_udp));
+	p_udp->latency_us = latency_us;
+}
+
+/**
+* Sends a datagram to an endpoint. It arrives after the latency of the link, unless the drop mask of the endpoint
+* selects it.
+*
+* \param[in,out] p_udp             Pointer to #pal_virtual_udp_t
+* \param[in]     endpoint          #PAL_VIRTUAL_UDP_CLIENT or #PAL_VIRTUAL_UDP_SERVER
+* \param[in]     p_data            Datagram, copied
+* \param[in]     length            Length of the datagram
+*
+* \retval  #PAL_STATUS_SUCCESS  Datagram is sent or dropped by the link
+* \retval  #PAL_STATUS_FAILURE  Datagram is longer than #PAL_VIRTUAL_UDP_MTU or all slots are in use
+*/
+pal_status_t pal_virtual_udp_send(pal_virtual_udp_t * p_udp, uint8_t endpoint, const uint8_t * p_data,
+                                  uint16_t length)
+{
+	uint32_t number = p_udp->sent[endpoint];
+	uint8_t index;
+
+	if (length > PAL_VIRTUAL_UDP_MTU)
+	{
+		return PAL_STATUS_FAILURE;
+	}
+
+	p_udp->sent[endpoint]++;
+	if ((number < 32) && (p_udp->drop_mask[endpoint] & ((uint32_t)1 << number)))
+	{
+		p_udp->dropped[endpoint]++;
+		return PAL_STATUS_SUCCESS;
+	}
+
+	for (index = 0; index < PAL_VIRTUAL_UDP_SLOTS; index++)
+	{
+		if (!p_udp->slots[index].in_use)
+		{
+			break;
+		}
+	}
+	if (PAL_VIRTUAL_UDP_SLOTS == index)
+	{
+		return PAL_STATUS_FAILURE;
+	}
+
+	p_udp->slots[index].p_udp = p_udp;
+	p_udp->slots[index].endpoint = endpoint;
+	p_udp->slots[index].length = length;
+	memcpy(p_udp->slots[index].data, p_data, length);
+	p_udp->slots[index].in_use = TRUE;
+	if (PAL_STATUS_SUCCESS != pal_virtual_schedule(pal_virtual_udp_arrive, &p_udp->slots[index], p_udp->latency_us))
+	{
+		p_udp->slots[index].in_use = FALSE;
+		return PAL_STATUS_FAILURE;
+	}
+	return PAL_STATUS_SUCCESS;
+}
+
+/**
+* Runs the virtual clock till a datagram arrives at the endpoint or the timeout expires.
+*
+* \param[in,out] p_udp             Pointer to #pal_virtual_udp_t
+* \param[in]     endpoint          #PAL_VIRTUAL_UDP_CLIENT or #PAL_VIRTUAL_UDP_SERVER
+* \param[in]     timeout_us        Virtual time in microseconds to wait at most
+*
+* \retval  TRUE   A datagram arrived, the clock is at its arrival
+* \retval  FALSE  The timeout expired
+*/
+uint8_t pal_virtual_udp_wait(pal_virtual_udp_t * p_udp, uint8_t endpoint, uint32_t timeout_us)
+{
+	p_udp->waiting[endpoint] = TRUE;
+	p_udp->arrived[endpoint] = FALSE;
+	//lint --e{534} suppress "The number of events run is not needed"
+	pal_virtual_run_for(timeout_us);
+	p_udp->waiting[endpoint] = FALSE;
+	return p_udp->arrived[endpoint];
+}
+
+/**
+* Gives a received datagram back to the link.
+*
+* \param[in,out] p_udp             Pointer to #pal_virtual_udp_t
+* \param[in]     p_data            Datagram passed to the receiver
+*/
+void pal_virtual_udp_release(pal_virtual_udp_t * p_udp, const uint8_t * p_data)
+{
+	uint8_t index;
+
+	for (index = 0; index < PAL_VIRTUAL_UDP_SLOTS; index++)
+	{
+		if (p_data == p_udp->slots[index].data)
+		{
+			p_udp->slots[index].in_use = FALSE;
+			break;
+		}
+	}
+}
+
+/**
+* @}
+*/
@@ -0,0 +1,584 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file pal_virtual_test.c
+*
+* \brief   Test of the virtual time PAL: the order of the events, the timing of the ifx i2c protocol stack and the
+*          command library against the simulated OPTIGA, the adaptive frame size under injected CRC errors, and the
+*          application transport of the DTLS client over the simulated UDP link. Every case runs in virtual time, the test takes no wall clock time to wait.
+*          Built with OPTIGA_UTIL_CERT_COMPRESSION, it also stores a compressed certificate in the simulated OPTIGA.
+*
+*          gcc -DPAL_OS_HAS_EVENT_PROCESS -DMODULE_ENABLE_DTLS_MUTUAL_AUTH -DOPTIGA_UTIL_CERT_COMPRESSION
+*              -Ioptiga/include -Ipal/virtual pal/virtual/test/pal_virtual_test.c pal/virtual/pal_os_event.c
+*              pal/virtual/pal_os_timer.c
+*              pal/virtual/pal_os_lock.c pal/virtual/pal_i2c.c pal/virtual/pal_gpio.c pal/virtual/pal_ifx_i2c_config.c
+*              pal/virtual/pal_virtual_udp.c optiga/comms/optiga_comms.c optiga/comms/ifx_i2c/ifx_i2c.c
+*              optiga/comms/ifx_i2c/ifx_i2c_config.c optiga/comms/ifx_i2c/ifx_i2c_transport_layer.c
+*              optiga/comms/ifx_i2c/ifx_i2c_data_link_layer.c optiga/comms/ifx_i2c/ifx_i2c_physical_layer.c
+*              optiga/util/optiga_util.c optiga/cmd/CommandLib.c optiga/common/Util.c
+*              optiga/dtls/AppTransportLayer.c -o pal_virtual_test
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "optiga/optiga_util.h"
+#include "optiga/ifx_i2c/ifx_i2c.h"
+#include "optiga/ifx_i2c/ifx_i2c_config.h"
+#include "optiga/dtls/AppTransportLayer.h"
+#include "pal_virtual.h"
+
+#define TEST_CHECK(condition)                                               \
+    if (!(condition))                                                       \
+    {                                                                       \
+        printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition);       \
+        return -1;                                                          \
+    }
+
+/// @cond hidden
+#define TEST_EXEC_TIME_US       (50000)
+#define TEST_LATENCY_US         (20000)
+#define TEST_TL_TIMEOUT_MS      (200)
+
+static optiga_comms_t test_comms = {(void*)&ifx_i2c_context_0, NULL, NULL, 0};
+
+#ifdef OPTIGA_UTIL_CERT_COMPRESSION
+//"Infineon OPTIGA(TM) Trust X CA 101" certificate, as in the authenticate chip example
+static const uint8_t test_ca_certificate[] = {
+    0x30, 0x82, 0x02, 0x78, 0x30, 0x82, 0x01, 0xfe, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x04, 0x6a,
+    0xdb, 0xdd, 0xd6, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x03, 0x30,
+    0x77, 0x31, 0x0b, 0x30, 0x09, 0x06, 0x03, 0x55, 0x04, 0x06, 0x13, 0x02, 0x44, 0x45, 0x31, 0x21,
+    0x30, 0x1f, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x18, 0x49, 0x6e, 0x66, 0x69, 0x6e, 0x65, 0x6f,
+    0x6e, 0x20, 0x54, 0x65, 0x63, 0x68, 0x6e, 0x6f, 0x6c, 0x6f, 0x67, 0x69, 0x65, 0x73, 0x20, 0x41,
+    0x47, 0x31, 0x1b, 0x30, 0x19, 0x06, 0x03, 0x55, 0x04, 0x0b, 0x0c, 0x12, 0x4f, 0x50, 0x54, 0x49,
+    0x47, 0x41, 0x28, 0x54, 0x4d, 0x29, 0x20, 0x44, 0x65, 0x76, 0x69, 0x63, 0x65, 0x73, 0x31, 0x28,
+    0x30, 0x26, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x1f, 0x49, 0x6e, 0x66, 0x69, 0x6e, 0x65, 0x6f,
+    0x6e, 0x20, 0x4f, 0x50, 0x54, 0x49, 0x47, 0x41, 0x28, 0x54, 0x4d, 0x29, 0x20, 0x45, 0x43, 0x43,
+    0x20, 0x52, 0x6f, 0x6f, 0x74, 0x20, 0x43, 0x41, 0x30, 0x1e, 0x17, 0x0d, 0x31, 0x37, 0x30, 0x38,
+    0x32, 0x39, 0x31, 0x36, 0x32, 0x37, 0x30, 0x38, 0x5a, 0x17, 0x0d, 0x34, 0x32, 0x30, 0x38, 0x32,
+    0x39, 0x31, 0x36, 0x32, 0x37, 0x30, 0x38, 0x5a, 0x30, 0x72, 0x31, 0x0b, 0x30, 0x09, 0x06, 0x03,
+    0x55, 0x04, 0x06, 0x13, 0x02, 0x44, 0x45, 0x31, 0x21, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x04, 0x0a,
+    0x0c, 0x18, 0x49, 0x6e, 0x66, 0x69, 0x6e, 0x65, 0x6f, 0x6e, 0x20, 0x54, 0x65, 0x63, 0x68, 0x6e,
+    0x6f, 0x6c, 0x6f, 0x67, 0x69, 0x65, 0x73, 0x20, 0x41, 0x47, 0x31, 0x13, 0x30, 0x11, 0x06, 0x03,
+    0x55, 0x04, 0x0b, 0x0c, 0x0a, 0x4f, 0x50, 0x54, 0x49, 0x47, 0x41, 0x28, 0x54, 0x4d, 0x29, 0x31,
+    0x2b, 0x30, 0x29, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x22, 0x49, 0x6e, 0x66, 0x69, 0x6e, 0x65,
+    0x6f, 0x6e, 0x20, 0x4f, 0x50, 0x54, 0x49, 0x47, 0x41, 0x28, 0x54, 0x4d, 0x29, 0x20, 0x54, 0x72,
+    0x75, 0x73, 0x74, 0x20, 0x58, 0x20, 0x43, 0x41, 0x20, 0x31, 0x30, 0x31, 0x30, 0x59, 0x30, 0x13,
+    0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+    0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x60, 0xd7, 0x9d, 0x39, 0x60, 0xfb, 0x10, 0xd4, 0x28,
+    0x89, 0x09, 0x56, 0x4f, 0xfd, 0xa8, 0x47, 0xe2, 0x22, 0xfd, 0x8d, 0x3a, 0x24, 0x07, 0x7b, 0x38,
+    0x0d, 0xc3, 0x70, 0x4e, 0x37, 0x42, 0x08, 0x1b, 0x33, 0xc6, 0xec, 0x47, 0xd0, 0xa8, 0xfb, 0xcf,
+    0xad, 0x3f, 0xdc, 0x7c, 0x6e, 0xcd, 0x94, 0x7a, 0x4c, 0x1e, 0x90, 0x63, 0xd0, 0x7f, 0xe4, 0x20,
+    0xa7, 0xab, 0x14, 0xd5, 0x92, 0xb6, 0xc0, 0xa3, 0x7d, 0x30, 0x7b, 0x30, 0x1d, 0x06, 0x03, 0x55,
+    0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xca, 0x05, 0x33, 0xd7, 0x4f, 0xc4, 0x7f, 0x09, 0x49, 0xfb,
+    0xdb, 0x12, 0x25, 0xdf, 0xd7, 0x97, 0x9d, 0x41, 0x1e, 0x15, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d,
+    0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x00, 0x04, 0x30, 0x12, 0x06, 0x03, 0x55, 0x1d,
+    0x13, 0x01, 0x01, 0xff, 0x04, 0x08, 0x30, 0x06, 0x01, 0x01, 0xff, 0x02, 0x01, 0x00, 0x30, 0x15,
+    0x06, 0x03, 0x55, 0x1d, 0x20, 0x04, 0x0e, 0x30, 0x0c, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x82, 0x14,
+    0x00, 0x44, 0x01, 0x14, 0x01, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16,
+    0x80, 0x14, 0xb4, 0x18, 0x85, 0xc8, 0x4a, 0x4a, 0xc5, 0x12, 0x7a, 0xf2, 0x40, 0x39, 0xde, 0xc4,
+    0xf5, 0x8b, 0x1e, 0x7e, 0x4a, 0xd1, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04,
+    0x03, 0x03, 0x03, 0x68, 0x00, 0x30, 0x65, 0x02, 0x31, 0x00, 0xd2, 0x21, 0x49, 0xc3, 0x46, 0x70,
+    0x4b, 0x16, 0x85, 0x9e, 0xf2, 0x92, 0x6d, 0x0c, 0xd2, 0xb8, 0x74, 0x4f, 0xdd, 0x12, 0x61, 0x78,
+    0x45, 0x9b, 0x54, 0x31, 0xd2, 0x9d, 0x50, 0x4a, 0xdd, 0x5c, 0xfe, 0xf7, 0x54, 0x12, 0xb8, 0x03,
+    0xc2, 0x11, 0x21, 0x95, 0x53, 0xfc, 0x30, 0x39, 0x00, 0xd6, 0x02, 0x30, 0x13, 0x62, 0x98, 0x1f,
+    0xe7, 0x64, 0x4c, 0x89, 0xef, 0xf0, 0xe7, 0x83, 0xeb, 0x71, 0x5c, 0xa1, 0xae, 0x47, 0xf7, 0xe7,
+    0xfb, 0x7e, 0x70, 0xa8, 0xdf, 0x28, 0x04, 0x14, 0x42, 0x47, 0x66, 0x70, 0x62, 0x22, 0x1d, 0xbf,
+    0xf3, 0xe6, 0xb3, 0x5e, 0x23, 0xcb, 0x29, 0x32, 0xde, 0xea, 0xb5, 0x8e
+};
+#endif
+
+static uint8_t test_order[8];
+static uint8_t test_order_count;
+
+static void test_record(void * p_ctx)
+{
+    test_order[test_order_count++] = (uint8_t)(uintptr_t)p_ctx;
+}
+
+//Runs the scheduler nested in an event, as a wait inside a callback of the simulation does
+static void test_nested_run(void * p_ctx)
+{
+    test_record(p_ctx);
+    pal_virtual_run_for(3000);
+}
+
+//Opens the application on a simulated OPTIGA with the given execution time of the commands
+static optiga_lib_status_t test_open(uint32_t exec_time_us)
+{
+    pal_virtual_init();
+    pal_virtual_optiga_init(exec_time_us);
+    return optiga_util_open_application(&test_comms);
+}
+
+//Adapts the client endpoint of the simulated UDP link to the application transport
+static int32_t test_udp_send(Void * p_ctx, const uint8_t * p_data, uint16_t length)
+{
+    return (PAL_STATUS_SUCCESS == pal_virtual_udp_send((pal_virtual_udp_t *)p_ctx, PAL_VIRTUAL_UDP_SERVER,
+                                                       p_data, length)) ? (int32_t)OCP_TL_OK : (int32_t)OCP_TL_ERROR;
+}
+
+static int32_t test_udp_poll(Void * p_ctx, uint16_t timeout_ms)
+{
+    return pal_virtual_udp_wait((pal_virtual_udp_t *)p_ctx, PAL_VIRTUAL_UDP_CLIENT, (uint32_t)timeout_ms * 1000) ?
+           (int32_t)OCP_TL_OK : (int32_t)OCP_TL_NO_DATA;
+}
+
+static Void test_udp_release(Void * p_ctx, const uint8_t * p_data)
+{
+    pal_virtual_udp_release((pal_virtual_udp_t *)p_ctx, p_data);
+}
+
+//Datagram handed over to the application and the callback to free it
+static const uint8_t * test_owned_data;
+static fAppTLFree_d test_owned_free;
+
+static int32_t test_udp_send_owned(Void * p_ctx, const uint8_t * p_data, uint16_t length, fAppTLFree_d pf_free)
+{
+    int32_t status = test_udp_send(p_ctx, p_data, length);
+
+    if ((int32_t)OCP_TL_OK == status)
+    {
+        test_owned_data = p_data;
+        test_owned_free = pf_free;
+    }
+    return status;
+}
+
+static Void test_udp_feed(void * p_ctx, const uint8_t * p_data, uint16_t length)
+{
+    if ((int32_t)OCP_TL_OK != AppTL_Feed((const sTL_d *)p_ctx, p_data, length))
+    {
+        printf("FAILED %s:%d: datagram not fed\n", __FILE__, __LINE__);
+    }
+}
+
+//Echoes the datagrams at the server endpoint
+static Void test_udp_echo(void * p_ctx, const uint8_t * p_data, uint16_t length)
+{
+    pal_virtual_udp_t * p_udp = (pal_virtual_udp_t *)p_ctx;
+
+    if (PAL_STATUS_SUCCESS != pal_virtual_udp_send(p_udp, PAL_VIRTUAL_UDP_CLIENT, p_data, length))
+    {
+        printf("FAILED %s:%d: datagram not echoed\n", __FILE__, __LINE__);
+    }
+    pal_virtual_udp_release(p_udp, p_data);
+}
+/// @endcond
+
+static int test_scheduler_order(void)
+{
+    pal_virtual_init();
+    test_order_count = 0;
+
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_virtual_schedule(test_record, (void *)3, 2000));
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_virtual_schedule(test_record, (void *)1, 1000));
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_virtual_schedule(test_record, (void *)2, 1000));
+    //The one shot timer of the library replaces the pending one
+    pal_os_event_register_callback_oneshot(test_record, (void *)9, 500);
+    pal_os_event_register_callback_oneshot(test_record, (void *)4, 2500);
+
+    TEST_CHECK(3 == pal_virtual_run_for(2000));
+    TEST_CHECK(2000 == pal_virtual_get_time_us());
+    TEST_CHECK(TRUE == pal_virtual_step());
+    TEST_CHECK(2500 == pal_virtual_get_time_us());
+    TEST_CHECK(FALSE == pal_virtual_step());
+
+    TEST_CHECK(4 == test_order_count);
+    TEST_CHECK((1 == test_order[0]) && (2 == test_order[1]) && (3 == test_order[2]) && (4 == test_order[3]));
+
+    //A run nested in an event ends behind the outer run, the clock must not go back
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_virtual_schedule(test_nested_run, (void *)5, 1000));
+    TEST_CHECK(PAL_STATUS_SUCCESS == pal_virtual_schedule(test_record, (void *)6, 3500));
+    TEST_CHECK(1 == pal_virtual_run_for(2000));
+    TEST_CHECK(2500 + 1000 + 3000 == pal_virtual_get_time_us());
+    TEST_CHECK((6 == test_order_count) && (5 == test_order[4]) && (6 == test_order[5]));
+
+    return 0;
+}
+
+static int test_optiga_open(void)
+{
+    pal_virtual_optiga_stats_t stats;
+
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == test_open(TEST_EXEC_TIME_US));
+    pal_virtual_optiga_get_stats(&stats);
+
+    //Cold reset: low time and start up time of the chip, then the open application command and the read of the
+    //maximum comms buffer size
+    TEST_CHECK(stats.reset_low_time_us >= RESET_LOW_TIME_MSEC);
+    TEST_CHECK(pal_virtual_get_time_us() >= RESET_LOW_TIME_MSEC + STARTUP_TIME_MSEC + 2 * TEST_EXEC_TIME_US);
+    TEST_CHECK(2 == stats.commands);
+    TEST_CHECK(0x0615 == CmdLib_GetMaxCommsBufferSize());
+    TEST_CHECK(0 == stats.nacks);
+
+    return 0;
+}
+
+static int test_optiga_command(void)
+{
+    uint8_t data[] = {0x01, 0x02, 0x03, 0x04};
+    pal_virtual_optiga_stats_t stats;
+    uint32_t commands;
+    uint64_t start_us;
+
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == test_open(TEST_EXEC_TIME_US));
+    pal_virtual_optiga_get_stats(&stats);
+    commands = stats.commands;
+
+    //The response is polled right away, the command takes its execution time and the bus time only
+    start_us = pal_virtual_get_time_us();
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_write_data(0xE0E1, OPTIGA_UTIL_ERASE_AND_WRITE, 0, data, sizeof(data)));
+    TEST_CHECK(pal_virtual_get_time_us() - start_us >= TEST_EXEC_TIME_US);
+    TEST_CHECK(pal_virtual_get_time_us() - start_us < TEST_EXEC_TIME_US + PL_DATA_POLLING_INVERVAL_US + 20000);
+
+    pal_virtual_optiga_get_stats(&stats);
+    TEST_CHECK(commands + 1 == stats.commands);
+
+    return 0;
+}
+
+static int test_optiga_data_objects(void)
+{
+    static uint8_t data[700];
+    static uint8_t buffer[sizeof(data)];
+    uint16_t length;
+    uint16_t index;
+
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == test_open(TEST_EXEC_TIME_US));
+    for (index = 0; index < sizeof(data); index++)
+    {
+        data[index] = (uint8_t)(index * 7);
+    }
+
+    //Both the command and the response take more than one frame
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_write_data(0xF1D0, OPTIGA_UTIL_ERASE_AND_WRITE, 0, data, sizeof(data)));
+    length = sizeof(buffer);
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_read_data(0xF1D0, 0, buffer, &length));
+    TEST_CHECK(sizeof(data) == length);
+    TEST_CHECK(0 == memcmp(data, buffer, sizeof(data)));
+
+    //A write at an offset extends the object, the used size is read from the metadata
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_write_data(0xF1D0, OPTIGA_UTIL_WRITE_ONLY, 600, data, 200));
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_get_data_size(0xF1D0, &length));
+    TEST_CHECK(800 == length);
+    length = sizeof(buffer);
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_read_data_exact(0xF1D0, 600, buffer, &length));
+    TEST_CHECK(200 == length);
+    TEST_CHECK(0 == memcmp(data, buffer, 200));
+
+    //Reads of an object never written and writes out of bound fail
+    length = sizeof(buffer);
+    TEST_CHECK(OPTIGA_LIB_SUCCESS != optiga_util_read_data(0xF1D1, 0, buffer, &length));
+    TEST_CHECK(OPTIGA_LIB_SUCCESS != optiga_util_write_data(0xF1D0, OPTIGA_UTIL_WRITE_ONLY,
+                                                            PAL_VIRTUAL_OPTIGA_OBJECT_SIZE - 1, data, 2));
+
+    return 0;
+}
+
+#ifdef OPTIGA_UTIL_CERT_COMPRESSION
+static int test_optiga_compressed_cert(void)
+{
+    static uint8_t compressed[sizeof(test_ca_certificate) + 16];
+    static uint8_t buffer[PAL_VIRTUAL_OPTIGA_OBJECT_SIZE];
+    uint16_t compressed_length = sizeof(compressed);
+    uint16_t length;
+    uint64_t start_us;
+    uint64_t plain_write_us;
+    uint64_t plain_read_us;
+    uint64_t compressed_write_us;
+    uint64_t compressed_read_us;
+
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == test_open(TEST_EXEC_TIME_US));
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_compress_cert(test_ca_certificate, sizeof(test_ca_certificate),
+                                                               compressed, &compressed_length));
+    TEST_CHECK(compressed_length < sizeof(test_ca_certificate));
+
+    //The certificate as it is
+    start_us = pal_virtual_get_time_us();
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_write_data(0xE0E2, OPTIGA_UTIL_ERASE_AND_WRITE, 0,
+                                                            (uint8_t *)test_ca_certificate, sizeof(test_ca_certificate)));
+    plain_write_us = pal_virtual_get_time_us() - start_us;
+    start_us = pal_virtual_get_time_us();
+    length = sizeof(buffer);
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_read_cert(0xE0E2, buffer, &length));
+    plain_read_us = pal_virtual_get_time_us() - start_us;
+    TEST_CHECK(sizeof(test_ca_certificate) == length);
+    TEST_CHECK(0 == memcmp(test_ca_certificate, buffer, length));
+
+    //The compressed certificate is decompressed by the read
+    start_us = pal_virtual_get_time_us();
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_write_data(0xE0E1, OPTIGA_UTIL_ERASE_AND_WRITE, 0,
+                                                            compressed, compressed_length));
+    compressed_write_us = pal_virtual_get_time_us() - start_us;
+    start_us = pal_virtual_get_time_us();
+    length = sizeof(buffer);
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_read_cert(0xE0E1, buffer, &length));
+    compressed_read_us = pal_virtual_get_time_us() - start_us;
+    TEST_CHECK(sizeof(test_ca_certificate) == length);
+    TEST_CHECK(0 == memcmp(test_ca_certificate, buffer, length));
+
+    //Fewer bytes and fewer frames on the bus
+    TEST_CHECK(compressed_write_us < plain_write_us);
+    TEST_CHECK(compressed_read_us < plain_read_us);
+
+    return 0;
+}
+#endif
+
+static int test_optiga_mute(void)
+{
+    uint64_t start_us;
+
+    pal_virtual_init();
+    pal_virtual_optiga_init(TEST_EXEC_TIME_US);
+    pal_virtual_optiga_set_mute(TRUE);
+
+    //The open application command is never answered, the transport layer gives up after its exit timeout
+    TEST_CHECK(OPTIGA_LIB_SUCCESS != optiga_util_open_application(&test_comms));
+    start_us = RESET_LOW_TIME_MSEC + STARTUP_TIME_MSEC;
+    TEST_CHECK(pal_virtual_get_time_us() - start_us >= (uint64_t)TL_MAX_EXIT_TIMEOUT * 1000 * 1000);
+
+    return 0;
+}
+
+static int test_optiga_nack(void)
+{
+    pal_virtual_optiga_stats_t stats;
+
+    pal_virtual_init();
+    pal_virtual_optiga_init(TEST_EXEC_TIME_US);
+    pal_virtual_optiga_set_nack(0xFFFFFFFF);
+
+    //The physical layer gives up after its polling limit
+    TEST_CHECK(OPTIGA_LIB_SUCCESS != optiga_util_open_application(&test_comms));
+    pal_virtual_optiga_get_stats(&stats);
+    TEST_CHECK(0 == stats.commands);
+    TEST_CHECK(stats.nacks >= PL_POLLING_MAX_CNT);
+    TEST_CHECK(pal_virtual_get_time_us() >= RESET_LOW_TIME_MSEC + STARTUP_TIME_MSEC +
+                                            (uint64_t)PL_POLLING_MAX_CNT * PL_POLLING_INVERVAL_US);
+
+    return 0;
+}
+
+static int test_optiga_frame_errors(void)
+{
+    static uint8_t data[700];
+    static uint8_t buffer[sizeof(data)];
+    pal_virtual_optiga_stats_t stats;
+    ifx_i2c_frame_stats_t frame_stats;
+    uint16_t max_frame_size;
+    uint16_t length;
+    uint16_t index;
+
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == test_open(TEST_EXEC_TIME_US));
+    TEST_CHECK(IFX_I2C_STACK_SUCCESS == ifx_i2c_set_adaptive_frame_size(&ifx_i2c_context_0, TRUE));
+    TEST_CHECK(IFX_I2C_STACK_SUCCESS == ifx_i2c_get_frame_stats(&ifx_i2c_context_0, &frame_stats));
+    max_frame_size = frame_stats.max_frame_size;
+    TEST_CHECK(PAL_VIRTUAL_OPTIGA_FRAME_SIZE == max_frame_size);
+    TEST_CHECK(max_frame_size == frame_stats.frame_size);
+    for (index = 0; index < sizeof(data); index++)
+    {
+        data[index] = (uint8_t)(index * 3);
+    }
+
+    //A burst of CRC errors is recovered by retransmissions, the frame size is halved for the next command
+    pal_virtual_optiga_set_crc_error(DL_ADAPTIVE_ERROR_BURST);
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_write_data(0xF1D0, OPTIGA_UTIL_ERASE_AND_WRITE, 0, data, 4));
+    TEST_CHECK(IFX_I2C_STACK_SUCCESS == ifx_i2c_get_frame_stats(&ifx_i2c_context_0, &frame_stats));
+    pal_virtual_optiga_get_stats(&stats);
+    TEST_CHECK(DL_ADAPTIVE_ERROR_BURST == stats.crc_errors);
+    TEST_CHECK(DL_ADAPTIVE_ERROR_BURST == frame_stats.crc_errors);
+    TEST_CHECK(1 == frame_stats.shrink_count);
+    TEST_CHECK(max_frame_size == frame_stats.frame_size);
+
+    //The next command agrees the smaller frame size with the slave first, both sides fragment for it
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_write_data(0xF1D0, OPTIGA_UTIL_ERASE_AND_WRITE, 0, data, sizeof(data)));
+    TEST_CHECK(IFX_I2C_STACK_SUCCESS == ifx_i2c_get_frame_stats(&ifx_i2c_context_0, &frame_stats));
+    pal_virtual_optiga_get_stats(&stats);
+    TEST_CHECK(max_frame_size / 2 == frame_stats.frame_size);
+    TEST_CHECK(frame_stats.frame_size == stats.data_reg_len);
+    length = sizeof(buffer);
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_read_data(0xF1D0, 0, buffer, &length));
+    TEST_CHECK((sizeof(data) == length) && (0 == memcmp(data, buffer, length)));
+
+    //Clean frames grow the frame size back to the negotiated one
+    for (index = 0; (index < 4 * DL_ADAPTIVE_CLEAN_FRAMES) && (frame_stats.frame_size < max_frame_size); index++)
+    {
+        TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_write_data(0xF1D0, OPTIGA_UTIL_WRITE_ONLY, 0, data, 4));
+        TEST_CHECK(IFX_I2C_STACK_SUCCESS == ifx_i2c_get_frame_stats(&ifx_i2c_context_0, &frame_stats));
+    }
+    pal_virtual_optiga_get_stats(&stats);
+    TEST_CHECK(max_frame_size == frame_stats.frame_size);
+    TEST_CHECK(max_frame_size == stats.data_reg_len);
+    TEST_CHECK(1 == frame_stats.shrink_count);
+    TEST_CHECK(frame_stats.grow_count >= 1);
+    length = sizeof(buffer);
+    TEST_CHECK(OPTIGA_LIB_SUCCESS == optiga_util_read_data(0xF1D0, 0, buffer, &length));
+    TEST_CHECK((sizeof(data) == length) && (0 == memcmp(data, buffer, length)));
+
+    TEST_CHECK(IFX_I2C_STACK_SUCCESS == ifx_i2c_set_adaptive_frame_size(&ifx_i2c_context_0, FALSE));
+    return 0;
+}
+
+static int test_udp_transport(void)
+{
+    static pal_virtual_udp_t udp;
+    uint8_t request[] = {0x16, 0xFE, 0xFD, 0x00, 0x01};
+    uint8_t response[PAL_VIRTUAL_UDP_MTU];
+    uint16_t length;
+    uint64_t start_us;
+    sAppTransport_d transport = {test_udp_send, test_udp_poll, test_udp_release, &udp, NULL};
+    sTL_d tl;
+
+    pal_virtual_init();
+    pal_virtual_udp_init(&udp, TEST_LATENCY_US);
+    memset(&tl, 0x00, sizeof(tl));
+    tl.psAppTransport = &transport;
+    tl.wTimeout = TEST_TL_TIMEOUT_MS;
+    udp.receive[PAL_VIRTUAL_UDP_CLIENT] = test_udp_feed;
+    udp.receive_ctx[PAL_VIRTUAL_UDP_CLIENT] = &tl;
+    udp.receive[PAL_VIRTUAL_UDP_SERVER] = test_udp_echo;
+    udp.receive_ctx[PAL_VIRTUAL_UDP_SERVER] = &udp;
+
+    TEST_CHECK((int32_t)OCP_TL_OK == AppTL_Init(&tl));
+    TEST_CHECK((int32_t)OCP_TL_OK == AppTL_Connect(&tl));
+
+    //Round trip: the echo arrives after twice the latency
+    start_us = pal_virtual_get_time_us();
+    TEST_CHECK((int32_t)OCP_TL_OK == AppTL_Send(&tl, request, sizeof(request)));
+    length = sizeof(response);
+    TEST_CHECK((int32_t)OCP_TL_OK == AppTL_Recv(&tl, response, &length));
+    TEST_CHECK((sizeof(request) == length) && (0 == memcmp(request, response, length)));
+    TEST_CHECK(2 * TEST_LATENCY_US == pal_virtual_get_time_us() - start_us);
+
+    //Lost request: the receive gives up after the transport layer timeout
+    udp.drop_mask[PAL_VIRTUAL_UDP_SERVER] = 1 << udp.sent[PAL_VIRTUAL_UDP_SERVER];
+    start_us = pal_virtual_get_time_us();
+    TEST_CHECK((int32_t)OCP_TL_OK == AppTL_Send(&tl, request, sizeof(request)));
+    length = sizeof(response);
+    TEST_CHECK((int32_t)OCP_TL_NO_DATA == AppTL_Recv(&tl, response, &length));
+    TEST_CHECK((uint64_t)TEST_TL_TIMEOUT_MS * 1000 == pal_virtual_get_time_us() - start_us);
+    TEST_CHECK(1 == udp.dropped[PAL_VIRTUAL_UDP_SERVER]);
+
+    AppTL_Disconnect(&tl);
+    //All datagrams are given back to the link
+    for (length = 0; length < PAL_VIRTUAL_UDP_SLOTS; length++)
+    {
+        TEST_CHECK(FALSE == udp.slots[length].in_use);
+    }
+
+    return 0;
+}
+
+static int test_udp_zero_copy(void)
+{
+    static pal_virtual_udp_t udp;
+    uint8_t request[] = {0x17, 0xFE, 0xFD, 0x00, 0x01};
+    uint8_t * p_buffer;
+    uint8_t slot;
+    sAppTransport_d transport = {test_udp_send, test_udp_poll, test_udp_release, &udp, test_udp_send_owned};
+    sDatagram_d datagram;
+    sTL_d tl;
+
+    pal_virtual_init();
+    pal_virtual_udp_init(&udp, TEST_LATENCY_US);
+    memset(&tl, 0x00, sizeof(tl));
+    tl.psAppTransport = &transport;
+    tl.wTimeout = TEST_TL_TIMEOUT_MS;
+    udp.receive[PAL_VIRTUAL_UDP_CLIENT] = test_udp_feed;
+    udp.receive_ctx[PAL_VIRTUAL_UDP_CLIENT] = &tl;
+    udp.receive[PAL_VIRTUAL_UDP_SERVER] = test_udp_echo;
+    udp.receive_ctx[PAL_VIRTUAL_UDP_SERVER] = &udp;
+
+    TEST_CHECK((int32_t)OCP_TL_OK == AppTL_Init(&tl));
+    TEST_CHECK((int32_t)OCP_TL_OK == AppTL_Connect(&tl));
+
+    //The record layer buffer is handed over and freed by the application
+    p_buffer = (uint8_t *)malloc(sizeof(request));
+    TEST_CHECK(NULL != p_buffer);
+    memcpy(p_buffer, request, sizeof(request));
+    test_owned_data = NULL;
+    TEST_CHECK((int32_t)OCP_TL_OK == AppTL_SendOwned(&tl, p_buffer, sizeof(request)));
+    TEST_CHECK((p_buffer == test_owned_data) && (NULL != test_owned_free));
+    test_owned_free(test_owned_data);
+
+    //The echo is lent in the slot of the link, which is in use till it is released
+    TEST_CHECK((int32_t)OCP_TL_OK == AppTL_RecvDatagram(&tl, &datagram));
+    TEST_CHECK((1 == datagram.bSegmentCount) && (sizeof(request) == datagram.wLen));
+    TEST_CHECK(0 == memcmp(request, datagram.rgpbSegment[0], datagram.wLen));
+    for (slot = 0; slot < PAL_VIRTUAL_UDP_SLOTS; slot++)
+    {
+        if (datagram.rgpbSegment[0] == udp.slots[slot].data)
+        {
+            break;
+        }
+    }
+    TEST_CHECK((PAL_VIRTUAL_UDP_SLOTS != slot) && (TRUE == udp.slots[slot].in_use));
+    AppTL_ReleaseDatagram(&tl, &datagram);
+    TEST_CHECK(FALSE == udp.slots[slot].in_use);
+
+    //A datagram the application does not take stays with the transport layer, which frees it
+    p_buffer = (uint8_t *)malloc(PAL_VIRTUAL_UDP_MTU + 1);
+    TEST_CHECK(NULL != p_buffer);
+    test_owned_data = NULL;
+    TEST_CHECK((int32_t)OCP_TL_ERROR == AppTL_SendOwned(&tl, p_buffer, PAL_VIRTUAL_UDP_MTU + 1));
+    TEST_CHECK(NULL == test_owned_data);
+
+    AppTL_Disconnect(&tl);
+    return 0;
+}
+
+int main(void)
+{
+    int status = 0;
+
+    status |= test_scheduler_order();
+    status |= test_optiga_open();
+    status |= test_optiga_command();
+    status |= test_optiga_data_objects();
+#ifdef OPTIGA_UTIL_CERT_COMPRESSION
+    status |= test_optiga_compressed_cert();
+#endif
+    status |= test_optiga_mute();
+    status |= test_optiga_nack();
+    status |= test_optiga_frame_errors();
+    status |= test_udp_transport();
+    status |= test_udp_zero_copy();
+
+    printf("%s\n", (0 == status) ? "PASSED" : "FAILED");
+    return (0 == status) ? 0 : 1;
+}
+
+/**
+* @}
+*/
@@ -50,9 +50,11 @@
  *********************************************************************************************************************/
 typedef struct pal_socket_data_config {
     uint8_t *p_data;
+    pal_socket_datagram_t *p_datagram;
     uint16_t p_length;
     uint8_t b_is_event_fired;
     ip_addr_t ip_address;
+    uint16_t port;
     int32_t i4RetVal;
 } pal_socket_data_config, *p_pal_socket_data_config;
 
@@ -76,7 +78,7 @@ void lwip_timer_isr(void *args)
  * API IMPLEMENTATION
  *********************************************************************************************************************/
 /**
- * Assigns the IP address of the socket
+ * Assigns the IP address of the socket. IPv6 literals are accepted if lwIP is built with IPv6 support.
  *
  * \param[in,out]  p_ip_address       Pointer to the location where the ip address tp be assigned
  * \param[in,out]  p_input_ip_address Pointer to the input IP address 
@@ -91,15 +93,39 @@ int32_t pal_socket_assign_ip_address(const char_t* p_ip_address,void* p_input_ip
     int32_t i4RetVal = (int32_t) E_COMMS_FAILURE;
 
     ip_addr_t ip_address;
-    if (0x01 == inet_aton(p_ip_address, &ip_address))
+    if (0x01 == ipaddr_aton(p_ip_address, &ip_address))
     {
-        ((ip_addr_t *)p_input_ip_address)->addr = ip_address.addr;
+        *((ip_addr_t *)p_input_ip_address) = ip_address;
         i4RetVal  = E_COMMS_SUCCESS;
     }
     
     return i4RetVal;
 }
 
+/**
+ * Compares an IP address string with an assigned IP address
+ *
+ * \param[in]  p_ip_address       Pointer to the IP address string
+ * \param[in]  p_input_ip_address Pointer to the assigned IP address
+ *
+ * \return  E_COMMS_SUCCESS if both addresses are the same
+ * \return  E_COMMS_FAILURE otherwise
+ */
+//lint --e{714} suppress "Functions are extern and not reference in header file"
+int32_t pal_socket_compare_ip_address(const char_t* p_ip_address,const void* p_input_ip_address)
+{
+    int32_t i4RetVal = (int32_t) E_COMMS_FAILURE;
+
+    ip_addr_t ip_address;
+    if ((0x01 == ipaddr_aton(p_ip_address, &ip_address)) &&
+        (ip_addr_cmp(&ip_address, (const ip_addr_t *)p_input_ip_address)))
+    {
+        i4RetVal  = E_COMMS_SUCCESS;
+    }
+
+    return i4RetVal;
+}
+
 /**
  * Initializes socket communication structure
  *
@@ -125,7 +151,11 @@ int32_t pal_socket_init(pal_socket_t* p_socket)
 
         //create a new pcb structure
         //Initialise the structure using udp_new()
+#if defined(LWIP_IPV6) && LWIP_IPV6
+        p_socket->pcbTx = udp_new_ip_type(IPADDR_TYPE_ANY);
+#else
         p_socket->pcbTx = udp_new();
+#endif
         if (NULL == p_socket->pcbTx)
         {
         	i4RetVal = (int32_t) E_COMMS_UDP_ALLOCATE_FAILURE;
@@ -211,7 +241,11 @@ int32_t pal_socket_connect(pal_socket_t* p_socket,
             break;
         }
 
+#if defined(LWIP_IPV6) && LWIP_IPV6
+        i4RetVal = udp_bind(p_socket->pcbTx, IP_ANY_TYPE, port);
+#else
         i4RetVal = udp_bind(p_socket->pcbTx, IP_ADDR_ANY, port);
+#endif
         //bind to the port using udp_bind()
         if ((int32_t)ERR_OK != i4RetVal)
         {
@@ -228,6 +262,8 @@ int32_t pal_socket_connect(pal_socket_t* p_socket,
 
 /**
  * Transmits the data to the client from which the data was received.
+ * The data is not copied, it is referenced by a PBUF_REF pbuf and lwIP chains the UDP header in front of it.
+ * lwIP copies referenced data itself if the datagram has to be queued, e.g. while the address is resolved.
  *
  * \param[in]  p_socket     Pointer to the socket communication structure
  * \param[in]  p_data       Pointer to the data buffer to be transmitted
@@ -246,7 +282,6 @@ int32_t pal_socket_send(const pal_socket_t* p_socket, uint8_t *p_data, uint32_t
     int32_t i4RetVal = (int32_t) E_COMMS_FAILURE;
 
     struct pbuf *p_out = NULL;
-    struct pbuf *p_buffer_data = NULL;
 	
     do
     {
@@ -264,32 +299,14 @@ int32_t pal_socket_send(const pal_socket_t* p_socket, uint8_t *p_data, uint32_t
             break;
         }
 
-        //allocate buffer using pbuf_alloc of length equal to PdwLen
-        //As handler argument is expected the pcb that shall be used for
-        //send back the data
-
-        //Allocate a buffer to store data to be transmitted
-        p_out = pbuf_alloc(PBUF_TRANSPORT, (uint16_t)length, PBUF_RAM);
+        //Reference the data to be transmitted, the headers are allocated by lwIP
+        p_out = pbuf_alloc(PBUF_TRANSPORT, (uint16_t)length, PBUF_REF);
         if (NULL == p_out)
         {
             i4RetVal = (int32_t) E_COMMS_INSUFFICIENT_MEMORY;
             break;
         }
-        
-        p_buffer_data = pbuf_alloc(PBUF_TRANSPORT, (uint16_t)0U, PBUF_RAM);
-        if (NULL == p_buffer_data)
-        {
-            i4RetVal = (int32_t) E_COMMS_INSUFFICIENT_MEMORY;
-            break;
-        }
-        p_buffer_data->payload = p_data;
-        p_buffer_data->len = (uint16_t)length;
-        p_buffer_data->next = NULL;
-        p_buffer_data->tot_len = (uint16_t)length;
-        
-        //copy date to this buffer from Pp_data using pbuf_copy
-        //lint --e{534} suppress "Return value is not required to be checked"
-        pbuf_copy(p_out,p_buffer_data);
+        p_out->payload = p_data;
 
         //Send back data to same ip that sent the data on same port
         //send data to send port using udp_sendto
@@ -318,12 +335,7 @@ int32_t pal_socket_send(const pal_socket_t* p_socket, uint8_t *p_data, uint32_t
     } while (FALSE);
 		
 	//clear allocated buffer pbuf_free
-	if (i4RetVal != (int32_t) E_COMMS_INSUFFICIENT_MEMORY && 0 == pbuf_free(p_out))
-	{
-		i4RetVal = (int32_t) E_COMMS_UDP_DEALLOCATION_FAILURE;
-	}
-    
-    if (i4RetVal != (int32_t) E_COMMS_INSUFFICIENT_MEMORY && 0 == pbuf_free(p_buffer_data))
+	if ((NULL != p_out) && (0 == pbuf_free(p_out)))
 	{
 		i4RetVal = (int32_t) E_COMMS_UDP_DEALLOCATION_FAILURE;
 	}
@@ -332,38 +344,28 @@ int32_t pal_socket_send(const pal_socket_t* p_socket, uint8_t *p_data, uint32_t
 }
 
 
+/// @cond hidden
 /**
- * Receives the data from the client
+ * Waits for a datagram, which the receive handler copies or references as given in the data config
  *
- * \param[in,out]  p_socket     Pointer to the socket communication structure
- * \param[out]     p_data       Pointer to the data buffer to be received
- * \param[in,out]  p_length    Pointer to the length of the buffer
+ * \param[in,out]  p_socket                Pointer to the socket communication structure
+ * \param[in,out]  p_in_out_data_callback  Data config passed to the receive handler
  *
  * \return  E_COMMS_SUCCESS on successful execution
- * \return  E_COMMS_PARAMETER_NULL on parameter received is NULL
  * \return  E_COMMS_UDP_NO_DATA_RECEIVED on no data received from the target
  * \return  E_COMMS_FAILURE on failure
  */
-int32_t pal_socket_listen(pal_socket_t *p_socket,
-                          uint8_t *p_data, uint32_t *p_length)
+static int32_t pal_socket_wait(pal_socket_t *p_socket, pal_socket_data_config * p_in_out_data_callback)
 {
     int32_t i4RetVal = (int32_t) E_COMMS_FAILURE;
-
-    pal_socket_data_config sInOutDataToCallBack = { 0 };
+    pal_socket_data_config sInOutDataToCallBack;
     uint32_t wTickCount = 0;
     uint32_t wBaseTickCount = 0;
 
     do
     {
-        //check for null values
-        if (NULL == p_socket || NULL == p_data || NULL == p_length || NULL == p_socket->pcbTx)
-        {
-            i4RetVal = (int32_t) E_COMMS_PARAMETER_NULL;
-            break;
-        }
         //Register an handler on receive packet event using udp_recv()
-        sInOutDataToCallBack.p_length = (uint16_t)*p_length;
-        sInOutDataToCallBack.p_data = p_data;
+        sInOutDataToCallBack = *p_in_out_data_callback;
         sInOutDataToCallBack.b_is_event_fired = FALSE;
 
         wBaseTickCount = pal_os_timer_get_time_in_milliseconds();
@@ -410,21 +412,119 @@ int32_t pal_socket_listen(pal_socket_t *p_socket,
             break;
         }
 
-        p_data = sInOutDataToCallBack.p_data;
-        *p_length = sInOutDataToCallBack.p_length;
+        p_in_out_data_callback->p_length = sInOutDataToCallBack.p_length;
         p_socket->sIPAddress = sInOutDataToCallBack.ip_address;
+        p_socket->wRecvPort = sInOutDataToCallBack.port;
 
         i4RetVal = (int32_t) E_COMMS_SUCCESS;
     } while (FALSE);
 		
-    if ((NULL != p_socket) && (NULL != p_socket->pcbTx))
+    //disable receiving of data till next receive call
+    udp_recv(p_socket->pcbTx, NULL, NULL);
+
+    if ((E_COMMS_SUCCESS != i4RetVal) && (NULL != sInOutDataToCallBack.p_datagram))
     {
-        //disable receiving of data till next receive call
-        udp_recv(p_socket->pcbTx, NULL, NULL);
+        //A datagram taken over by the handler after the timeout expired
+        pal_socket_release_datagram(sInOutDataToCallBack.p_datagram);
     }
 
     return i4RetVal;
 }
+/// @endcond
+
+/**
+ * Receives the data from the client
+ *
+ * \param[in,out]  p_socket     Pointer to the socket communication structure
+ * \param[out]     p_data       Pointer to the data buffer to be received
+ * \param[in,out]  p_length    Pointer to the length of the buffer
+ *
+ * \return  E_COMMS_SUCCESS on successful execution
+ * \return  E_COMMS_PARAMETER_NULL on parameter received is NULL
+ * \return  E_COMMS_UDP_NO_DATA_RECEIVED on no data received from the target
+ * \return  E_COMMS_FAILURE on failure
+ */
+int32_t pal_socket_listen(pal_socket_t *p_socket,
+                          uint8_t *p_data, uint32_t *p_length)
+{
+    int32_t i4RetVal = (int32_t) E_COMMS_FAILURE;
+
+    pal_socket_data_config sInOutDataToCallBack = { 0 };
+
+    do
+    {
+        //check for null values
+        if (NULL == p_socket || NULL == p_data || NULL == p_length || NULL == p_socket->pcbTx)
+        {
+            i4RetVal = (int32_t) E_COMMS_PARAMETER_NULL;
+            break;
+        }
+        sInOutDataToCallBack.p_length = (uint16_t)*p_length;
+        sInOutDataToCallBack.p_data = p_data;
+
+        i4RetVal = pal_socket_wait(p_socket, &sInOutDataToCallBack);
+        if (E_COMMS_SUCCESS == i4RetVal)
+        {
+            *p_length = sInOutDataToCallBack.p_length;
+        }
+    } while (FALSE);
+
+    return i4RetVal;
+}
+
+/**
+ * Receives a datagram from the client without copying it. The datagram references the pbuf chain of lwIP,
+ * chains of more than #PAL_SOCKET_MAX_SEGMENTS pbufs are coalesced. The pbufs are held till the datagram is
+ * released with #pal_socket_release_datagram.
+ *
+ * \param[in,out]  p_socket     Pointer to the socket communication structure
+ * \param[out]     p_datagram   Pointer to the datagram
+ *
+ * \return  E_COMMS_SUCCESS on successful execution
+ * \return  E_COMMS_PARAMETER_NULL on parameter received is NULL
+ * \return  E_COMMS_UDP_NO_DATA_RECEIVED on no data received from the target
+ * \return  E_COMMS_INSUFFICIENT_MEMORY on failure to coalesce a long chain
+ * \return  E_COMMS_FAILURE on failure
+ */
+int32_t pal_socket_listen_datagram(pal_socket_t* p_socket, pal_socket_datagram_t* p_datagram)
+{
+    int32_t i4RetVal = (int32_t) E_COMMS_FAILURE;
+
+    pal_socket_data_config sInOutDataToCallBack = { 0 };
+
+    do
+    {
+        //check for null values
+        if (NULL == p_socket || NULL == p_datagram || NULL == p_socket->pcbTx)
+        {
+            i4RetVal = (int32_t) E_COMMS_PARAMETER_NULL;
+            break;
+        }
+        memset(p_datagram, 0, sizeof(pal_socket_datagram_t));
+        sInOutDataToCallBack.p_datagram = p_datagram;
+
+        i4RetVal = pal_socket_wait(p_socket, &sInOutDataToCallBack);
+    } while (FALSE);
+
+    return i4RetVal;
+}
+
+/**
+ * Releases a datagram received with #pal_socket_listen_datagram, i.e. frees its pbufs
+ *
+ * \param[in,out]  p_datagram   Pointer to the datagram
+ *
+ * \return  None
+ */
+void pal_socket_release_datagram(pal_socket_datagram_t* p_datagram)
+{
+    if ((NULL != p_datagram) && (NULL != p_datagram->p_handle))
+    {
+        //lint --e{534} suppress "This is a void function so return value is ignored"
+        pbuf_free((struct pbuf *)p_datagram->p_handle);
+        memset(p_datagram, 0, sizeof(pal_socket_datagram_t));
+    }
+}
 
 /**
  * Closes the UDP communication and releases all the resources
@@ -448,6 +548,7 @@ void pal_socket_close(pal_socket_t* p_socket)
 
         memset(&p_socket->sIPAddress, 0, sizeof(p_socket->sIPAddress));
         p_socket->wPort = 0;
+        p_socket->wRecvPort = 0;
 	}
 }
 /// @cond hidden
@@ -467,8 +568,47 @@ void pal_socket_receive_handler(void * arg, struct udp_pcb * upcb, struct pbuf *
 		                        ip_addr_t * p_addr, u16_t port)
 {
     struct pbuf * q;
-    uint32_t dwOffset = 0;
-    
+    pal_socket_datagram_t * p_datagram;
+
+    if ((NULL != arg) && (NULL != ((p_pal_socket_data_config) arg)->p_datagram))
+    {
+        p_datagram = ((p_pal_socket_data_config) arg)->p_datagram;
+        //Only the first datagram is taken, the socket does not queue
+        if ((TRUE == ((p_pal_socket_data_config) arg)->b_is_event_fired) || (NULL == p_pbuf) || (NULL == p_addr))
+        {
+            if (NULL != p_pbuf)
+            {
+                //lint --e{534} suppress "This is a void function so return value is ignored"
+                pbuf_free(p_pbuf);
+            }
+            return;
+        }
+        ((p_pal_socket_data_config) arg)->i4RetVal = (int32_t) E_COMMS_SUCCESS;
+        if (pbuf_clen(p_pbuf) > PAL_SOCKET_MAX_SEGMENTS)
+        {
+            //Returns the chain unchanged if no single pbuf can be allocated
+            p_pbuf = pbuf_coalesce(p_pbuf, PBUF_RAW);
+            if (NULL != p_pbuf->next)
+            {
+                ((p_pal_socket_data_config) arg)->i4RetVal = (int32_t) E_COMMS_INSUFFICIENT_MEMORY;
+            }
+        }
+        //The pbufs are kept, the payload is referenced till the datagram is released
+        p_datagram->p_handle = p_pbuf;
+        p_datagram->length = p_pbuf->tot_len;
+        for (q = p_pbuf; (NULL != q) && (p_datagram->segment_count < PAL_SOCKET_MAX_SEGMENTS); q = q->next)
+        {
+            p_datagram->p_segment[p_datagram->segment_count] = (uint8_t *)q->payload;
+            p_datagram->segment_length[p_datagram->segment_count] = q->len;
+            p_datagram->segment_count++;
+        }
+        ((p_pal_socket_data_config) arg)->p_length = p_pbuf->tot_len;
+        ((p_pal_socket_data_config) arg)->ip_address = *p_addr;
+        ((p_pal_socket_data_config) arg)->port = port;
+        ((p_pal_socket_data_config) arg)->b_is_event_fired = TRUE;
+        return;
+    }
+
     if(NULL != arg)
     {
         ((p_pal_socket_data_config) arg)->i4RetVal = (int32_t) E_COMMS_FAILURE;
@@ -490,12 +630,11 @@ void pal_socket_receive_handler(void * arg, struct udp_pcb * upcb, struct pbuf *
                 
                 ((p_pal_socket_data_config) arg)->p_length = p_pbuf->tot_len;
                 ((p_pal_socket_data_config) arg)->ip_address = *p_addr;
+                ((p_pal_socket_data_config) arg)->port = port;
                 
-                for (q = p_pbuf; q != NULL; q = q->next)
-                {
-                    memcpy( ((((p_pal_socket_data_config) arg)->p_data)+dwOffset), q->payload, q->len);
-                    dwOffset += q->len;
-                }
+                //Single copy of the whole chain into the record layer buffer, where the records are processed in place
+                //lint --e{534} suppress "Length is checked against tot_len above"
+                pbuf_copy_partial(p_pbuf, ((p_pal_socket_data_config) arg)->p_data, p_pbuf->tot_len, 0);
 
                 ((p_pal_socket_data_config) arg)->i4RetVal = (int32_t) E_COMMS_SUCCESS;
                 